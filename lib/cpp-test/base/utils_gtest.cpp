@@ -12,6 +12,7 @@
 
 #include "tick/array/array2d.h"
 #include "tick/base/base.h"
+#include "tick/base/math/fft.h"
 #include "tick/base/parallel/parallel.h"
 #include "tick/base/time_func.h"
 
@@ -337,6 +338,33 @@ TEST(DebugTest, PrintSparseArray) {
   EXPECT_PRED_FORMAT2(testing::IsSubstring, "SparseArray", msg);
 }
 
+TEST(FFTTest, Convolution) {
+  const std::vector<double> x{1., 2., -1., 0.5, 3.};
+  const std::vector<double> y{0.5, -2., 1.};
+
+  const ulong n = fft_size(x.size() + y.size() - 1);
+  EXPECT_EQ(n, 8);
+  std::vector<std::complex<double> > x_fft(n, 0.), y_fft(n, 0.);
+  std::copy(x.begin(), x.end(), x_fft.begin());
+  std::copy(y.begin(), y.end(), y_fft.begin());
+  fft(x_fft);
+  fft(y_fft);
+  for (ulong p = 0; p < n; ++p) x_fft[p] *= y_fft[p];
+  fft(x_fft, true);
+
+  for (ulong k = 0; k < x.size() + y.size() - 1; ++k) {
+    double convolution_k = 0;
+    for (ulong j = 0; j < y.size(); ++j) {
+      if (k >= j && k - j < x.size()) convolution_k += x[k - j] * y[j];
+    }
+    EXPECT_NEAR(x_fft[k].real(), convolution_k, 1e-12) << k;
+    EXPECT_NEAR(x_fft[k].imag(), 0., 1e-12) << k;
+  }
+
+  std::vector<std::complex<double> > bad_size(6);
+  EXPECT_THROW(fft(bad_size), std::runtime_error);
+}
+
 #ifdef ADD_MAIN
 int main(int argc, char **argv) {
 #ifdef _WIN32
@@ -0,0 +1,364 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_adm4.h"
+
+namespace {
+
+//! @brief One iteration of the inner EM of ADM4 as it was computed before the
+//! sparse weights, with dense weights g[r][u] of shape (n_jumps, n_nodes)
+void dense_adm4_iteration(const SArrayDoublePtrList2D &timestamps_list,
+                          const VArrayDoublePtr end_times, const double decay,
+                          const double rho, ArrayDouble &mu,
+                          ArrayDouble2d &adjacency, const ArrayDouble2d &z1,
+                          const ArrayDouble2d &z2, const ArrayDouble2d &u1,
+                          const ArrayDouble2d &u2) {
+  const ulong n_nodes = mu.size();
+
+  ArrayDouble kernel_integral(n_nodes);
+  kernel_integral.init_to_zero();
+  ArrayDouble next_mu(n_nodes);
+  next_mu.init_to_zero();
+  ArrayDouble2d next_C(n_nodes, n_nodes);
+  next_C.init_to_zero();
+  for (ulong r = 0; r < timestamps_list.size(); ++r) {
+    for (ulong u = 0; u < n_nodes; ++u) {
+      ArrayDouble timestamps_u = view(*timestamps_list[r][u]);
+      for (ulong i = 0; i < timestamps_u.size(); ++i) {
+        const double t_i = timestamps_u[i];
+        kernel_integral[u] += 1 - std::exp(-decay * ((*end_times)[r] - t_i));
+
+        ArrayDouble g_i(n_nodes);
+        g_i.init_to_zero();
+        for (ulong v = 0; v < n_nodes; ++v) {
+          ArrayDouble timestamps_v = view(*timestamps_list[r][v]);
+          for (ulong j = 0; j < timestamps_v.size(); ++j) {
+            if (timestamps_v[j] >= t_i) break;
+            g_i[v] += decay * std::exp(-decay * (t_i - timestamps_v[j]));
+          }
+        }
+
+        double norm = mu[u];
+        for (ulong v = 0; v < n_nodes; ++v) norm += adjacency(u, v) * g_i[v];
+        next_mu[u] += mu[u] / norm;
+        for (ulong v = 0; v < n_nodes; ++v) {
+          next_C(u, v) += adjacency(u, v) * g_i[v] / norm;
+        }
+      }
+    }
+  }
+
+  for (ulong u = 0; u < n_nodes; ++u) {
+    for (ulong v = 0; v < n_nodes; ++v) {
+      const double B = kernel_integral[v] +
+                       rho * (-z1(u, v) + u1(u, v) - z2(u, v) + u2(u, v));
+      adjacency(u, v) =
+          (-B + std::sqrt(B * B + 8 * rho * next_C(u, v))) / (4 * rho);
+    }
+    mu[u] = next_mu[u] / end_times->sum();
+  }
+}
+
+double soft_threshold(const double x, const double threshold) {
+  if (std::fabs(x) <= threshold) return 0;
+  return x > 0 ? x - threshold : x + threshold;
+}
+
+ArrayDouble2d get_matrix(const ulong n_nodes, const double shift,
+                         const double scale) {
+  ArrayDouble2d matrix(n_nodes, n_nodes);
+  for (ulong k = 0; k < matrix.size(); ++k) {
+    matrix[k] = shift + scale * std::sin(1.7 * k + shift);
+  }
+  return matrix;
+}
+
+void expect_relative_near(const ArrayDouble &actual,
+                          const ArrayDouble &expected, const double tol) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (ulong j = 0; j < actual.size(); ++j) {
+    EXPECT_NEAR(actual[j], expected[j],
+                tol * std::max(1., std::abs(expected[j])))
+        << j;
+  }
+}
+
+ArrayDouble flat(const ArrayDouble2d &matrix) {
+  return ArrayDouble(matrix.size(), matrix.data());
+}
+
+double relative_distance(const ArrayDouble &new_values,
+                         const ArrayDouble &old_values) {
+  ArrayDouble diff = new_values;
+  diff.mult_incr(old_values, -1.);
+  const double norm_old = old_values.norm_sq();
+  return std::sqrt(diff.norm_sq() / (norm_old == 0 ? 1. : norm_old));
+}
+
+}  // namespace
+
+class HawkesADM4Test : public ::testing::Test {
+ protected:
+  const ulong n_nodes = 4;
+  const double decay = 2.;
+  const double rho = 0.3;
+  SArrayDoublePtrList2D timestamps_list;
+  VArrayDoublePtr end_times;
+
+  void SetUp() override {
+    std::mt19937 generator(711);
+    const std::vector<double> lengths{15., 10.};
+    const std::vector<ulong> n_events{30, 18, 25, 12};
+    end_times = VArrayDouble::new_ptr(lengths.size());
+    timestamps_list = SArrayDoublePtrList2D(0);
+    for (ulong r = 0; r < lengths.size(); ++r) {
+      (*end_times)[r] = lengths[r];
+      std::uniform_real_distribution<double> uniform(0., lengths[r]);
+      SArrayDoublePtrList1D realization(0);
+      for (ulong u = 0; u < n_nodes; ++u) {
+        std::vector<double> times(n_events[(r + u) % n_events.size()]);
+        for (double &time : times) time = uniform(generator);
+        std::sort(times.begin(), times.end());
+        ArrayDouble timestamps_u(times.size(), times.data());
+        realization.push_back(SArrayDouble::new_ptr(timestamps_u));
+      }
+      timestamps_list.push_back(realization);
+    }
+  }
+};
+
+TEST_F(HawkesADM4Test, solve_matches_dense_weights) {
+  const ArrayDouble2d z1 = get_matrix(n_nodes, 0.1, 0.05);
+  const ArrayDouble2d z2 = get_matrix(n_nodes, 0.2, 0.1);
+  const ArrayDouble2d u1 = get_matrix(n_nodes, -0.05, 0.02);
+  const ArrayDouble2d u2 = get_matrix(n_nodes, 0.03, 0.04);
+
+  for (int n_threads : {1, 3}) {
+    HawkesADM4 adm4(decay, rho, n_threads);
+    adm4.set_data(timestamps_list, end_times);
+
+    ArrayDouble mu{0.5, 0.7, 0.3, 0.4};
+    ArrayDouble2d adjacency = get_matrix(n_nodes, 0.5, 0.2);
+    ArrayDouble dense_mu = mu;
+    ArrayDouble2d dense_adjacency = adjacency;
+
+    ArrayDouble2d z1_copy = z1, z2_copy = z2, u1_copy = u1, u2_copy = u2;
+    for (int iter = 0; iter < 5; ++iter) {
+      adm4.solve(mu, adjacency, z1_copy, z2_copy, u1_copy, u2_copy);
+      dense_adm4_iteration(timestamps_list, end_times, decay, rho, dense_mu,
+                           dense_adjacency, z1, z2, u1, u2);
+      SCOPED_TRACE(::testing::Message() << "n_threads=" << n_threads
+                                        << " iter=" << iter);
+      expect_relative_near(mu, dense_mu, 1e-12);
+      expect_relative_near(flat(adjacency), flat(dense_adjacency), 1e-12);
+    }
+  }
+}
+
+TEST_F(HawkesADM4Test, float_weights_match_double_weights) {
+  const ArrayDouble2d z1 = get_matrix(n_nodes, 0.1, 0.05);
+  const ArrayDouble2d z2 = get_matrix(n_nodes, 0.2, 0.1);
+  const ArrayDouble2d u1 = get_matrix(n_nodes, -0.05, 0.02);
+  const ArrayDouble2d u2 = get_matrix(n_nodes, 0.03, 0.04);
+
+  HawkesADM4Double adm4_double(decay, rho);
+  adm4_double.set_data(timestamps_list, end_times);
+  HawkesADM4Float adm4_float(decay, rho);
+  adm4_float.set_data(timestamps_list, end_times);
+
+  ArrayDouble mu_double{0.5, 0.7, 0.3, 0.4};
+  ArrayDouble2d adjacency_double = get_matrix(n_nodes, 0.5, 0.2);
+  ArrayDouble mu_float = mu_double;
+  ArrayDouble2d adjacency_float = adjacency_double;
+
+  ArrayDouble2d z1_copy = z1, z2_copy = z2, u1_copy = u1, u2_copy = u2;
+  for (int iter = 0; iter < 5; ++iter) {
+    adm4_double.solve(mu_double, adjacency_double, z1_copy, z2_copy, u1_copy,
+                      u2_copy);
+    adm4_float.solve(mu_float, adjacency_float, z1_copy, z2_copy, u1_copy,
+                     u2_copy);
+    SCOPED_TRACE(::testing::Message() << "iter=" << iter);
+    // Only the stored weights are rounded to float, the accumulations are
+    // the same
+    expect_relative_near(mu_float, mu_double, 1e-5);
+    expect_relative_near(flat(adjacency_float), flat(adjacency_double), 1e-5);
+  }
+}
+
+TEST_F(HawkesADM4Test, low_rank_admm_matches_dense_admm) {
+  // Without nuclear penalization, the low rank component is adjacency + u1
+  // as long as max_rank is not smaller than n_nodes
+  const double strength_lasso = 0.05;
+  const ulong em_max_iter = 3;
+
+  HawkesADM4 adm4(decay, rho, 2);
+  adm4.set_data(timestamps_list, end_times);
+  adm4.set_max_rank(n_nodes);
+  adm4.reset_components();
+
+  ArrayDouble mu{0.5, 0.7, 0.3, 0.4};
+  ArrayDouble2d adjacency = get_matrix(n_nodes, 0.5, 0.2);
+  ArrayDouble2d u1(n_nodes, n_nodes), u2(n_nodes, n_nodes);
+  u1.init_to_zero();
+  u2.init_to_zero();
+
+  ArrayDouble dense_mu = mu;
+  ArrayDouble2d dense_adjacency = adjacency;
+  ArrayDouble2d z1(n_nodes, n_nodes), z2(n_nodes, n_nodes);
+  ArrayDouble2d dense_u1(n_nodes, n_nodes), dense_u2(n_nodes, n_nodes);
+  z1.init_to_zero();
+  z2.init_to_zero();
+  dense_u1.init_to_zero();
+  dense_u2.init_to_zero();
+
+  for (int iter = 0; iter < 4; ++iter) {
+    adm4.solve_em_low_rank(mu, adjacency, u1, u2, em_max_iter, 0.);
+    adm4.update_components(adjacency, u1, u2, strength_lasso, 0.);
+
+    for (ulong em_iter = 0; em_iter < em_max_iter; ++em_iter) {
+      dense_adm4_iteration(timestamps_list, end_times, decay, rho, dense_mu,
+                           dense_adjacency, z1, z2, dense_u1, dense_u2);
+    }
+    for (ulong k = 0; k < z1.size(); ++k) {
+      z1[k] = dense_adjacency[k] + dense_u1[k];
+      z2[k] = soft_threshold(dense_adjacency[k] + dense_u2[k],
+                             strength_lasso / rho);
+      dense_u1[k] += dense_adjacency[k] - z1[k];
+      dense_u2[k] += dense_adjacency[k] - z2[k];
+    }
+
+    SCOPED_TRACE(::testing::Message() << "iter=" << iter);
+    expect_relative_near(mu, dense_mu, 1e-8);
+    expect_relative_near(flat(adjacency), flat(dense_adjacency), 1e-8);
+    expect_relative_near(flat(u1), flat(dense_u1), 1e-8);
+    expect_relative_near(flat(u2), flat(dense_u2), 1e-8);
+  }
+  EXPECT_EQ(adm4.get_low_rank_singular_values()->size(), n_nodes);
+}
+
+TEST_F(HawkesADM4Test, low_rank_factors_are_thresholded_svd) {
+  const double strength_nuclear = 0.02;
+  const double threshold = strength_nuclear / rho;
+
+  HawkesADM4 adm4(decay, rho);
+  adm4.set_data(timestamps_list, end_times);
+  adm4.set_max_rank(2);
+  adm4.reset_components();
+
+  ArrayDouble2d adjacency = get_matrix(n_nodes, 0.5, 0.2);
+  ArrayDouble2d u1 = get_matrix(n_nodes, -0.05, 0.3);
+  ArrayDouble2d u2(n_nodes, n_nodes);
+  u2.init_to_zero();
+  ArrayDouble2d x = adjacency;
+  x.mult_incr(u1, 1.);
+
+  adm4.update_components(adjacency, u1, u2, 0., strength_nuclear);
+  ArrayDouble2d left = *adm4.get_low_rank_left();
+  ArrayDouble2d right = *adm4.get_low_rank_right();
+  ArrayDouble singular_values = *adm4.get_low_rank_singular_values();
+  ASSERT_EQ(singular_values.size(), 2u);
+  EXPECT_GT(singular_values[0], singular_values[1]);
+
+  ArrayDouble2d z1(n_nodes, n_nodes);
+  z1.init_to_zero();
+  for (ulong k = 0; k < singular_values.size(); ++k) {
+    // Singular vectors of x with singular value singular_values[k] +
+    // threshold
+    const double sigma_k = singular_values[k] + threshold;
+    for (ulong i = 0; i < n_nodes; ++i) {
+      double x_right_i = 0, x_t_left_i = 0;
+      for (ulong j = 0; j < n_nodes; ++j) {
+        x_right_i += x(i, j) * right(k, j);
+        x_t_left_i += x(j, i) * left(k, j);
+        z1(i, j) += singular_values[k] * left(k, i) * right(k, j);
+      }
+      EXPECT_NEAR(x_right_i, sigma_k * left(k, i), 1e-6) << k << " " << i;
+      EXPECT_NEAR(x_t_left_i, sigma_k * right(k, i), 1e-6) << k << " " << i;
+    }
+    for (ulong l = 0; l <= k; ++l) {
+      EXPECT_NEAR(view_row(left, k).dot(view_row(left, l)), k == l, 1e-10);
+      EXPECT_NEAR(view_row(right, k).dot(view_row(right, l)), k == l, 1e-10);
+    }
+  }
+
+  // The dual variable is updated with the low rank component
+  for (ulong k = 0; k < x.size(); ++k) {
+    EXPECT_NEAR(u1[k], x[k] - z1[k], 1e-10);
+  }
+}
+
+TEST_F(HawkesADM4Test, fit_matches_repeated_admm_iterations) {
+  const double strength_lasso = 0.05;
+  const double strength_nuclear = 0.02;
+  const ulong max_iter = 9;
+  const ulong em_max_iter = 3;
+  const ulong record_every = 4;
+
+  HawkesADM4 adm4(decay, rho, 2);
+  adm4.set_data(timestamps_list, end_times);
+  adm4.set_max_rank(n_nodes);
+
+  ArrayDouble expected_mu{0.5, 0.7, 0.3, 0.4};
+  ArrayDouble2d expected_adjacency = get_matrix(n_nodes, 0.5, 0.2);
+  ArrayDouble mu = expected_mu;
+  ArrayDouble2d adjacency = expected_adjacency;
+
+  ArrayDouble2d u1(n_nodes, n_nodes), u2(n_nodes, n_nodes);
+  u1.init_to_zero();
+  u2.init_to_zero();
+  adm4.reset_components();
+  std::vector<std::vector<double> > expected_history;
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const ArrayDouble previous_mu = expected_mu;
+    const ArrayDouble2d previous_adjacency = expected_adjacency;
+    adm4.solve_em_low_rank(expected_mu, expected_adjacency, u1, u2,
+                           em_max_iter, 0.);
+    adm4.update_components(expected_adjacency, u1, u2, strength_lasso,
+                           strength_nuclear);
+    if (iter % record_every == 0 || iter + 1 == max_iter) {
+      expected_history.push_back(
+          {static_cast<double>(iter + 1),
+           relative_distance(expected_mu, previous_mu),
+           relative_distance(flat(expected_adjacency),
+                             flat(previous_adjacency))});
+    }
+  }
+
+  // Tolerances of 0 are never reached
+  EXPECT_EQ(adm4.fit(mu, adjacency, strength_lasso, strength_nuclear,
+                     max_iter, 0., em_max_iter, 0., record_every),
+            max_iter);
+  expect_relative_near(mu, expected_mu, 1e-12);
+  expect_relative_near(flat(adjacency), flat(expected_adjacency), 1e-12);
+
+  ArrayDouble2d history = *adm4.get_fit_history();
+  ASSERT_EQ(history.n_rows(), expected_history.size());
+  ASSERT_EQ(history.n_cols(), 3u);
+  for (ulong k = 0; k < history.n_rows(); ++k) {
+    SCOPED_TRACE(::testing::Message() << "record=" << k);
+    expect_relative_near(view_row(history, k),
+                         ArrayDouble(3, expected_history[k].data()), 1e-10);
+  }
+
+  // Convergence is only accepted after a few iterations
+  mu = ArrayDouble{0.5, 0.7, 0.3, 0.4};
+  adjacency = get_matrix(n_nodes, 0.5, 0.2);
+  EXPECT_EQ(adm4.fit(mu, adjacency, strength_lasso, strength_nuclear,
+                     max_iter, 1e10, em_max_iter, -1., 1),
+            7u);
+  EXPECT_EQ(adm4.get_fit_history()->n_rows(), 7u);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
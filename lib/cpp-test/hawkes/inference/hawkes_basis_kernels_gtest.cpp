@@ -0,0 +1,413 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_basis_kernels.h"
+
+namespace {
+
+//! @brief One iteration of HawkesBasisKernels as it was computed before the
+//! index of pairs of events, every event rescanning its past events and the
+//! per node buffers being reduced in node order
+class PreviousBasisKernels {
+  const SArrayDoublePtrList2D &timestamps_list;
+  const VArrayDoublePtr end_times;
+  const ulong n_nodes, D, M;
+  const double kernel_dt, alpha;
+
+ public:
+  PreviousBasisKernels(const SArrayDoublePtrList2D &timestamps_list,
+                       const VArrayDoublePtr end_times,
+                       const double kernel_support, const ulong kernel_size,
+                       const ulong n_basis, const double alpha)
+      : timestamps_list(timestamps_list),
+        end_times(end_times),
+        n_nodes(timestamps_list[0].size()),
+        D(n_basis),
+        M(kernel_size),
+        kernel_dt(kernel_support / kernel_size),
+        alpha(alpha) {}
+
+  double solve(ArrayDouble &mu, ArrayDouble2d &gdm, ArrayDouble2d &auvd,
+               const ulong max_iter_gdm, const double max_tol_gdm) const {
+    ArrayDouble2d Gdm(D, M);
+    for (ulong d = 0; d < D; d++) {
+      Gdm(d, 0) = gdm(d, 0) * kernel_dt;
+      for (ulong m = 1; m < M; m++) {
+        Gdm(d, m) = Gdm(d, m - 1) + gdm(d, m) * kernel_dt;
+      }
+    }
+
+    ArrayDouble2d a_sum_vd(n_nodes, D);
+    a_sum_vd.init_to_zero();
+    for (ulong v = 0; v < n_nodes; v++) {
+      for (ulong d = 0; d < D; d++) {
+        for (ulong u = 0; u < n_nodes; u++) {
+          a_sum_vd(v, d) += auvd(u, v * D + d);
+        }
+      }
+    }
+
+    ArrayDouble2d rud(n_nodes, D), quvd(n_nodes, n_nodes * D);
+    ArrayDouble2d Cdm(D, M), Ddm(D, M);
+    rud.init_to_zero();
+    quvd.init_to_zero();
+    Cdm.init_to_zero();
+    Ddm.init_to_zero();
+
+    ArrayDouble next_mu(n_nodes);
+    for (ulong u = 0; u < n_nodes; u++) {
+      double mu_out = 0;
+      for (ulong r = 0; r < timestamps_list.size(); r++) {
+        const ArrayDouble u_realization = view(*timestamps_list[r][u]);
+        const double T = (*end_times)[r];
+        compute_r(u_realization, T, gdm, Gdm, u, rud);
+        compute_C(u_realization, T, gdm, a_sum_vd, u, Cdm);
+        mu_out +=
+            compute_mu_q_D(u, timestamps_list[r], gdm, auvd, mu[u], quvd, Ddm);
+      }
+      next_mu[u] = mu_out / end_times->sum();
+    }
+    mu = next_mu;
+
+    for (ulong u = 0; u < n_nodes; u++) {
+      for (ulong v = 0; v < n_nodes; v++) {
+        for (ulong d = 0; d < D; d++) {
+          auvd(u, v * D + d) =
+              std::sqrt(quvd(u, v * D + d) / (rud(v, d) + 2 * alpha));
+        }
+      }
+    }
+
+    double rerr_gdm = 0;
+    for (ulong d = 0; d < D; d++) {
+      rerr_gdm = std::max(
+          rerr_gdm, compute_gdm(d, gdm, Cdm, Ddm, max_tol_gdm, max_iter_gdm));
+    }
+    return rerr_gdm;
+  }
+
+ private:
+  void compute_r(const ArrayDouble &u_realization, const double T,
+                 const ArrayDouble2d &gdm, const ArrayDouble2d &Gdm,
+                 const ulong u, ArrayDouble2d &rud) const {
+    for (ulong j = 0; j < u_realization.size(); j++) {
+      const ulong m0 =
+          static_cast<ulong>(std::floor((T - u_realization[j]) / kernel_dt));
+      for (ulong d = 0; d < D; d++) {
+        if (m0 >= M) {
+          rud(u, d) += Gdm(d, M - 1);
+        } else if (m0 > 0) {
+          rud(u, d) += Gdm(d, m0 - 1) +
+                       (T - u_realization[j] - m0 * kernel_dt) * gdm(d, m0);
+        } else {
+          rud(u, d) += (T - u_realization[j] - m0 * kernel_dt) * gdm(d, m0);
+        }
+      }
+    }
+  }
+
+  void compute_C(const ArrayDouble &u_realization, const double T,
+                 const ArrayDouble2d &gdm, const ArrayDouble2d &a_sum_vd,
+                 const ulong u, ArrayDouble2d &Cdm) const {
+    ulong i = u_realization.size() - 1;
+    for (ulong m = 0; m < M; m++) {
+      while (i != static_cast<ulong>(-1) &&
+             u_realization[i] > T - m * kernel_dt)
+        i--;
+      if (i == static_cast<ulong>(-1)) break;
+      for (ulong d = 0; d < D; d++) {
+        Cdm(d, m) += a_sum_vd(u, d) * (i + 1) / gdm(d, m);
+      }
+    }
+  }
+
+  double compute_mu_q_D(const ulong u_index,
+                        const SArrayDoublePtrList1D &realization,
+                        const ArrayDouble2d &gdm, const ArrayDouble2d &auvd,
+                        const double mu, ArrayDouble2d &quvd,
+                        ArrayDouble2d &Ddm) const {
+    const ArrayDouble u = view(*realization[u_index]);
+    std::vector<ulong> v_indices(n_nodes);
+    for (ulong n = 0; n < n_nodes; n++) v_indices[n] = realization[n]->size();
+
+    ArrayDouble2d qvd_temp(n_nodes, D), Ddm_temp(D, M);
+    double mu_out = 0;
+    for (ulong i = u.size() - 1; i != static_cast<ulong>(-1); i--) {
+      double norm = 0;
+      qvd_temp.init_to_zero();
+      Ddm_temp.init_to_zero();
+      const double t_i = u[i];
+
+      for (ulong v_index = 0; v_index < n_nodes; v_index++) {
+        const ArrayDouble v = view(*realization[v_index]);
+        while (true) {
+          if (v_indices[v_index] == 0) break;
+          if (v_indices[v_index] < v.size() && t_i >= v[v_indices[v_index]])
+            break;
+          v_indices[v_index]--;
+        }
+        if (t_i < v[v_indices[v_index]]) continue;
+
+        for (ulong j = v_indices[v_index]; j != static_cast<ulong>(-1); j--) {
+          const double t_j = v[j];
+          if (u_index == v_index && i == j) {
+            norm += mu;
+          } else {
+            const ulong m =
+                static_cast<ulong>(std::floor((t_i - t_j) / kernel_dt));
+            if (m >= M) break;
+            for (ulong d = 0; d < D; d++) {
+              const double val = auvd(u_index, v_index * D + d) * gdm(d, m);
+              qvd_temp(v_index, d) += val;
+              Ddm_temp(d, m) += val;
+              norm += val;
+            }
+          }
+        }
+      }
+
+      mu_out += mu / norm;
+      for (ulong d = 0; d < D; d++) {
+        for (ulong m = 0; m < M; m++) {
+          Ddm(d, m) += Ddm_temp(d, m) / (norm * kernel_dt);
+        }
+        for (ulong v_index = 0; v_index < n_nodes; v_index++) {
+          quvd(u_index, v_index * D + d) += auvd(u_index, v_index * D + d) *
+                                            qvd_temp(v_index, d) / norm;
+        }
+      }
+    }
+    return mu_out;
+  }
+
+  double compute_gdm(const ulong d, ArrayDouble2d &gdm,
+                     const ArrayDouble2d &Cdm, const ArrayDouble2d &Ddm,
+                     const double tol, const ulong max_iter) const {
+    for (ulong m = 0; m < M; m++) gdm(d, m) = 0;
+    double max_rel_error = 0;
+    for (ulong n_iter = 0; n_iter < max_iter; ++n_iter) {
+      max_rel_error = -1;
+      for (ulong m = 0; m < M; m++) {
+        const double mm = m == 0 ? 0 : gdm(d, m - 1);
+        const double pm = m == M - 1 ? 0 : gdm(d, m + 1);
+        const double a = 4 * alpha / (kernel_dt * kernel_dt) + Cdm(d, m);
+        const double b = -2 * alpha * (pm + mm) / (kernel_dt * kernel_dt);
+        const double c = -Ddm(d, m);
+        const double sol = (-b + std::sqrt(b * b - 4 * a * c)) / (2 * a);
+        if (n_iter != 0) {
+          const double rel_error =
+              gdm(d, m) == 0 ? sol : (sol - gdm(d, m)) / gdm(d, m);
+          max_rel_error = std::max(rel_error, max_rel_error);
+        }
+        gdm(d, m) = sol;
+      }
+      if (n_iter > 0 && max_rel_error < tol) break;
+    }
+    return max_rel_error;
+  }
+};
+
+void expect_relative_near(const ArrayDouble &actual,
+                          const ArrayDouble &expected, const double tol) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (ulong j = 0; j < actual.size(); ++j) {
+    EXPECT_NEAR(actual[j], expected[j],
+                tol * std::max(1., std::abs(expected[j])))
+        << j;
+  }
+}
+
+ArrayDouble flat(const ArrayDouble2d &matrix) {
+  return ArrayDouble(matrix.size(), matrix.data());
+}
+
+double relative_distance(const ArrayDouble &new_values,
+                         const ArrayDouble &old_values) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < new_values.size(); ++j) {
+    norm_diff += (new_values[j] - old_values[j]) *
+                 (new_values[j] - old_values[j]);
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+}  // namespace
+
+class HawkesBasisKernelsTest : public ::testing::Test {
+ protected:
+  const ulong n_nodes = 4;
+  const double kernel_support = 2.;
+  const ulong kernel_size = 10;
+  const ulong n_basis = 2;
+  const double alpha = 0.05;
+  SArrayDoublePtrList2D timestamps_list;
+  VArrayDoublePtr end_times;
+
+  void SetUp() override {
+    std::mt19937 generator(3407);
+    const std::vector<double> lengths{30., 20.};
+    const std::vector<ulong> n_events{45, 20, 60, 30};
+    end_times = VArrayDouble::new_ptr(lengths.size());
+    timestamps_list = SArrayDoublePtrList2D(0);
+    for (ulong r = 0; r < lengths.size(); ++r) {
+      (*end_times)[r] = lengths[r];
+      std::uniform_real_distribution<double> uniform(0., lengths[r]);
+      SArrayDoublePtrList1D realization(0);
+      for (ulong u = 0; u < n_nodes; ++u) {
+        std::vector<double> times(n_events[(r + u) % n_events.size()]);
+        for (double &time : times) time = uniform(generator);
+        std::sort(times.begin(), times.end());
+        ArrayDouble timestamps_u(times.size(), times.data());
+        realization.push_back(SArrayDouble::new_ptr(timestamps_u));
+      }
+      timestamps_list.push_back(realization);
+    }
+  }
+
+  void get_starting_point(ArrayDouble &mu, ArrayDouble2d &gdm,
+                          ArrayDouble2d &auvd) const {
+    mu = ArrayDouble(n_nodes);
+    gdm = ArrayDouble2d(n_basis, kernel_size);
+    auvd = ArrayDouble2d(n_nodes, n_nodes * n_basis);
+    for (ulong u = 0; u < n_nodes; ++u) mu[u] = 0.3 + 0.1 * u;
+    for (ulong d = 0; d < n_basis; ++d) {
+      for (ulong m = 0; m < kernel_size; ++m) {
+        gdm(d, m) = (d + 1) * std::exp(-(d + 0.5) * m * 0.2);
+      }
+    }
+    for (ulong k = 0; k < auvd.size(); ++k) auvd[k] = 0.1 + 0.03 * (k % 5);
+  }
+};
+
+TEST_F(HawkesBasisKernelsTest, solve_matches_previous_implementation) {
+  const ulong max_iter_gdm = 50;
+  const double max_tol_gdm = 1e-6;
+  PreviousBasisKernels previous(timestamps_list, end_times, kernel_support,
+                                kernel_size, n_basis, alpha);
+
+  // More threads than nodes are capped to the number of nodes
+  for (int n_threads : {1, 3, 8}) {
+    HawkesBasisKernels basis_kernels(kernel_support, kernel_size, n_basis,
+                                     alpha, n_threads);
+    basis_kernels.set_data(timestamps_list, end_times);
+
+    ArrayDouble mu, previous_mu;
+    ArrayDouble2d gdm, auvd, previous_gdm, previous_auvd;
+    get_starting_point(mu, gdm, auvd);
+    get_starting_point(previous_mu, previous_gdm, previous_auvd);
+
+    for (int iter = 0; iter < 5; ++iter) {
+      const double rerr =
+          basis_kernels.solve(mu, gdm, auvd, max_iter_gdm, max_tol_gdm);
+      const double previous_rerr = previous.solve(
+          previous_mu, previous_gdm, previous_auvd, max_iter_gdm, max_tol_gdm);
+      SCOPED_TRACE(::testing::Message() << "n_threads=" << n_threads
+                                        << " iter=" << iter);
+      EXPECT_NEAR(rerr, previous_rerr, 1e-8);
+      expect_relative_near(mu, previous_mu, 1e-10);
+      expect_relative_near(flat(gdm), flat(previous_gdm), 1e-10);
+      expect_relative_near(flat(auvd), flat(previous_auvd), 1e-10);
+    }
+  }
+}
+
+TEST_F(HawkesBasisKernelsTest, solve_is_deterministic_for_threads) {
+  ArrayDouble mu, other_mu;
+  ArrayDouble2d gdm, auvd, other_gdm, other_auvd;
+  get_starting_point(mu, gdm, auvd);
+  get_starting_point(other_mu, other_gdm, other_auvd);
+
+  HawkesBasisKernels basis_kernels(kernel_support, kernel_size, n_basis, alpha,
+                                   3);
+  basis_kernels.set_data(timestamps_list, end_times);
+  HawkesBasisKernels other(kernel_support, kernel_size, n_basis, alpha, 3);
+  other.set_data(timestamps_list, end_times);
+  for (int iter = 0; iter < 3; ++iter) {
+    basis_kernels.solve(mu, gdm, auvd, 20, 1e-6);
+    other.solve(other_mu, other_gdm, other_auvd, 20, 1e-6);
+  }
+  for (ulong k = 0; k < gdm.size(); ++k) EXPECT_EQ(gdm[k], other_gdm[k]) << k;
+  for (ulong k = 0; k < auvd.size(); ++k) {
+    EXPECT_EQ(auvd[k], other_auvd[k]) << k;
+  }
+}
+
+TEST_F(HawkesBasisKernelsTest, fit_matches_repeated_solve) {
+  const ulong max_iter = 8;
+  const ulong record_every = 3;
+  const ulong max_iter_gdm = 20;
+  const double max_tol_gdm = 1e-6;
+  HawkesBasisKernels basis_kernels(kernel_support, kernel_size, n_basis, alpha,
+                                   2);
+  basis_kernels.set_data(timestamps_list, end_times);
+
+  ArrayDouble expected_mu, mu;
+  ArrayDouble2d expected_gdm, expected_auvd, gdm, auvd;
+  get_starting_point(expected_mu, expected_gdm, expected_auvd);
+  std::vector<std::vector<double> > expected_history;
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const ArrayDouble previous_mu = expected_mu;
+    const ArrayDouble2d previous_gdm = expected_gdm;
+    const ArrayDouble2d previous_auvd = expected_auvd;
+    const double rel_ode = basis_kernels.solve(
+        expected_mu, expected_gdm, expected_auvd, max_iter_gdm, max_tol_gdm);
+    if (iter % record_every == 0 || iter + 1 == max_iter) {
+      expected_history.push_back(
+          {static_cast<double>(iter + 1),
+           relative_distance(expected_mu, previous_mu),
+           relative_distance(flat(expected_auvd), flat(previous_auvd)),
+           relative_distance(flat(expected_gdm), flat(previous_gdm)),
+           rel_ode});
+    }
+  }
+
+  get_starting_point(mu, gdm, auvd);
+  EXPECT_EQ(basis_kernels.fit(mu, gdm, auvd, max_iter, 0., max_iter_gdm,
+                              max_tol_gdm, record_every),
+            max_iter);
+  expect_relative_near(mu, expected_mu, 1e-12);
+  expect_relative_near(flat(gdm), flat(expected_gdm), 1e-12);
+  expect_relative_near(flat(auvd), flat(expected_auvd), 1e-12);
+
+  ArrayDouble2d history = *basis_kernels.get_fit_history();
+  ASSERT_EQ(history.n_rows(), expected_history.size());
+  ASSERT_EQ(history.n_cols(), 5u);
+  for (ulong k = 0; k < history.n_rows(); ++k) {
+    SCOPED_TRACE(::testing::Message() << "record=" << k);
+    expect_relative_near(view_row(history, k),
+                         ArrayDouble(5, expected_history[k].data()), 1e-10);
+  }
+
+  // Without recording, only the last iteration is checked
+  get_starting_point(mu, gdm, auvd);
+  basis_kernels.fit(mu, gdm, auvd, max_iter, 0., max_iter_gdm, max_tol_gdm, 0);
+  history = *basis_kernels.get_fit_history();
+  ASSERT_EQ(history.n_rows(), 1u);
+  EXPECT_EQ(history(0, 0), static_cast<double>(max_iter));
+}
+
+TEST_F(HawkesBasisKernelsTest, fit_stops_at_tolerance) {
+  HawkesBasisKernels basis_kernels(kernel_support, kernel_size, n_basis,
+                                   alpha);
+  basis_kernels.set_data(timestamps_list, end_times);
+  ArrayDouble mu;
+  ArrayDouble2d gdm, auvd;
+  get_starting_point(mu, gdm, auvd);
+  EXPECT_EQ(basis_kernels.fit(mu, gdm, auvd, 10, 1e10, 20, 1e-6, 3), 1u);
+  EXPECT_EQ(basis_kernels.get_fit_history()->n_rows(), 1u);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
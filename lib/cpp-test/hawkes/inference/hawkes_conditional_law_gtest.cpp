@@ -0,0 +1,139 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_conditional_law.h"
+
+class HawkesConditionalLawTest : public ::testing::Test {
+ protected:
+  const double end_time = 50.;
+  SArrayDoublePtrList1D timestamps;
+  SArrayDoublePtrList1D marks;
+  ArrayDouble lags;
+
+  void add_node(std::mt19937 &generator, const ulong n_events,
+                const double max_time) {
+    std::uniform_real_distribution<double> uniform(0., max_time);
+    std::exponential_distribution<double> exponential(1.);
+    std::vector<double> times(n_events);
+    for (double &time : times) time = uniform(generator);
+    std::sort(times.begin(), times.end());
+    // Marks are given as their cumulated sum
+    ArrayDouble timestamps_node(n_events), marks_node(n_events);
+    double cumulated_mark = 0;
+    for (ulong k = 0; k < n_events; ++k) {
+      timestamps_node[k] = times[k];
+      cumulated_mark += exponential(generator);
+      marks_node[k] = cumulated_mark;
+    }
+    timestamps.push_back(SArrayDouble::new_ptr(timestamps_node));
+    marks.push_back(SArrayDouble::new_ptr(marks_node));
+  }
+
+  void SetUp() override {
+    std::mt19937 generator(5113);
+    timestamps = SArrayDoublePtrList1D(0);
+    marks = SArrayDoublePtrList1D(0);
+    add_node(generator, 300, end_time);
+    add_node(generator, 150, end_time);
+    // A node whose jumps stop early, another with a single jump
+    add_node(generator, 80, end_time / 3);
+    add_node(generator, 1, end_time);
+
+    const ulong n_lags = 25;
+    lags = ArrayDouble(n_lags + 1);
+    lags[0] = 0;
+    for (ulong k = 1; k <= n_lags; ++k) lags[k] = 1e-3 * std::pow(1.4, k);
+  }
+};
+
+TEST_F(HawkesConditionalLawTest, batch_matches_single_triplets) {
+  const ulong n_nodes = timestamps.size();
+  const ulong N = lags.size() - 1;
+  // Several mark intervals per Z node, the same (z, interval) groups being
+  // shared by all Y nodes
+  const std::vector<std::vector<double> > intervals{
+      {-DBL_MAX, DBL_MAX}, {-DBL_MAX, 0.5}, {0.5, 1.5}, {1.5, DBL_MAX}};
+
+  std::vector<ulong> y_nodes_vector, z_nodes_vector;
+  std::vector<double> zmins_vector, zmaxs_vector;
+  for (ulong i = 0; i < n_nodes; ++i) {
+    for (ulong j = 0; j < n_nodes; ++j) {
+      for (const auto &interval : intervals) {
+        y_nodes_vector.push_back(i);
+        z_nodes_vector.push_back(j);
+        zmins_vector.push_back(interval[0]);
+        zmaxs_vector.push_back(interval[1]);
+      }
+    }
+  }
+  const ulong n_triplets = y_nodes_vector.size();
+  ArrayULong y_nodes(n_triplets, y_nodes_vector.data());
+  ArrayULong z_nodes(n_triplets, z_nodes_vector.data());
+  ArrayDouble zmins(n_triplets, zmins_vector.data());
+  ArrayDouble zmaxs(n_triplets, zmaxs_vector.data());
+
+  ArrayDouble2d expected_res_Y(n_triplets, N);
+  ArrayDouble expected_res_X(N);
+  for (ulong triplet = 0; triplet < n_triplets; ++triplet) {
+    ArrayDouble y_time = *timestamps[y_nodes[triplet]];
+    ArrayDouble z_time = *timestamps[z_nodes[triplet]];
+    ArrayDouble z_mark = *marks[z_nodes[triplet]];
+    ArrayDouble res_Y = view_row(expected_res_Y, triplet);
+    PointProcessCondLaw(y_time, z_time, z_mark, lags, zmins[triplet],
+                        zmaxs[triplet], end_time, y_time.size() / end_time,
+                        expected_res_X, res_Y);
+  }
+
+  for (int n_threads : {1, 4, 64}) {
+    ArrayDouble res_X(N);
+    ArrayDouble2d res_Y(n_triplets, N);
+    PointProcessCondLawBatch(timestamps, marks, lags, y_nodes, z_nodes, zmins,
+                             zmaxs, end_time, res_X, res_Y, n_threads);
+    for (ulong k = 0; k < N; ++k) {
+      EXPECT_DOUBLE_EQ(res_X[k], expected_res_X[k]) << k;
+    }
+    for (ulong triplet = 0; triplet < n_triplets; ++triplet) {
+      for (ulong k = 0; k < N; ++k) {
+        EXPECT_NEAR(res_Y(triplet, k), expected_res_Y(triplet, k), 1e-10)
+            << "n_threads=" << n_threads << " triplet=" << triplet
+            << " k=" << k;
+      }
+    }
+  }
+}
+
+TEST_F(HawkesConditionalLawTest, batch_checks_arguments) {
+  const ulong N = lags.size() - 1;
+  ArrayULong y_nodes{0, 1}, z_nodes{1, 0};
+  ArrayDouble zmins{-DBL_MAX, -DBL_MAX}, zmaxs{DBL_MAX, DBL_MAX};
+  ArrayDouble res_X(N);
+  ArrayDouble2d res_Y(2, N);
+  PointProcessCondLawBatch(timestamps, marks, lags, y_nodes, z_nodes, zmins,
+                           zmaxs, end_time, res_X, res_Y);
+
+  ArrayULong wrong_z_nodes{1, 4};
+  EXPECT_THROW(
+      PointProcessCondLawBatch(timestamps, marks, lags, y_nodes, wrong_z_nodes,
+                               zmins, zmaxs, end_time, res_X, res_Y),
+      std::runtime_error);
+  ArrayDouble2d wrong_res_Y(3, N);
+  EXPECT_THROW(
+      PointProcessCondLawBatch(timestamps, marks, lags, y_nodes, z_nodes,
+                               zmins, zmaxs, end_time, res_X, wrong_res_Y),
+      std::runtime_error);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
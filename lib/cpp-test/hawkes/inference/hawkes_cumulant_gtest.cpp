@@ -0,0 +1,126 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_cumulant.h"
+
+class HawkesCumulantTest : public ::testing::Test {
+ protected:
+  const ulong n_nodes = 3;
+  const double integration_support = 1.5;
+  SArrayDoublePtrList2D timestamps_list;
+  VArrayDoublePtr end_times;
+
+  void SetUp() override {
+    std::mt19937 generator(2207);
+    const std::vector<double> lengths{30., 22.};
+    const std::vector<ulong> n_events{60, 35, 80};
+    end_times = VArrayDouble::new_ptr(lengths.size());
+    timestamps_list = SArrayDoublePtrList2D(0);
+    for (ulong r = 0; r < lengths.size(); ++r) {
+      (*end_times)[r] = lengths[r];
+      std::uniform_real_distribution<double> uniform(0., lengths[r]);
+      SArrayDoublePtrList1D realization(0);
+      for (ulong u = 0; u < n_nodes; ++u) {
+        std::vector<double> times(n_events[(r + u) % n_events.size()]);
+        for (double &time : times) time = uniform(generator);
+        std::sort(times.begin(), times.end());
+        ArrayDouble timestamps_u(times.size(), times.data());
+        realization.push_back(SArrayDouble::new_ptr(timestamps_u));
+      }
+      timestamps_list.push_back(realization);
+    }
+  }
+};
+
+TEST_F(HawkesCumulantTest, compute_cumulants_matches_pairwise) {
+  HawkesCumulant pairwise_cumulant(integration_support);
+  pairwise_cumulant.set_data(timestamps_list, end_times);
+  const ulong n_realizations = timestamps_list.size();
+
+  // Cumulants computed pair by pair, as the Python wrapper used to do
+  ArrayDouble expected_L(n_nodes);
+  expected_L.init_to_zero();
+  ArrayDouble2d expected_C(n_nodes, n_nodes);
+  expected_C.init_to_zero();
+  ArrayDouble2d expected_K(n_nodes, n_nodes);
+  expected_K.init_to_zero();
+  for (ulong r = 0; r < n_realizations; ++r) {
+    ArrayDouble L_r(n_nodes);
+    for (ulong i = 0; i < n_nodes; ++i) {
+      L_r[i] = timestamps_list[r][i]->size() / (*end_times)[r];
+    }
+    expected_L.mult_incr(L_r, 1. / n_realizations);
+
+    ArrayDouble2d C_r(n_nodes, n_nodes), J_r(n_nodes, n_nodes);
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong j = 0; j < n_nodes; ++j) {
+        ArrayDouble A_and_I =
+            *pairwise_cumulant.compute_A_and_I_ij(r, i, j, L_r[j]);
+        C_r(i, j) = A_and_I[0];
+        J_r(i, j) = A_and_I[1];
+      }
+    }
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong j = 0; j < n_nodes; ++j) {
+        expected_C(i, j) += 0.5 * (C_r(i, j) + C_r(j, i)) / n_realizations;
+      }
+    }
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong j = 0; j < i; ++j) {
+        const double J_r_ij = 0.5 * (J_r(i, j) + J_r(j, i));
+        J_r(i, j) = J_r_ij;
+        J_r(j, i) = J_r_ij;
+      }
+    }
+
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong j = 0; j < n_nodes; ++j) {
+        const double E_ijj = pairwise_cumulant.compute_E_ijk(
+            r, i, j, j, L_r[i], L_r[j], J_r(i, j));
+        const double E_jji = pairwise_cumulant.compute_E_ijk(
+            r, j, j, i, L_r[j], L_r[j], J_r(j, j));
+        expected_K(i, j) += (2 * E_ijj + E_jji) / (3. * n_realizations);
+      }
+    }
+  }
+
+  for (int n_threads : {1, 4}) {
+    HawkesCumulant cumulant(integration_support, n_threads);
+    cumulant.set_data(timestamps_list, end_times);
+    cumulant.compute_cumulants();
+    EXPECT_TRUE(cumulant.get_are_cumulants_ready());
+
+    ArrayDouble L = *cumulant.get_mean_intensity();
+    ArrayDouble2d C = *cumulant.get_covariance();
+    ArrayDouble2d K = *cumulant.get_skewness();
+    for (ulong i = 0; i < n_nodes; ++i) {
+      EXPECT_DOUBLE_EQ(L[i], expected_L[i]) << n_threads;
+      for (ulong j = 0; j < n_nodes; ++j) {
+        EXPECT_NEAR(C(i, j), expected_C(i, j), 1e-10)
+            << n_threads << " " << i << " " << j;
+        EXPECT_NEAR(K(i, j), expected_K(i, j), 1e-10)
+            << n_threads << " " << i << " " << j;
+      }
+    }
+  }
+}
+
+TEST_F(HawkesCumulantTest, cumulants_not_computed) {
+  HawkesCumulant cumulant(integration_support);
+  EXPECT_THROW(cumulant.compute_cumulants(), std::runtime_error);
+  cumulant.set_data(timestamps_list, end_times);
+  EXPECT_THROW(cumulant.get_covariance(), std::runtime_error);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
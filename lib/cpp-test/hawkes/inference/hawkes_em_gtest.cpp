@@ -0,0 +1,429 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_em.h"
+
+namespace {
+
+//! @brief Discretization of kernel_size bins of equal size over support
+ArrayDouble uniform_discretization(const double support,
+                                   const ulong kernel_size) {
+  ArrayDouble discretization(kernel_size + 1);
+  for (ulong m = 0; m <= kernel_size; ++m) {
+    discretization[m] = support * m / kernel_size;
+  }
+  return discretization;
+}
+
+//! @brief One EM iteration as it was computed before the index of pairs of
+//! events, all pairs of events being enumerated and the intensities
+//! recomputed from scratch
+void dense_em_iteration(const SArrayDoublePtrList2D &timestamps_list,
+                        const VArrayDoublePtr end_times,
+                        const ArrayDouble &discretization, ArrayDouble &mu,
+                        ArrayDouble2d &kernels) {
+  const ulong n_nodes = mu.size();
+  const ulong kernel_size = discretization.size() - 1;
+  const double kernel_support = discretization[kernel_size];
+
+  ArrayDouble n_jumps_per_node(n_nodes);
+  n_jumps_per_node.init_to_zero();
+  for (auto &realization : timestamps_list) {
+    for (ulong v = 0; v < n_nodes; ++v) {
+      n_jumps_per_node[v] += realization[v]->size();
+    }
+  }
+
+  ArrayDouble next_mu(n_nodes);
+  next_mu.init_to_zero();
+  ArrayDouble2d next_kernels(n_nodes, n_nodes * kernel_size);
+  next_kernels.init_to_zero();
+  std::vector<double> unnormalized_kernel(n_nodes * kernel_size);
+
+  for (auto &realization : timestamps_list) {
+    for (ulong u = 0; u < n_nodes; ++u) {
+      ArrayDouble timestamps_u = view(*realization[u]);
+      for (ulong i = 0; i < timestamps_u.size(); ++i) {
+        std::fill(unnormalized_kernel.begin(), unnormalized_kernel.end(), 0.);
+        double intensity = mu[u];
+        for (ulong v = 0; v < n_nodes; ++v) {
+          ArrayDouble timestamps_v = view(*realization[v]);
+          for (ulong j = 0; j < timestamps_v.size(); ++j) {
+            const double t_diff = timestamps_u[i] - timestamps_v[j];
+            if (t_diff <= 0 || t_diff >= kernel_support) continue;
+            ulong m = 0;
+            while (discretization[m + 1] < t_diff) ++m;
+            unnormalized_kernel[v * kernel_size + m] +=
+                kernels(u, v * kernel_size + m);
+            intensity += kernels(u, v * kernel_size + m);
+          }
+        }
+        if (intensity == 0) continue;
+
+        next_mu[u] += mu[u] / (intensity * end_times->sum());
+        for (ulong v = 0; v < n_nodes; ++v) {
+          for (ulong m = 0; m < kernel_size; ++m) {
+            const double kernel_dt = discretization[m + 1] - discretization[m];
+            next_kernels(u, v * kernel_size + m) +=
+                unnormalized_kernel[v * kernel_size + m] /
+                (intensity * n_jumps_per_node[v] * kernel_dt);
+          }
+        }
+      }
+    }
+  }
+  mu = next_mu;
+  kernels = next_kernels;
+}
+
+void expect_relative_near(const ArrayDouble &actual,
+                          const ArrayDouble &expected, const double tol) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (ulong j = 0; j < actual.size(); ++j) {
+    EXPECT_NEAR(actual[j], expected[j],
+                tol * std::max(1., std::abs(expected[j])))
+        << j;
+  }
+}
+
+}  // namespace
+
+class HawkesEMTest : public ::testing::Test {
+ protected:
+  const ulong n_nodes = 3;
+  SArrayDoublePtrList2D timestamps_list;
+  VArrayDoublePtr end_times;
+
+  void SetUp() override {
+    // Several realizations of different lengths and numbers of events
+    std::mt19937 generator(1309);
+    const std::vector<double> lengths{20., 12.5, 17.};
+    const std::vector<ulong> n_events{40, 25, 10};
+    end_times = VArrayDouble::new_ptr(lengths.size());
+    timestamps_list = SArrayDoublePtrList2D(0);
+    for (ulong r = 0; r < lengths.size(); ++r) {
+      (*end_times)[r] = lengths[r];
+      std::uniform_real_distribution<double> uniform(0., lengths[r]);
+      SArrayDoublePtrList1D realization(0);
+      for (ulong u = 0; u < n_nodes; ++u) {
+        std::vector<double> times(n_events[(r + u) % n_events.size()]);
+        for (double &time : times) time = uniform(generator);
+        std::sort(times.begin(), times.end());
+        ArrayDouble timestamps_u(times.size(), times.data());
+        realization.push_back(SArrayDouble::new_ptr(timestamps_u));
+      }
+      timestamps_list.push_back(realization);
+    }
+  }
+
+  void get_starting_point(const ulong kernel_size, ArrayDouble &mu,
+                          ArrayDouble2d &kernels) const {
+    mu = ArrayDouble(n_nodes);
+    kernels = ArrayDouble2d(n_nodes, n_nodes * kernel_size);
+    for (ulong u = 0; u < n_nodes; ++u) {
+      mu[u] = 0.5 + 0.2 * u;
+      for (ulong k = 0; k < n_nodes * kernel_size; ++k) {
+        kernels(u, k) = 0.1 + 0.05 * ((u + 2 * k) % 7);
+      }
+    }
+  }
+};
+
+TEST_F(HawkesEMTest, solve_matches_dense_em) {
+  const double kernel_support = 1.5;
+  const ulong kernel_size = 6;
+  ArrayDouble explicit_discretization{0., 0.1, 0.3, 0.7, 1.5};
+
+  for (bool uniform : {true, false}) {
+    for (int n_threads : {1, 4}) {
+      ArrayDouble discretization =
+          uniform ? uniform_discretization(kernel_support, kernel_size)
+                  : explicit_discretization;
+      std::unique_ptr<HawkesEM> em;
+      if (uniform) {
+        em.reset(new HawkesEM(kernel_support, kernel_size, n_threads));
+      } else {
+        em.reset(new HawkesEM(SArrayDouble::new_ptr(explicit_discretization),
+                              n_threads));
+      }
+      em->set_data(timestamps_list, end_times);
+
+      ArrayDouble mu, dense_mu;
+      ArrayDouble2d kernels, dense_kernels;
+      get_starting_point(discretization.size() - 1, mu, kernels);
+      get_starting_point(discretization.size() - 1, dense_mu, dense_kernels);
+
+      for (int iter = 0; iter < 5; ++iter) {
+        em->solve(mu, kernels);
+        dense_em_iteration(timestamps_list, end_times, discretization,
+                           dense_mu, dense_kernels);
+        SCOPED_TRACE(::testing::Message() << "uniform=" << uniform
+                                          << " n_threads=" << n_threads
+                                          << " iter=" << iter);
+        expect_relative_near(mu, dense_mu, 1e-12);
+        expect_relative_near(ArrayDouble(kernels.size(), kernels.data()),
+                             ArrayDouble(dense_kernels.size(),
+                                         dense_kernels.data()),
+                             1e-12);
+      }
+    }
+  }
+}
+
+TEST_F(HawkesEMTest, binned_matches_exact) {
+  const double kernel_support = 1.5;
+  const ulong kernel_size = 6;
+  const ulong fft_binning = 16;
+  const double grid_dt = kernel_support / kernel_size / fft_binning;
+
+  // On timestamps lying on the grid, binning loses nothing
+  SArrayDoublePtrList2D grid_timestamps_list(0);
+  for (auto &realization : timestamps_list) {
+    SArrayDoublePtrList1D grid_realization(0);
+    for (auto &timestamps_u : realization) {
+      ArrayDouble grid_timestamps_u(timestamps_u->size());
+      for (ulong i = 0; i < timestamps_u->size(); ++i) {
+        grid_timestamps_u[i] =
+            std::round((*timestamps_u)[i] / grid_dt) * grid_dt;
+      }
+      grid_realization.push_back(grid_timestamps_u.as_sarray_ptr());
+    }
+    grid_timestamps_list.push_back(grid_realization);
+  }
+
+  // On other timestamps, only the pairs of events closer than a grid step
+  // to a kernel bin boundary might fall in another kernel bin
+  for (bool on_grid : {true, false}) {
+    auto &data = on_grid ? grid_timestamps_list : timestamps_list;
+    const double tol = on_grid ? 1e-9 : 2e-2;
+    const ulong data_fft_binning = on_grid ? fft_binning : 500;
+
+    HawkesEM exact_em(kernel_support, kernel_size, 2);
+    exact_em.set_data(data, end_times);
+    HawkesEM binned_em(kernel_support, kernel_size, 2);
+    binned_em.set_fft_binning(data_fft_binning);
+    binned_em.set_data(data, end_times);
+
+    ArrayDouble mu, binned_mu;
+    ArrayDouble2d kernels, binned_kernels;
+    get_starting_point(kernel_size, mu, kernels);
+    get_starting_point(kernel_size, binned_mu, binned_kernels);
+
+    for (int iter = 0; iter < 5; ++iter) {
+      SCOPED_TRACE(::testing::Message() << "on_grid=" << on_grid
+                                        << " iter=" << iter);
+      EXPECT_NEAR(binned_em.loglikelihood(binned_mu, binned_kernels),
+                  exact_em.loglikelihood(mu, kernels), tol);
+
+      exact_em.solve(mu, kernels);
+      binned_em.solve(binned_mu, binned_kernels);
+      expect_relative_near(binned_mu, mu, tol);
+      expect_relative_near(
+          ArrayDouble(binned_kernels.size(), binned_kernels.data()),
+          ArrayDouble(kernels.size(), kernels.data()), tol);
+    }
+  }
+}
+
+TEST_F(HawkesEMTest, residuals_match_kernel_overlaps) {
+  ArrayDouble explicit_discretization{0., 0.1, 0.3, 0.7, 1.5};
+
+  for (bool uniform : {true, false}) {
+    for (int n_threads : {1, 4}) {
+      ArrayDouble discretization = uniform ? uniform_discretization(1.5, 6)
+                                           : explicit_discretization;
+      const ulong kernel_size = discretization.size() - 1;
+      std::unique_ptr<HawkesEM> em;
+      if (uniform) {
+        em.reset(new HawkesEM(1.5, kernel_size, n_threads));
+      } else {
+        em.reset(new HawkesEM(SArrayDouble::new_ptr(explicit_discretization),
+                              n_threads));
+      }
+      em->set_data(timestamps_list, end_times);
+
+      ArrayDouble mu;
+      ArrayDouble2d kernels;
+      get_starting_point(kernel_size, mu, kernels);
+      SArrayDoublePtrList2D residuals = em->get_residuals(mu, kernels);
+
+      ASSERT_EQ(residuals.size(), timestamps_list.size());
+      for (ulong r = 0; r < timestamps_list.size(); ++r) {
+        ASSERT_EQ(residuals[r].size(), n_nodes);
+        for (ulong u = 0; u < n_nodes; ++u) {
+          const ArrayDouble &timestamps_u = *timestamps_list[r][u];
+          ASSERT_EQ(residuals[r][u]->size(), timestamps_u.size());
+          double t_previous = 0;
+          for (ulong k = 0; k < timestamps_u.size(); ++k) {
+            // Kernels are integrated between t_previous and t_k bin by bin
+            const double t_k = timestamps_u[k];
+            double expected = mu[u] * (t_k - t_previous);
+            for (ulong v = 0; v < n_nodes; ++v) {
+              const ArrayDouble &timestamps_v = *timestamps_list[r][v];
+              for (ulong p = 0; p < timestamps_v.size(); ++p) {
+                for (ulong m = 0; m < kernel_size; ++m) {
+                  const double start = std::max(
+                      t_previous, timestamps_v[p] + discretization[m]);
+                  const double end =
+                      std::min(t_k, timestamps_v[p] + discretization[m + 1]);
+                  if (end > start) {
+                    expected += kernels(u, v * kernel_size + m) * (end - start);
+                  }
+                }
+              }
+            }
+            EXPECT_NEAR((*residuals[r][u])[k], expected, 1e-12)
+                << "uniform=" << uniform << " n_threads=" << n_threads
+                << " r=" << r << " u=" << u << " k=" << k;
+            t_previous = t_k;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(HawkesEMTest, residuals_check_shapes) {
+  HawkesEM em(1.5, 6);
+  em.set_data(timestamps_list, end_times);
+  ArrayDouble mu;
+  ArrayDouble2d kernels;
+  get_starting_point(5, mu, kernels);
+  EXPECT_THROW(em.get_residuals(mu, kernels), std::runtime_error);
+}
+
+TEST_F(HawkesEMTest, fit_selects_best_finite_start) {
+  const double kernel_support = 1.5;
+  const ulong kernel_size = 5;
+  const ulong max_iter = 6;
+  const ulong record_every = 2;
+  const ulong n_starts = 3;
+  const ulong n_kernel_values = n_nodes * n_nodes * kernel_size;
+
+  // The first starting point has no baseline nor kernels, its intensity is
+  // zero at every event and its log-likelihood -inf
+  ArrayDouble mu;
+  ArrayDouble2d kernels;
+  get_starting_point(kernel_size, mu, kernels);
+  ArrayDouble2d mu_starts(n_starts, n_nodes);
+  ArrayDouble2d kernels_starts(n_starts, n_kernel_values);
+  mu_starts.init_to_zero();
+  kernels_starts.init_to_zero();
+  for (ulong k = 0; k < n_nodes; ++k) {
+    mu_starts(1, k) = mu[k];
+    mu_starts(2, k) = 3 * mu[k];
+  }
+  for (ulong k = 0; k < n_kernel_values; ++k) {
+    kernels_starts(1, k) = kernels[k];
+    kernels_starts(2, k) = 0.2 * kernels[k];
+  }
+
+  for (int n_threads : {1, 4}) {
+    HawkesEM em(kernel_support, kernel_size, n_threads);
+    em.set_data(timestamps_list, end_times);
+    ArrayDouble2d fitted_mu = mu_starts, fitted_kernels = kernels_starts;
+    // A negative tolerance is never reached, even by the first starting
+    // point which does not move
+    const ulong best_start =
+        em.fit(fitted_mu, fitted_kernels, max_iter, -1., record_every);
+
+    ArrayDouble loglikelihoods(n_starts);
+    for (ulong start = 0; start < n_starts; ++start) {
+      SCOPED_TRACE(::testing::Message() << "n_threads=" << n_threads
+                                        << " start=" << start);
+      ArrayDouble start_mu(n_nodes);
+      start_mu.mult_fill(view_row(mu_starts, start), 1.);
+      ArrayDouble2d start_kernels(n_nodes, n_nodes * kernel_size);
+      std::copy(view_row(kernels_starts, start).data(),
+                view_row(kernels_starts, start).data() + n_kernel_values,
+                start_kernels.data());
+      std::vector<double> expected_iters, expected_llhs;
+      for (ulong iter = 0; iter < max_iter; ++iter) {
+        em.solve(start_mu, start_kernels);
+        if (iter % record_every == 0 || iter + 1 == max_iter) {
+          expected_iters.push_back(iter);
+          expected_llhs.push_back(em.loglikelihood(start_mu, start_kernels));
+        }
+      }
+      loglikelihoods[start] = expected_llhs.back();
+
+      expect_relative_near(view_row(fitted_mu, start), start_mu, 1e-12);
+      expect_relative_near(
+          view_row(fitted_kernels, start),
+          ArrayDouble(start_kernels.size(), start_kernels.data()), 1e-12);
+
+      ArrayDouble2d history = *em.get_fit_history(start);
+      ASSERT_EQ(history.n_rows(), expected_iters.size());
+      for (ulong k = 0; k < history.n_rows(); ++k) {
+        EXPECT_EQ(history(k, 0), expected_iters[k]) << k;
+        if (start == 0) {
+          EXPECT_EQ(history(k, 3), -std::numeric_limits<double>::infinity())
+              << k;
+        } else {
+          EXPECT_NEAR(history(k, 3), expected_llhs[k],
+                      1e-10 * std::abs(expected_llhs[k]))
+              << k;
+        }
+      }
+    }
+
+    // std::isfinite is optimized away with -ffast-math
+    EXPECT_EQ(loglikelihoods[0], -std::numeric_limits<double>::infinity());
+    EXPECT_GT(loglikelihoods[1], std::numeric_limits<double>::lowest());
+    EXPECT_GT(loglikelihoods[2], std::numeric_limits<double>::lowest());
+    EXPECT_EQ(best_start, loglikelihoods[1] > loglikelihoods[2] ? 1u : 2u)
+        << n_threads;
+  }
+}
+
+TEST_F(HawkesEMTest, fit_records_last_iteration) {
+  const ulong kernel_size = 5;
+  const ulong max_iter = 4;
+  HawkesEM em(1.5, kernel_size);
+  em.set_data(timestamps_list, end_times);
+
+  ArrayDouble mu;
+  ArrayDouble2d kernels;
+  get_starting_point(kernel_size, mu, kernels);
+  ArrayDouble2d mu_starts(1, n_nodes, mu.data());
+  ArrayDouble2d kernels_starts(1, kernels.size(), kernels.data());
+  ArrayDouble2d fitted_mu = mu_starts, fitted_kernels = kernels_starts;
+
+  // Without recording, all iterations are run and only the last one is kept
+  EXPECT_EQ(em.fit(fitted_mu, fitted_kernels, max_iter, 1e10, 0), 0u);
+  ArrayDouble2d history = *em.get_fit_history(0);
+  ASSERT_EQ(history.n_rows(), 1u);
+  EXPECT_EQ(history(0, 0), max_iter - 1);
+  ArrayDouble last_mu = view_row(fitted_mu, 0);
+  ArrayDouble2d last_kernels(n_nodes, n_nodes * kernel_size,
+                             fitted_kernels.data());
+  const double llh = em.loglikelihood(last_mu, last_kernels);
+  EXPECT_NEAR(history(0, 3), llh, 1e-10 * std::abs(llh));
+
+  // A single starting point with a zero intensity is still returned, it
+  // does not move and stops at the first iteration
+  ArrayDouble2d zero_mu(1, n_nodes), zero_kernels(1, kernels.size());
+  zero_mu.init_to_zero();
+  zero_kernels.init_to_zero();
+  EXPECT_EQ(em.fit(zero_mu, zero_kernels, max_iter, 0., 1), 0u);
+  history = *em.get_fit_history(0);
+  ASSERT_EQ(history.n_rows(), 1u);
+  EXPECT_EQ(history(0, 3), -std::numeric_limits<double>::infinity());
+  EXPECT_THROW(em.get_fit_history(1), std::runtime_error);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
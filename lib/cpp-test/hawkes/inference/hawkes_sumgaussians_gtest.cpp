@@ -0,0 +1,249 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/inference/hawkes_sumgaussians.h"
+
+namespace {
+
+void expect_relative_near(const ArrayDouble &actual,
+                          const ArrayDouble &expected, const double tol) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (ulong j = 0; j < actual.size(); ++j) {
+    EXPECT_NEAR(actual[j], expected[j],
+                tol * std::max(1., std::abs(expected[j])))
+        << j;
+  }
+}
+
+double relative_distance(const ArrayDouble &new_values,
+                         const ArrayDouble &old_values) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < new_values.size(); ++j) {
+    norm_diff += (new_values[j] - old_values[j]) *
+                 (new_values[j] - old_values[j]);
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+ArrayDouble flat(const ArrayDouble2d &matrix) {
+  return ArrayDouble(matrix.size(), matrix.data());
+}
+
+}  // namespace
+
+class HawkesSumGaussiansTest : public ::testing::Test {
+ protected:
+  const ulong n_nodes = 3;
+  const ulong n_gaussians = 5;
+  const double max_mean_gaussian = 2.;
+  SArrayDoublePtrList2D timestamps_list;
+  VArrayDoublePtr end_times;
+
+  void SetUp() override {
+    std::mt19937 generator(4021);
+    const std::vector<double> lengths{25., 18.};
+    const std::vector<ulong> n_events{50, 30, 70};
+    end_times = VArrayDouble::new_ptr(lengths.size());
+    timestamps_list = SArrayDoublePtrList2D(0);
+    for (ulong r = 0; r < lengths.size(); ++r) {
+      (*end_times)[r] = lengths[r];
+      std::uniform_real_distribution<double> uniform(0., lengths[r]);
+      SArrayDoublePtrList1D realization(0);
+      for (ulong u = 0; u < n_nodes; ++u) {
+        std::vector<double> times(n_events[(r + u) % n_events.size()]);
+        for (double &time : times) time = uniform(generator);
+        std::sort(times.begin(), times.end());
+        ArrayDouble timestamps_u(times.size(), times.data());
+        realization.push_back(SArrayDouble::new_ptr(timestamps_u));
+      }
+      timestamps_list.push_back(realization);
+    }
+  }
+
+  void get_starting_point(ArrayDouble &mu, ArrayDouble2d &amplitudes) const {
+    mu = ArrayDouble(n_nodes);
+    amplitudes = ArrayDouble2d(n_nodes, n_nodes * n_gaussians);
+    for (ulong u = 0; u < n_nodes; ++u) {
+      mu[u] = 0.4 + 0.3 * u;
+      for (ulong k = 0; k < n_nodes * n_gaussians; ++k) {
+        amplitudes(u, k) = 0.05 + 0.02 * ((3 * u + k) % 5);
+      }
+    }
+  }
+};
+
+TEST_F(HawkesSumGaussiansTest, lookup_tables_match_exact_evaluation) {
+  const double step_size = 1e-4;
+  const double strength_lasso = 0.01;
+  const double strength_grouplasso = 0.01;
+  const ulong em_max_iter = 3;
+  // Beyond 6 standard deviations, gaussian densities are below 1.6e-8 of
+  // their maximum, and the interpolation of the tables is much more accurate
+  const double tol = 1e-8;
+
+  HawkesSumGaussians exact(n_gaussians, max_mean_gaussian, step_size,
+                           strength_lasso, strength_grouplasso, em_max_iter);
+  exact.set_data(timestamps_list, end_times);
+  ArrayDouble mu;
+  ArrayDouble2d amplitudes;
+  get_starting_point(mu, amplitudes);
+  std::vector<ArrayDouble> exact_mus;
+  std::vector<ArrayDouble2d> exact_amplitudes;
+  for (int iter = 0; iter < 4; ++iter) {
+    exact.solve(mu, amplitudes);
+    exact_mus.push_back(mu);
+    exact_amplitudes.push_back(amplitudes);
+  }
+
+  for (int n_threads : {1, 3}) {
+    for (double n_std_truncation : {6., 8.}) {
+      HawkesSumGaussians truncated(n_gaussians, max_mean_gaussian, step_size,
+                                   strength_lasso, strength_grouplasso,
+                                   em_max_iter, n_threads);
+      truncated.set_n_std_truncation(n_std_truncation);
+      truncated.set_data(timestamps_list, end_times);
+      get_starting_point(mu, amplitudes);
+      for (int iter = 0; iter < 4; ++iter) {
+        truncated.solve(mu, amplitudes);
+        SCOPED_TRACE(::testing::Message()
+                     << "n_threads=" << n_threads
+                     << " n_std_truncation=" << n_std_truncation
+                     << " iter=" << iter);
+        expect_relative_near(mu, exact_mus[iter], tol);
+        expect_relative_near(
+            ArrayDouble(amplitudes.size(), amplitudes.data()),
+            ArrayDouble(exact_amplitudes[iter].size(),
+                        exact_amplitudes[iter].data()),
+            tol);
+      }
+    }
+  }
+}
+
+TEST_F(HawkesSumGaussiansTest, short_truncation_drops_distant_lags) {
+  // With a cutoff of half a standard deviation, most pairs of events are
+  // ignored and the estimates move away from the exact ones
+  HawkesSumGaussians exact(n_gaussians, max_mean_gaussian, 0.01, 1e-3, 1e-3,
+                           2);
+  exact.set_data(timestamps_list, end_times);
+  HawkesSumGaussians truncated(n_gaussians, max_mean_gaussian, 0.01, 1e-3,
+                               1e-3, 2);
+  truncated.set_n_std_truncation(0.5);
+  truncated.set_data(timestamps_list, end_times);
+
+  ArrayDouble mu, truncated_mu;
+  ArrayDouble2d amplitudes, truncated_amplitudes;
+  get_starting_point(mu, amplitudes);
+  get_starting_point(truncated_mu, truncated_amplitudes);
+  exact.solve(mu, amplitudes);
+  truncated.solve(truncated_mu, truncated_amplitudes);
+
+  // Less excitation is seen, hence a larger baseline
+  for (ulong u = 0; u < n_nodes; ++u) EXPECT_GT(truncated_mu[u], mu[u]) << u;
+}
+
+TEST_F(HawkesSumGaussiansTest, n_std_truncation_must_be_non_negative) {
+  HawkesSumGaussians learner(n_gaussians, max_mean_gaussian, 0.01, 1e-3, 1e-3,
+                             2);
+  EXPECT_THROW(learner.set_n_std_truncation(-1.), std::runtime_error);
+  learner.set_n_std_truncation(4.);
+  EXPECT_DOUBLE_EQ(learner.get_n_std_truncation(), 4.);
+}
+
+TEST_F(HawkesSumGaussiansTest, fit_matches_repeated_solve) {
+  const ulong max_iter = 11;
+  const ulong record_every = 3;
+  HawkesSumGaussians learner(n_gaussians, max_mean_gaussian, 0.01, 1e-3, 1e-3,
+                             2, 2);
+  learner.set_data(timestamps_list, end_times);
+
+  ArrayDouble expected_mu, mu;
+  ArrayDouble2d expected_amplitudes, amplitudes;
+  get_starting_point(expected_mu, expected_amplitudes);
+  std::vector<std::vector<double> > expected_history;
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const ArrayDouble previous_mu = expected_mu;
+    const ArrayDouble2d previous_amplitudes = expected_amplitudes;
+    learner.solve(expected_mu, expected_amplitudes);
+    if (iter % record_every == 0 || iter + 1 == max_iter) {
+      expected_history.push_back(
+          {static_cast<double>(iter + 1),
+           relative_distance(expected_mu, previous_mu),
+           relative_distance(flat(expected_amplitudes),
+                             flat(previous_amplitudes))});
+    }
+  }
+
+  // Tolerances of 0 are never reached
+  get_starting_point(mu, amplitudes);
+  EXPECT_EQ(learner.fit(mu, amplitudes, max_iter, 0., 0., record_every),
+            max_iter);
+  expect_relative_near(mu, expected_mu, 1e-12);
+  expect_relative_near(flat(amplitudes), flat(expected_amplitudes), 1e-12);
+
+  ArrayDouble2d history = *learner.get_fit_history();
+  ASSERT_EQ(history.n_rows(), expected_history.size());
+  ASSERT_EQ(history.n_cols(), 3u);
+  for (ulong k = 0; k < history.n_rows(); ++k) {
+    SCOPED_TRACE(::testing::Message() << "record=" << k);
+    expect_relative_near(view_row(history, k),
+                         ArrayDouble(3, expected_history[k].data()), 1e-10);
+  }
+
+  // Without recording, only the last iteration is checked
+  get_starting_point(mu, amplitudes);
+  EXPECT_EQ(learner.fit(mu, amplitudes, max_iter, 0., 0., 0), max_iter);
+  history = *learner.get_fit_history();
+  ASSERT_EQ(history.n_rows(), 1u);
+  expect_relative_near(view_row(history, 0),
+                       ArrayDouble(3, expected_history.back().data()), 1e-10);
+}
+
+TEST_F(HawkesSumGaussiansTest, fit_stops_at_tolerances) {
+  HawkesSumGaussians learner(n_gaussians, max_mean_gaussian, 0.01, 1e-3, 1e-3,
+                             2);
+  learner.set_data(timestamps_list, end_times);
+  ArrayDouble mu;
+  ArrayDouble2d amplitudes;
+
+  // tol is only accepted after 7 iterations
+  get_starting_point(mu, amplitudes);
+  EXPECT_EQ(learner.fit(mu, amplitudes, 20, 1e10, 0.), 7u);
+  EXPECT_EQ(learner.get_fit_history()->n_rows(), 7u);
+
+  // em_tol is accepted at any iteration checked
+  get_starting_point(mu, amplitudes);
+  EXPECT_EQ(learner.fit(mu, amplitudes, 20, 0., 1e10, 4), 1u);
+  ArrayDouble2d history = *learner.get_fit_history();
+  ASSERT_EQ(history.n_rows(), 1u);
+  EXPECT_EQ(history(0, 0), 1.);
+
+  // Negative em_tol adapts to the previous relative change, which starts at
+  // 0.1
+  get_starting_point(mu, amplitudes);
+  const ulong n_iter = learner.fit(mu, amplitudes, 20, 0., -1.);
+  history = *learner.get_fit_history();
+  ASSERT_EQ(history.n_rows(), n_iter);
+  for (ulong k = 0; k < n_iter; ++k) {
+    const double previous_change =
+        k == 0 ? 0.1 : std::max(history(k - 1, 1), history(k - 1, 2));
+    const bool is_below = std::max(history(k, 1), history(k, 2)) <
+                          previous_change * 1e-2;
+    EXPECT_EQ(is_below, k + 1 == n_iter && n_iter < 20) << k;
+  }
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
@@ -266,6 +266,86 @@ TEST_F(HawkesModelTest, compute_loss_loglikelihood) {
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 6);
 }
 
+TEST_F(HawkesModelTest, compute_loss_loglikelihood_float_weights) {
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65;
+  (*end_times)[1] = 5.87;
+
+  ArrayDouble decays{2., 3.};
+  ModelHawkesSumExpKernLogLikDouble model_double(decays, 2);
+  ModelHawkesSumExpKernLogLikFloat model_float(decays, 2);
+  model_double.set_data(timestamps_list, end_times);
+  model_float.set_data(timestamps_list, end_times);
+
+  ArrayDouble coeffs{1., 3., 0.5, 1., 1., 3., 2., 3., 4., 1.};
+  ASSERT_EQ(model_float.get_n_coeffs(), coeffs.size());
+
+  EXPECT_NEAR(model_float.loss(coeffs), model_double.loss(coeffs), 1e-5);
+
+  ArrayDouble grad_double(coeffs.size());
+  ArrayDouble grad_float(coeffs.size());
+  model_double.grad(coeffs, grad_double);
+  model_float.grad(coeffs, grad_float);
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    EXPECT_NEAR(grad_float[j], grad_double[j], 1e-5) << j;
+  }
+}
+
+TEST_F(HawkesModelTest, compute_grad_i_sparse_loglikelihood) {
+  // Middle node has no jumps and must be skipped when mapping samples
+  auto timestamps_3d = SArrayDoublePtrList1D(0);
+  timestamps_3d.push_back(timestamps[0]);
+  timestamps_3d.push_back(ArrayDouble(0).as_sarray_ptr());
+  timestamps_3d.push_back(timestamps[1]);
+
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps_3d);
+  timestamps_list.push_back(timestamps_3d);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65;
+  (*end_times)[1] = 5.87;
+
+  ModelHawkesExpKernLogLik model(2.);
+  model.set_data(timestamps_list, end_times);
+  model.compute_weights();
+
+  ArrayDouble coeffs{1., 3., 2., 3., 4., 1., 0.5, 1.5, 2., 1., 0.5, 3.};
+  const ulong n_coeffs = model.get_n_coeffs();
+  ASSERT_EQ(n_coeffs, coeffs.size());
+
+  ArrayDouble grad_i(n_coeffs);
+  ArrayDouble grad_i_sparse(n_coeffs);
+  std::vector<ulong> support;
+  for (ulong sampled_i = 0; sampled_i < model.get_rand_max(); ++sampled_i) {
+    model.grad_i(sampled_i, coeffs, grad_i);
+
+    grad_i_sparse.fill(-42.);
+    model.grad_i_sparse(sampled_i, coeffs, grad_i_sparse);
+    const ulong node = (sampled_i % 11) < 5 ? 0 : 2;
+    model.get_grad_i_support(sampled_i, support);
+    ASSERT_EQ(support.size(), 1 + model.get_alpha_i_last_index(node) -
+                                  model.get_alpha_i_first_index(node));
+    EXPECT_EQ(support[0], node);
+
+    for (ulong j = 0; j < n_coeffs; ++j) {
+      const bool in_support = j == node ||
+                              (j >= model.get_alpha_i_first_index(node) &&
+                               j < model.get_alpha_i_last_index(node));
+      if (in_support) {
+        EXPECT_DOUBLE_EQ(grad_i_sparse[j], grad_i[j]) << sampled_i << " " << j;
+      } else {
+        EXPECT_DOUBLE_EQ(grad_i_sparse[j], -42.) << sampled_i << " " << j;
+        EXPECT_DOUBLE_EQ(grad_i[j], 0.) << sampled_i << " " << j;
+      }
+    }
+  }
+  EXPECT_THROW(model.grad_i_sparse(model.get_rand_max(), coeffs, grad_i_sparse),
+               std::runtime_error);
+}
+
 TEST_F(HawkesModelTest, compute_loss_loglikelihood_sparse) {
   ModelHawkesExpKernLogLikSingle model(2);
   auto sparse_timestamps = SArrayDoublePtrList1D(0);
@@ -425,6 +505,45 @@ TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_varying_baseline) {
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 14);
 }
 
+TEST_F(HawkesModelTest, compute_grad_least_square_sum_exp_varying_baseline) {
+  ArrayDouble decays{2., 3.};
+
+  const double end_time = 5.87;
+  ModelHawkesSumExpKernLeastSqSingle model(decays, 3, 2., 2);
+  model.set_data(timestamps, end_time);
+  model.compute_weights();
+
+  ArrayDouble coeffs{1., 3., 0., 1., 1., 3., 2., 3., 4., 1., 5., 3., 2., 4.};
+  const ulong n_coeffs = model.get_n_coeffs();
+  ASSERT_EQ(n_coeffs, coeffs.size());
+
+  ArrayDouble grad(n_coeffs);
+  model.grad(coeffs, grad);
+
+  // The loss is quadratic, hence centered finite differences are exact up to
+  // rounding errors
+  const double eps = 1e-3;
+  for (ulong k = 0; k < n_coeffs; ++k) {
+    ArrayDouble coeffs_plus = coeffs;
+    ArrayDouble coeffs_minus = coeffs;
+    coeffs_plus[k] += eps;
+    coeffs_minus[k] -= eps;
+    const double finite_diff =
+        (model.loss(coeffs_plus) - model.loss(coeffs_minus)) / (2 * eps);
+    EXPECT_NEAR(grad[k], finite_diff, 1e-6 * std::max(1., std::abs(grad[k])));
+  }
+
+  ArrayDouble grad_i(n_coeffs);
+  for (ulong i = 0; i < model.get_n_nodes(); ++i) model.grad_i(i, coeffs, grad_i);
+  grad_i /= model.get_n_total_jumps();
+  for (ulong k = 0; k < n_coeffs; ++k) EXPECT_NEAR(grad[k], grad_i[k], 1e-10);
+
+  double sum_loss_i = 0;
+  for (ulong i = 0; i < model.get_n_nodes(); ++i)
+    sum_loss_i += model.loss_i(i, coeffs);
+  EXPECT_DOUBLE_EQ(model.loss(coeffs), sum_loss_i / model.get_n_total_jumps());
+}
+
 TEST_F(HawkesModelTest, hawkes_least_squares_sum_exp_serialization) {
   ArrayDouble decays{2., 3.};
 
@@ -485,6 +604,68 @@ TEST_F(HawkesModelTest, compute_loss_least_square_list) {
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 6u);
 }
 
+TEST_F(HawkesModelTest, compute_loss_least_square_adjacency_mask) {
+  ArrayDouble2d decays(2, 2);
+  decays(0, 0) = 2.;
+  decays(0, 1) = 3.;
+  decays(1, 0) = 1.5;
+  decays(1, 1) = 2.5;
+
+  ArrayULong2d adjacency_mask(2, 2);
+  adjacency_mask.fill(1);
+  adjacency_mask(0, 1) = 0;
+
+  auto sdecays = decays.as_sarray2d_ptr();
+  auto sadjacency_mask = adjacency_mask.as_sarray2d_ptr();
+
+  ModelHawkesExpKernLeastSqSingle full_model(sdecays, 2);
+  full_model.set_data(timestamps, 5.65);
+  full_model.compute_weights();
+
+  ModelHawkesExpKernLeastSqSingle masked_model(sdecays, 2);
+  masked_model.set_adjacency_mask(sadjacency_mask);
+  masked_model.set_data(timestamps, 5.65);
+  masked_model.compute_weights();
+
+  // Coefficients outside of the mask are ignored by the masked model
+  ArrayDouble coeffs = ArrayDouble{1., 3., 2., 0., 4., 1};
+  ArrayDouble masked_coeffs = ArrayDouble{1., 3., 2., 7., 4., 1};
+
+  EXPECT_DOUBLE_EQ(masked_model.loss_i(0, masked_coeffs),
+                   full_model.loss_i(0, coeffs));
+  EXPECT_DOUBLE_EQ(masked_model.loss_i(1, masked_coeffs),
+                   full_model.loss_i(1, coeffs));
+  EXPECT_DOUBLE_EQ(masked_model.loss(masked_coeffs), full_model.loss(coeffs));
+
+  ArrayDouble grad(full_model.get_n_coeffs());
+  full_model.grad(coeffs, grad);
+  ArrayDouble masked_grad(masked_model.get_n_coeffs());
+  masked_model.grad(masked_coeffs, masked_grad);
+
+  for (ulong i = 0; i < masked_model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    if (i == 3) {
+      EXPECT_DOUBLE_EQ(masked_grad[i], 0);
+    } else {
+      EXPECT_DOUBLE_EQ(masked_grad[i], grad[i]);
+    }
+  }
+
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65;
+  (*end_times)[1] = 5.65;
+
+  ModelHawkesExpKernLeastSq masked_list_model(sdecays, 2);
+  masked_list_model.set_adjacency_mask(sadjacency_mask);
+  masked_list_model.set_data(timestamps_list, end_times);
+
+  EXPECT_DOUBLE_EQ(masked_list_model.loss_i(1, masked_coeffs),
+                   2 * full_model.loss_i(1, coeffs));
+}
+
 TEST_F(HawkesModelTest, least_square_list_serialization) {
   ArrayDouble2d decays(2, 2);
   decays.fill(2);
@@ -680,6 +861,89 @@ TEST_F(HawkesModelTest, compute_loss_loglikelihood_list_sum_exp_kern) {
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 14);
 }
 
+TEST_F(HawkesModelTest, compute_residuals_loglikelihood_sum_exp_kern) {
+  ArrayDouble decays{1., 2., 3.};
+  const ulong n_nodes = timestamps.size();
+  const ulong n_decays = decays.size();
+
+  ModelHawkesSumExpKernLogLik model(decays, 2);
+  model.incremental_set_data(timestamps, 5.65);
+  model.incremental_set_data(timestamps, 5.87);
+
+  ArrayDouble coeffs =
+      ArrayDouble{1., 3., 2., 3., 4., 1., 5., 3., 2., 4., 2., 3., 4., 5.};
+  SArrayDoublePtrList2D residuals = model.get_residuals(coeffs);
+
+  ASSERT_EQ(residuals.size(), 2u);
+  for (ulong r = 0; r < 2; ++r) {
+    ASSERT_EQ(residuals[r].size(), n_nodes);
+    for (ulong i = 0; i < n_nodes; ++i) {
+      const ArrayDouble &t_i = *timestamps[i];
+      ASSERT_EQ(residuals[r][i]->size(), t_i.size());
+
+      // Compensator of node i between its consecutive jumps, computed jump
+      // by jump
+      double t_previous = 0;
+      for (ulong k = 0; k < t_i.size(); ++k) {
+        double expected = coeffs[i] * (t_i[k] - t_previous);
+        for (ulong j = 0; j < n_nodes; ++j) {
+          const ArrayDouble &t_j = *timestamps[j];
+          for (ulong l = 0; l < t_j.size() && t_j[l] < t_i[k]; ++l) {
+            for (ulong u = 0; u < n_decays; ++u) {
+              const double alpha =
+                  coeffs[n_nodes + (i * n_nodes + j) * n_decays + u];
+              const double start = std::max(t_previous, t_j[l]);
+              expected += alpha * (std::exp(-decays[u] * (start - t_j[l])) -
+                                   std::exp(-decays[u] * (t_i[k] - t_j[l])));
+            }
+          }
+        }
+        EXPECT_NEAR((*residuals[r][i])[k], expected, 1e-12) << r << i << k;
+        t_previous = t_i[k];
+      }
+    }
+  }
+}
+
+TEST_F(HawkesModelTest, compute_weights_loglikelihood_list_time_chunks) {
+  // Large enough realization for its (r, i, j) triplets to be split in time
+  const ulong n_jumps = 40000;
+  const double end_time = n_jumps * 0.01 + 1.;
+  auto long_timestamps = SArrayDoublePtrList1D(0);
+  for (ulong i = 0; i < 2; ++i) {
+    ArrayDouble t_i(n_jumps);
+    for (ulong k = 0; k < n_jumps; ++k) {
+      t_i[k] = k * 0.01 + 0.004 * (1 + std::sin(1.3 * k + i));
+    }
+    long_timestamps.push_back(t_i.as_sarray_ptr());
+  }
+
+  ArrayDouble decays{2., 30.};
+  ModelHawkesSumExpKernLogLikSingle model_single(decays, 1);
+  model_single.set_data(long_timestamps, end_time);
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(long_timestamps);
+  auto end_times = VArrayDouble::new_ptr(1);
+  (*end_times)[0] = end_time;
+  ModelHawkesSumExpKernLogLik model_list(decays, 8);
+  model_list.set_data(timestamps_list, end_times);
+
+  ArrayDouble coeffs{1., 3., 0.5, 1., 1., 3., 2., 3., 4., 1.};
+  const double loss_single = model_single.loss(coeffs);
+  EXPECT_NEAR(model_list.loss(coeffs), loss_single,
+              1e-10 * std::abs(loss_single));
+
+  ArrayDouble grad_single(coeffs.size());
+  ArrayDouble grad_list(coeffs.size());
+  model_single.grad(coeffs, grad_single);
+  model_list.grad(coeffs, grad_list);
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    EXPECT_NEAR(grad_list[j], grad_single[j],
+                1e-10 * std::abs(grad_single[j]))
+        << j;
+  }
+}
+
 TEST_F(HawkesModelTest, compute_hessian_loglikelihood) {
   ModelHawkesExpKernLogLikSingle model(2);
   model.set_data(timestamps, 4.25);
@@ -0,0 +1,136 @@
+// License: BSD 3 clause
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/simulation/hawkes_intensity_filter.h"
+
+class HawkesIntensityFilterTest : public ::testing::Test {
+ protected:
+  ArrayDouble baseline{0.3, 0.5};
+  ArrayDouble decays{0.7, 3.};
+  ArrayDouble2d adjacency;
+  ArrayULong nodes{0, 1, 1, 0, 1};
+  ArrayDouble times{0.5, 1.1, 1.3, 2.7, 4.};
+
+  void SetUp() override {
+    // adjacency(i, j * n_decays + u) is the intensity of j -> i for decay u
+    adjacency = ArrayDouble2d(2, 4);
+    adjacency.init_to_zero();
+    adjacency(0, 0) = 0.2;
+    adjacency(0, 3) = 0.1;
+    adjacency(1, 0) = 0.4;
+    adjacency(1, 1) = 0.3;
+  }
+
+  double naive_intensity(ulong i, double t, ulong n_events) {
+    double intensity = baseline[i];
+    for (ulong k = 0; k < n_events; ++k) {
+      if (times[k] >= t) continue;
+      for (ulong u = 0; u < decays.size(); ++u) {
+        intensity += adjacency(i, nodes[k] * decays.size() + u) * decays[u] *
+                     std::exp(-decays[u] * (t - times[k]));
+      }
+    }
+    return intensity;
+  }
+
+  double naive_compensator(ulong i, double t0, double t1, ulong n_events) {
+    double compensator = baseline[i] * (t1 - t0);
+    for (ulong k = 0; k < n_events; ++k) {
+      for (ulong u = 0; u < decays.size(); ++u) {
+        compensator += adjacency(i, nodes[k] * decays.size() + u) *
+                       (std::exp(-decays[u] * (t0 - times[k])) -
+                        std::exp(-decays[u] * (t1 - times[k])));
+      }
+    }
+    return compensator;
+  }
+};
+
+TEST_F(HawkesIntensityFilterTest, intensity_and_compensator) {
+  HawkesIntensityFilter filter(baseline, adjacency, decays);
+  ArrayDouble intensities(2), compensators(2);
+
+  for (ulong k = 0; k < times.size(); ++k) {
+    filter.on_event(nodes[k], times[k]);
+    const double t = times[k] + 0.25;
+    filter.intensity(t, intensities);
+    filter.compensator(t, t + 1.5, compensators);
+    for (ulong i = 0; i < 2; ++i) {
+      EXPECT_NEAR(intensities[i], naive_intensity(i, t, k + 1), 1e-12);
+      EXPECT_DOUBLE_EQ(filter.get_intensity(i, t), intensities[i]);
+      EXPECT_NEAR(compensators[i], naive_compensator(i, t, t + 1.5, k + 1),
+                  1e-12);
+    }
+  }
+  EXPECT_THROW(filter.on_event(0, 1.), std::runtime_error);
+}
+
+TEST_F(HawkesIntensityFilterTest, on_events) {
+  HawkesIntensityFilter filter(baseline, adjacency, decays);
+  ArrayDouble event_intensities(times.size());
+  filter.on_events(nodes, times, event_intensities);
+  for (ulong k = 0; k < times.size(); ++k) {
+    EXPECT_NEAR(event_intensities[k], naive_intensity(nodes[k], times[k], k),
+                1e-12);
+  }
+  EXPECT_DOUBLE_EQ(filter.get_last_time(), times[times.size() - 1]);
+
+  // Far away events force the reference time to move
+  filter.on_event(1, 1000.);
+  filter.on_event(0, 1000.5);
+  EXPECT_NEAR(filter.get_intensity(0, 1001.),
+              baseline[0] + 0.1 * 3. * std::exp(-3. * 1.) +
+                  0.2 * 0.7 * std::exp(-0.7 * 0.5),
+              1e-12);
+
+  filter.reset();
+  EXPECT_DOUBLE_EQ(filter.get_intensity(1, 0.), baseline[1]);
+}
+
+TEST_F(HawkesIntensityFilterTest, stale_nodes) {
+  // Node 1 is only excited by node 0, and keeps its slow excitation while
+  // the events of node 1 move the reference time
+  decays = ArrayDouble{0.01, 5.};
+  adjacency.init_to_zero();
+  adjacency(0, 2) = 0.2;
+  adjacency(0, 3) = 0.1;
+  adjacency(1, 0) = 0.4;
+  adjacency(1, 1) = 0.3;
+  nodes = ArrayULong{0, 1, 1, 1, 1, 0, 1};
+  times = ArrayDouble{1., 25., 50., 75., 100., 130., 131.};
+
+  HawkesIntensityFilter filter(baseline, adjacency, decays);
+  ArrayDouble intensities(2), compensators(2);
+  for (ulong k = 0; k < times.size(); ++k) {
+    EXPECT_NEAR(filter.get_intensity(nodes[k], times[k]),
+                naive_intensity(nodes[k], times[k], k), 1e-12);
+    filter.on_event(nodes[k], times[k]);
+    const double t = times[k] + 0.1;
+    filter.intensity(t, intensities);
+    filter.compensator(t, t + 10., compensators);
+    for (ulong i = 0; i < 2; ++i) {
+      SCOPED_TRACE(::testing::Message() << "k=" << k << " i=" << i);
+      EXPECT_NEAR(intensities[i], naive_intensity(i, t, k + 1), 1e-12);
+      EXPECT_DOUBLE_EQ(filter.get_intensity(i, t), intensities[i]);
+      EXPECT_NEAR(compensators[i], naive_compensator(i, t, t + 10., k + 1),
+                  1e-12);
+    }
+  }
+  // The slow excitation of node 1 is still there
+  EXPECT_GT(filter.get_intensity(1, 131.5) - baseline[1], 0.3 * 0.01 * 0.2);
+}
+
+TEST_F(HawkesIntensityFilterTest, wrong_arguments) {
+  HawkesIntensityFilter filter(baseline, adjacency, decays);
+  EXPECT_THROW(filter.on_event(2, 1.), std::runtime_error);
+  EXPECT_THROW(filter.get_intensity(2, 1.), std::runtime_error);
+
+  ArrayULong wrong_nodes{0, 2};
+  ArrayDouble two_times{0.5, 1.}, event_intensities(2);
+  EXPECT_THROW(filter.on_events(wrong_nodes, two_times, event_intensities),
+               std::runtime_error);
+  ArrayULong two_nodes{0, 1};
+  ArrayDouble unsorted_times{1., 0.5};
+  EXPECT_THROW(filter.on_events(two_nodes, unsorted_times, event_intensities),
+               std::runtime_error);
+}
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <complex>
 #include <numeric>
+#include <typeinfo>
+#include <vector>
 
 #define DEBUG_COSTLY_THROW 1
 #define TICK_TEST_DATA_SIZE (1000)
@@ -10,7 +12,17 @@
 #include <gtest/gtest.h>
 
 #include "tick/array/array.h"
+#include "tick/linear_model/model_hinge.h"
 #include "tick/linear_model/model_linreg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/linear_model/model_poisreg.h"
+#include "tick/linear_model/model_quadratic_hinge.h"
+#include "tick/linear_model/model_smoothed_hinge.h"
+#include "tick/robust/model_absolute_regression.h"
+#include "tick/robust/model_epsilon_insensitive.h"
+#include "tick/robust/model_huber.h"
+#include "tick/robust/model_linreg_with_intercepts.h"
+#include "tick/robust/model_modified_huber.h"
 
 #include <cereal/types/memory.hpp>
 #include <cereal/types/unordered_map.hpp>
@@ -127,6 +139,108 @@ TEST(Model, SerializationBinary) {
                                  cereal::PortableBinaryOutputArchive>();
 }
 
+namespace {
+
+const ulong batch_n_samples = 7;
+const ulong batch_n_features = 5;
+
+ArrayDouble2d get_batch_features() {
+  ArrayDouble2d features(batch_n_samples, batch_n_features);
+  for (ulong k = 0; k < features.size(); ++k) {
+    // About one entry out of three is zero
+    features[k] = k % 3 == 1 ? 0 : std::sin(1.3 * k + 0.4);
+  }
+  return features;
+}
+
+SSparseArrayDouble2dPtr to_sparse(const ArrayDouble2d &dense) {
+  std::vector<double> data;
+  std::vector<INDICE_TYPE> indices;
+  std::vector<INDICE_TYPE> indptr{0};
+  for (ulong i = 0; i < dense.n_rows(); ++i) {
+    for (ulong j = 0; j < dense.n_cols(); ++j) {
+      if (dense(i, j) != 0) {
+        data.push_back(dense(i, j));
+        indices.push_back(j);
+      }
+    }
+    indptr.push_back(data.size());
+  }
+  // no need to free, it will be done by sparse array
+  double *sparse_data = new double[data.size()];
+  std::copy(data.begin(), data.end(), sparse_data);
+  INDICE_TYPE *sparse_indices = new INDICE_TYPE[indices.size()];
+  std::copy(indices.begin(), indices.end(), sparse_indices);
+  INDICE_TYPE *sparse_indptr = new INDICE_TYPE[indptr.size()];
+  std::copy(indptr.begin(), indptr.end(), sparse_indptr);
+  SSparseArrayDouble2dPtr sparse = SSparseArrayDouble2d::new_ptr(0, 0, 0);
+  sparse->set_data_indices_rowindices(sparse_data, sparse_indices,
+                                      sparse_indptr, dense.n_rows(),
+                                      dense.n_cols());
+  return sparse;
+}
+
+void check_grad_i_factors(TModelGeneralizedLinear<double> &model) {
+  SCOPED_TRACE(typeid(model).name());
+  ArrayDouble coeffs(model.get_n_coeffs());
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    coeffs[j] = 0.3 * std::cos(2.1 * j + 0.2);
+  }
+  // Runs of consecutive samples, isolated samples and repetitions
+  ArrayULong batch{2, 3, 4, 0, 6, 5, 6, 1};
+  ArrayDouble inner_prods(batch.size());
+  model.get_inner_prods(batch, coeffs, inner_prods);
+  ArrayDouble factors(batch.size());
+  model.grad_i_factors(batch, coeffs, factors);
+  for (ulong k = 0; k < batch.size(); ++k) {
+    EXPECT_NEAR(inner_prods[k], model.get_inner_prod(batch[k], coeffs),
+                1e-13)
+        << k;
+    EXPECT_NEAR(factors[k], model.grad_i_factor(batch[k], coeffs), 1e-13)
+        << k;
+  }
+}
+
+}  // namespace
+
+TEST(Model, GradIFactorsMatchGradIFactor) {
+  ArrayDouble labels{1, -1, 2, 0, 1, -1, 1};
+  SArrayDoublePtr y = labels.as_sarray_ptr();
+  ArrayDouble2d dense = get_batch_features();
+  std::vector<std::shared_ptr<BaseArray2d<double>>> features_list{
+      dense.as_sarray2d_ptr(), to_sparse(dense)};
+  for (auto features : features_list) {
+    for (const bool fit_intercept : {false, true}) {
+      SCOPED_TRACE(::testing::Message() << "sparse=" << features->is_sparse()
+                                        << " intercept=" << fit_intercept);
+      ModelLinReg linreg(features, y, fit_intercept);
+      check_grad_i_factors(linreg);
+      ModelLogReg logreg(features, y, fit_intercept);
+      check_grad_i_factors(logreg);
+      ModelPoisReg poisreg(features, y, LinkType::exponential, fit_intercept);
+      check_grad_i_factors(poisreg);
+      ModelHinge hinge(features, y, fit_intercept);
+      check_grad_i_factors(hinge);
+      ModelQuadraticHinge quadratic_hinge(features, y, fit_intercept);
+      check_grad_i_factors(quadratic_hinge);
+      ModelSmoothedHinge smoothed_hinge(features, y, fit_intercept, 0.5);
+      check_grad_i_factors(smoothed_hinge);
+      ModelAbsoluteRegression absolute(features, y, fit_intercept);
+      check_grad_i_factors(absolute);
+      ModelEpsilonInsensitive epsilon_insensitive(features, y, fit_intercept,
+                                                  0.5);
+      check_grad_i_factors(epsilon_insensitive);
+      ModelHuber huber(features, y, fit_intercept, 0.5);
+      check_grad_i_factors(huber);
+      TModelModifiedHuber<double> modified_huber(features, y, fit_intercept);
+      check_grad_i_factors(modified_huber);
+      ModelLinRegWithIntercepts linreg_with_intercepts(features, y,
+                                                       fit_intercept);
+      check_grad_i_factors(linreg_with_intercepts);
+    }
+  }
+}
+
 #ifdef ADD_MAIN
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
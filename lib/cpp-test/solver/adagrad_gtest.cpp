@@ -0,0 +1,87 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/linear_model/model_linreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/solver/adagrad.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+// Runs AdaGrad on the dense and on the sparse toy dataset, the sparse one
+// updating only the support of each sample
+void check_sparse_updates(std::shared_ptr<TProx<double, double>> prox,
+                          const bool fit_intercept) {
+  SArrayDoublePtr labels_ptr = get_labels();
+  SArrayDouble2dPtr features_ptr = get_features();
+  SSparseArrayDouble2dPtr sparse_features_ptr = get_sparse_features();
+
+  const ulong n_samples = features_ptr->n_rows();
+  const ulong n_coeffs = features_ptr->n_cols() + (fit_intercept ? 1 : 0);
+
+  auto model = std::make_shared<ModelLinReg>(features_ptr, labels_ptr,
+                                             fit_intercept, 1);
+  auto sparse_model = std::make_shared<ModelLinReg>(
+      sparse_features_ptr, labels_ptr, fit_intercept, 1);
+  ASSERT_TRUE(sparse_model->is_sparse());
+
+  AdaGrad adagrad(n_samples, 0, RandType::unif, 0.1, 1, 1309);
+  adagrad.set_rand_max(n_samples);
+  adagrad.set_model(model);
+  adagrad.set_prox(prox);
+
+  AdaGrad sparse_adagrad(n_samples, 0, RandType::unif, 0.1, 1, 1309);
+  sparse_adagrad.set_rand_max(n_samples);
+  sparse_adagrad.set_model(sparse_model);
+  sparse_adagrad.set_prox(prox);
+
+  ArrayDouble iterate(n_coeffs), sparse_iterate(n_coeffs);
+  iterate.init_to_zero();
+  adagrad.set_starting_iterate(iterate);
+  sparse_adagrad.set_starting_iterate(iterate);
+  for (int epoch = 0; epoch < 10; ++epoch) {
+    adagrad.solve();
+    sparse_adagrad.solve();
+    adagrad.get_iterate(iterate);
+    sparse_adagrad.get_iterate(sparse_iterate);
+    for (ulong j = 0; j < n_coeffs; ++j) {
+      ASSERT_NEAR(sparse_iterate[j], iterate[j], 1e-12) << epoch << " " << j;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(AdaGrad, test_sparse_prox_l1) {
+  check_sparse_updates(std::make_shared<ProxL1Double>(0.01, 0, 5, false),
+                       false);
+  check_sparse_updates(std::make_shared<ProxL1Double>(0.01, 0, 6, true),
+                       true);
+}
+
+TEST(AdaGrad, test_sparse_prox_l2sq) {
+  check_sparse_updates(std::make_shared<ProxL2Sq>(0.1, 0, 6, false), true);
+}
+
+TEST(AdaGrad, test_sparse_prox_elasticnet) {
+  check_sparse_updates(
+      std::make_shared<ProxElasticNet>(0.05, 0.5, 0, 6, false), true);
+  check_sparse_updates(
+      std::make_shared<ProxElasticNet>(0.05, 0.5, 0, 3, true), false);
+}
+
+TEST(AdaGrad, test_screening_rejected) {
+  AdaGradDouble adagrad(get_labels()->size(), 0, RandType::unif, 0.1);
+  EXPECT_THROW(adagrad.set_screening_every(1), std::runtime_error);
+  adagrad.set_screening_every(0);
+  EXPECT_EQ(adagrad.get_screening_every(), 0u);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
@@ -0,0 +1,134 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include <cereal/types/memory.hpp>
+#include <cereal/archives/portable_binary.hpp>
+
+#include "tick/linear_model/model_linreg.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/robust/model_linreg_with_intercepts.h"
+#include "tick/solver/asvrg.h"
+#include "tick/solver/svrg.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+// Minimizer of the ridge regularized least squares on the toy dataset, found
+// by the sequential SVRG
+ArrayDouble get_ridge_minimizer(const bool fit_intercept) {
+  auto model = std::make_shared<ModelLinReg>(get_features(), get_labels(),
+                                             fit_intercept, 1);
+  const ulong n_samples = get_labels()->size();
+  SVRG svrg(n_samples, 0, RandType::unif, 0.2 / model->get_lip_max(), 1,
+            1309);
+  svrg.set_rand_max(n_samples);
+  svrg.set_model(model);
+  svrg.set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  svrg.solve(3000);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  svrg.get_iterate(minimizer);
+  return minimizer;
+}
+
+template <class Features>
+void check_minimizer(std::shared_ptr<Features> features, const bool sparse,
+                     const int n_threads, const RandType rand_type) {
+  const bool fit_intercept = true;
+  auto model = std::make_shared<ModelLinReg>(features, get_labels(),
+                                             fit_intercept, 1);
+  ASSERT_EQ(model->is_sparse(), sparse);
+  const ulong n_samples = get_labels()->size();
+
+  AtomicSVRGDouble asvrg(n_samples, 0, rand_type, 0.2 / model->get_lip_max(),
+                         1, 1309, n_threads);
+  asvrg.set_rand_max(n_samples);
+  asvrg.set_model(model);
+  asvrg.set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  asvrg.solve(3000);
+
+  ArrayDouble iterate(model->get_n_coeffs());
+  asvrg.get_iterate(iterate);
+  ArrayDouble minimizer = get_ridge_minimizer(fit_intercept);
+  for (ulong j = 0; j < iterate.size(); ++j) {
+    EXPECT_NEAR(iterate[j], minimizer[j], 1e-6) << j;
+  }
+}
+
+}  // namespace
+
+TEST(AtomicSVRG, test_sparse_minimizer) {
+  for (int n_threads : {1, 3}) {
+    check_minimizer(get_sparse_features(), true, n_threads, RandType::unif);
+    check_minimizer(get_sparse_features(), true, n_threads, RandType::perm);
+  }
+}
+
+TEST(AtomicSVRG, test_dense_minimizer) {
+  for (int n_threads : {1, 3}) {
+    check_minimizer(get_features(), false, n_threads, RandType::unif);
+    check_minimizer(get_features(), false, n_threads, RandType::perm);
+  }
+}
+
+TEST(AtomicSVRG, test_rejected_settings) {
+  const ulong n_samples = get_labels()->size();
+  AtomicSVRGDouble asvrg(n_samples, 0, RandType::unif, 0.1);
+  EXPECT_THROW(asvrg.set_n_threads(0), std::runtime_error);
+  EXPECT_THROW(asvrg.set_rand_type(RandType::importance), std::runtime_error);
+  EXPECT_THROW(asvrg.set_batch_size(2), std::runtime_error);
+  asvrg.set_batch_size(1);
+  EXPECT_THROW(asvrg.set_screening_every(1), std::runtime_error);
+  EXPECT_THROW(asvrg.set_model(std::make_shared<ModelLinRegWithIntercepts>(
+                   get_features(), get_labels(), true, 1)),
+               std::runtime_error);
+}
+
+TEST(AtomicSVRG, test_compare_n_threads) {
+  auto model = std::make_shared<ModelLinReg>(get_sparse_features(),
+                                             get_labels(), false, 1);
+  const ulong n_samples = get_labels()->size();
+  AtomicSVRGDouble asvrg(n_samples, 0, RandType::unif, 0.1, 1, 1309, 2);
+  AtomicSVRGDouble other(n_samples, 0, RandType::unif, 0.1, 1, 1309, 2);
+  for (AtomicSVRGDouble *solver : {&asvrg, &other}) {
+    solver->set_rand_max(n_samples);
+    solver->set_model(model);
+    solver->set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  }
+  EXPECT_TRUE(asvrg == other);
+  other.set_n_threads(3);
+  EXPECT_FALSE(asvrg == other);
+}
+
+TEST(AtomicSVRG, test_serialization) {
+  auto model = std::make_shared<ModelLinReg>(get_sparse_features(),
+                                             get_labels(), true, 1);
+  const ulong n_samples = get_labels()->size();
+  AtomicSVRGDouble asvrg(n_samples, 0, RandType::unif,
+                         0.2 / model->get_lip_max(), 1, 1309, 3);
+  asvrg.set_rand_max(n_samples);
+  asvrg.set_model(model);
+  asvrg.set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  asvrg.solve(3);
+
+  std::stringstream os;
+  {
+    cereal::PortableBinaryOutputArchive outputArchive(os);
+    outputArchive(asvrg);
+  }
+  {
+    cereal::PortableBinaryInputArchive inputArchive(os);
+
+    AtomicSVRGDouble restored_asvrg;
+    inputArchive(restored_asvrg);
+
+    EXPECT_EQ(restored_asvrg.get_n_threads(), 3);
+    ASSERT_TRUE(asvrg == restored_asvrg);
+  }
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
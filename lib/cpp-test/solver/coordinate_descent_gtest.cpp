@@ -0,0 +1,188 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/linear_model/model_linreg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/linear_model/model_poisreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_l2.h"
+#include "tick/solver/coordinate_descent.h"
+#include "tick/solver/svrg.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+template <class Model>
+std::shared_ptr<Model> get_model(const bool sparse, SArrayDoublePtr labels,
+                                 const bool fit_intercept) {
+  if (sparse) {
+    return std::make_shared<Model>(get_sparse_features(), labels,
+                                   fit_intercept, 1);
+  }
+  return std::make_shared<Model>(get_features(), labels, fit_intercept, 1);
+}
+
+ArrayDouble get_cd_minimizer(
+    std::shared_ptr<ModelDouble> model, std::shared_ptr<ProxDouble> prox,
+    RandType rand_type = RandType::cyclic,
+    CoordinateDescent_StepType step_type = CoordinateDescent_StepType::Newton,
+    ulong n_epochs = 200) {
+  CoordinateDescent cd(0, 0, rand_type, step_type, 10, 1, 1309);
+  cd.set_model(model);
+  cd.set_prox(prox);
+  cd.solve(n_epochs);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  cd.get_minimizer(minimizer);
+  return minimizer;
+}
+
+}  // namespace
+
+TEST(CoordinateDescent, test_linreg) {
+  const double strength = 0.1;
+  auto prox = std::make_shared<ProxL1Double>(strength, false);
+  for (bool sparse : {false, true}) {
+    auto model = get_model<ModelLinReg>(sparse, get_labels(), false);
+    SVRG svrg(get_labels()->size(), 0, RandType::unif,
+              0.5 / model->get_lip_max(), 1, 1309);
+    svrg.set_rand_max(get_labels()->size());
+    svrg.set_model(model);
+    svrg.set_prox(prox);
+    svrg.solve(3000);
+    ArrayDouble svrg_minimizer(model->get_n_coeffs());
+    svrg.get_minimizer(svrg_minimizer);
+
+    for (auto rand_type : {RandType::cyclic, RandType::perm, RandType::unif}) {
+      for (auto step_type : {CoordinateDescent_StepType::QuadraticBound,
+                             CoordinateDescent_StepType::Newton}) {
+        ArrayDouble minimizer =
+            get_cd_minimizer(model, prox, rand_type, step_type);
+        expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+        for (ulong j = 0; j < minimizer.size(); ++j) {
+          EXPECT_NEAR(minimizer[j], svrg_minimizer[j], 1e-6)
+              << sparse << " " << rand_type << " " << step_type;
+        }
+      }
+    }
+  }
+}
+
+TEST(CoordinateDescent, test_logreg) {
+  const double strength = 0.05;
+  auto prox = std::make_shared<ProxL1Double>(strength, false);
+  for (bool sparse : {false, true}) {
+    auto model = get_model<ModelLogReg>(sparse, get_sign_labels(), false);
+    for (auto step_type : {CoordinateDescent_StepType::QuadraticBound,
+                           CoordinateDescent_StepType::Newton}) {
+      ArrayDouble minimizer =
+          get_cd_minimizer(model, prox, RandType::perm, step_type, 1000);
+      expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+      EXPECT_GT(minimizer.norm_sq(), 0);
+    }
+  }
+}
+
+TEST(CoordinateDescent, test_poisreg) {
+  const double strength = 0.05;
+  auto prox = std::make_shared<ProxL1Double>(strength, false);
+  auto model = std::make_shared<ModelPoisReg>(
+      get_features(), get_count_labels(), LinkType::exponential, false, 1);
+  ArrayDouble minimizer = get_cd_minimizer(model, prox);
+  expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+  EXPECT_GT(minimizer.norm_sq(), 0);
+
+  // Far from the solution, Newton steps overshoot without backtracking
+  auto model_intercept = std::make_shared<ModelPoisReg>(
+      get_features(), get_count_labels(), LinkType::exponential, true, 1);
+  auto prox_intercept =
+      std::make_shared<ProxL1Double>(strength, 0, 5, false);
+  ArrayDouble minimizer_intercept =
+      get_cd_minimizer(model_intercept, prox_intercept);
+  expect_l1_optimality(*model_intercept, minimizer_intercept, strength, 5,
+                       1e-8);
+  CoordinateDescent cd;
+  cd.set_model(model_intercept);
+  cd.set_prox(prox_intercept);
+  ArrayDouble start{0, 0, 0, 0, 0, -20};
+  cd.set_starting_iterate(start);
+  cd.solve(200);
+  ArrayDouble started_minimizer(minimizer_intercept.size());
+  cd.get_minimizer(started_minimizer);
+  for (ulong j = 0; j < started_minimizer.size(); ++j) {
+    EXPECT_NEAR(started_minimizer[j], minimizer_intercept[j], 1e-8);
+  }
+
+  // Poisson losses are not smooth
+  EXPECT_THROW(get_cd_minimizer(model, prox, RandType::cyclic,
+                                CoordinateDescent_StepType::QuadraticBound),
+               std::runtime_error);
+
+  // The identity link needs positive inner products
+  auto identity_model = std::make_shared<ModelPoisReg>(
+      get_features(), get_count_labels(), LinkType::identity, false, 1);
+  CoordinateDescent identity_cd;
+  EXPECT_THROW(identity_cd.set_model(identity_model), std::runtime_error);
+  cd.set_model(model);
+  model->set_link_type(LinkType::identity);
+  EXPECT_THROW(cd.solve(), std::runtime_error);
+}
+
+TEST(CoordinateDescent, test_intercept) {
+  const double strength = 0.1;
+  // The intercept is not penalized
+  auto prox = std::make_shared<ProxElasticNetDouble>(strength, 1., 0, 5, false);
+  for (bool sparse : {false, true}) {
+    auto model = get_model<ModelLogReg>(sparse, get_sign_labels(), true);
+    ArrayDouble minimizer = get_cd_minimizer(model, prox);
+    expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+    EXPECT_NE(minimizer[5], 0);
+  }
+}
+
+TEST(CoordinateDescent, test_col_major_features) {
+  auto prox = std::make_shared<ProxL1Double>(0.1, false);
+  auto model = std::make_shared<ModelLinReg>(get_sparse_features(),
+                                             get_labels(), true, 1);
+  ArrayDouble minimizer = get_cd_minimizer(model, prox, RandType::cyclic,
+                                           CoordinateDescent_StepType::Newton,
+                                           20);
+
+  auto col_major_features =
+      SparseArray2d<double, ColMajor>::CREATE_FROM(*get_sparse_features());
+  CoordinateDescent cd(0, 0, RandType::cyclic);
+  cd.set_model(model);
+  cd.set_prox(prox);
+  cd.set_col_major_features(col_major_features);
+  cd.solve(20);
+  ArrayDouble col_major_minimizer(model->get_n_coeffs());
+  cd.get_minimizer(col_major_minimizer);
+  for (ulong j = 0; j < minimizer.size(); ++j) {
+    EXPECT_DOUBLE_EQ(col_major_minimizer[j], minimizer[j]);
+  }
+
+  // The model gives the expected shape
+  CoordinateDescent cd_without_model;
+  EXPECT_THROW(cd_without_model.set_col_major_features(col_major_features),
+               std::runtime_error);
+}
+
+TEST(CoordinateDescent, test_errors) {
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), false, 1);
+  CoordinateDescent cd;
+  cd.set_model(model);
+  cd.set_prox(std::make_shared<ProxL2Double>(0.1, false));
+  EXPECT_THROW(cd.solve(), std::runtime_error);
+
+  cd.set_prox(std::make_shared<ProxL1Double>(0.1, false));
+  cd.set_rand_type(RandType::importance);
+  EXPECT_THROW(cd.solve(), std::runtime_error);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
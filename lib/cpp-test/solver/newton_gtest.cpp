@@ -0,0 +1,242 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/linear_model/model_linreg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/linear_model/model_poisreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_l2.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/solver/newton_cg.h"
+#include "tick/solver/prox_newton.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+std::shared_ptr<ModelLogReg> get_logreg(const bool sparse,
+                                        const bool fit_intercept,
+                                        const int n_threads = 1) {
+  if (sparse) {
+    return std::make_shared<ModelLogReg>(
+        get_sparse_features(), get_sign_labels(), fit_intercept, n_threads);
+  }
+  return std::make_shared<ModelLogReg>(get_features(), get_sign_labels(),
+                                       fit_intercept, n_threads);
+}
+
+// Checks that the gradient of the loss penalized by the squared L2 norm on
+// its first n_penalized coefficients is zero
+void expect_l2sq_optimality(ModelDouble &model, ArrayDouble &coeffs,
+                            const double strength, const ulong n_penalized,
+                            const double tol) {
+  ArrayDouble grad(coeffs.size());
+  model.grad(coeffs, grad);
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    const double penalization = j < n_penalized ? strength * coeffs[j] : 0;
+    EXPECT_NEAR(grad[j] + penalization, 0, tol) << j;
+  }
+}
+
+template <class Solver>
+ArrayDouble get_minimizer(Solver &solver, const ulong n_epochs) {
+  solver.solve(n_epochs);
+  ArrayDouble minimizer(solver.get_model()->get_n_coeffs());
+  solver.get_minimizer(minimizer);
+  return minimizer;
+}
+
+}  // namespace
+
+TEST(Newton, test_hessian_vector_product) {
+  const double eps = 1e-6;
+  for (bool sparse : {false, true}) {
+    for (bool fit_intercept : {false, true}) {
+      for (int n_threads : {1, 3}) {
+        auto model = get_logreg(sparse, fit_intercept, n_threads);
+        const ulong n_coeffs = model->get_n_coeffs();
+        ArrayDouble all_coeffs{0.3, -0.2, 0.5, 0.1, -0.4, 0.2};
+        ArrayDouble coeffs = view(all_coeffs, 0, n_coeffs);
+        ArrayDouble all_vector{1., 0.5, -2., 0.1, 0.7, -1.};
+        ArrayDouble vector = view(all_vector, 0, n_coeffs);
+
+        // Finite differences of the gradient
+        ArrayDouble coeffs_plus(n_coeffs), coeffs_minus(n_coeffs);
+        coeffs_plus.mult_fill(vector, eps);
+        coeffs_plus.mult_incr(coeffs, 1);
+        coeffs_minus.mult_fill(vector, -eps);
+        coeffs_minus.mult_incr(coeffs, 1);
+        ArrayDouble grad_plus(n_coeffs), grad_minus(n_coeffs);
+        model->grad(coeffs_plus, grad_plus);
+        model->grad(coeffs_minus, grad_minus);
+
+        ArrayDouble product(n_coeffs);
+        model->hessian_vector_product(coeffs, vector, product);
+        for (ulong j = 0; j < n_coeffs; ++j) {
+          EXPECT_NEAR(product[j], (grad_plus[j] - grad_minus[j]) / (2 * eps),
+                      1e-8)
+              << sparse << " " << fit_intercept << " " << n_threads;
+        }
+
+        // Products at the same point reuse the second derivatives computed
+        // along the first one
+        ArrayDouble all_other_vector{-0.3, 1.2, 0.4, -0.8, 0.6, 2.};
+        ArrayDouble other_vector = view(all_other_vector, 0, n_coeffs);
+        ArrayDouble cached_product(n_coeffs), fresh_product(n_coeffs);
+        model->hessian_vector_product(coeffs, other_vector, cached_product);
+        get_logreg(sparse, fit_intercept, n_threads)
+            ->hessian_vector_product(coeffs, other_vector, fresh_product);
+        for (ulong j = 0; j < n_coeffs; ++j) {
+          EXPECT_DOUBLE_EQ(cached_product[j], fresh_product[j]);
+        }
+
+        // The hessian is computed again when the point changes
+        ArrayDouble other_product(n_coeffs);
+        model->hessian_vector_product(coeffs_plus, vector, other_product);
+        auto other_model = get_logreg(sparse, fit_intercept, n_threads);
+        ArrayDouble expected_product(n_coeffs);
+        other_model->hessian_vector_product(coeffs_plus, vector,
+                                            expected_product);
+        for (ulong j = 0; j < n_coeffs; ++j) {
+          EXPECT_DOUBLE_EQ(other_product[j], expected_product[j]);
+        }
+      }
+    }
+  }
+
+  // The hessian of least squares is the one of the features
+  auto features = get_features();
+  auto model = std::make_shared<ModelLinReg>(features, get_labels(), false, 1);
+  ArrayDouble coeffs(5);
+  coeffs.init_to_zero();
+  ArrayDouble vector{1., 0.5, -2., 0.1, 0.7};
+  ArrayDouble product(5);
+  model->hessian_vector_product(coeffs, vector, product);
+  ArrayDouble expected_product(5);
+  expected_product.init_to_zero();
+  for (ulong i = 0; i < features->n_rows(); ++i) {
+    const ArrayDouble x_i = view_row(*features, i);
+    expected_product.mult_incr(x_i, x_i.dot(vector) / features->n_rows());
+  }
+  for (ulong j = 0; j < 5; ++j) {
+    EXPECT_NEAR(product[j], expected_product[j], 1e-12);
+  }
+
+  ArrayDouble wrong_vector(4);
+  EXPECT_THROW(model->hessian_vector_product(coeffs, wrong_vector, product),
+               std::runtime_error);
+}
+
+TEST(Newton, test_newton_cg_logreg) {
+  const double strength = 0.05;
+  // The intercept is not penalized
+  auto prox = std::make_shared<ProxL2SqDouble>(strength, 0, 5, false);
+  for (bool sparse : {false, true}) {
+    auto model = get_logreg(sparse, true);
+    NewtonCG newton_cg;
+    newton_cg.set_model(model);
+    newton_cg.set_prox(prox);
+    // Only a few Newton steps are needed
+    ArrayDouble minimizer = get_minimizer(newton_cg, 10);
+    expect_l2sq_optimality(*model, minimizer, strength, 5, 1e-10);
+    EXPECT_NE(minimizer[5], 0);
+  }
+}
+
+TEST(Newton, test_newton_cg_linreg) {
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), true, 1);
+  NewtonCG newton_cg;
+  newton_cg.set_model(model);
+  ArrayDouble minimizer = get_minimizer(newton_cg, 10);
+  expect_l2sq_optimality(*model, minimizer, 0, 0, 1e-10);
+}
+
+TEST(Newton, test_newton_cg_poisreg) {
+  const double strength = 0.05;
+  auto prox = std::make_shared<ProxL2SqDouble>(strength, 0, 5, false);
+  auto model = std::make_shared<ModelPoisReg>(
+      get_features(), get_count_labels(), LinkType::exponential, true, 1);
+  NewtonCG newton_cg;
+  newton_cg.set_model(model);
+  newton_cg.set_prox(prox);
+  // Far from the solution, full Newton steps overshoot
+  ArrayDouble start{0, 0, 0, 0, 0, -20};
+  newton_cg.set_starting_iterate(start);
+  ArrayDouble minimizer = get_minimizer(newton_cg, 100);
+  expect_l2sq_optimality(*model, minimizer, strength, 5, 1e-10);
+}
+
+TEST(Newton, test_prox_newton_logreg) {
+  const double strength = 0.05;
+  // The intercept is not penalized
+  auto prox = std::make_shared<ProxElasticNetDouble>(strength, 1., 0, 5, false);
+  for (bool sparse : {false, true}) {
+    auto model = get_logreg(sparse, true);
+    for (auto rand_type : {RandType::cyclic, RandType::perm, RandType::unif}) {
+      ProxNewton prox_newton(0, rand_type, 10, 1, 1309);
+      prox_newton.set_model(model);
+      prox_newton.set_prox(prox);
+      ArrayDouble minimizer = get_minimizer(prox_newton, 20);
+      expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+      EXPECT_GT(minimizer.norm_sq(), minimizer[5] * minimizer[5]);
+    }
+  }
+}
+
+TEST(Newton, test_prox_newton_linreg) {
+  auto prox = std::make_shared<ProxL1Double>(0.1, false);
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), false, 1);
+  CoordinateDescent cd(0, 0, RandType::cyclic);
+  cd.set_model(model);
+  cd.set_prox(prox);
+  ArrayDouble cd_minimizer = get_minimizer(cd, 200);
+
+  ProxNewton prox_newton;
+  prox_newton.set_model(model);
+  prox_newton.set_prox(prox);
+  ArrayDouble minimizer = get_minimizer(prox_newton, 20);
+  for (ulong j = 0; j < minimizer.size(); ++j) {
+    EXPECT_NEAR(minimizer[j], cd_minimizer[j], 1e-8);
+  }
+}
+
+TEST(Newton, test_prox_newton_poisreg) {
+  const double strength = 0.05;
+  auto prox = std::make_shared<ProxL1Double>(strength, 0, 5, false);
+  auto model = std::make_shared<ModelPoisReg>(
+      get_features(), get_count_labels(), LinkType::exponential, true, 1);
+  ProxNewton prox_newton;
+  prox_newton.set_model(model);
+  prox_newton.set_prox(prox);
+  // Far from the solution, full Newton steps overshoot
+  ArrayDouble start{0, 0, 0, 0, 0, -20};
+  prox_newton.set_starting_iterate(start);
+  ArrayDouble minimizer = get_minimizer(prox_newton, 100);
+  expect_l1_optimality(*model, minimizer, strength, 5, 1e-8);
+}
+
+TEST(Newton, test_errors) {
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), false, 1);
+  NewtonCG newton_cg;
+  newton_cg.set_model(model);
+  EXPECT_THROW(newton_cg.set_prox(std::make_shared<ProxL1Double>(0.1, false)),
+               std::runtime_error);
+  EXPECT_THROW(
+      newton_cg.set_prox(std::make_shared<ProxL2SqDouble>(0.1, true)),
+      std::runtime_error);
+
+  ProxNewton prox_newton;
+  prox_newton.set_model(model);
+  prox_newton.set_prox(std::make_shared<ProxL2Double>(0.1, false));
+  EXPECT_THROW(prox_newton.solve(), std::runtime_error);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
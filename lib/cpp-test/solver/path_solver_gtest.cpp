@@ -0,0 +1,216 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/linear_model/model_linreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/solver/path_solver.h"
+#include "tick/solver/svrg.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+template <class Solver = SVRG, class Features>
+std::shared_ptr<Solver> get_svrg(std::shared_ptr<Features> features) {
+  auto model =
+      std::make_shared<ModelLinReg>(features, get_labels(), false, 1);
+  const ulong n_samples = get_labels()->size();
+  auto svrg = std::make_shared<Solver>(n_samples, 0, RandType::unif,
+                                       0.5 / model->get_lip_max(), 1, 1309);
+  svrg->set_rand_max(n_samples);
+  svrg->set_model(model);
+  return svrg;
+}
+
+// Geometric grid from the strength for which zero is a solution
+ArrayDouble get_strengths(PathSolver &path_solver, const ulong n_strengths) {
+  const double strength_max = path_solver.get_strength_max();
+  ArrayDouble strengths(n_strengths);
+  for (ulong k = 0; k < n_strengths; ++k) {
+    strengths[k] = strength_max * std::pow(1e-2, k / (n_strengths - 1.));
+  }
+  return strengths;
+}
+
+// Minimizer of a single fit, started from zero
+template <class Features>
+ArrayDouble get_minimizer(std::shared_ptr<Features> features,
+                          std::shared_ptr<ProxSeparableDouble> prox) {
+  auto svrg = get_svrg(features);
+  svrg->set_prox(prox);
+  svrg->solve(3000);
+  ArrayDouble minimizer(svrg->get_model()->get_n_coeffs());
+  svrg->get_minimizer(minimizer);
+  return minimizer;
+}
+
+// Records the proportion of screened features at each epoch
+class RecordingSVRG : public SVRG {
+ public:
+  using SVRG::SVRG;
+
+  std::vector<double> screening_rates;
+
+  void solve_one_epoch() override {
+    screening_rates.push_back(get_screening_rate());
+    SVRG::solve_one_epoch();
+  }
+};
+
+class ThrowingSVRG : public SVRG {
+ public:
+  using SVRG::SVRG;
+
+  void solve_one_epoch() override { TICK_ERROR("The fit failed"); }
+};
+
+ArrayDouble get_row(const SSparseArrayDouble2d &path, const ulong k) {
+  ArrayDouble row(path.n_cols());
+  row.init_to_zero();
+  for (INDICE_TYPE idx = path.row_indices()[k]; idx < path.row_indices()[k + 1];
+       ++idx) {
+    row[path.indices()[idx]] = path.data()[idx];
+  }
+  return row;
+}
+
+}  // namespace
+
+TEST(PathSolver, test_strength_max) {
+  auto prox = std::make_shared<ProxL1Double>(0., false);
+  PathSolver path_solver(get_svrg(get_features()), prox, 50);
+  const double strength_max = path_solver.get_strength_max();
+  path_solver.set_strengths(ArrayDouble{strength_max, 0.9 * strength_max});
+  path_solver.solve();
+
+  auto path = path_solver.get_path();
+  ASSERT_EQ(path->n_rows(), 2u);
+  ASSERT_EQ(path->n_cols(), 5u);
+  EXPECT_EQ(path->row_indices()[1], 0u);
+  EXPECT_GT(path->row_indices()[2], 0u);
+}
+
+TEST(PathSolver, test_path_minimizers) {
+  for (bool sparse : {false, true}) {
+    std::vector<std::shared_ptr<ProxSeparableDouble> > proxs{
+        std::make_shared<ProxL1Double>(0., false),
+        std::make_shared<ProxElasticNetDouble>(0., 0.7, false)};
+    for (auto prox : proxs) {
+      auto svrg = sparse ? get_svrg(get_sparse_features())
+                         : get_svrg(get_features());
+      PathSolver path_solver(svrg, prox, 1000);
+      const ArrayDouble strengths = get_strengths(path_solver, 6);
+      path_solver.set_strengths(strengths);
+      path_solver.solve();
+
+      auto path = path_solver.get_path();
+      ASSERT_EQ(path->n_rows(), strengths.size());
+      for (ulong k = 0; k < strengths.size(); ++k) {
+        prox->set_strength(strengths[k]);
+        ArrayDouble minimizer =
+            sparse ? get_minimizer(get_sparse_features(), prox)
+                   : get_minimizer(get_features(), prox);
+        ArrayDouble row = get_row(*path, k);
+        for (ulong j = 0; j < minimizer.size(); ++j) {
+          EXPECT_NEAR(row[j], minimizer[j], 1e-6) << sparse << " " << k;
+        }
+      }
+    }
+  }
+}
+
+TEST(PathSolver, test_screening) {
+  auto prox = std::make_shared<ProxL1Double>(0., false);
+  PathSolver unscreened_solver(get_svrg(get_features()), prox, 300, false);
+  const ArrayDouble strengths = get_strengths(unscreened_solver, 6);
+  unscreened_solver.set_strengths(strengths);
+  unscreened_solver.solve();
+
+  auto svrg = get_svrg<RecordingSVRG>(get_features());
+  PathSolver path_solver(svrg, prox, 300);
+  path_solver.set_strengths(strengths);
+  path_solver.solve();
+
+  // Features are discarded at the beginning of the path, and skipped by the
+  // updates of the solver
+  ArrayULong n_active_features = *path_solver.get_n_active_features();
+  EXPECT_LT(n_active_features[0], 5u);
+  EXPECT_EQ((*unscreened_solver.get_n_active_features())[0], 5u);
+  EXPECT_GT(svrg->screening_rates.front(), 0);
+
+  auto path = path_solver.get_path();
+  auto unscreened_path = unscreened_solver.get_path();
+  for (ulong k = 0; k < strengths.size(); ++k) {
+    ArrayDouble row = get_row(*path, k);
+    ArrayDouble unscreened_row = get_row(*unscreened_path, k);
+    for (ulong j = 0; j < row.size(); ++j) {
+      EXPECT_NEAR(row[j], unscreened_row[j], 1e-6) << k;
+    }
+  }
+}
+
+TEST(PathSolver, test_kkt_violations) {
+  // Starting from the solution of a much smaller strength, where all
+  // gradients are small, the strong rule discards all features
+  auto prox = std::make_shared<ProxL1Double>(0., false);
+  auto svrg = get_svrg(get_features());
+  PathSolver path_solver(svrg, prox, 1000);
+  const double strength_max = path_solver.get_strength_max();
+  prox->set_strength(0.01 * strength_max);
+  ArrayDouble start = get_minimizer(get_features(), prox);
+  svrg->set_starting_iterate(start);
+
+  const double strength = 0.3 * strength_max;
+  path_solver.set_strengths(ArrayDouble{strength});
+  path_solver.solve();
+  EXPECT_GT((*path_solver.get_n_kkt_violations())[0], 0u);
+
+  prox->set_strength(strength);
+  ArrayDouble minimizer = get_minimizer(get_features(), prox);
+  ArrayDouble row = get_row(*path_solver.get_path(), 0);
+  for (ulong j = 0; j < minimizer.size(); ++j) {
+    EXPECT_NEAR(row[j], minimizer[j], 1e-6);
+  }
+}
+
+TEST(PathSolver, test_wrong_strengths) {
+  auto prox = std::make_shared<ProxL1Double>(0., false);
+  PathSolver path_solver(get_svrg(get_features()), prox);
+  EXPECT_THROW(path_solver.set_strengths(ArrayDouble{1., 2.}),
+               std::runtime_error);
+  EXPECT_THROW(path_solver.set_strengths(ArrayDouble{1., 0.}),
+               std::runtime_error);
+  EXPECT_THROW(path_solver.solve(), std::runtime_error);
+}
+
+TEST(PathSolver, test_prox_restored) {
+  auto prox = std::make_shared<ProxL1Double>(0., false);
+  auto original_prox = std::make_shared<ProxL2SqDouble>(0.1, false);
+
+  auto svrg = get_svrg(get_features());
+  svrg->set_prox(original_prox);
+  PathSolver path_solver(svrg, prox, 2);
+  path_solver.set_strengths(get_strengths(path_solver, 3));
+  path_solver.solve();
+  EXPECT_EQ(svrg->get_prox(), original_prox);
+
+  // Even if a fit of the path fails
+  auto model = std::make_shared<ModelLinReg>(get_features(), get_labels(),
+                                             false, 1);
+  auto throwing_svrg = std::make_shared<ThrowingSVRG>(
+      get_labels()->size(), 0, RandType::unif, 0.1, 1, 1309);
+  throwing_svrg->set_model(model);
+  throwing_svrg->set_prox(original_prox);
+  PathSolver throwing_path_solver(throwing_svrg, prox);
+  throwing_path_solver.set_strengths(ArrayDouble{1., 0.5});
+  EXPECT_THROW(throwing_path_solver.solve(), std::runtime_error);
+  EXPECT_EQ(throwing_svrg->get_prox(), original_prox);
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
@@ -5,11 +5,68 @@
 #include <cereal/archives/portable_binary.hpp>
 
 #include "tick/linear_model/model_linreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
 #include "tick/prox/prox_l2sq.h"
 #include "tick/solver/saga.h"
 #include "tick/solver/asaga.h"
 #include "toy_dataset.ipp"
 
+namespace {
+
+// Runs SAGA with ridge penalization on the toy dataset
+template <class Features>
+ArrayDouble get_ridge_minimizer(std::shared_ptr<Features> features,
+                                const ulong batch_size,
+                                const RandType rand_type) {
+  auto model =
+      std::make_shared<ModelLinReg>(features, get_labels(), true, 1);
+  const ulong n_samples = get_labels()->size();
+  SAGA saga(n_samples, 0, rand_type, 0.2 / model->get_lip_max(), 1, 1309);
+  saga.set_rand_max(n_samples);
+  saga.set_batch_size(batch_size);
+  saga.set_model(model);
+  saga.set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  saga.solve(3000);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  saga.get_iterate(minimizer);
+  return minimizer;
+}
+
+// Strength of L1 penalization above which zero is the solution of least
+// squares on the toy dataset, without intercept
+double get_strength_max() {
+  ModelLinReg model(get_features(), get_labels(), false, 1);
+  ArrayDouble zero(model.get_n_coeffs());
+  zero.init_to_zero();
+  ArrayDouble grad(model.get_n_coeffs());
+  model.grad(zero, grad);
+  double strength_max = 0;
+  for (ulong j = 0; j < grad.size(); ++j) {
+    strength_max = std::max(strength_max, std::abs(grad[j]));
+  }
+  return strength_max;
+}
+
+// Runs SAGA on least squares without intercept, as required by screening
+template <class Features>
+std::shared_ptr<SAGA> get_screened_saga(
+    std::shared_ptr<Features> features,
+    std::shared_ptr<ProxSeparableDouble> prox, const ulong screening_every) {
+  auto model =
+      std::make_shared<ModelLinReg>(features, get_labels(), false, 1);
+  const ulong n_samples = get_labels()->size();
+  auto saga = std::make_shared<SAGA>(n_samples, 0, RandType::unif,
+                                     0.2 / model->get_lip_max(), 1, 1309);
+  saga->set_rand_max(n_samples);
+  saga->set_model(model);
+  saga->set_prox(prox);
+  saga->set_screening_every(screening_every);
+  return saga;
+}
+
+}  // namespace
+
 TEST(SAGA, test_saga_dense_convergence) {
   SArrayDoublePtr labels_ptr = get_labels();
   SArrayDouble2dPtr features_ptr = get_features();
@@ -90,6 +147,168 @@ TEST(SAGA, test_saga_sparse_convergence) {
   EXPECT_LE(objective_asaga - objective300, 0.0001);
 }
 
+TEST(SAGA, test_saga_batch_minimizer) {
+  ArrayDouble minimizer =
+      get_ridge_minimizer(get_features(), 1, RandType::unif);
+  for (RandType rand_type : {RandType::unif, RandType::perm}) {
+    ArrayDouble dense_iterate =
+        get_ridge_minimizer(get_features(), 3, rand_type);
+    ArrayDouble sparse_iterate =
+        get_ridge_minimizer(get_sparse_features(), 3, rand_type);
+    for (ulong j = 0; j < minimizer.size(); ++j) {
+      EXPECT_NEAR(dense_iterate[j], minimizer[j], 1e-6) << j;
+      EXPECT_NEAR(sparse_iterate[j], minimizer[j], 1e-6) << j;
+    }
+  }
+}
+
+TEST(SAGA, test_saga_batch_repeated_samples) {
+  // Batches larger than the number of samples always draw some samples
+  // several times
+  auto features = get_features();
+  auto model = std::make_shared<ModelLinReg>(features, get_labels(), true, 1);
+  const ulong n_samples = features->n_rows();
+  const ulong n_features = features->n_cols();
+  const ulong batch_size = 2 * n_samples - 2;
+  const double step = 0.1 / model->get_lip_max();
+  SAGA saga(batch_size, 0, RandType::unif, step, 1, 1309);
+  saga.set_rand_max(n_samples);
+  saga.set_batch_size(batch_size);
+  saga.set_model(model);
+
+  // Draws the same samples as saga
+  TStoSolver<double, double> sampler(batch_size, 0, RandType::unif, 1, 1309);
+  sampler.set_rand_max(n_samples);
+
+  ArrayDouble expected_iterate(model->get_n_coeffs());
+  expected_iterate.init_to_zero();
+  ArrayDouble gradients_memory(n_samples), gradients_average(n_features + 1);
+  gradients_memory.init_to_zero();
+  gradients_average.init_to_zero();
+  for (int epoch = 0; epoch < 3; ++epoch) {
+    std::vector<ulong> batch(batch_size);
+    for (ulong &i : batch) i = sampler.get_next_i();
+
+    std::vector<double> factors;
+    for (ulong i : batch) {
+      factors.push_back(model->grad_i_factor(i, expected_iterate));
+    }
+    ArrayDouble direction = gradients_average;
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      const double diff = factors[idx] - gradients_memory[batch[idx]];
+      ArrayDouble features_i = view_row(*features, batch[idx]);
+      for (ulong j = 0; j < n_features; ++j) {
+        direction[j] += diff * features_i[j] / batch_size;
+      }
+      direction[n_features] += diff / batch_size;
+    }
+    expected_iterate.mult_incr(direction, -step);
+
+    std::vector<bool> stored(n_samples, false);
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      const ulong i = batch[idx];
+      if (stored[i]) continue;
+      stored[i] = true;
+      const double diff = factors[idx] - gradients_memory[i];
+      gradients_memory[i] = factors[idx];
+      ArrayDouble features_i = view_row(*features, i);
+      for (ulong j = 0; j < n_features; ++j) {
+        gradients_average[j] += diff * features_i[j] / n_samples;
+      }
+      gradients_average[n_features] += diff / n_samples;
+    }
+
+    saga.solve(1);
+    ArrayDouble iterate(model->get_n_coeffs());
+    saga.get_iterate(iterate);
+    for (ulong j = 0; j < iterate.size(); ++j) {
+      EXPECT_NEAR(iterate[j], expected_iterate[j], 1e-12)
+          << "epoch " << epoch << " " << j;
+    }
+  }
+}
+
+TEST(SAGA, test_saga_importance_minimizer) {
+  ArrayDouble minimizer =
+      get_ridge_minimizer(get_features(), 1, RandType::unif);
+  for (ulong batch_size : {1, 3}) {
+    ArrayDouble dense_iterate =
+        get_ridge_minimizer(get_features(), batch_size, RandType::importance);
+    ArrayDouble sparse_iterate = get_ridge_minimizer(
+        get_sparse_features(), batch_size, RandType::importance);
+    for (ulong j = 0; j < minimizer.size(); ++j) {
+      EXPECT_NEAR(dense_iterate[j], minimizer[j], 1e-6) << j;
+      EXPECT_NEAR(sparse_iterate[j], minimizer[j], 1e-6) << j;
+    }
+  }
+}
+
+TEST(SAGA, test_saga_gap_safe_screening) {
+  const double strength = 0.3 * get_strength_max();
+  std::vector<std::shared_ptr<ProxSeparableDouble> > proxs{
+      std::make_shared<ProxL1Double>(strength, false),
+      std::make_shared<ProxElasticNetDouble>(strength / 0.7, 0.7, false)};
+  for (auto prox : proxs) {
+    auto saga = get_screened_saga(get_features(), prox, 0);
+    saga->solve(3000);
+    ArrayDouble minimizer(5);
+    saga->get_iterate(minimizer);
+    EXPECT_EQ(saga->get_screening_rate(), 0);
+
+    for (bool sparse : {false, true}) {
+      auto screened_saga =
+          sparse ? get_screened_saga(get_sparse_features(), prox, 10)
+                 : get_screened_saga(get_features(), prox, 10);
+      screened_saga->solve(3000);
+      ArrayDouble iterate(5);
+      screened_saga->get_iterate(iterate);
+      EXPECT_GT(screened_saga->get_screening_rate(), 0);
+      EXPECT_LT(screened_saga->get_duality_gap(), 1e-6);
+      for (ulong j = 0; j < iterate.size(); ++j) {
+        EXPECT_NEAR(iterate[j], minimizer[j], 1e-6) << sparse << " " << j;
+      }
+    }
+  }
+}
+
+TEST(SAGA, test_saga_screening_strength_change) {
+  // Features screened with a strong penalization are given back when it is
+  // lowered
+  const double strength_max = get_strength_max();
+  auto prox = std::make_shared<ProxL1Double>(0.05 * strength_max, false);
+  for (bool sparse : {false, true}) {
+    auto saga = sparse ? get_screened_saga(get_sparse_features(), prox, 0)
+                       : get_screened_saga(get_features(), prox, 0);
+    saga->solve(3000);
+    ArrayDouble minimizer(5);
+    saga->get_iterate(minimizer);
+
+    prox->set_strength(0.6 * strength_max);
+    auto screened_saga =
+        sparse ? get_screened_saga(get_sparse_features(), prox, 10)
+               : get_screened_saga(get_features(), prox, 10);
+    screened_saga->solve(500);
+    EXPECT_GT(screened_saga->get_screening_rate(), 0);
+
+    prox->set_strength(0.05 * strength_max);
+    screened_saga->solve(3000);
+    ArrayDouble iterate(5);
+    screened_saga->get_iterate(iterate);
+    for (ulong j = 0; j < iterate.size(); ++j) {
+      EXPECT_NEAR(iterate[j], minimizer[j], 1e-6) << sparse << " " << j;
+    }
+  }
+}
+
+TEST(SAGA, test_asaga_rejects_batches) {
+  AtomicSAGADouble asaga(get_labels()->size(), 0, RandType::unif, 0.1);
+  EXPECT_THROW(asaga.set_batch_size(2), std::runtime_error);
+  asaga.set_batch_size(1);
+  EXPECT_EQ(asaga.get_batch_size(), 1u);
+  // Neither does it skip screened features
+  EXPECT_THROW(asaga.set_screening_every(1), std::runtime_error);
+}
+
 TEST(SAGA, test_saga_serialization) {
   SArrayDoublePtr labels_ptr = get_labels();
   SBaseArrayDouble2dPtr features_ptr = get_features();
@@ -0,0 +1,141 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include <cereal/types/memory.hpp>
+#include <cereal/archives/portable_binary.hpp>
+
+#include "tick/linear_model/model_logreg.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/prox/prox_zero.h"
+#include "tick/solver/sdca.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+std::shared_ptr<ModelLogReg> get_sparse_logreg(const bool fit_intercept) {
+  ArrayDouble labels = *get_labels();
+  for (ulong i = 0; i < labels.size(); ++i) labels[i] = labels[i] > 0 ? 1 : -1;
+  return std::make_shared<ModelLogReg>(get_sparse_features(),
+                                       labels.as_sarray_ptr(), fit_intercept,
+                                       1);
+}
+
+// With ProxZero, the primal vector must be given by the dual vector through
+// the primal-dual relation
+void check_primal_dual_relation(const size_t n_threads,
+                                const bool fit_intercept) {
+  const double l_l2sq = 0.1;
+  auto model = get_sparse_logreg(fit_intercept);
+  const ulong n_samples = get_labels()->size();
+  SDCA sdca(l_l2sq, n_samples, 0, RandType::unif, 1, 1309,
+            n_threads);
+  sdca.set_rand_max(n_samples);
+  sdca.set_model(model);
+  sdca.set_prox(std::make_shared<ProxZeroDouble>(0));
+
+  for (int epoch = 0; epoch < 5; ++epoch) {
+    sdca.solve();
+    ArrayDouble primal_vector = *sdca.get_primal_vector();
+    ArrayDouble dual_vector = *sdca.get_dual_vector();
+    ArrayDouble expected_primal_vector(primal_vector.size());
+    model->sdca_primal_dual_relation(l_l2sq, dual_vector,
+                                     expected_primal_vector);
+    for (ulong j = 0; j < primal_vector.size(); ++j) {
+      ASSERT_NEAR(primal_vector[j], expected_primal_vector[j], 1e-12)
+          << epoch << " " << j;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(SDCA, test_sparse_primal_dual_relation) {
+  check_primal_dual_relation(1, false);
+  check_primal_dual_relation(1, true);
+}
+
+TEST(SDCA, test_parallel_primal_dual_relation) {
+  check_primal_dual_relation(3, false);
+  check_primal_dual_relation(3, true);
+}
+
+TEST(SDCA, test_parallel_minimizer) {
+  auto model = get_sparse_logreg(true);
+  const ulong n_samples = get_labels()->size();
+
+  ArrayDouble minimizer, parallel_minimizer;
+  for (size_t n_threads : {1, 2}) {
+    SDCA sdca(0.1, n_samples, 0, RandType::perm, 1, 1309, n_threads);
+    sdca.set_rand_max(n_samples);
+    sdca.set_model(model);
+    sdca.set_prox(std::make_shared<ProxL2Sq>(0.05, false));
+    sdca.solve(300);
+    ArrayDouble &out = n_threads == 1 ? minimizer : parallel_minimizer;
+    out = *sdca.get_primal_vector();
+  }
+  for (ulong j = 0; j < minimizer.size(); ++j) {
+    EXPECT_NEAR(parallel_minimizer[j], minimizer[j], 1e-8) << j;
+  }
+}
+
+TEST(SDCA, test_more_threads_than_samples) {
+  // Every step of the epoch must run even if some threads would get an
+  // empty block of dual coordinates
+  auto model = get_sparse_logreg(false);
+  const ulong n_samples = get_labels()->size();
+  SDCA sdca(0.1, n_samples, 0, RandType::perm, 1, 1309, n_samples + 3);
+  sdca.set_rand_max(n_samples);
+  sdca.set_model(model);
+  sdca.set_prox(std::make_shared<ProxZeroDouble>(0));
+  sdca.solve(1);
+
+  ArrayDouble dual_vector = *sdca.get_dual_vector();
+  for (ulong i = 0; i < n_samples; ++i) EXPECT_NE(dual_vector[i], 0) << i;
+}
+
+TEST(SDCA, test_sdca_compare_n_threads) {
+  auto model = get_sparse_logreg(false);
+  const ulong n_samples = get_labels()->size();
+  SDCA sdca(0.1, n_samples, 0, RandType::unif, 1, 1309, 2);
+  SDCA other(0.1, n_samples, 0, RandType::unif, 1, 1309, 2);
+  for (SDCA *solver : {&sdca, &other}) {
+    solver->set_rand_max(n_samples);
+    solver->set_model(model);
+    solver->set_prox(std::make_shared<ProxL2Sq>(0.05, false));
+  }
+  EXPECT_TRUE(sdca == other);
+  other.set_n_threads(3);
+  EXPECT_FALSE(sdca == other);
+}
+
+TEST(SDCA, test_sdca_serialization) {
+  auto model = get_sparse_logreg(false);
+  const ulong n_samples = get_labels()->size();
+  SDCA sdca(0.1, n_samples, 0, RandType::unif, 1, 1309, 2);
+  sdca.set_rand_max(n_samples);
+  sdca.set_model(model);
+  sdca.set_prox(std::make_shared<ProxL2Sq>(0.05, false));
+  sdca.solve(3);
+
+  std::stringstream os;
+  {
+    cereal::PortableBinaryOutputArchive outputArchive(os);
+    outputArchive(sdca);
+  }
+  {
+    cereal::PortableBinaryInputArchive inputArchive(os);
+
+    SDCA restored_sdca;
+    inputArchive(restored_sdca);
+
+    EXPECT_EQ(restored_sdca.get_n_threads(), 2u);
+    ASSERT_TRUE(sdca == restored_sdca);
+  }
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
@@ -0,0 +1,232 @@
+#define DEBUG_COSTLY_THROW 1
+
+#include <gtest/gtest.h>
+#include "tick/hawkes/model/list_of_realizations/model_hawkes_expkern_loglik.h"
+#include "tick/linear_model/model_linreg.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_l2sq.h"
+#include "tick/prox/prox_screened.h"
+#include "tick/solver/sgd.h"
+#include "tick/solver/svrg.h"
+#include "toy_dataset.ipp"
+
+namespace {
+
+// Runs SGD on the dense and on the sparse toy dataset, the sparse one
+// applying the prox lazily
+void check_lazy_prox(std::shared_ptr<TProx<double, double>> prox,
+                     const bool fit_intercept, const ulong batch_size = 1) {
+  SArrayDoublePtr labels_ptr = get_labels();
+  SArrayDouble2dPtr features_ptr = get_features();
+  SSparseArrayDouble2dPtr sparse_features_ptr = get_sparse_features();
+
+  const ulong n_samples = features_ptr->n_rows();
+  const ulong n_coeffs = features_ptr->n_cols() + (fit_intercept ? 1 : 0);
+
+  auto model = std::make_shared<ModelLinReg>(features_ptr, labels_ptr,
+                                             fit_intercept, 1);
+  auto sparse_model = std::make_shared<ModelLinReg>(
+      sparse_features_ptr, labels_ptr, fit_intercept, 1);
+  ASSERT_TRUE(sparse_model->is_sparse());
+
+  const double step = 1. / model->get_lip_max();
+  SGD sgd(n_samples, 0, RandType::unif, step, 1, 1309);
+  sgd.set_rand_max(n_samples);
+  sgd.set_batch_size(batch_size);
+  sgd.set_model(model);
+  sgd.set_prox(prox);
+
+  SGD sparse_sgd(n_samples, 0, RandType::unif, step, 1, 1309);
+  sparse_sgd.set_rand_max(n_samples);
+  sparse_sgd.set_batch_size(batch_size);
+  sparse_sgd.set_model(sparse_model);
+  sparse_sgd.set_prox(prox);
+
+  ArrayDouble iterate(n_coeffs), sparse_iterate(n_coeffs);
+  for (int epoch = 0; epoch < 20; ++epoch) {
+    sgd.solve();
+    sparse_sgd.solve();
+    sgd.get_iterate(iterate);
+    sparse_sgd.get_iterate(sparse_iterate);
+    for (ulong j = 0; j < n_coeffs; ++j) {
+      ASSERT_NEAR(sparse_iterate[j], iterate[j], 1e-12) << epoch << " " << j;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(SGD, test_sparse_lazy_prox_l1) {
+  check_lazy_prox(std::make_shared<ProxL1Double>(0.1, false), false);
+  check_lazy_prox(std::make_shared<ProxL1Double>(0.1, true), true);
+}
+
+TEST(SGD, test_sparse_lazy_prox_l2sq) {
+  check_lazy_prox(std::make_shared<ProxL2Sq>(0.5, false), true);
+}
+
+TEST(SGD, test_sparse_lazy_prox_elasticnet) {
+  check_lazy_prox(std::make_shared<ProxElasticNet>(0.2, 0.5, false), true);
+  check_lazy_prox(std::make_shared<ProxElasticNet>(0.2, 0.5, 0, 3, true),
+                  false);
+}
+
+TEST(SGD, test_sparse_lazy_prox_screened) {
+  // The discarded coordinates are zeroed by the lazy updates, the others get
+  // the shrinkage of the wrapped prox on its range
+  auto prox = std::make_shared<ProxL1Double>(0.1, 0, 5, false);
+  auto screened_prox = std::make_shared<ProxScreenedDouble>(prox);
+  screened_prox->discard(1);
+  screened_prox->discard(3);
+
+  double threshold, scaling, screened_threshold, screened_scaling;
+  ASSERT_TRUE(prox->get_shrinkage(0.5, threshold, scaling));
+  ASSERT_TRUE(
+      screened_prox->get_shrinkage(0.5, screened_threshold, screened_scaling));
+  EXPECT_EQ(screened_threshold, threshold);
+  EXPECT_EQ(screened_scaling, scaling);
+
+  check_lazy_prox(screened_prox, true);
+  check_lazy_prox(screened_prox, true, 3);
+}
+
+TEST(SGD, test_sparse_lazy_prox_batch) {
+  for (bool fit_intercept : {false, true}) {
+    check_lazy_prox(std::make_shared<ProxL1Double>(0.05, false), fit_intercept,
+                    3);
+    check_lazy_prox(std::make_shared<ProxElasticNet>(0.05, 0.5, false),
+                    fit_intercept, 3);
+  }
+}
+
+TEST(SGD, test_hawkes_lazy_prox) {
+  auto timestamps = SArrayDoublePtrList1D(0);
+  timestamps.push_back(
+      ArrayDouble{0.31, 0.93, 1.29, 2.32, 4.25}.as_sarray_ptr());
+  timestamps.push_back(
+      ArrayDouble{0.12, 1.19, 2.12, 2.41, 3.35, 4.21}.as_sarray_ptr());
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65;
+  (*end_times)[1] = 5.87;
+
+  auto model = std::make_shared<ModelHawkesExpKernLogLik>(2., 1);
+  model->set_data(timestamps_list, end_times);
+  ASSERT_TRUE(model->has_grad_i_sparse());
+  const ulong n_coeffs = model->get_n_coeffs();
+  const ulong rand_max = model->get_rand_max();
+
+  // Positive coefficients keep the intensities positive
+  for (auto prox : std::vector<std::shared_ptr<ProxDouble>>{
+           std::make_shared<ProxL1Double>(0.1, true),
+           std::make_shared<ProxElasticNet>(0.1, 0.5, true)}) {
+    const double step = 0.1;
+    SGD sgd(rand_max, 0, RandType::cyclic, step);
+    sgd.set_rand_max(rand_max);
+    sgd.set_model(model);
+    sgd.set_prox(prox);
+    ArrayDouble start(n_coeffs);
+    start.fill(1.);
+    sgd.set_starting_iterate(start);
+    sgd.solve(3);
+    ArrayDouble iterate(n_coeffs);
+    sgd.get_iterate(iterate);
+
+    // Dense steps, the prox being applied on all coefficients
+    ArrayDouble expected_iterate(n_coeffs);
+    expected_iterate.fill(1.);
+    ArrayDouble grad(n_coeffs);
+    for (ulong t = 1; t <= 3 * rand_max; ++t) {
+      model->grad_i((t - 1) % rand_max, expected_iterate, grad);
+      const double step_t = step / (t + 1);
+      expected_iterate.mult_incr(grad, -step_t);
+      prox->call(expected_iterate, step_t, expected_iterate);
+    }
+    for (ulong j = 0; j < n_coeffs; ++j) {
+      EXPECT_NEAR(iterate[j], expected_iterate[j], 1e-12) << j;
+    }
+  }
+}
+
+TEST(SGD, test_importance_sampling_frequencies) {
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), true, 1);
+  const ulong n_samples = get_labels()->size();
+  SGD sgd(n_samples, 0, RandType::importance, 0, 1, 1309);
+  sgd.set_rand_max(n_samples);
+  sgd.set_model(model);
+  StoSolver &solver = sgd;
+
+  const ulong n_draws = 100000;
+  ArrayULong counts(n_samples);
+  counts.init_to_zero();
+  for (ulong k = 0; k < n_draws; ++k) counts[solver.get_next_i()]++;
+
+  ArrayDouble lip_consts = model->get_lip_consts();
+  for (ulong i = 0; i < n_samples; ++i) {
+    EXPECT_NEAR(static_cast<double>(counts[i]) / n_draws,
+                lip_consts[i] / lip_consts.sum(), 5e-3)
+        << i;
+  }
+}
+
+TEST(SGD, test_importance_sampling_size_mismatch) {
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), true, 1);
+  const ulong n_samples = get_labels()->size();
+  SGD sgd(n_samples, 0, RandType::importance, 0, 1, 1309);
+  sgd.set_rand_max(n_samples + 1);
+  sgd.set_model(model);
+  StoSolver &solver = sgd;
+  // There must be one Lipschitz constant per sample
+  EXPECT_THROW(solver.get_next_i(), std::runtime_error);
+}
+
+TEST(SGD, test_screening_rejected) {
+  SGD sgd(get_labels()->size(), 0, RandType::unif, 0.1);
+  EXPECT_THROW(sgd.set_screening_every(1), std::runtime_error);
+  sgd.set_screening_every(0);
+  EXPECT_EQ(sgd.get_screening_every(), 0u);
+}
+
+TEST(SGD, test_importance_sampling_unbiased) {
+  // Without the reweighting of the gradients, SGD would converge to the
+  // minimizer of the loss weighted by the Lipschitz constants
+  auto model =
+      std::make_shared<ModelLinReg>(get_features(), get_labels(), true, 1);
+  auto sparse_model = std::make_shared<ModelLinReg>(get_sparse_features(),
+                                                    get_labels(), true, 1);
+  auto prox = std::make_shared<ProxL2Sq>(0.5, false);
+  const ulong n_samples = get_labels()->size();
+
+  SVRG svrg(n_samples, 0, RandType::unif, 0.2 / model->get_lip_max(), 1,
+            1309);
+  svrg.set_rand_max(n_samples);
+  svrg.set_model(model);
+  svrg.set_prox(prox);
+  svrg.solve(3000);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  svrg.get_iterate(minimizer);
+
+  for (auto sgd_model : {model, sparse_model}) {
+    SGD sgd(n_samples, 0, RandType::importance, 1., 1, 1309);
+    sgd.set_rand_max(n_samples);
+    sgd.set_model(sgd_model);
+    sgd.set_prox(prox);
+    sgd.solve(3000);
+    ArrayDouble iterate(model->get_n_coeffs());
+    sgd.get_iterate(iterate);
+    iterate.mult_incr(minimizer, -1);
+    EXPECT_LE(std::sqrt(iterate.norm_sq()), 1e-2);
+  }
+}
+
+#ifdef ADD_MAIN
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif  // ADD_MAIN
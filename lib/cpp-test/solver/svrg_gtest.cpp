@@ -2,10 +2,59 @@
 
 #include <gtest/gtest.h>
 #include "tick/linear_model/model_linreg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/prox/prox_l1.h"
 #include "tick/prox/prox_l2sq.h"
 #include "tick/solver/svrg.h"
 #include "toy_dataset.ipp"
 
+namespace {
+
+// Runs SVRG with ridge penalization on the toy dataset
+template <class Features>
+ArrayDouble get_ridge_minimizer(std::shared_ptr<Features> features,
+                                const ulong batch_size,
+                                const RandType rand_type) {
+  auto model =
+      std::make_shared<ModelLinReg>(features, get_labels(), true, 1);
+  const ulong n_samples = get_labels()->size();
+  SVRG svrg(n_samples, 0, rand_type, 0.2 / model->get_lip_max(), 1, 1309);
+  svrg.set_rand_max(n_samples);
+  svrg.set_batch_size(batch_size);
+  svrg.set_model(model);
+  svrg.set_prox(std::make_shared<ProxL2Sq>(0.1, false));
+  svrg.solve(3000);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  svrg.get_iterate(minimizer);
+  return minimizer;
+}
+
+// Runs SVRG on logistic regression without intercept, with labels given by
+// the signs of the toy labels
+template <class Features>
+ArrayDouble get_logreg_minimizer(std::shared_ptr<Features> features,
+                                 std::shared_ptr<ProxL1Double> prox,
+                                 const ulong screening_every,
+                                 double &screening_rate) {
+  ArrayDouble labels = *get_labels();
+  for (ulong i = 0; i < labels.size(); ++i) labels[i] = labels[i] > 0 ? 1 : -1;
+  auto model = std::make_shared<ModelLogReg>(features, labels.as_sarray_ptr(),
+                                             false, 1);
+  SVRG svrg(labels.size(), 0, RandType::unif, 0.5 / model->get_lip_max(), 1,
+            1309);
+  svrg.set_rand_max(labels.size());
+  svrg.set_model(model);
+  svrg.set_prox(prox);
+  svrg.set_screening_every(screening_every);
+  svrg.solve(3000);
+  ArrayDouble minimizer(model->get_n_coeffs());
+  svrg.get_iterate(minimizer);
+  screening_rate = svrg.get_screening_rate();
+  return minimizer;
+}
+
+}  // namespace
+
 TEST(SVRG, test_convergence) {
   SArrayDoublePtr labels_ptr = get_labels();
   SArrayDouble2dPtr features_ptr = get_features();
@@ -72,6 +121,54 @@ TEST(SVRG, test_history) {
   ASSERT_LE(get_objective(2), get_objective(1));
 }
 
+TEST(SVRG, test_batch_minimizer) {
+  ArrayDouble minimizer =
+      get_ridge_minimizer(get_features(), 1, RandType::unif);
+  for (RandType rand_type : {RandType::unif, RandType::perm}) {
+    ArrayDouble dense_iterate =
+        get_ridge_minimizer(get_features(), 3, rand_type);
+    ArrayDouble sparse_iterate =
+        get_ridge_minimizer(get_sparse_features(), 3, rand_type);
+    for (ulong j = 0; j < minimizer.size(); ++j) {
+      EXPECT_NEAR(dense_iterate[j], minimizer[j], 1e-6) << j;
+      EXPECT_NEAR(sparse_iterate[j], minimizer[j], 1e-6) << j;
+    }
+  }
+}
+
+TEST(SVRG, test_importance_minimizer) {
+  ArrayDouble minimizer =
+      get_ridge_minimizer(get_features(), 1, RandType::unif);
+  for (ulong batch_size : {1, 3}) {
+    ArrayDouble dense_iterate =
+        get_ridge_minimizer(get_features(), batch_size, RandType::importance);
+    ArrayDouble sparse_iterate = get_ridge_minimizer(
+        get_sparse_features(), batch_size, RandType::importance);
+    for (ulong j = 0; j < minimizer.size(); ++j) {
+      EXPECT_NEAR(dense_iterate[j], minimizer[j], 1e-6) << j;
+      EXPECT_NEAR(sparse_iterate[j], minimizer[j], 1e-6) << j;
+    }
+  }
+}
+
+TEST(SVRG, test_gap_safe_screening) {
+  auto prox = std::make_shared<ProxL1Double>(0.1, false);
+  double screening_rate;
+  ArrayDouble minimizer =
+      get_logreg_minimizer(get_features(), prox, 0, screening_rate);
+  ASSERT_EQ(screening_rate, 0);
+  ArrayDouble dense_iterate =
+      get_logreg_minimizer(get_features(), prox, 5, screening_rate);
+  EXPECT_GT(screening_rate, 0);
+  ArrayDouble sparse_iterate =
+      get_logreg_minimizer(get_sparse_features(), prox, 5, screening_rate);
+  EXPECT_GT(screening_rate, 0);
+  for (ulong j = 0; j < minimizer.size(); ++j) {
+    EXPECT_NEAR(dense_iterate[j], minimizer[j], 1e-6) << j;
+    EXPECT_NEAR(sparse_iterate[j], minimizer[j], 1e-6) << j;
+  }
+}
+
 #ifdef ADD_MAIN
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,6 +1,10 @@
 
 
+#include <gtest/gtest.h>
+#include <cmath>
+
 #include "tick/base/base.h"
+#include "tick/base_model/model.h"
 
 SArrayDoublePtr get_labels() {
   ArrayDouble labels{-1.76, 2.6, -0.7, -1.84, -1.88, -1.78, 2.52};
@@ -40,4 +44,33 @@ SSparseArrayDouble2dPtr get_sparse_features() {
   sparse_features->set_data_indices_rowindices(
       sparse_data, sparse_indices, sparse_indptr, n_samples, n_features);
   return sparse_features;
-}
\ No newline at end of file
+}
+
+SArrayDoublePtr get_sign_labels() {
+  ArrayDouble labels = *get_labels();
+  for (ulong i = 0; i < labels.size(); ++i) labels[i] = labels[i] > 0 ? 1 : -1;
+  return labels.as_sarray_ptr();
+}
+
+SArrayDoublePtr get_count_labels() {
+  ArrayDouble labels{0, 3, 1, 0, 2, 1, 4};
+  return labels.as_sarray_ptr();
+}
+
+// Checks the optimality conditions of the loss penalized by the L1 norm on
+// its first n_penalized coefficients
+void expect_l1_optimality(ModelDouble &model, ArrayDouble &coeffs,
+                          const double strength, const ulong n_penalized,
+                          const double tol) {
+  ArrayDouble grad(coeffs.size());
+  model.grad(coeffs, grad);
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    if (j >= n_penalized) {
+      EXPECT_NEAR(grad[j], 0, tol) << j;
+    } else if (coeffs[j] == 0) {
+      EXPECT_LE(std::abs(grad[j]), strength + tol) << j;
+    } else {
+      EXPECT_NEAR(grad[j], coeffs[j] > 0 ? -strength : strength, tol) << j;
+    }
+  }
+}
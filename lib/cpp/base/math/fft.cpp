@@ -0,0 +1,57 @@
+// License: BSD 3 clause
+
+#include "tick/base/math/fft.h"
+
+#include <cmath>
+#include <utility>
+
+#include "tick/base/base.h"
+
+ulong fft_size(const ulong n) {
+  ulong size = 1;
+  while (size < n) size <<= 1;
+  return size;
+}
+
+void fft(std::vector<std::complex<double> > &values, const bool inverse) {
+  const ulong n = values.size();
+  if (n == 0 || (n & (n - 1)) != 0) {
+    TICK_ERROR("fft size must be a power of 2, received " << n);
+  }
+
+  // Bit reversal permutation
+  for (ulong i = 1, j = 0; i < n; ++i) {
+    ulong bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(values[i], values[j]);
+  }
+
+  // Twiddle factors are computed once and for all to avoid accumulating
+  // rounding errors in long stages
+  const double sign = inverse ? 1 : -1;
+  std::vector<std::complex<double> > twiddles(n / 2);
+  for (ulong k = 0; k < n / 2; ++k) {
+    const double angle = sign * 2 * M_PI * k / n;
+    twiddles[k] = std::complex<double>(std::cos(angle), std::sin(angle));
+  }
+
+  // Iterative Cooley-Tukey butterflies
+  for (ulong length = 2; length <= n; length <<= 1) {
+    const ulong half_length = length / 2;
+    const ulong twiddle_step = n / length;
+    for (ulong start = 0; start < n; start += length) {
+      for (ulong k = 0; k < half_length; ++k) {
+        const std::complex<double> even = values[start + k];
+        const std::complex<double> odd =
+            values[start + k + half_length] * twiddles[k * twiddle_step];
+        values[start + k] = even + odd;
+        values[start + k + half_length] = even - odd;
+      }
+    }
+  }
+
+  if (inverse) {
+    for (ulong i = 0; i < n; ++i) values[i] /= static_cast<double>(n);
+  }
+}
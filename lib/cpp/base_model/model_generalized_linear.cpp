@@ -2,6 +2,31 @@
 
 #include "tick/base_model/model_generalized_linear.h"
 
+namespace {
+
+// Products of n_rows contiguous rows with coeffs, the matrix-vector kernel of
+// vector_operations being used when coeffs are plain values
+template <class T>
+void dot_rows(const ulong n_rows, const ulong n_cols, const T *rows,
+              const T *coeffs, T *out) {
+  tick::vector_operations<T>{}.dot_matrix_vector(n_rows, n_cols, T{1}, rows,
+                                                 coeffs, out);
+}
+
+template <class T>
+void dot_rows(const ulong n_rows, const ulong n_cols, const T *rows,
+              const std::atomic<T> *coeffs, T *out) {
+  for (ulong r = 0; r < n_rows; ++r) {
+    T inner_prod = 0;
+    for (ulong j = 0; j < n_cols; ++j) {
+      inner_prod += rows[r * n_cols + j] * coeffs[j].load();
+    }
+    out[r] = inner_prod;
+  }
+}
+
+}  // namespace
+
 template <class T, class K>
 TModelGeneralizedLinear<T, K>::TModelGeneralizedLinear(
     const std::shared_ptr<BaseArray2d<T>> features,
@@ -94,6 +119,76 @@ T TModelGeneralizedLinear<T, K>::loss(const Array<K> &coeffs) {
          n_samples;
 }
 
+template <class T, class K>
+bool TModelGeneralizedLinear<T, K>::is_hessian_point(
+    const Array<K> &coeffs) const {
+  if (!ready_hessian_factors || hessian_point.size() != coeffs.size()) {
+    return false;
+  }
+  for (ulong j = 0; j < coeffs.size(); ++j) {
+    if (hessian_point[j] != coeffs[j]) return false;
+  }
+  return true;
+}
+
+template <class T, class K>
+void TModelGeneralizedLinear<T, K>::inc_hessian_vector_product_i(
+    const ulong i, Array<T> &out, const Array<T> &vector) {
+  const BaseArray<T> x_i = get_features(i);
+  if (fit_intercept) {
+    const Array<T> vector_no_interc = view(vector, 0, n_features);
+    const T alpha_i =
+        hessian_factors[i] * (x_i.dot(vector_no_interc) + vector[n_features]);
+    Array<T> out_no_interc = view(out, 0, n_features);
+    out_no_interc.mult_incr(x_i, alpha_i);
+    out[n_features] += alpha_i;
+  } else {
+    out.mult_incr(x_i, hessian_factors[i] * x_i.dot(vector));
+  }
+}
+
+template <class T, class K>
+void TModelGeneralizedLinear<T, K>::inc_hessian_vector_product_at_i(
+    const ulong i, Array<T> &out, const Array<K> &coeffs,
+    const Array<T> &vector) {
+  hessian_factors[i] =
+      hessian_i_factor_from_inner_prod(i, get_inner_prod(i, coeffs));
+  inc_hessian_vector_product_i(i, out, vector);
+}
+
+template <class T, class K>
+void TModelGeneralizedLinear<T, K>::hessian_vector_product(
+    const Array<K> &coeffs, const Array<T> &vector, Array<T> &out) {
+  if (vector.size() != get_n_coeffs() || out.size() != get_n_coeffs()) {
+    TICK_ERROR("vector and out should have shape (" << get_n_coeffs()
+                                                    << ", )");
+  }
+  out.fill(0.0);
+  const auto redux = [](Array<T> &r, const Array<T> &s) {
+    r.mult_incr(s, 1.0);
+  };
+
+  if (is_hessian_point(coeffs)) {
+    parallel_map_array<Array<T>>(
+        n_threads, n_samples, redux,
+        &TModelGeneralizedLinear<T, K>::inc_hessian_vector_product_i, this,
+        out, vector);
+  } else {
+    // The hessian factors are computed along the product
+    ready_hessian_factors = false;
+    hessian_point = Array<T>(coeffs.size());
+    for (ulong j = 0; j < coeffs.size(); ++j) hessian_point[j] = coeffs[j];
+    hessian_factors = Array<T>(n_samples);
+    parallel_map_array<Array<T>>(
+        n_threads, n_samples, redux,
+        &TModelGeneralizedLinear<T, K>::inc_hessian_vector_product_at_i, this,
+        out, coeffs, vector);
+    ready_hessian_factors = true;
+  }
+
+  out *= 1.0 / n_samples;
+}
+
 template <class T, class K>
 void TModelGeneralizedLinear<T, K>::sdca_primal_dual_relation(
     const T l_l2sq, const Array<T> &dual_vector, Array<T> &out_primal_vector) {
@@ -139,6 +234,49 @@ T TModelGeneralizedLinear<T, K>::get_inner_prod(const ulong i,
   }
 }
 
+template <class T, class K>
+void TModelGeneralizedLinear<T, K>::get_inner_prods(const ArrayULong &indices,
+                                                    const Array<K> &coeffs,
+                                                    Array<T> &out) const {
+  const ulong batch_size = indices.size();
+  const T intercept = fit_intercept ? T(coeffs[n_features]) : T{0};
+  const T *features_data = features->data();
+  if (features->is_sparse()) {
+    const INDICE_TYPE *row_indices = features->row_indices();
+    const INDICE_TYPE *columns = features->indices();
+    for (ulong k = 0; k < batch_size; ++k) {
+      const ulong i = indices[k];
+      T inner_prod = intercept;
+      for (INDICE_TYPE idx = row_indices[i]; idx < row_indices[i + 1]; ++idx) {
+        inner_prod += features_data[idx] * T(coeffs[columns[idx]]);
+      }
+      out[k] = inner_prod;
+    }
+  } else {
+    ulong k = 0;
+    while (k < batch_size) {
+      ulong run_end = k + 1;
+      while (run_end < batch_size &&
+             indices[run_end] == indices[run_end - 1] + 1) {
+        ++run_end;
+      }
+      dot_rows(run_end - k, n_features, features_data + indices[k] * n_features,
+               coeffs.data(), out.data() + k);
+      for (; k < run_end; ++k) out[k] += intercept;
+    }
+  }
+}
+
+template <class T, class K>
+void TModelGeneralizedLinear<T, K>::grad_i_factors(const ArrayULong &indices,
+                                                   const Array<K> &coeffs,
+                                                   Array<T> &out) {
+  get_inner_prods(indices, coeffs, out);
+  for (ulong k = 0; k < indices.size(); ++k) {
+    out[k] = grad_i_factor_from_inner_prod(indices[k], out[k]);
+  }
+}
+
 template class TModelGeneralizedLinear<double, double>;
 template class TModelGeneralizedLinear<float, float>;
 
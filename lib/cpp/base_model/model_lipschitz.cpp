@@ -40,6 +40,12 @@ T TModelLipschitz<T, K>::get_lip_mean() {
   }
 }
 
+template <class T, class K>
+Array<T> TModelLipschitz<T, K>::get_lip_consts() {
+  compute_lip_consts();
+  return lip_consts;
+}
+
 template class TModelLipschitz<double, double>;
 template class TModelLipschitz<float, float>;
 
@@ -1,30 +1,152 @@
 // License: BSD 3 clause
 
 #include "tick/hawkes/inference/hawkes_adm4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 #include "tick/base/base.h"
+#include "tick/random/rand.h"
 
-HawkesADM4::HawkesADM4(const double decay, const double rho,
-                       const int max_n_threads,
-                       const unsigned int optimization_level)
-    : ModelHawkesList(max_n_threads, optimization_level) {
-  set_decay(decay);
-  set_rho(rho);
+namespace {
+
+//! @brief Transpose of a row major matrix
+ArrayDouble2d transpose(const ArrayDouble2d &matrix) {
+  ArrayDouble2d transposed(matrix.n_cols(), matrix.n_rows());
+  for (ulong i = 0; i < matrix.n_rows(); ++i) {
+    for (ulong j = 0; j < matrix.n_cols(); ++j) {
+      transposed(j, i) = matrix(i, j);
+    }
+  }
+  return transposed;
 }
 
-void HawkesADM4::compute_weights() {
-  // Allocate weights
-  next_mu = ArrayDouble2d(n_realizations, n_nodes);
-  next_C = ArrayDouble2d(n_realizations * n_nodes, n_nodes);
-  unnormalized_next_C = ArrayDouble2d(n_realizations * n_nodes, n_nodes);
+//! @brief Modified Gram-Schmidt orthonormalization of the rows of a matrix.
+//! Rows that are numerically dependent on previous ones are set to zero
+void orthonormalize_rows(ArrayDouble2d &matrix) {
+  for (ulong i = 0; i < matrix.n_rows(); ++i) {
+    ArrayDouble row_i = view_row(matrix, i);
+    const double original_norm = std::sqrt(row_i.norm_sq());
+    for (ulong j = 0; j < i; ++j) {
+      ArrayDouble row_j = view_row(matrix, j);
+      row_i.mult_incr(row_j, -row_i.dot(row_j));
+    }
+    const double norm = std::sqrt(row_i.norm_sq());
+    if (norm <= 1e-12 * original_norm || norm == 0) {
+      row_i.init_to_zero();
+    } else {
+      row_i /= norm;
+    }
+  }
+}
 
-  kernel_integral = ArrayDouble(n_nodes);
-  g = ArrayDouble2dList2D(n_realizations);
-  for (ulong r = 0; r < n_realizations; ++r) {
-    g[r] = ArrayDouble2dList1D(n_nodes);
-    for (ulong u = 0; u < n_nodes; ++u) {
-      g[r][u] = ArrayDouble2d(timestamps_list[r][u]->size(), n_nodes);
+//! @brief Cyclic Jacobi eigen decomposition of a small symmetric matrix.
+//! On exit, the diagonal of matrix holds the eigenvalues and the columns of
+//! eigenvectors the corresponding eigenvectors
+void jacobi_eigen_decomposition(ArrayDouble2d &matrix,
+                                ArrayDouble2d &eigenvectors) {
+  const ulong n = matrix.n_rows();
+  eigenvectors = ArrayDouble2d(n, n);
+  eigenvectors.init_to_zero();
+  for (ulong i = 0; i < n; ++i) eigenvectors(i, i) = 1;
+
+  for (int sweep = 0; sweep < 100; ++sweep) {
+    double off_diagonal = 0, diagonal = 0;
+    for (ulong p = 0; p < n; ++p) {
+      diagonal += matrix(p, p) * matrix(p, p);
+      for (ulong q = p + 1; q < n; ++q) off_diagonal += matrix(p, q) * matrix(p, q);
+    }
+    if (off_diagonal <= 1e-30 * diagonal) break;
+
+    for (ulong p = 0; p < n; ++p) {
+      for (ulong q = p + 1; q < n; ++q) {
+        if (matrix(p, q) == 0) continue;
+        const double theta = (matrix(q, q) - matrix(p, p)) / (2 * matrix(p, q));
+        const double t = (theta >= 0 ? 1. : -1.) /
+                         (std::fabs(theta) + std::sqrt(theta * theta + 1));
+        const double c = 1 / std::sqrt(t * t + 1);
+        const double s = t * c;
+        for (ulong k = 0; k < n; ++k) {
+          const double m_kp = matrix(k, p), m_kq = matrix(k, q);
+          matrix(k, p) = c * m_kp - s * m_kq;
+          matrix(k, q) = s * m_kp + c * m_kq;
+        }
+        for (ulong k = 0; k < n; ++k) {
+          const double m_pk = matrix(p, k), m_qk = matrix(q, k);
+          matrix(p, k) = c * m_pk - s * m_qk;
+          matrix(q, k) = s * m_pk + c * m_qk;
+        }
+        for (ulong k = 0; k < n; ++k) {
+          const double v_kp = eigenvectors(k, p), v_kq = eigenvectors(k, q);
+          eigenvectors(k, p) = c * v_kp - s * v_kq;
+          eigenvectors(k, q) = s * v_kp + c * v_kq;
+        }
+      }
     }
   }
+}
+
+//! @brief c = a . b for row major matrices
+ArrayDouble2d dot(const ArrayDouble2d &a, const ArrayDouble2d &b) {
+  ArrayDouble2d c(a.n_rows(), b.n_cols());
+  tick::vector_operations<double>{}.dot_matrix_matrix(
+      a.n_rows(), b.n_cols(), a.n_cols(), 1., a.data(), b.data(), 0.,
+      c.data());
+  return c;
+}
+
+//! @brief c += a . b for row major matrices
+void dot_incr(const ArrayDouble2d &a, const ArrayDouble2d &b,
+              ArrayDouble2d &c) {
+  tick::vector_operations<double>{}.dot_matrix_matrix(
+      a.n_rows(), b.n_cols(), a.n_cols(), 1., a.data(), b.data(), 1.,
+      c.data());
+}
+
+//! @brief Norm of new_values - old_values relatively to the norm of
+//! old_values, as tick.solver.base.utils.relative_distance does
+double relative_distance(const double *new_values, const double *old_values,
+                         const ulong size) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < size; ++j) {
+    const double diff = new_values[j] - old_values[j];
+    norm_diff += diff * diff;
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+//! @brief Values recorded for each checked iteration of fit: iteration
+//! number and relative changes of mu and adjacency
+const ulong n_fit_history_columns = 3;
+
+//! @brief Iterations run by fit before convergence is accepted, the relative
+//! changes are sometimes small at start when the inner tolerance is low
+const ulong min_fit_iter = 7;
+
+}  // namespace
+
+template <class T>
+THawkesADM4<T>::THawkesADM4(const double decay, const double rho,
+                            const int max_n_threads,
+                            const unsigned int optimization_level)
+    : ModelHawkesList(max_n_threads, optimization_level),
+      weights_threshold(0),
+      max_rank(10) {
+  set_decay(decay);
+  set_rho(rho);
+}
+
+template <class T>
+void THawkesADM4<T>::compute_weights() {
+  kernel_integral = ArrayDouble(n_nodes);
+  g_indptr = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  g_indices = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  g_values = std::vector<std::vector<T> >(n_realizations * n_nodes);
+  g_columns = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  next_mu = ArrayDouble2d(n_realizations, n_nodes);
+  next_C_ru = std::vector<std::vector<double> >(n_realizations * n_nodes);
 
   // Compute weights
   // variable to compute kernel integral in parallel that will be reduced
@@ -32,7 +154,7 @@ void HawkesADM4::compute_weights() {
   ArrayDouble2d map_kernel_integral(n_realizations, n_nodes);
   map_kernel_integral.init_to_zero();
   parallel_run(get_n_threads(), n_nodes * n_realizations,
-               &HawkesADM4::compute_weights_ru, this, map_kernel_integral);
+               &THawkesADM4<T>::compute_weights_ru, this, map_kernel_integral);
 
   kernel_integral.init_to_zero();
   for (ulong r = 0; r < n_realizations; ++r) {
@@ -46,48 +168,78 @@ void HawkesADM4::compute_weights() {
 }
 
 // This code is very similar to ModelHawkesExpKernLogLikSingle
-void HawkesADM4::compute_weights_ru(const ulong r_u,
-                                    ArrayDouble2d &map_kernel_integral) {
+template <class T>
+void THawkesADM4<T>::compute_weights_ru(const ulong r_u,
+                                        ArrayDouble2d &map_kernel_integral) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong u = r_u % n_nodes;
-  ArrayDouble2d g_ru = view(g[r][u]);
   const ArrayDouble timestamps_ru = view(*timestamps_list[r][u]);
+  const ulong n_jumps_ru = timestamps_ru.size();
   const double end_time_r = (*end_times)[r];
   ArrayDouble map_kernel_integral_r = view_row(map_kernel_integral, r);
 
+  // We use this pass over the data to fill kernel_integral
+  for (ulong k = 0; k < n_jumps_ru; k++) {
+    map_kernel_integral_r[u] +=
+        (1. - cexp(-decay * (end_time_r - timestamps_ru[k])));
+  }
+
+  // Kernel values g_ru_k_v are computed node per node with the usual
+  // recursion and only those above weights_threshold are kept, as
+  // (event, column) entries later sorted by event
+  std::vector<ulong> &columns = g_columns[r_u];
+  columns.clear();
+  std::vector<ulong> entries_k, entries_column;
+  std::vector<T> entries_values;
   for (ulong v = 0; v < n_nodes; v++) {
     const ArrayDouble timestamps_rv = view(*timestamps_list[r][v]);
     ulong ij = 0;
-    for (ulong k = 0; k < timestamps_ru.size(); k++) {
+    double g_ru_k_v = 0;
+    bool has_entries = false;
+    for (ulong k = 0; k < n_jumps_ru; k++) {
       const double t_ru_k = timestamps_ru[k];
 
-      if (k > 0) {
-        const double ebt = cexp(-decay * (t_ru_k - timestamps_ru[k - 1]));
-        g_ru[k * n_nodes + v] = g_ru[(k - 1) * n_nodes + v] * ebt;
-      } else {
-        if (k < timestamps_ru.size()) g_ru[k * n_nodes + v] = 0;
-      }
+      if (k > 0) g_ru_k_v *= cexp(-decay * (t_ru_k - timestamps_ru[k - 1]));
       while ((ij < timestamps_rv.size()) && (timestamps_rv[ij] < t_ru_k)) {
         const double ebt = cexp(-decay * (t_ru_k - timestamps_rv[ij]));
-        g_ru[k * n_nodes + v] += decay * ebt;
+        g_ru_k_v += decay * ebt;
         ij++;
       }
-
-      if (u == v) {
-        // We use this pass over the data to fill kernel_integral
-        map_kernel_integral_r[u] += (1. - cexp(-decay * (end_time_r - t_ru_k)));
+      if (g_ru_k_v > 0 && g_ru_k_v >= weights_threshold) {
+        entries_k.push_back(k);
+        entries_column.push_back(columns.size());
+        entries_values.push_back(static_cast<T>(g_ru_k_v));
+        has_entries = true;
       }
     }
+    if (has_entries) columns.push_back(v);
   }
-}
 
-// The main method for performing one iteration
-void HawkesADM4::solve(ArrayDouble &mu, ArrayDouble2d &adjacency,
-                       ArrayDouble2d &z1, ArrayDouble2d &z2, ArrayDouble2d &u1,
-                       ArrayDouble2d &u2) {
-  if (!weights_computed) compute_weights();
+  // Counting sort of the entries into a compressed row storage indexed by
+  // the events of u
+  std::vector<ulong> &indptr = g_indptr[r_u];
+  std::vector<ulong> &indices = g_indices[r_u];
+  std::vector<T> &values = g_values[r_u];
+  indptr.assign(n_jumps_ru + 1, 0);
+  for (const ulong k : entries_k) indptr[k + 1]++;
+  for (ulong k = 0; k < n_jumps_ru; k++) indptr[k + 1] += indptr[k];
+  indices.resize(entries_k.size());
+  values.resize(entries_k.size());
+  std::vector<ulong> position(indptr.begin(), indptr.end() - 1);
+  for (ulong p = 0; p < entries_k.size(); ++p) {
+    const ulong dest = position[entries_k[p]]++;
+    indices[dest] = entries_column[p];
+    values[dest] = entries_values[p];
+  }
+  next_C_ru[r_u].assign(columns.size(), 0.);
+}
 
+template <class T>
+void THawkesADM4<T>::check_shapes(const ArrayDouble &mu,
+                                  const ArrayDouble2d &adjacency,
+                                  const ArrayDouble2d &u1,
+                                  const ArrayDouble2d &u2) const {
   if (mu.size() != n_nodes) {
     TICK_ERROR("mu argument must be an array of shape (" << n_nodes << ",)");
   }
@@ -95,14 +247,6 @@ void HawkesADM4::solve(ArrayDouble &mu, ArrayDouble2d &adjacency,
     TICK_ERROR("adjacency matrix must be an array of shape ("
                << n_nodes << ", " << n_nodes << ")");
   }
-  if (z1.n_rows() != n_nodes || z1.n_cols() != n_nodes) {
-    TICK_ERROR("Z1 matrix must be an array of shape (" << n_nodes << ", "
-                                                       << n_nodes << ")");
-  }
-  if (z2.n_rows() != n_nodes || z2.n_cols() != n_nodes) {
-    TICK_ERROR("Z2 matrix must be an array of shape (" << n_nodes << ", "
-                                                       << n_nodes << ")");
-  }
   if (u1.n_rows() != n_nodes || u1.n_cols() != n_nodes) {
     TICK_ERROR("U1 matrix must be an array of shape (" << n_nodes << ", "
                                                        << n_nodes << ")");
@@ -111,101 +255,389 @@ void HawkesADM4::solve(ArrayDouble &mu, ArrayDouble2d &adjacency,
     TICK_ERROR("U2 matrix must be an array of shape (" << n_nodes << ", "
                                                        << n_nodes << ")");
   }
+}
 
-  next_C.init_to_zero();
-  next_mu.init_to_zero();
+// The main method for performing one iteration
+template <class T>
+void THawkesADM4<T>::solve(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                           ArrayDouble2d &z1, ArrayDouble2d &z2,
+                           ArrayDouble2d &u1, ArrayDouble2d &u2) {
+  if (!weights_computed) compute_weights();
 
+  check_shapes(mu, adjacency, u1, u2);
+  if (z1.n_rows() != n_nodes || z1.n_cols() != n_nodes) {
+    TICK_ERROR("Z1 matrix must be an array of shape (" << n_nodes << ", "
+                                                       << n_nodes << ")");
+  }
+  if (z2.n_rows() != n_nodes || z2.n_cols() != n_nodes) {
+    TICK_ERROR("Z2 matrix must be an array of shape (" << n_nodes << ", "
+                                                       << n_nodes << ")");
+  }
+
+  // Events of each realization and node are majorized by a single task, the
+  // results are then reduced over realizations node per node
   parallel_run(get_n_threads(), n_nodes * n_realizations,
-               &HawkesADM4::estimate_ru, this, mu, adjacency);
+               &THawkesADM4<T>::estimate_ru, this, mu, adjacency);
   parallel_run(
       std::min(get_n_threads(), static_cast<const unsigned int>(n_nodes)),
-      n_nodes, &HawkesADM4::update_u, this, mu, adjacency, z1, z2, u1, u2);
+      n_nodes, &THawkesADM4<T>::update_u, this, mu, adjacency, z1, z2, u1, u2);
+}
+
+template <class T>
+ulong THawkesADM4<T>::solve_em(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                               ArrayDouble2d &z1, ArrayDouble2d &z2,
+                               ArrayDouble2d &u1, ArrayDouble2d &u2,
+                               const ulong em_max_iter, const double em_tol) {
+  return run_em(mu, adjacency, em_max_iter, em_tol,
+                [&]() { solve(mu, adjacency, z1, z2, u1, u2); });
+}
+
+template <class T>
+void THawkesADM4<T>::reset_components() {
+  low_rank_left = ArrayDouble2d(0, n_nodes);
+  low_rank_right = ArrayDouble2d(0, n_nodes);
+  low_rank_singular_values = ArrayDouble(0);
+  sparse_indices = std::vector<std::vector<ulong> >(n_nodes);
+  sparse_values = std::vector<std::vector<double> >(n_nodes);
+}
+
+template <class T>
+ulong THawkesADM4<T>::solve_em_low_rank(ArrayDouble &mu,
+                                        ArrayDouble2d &adjacency,
+                                        ArrayDouble2d &u1, ArrayDouble2d &u2,
+                                        const ulong em_max_iter,
+                                        const double em_tol) {
+  if (!weights_computed) compute_weights();
+  check_shapes(mu, adjacency, u1, u2);
+  if (sparse_indices.size() != n_nodes) reset_components();
+
+  return run_em(mu, adjacency, em_max_iter, em_tol, [&]() {
+    parallel_run(get_n_threads(), n_nodes * n_realizations,
+                 &THawkesADM4<T>::estimate_ru, this, mu, adjacency);
+    parallel_run(
+        std::min(get_n_threads(), static_cast<const unsigned int>(n_nodes)),
+        n_nodes, &THawkesADM4<T>::update_low_rank_u, this, mu, adjacency, u1,
+        u2);
+  });
 }
 
-// Procedure called by HawkesADM4::solve
-void HawkesADM4::estimate_ru(const ulong r_u, ArrayDouble &mu,
-                             ArrayDouble2d &adjacency) {
+template <class T>
+ulong THawkesADM4<T>::run_em(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                             const ulong em_max_iter, const double em_tol,
+                             const std::function<void()> &iteration) {
+  ArrayDouble previous_mu(mu.size());
+  ArrayDouble previous_adjacency(adjacency.size());
+  for (ulong iter = 0; iter < em_max_iter; ++iter) {
+    previous_mu.mult_fill(mu, 1.);
+    std::copy(adjacency.data(), adjacency.data() + adjacency.size(),
+              previous_adjacency.data());
+
+    iteration();
+
+    const double rel_baseline =
+        relative_distance(mu.data(), previous_mu.data(), mu.size());
+    const double rel_adjacency = relative_distance(
+        adjacency.data(), previous_adjacency.data(), adjacency.size());
+    if (std::max(rel_baseline, rel_adjacency) < em_tol) return iter + 1;
+  }
+  return em_max_iter;
+}
+
+// Procedure called in parallel by THawkesADM4<T>::solve
+template <class T>
+void THawkesADM4<T>::estimate_ru(const ulong r_u, const ArrayDouble &mu,
+                                 const ArrayDouble2d &adjacency) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
-  const ulong node_u = r_u % n_nodes;
-
-  // Fetch corresponding data
-  SArrayDoublePtrList1D &realization = timestamps_list[r];
-  ArrayDouble adjacency_u = view_row(adjacency, node_u);
-  ArrayDouble2d g_ru = view(g[r][node_u]);
-  double mu_u = mu[node_u];
-
-  // initialize next data
-  double &next_mu_ur = next_mu(r, node_u);
-  ArrayDouble next_C_ru = view_row(next_C, r * n_nodes + node_u);
-  ArrayDouble unnormalized_next_C_ru =
-      view_row(unnormalized_next_C, r * n_nodes + node_u);
-
-  // We loop in reverse order to benefit from last_indices
-  for (ulong i = realization[node_u]->size() - 1; i != static_cast<ulong>(-1);
-       i--) {
-    // this array will store temporary values
-    unnormalized_next_C_ru.init_to_zero();
-    ArrayDouble g_ru_i = view_row(g_ru, i);
+  const ulong u = r_u % n_nodes;
 
+  const std::vector<ulong> &indptr = g_indptr[r_u];
+  const ulong *indices = g_indices[r_u].data();
+  const T *values = g_values[r_u].data();
+  const std::vector<ulong> &columns = g_columns[r_u];
+  const double mu_u = mu[u];
+
+  // Entries of adjacency_u are gathered once for the columns in the weights
+  std::vector<double> adjacency_ru(columns.size());
+  for (ulong c = 0; c < columns.size(); ++c) {
+    adjacency_ru[c] = adjacency(u, columns[c]);
+  }
+
+  std::vector<double> &next_C = next_C_ru[r_u];
+  std::fill(next_C.begin(), next_C.end(), 0.);
+  double next_mu_ru = 0;
+  for (ulong i = 0; i + 1 < indptr.size(); ++i) {
     // norm will be equal to mu_u + \sum_v \sum_(t_j < t_i) a_uv g(t_i - t_j)
     double norm = mu_u;
-
-    for (ulong node_v = 0; node_v < n_nodes; node_v++) {
-      const double sum_unnormalized_p_ij = adjacency_u[node_v] * g_ru_i[node_v];
-      unnormalized_next_C_ru[node_v] += sum_unnormalized_p_ij;
-      norm += sum_unnormalized_p_ij;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; ++p) {
+      norm += adjacency_ru[indices[p]] * values[p];
     }
 
-    next_mu_ur += mu_u / norm;
-    next_C_ru.mult_incr(unnormalized_next_C_ru, 1. / norm);
+    next_mu_ru += mu_u / norm;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; ++p) {
+      next_C[indices[p]] += adjacency_ru[indices[p]] * values[p] / norm;
+    }
   }
+  next_mu(r, u) = next_mu_ru;
 }
 
 // A method called in parallel by the method 'solve' (see below)
-void HawkesADM4::update_u(const ulong u, ArrayDouble &mu,
-                          ArrayDouble2d &adjacency, ArrayDouble2d &z1,
-                          ArrayDouble2d &z2, ArrayDouble2d &u1,
-                          ArrayDouble2d &u2) {
+template <class T>
+void THawkesADM4<T>::update_u(const ulong u, ArrayDouble &mu,
+                              ArrayDouble2d &adjacency, ArrayDouble2d &z1,
+                              ArrayDouble2d &z2, ArrayDouble2d &u1,
+                              ArrayDouble2d &u2) {
   ArrayDouble adjacency_u = view_row(adjacency, u);
+  update_adjacency_u(u, mu, adjacency_u, view_row(z1, u), view_row(z2, u),
+                     view_row(u1, u), view_row(u2, u));
+}
 
-  ArrayDouble z1_u = view_row(z1, u);
-  ArrayDouble z2_u = view_row(z2, u);
-  ArrayDouble u1_u = view_row(u1, u);
-  ArrayDouble u2_u = view_row(u2, u);
+// A method called in parallel by the method 'solve_em_low_rank'
+template <class T>
+void THawkesADM4<T>::update_low_rank_u(const ulong u, ArrayDouble &mu,
+                                       ArrayDouble2d &adjacency,
+                                       ArrayDouble2d &u1, ArrayDouble2d &u2) {
+  // Only row u of the components is formed, by each task
+  ArrayDouble z1_u(n_nodes), z2_u(n_nodes);
+  fill_low_rank_row(u, z1_u);
+  fill_sparse_row(u, z2_u);
 
-  update_adjacency_u(u, adjacency_u, z1_u, z2_u, u1_u, u2_u);
-  update_baseline_u(u, mu);
+  ArrayDouble adjacency_u = view_row(adjacency, u);
+  update_adjacency_u(u, mu, adjacency_u, z1_u, z2_u, view_row(u1, u),
+                     view_row(u2, u));
 }
 
-// Procedure called by HawkesADM4::solve
-void HawkesADM4::update_adjacency_u(const ulong u, ArrayDouble &adjacency_u,
-                                    ArrayDouble &z1_u, ArrayDouble &z2_u,
-                                    ArrayDouble &u1_u, ArrayDouble &u2_u) {
+template <class T>
+void THawkesADM4<T>::update_adjacency_u(const ulong u, ArrayDouble &mu,
+                                        ArrayDouble &adjacency_u,
+                                        const ArrayDouble &z1_u,
+                                        const ArrayDouble &z2_u,
+                                        const ArrayDouble &u1_u,
+                                        const ArrayDouble &u2_u) {
+  // Thread local reduction of the majorization over realizations
+  ArrayDouble next_C_u(n_nodes);
+  next_C_u.init_to_zero();
+  double next_mu_u = 0;
+  for (ulong r = 0; r < n_realizations; ++r) {
+    const ulong r_u = r * n_nodes + u;
+    const std::vector<ulong> &columns = g_columns[r_u];
+    for (ulong c = 0; c < columns.size(); ++c) {
+      next_C_u[columns[c]] += next_C_ru[r_u][c];
+    }
+    next_mu_u += next_mu(r, u);
+  }
+
   for (ulong v = 0; v < n_nodes; v++) {
     const double B =
         kernel_integral[v] + rho * (-z1_u[v] + u1_u[v] - z2_u[v] + u2_u[v]);
-
-    double C = 0;
-    for (ulong r = 0; r < n_realizations; ++r) {
-      C += next_C(r * n_nodes + u, v);
-    }
+    const double C = next_C_u[v];
 
     // computation of updated value
     adjacency_u[v] = (-B + sqrt(B * B + 8 * rho * C)) / (4 * rho);
   }
+  mu[u] = next_mu_u / end_times->sum();
 }
 
-void HawkesADM4::update_baseline_u(const ulong u, ArrayDouble &mu) {
-  mu[u] = 0;
-  for (ulong r = 0; r < n_realizations; ++r) {
-    mu[u] += next_mu(r, u) / end_times->sum();
+template <class T>
+void THawkesADM4<T>::fill_low_rank_row(const ulong u, ArrayDouble &z1_u) const {
+  z1_u.init_to_zero();
+  for (ulong k = 0; k < low_rank_singular_values.size(); ++k) {
+    const double scale = low_rank_left(k, u) * low_rank_singular_values[k];
+    for (ulong v = 0; v < n_nodes; ++v) {
+      z1_u[v] += scale * low_rank_right(k, v);
+    }
+  }
+}
+
+template <class T>
+void THawkesADM4<T>::fill_sparse_row(const ulong u, ArrayDouble &z2_u) const {
+  z2_u.init_to_zero();
+  for (ulong p = 0; p < sparse_indices[u].size(); ++p) {
+    z2_u[sparse_indices[u][p]] = sparse_values[u][p];
+  }
+}
+
+template <class T>
+void THawkesADM4<T>::update_components(ArrayDouble2d &adjacency,
+                                       ArrayDouble2d &u1, ArrayDouble2d &u2,
+                                       const double strength_lasso,
+                                       const double strength_nuclear) {
+  check_shapes(ArrayDouble(n_nodes), adjacency, u1, u2);
+  if (sparse_indices.size() != n_nodes) reset_components();
+
+  compute_low_rank(adjacency, u1, strength_nuclear / rho);
+  const double lasso_threshold = strength_lasso / rho;
+  parallel_run(
+      std::min(get_n_threads(), static_cast<const unsigned int>(n_nodes)),
+      n_nodes, &THawkesADM4<T>::update_components_u, this, adjacency, u1, u2,
+      lasso_threshold);
+}
+
+template <class T>
+ulong THawkesADM4<T>::fit(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                          const double strength_lasso,
+                          const double strength_nuclear, const ulong max_iter,
+                          const double tol, const ulong em_max_iter,
+                          const double em_tol, const ulong record_every) {
+  if (!weights_computed) compute_weights();
+  ArrayDouble2d u1(n_nodes, n_nodes), u2(n_nodes, n_nodes);
+  u1.init_to_zero();
+  u2.init_to_zero();
+  check_shapes(mu, adjacency, u1, u2);
+  reset_components();
+
+  fit_history.clear();
+  ArrayDouble previous_mu(mu.size());
+  ArrayDouble previous_adjacency(adjacency.size());
+  // Without em_tol, the inner EM stops once it changes the parameters a
+  // hundred times less than the last checked iteration
+  double max_relative_distance = 1e-1;
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const bool record = iter + 1 == max_iter ||
+                        (record_every > 0 && iter % record_every == 0);
+    if (record) {
+      previous_mu.mult_fill(mu, 1.);
+      std::copy(adjacency.data(), adjacency.data() + adjacency.size(),
+                previous_adjacency.data());
+    }
+
+    const double inner_tol =
+        em_tol < 0 ? max_relative_distance * 1e-2 : em_tol;
+    solve_em_low_rank(mu, adjacency, u1, u2, em_max_iter, inner_tol);
+    update_components(adjacency, u1, u2, strength_lasso, strength_nuclear);
+
+    if (record) {
+      const double rel_baseline =
+          relative_distance(mu.data(), previous_mu.data(), mu.size());
+      const double rel_adjacency = relative_distance(
+          adjacency.data(), previous_adjacency.data(), adjacency.size());
+      fit_history.insert(fit_history.end(), {static_cast<double>(iter + 1),
+                                             rel_baseline, rel_adjacency});
+
+      max_relative_distance = std::max(rel_baseline, rel_adjacency);
+      if (max_relative_distance <= tol && iter + 1 >= min_fit_iter) {
+        return iter + 1;
+      }
+    }
+  }
+  return max_iter;
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesADM4<T>::get_fit_history() const {
+  ArrayDouble2d history_array(fit_history.size() / n_fit_history_columns,
+                              n_fit_history_columns);
+  std::copy(fit_history.begin(), fit_history.end(), history_array.data());
+  return history_array.as_sarray2d_ptr();
+}
+
+template <class T>
+void THawkesADM4<T>::update_components_u(const ulong u,
+                                         ArrayDouble2d &adjacency,
+                                         ArrayDouble2d &u1, ArrayDouble2d &u2,
+                                         const double threshold) {
+  const ArrayDouble adjacency_u = view_row(adjacency, u);
+  ArrayDouble u1_u = view_row(u1, u);
+  ArrayDouble u2_u = view_row(u2, u);
+
+  // u1 += adjacency - z1
+  ArrayDouble z1_u(n_nodes);
+  fill_low_rank_row(u, z1_u);
+  u1_u.mult_incr(adjacency_u, 1.);
+  u1_u.mult_incr(z1_u, -1.);
+
+  // z2 = soft thresholding of x = adjacency + u2, then u2 += adjacency - z2,
+  // that is u2 = x - z2
+  std::vector<ulong> &indices = sparse_indices[u];
+  std::vector<double> &values = sparse_values[u];
+  indices.clear();
+  values.clear();
+  for (ulong v = 0; v < n_nodes; ++v) {
+    const double x_v = adjacency_u[v] + u2_u[v];
+    if (std::fabs(x_v) > threshold) {
+      const double z2_v = x_v > 0 ? x_v - threshold : x_v + threshold;
+      indices.push_back(v);
+      values.push_back(z2_v);
+      u2_u[v] = x_v - z2_v;
+    } else {
+      u2_u[v] = x_v;
+    }
+  }
+}
+
+template <class T>
+void THawkesADM4<T>::compute_low_rank(const ArrayDouble2d &adjacency,
+                                      const ArrayDouble2d &u1,
+                                      const double threshold) {
+  // Products with x = adjacency + u1 are computed without forming it
+  auto x_dot = [&adjacency, &u1](const ArrayDouble2d &matrix) {
+    ArrayDouble2d product = dot(adjacency, matrix);
+    dot_incr(u1, matrix, product);
+    return product;
+  };
+  auto dot_x = [&adjacency, &u1](const ArrayDouble2d &matrix) {
+    ArrayDouble2d product = dot(matrix, adjacency);
+    dot_incr(matrix, u1, product);
+    return product;
+  };
+
+  // Randomized range finder (Halko, Martinsson and Tropp, 2011) with a few
+  // power iterations, the sketch is slightly larger than max_rank
+  const ulong sketch_size = std::min(n_nodes, max_rank + 10);
+  Rand rand(static_cast<int>(n_nodes));
+  ArrayDouble2d omega(n_nodes, sketch_size);
+  for (ulong k = 0; k < omega.size(); ++k) omega[k] = rand.gaussian();
+
+  ArrayDouble2d range_t = transpose(x_dot(omega));
+  orthonormalize_rows(range_t);
+  for (int power_iteration = 0; power_iteration < 2; ++power_iteration) {
+    ArrayDouble2d co_range_t = dot_x(range_t);
+    orthonormalize_rows(co_range_t);
+    range_t = transpose(x_dot(transpose(co_range_t)));
+    orthonormalize_rows(range_t);
+  }
+
+  // SVD of the small projected matrix b = range^T x through the eigen
+  // decomposition of b b^T
+  ArrayDouble2d b = dot_x(range_t);
+  ArrayDouble2d b_b_t = dot(b, transpose(b));
+  ArrayDouble2d eigenvectors;
+  jacobi_eigen_decomposition(b_b_t, eigenvectors);
+
+  std::vector<ulong> order(sketch_size);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&b_b_t](ulong i, ulong j) { return b_b_t(i, i) > b_b_t(j, j); });
+
+  // Singular values are soft thresholded, only positive ones are kept
+  ulong rank = 0;
+  while (rank < std::min(max_rank, sketch_size) &&
+         std::sqrt(std::max(b_b_t(order[rank], order[rank]), 0.)) > threshold)
+    rank++;
+
+  low_rank_left = ArrayDouble2d(rank, n_nodes);
+  low_rank_right = ArrayDouble2d(rank, n_nodes);
+  low_rank_singular_values = ArrayDouble(rank);
+  low_rank_left.init_to_zero();
+  low_rank_right.init_to_zero();
+  for (ulong j = 0; j < rank; ++j) {
+    const double singular_value = std::sqrt(b_b_t(order[j], order[j]));
+    low_rank_singular_values[j] = singular_value - threshold;
+    ArrayDouble left_j = view_row(low_rank_left, j);
+    ArrayDouble right_j = view_row(low_rank_right, j);
+    for (ulong l = 0; l < sketch_size; ++l) {
+      const double w_lj = eigenvectors(l, order[j]);
+      left_j.mult_incr(view_row(range_t, l), w_lj);
+      right_j.mult_incr(view_row(b, l), w_lj / singular_value);
+    }
   }
 }
 
-double HawkesADM4::get_decay() const { return decay; }
+template <class T>
+double THawkesADM4<T>::get_decay() const { return decay; }
 
-void HawkesADM4::set_decay(const double decay) {
+template <class T>
+void THawkesADM4<T>::set_decay(const double decay) {
   if (decay <= 0) {
     TICK_ERROR("decay must be positive, received " << decay);
   }
@@ -213,11 +645,60 @@ void HawkesADM4::set_decay(const double decay) {
   weights_computed = false;
 }
 
-double HawkesADM4::get_rho() const { return rho; }
+template <class T>
+double THawkesADM4<T>::get_rho() const { return rho; }
 
-void HawkesADM4::set_rho(double rho) {
+template <class T>
+void THawkesADM4<T>::set_rho(double rho) {
   if (rho <= 0) {
     TICK_ERROR("rho (penalty parameter) must be positive, received " << rho);
   }
   this->rho = rho;
 }
+
+template <class T>
+double THawkesADM4<T>::get_weights_threshold() const {
+  return weights_threshold;
+}
+
+template <class T>
+void THawkesADM4<T>::set_weights_threshold(const double weights_threshold) {
+  if (weights_threshold < 0) {
+    TICK_ERROR("weights threshold must be non negative, received "
+               << weights_threshold);
+  }
+  this->weights_threshold = weights_threshold;
+  weights_computed = false;
+}
+
+template <class T>
+ulong THawkesADM4<T>::get_max_rank() const { return max_rank; }
+
+template <class T>
+void THawkesADM4<T>::set_max_rank(const ulong max_rank) {
+  if (max_rank == 0) {
+    TICK_ERROR("max rank must be positive");
+  }
+  this->max_rank = max_rank;
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesADM4<T>::get_low_rank_left() const {
+  ArrayDouble2d copied_low_rank_left = low_rank_left;
+  return copied_low_rank_left.as_sarray2d_ptr();
+}
+
+template <class T>
+SArrayDoublePtr THawkesADM4<T>::get_low_rank_singular_values() const {
+  ArrayDouble copied_singular_values = low_rank_singular_values;
+  return copied_singular_values.as_sarray_ptr();
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesADM4<T>::get_low_rank_right() const {
+  ArrayDouble2d copied_low_rank_right = low_rank_right;
+  return copied_low_rank_right.as_sarray2d_ptr();
+}
+
+template class DLL_PUBLIC THawkesADM4<double>;
+template class DLL_PUBLIC THawkesADM4<float>;
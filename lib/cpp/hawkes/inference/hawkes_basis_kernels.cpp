@@ -2,7 +2,28 @@
 
 #include "tick/hawkes/inference/hawkes_basis_kernels.h"
 
-// Procedure called by HawkesBasisKernels::solve
+#include <algorithm>
+#include <cmath>
+
+// Values recorded for each checked iteration of fit: iteration number,
+// relative changes of baseline, amplitudes and basis kernels and relative
+// error of the basis kernels updates
+static const ulong n_fit_history_columns = 5;
+
+// Norm of new_values - old_values relatively to the norm of old_values, as
+// tick.solver.base.utils.relative_distance does
+static double relative_distance(const double *new_values,
+                                const double *old_values, const ulong size) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < size; ++j) {
+    const double diff = new_values[j] - old_values[j];
+    norm_diff += diff * diff;
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+// Procedure called by THawkesBasisKernels<T>::solve
 // Not commented, see LaTeX notes
 void compute_r(ArrayDouble &u_realization, double T, double kernel_dt,
                ArrayDouble2d &gdm, ArrayDouble2d &Gdm, ArrayDouble &rd) {
@@ -24,7 +45,7 @@ void compute_r(ArrayDouble &u_realization, double T, double kernel_dt,
   }
 }
 
-// Procedure called by HawkesBasisKernels::solve
+// Procedure called by THawkesBasisKernels<T>::solve
 // Not commented, see LaTeX notes
 void compute_C(ArrayDouble &u_realization, double T, double kernel_dt,
                ArrayDouble2d &gdm, ArrayDouble &a_sum, ArrayDouble2d &Cdm) {
@@ -42,82 +63,7 @@ void compute_C(ArrayDouble &u_realization, double T, double kernel_dt,
   }
 }
 
-// Procedure called by HawkesBasisKernels::solve
-// Not commented, see LaTeX notes
-double compute_mu_q_D(ulong u_index, SArrayDoublePtrList1D &realization,
-                      double T, double kernel_dt, ArrayDouble2d &gdm,
-                      ArrayDouble2d &avd, double mu, ArrayDouble2d &qvd,
-                      ArrayDouble2d &qvd_temp, ArrayDouble2d &Ddm,
-                      ArrayDouble2d &Ddm_temp) {
-  ulong dim = qvd.n_rows();
-  ulong M = gdm.n_cols();
-  ulong D = gdm.n_rows();
-
-  ArrayDouble &u = *realization[u_index];
-
-  ArrayULong v_indices(dim);
-  for (ulong n = 0; n < dim; n++) {
-    v_indices[n] = realization[n]->size();
-  }
-
-  double mu_out = 0;
-
-  for (ulong i = u.size() - 1; i != static_cast<ulong>(-1); i--) {
-    double norm = 0;
-    qvd_temp.init_to_zero();
-    Ddm_temp.init_to_zero();
-
-    double t_i = u[i];
-
-    for (ulong v_index = 0; v_index < dim; v_index++) {
-      ArrayDouble &v = *realization[v_index];
-
-      while (true) {
-        if (v_indices[v_index] == 0) break;
-        if (v_indices[v_index] < v.size() && t_i >= v[v_indices[v_index]])
-          break;
-        v_indices[v_index]--;
-      }
-      if (t_i < v[v_indices[v_index]]) continue;
-
-      ulong j0 = v_indices[v_index];
-
-      ArrayDouble ad = view_row(avd, v_index);
-      ArrayDouble qd_temp = view_row(qvd_temp, v_index);
-
-      for (ulong j = j0; j != static_cast<ulong>(-1); j--) {
-        double t_j = v[j];
-        if (u_index == v_index && i == j) {
-          norm += mu;
-        } else {
-          ulong m = static_cast<ulong>(std::floor((t_i - t_j) / kernel_dt));
-          if (m >= M) break;
-          for (ulong d = 0; d < D; d++) {
-            double val = ad[d] * gdm[d * M + m];
-            qd_temp[d] += val;
-            Ddm_temp[d * M + m] += val;
-            norm += val;
-          }
-        }
-      }
-    }
-
-    mu_out += mu / norm;
-    for (ulong d = 0; d < D; d++) {
-      for (ulong m = 0; m < M; m++) {
-        Ddm[d * M + m] += Ddm_temp[d * M + m] / (norm * kernel_dt);
-      }
-      for (ulong v_index = 0; v_index < dim; v_index++) {
-        qvd[v_index * D + d] +=
-            avd[v_index * D + d] * qvd_temp[v_index * D + d] / norm;
-      }
-    }
-  }
-
-  return mu_out;
-}
-
-// Procedure called by HawkesBasisKernels::solve
+// Procedure called by THawkesBasisKernels<T>::solve
 // Not commented, see LaTeX notes
 double compute_gdm(double alpha, double kernel_dx, ArrayDouble &gdm,
                    ArrayDouble &Cdm, ArrayDouble &Ddm, double tol,
@@ -153,10 +99,12 @@ double compute_gdm(double alpha, double kernel_dx, ArrayDouble &gdm,
 }
 
 // Constructor for the main class
-HawkesBasisKernels::HawkesBasisKernels(const double kernel_support,
-                                       const ulong kernel_size,
-                                       const ulong n_basis, const double alpha,
-                                       const int max_n_threads)
+template <class T>
+THawkesBasisKernels<T>::THawkesBasisKernels(const double kernel_support,
+                                            const ulong kernel_size,
+                                            const ulong n_basis,
+                                            const double alpha,
+                                            const int max_n_threads)
     : ModelHawkesList(max_n_threads, 0) {
   set_kernel_support(kernel_support);
   set_kernel_size(kernel_size);
@@ -164,33 +112,157 @@ HawkesBasisKernels::HawkesBasisKernels(const double kernel_support,
   set_alpha(alpha);
 }
 
-void HawkesBasisKernels::allocate_weights() {
+template <class T>
+void THawkesBasisKernels<T>::allocate_weights() {
   const ulong n_basis = get_n_basis();
   rud = ArrayDouble2d(n_nodes, n_basis);
-  Dudm = ArrayDouble2d(n_nodes, n_basis * kernel_size);
   Gdm = ArrayDouble2d(n_basis, kernel_size);
-  Dudm_temp = ArrayDouble2d(n_nodes, n_basis * kernel_size);
-  Cudm = ArrayDouble2d(n_nodes, n_basis * kernel_size);
   a_sum_vd = ArrayDouble2d(n_nodes, n_basis);
-  quvd_temp = ArrayDouble2d(n_nodes, n_nodes * n_basis);
   quvd = ArrayDouble2d(n_nodes, n_nodes * n_basis);
 
+  thread_Cdm = ArrayDouble2d(get_n_threads(), n_basis * kernel_size);
+  thread_Ddm = ArrayDouble2d(get_n_threads(), n_basis * kernel_size);
+  Cdm = ArrayDouble(n_basis * kernel_size);
+  Ddm = ArrayDouble(n_basis * kernel_size);
+
+  pairs_indptr = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  pairs_bins = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  pairs_counts = std::vector<std::vector<T> >(n_realizations * n_nodes);
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &THawkesBasisKernels<T>::compute_pairs_index_ur, this);
+
   weights_computed = true;
 }
 
+template <class T>
+void THawkesBasisKernels<T>::compute_pairs_index_ur(const ulong r_u) {
+  // Obtain realization and node index from r_u
+  const ulong r = static_cast<const ulong>(r_u / n_nodes);
+  const ulong node_u = r_u % n_nodes;
+
+  SArrayDoublePtrList1D &realization = timestamps_list[r];
+  ArrayDouble timestamps_u = view(*realization[node_u]);
+
+  std::vector<ulong> &indptr = pairs_indptr[r_u];
+  std::vector<ulong> &bins = pairs_bins[r_u];
+  std::vector<T> &counts = pairs_counts[r_u];
+  indptr.assign(1, 0);
+  bins.clear();
+  counts.clear();
+
+  // end_indices[v] is the number of events of node v that satisfy
+  // v[index] <= t_i
+  ArrayULong end_indices(n_nodes);
+  end_indices.init_to_zero();
+
+  for (ulong i = 0; i < timestamps_u.size(); i++) {
+    const double t_i = timestamps_u[i];
+
+    for (ulong node_v = 0; node_v < n_nodes; node_v++) {
+      ArrayDouble timestamps_v = view(*realization[node_v]);
+
+      while (end_indices[node_v] < timestamps_v.size() &&
+             timestamps_v[end_indices[node_v]] <= t_i)
+        end_indices[node_v]++;
+
+      const ulong pairs_v_start = bins.size();
+      for (ulong j = end_indices[node_v] - 1; j != static_cast<ulong>(-1);
+           j--) {
+        // This is the event itself, it is accounted for by the baseline
+        if (node_u == node_v && i == j) continue;
+
+        const ulong m = static_cast<ulong>(
+            std::floor((t_i - timestamps_v[j]) / get_kernel_dt()));
+        if (m >= kernel_size) break;
+
+        // m is non decreasing, events falling in the same bin are merged
+        const ulong bin = node_v * kernel_size + m;
+        if (bins.size() > pairs_v_start && bins.back() == bin) {
+          counts.back() += 1;
+        } else {
+          bins.push_back(bin);
+          counts.push_back(1);
+        }
+      }
+    }
+    indptr.push_back(bins.size());
+  }
+}
+
+// Procedure called by THawkesBasisKernels<T>::solve_u
+// Not commented, see LaTeX notes
+template <class T>
+double THawkesBasisKernels<T>::compute_mu_q_D_ur(const ulong r, const ulong u,
+                                                 const double mu_u,
+                                                 ArrayDouble2d &gdm,
+                                                 ArrayDouble2d &avd,
+                                                 ArrayDouble2d &qvd,
+                                                 ArrayDouble2d &Ddm) {
+  const ulong r_u = r * n_nodes + u;
+  const ulong D = gdm.n_rows();
+  const ulong M = gdm.n_cols();
+  const double kernel_dt = get_kernel_dt();
+
+  const std::vector<ulong> &indptr = pairs_indptr[r_u];
+  const ulong *bins = pairs_bins[r_u].data();
+  const T *counts = pairs_counts[r_u].data();
+
+  double mu_out = 0;
+  for (ulong i = 0; i + 1 < indptr.size(); i++) {
+    double norm = mu_u;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; p++) {
+      const ulong v = bins[p] / M, m = bins[p] % M;
+      for (ulong d = 0; d < D; d++) {
+        norm += avd[v * D + d] * gdm[d * M + m] * counts[p];
+      }
+    }
+
+    mu_out += mu_u / norm;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; p++) {
+      const ulong v = bins[p] / M, m = bins[p] % M;
+      for (ulong d = 0; d < D; d++) {
+        const double val = avd[v * D + d] * gdm[d * M + m] * counts[p];
+        Ddm[d * M + m] += val / (norm * kernel_dt);
+        qvd[v * D + d] += avd[v * D + d] * val / norm;
+      }
+    }
+  }
+
+  return mu_out;
+}
+
 // A method called in parallel by the method 'solve' (see below)
-void HawkesBasisKernels::solve_u(ulong u, ArrayDouble &mu, ArrayDouble2d &gdm,
-                                 ArrayDouble2d &auvd) {
+template <class T>
+void THawkesBasisKernels<T>::solve_thread(const ulong thread_index,
+                                          ArrayDouble &mu, ArrayDouble2d &gdm,
+                                          ArrayDouble2d &auvd) {
+  const ulong n_basis = get_n_basis();
+  ArrayDouble2d Cdm_thread(n_basis, kernel_size,
+                           view_row(thread_Cdm, thread_index).data());
+  ArrayDouble2d Ddm_thread(n_basis, kernel_size,
+                           view_row(thread_Ddm, thread_index).data());
+  Cdm_thread.init_to_zero();
+  Ddm_thread.init_to_zero();
+
+  ulong u_start, u_end;
+  std::tie(u_start, u_end) = tick::get_thread_indices(
+      thread_index, thread_Cdm.n_rows(), n_nodes);
+  for (ulong u = u_start; u < u_end; u++) {
+    solve_u(u, mu, gdm, auvd, Cdm_thread, Ddm_thread);
+  }
+}
+
+// Procedure called by THawkesBasisKernels<T>::solve_thread
+template <class T>
+void THawkesBasisKernels<T>::solve_u(ulong u, ArrayDouble &mu,
+                                     ArrayDouble2d &gdm, ArrayDouble2d &auvd,
+                                     ArrayDouble2d &Cdm, ArrayDouble2d &Ddm) {
   const ulong n_basis = get_n_basis();
 
   ArrayDouble rd = view_row(rud, u);
   double mu_out = 0;
-  ArrayDouble2d Cdm(n_basis, kernel_size, view_row(Cudm, u).data());
-  ArrayDouble2d Ddm(n_basis, kernel_size, view_row(Dudm, u).data());
-  ArrayDouble2d Ddm_temp(n_basis, kernel_size, view_row(Dudm_temp, u).data());
   ArrayDouble2d avd(n_nodes, n_basis, view_row(auvd, u).data());
   ArrayDouble2d qvd(n_nodes, n_basis, view_row(quvd, u).data());
-  ArrayDouble2d qvd_temp(n_nodes, n_basis, view_row(quvd_temp, u).data());
   ArrayDouble a_sum_v = view_row(a_sum_vd, u);
 
   for (ulong r = 0; r < n_realizations; r++) {
@@ -198,35 +270,60 @@ void HawkesBasisKernels::solve_u(ulong u, ArrayDouble &mu, ArrayDouble2d &gdm,
               Gdm, rd);
     compute_C(*timestamps_list[r][u], (*end_times)[r], get_kernel_dt(), gdm,
               a_sum_v, Cdm);
-    mu_out +=
-        compute_mu_q_D(u, timestamps_list[r], (*end_times)[r], get_kernel_dt(),
-                       gdm, avd, mu[u], qvd, qvd_temp, Ddm, Ddm_temp);
+    mu_out += compute_mu_q_D_ur(r, u, mu[u], gdm, avd, qvd, Ddm);
   }
 
   mu_out /= end_times->sum();
   mu[u] = mu_out;
 }
 
+// Procedure called by THawkesBasisKernels<T>::solve
+template <class T>
+void THawkesBasisKernels<T>::update_amplitudes_u(const ulong u,
+                                                 ArrayDouble2d &auvd) {
+  const ulong n_basis = get_n_basis();
+  for (ulong v = 0; v < n_nodes; v++) {
+    for (ulong d = 0; d < n_basis; d++) {
+      auvd[u * n_nodes * n_basis + v * n_basis + d] =
+          sqrt(quvd[u * n_nodes * n_basis + v * n_basis + d] /
+               (rud[v * n_basis + d] + 2 * alpha));
+    }
+  }
+}
+
+// Procedure called by THawkesBasisKernels<T>::solve
+template <class T>
+double THawkesBasisKernels<T>::update_gdm_d(const ulong d, ArrayDouble2d &gdm,
+                                            ulong max_iter_gdm,
+                                            double max_tol_gdm) {
+  ArrayDouble gm = view_row(gdm, d);
+  ArrayDouble Cm = view(Cdm, d * kernel_size, (d + 1) * kernel_size);
+  ArrayDouble Dm = view(Ddm, d * kernel_size, (d + 1) * kernel_size);
+  return compute_gdm(alpha, get_kernel_dt(), gm, Cm, Dm, max_tol_gdm,
+                     max_iter_gdm);
+}
+
 // The main method for performing one iteration
-double HawkesBasisKernels::solve(ArrayDouble &mu, ArrayDouble2d &gdm,
-                                 ArrayDouble2d &auvd, ulong max_iter_gdm,
-                                 double max_tol_gdm) {
+template <class T>
+double THawkesBasisKernels<T>::solve(ArrayDouble &mu, ArrayDouble2d &gdm,
+                                     ArrayDouble2d &auvd, ulong max_iter_gdm,
+                                     double max_tol_gdm) {
   if (!weights_computed) allocate_weights();
 
+  const ulong n_basis = get_n_basis();
+
   if (mu.size() != n_nodes) {
     TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
   }
   if (gdm.n_rows() != n_basis || gdm.n_cols() != kernel_size) {
     TICK_ERROR("basis functions / gdm argument must be an array of shape ("
-               << n_nodes << ", " << kernel_size << ")");
+               << n_basis << ", " << kernel_size << ")");
   }
   if (auvd.n_rows() != n_nodes || auvd.n_cols() != n_nodes * n_basis) {
     TICK_ERROR("amplitudes / auvd argument must be an array of shape ("
                << n_nodes << ", " << n_nodes * n_basis << ")");
   }
 
-  const ulong n_basis = get_n_basis();
-
   for (ulong d = 0; d < n_basis; d++) {
     Gdm[d * kernel_size] = gdm[d * kernel_size] * get_kernel_dt();
     for (ulong m = 1; m < kernel_size; m++)
@@ -246,56 +343,93 @@ double HawkesBasisKernels::solve(ArrayDouble &mu, ArrayDouble2d &gdm,
 
   rud.init_to_zero();
   quvd.init_to_zero();
-  Dudm.init_to_zero();
-  Cudm.init_to_zero();
 
-  // Parallel loop on u to run compute_r, compute_C, Scompute_mu_q_D
-  parallel_run(get_n_threads(), n_nodes, &HawkesBasisKernels::solve_u, this, mu,
-               gdm, auvd);
-
-  // Then we reduce the computations of Cudm and Dudm
-  // We store in component u=0 the sum_u=0^n_nodes Cudm (same for Dudm)
-  for (ulong u = 1; u < n_nodes; u++) {
-    for (ulong d = 0; d < n_basis; d++) {
-      for (ulong m = 0; m < kernel_size; m++) {
-        Cudm[d * kernel_size + m] +=
-            Cudm[u * n_basis * kernel_size + d * kernel_size + m];
-        Dudm[d * kernel_size + m] +=
-            Dudm[u * n_basis * kernel_size + d * kernel_size + m];
-      }
-    }
+  // Parallel loop on u to run compute_r, compute_C, compute_mu_q_D_ur, each
+  // thread handles a fixed range of nodes
+  const unsigned int n_threads = thread_Cdm.n_rows();
+  parallel_run(n_threads, n_threads, &THawkesBasisKernels<T>::solve_thread,
+               this, mu, gdm, auvd);
+
+  // Then we reduce the computations of Cdm and Ddm, always in the same order
+  Cdm.init_to_zero();
+  Ddm.init_to_zero();
+  for (ulong thread_index = 0; thread_index < n_threads; thread_index++) {
+    Cdm.mult_incr(view_row(thread_Cdm, thread_index), 1.);
+    Ddm.mult_incr(view_row(thread_Ddm, thread_index), 1.);
   }
 
-  for (ulong u = 0; u < n_nodes; u++) {
-    for (ulong v = 0; v < n_nodes; v++) {
-      for (ulong d = 0; d < n_basis; d++) {
-        auvd[u * n_nodes * n_basis + v * n_basis + d] =
-            sqrt(quvd[u * n_nodes * n_basis + v * n_basis + d] /
-                 (rud[v * n_basis + d] + 2 * alpha));
-      }
-    }
-  }
+  parallel_run(get_n_threads(), n_nodes,
+               &THawkesBasisKernels<T>::update_amplitudes_u, this, auvd);
+
+  SArrayDoublePtr rerrs_gdm = parallel_map(
+      std::min(get_n_threads(), static_cast<unsigned int>(n_basis)), n_basis,
+      &THawkesBasisKernels<T>::update_gdm_d, this, gdm, max_iter_gdm,
+      max_tol_gdm);
 
   double rerr_gdm = 0;
   for (ulong d = 0; d < n_basis; d++) {
-    ArrayDouble gm = view_row(gdm, d);
-    ArrayDouble2d Cdm(n_basis, kernel_size, view_row(Cudm, 0).data());
-    ArrayDouble2d Ddm(n_basis, kernel_size, view_row(Dudm, 0).data());
-    ArrayDouble Cm = view_row(Cdm, d);
-    ArrayDouble Dm = view_row(Ddm, d);
-    double rerr = compute_gdm(alpha, get_kernel_dt(), gm, Cm, Dm, max_tol_gdm,
-                              max_iter_gdm);
-    rerr_gdm = std::max(rerr, rerr_gdm);
+    rerr_gdm = std::max((*rerrs_gdm)[d], rerr_gdm);
   }
-
   return rerr_gdm;
 }
 
-unsigned int HawkesBasisKernels::get_n_threads() const {
+template <class T>
+ulong THawkesBasisKernels<T>::fit(ArrayDouble &mu, ArrayDouble2d &gdm,
+                                  ArrayDouble2d &auvd, const ulong max_iter,
+                                  const double tol, const ulong max_iter_gdm,
+                                  const double max_tol_gdm,
+                                  const ulong record_every) {
+  fit_history.clear();
+  ArrayDouble previous_mu(mu.size());
+  ArrayDouble previous_gdm(gdm.size());
+  ArrayDouble previous_auvd(auvd.size());
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const bool is_last_iter = iter + 1 == max_iter;
+    const bool record =
+        is_last_iter || (record_every > 0 && iter % record_every == 0);
+    if (record) {
+      previous_mu.mult_fill(mu, 1.);
+      std::copy(gdm.data(), gdm.data() + gdm.size(), previous_gdm.data());
+      std::copy(auvd.data(), auvd.data() + auvd.size(), previous_auvd.data());
+    }
+
+    const double rel_ode = solve(mu, gdm, auvd, max_iter_gdm, max_tol_gdm);
+
+    if (record) {
+      const double rel_baseline =
+          relative_distance(mu.data(), previous_mu.data(), mu.size());
+      const double rel_amplitudes = relative_distance(
+          auvd.data(), previous_auvd.data(), auvd.size());
+      const double rel_basis_kernels =
+          relative_distance(gdm.data(), previous_gdm.data(), gdm.size());
+      fit_history.insert(fit_history.end(),
+                         {static_cast<double>(iter + 1), rel_baseline,
+                          rel_amplitudes, rel_basis_kernels, rel_ode});
+
+      if (std::max({rel_baseline, rel_amplitudes, rel_basis_kernels}) <=
+          tol) {
+        return iter + 1;
+      }
+    }
+  }
+  return max_iter;
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesBasisKernels<T>::get_fit_history() const {
+  ArrayDouble2d history_array(fit_history.size() / n_fit_history_columns,
+                              n_fit_history_columns);
+  std::copy(fit_history.begin(), fit_history.end(), history_array.data());
+  return history_array.as_sarray2d_ptr();
+}
+
+template <class T>
+unsigned int THawkesBasisKernels<T>::get_n_threads() const {
   return std::min(this->max_n_threads, static_cast<unsigned int>(n_nodes));
 }
 
-void HawkesBasisKernels::set_kernel_support(const double kernel_support) {
+template <class T>
+void THawkesBasisKernels<T>::set_kernel_support(const double kernel_support) {
   if (kernel_support <= 0) {
     TICK_ERROR("Kernel support must be positive and you have provided "
                << kernel_support)
@@ -303,7 +437,8 @@ void HawkesBasisKernels::set_kernel_support(const double kernel_support) {
   this->kernel_support = kernel_support;
 }
 
-void HawkesBasisKernels::set_kernel_size(const ulong kernel_size) {
+template <class T>
+void THawkesBasisKernels<T>::set_kernel_size(const ulong kernel_size) {
   if (kernel_size <= 0) {
     TICK_ERROR("Kernel size must be positive and you have provided "
                << kernel_size)
@@ -312,7 +447,8 @@ void HawkesBasisKernels::set_kernel_size(const ulong kernel_size) {
   weights_computed = false;
 }
 
-void HawkesBasisKernels::set_kernel_dt(const double kernel_dt) {
+template <class T>
+void THawkesBasisKernels<T>::set_kernel_dt(const double kernel_dt) {
   if (kernel_dt <= 0) {
     TICK_ERROR(
         "Kernel discretization parameter must be positive and you have "
@@ -328,14 +464,19 @@ void HawkesBasisKernels::set_kernel_dt(const double kernel_dt) {
   set_kernel_size(static_cast<ulong>(std::ceil(kernel_support / kernel_dt)));
 }
 
-void HawkesBasisKernels::set_n_basis(const ulong n_basis) {
+template <class T>
+void THawkesBasisKernels<T>::set_n_basis(const ulong n_basis) {
   this->n_basis = n_basis;
   weights_computed = false;
 }
 
-void HawkesBasisKernels::set_alpha(const double alpha) {
+template <class T>
+void THawkesBasisKernels<T>::set_alpha(const double alpha) {
   if (alpha <= 0) {
     TICK_ERROR("alpha must be positive and you have provided " << alpha)
   }
   this->alpha = alpha;
 }
+
+template class DLL_PUBLIC THawkesBasisKernels<double>;
+template class DLL_PUBLIC THawkesBasisKernels<float>;
@@ -7,7 +7,13 @@
 #define Py_END_ALLOW_THREADS
 #endif
 
-#include "tick/array/array.h"
+#include "tick/hawkes/inference/hawkes_conditional_law.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <tuple>
+#include <vector>
 
 // The non parametric estimation is based on the following quantities :
 //
@@ -140,6 +146,279 @@ void PointProcessCondLaw(ArrayDouble &y_time, ArrayDouble &z_time,
   Py_END_ALLOW_THREADS
 }
 
+namespace {
+
+// Computes the signals of PointProcessCondLaw for a batch of triplets. The
+// eligible jumps of Z are first collected once per Z node and mark interval,
+// as they are shared by all the triplets that only differ by their Y node.
+// They are then split in chunks whose partial sums are computed in parallel
+// and reduced afterwards.
+class PointProcessCondLawBatchTasks {
+  const SArrayDoublePtrList1D &timestamps;
+  const SArrayDoublePtrList1D &marks;
+  const ArrayDouble &lags;
+  const ArrayULong &y_nodes, &z_nodes;
+  const ArrayDouble &zmins, &zmaxs;
+  const double y_T;
+
+  //! @brief Z node and mark interval of each group of triplets
+  std::vector<std::tuple<ulong, double, double> > groups;
+
+  //! @brief Group of each triplet
+  std::vector<ulong> triplet_groups;
+
+  //! @brief Times of the eligible jumps of Z of each group
+  std::vector<std::vector<double> > eligible_z_times;
+
+  //! @brief Number of eligible jumps of Z used by each triplet, the jumps
+  //! after the last jump of Y are dropped
+  std::vector<ulong> n_eligible;
+
+  //! @brief Number of terms involved in the computation of each triplet
+  std::vector<ulong> n_terms;
+
+ public:
+  //! @brief Triplet and range of eligible jumps handled by each chunk
+  std::vector<std::array<ulong, 3> > chunks;
+
+  //! @brief Partial sums of each chunk, of shape (n_chunks, N)
+  ArrayDouble2d chunks_sums;
+
+  PointProcessCondLawBatchTasks(const SArrayDoublePtrList1D &timestamps,
+                                const SArrayDoublePtrList1D &marks,
+                                const ArrayDouble &lags,
+                                const ArrayULong &y_nodes,
+                                const ArrayULong &z_nodes,
+                                const ArrayDouble &zmins,
+                                const ArrayDouble &zmaxs, const double y_T)
+      : timestamps(timestamps),
+        marks(marks),
+        lags(lags),
+        y_nodes(y_nodes),
+        z_nodes(z_nodes),
+        zmins(zmins),
+        zmaxs(zmaxs),
+        y_T(y_T),
+        triplet_groups(y_nodes.size()),
+        n_eligible(y_nodes.size()),
+        n_terms(y_nodes.size()) {
+    std::map<std::tuple<ulong, double, double>, ulong> group_indices;
+    for (ulong triplet = 0; triplet < y_nodes.size(); triplet++) {
+      const auto group = std::make_tuple(z_nodes[triplet], zmins[triplet],
+                                         zmaxs[triplet]);
+      auto inserted = group_indices.emplace(group, groups.size());
+      if (inserted.second) groups.push_back(group);
+      triplet_groups[triplet] = inserted.first->second;
+    }
+    eligible_z_times.resize(groups.size());
+  }
+
+  ulong get_n_groups() const { return groups.size(); }
+
+  ulong get_n_terms(const ulong triplet) const { return n_terms[triplet]; }
+
+  // Same eligibility and stopping rules as PointProcessCondLaw, except for
+  // the last jump of Y which is handled by count_eligible_z_times
+  void collect_eligible_z_times(const ulong group) {
+    const ulong z_node = std::get<0>(groups[group]);
+    const ArrayDouble &z_time = *timestamps[z_node];
+    const ArrayDouble &z_mark = *marks[z_node];
+    const double zmin = std::get<1>(groups[group]);
+    const double zmax = std::get<2>(groups[group]);
+    const double lag_max = lags[lags.size() - 1];
+
+    std::vector<double> &eligible_z_times_g = eligible_z_times[group];
+    eligible_z_times_g.clear();
+    for (ulong z_index = 0; z_index < z_mark.size(); z_index++) {
+      if (zmin < zmax && z_index > 0 &&
+          (zmin > z_mark[z_index] - z_mark[z_index - 1] ||
+           z_mark[z_index] - z_mark[z_index - 1] > zmax))
+        continue;
+
+      const double z_t = z_time[z_index];
+      if (z_t + lag_max >= y_T) break;
+      eligible_z_times_g.push_back(z_t);
+    }
+  }
+
+  // PointProcessCondLaw stops at the first eligible jump of Z after the last
+  // jump of Y, still counting it as a term
+  void count_eligible_z_times() {
+    for (ulong triplet = 0; triplet < y_nodes.size(); triplet++) {
+      const ArrayDouble &y_time = *timestamps[y_nodes[triplet]];
+      const std::vector<double> &z_times =
+          eligible_z_times[triplet_groups[triplet]];
+      ulong n_eligible_t = 0;
+      if (y_time.size() > 0) {
+        n_eligible_t = std::upper_bound(z_times.begin(), z_times.end(),
+                                        y_time[y_time.size() - 1]) -
+                       z_times.begin();
+      }
+      n_eligible[triplet] = n_eligible_t;
+      n_terms[triplet] =
+          n_eligible_t + (n_eligible_t < z_times.size() ? 1 : 0);
+    }
+  }
+
+  void schedule_chunks(const ulong min_n_chunks) {
+    const ulong n_triplets = y_nodes.size();
+    const ulong n_chunks_per_triplet =
+        std::max<ulong>(1, (min_n_chunks + n_triplets - 1) / n_triplets);
+    chunks.clear();
+    for (ulong triplet = 0; triplet < n_triplets; triplet++) {
+      const ulong n_eligible_t = n_eligible[triplet];
+      const ulong n_chunks = std::min(n_chunks_per_triplet, n_eligible_t);
+      for (ulong c = 0; c < n_chunks; c++) {
+        chunks.push_back({triplet, (c * n_eligible_t) / n_chunks,
+                          ((c + 1) * n_eligible_t) / n_chunks});
+      }
+    }
+    chunks_sums = ArrayDouble2d(chunks.size(), lags.size() - 1);
+    chunks_sums.init_to_zero();
+  }
+
+  // Every lag bound is followed by a monotone cursor on Y, shared by the
+  // consecutive lags k - 1 and k
+  void compute_chunk(const ulong chunk) {
+    const ulong triplet = chunks[chunk][0];
+    const std::vector<double> &z_times =
+        eligible_z_times[triplet_groups[triplet]];
+    const ArrayDouble &y_time = *timestamps[y_nodes[triplet]];
+    const ulong n_y = y_time.size();
+    const ulong N = lags.size() - 1;
+    ArrayDouble sums = view_row(chunks_sums, chunk);
+
+    const double *y_begin = y_time.data(), *y_end = y_time.data() + n_y;
+    const double first_z_t = z_times[chunks[chunk][1]];
+    // After advancing, y_time[y_index] >= z_t and y_time[cursors[k]] is the
+    // first time greater than z_t + lags[k]
+    ulong y_index = std::lower_bound(y_begin, y_end, first_z_t) - y_begin;
+    std::vector<ulong> cursors(N + 1);
+    for (ulong k = 0; k <= N; k++) {
+      cursors[k] =
+          std::upper_bound(y_begin, y_end, first_z_t + lags[k]) - y_begin;
+    }
+
+    for (ulong z = chunks[chunk][1]; z < chunks[chunk][2]; z++) {
+      const double z_t = z_times[z];
+      while (y_index < n_y && y_time[y_index] < z_t) y_index++;
+      for (ulong k = 0; k <= N; k++) {
+        ulong &cursor = cursors[k];
+        while (cursor < n_y && y_time[cursor] <= z_t + lags[k]) cursor++;
+      }
+
+      // Away from the first and last jumps of Y, the signal is the number of
+      // jumps of Y between the two lags
+      if (cursors[0] > 0 && cursors[0] >= y_index && cursors[N] < n_y) {
+        for (ulong k = 0; k < N; k++) {
+          sums[k] += cursors[k + 1] - cursors[k];
+        }
+        continue;
+      }
+
+      ulong y_index_lag = std::max(cursors[0], y_index);
+      for (ulong k = 0; k < N; k++) {
+        const ulong y_index_lag_delta = std::max(cursors[k + 1], y_index_lag);
+        // The boundary conventions of PointProcessCondLaw are kept when Y
+        // has no jump after z_t + lags[k + 1]
+        if (y_index_lag < n_y) {
+          const ulong ytlag = (y_index_lag == 0 ? 0 : y_index_lag - 1);
+          if (y_index_lag_delta < n_y) {
+            sums[k] +=
+                (y_index_lag_delta == 0 ? 0 : y_index_lag_delta - 1) - ytlag;
+          } else if (y_index_lag != n_y - 1) {
+            sums[k] += (n_y == 1 ? 0 : n_y - 2) - ytlag;
+          }
+        }
+        y_index_lag = y_index_lag_delta;
+      }
+    }
+  }
+};
+
+}  // namespace
+
+void PointProcessCondLawBatch(const SArrayDoublePtrList1D &timestamps,
+                              const SArrayDoublePtrList1D &marks,
+                              ArrayDouble &lags, ArrayULong &y_nodes,
+                              ArrayULong &z_nodes, ArrayDouble &zmins,
+                              ArrayDouble &zmaxs, double y_T,
+                              ArrayDouble &res_X, ArrayDouble2d &res_Y,
+                              int max_n_threads) {
+  const ulong n_triplets = y_nodes.size();
+  if (timestamps.size() != marks.size()) {
+    TICK_ERROR("timestamps (size=" << timestamps.size()
+                                   << ") and marks (size=" << marks.size()
+                                   << ") should have the same size");
+  }
+  for (ulong node = 0; node < timestamps.size(); node++) {
+    if (timestamps[node]->size() != marks[node]->size()) {
+      TICK_ERROR("timestamps and marks of node "
+                 << node << " should have the same size");
+    }
+  }
+  if (z_nodes.size() != n_triplets || zmins.size() != n_triplets ||
+      zmaxs.size() != n_triplets) {
+    TICK_ERROR("y_nodes, z_nodes, zmins and zmaxs should have the same size");
+  }
+  for (ulong triplet = 0; triplet < n_triplets; triplet++) {
+    if (y_nodes[triplet] >= timestamps.size() ||
+        z_nodes[triplet] >= timestamps.size()) {
+      TICK_ERROR("triplet " << triplet << " refers to a node larger than "
+                            << timestamps.size());
+    }
+  }
+  if (lags.size() < 2 || res_X.size() + 1 != lags.size()) {
+    TICK_ERROR("lags (size=" << lags.size()
+                             << ") should be of the size of res_X (size="
+                             << res_X.size() << " plus one");
+  }
+  if (res_Y.n_rows() != n_triplets || res_Y.n_cols() != res_X.size()) {
+    TICK_ERROR("res_Y should be an array of shape (" << n_triplets << ", "
+                                                     << res_X.size() << ")");
+  }
+
+  const ulong N = lags.size() - 1;
+  const unsigned int n_threads =
+      static_cast<unsigned int>(std::max(max_n_threads, 1));
+
+  Py_BEGIN_ALLOW_THREADS
+
+      PointProcessCondLawBatchTasks tasks(timestamps, marks, lags, y_nodes,
+                                          z_nodes, zmins, zmaxs, y_T);
+  parallel_run(n_threads, tasks.get_n_groups(),
+               &PointProcessCondLawBatchTasks::collect_eligible_z_times,
+               &tasks);
+  tasks.count_eligible_z_times();
+  tasks.schedule_chunks(4 * n_threads);
+  parallel_run(n_threads, tasks.chunks.size(),
+               &PointProcessCondLawBatchTasks::compute_chunk, &tasks);
+
+  res_Y.init_to_zero();
+  for (ulong chunk = 0; chunk < tasks.chunks.size(); chunk++) {
+    ArrayDouble res_Y_triplet = view_row(res_Y, tasks.chunks[chunk][0]);
+    res_Y_triplet.mult_incr(view_row(tasks.chunks_sums, chunk), 1.);
+  }
+
+  for (ulong triplet = 0; triplet < n_triplets; triplet++) {
+    ArrayDouble res_Y_triplet = view_row(res_Y, triplet);
+    const ulong n_terms = tasks.get_n_terms(triplet);
+    const double y_lambda = timestamps[y_nodes[triplet]]->size() / y_T;
+    for (ulong k = 0; k < N; k++) {
+      if (n_terms != 0) {
+        res_Y_triplet[k] /= n_terms;
+      }
+      res_Y_triplet[k] /= (lags[k + 1] - lags[k]);
+      res_Y_triplet[k] -= y_lambda;
+    }
+  }
+  for (ulong k = 0; k < N; k++) {
+    res_X[k] = (lags[k + 1] + lags[k]) / 2.0;
+  }
+
+  Py_END_ALLOW_THREADS
+}
+
 //
 // Given two point processes Y and Z, computes the Signal
 //
@@ -1,10 +1,15 @@
 #include "tick/hawkes/inference/hawkes_cumulant.h"
 
-HawkesCumulant::HawkesCumulant(double integration_support)
-    : integration_support(integration_support), are_cumulants_ready(false) {}
+template <class T>
+THawkesCumulant<T>::THawkesCumulant(double integration_support,
+                                    const int max_n_threads)
+    : ModelHawkesList(max_n_threads, 0),
+      integration_support(integration_support),
+      are_cumulants_ready(false) {}
 
-SArrayDoublePtr HawkesCumulant::compute_A_and_I_ij(ulong r, ulong i, ulong j,
-                                                   double mean_intensity_j) {
+template <class T>
+SArrayDoublePtr THawkesCumulant<T>::compute_A_and_I_ij(
+    ulong r, ulong i, ulong j, double mean_intensity_j) {
   auto timestamps_i = timestamps_list[r][i];
   auto timestamps_j = timestamps_list[r][j];
 
@@ -64,9 +69,10 @@ SArrayDoublePtr HawkesCumulant::compute_A_and_I_ij(ulong r, ulong i, ulong j,
   return return_array.as_sarray_ptr();
 }
 
-double HawkesCumulant::compute_E_ijk(ulong r, ulong i, ulong j, ulong k,
-                                     double mean_intensity_i,
-                                     double mean_intensity_j, double J_ij) {
+template <class T>
+double THawkesCumulant<T>::compute_E_ijk(ulong r, ulong i, ulong j, ulong k,
+                                         double mean_intensity_i,
+                                         double mean_intensity_j, double J_ij) {
   auto timestamps_i = timestamps_list[r][i];
   auto timestamps_j = timestamps_list[r][j];
   auto timestamps_k = timestamps_list[r][k];
@@ -126,3 +132,233 @@ double HawkesCumulant::compute_E_ijk(ulong r, ulong i, ulong j, ulong k,
   res /= (*end_times)[r];
   return res;
 }
+
+template <class T>
+void THawkesCumulant<T>::compute_cumulants() {
+  if (n_realizations == 0) {
+    TICK_ERROR(
+        "Cannot compute cumulants if no realization has been provided");
+  }
+
+  mean_intensity_per_realization = ArrayDouble2d(n_realizations, n_nodes);
+  for (ulong r = 0; r < n_realizations; ++r) {
+    for (ulong i = 0; i < n_nodes; ++i) {
+      mean_intensity_per_realization(r, i) =
+          timestamps_list[r][i]->size() / (*end_times)[r];
+    }
+  }
+
+  covariance_per_realization = Array2d<T>(n_realizations * n_nodes, n_nodes);
+  J_per_realization = Array2d<T>(n_realizations * n_nodes, n_nodes);
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &THawkesCumulant<T>::compute_A_and_I_ri, this);
+
+  // We keep the symmetric part to remove edge effects
+  mean_intensity = ArrayDouble(n_nodes);
+  mean_intensity.init_to_zero();
+  covariance = ArrayDouble2d(n_nodes, n_nodes);
+  covariance.init_to_zero();
+  for (ulong r = 0; r < n_realizations; ++r) {
+    Array2d<T> C_r(n_nodes, n_nodes,
+                   view_row(covariance_per_realization, r * n_nodes).data());
+    Array2d<T> J_r(n_nodes, n_nodes,
+                   view_row(J_per_realization, r * n_nodes).data());
+    for (ulong i = 0; i < n_nodes; ++i) {
+      mean_intensity[i] += mean_intensity_per_realization(r, i);
+      for (ulong j = 0; j < i; ++j) {
+        const double C_r_ij = 0.5 * (C_r(i, j) + C_r(j, i));
+        C_r(i, j) = C_r_ij;
+        C_r(j, i) = C_r_ij;
+        const double J_r_ij = 0.5 * (J_r(i, j) + J_r(j, i));
+        J_r(i, j) = J_r_ij;
+        J_r(j, i) = J_r_ij;
+      }
+    }
+    for (ulong ij = 0; ij < n_nodes * n_nodes; ++ij) {
+      covariance[ij] += C_r[ij] * (1. / n_realizations);
+    }
+  }
+  mean_intensity /= n_realizations;
+
+  E_ikk_per_realization = Array2d<T>(n_realizations * n_nodes, n_nodes);
+  E_jjk_per_realization = Array2d<T>(n_realizations * n_nodes, n_nodes);
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &THawkesCumulant<T>::compute_E_rk, this);
+
+  // K_c_ij = (2 E_ijj + E_jji) / 3, averaged over realizations
+  ArrayDouble2d E_ijj(n_nodes, n_nodes), E_jji(n_nodes, n_nodes);
+  E_ijj.init_to_zero();
+  E_jji.init_to_zero();
+  for (ulong r = 0; r < n_realizations; ++r) {
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong j = 0; j < n_nodes; ++j) {
+        E_ijj(i, j) += E_ikk_per_realization(r * n_nodes + j, i);
+        E_jji(i, j) += E_jjk_per_realization(r * n_nodes + i, j);
+      }
+    }
+  }
+  E_ijj /= n_realizations;
+  E_jji /= n_realizations;
+
+  skewness = ArrayDouble2d(n_nodes, n_nodes);
+  skewness.init_to_zero();
+  skewness.mult_incr(E_ijj, 2.);
+  skewness.mult_incr(E_jji, 1.);
+  skewness /= 3.;
+
+  are_cumulants_ready = true;
+}
+
+template <class T>
+void THawkesCumulant<T>::compute_A_and_I_ri(const ulong r_i) {
+  const ulong r = r_i / n_nodes;
+  const ulong i = r_i % n_nodes;
+
+  const ArrayDouble timestamps_i = view(*timestamps_list[r][i]);
+  const ulong n_i = timestamps_i.size();
+  const double width = 2 * integration_support;
+
+  // C_ij and J_ij are accumulated in double and only stored in T
+  ArrayDouble res_C(n_nodes), res_J(n_nodes);
+  res_C.init_to_zero();
+  res_J.init_to_zero();
+
+  // Sliding windows over all nodes are shared by all events of node i
+  ArrayULong last_l(n_nodes);
+  last_l.init_to_zero();
+
+  for (ulong k = 0; k < n_i; ++k) {
+    const double t_i_k = timestamps_i[k];
+    if (t_i_k - integration_support < 0) continue;
+
+    for (ulong j = 0; j < n_nodes; ++j) {
+      const ArrayDouble timestamps_j = view(*timestamps_list[r][j]);
+      const ulong n_j = timestamps_j.size();
+
+      // Find next t_j_l that occurs width before t_i_k
+      while (last_l[j] < n_j && timestamps_j[last_l[j]] <= t_i_k - width) {
+        ++last_l[j];
+      }
+
+      ulong l = last_l[j];
+      ulong timestamps_in_interval = 0;
+      double sub_res = 0.;
+      while (l < n_j) {
+        const double abs_t_j_l_minus_t_i_k = fabs(timestamps_j[l] - t_i_k);
+        if (abs_t_j_l_minus_t_i_k >= width) break;
+
+        sub_res += width - abs_t_j_l_minus_t_i_k;
+        if (abs_t_j_l_minus_t_i_k < integration_support)
+          timestamps_in_interval++;
+        l += 1;
+      }
+
+      if (l == n_j) continue;
+      const double mean_intensity_j = mean_intensity_per_realization(r, j);
+      res_C[j] += timestamps_in_interval - mean_intensity_j * width;
+      res_J[j] += sub_res - mean_intensity_j * width * width;
+    }
+  }
+
+  res_C /= (*end_times)[r];
+  res_J /= (*end_times)[r];
+  Array<T> C_ri = view_row(covariance_per_realization, r_i);
+  Array<T> J_ri = view_row(J_per_realization, r_i);
+  for (ulong j = 0; j < n_nodes; ++j) {
+    C_ri[j] = res_C[j];
+    J_ri[j] = res_J[j];
+  }
+}
+
+template <class T>
+void THawkesCumulant<T>::compute_E_rk(const ulong r_k) {
+  const ulong r = r_k / n_nodes;
+  const ulong k = r_k % n_nodes;
+
+  const ArrayDouble timestamps_k = view(*timestamps_list[r][k]);
+  const Array2d<T> J_r(n_nodes, n_nodes,
+                       view_row(J_per_realization, r * n_nodes).data());
+
+  ArrayDouble E_ikk(n_nodes), E_jjk(n_nodes);
+  E_ikk.init_to_zero();
+  E_jjk.init_to_zero();
+
+  // Number of events of each node in the window around tau, shared by all
+  // (i, j) pairs. It is not used if the window reaches the end of the node
+  ArrayULong window_start(n_nodes), window_end(n_nodes);
+  window_start.init_to_zero();
+  window_end.init_to_zero();
+  ArrayDouble centered_counts(n_nodes);
+  std::vector<bool> is_valid(n_nodes);
+
+  for (ulong t = 0; t < timestamps_k.size(); ++t) {
+    const double tau = timestamps_k[t];
+    if (tau - integration_support < 0) continue;
+
+    for (ulong a = 0; a < n_nodes; ++a) {
+      const ArrayDouble timestamps_a = view(*timestamps_list[r][a]);
+      const ulong n_a = timestamps_a.size();
+
+      ulong &start = window_start[a];
+      while (start < n_a && timestamps_a[start] <= tau - integration_support)
+        start += 1;
+      ulong &end = window_end[a];
+      end = std::max(end, start);
+      while (end < n_a && timestamps_a[end] < tau + integration_support)
+        end += 1;
+
+      is_valid[a] = end < n_a;
+      centered_counts[a] =
+          (end - start) -
+          mean_intensity_per_realization(r, a) * 2 * integration_support;
+    }
+
+    for (ulong a = 0; a < n_nodes; ++a) {
+      if (!is_valid[a]) continue;
+      if (is_valid[k]) {
+        E_ikk[a] += centered_counts[a] * centered_counts[k] - J_r(a, k);
+      }
+      E_jjk[a] += centered_counts[a] * centered_counts[a] - J_r(a, a);
+    }
+  }
+
+  E_ikk /= (*end_times)[r];
+  E_jjk /= (*end_times)[r];
+  Array<T> E_ikk_rk = view_row(E_ikk_per_realization, r_k);
+  Array<T> E_jjk_rk = view_row(E_jjk_per_realization, r_k);
+  for (ulong a = 0; a < n_nodes; ++a) {
+    E_ikk_rk[a] = E_ikk[a];
+    E_jjk_rk[a] = E_jjk[a];
+  }
+}
+
+template <class T>
+void THawkesCumulant<T>::check_cumulants_computed() const {
+  if (!are_cumulants_ready) {
+    TICK_ERROR("Cumulants must be computed with compute_cumulants first");
+  }
+}
+
+template <class T>
+SArrayDoublePtr THawkesCumulant<T>::get_mean_intensity() const {
+  check_cumulants_computed();
+  ArrayDouble copied_mean_intensity = mean_intensity;
+  return copied_mean_intensity.as_sarray_ptr();
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesCumulant<T>::get_covariance() const {
+  check_cumulants_computed();
+  ArrayDouble2d copied_covariance = covariance;
+  return copied_covariance.as_sarray2d_ptr();
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesCumulant<T>::get_skewness() const {
+  check_cumulants_computed();
+  ArrayDouble2d copied_skewness = skewness;
+  return copied_skewness.as_sarray2d_ptr();
+}
+
+template class DLL_PUBLIC THawkesCumulant<double>;
+template class DLL_PUBLIC THawkesCumulant<float>;
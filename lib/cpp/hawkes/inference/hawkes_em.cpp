@@ -2,46 +2,133 @@
 
 #include "tick/hawkes/inference/hawkes_em.h"
 
-HawkesEM::HawkesEM(const double kernel_support, const ulong kernel_size,
-                   const int max_n_threads)
-    : ModelHawkesList(max_n_threads, 0), kernel_discretization(nullptr) {
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "tick/base/math/fft.h"
+
+namespace {
+// Values recorded for each checked iteration of fit: iteration number,
+// relative changes of baseline and kernels and log-likelihood
+const ulong n_fit_history_columns = 4;
+
+//! @brief Norm of new_values - old_values relatively to the norm of
+//! old_values, as tick.solver.base.utils.relative_distance does
+double relative_distance(const double *new_values, const double *old_values,
+                         const ulong size) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < size; ++j) {
+    const double diff = new_values[j] - old_values[j];
+    norm_diff += diff * diff;
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+//! @brief Whether value is neither infinite nor NaN. Its exponent bits are
+//! read as std::isfinite is optimized away with -ffast-math
+bool is_finite(const double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return ((bits >> 52) & 0x7FF) != 0x7FF;
+}
+}  // namespace
+
+template <class T>
+THawkesEM<T>::THawkesEM(const double kernel_support, const ulong kernel_size,
+                        const int max_n_threads)
+    : ModelHawkesList(max_n_threads, 0),
+      kernel_discretization(nullptr),
+      fft_binning(0) {
   set_kernel_support(kernel_support);
   set_kernel_size(kernel_size);
 }
 
-HawkesEM::HawkesEM(const SArrayDoublePtr kernel_discretization,
-                   const int max_n_threads)
-    : ModelHawkesList(max_n_threads, 0) {
+template <class T>
+THawkesEM<T>::THawkesEM(const SArrayDoublePtr kernel_discretization,
+                        const int max_n_threads)
+    : ModelHawkesList(max_n_threads, 0), fft_binning(0) {
   set_kernel_discretization(kernel_discretization);
 }
 
-void HawkesEM::allocate_weights() {
+template <class T>
+void THawkesEM<T>::allocate_weights() {
   next_mu = ArrayDouble2d(n_realizations, n_nodes);
   next_kernels = ArrayDouble2d(n_realizations * n_nodes, n_nodes * kernel_size);
-  unnormalized_kernels =
-      ArrayDouble2d(n_realizations * n_nodes, n_nodes * kernel_size);
+
+  if (fft_binning > 0) {
+    pairs_indptr.clear();
+    pairs_bins.clear();
+    pairs_counts.clear();
+
+    binned_counts = std::vector<std::vector<T> >(n_realizations * n_nodes);
+    binned_counts_fft = std::vector<std::vector<std::complex<double> > >(
+        n_realizations * n_nodes);
+    parallel_run(get_n_threads(), n_nodes * n_realizations,
+                 &THawkesEM<T>::compute_binned_counts_rv, this);
+  } else {
+    binned_counts.clear();
+    binned_counts_fft.clear();
+
+    pairs_indptr = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+    pairs_bins = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+    pairs_counts =
+        std::vector<std::vector<T> >(n_realizations * n_nodes);
+    parallel_run(get_n_threads(), n_nodes * n_realizations,
+                 &THawkesEM<T>::compute_pairs_index_ur, this);
+  }
   weights_computed = true;
 }
 
-double HawkesEM::loglikelihood(const ArrayDouble &mu, ArrayDouble2d &kernels) {
+template <class T>
+double THawkesEM<T>::loglikelihood(const ArrayDouble &mu,
+                                   ArrayDouble2d &kernels) {
+  if (!weights_computed) allocate_weights();
+  return loglikelihood(mu, kernels, get_n_threads());
+}
+
+template <class T>
+double THawkesEM<T>::loglikelihood(const ArrayDouble &mu,
+                                   ArrayDouble2d &kernels,
+                                   const unsigned int n_threads) {
   check_baseline_and_kernels(mu, kernels);
 
+  // Shared by all (realization, node) tasks
+  const ArrayDouble2d kernel_norms = *get_kernel_norms(kernels);
+  const ArrayDouble kernel_discretization = *get_kernel_discretization();
+
   double llh = parallel_map_additive_reduce(
-      get_n_threads(), n_nodes * n_realizations, &HawkesEM::loglikelihood_ur,
-      this, mu, kernels);
+      n_threads, n_nodes * n_realizations,
+      fft_binning > 0 ? &THawkesEM<T>::loglikelihood_binned_ur
+                      : &THawkesEM<T>::loglikelihood_ur,
+      this, mu, kernels, kernel_norms, kernel_discretization);
   return llh /= get_n_total_jumps();
 }
 
-void HawkesEM::solve(ArrayDouble &mu, ArrayDouble2d &kernels) {
+template <class T>
+void THawkesEM<T>::solve(ArrayDouble &mu, ArrayDouble2d &kernels) {
   if (!weights_computed) allocate_weights();
+  solve(mu, kernels, next_mu, next_kernels, get_n_threads());
+}
+
+template <class T>
+void THawkesEM<T>::solve(ArrayDouble &mu, ArrayDouble2d &kernels,
+                         ArrayDouble2d &next_mu_buffer,
+                         ArrayDouble2d &next_kernels_buffer,
+                         const unsigned int n_threads) {
   check_baseline_and_kernels(mu, kernels);
 
   // Map
   // Fill next_mu and next_kernels
-  next_mu.init_to_zero();
-  next_kernels.init_to_zero();
-  parallel_run(get_n_threads(), n_nodes * n_realizations, &HawkesEM::solve_ur,
-               this, mu, kernels);
+  next_mu_buffer.init_to_zero();
+  next_kernels_buffer.init_to_zero();
+  parallel_run(n_threads, n_nodes * n_realizations,
+               fft_binning > 0 ? &THawkesEM<T>::solve_binned_ur
+                               : &THawkesEM<T>::solve_ur,
+               this, mu, kernels, next_mu_buffer, next_kernels_buffer);
 
   // Reduce
   // Fill mu and kernels with next_mu and next_kernels
@@ -49,11 +136,11 @@ void HawkesEM::solve(ArrayDouble &mu, ArrayDouble2d &kernels) {
   kernels.init_to_zero();
   for (ulong r = 0; r < n_realizations; r++) {
     for (ulong node_u = 0; node_u < n_nodes; ++node_u) {
-      mu[node_u] += next_mu(r, node_u);
+      mu[node_u] += next_mu_buffer(r, node_u);
 
       ArrayDouble2d next_kernel_u_r(
           n_nodes, kernel_size,
-          view_row(next_kernels, r * n_nodes + node_u).data());
+          view_row(next_kernels_buffer, r * n_nodes + node_u).data());
       ArrayDouble2d kernel_u(n_nodes, kernel_size,
                              view_row(kernels, node_u).data());
       kernel_u.mult_incr(next_kernel_u_r, 1.);
@@ -61,67 +148,277 @@ void HawkesEM::solve(ArrayDouble &mu, ArrayDouble2d &kernels) {
   }
 }
 
-double HawkesEM::loglikelihood_ur(const ulong r_u, const ArrayDouble &mu,
-                                  ArrayDouble2d &kernels) {
+template <class T>
+ulong THawkesEM<T>::fit(ArrayDouble2d &mu_starts, ArrayDouble2d &kernels_starts,
+                        const ulong max_iter, const double tol,
+                        const ulong record_every) {
+  const ulong n_starts = mu_starts.n_rows();
+  if (n_starts == 0) {
+    TICK_ERROR("At least one starting point must be given");
+  }
+  if (mu_starts.n_cols() != n_nodes) {
+    TICK_ERROR("mu_starts argument must be an array of shape ("
+               << n_starts << ", " << n_nodes << ")");
+  }
+  if (kernels_starts.n_rows() != n_starts ||
+      kernels_starts.n_cols() != n_nodes * n_nodes * kernel_size) {
+    TICK_ERROR("kernels_starts argument must be an array of shape ("
+               << n_starts << ", " << n_nodes * n_nodes * kernel_size << ")");
+  }
+  if (!weights_computed) allocate_weights();
+
+  // Starting points run in parallel, each of them using its share of the
+  // threads for its own iterations
+  const unsigned int n_threads = get_n_threads();
+  const unsigned int n_parallel_starts =
+      static_cast<unsigned int>(std::min<ulong>(n_threads, n_starts));
+  const unsigned int n_threads_per_start =
+      std::max(1u, n_threads / n_parallel_starts);
+
+  fit_histories = std::vector<std::vector<double> >(n_starts);
+  ArrayDouble loglikelihoods(n_starts);
+  parallel_run(n_parallel_starts, n_starts, &THawkesEM<T>::fit_start, this,
+               mu_starts, kernels_starts, max_iter, tol, record_every,
+               n_threads_per_start, loglikelihoods);
+
+  // A starting point reaching a non positive intensity has a log-likelihood
+  // of -inf and a diverging one a NaN log-likelihood, they are only chosen
+  // if no starting point has a finite log-likelihood
+  ulong best_start = 0;
+  bool found_finite = false;
+  for (ulong start = 0; start < n_starts; ++start) {
+    if (!is_finite(loglikelihoods[start])) continue;
+    if (!found_finite || loglikelihoods[start] > loglikelihoods[best_start]) {
+      best_start = start;
+      found_finite = true;
+    }
+  }
+  return best_start;
+}
+
+template <class T>
+void THawkesEM<T>::fit_start(const ulong start, ArrayDouble2d &mu_starts,
+                             ArrayDouble2d &kernels_starts,
+                             const ulong max_iter, const double tol,
+                             const ulong record_every,
+                             const unsigned int n_threads_per_start,
+                             ArrayDouble &loglikelihoods) {
+  ArrayDouble mu = view_row(mu_starts, start);
+  ArrayDouble2d kernels(n_nodes, n_nodes * kernel_size,
+                        view_row(kernels_starts, start).data());
+
+  // Each starting point has its own buffers, the index of pairs is shared
+  ArrayDouble2d next_mu_buffer(n_realizations, n_nodes);
+  ArrayDouble2d next_kernels_buffer(n_realizations * n_nodes,
+                                    n_nodes * kernel_size);
+  ArrayDouble previous_mu(n_nodes);
+  ArrayDouble previous_kernels(kernels.size());
+  std::vector<double> &history = fit_histories[start];
+
+  double llh = std::numeric_limits<double>::quiet_NaN();
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const bool is_last_iter = iter + 1 == max_iter;
+    const bool record =
+        is_last_iter || (record_every > 0 && iter % record_every == 0);
+    if (record) {
+      previous_mu.mult_fill(mu, 1.);
+      std::copy(kernels.data(), kernels.data() + kernels.size(),
+                previous_kernels.data());
+    }
+
+    solve(mu, kernels, next_mu_buffer, next_kernels_buffer,
+          n_threads_per_start);
+
+    if (record) {
+      const double rel_baseline =
+          relative_distance(mu.data(), previous_mu.data(), n_nodes);
+      const double rel_kernel = relative_distance(
+          kernels.data(), previous_kernels.data(), kernels.size());
+      llh = loglikelihood(mu, kernels, n_threads_per_start);
+      history.insert(history.end(), {static_cast<double>(iter), rel_baseline,
+                                     rel_kernel, llh});
+
+      // Without recording, all iterations are run
+      if (record_every > 0 && std::max(rel_baseline, rel_kernel) <= tol) {
+        break;
+      }
+    }
+  }
+  loglikelihoods[start] = llh;
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesEM<T>::get_fit_history(const ulong start) const {
+  if (start >= fit_histories.size()) {
+    TICK_ERROR("No fit history for starting point " << start << ", last fit "
+                                                    << "had "
+                                                    << fit_histories.size()
+                                                    << " starting points");
+  }
+  const std::vector<double> &history = fit_histories[start];
+  ArrayDouble2d history_array(history.size() / n_fit_history_columns,
+                              n_fit_history_columns);
+  std::copy(history.begin(), history.end(), history_array.data());
+  return history_array.as_sarray2d_ptr();
+}
+
+template <class T>
+double THawkesEM<T>::loglikelihood_ur(
+    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+    const ArrayDouble2d &kernel_norms,
+    const ArrayDouble &kernel_discretization) {
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   double llh = (*end_times)[r];
-  std::function<void(double)> add_to_llh = [&llh](double intensity_t_i) {
+  auto add_to_llh = [&llh](ulong, ulong, double intensity_t_i) {
     if (intensity_t_i <= 0)
-      llh = std::numeric_limits<double>::infinity();
+      llh = -std::numeric_limits<double>::infinity();
     else
       llh += log(intensity_t_i);
   };
 
-  compute_intensities_ur(r_u, mu, kernels, add_to_llh, false);
+  compute_intensities_ur(r_u, mu, kernels, add_to_llh);
 
-  llh -= compute_compensator_ur(r_u, mu, kernels);
+  llh -= compute_compensator_ur(r_u, mu, kernels, kernel_norms,
+                                kernel_discretization);
   return llh;
 }
 
-void HawkesEM::solve_ur(const ulong r_u, const ArrayDouble &mu,
-                        ArrayDouble2d &kernels) {
+template <class T>
+void THawkesEM<T>::solve_ur(const ulong r_u, const ArrayDouble &mu,
+                            ArrayDouble2d &kernels,
+                            ArrayDouble2d &next_mu_buffer,
+                            ArrayDouble2d &next_kernels_buffer) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong node_u = r_u % n_nodes;
 
   // Fetch corresponding data
   const double mu_u = mu[node_u];
+  const ArrayDouble kernel_u = view_row(kernels, node_u);
+  const ulong *bins = pairs_bins[r_u].data();
+  const T *counts = pairs_counts[r_u].data();
+
+  // Row r_u of next_kernels is only written by this task, the normalization
+  // terms which do not depend on the event are applied once at the end
+  ArrayDouble next_kernel_ru = view_row(next_kernels_buffer, r_u);
+  double sum_inverse_intensities = 0;
+
+  auto add_to_next_kernel = [&](ulong pairs_start, ulong pairs_end,
+                                double intensity_t_i) {
+    // If norm is zero then nothing to do (no contribution)
+    if (intensity_t_i == 0) return;
+
+    const double inverse_intensity = 1. / intensity_t_i;
+    sum_inverse_intensities += inverse_intensity;
+    for (ulong p = pairs_start; p < pairs_end; ++p) {
+      next_kernel_ru[bins[p]] +=
+          counts[p] * kernel_u[bins[p]] * inverse_intensity;
+    }
+  };
+  compute_intensities_ur(r_u, mu, kernels, add_to_next_kernel);
 
-  // initialize next data
-  ArrayDouble2d next_kernel_ru(
-      n_nodes, kernel_size,
-      view_row(next_kernels, r * n_nodes + node_u).data());
-  ArrayDouble2d unnormalized_kernel_ru(
-      n_nodes, kernel_size,
-      view_row(unnormalized_kernels, r * n_nodes + node_u).data());
-  double &next_mu_ru = next_mu(r, node_u);
-
-  std::function<void(double)> add_to_next_kernel =
-      [this, &unnormalized_kernel_ru, &next_kernel_ru, &next_mu_ru,
-       &mu_u](double intensity_t_i) {
-        // If norm is zero then nothing to do (no contribution)
-        if (intensity_t_i == 0) return;
-
-        // Otherwise, we need to norm the kernel_temp's and the mu_temp
-        // and add their contributions to the estimation
-        next_mu_ru += mu_u / (intensity_t_i * this->end_times->sum());
-        for (ulong node_v = 0; node_v < this->n_nodes; node_v++) {
-          ArrayDouble unnormalized_kernel_ruv =
-              view_row(unnormalized_kernel_ru, node_v);
-          ArrayDouble next_kernel_ruv = view_row(next_kernel_ru, node_v);
-          for (ulong m = 0; m < this->kernel_size; m++) {
-            const double normalization_term =
-                intensity_t_i * (*this->n_jumps_per_node)[node_v] *
-                get_kernel_dt(m);
-            next_kernel_ruv[m] +=
-                unnormalized_kernel_ruv[m] / normalization_term;
-          }
-        }
-      };
-  compute_intensities_ur(r_u, mu, kernels, add_to_next_kernel, true);
+  next_mu_buffer(r, node_u) = mu_u * sum_inverse_intensities / end_times->sum();
+  for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+    // Without jumps on node v there is no contribution
+    if ((*n_jumps_per_node)[node_v] == 0) continue;
+    for (ulong m = 0; m < kernel_size; ++m) {
+      next_kernel_ru[node_v * kernel_size + m] /=
+          (*n_jumps_per_node)[node_v] * get_kernel_dt(m);
+    }
+  }
+}
+
+template <class T>
+double THawkesEM<T>::loglikelihood_binned_ur(
+    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+    const ArrayDouble2d &kernel_norms,
+    const ArrayDouble &kernel_discretization) {
+  const ulong r = static_cast<const ulong>(r_u / n_nodes);
+  const std::vector<T> &counts_u = binned_counts[r_u];
+
+  std::vector<double> intensities;
+  compute_binned_intensities_ur(r_u, mu, kernels, intensities);
+
+  double llh = (*end_times)[r];
+  for (ulong b = 0; b < counts_u.size(); ++b) {
+    if (counts_u[b] == 0) continue;
+    if (intensities[b] <= 0)
+      llh = -std::numeric_limits<double>::infinity();
+    else
+      llh += counts_u[b] * log(intensities[b]);
+  }
+
+  llh -= compute_compensator_ur(r_u, mu, kernels, kernel_norms,
+                                kernel_discretization);
+  return llh;
 }
 
-SArrayDouble2dPtr HawkesEM::get_kernel_norms(ArrayDouble2d &kernels) const {
+template <class T>
+void THawkesEM<T>::solve_binned_ur(const ulong r_u, const ArrayDouble &mu,
+                                   ArrayDouble2d &kernels,
+                                   ArrayDouble2d &next_mu_buffer,
+                                   ArrayDouble2d &next_kernels_buffer) {
+  // Obtain realization and node index from r_u
+  const ulong r = static_cast<const ulong>(r_u / n_nodes);
+  const ulong node_u = r_u % n_nodes;
+
+  const double mu_u = mu[node_u];
+  const ArrayDouble kernel_u = view_row(kernels, node_u);
+  const std::vector<T> &counts_u = binned_counts[r_u];
+  const ulong fft_length = binned_counts_fft[r_u].size();
+  const ulong n_lags = kernel_size * fft_binning;
+
+  std::vector<double> intensities;
+  compute_binned_intensities_ur(r_u, mu, kernels, intensities);
+
+  // Each event of a bin contributes with the inverse of its intensity
+  std::vector<std::complex<double> > weights(fft_length, 0.);
+  double sum_weights = 0;
+  for (ulong b = 0; b < counts_u.size(); ++b) {
+    // If intensity is zero then nothing to do (no contribution)
+    if (counts_u[b] == 0 || intensities[b] == 0) continue;
+    weights[b] = counts_u[b] / intensities[b];
+    sum_weights += weights[b].real();
+  }
+  fft(weights);
+
+  ArrayDouble next_kernel_ru = view_row(next_kernels_buffer, r_u);
+  std::vector<std::complex<double> > correlation(fft_length);
+  for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+    // Without jumps on node v there is no contribution
+    if ((*n_jumps_per_node)[node_v] == 0) continue;
+
+    // Correlation at lag L between weights of node u and counts of node v
+    const std::vector<std::complex<double> > &counts_fft_v =
+        binned_counts_fft[r * n_nodes + node_v];
+    for (ulong p = 0; p < fft_length; ++p) {
+      correlation[p] = weights[p] * std::conj(counts_fft_v[p]);
+    }
+    fft(correlation, true);
+
+    ArrayDouble next_kernel_ruv =
+        view(next_kernel_ru, node_v * kernel_size, (node_v + 1) * kernel_size);
+    for (ulong lag = 0; lag < n_lags; ++lag) {
+      next_kernel_ruv[lag / fft_binning] += correlation[lag].real();
+    }
+    // An event is not its own parent
+    if (node_v == node_u) next_kernel_ruv[0] -= sum_weights;
+
+    for (ulong m = 0; m < kernel_size; ++m) {
+      const double normalization_term =
+          (*n_jumps_per_node)[node_v] * get_kernel_dt(m);
+      // FFT rounding errors might lead to tiny negative values
+      next_kernel_ruv[m] = std::max(0., next_kernel_ruv[m]) *
+                           kernel_u[node_v * kernel_size + m] /
+                           normalization_term;
+    }
+  }
+
+  next_mu_buffer(r, node_u) = mu_u * sum_weights / end_times->sum();
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesEM<T>::get_kernel_norms(ArrayDouble2d &kernels) const {
   check_baseline_and_kernels(ArrayDouble(n_nodes), kernels);
 
   ArrayDouble discretization_intervals(kernel_size);
@@ -142,125 +439,178 @@ SArrayDouble2dPtr HawkesEM::get_kernel_norms(ArrayDouble2d &kernels) const {
   return kernel_norms.as_sarray2d_ptr();
 }
 
-void HawkesEM::compute_intensities_ur(
-    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
-    std::function<void(double)> intensity_func,
-    bool store_unnormalized_kernel) {
+template <class T>
+void THawkesEM<T>::compute_pairs_index_ur(const ulong r_u) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong node_u = r_u % n_nodes;
 
-  ArrayDouble2d kernel_norms = *get_kernel_norms(kernels);
-  double marginal_int_intensity = 0;
-  for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
-    marginal_int_intensity += kernel_norms(node_v, node_u);
-  }
-
-  // Fetch corresponding data
   SArrayDoublePtrList1D &realization = timestamps_list[r];
-  ArrayDouble2d kernel_u(n_nodes, kernel_size,
-                         view_row(kernels, node_u).data());
-  const double mu_u = mu[node_u];
-
-  ArrayDouble2d unnormalized_kernel_ru;
-  if (store_unnormalized_kernel) {
-    unnormalized_kernel_ru = ArrayDouble2d(
-        n_nodes, kernel_size,
-        view_row(unnormalized_kernels, r * n_nodes + node_u).data());
-  }
-
   ArrayDouble timestamps_u = view(*realization[node_u]);
 
+  std::vector<ulong> &indptr = pairs_indptr[r_u];
+  std::vector<ulong> &bins = pairs_bins[r_u];
+  std::vector<T> &counts = pairs_counts[r_u];
+  indptr.assign(1, 0);
+  bins.clear();
+  counts.clear();
+
   // This array will allow us to find quicker the events in each component that
-  // have occurred just before the events we will look at
-  ArrayULong last_indices(n_nodes);
-  for (ulong v = 0; v < n_nodes; v++) {
-    last_indices[v] = realization[v]->size();
-  }
+  // have occurred just before the events we will look at. end_indices[v] is
+  // the number of events of node v that satisfy v[index] <= t_i
+  ArrayULong end_indices(n_nodes);
+  end_indices.init_to_zero();
 
-  for (ulong i = timestamps_u.size() - 1; i != static_cast<ulong>(-1); i--) {
+  for (ulong i = 0; i < timestamps_u.size(); i++) {
     const double t_i = timestamps_u[i];
-    unnormalized_kernel_ru.init_to_zero();
 
-    // intensity_t_i will be equal to the intensity value of node i at time t_i
-    // ie. mu_u + \sum_v \sum_(t_j < t_i) g_uv(t_i - t_j)
-    double intensity_t_i = 0;
     for (ulong node_v = 0; node_v < n_nodes; node_v++) {
       ArrayDouble timestamps_v = view(*realization[node_v]);
 
-      ArrayDouble unnormalized_kernel_ruv;
-      if (store_unnormalized_kernel)
-        unnormalized_kernel_ruv = view_row(unnormalized_kernel_ru, node_v);
-
-      // Update the corresponding index such that it is the largest index which
-      // satisfies v[index] <= t_i
-      while (true) {
-        if (last_indices[node_v] == 0) break;
-        if (last_indices[node_v] < timestamps_v.size() &&
-            t_i >= timestamps_v[last_indices[node_v]])
-          break;
-        last_indices[node_v]--;
-      }
-      // if (t_i < timestamps_v[last_indices[node_v]]) continue;
-      if ( (timestamps_v.size() == 0) || (t_i < timestamps_v[last_indices[node_v]]) ) continue;
-
-      // Get the corresponding kernels and their size
-      ArrayDouble kernel_ruv = view_row(kernel_u, node_v);
+      while (end_indices[node_v] < timestamps_v.size() &&
+             timestamps_v[end_indices[node_v]] <= t_i)
+        end_indices[node_v]++;
 
-      ulong j0 = last_indices[node_v];
+      const ulong pairs_v_start = bins.size();
       ulong last_m = 0;
 
-      // So now we loop on the indices of y backward starting from the index
-      // computed above
-      for (ulong j = j0; j != static_cast<ulong>(-1); j--) {
-        // Case the two events are in fact the same one
-        if (node_u == node_v && i == j) {
-          intensity_t_i += mu_u;
+      // So now we loop on the indices of y backward starting from the last
+      // event before t_i
+      for (ulong j = end_indices[node_v] - 1; j != static_cast<ulong>(-1);
+           j--) {
+        // Case the two events are in fact the same one, it is accounted for
+        // by the baseline
+        if (node_u == node_v && i == j) continue;
+
+        const double t_diff = t_i - timestamps_v[j];
+        // If the two events are too far away --> we are done with node v
+        if (t_diff >= kernel_support) break;
+
+        // We get the index in the kernel array
+        ulong m;
+        if (kernel_discretization == nullptr) {
+          m = static_cast<ulong>(floor(t_diff / get_kernel_dt()));
         } else {
-          // Case they are different
-          const double t_j = timestamps_v[j];
-
-          const double t_diff = t_i - t_j;
-          if (t_diff < kernel_support) {
-            // We get the index in the kernel array
-            ulong m;
-            if (kernel_discretization == nullptr) {
-              m = static_cast<ulong>(floor(t_diff / get_kernel_dt()));
-            } else {
-              // last_m allows us to find m value quicker as m >= last_m
-              m = last_m;
-              while ((*kernel_discretization)[m + 1] < t_diff) m++;
-            }
-            last_m = m;
-
-            // Then we get the corresponding kernel value
-            double unnormalized_p_uv_ij = kernel_ruv[m];
-
-            if (store_unnormalized_kernel)
-              unnormalized_kernel_ruv[m] += unnormalized_p_uv_ij;
-
-            // Update the norm
-            intensity_t_i += unnormalized_p_uv_ij;
-          } else {
-            // If the two events are too far away --> we are done with the
-            // second loop
-            break;
-          }
+          // last_m allows us to find m value quicker as m >= last_m
+          m = last_m;
+          while ((*kernel_discretization)[m + 1] < t_diff) m++;
+        }
+        last_m = m;
+
+        // m is non decreasing, events falling in the same bin are merged
+        const ulong bin = node_v * kernel_size + m;
+        if (bins.size() > pairs_v_start && bins.back() == bin) {
+          counts.back() += 1;
+        } else {
+          bins.push_back(bin);
+          counts.push_back(1);
         }
       }
     }
-    intensity_func(intensity_t_i);
+    indptr.push_back(bins.size());
+  }
+}
+
+template <class T>
+void THawkesEM<T>::compute_binned_counts_rv(const ulong r_v) {
+  // Obtain realization and node index from r_v
+  const ulong r = static_cast<const ulong>(r_v / n_nodes);
+  const ulong node_v = r_v % n_nodes;
+
+  const double grid_dt = get_kernel_dt() / fft_binning;
+  const ulong n_bins =
+      static_cast<ulong>(std::floor((*end_times)[r] / grid_dt)) + 1;
+
+  ArrayDouble timestamps_v = view(*timestamps_list[r][node_v]);
+  std::vector<T> &counts = binned_counts[r_v];
+  counts.assign(n_bins, 0.);
+  for (ulong j = 0; j < timestamps_v.size(); ++j) {
+    const ulong b = static_cast<ulong>(std::floor(timestamps_v[j] / grid_dt));
+    counts[std::min(b, n_bins - 1)] += 1;
   }
+
+  // Zero padding over the kernel length avoids circular wraps
+  std::vector<std::complex<double> > &counts_fft = binned_counts_fft[r_v];
+  counts_fft.assign(fft_size(n_bins + kernel_size * fft_binning), 0.);
+  std::copy(counts.begin(), counts.end(), counts_fft.begin());
+  fft(counts_fft);
 }
 
-double HawkesEM::compute_compensator_ur(const ulong r_u, const ArrayDouble &mu,
-                                        ArrayDouble2d &kernels) {
+template <class T>
+void THawkesEM<T>::compute_binned_intensities_ur(
+    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+    std::vector<double> &intensities) {
+  // Obtain realization and node index from r_u
+  const ulong r = static_cast<const ulong>(r_u / n_nodes);
+  const ulong node_u = r_u % n_nodes;
+
+  const ArrayDouble kernel_u = view_row(kernels, node_u);
+  const ulong n_bins = binned_counts[r_u].size();
+  const ulong fft_length = binned_counts_fft[r_u].size();
+  const ulong n_lags = kernel_size * fft_binning;
+
+  // Sum over v of the convolutions of kernel uv on the grid with counts of v
+  std::vector<std::complex<double> > convolution(fft_length, 0.);
+  std::vector<std::complex<double> > kernel_fft(fft_length);
+  for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+    std::fill(kernel_fft.begin(), kernel_fft.end(), 0.);
+    for (ulong lag = 0; lag < n_lags; ++lag) {
+      kernel_fft[lag] = kernel_u[node_v * kernel_size + lag / fft_binning];
+    }
+    fft(kernel_fft);
+
+    const std::vector<std::complex<double> > &counts_fft_v =
+        binned_counts_fft[r * n_nodes + node_v];
+    for (ulong p = 0; p < fft_length; ++p) {
+      convolution[p] += kernel_fft[p] * counts_fft_v[p];
+    }
+  }
+  fft(convolution, true);
+
+  // Events of a bin do not excite themselves
+  intensities.resize(n_bins);
+  for (ulong b = 0; b < n_bins; ++b) {
+    intensities[b] =
+        mu[node_u] + convolution[b].real() - kernel_u[node_u * kernel_size];
+  }
+}
+
+template <class T>
+template <class IntensityFunc>
+void THawkesEM<T>::compute_intensities_ur(const ulong r_u,
+                                          const ArrayDouble &mu,
+                                          ArrayDouble2d &kernels,
+                                          IntensityFunc &intensity_func) {
+  const ulong node_u = r_u % n_nodes;
+
+  const ArrayDouble kernel_u = view_row(kernels, node_u);
+  const double mu_u = mu[node_u];
+
+  const std::vector<ulong> &indptr = pairs_indptr[r_u];
+  const ulong *bins = pairs_bins[r_u].data();
+  const T *counts = pairs_counts[r_u].data();
+
+  for (ulong i = 0; i + 1 < indptr.size(); i++) {
+    // intensity_t_i will be equal to the intensity value of node i at time t_i
+    // ie. mu_u + \sum_v \sum_(t_j < t_i) g_uv(t_i - t_j)
+    double intensity_t_i = mu_u;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; ++p) {
+      intensity_t_i += counts[p] * kernel_u[bins[p]];
+    }
+    intensity_func(indptr[i], indptr[i + 1], intensity_t_i);
+  }
+}
+
+template <class T>
+double THawkesEM<T>::compute_compensator_ur(
+    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+    const ArrayDouble2d &kernel_norms,
+    const ArrayDouble &kernel_discretization) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong node_u = r_u % n_nodes;
 
   double compensator = 0;
-  ArrayDouble2d kernel_norms = *get_kernel_norms(kernels);
 
   // Marginal value added to compensator by an event of node u
   double marginal_compensator = 0;
@@ -277,7 +627,6 @@ double HawkesEM::compute_compensator_ur(const ulong r_u, const ArrayDouble &mu,
   // Marginal compensator of the kernel u for timestamps are close to end_time
   double current_marginal_compensator = 0;
   ulong last_m = 0;
-  ArrayDouble kernel_discretization = *get_kernel_discretization();
   for (ulong i = timestamps_u.size() - 1; i != static_cast<ulong>(-1); i--) {
     const double t_i = timestamps_u[i];
     double t_diff = (*end_times)[r] - t_i;
@@ -319,7 +668,97 @@ double HawkesEM::compute_compensator_ur(const ulong r_u, const ArrayDouble &mu,
   return compensator;
 }
 
-double HawkesEM::get_kernel_dt(const ulong m) const {
+template <class T>
+SArrayDoublePtrList2D THawkesEM<T>::get_residuals(const ArrayDouble &mu,
+                                                  ArrayDouble2d &kernels) {
+  check_baseline_and_kernels(mu, kernels);
+  const ArrayDouble kernel_discretization = *get_kernel_discretization();
+
+  SArrayDoublePtrList2D residuals(n_realizations);
+  for (ulong r = 0; r < n_realizations; ++r) {
+    residuals[r] = SArrayDoublePtrList1D(n_nodes);
+    for (ulong node_u = 0; node_u < n_nodes; ++node_u) {
+      residuals[r][node_u] =
+          SArrayDouble::new_ptr(timestamps_list[r][node_u]->size());
+    }
+  }
+  parallel_run(get_n_threads(), n_nodes * n_realizations,
+               &THawkesEM<T>::compute_residuals_ur, this, mu, kernels,
+               kernel_discretization, residuals);
+  return residuals;
+}
+
+template <class T>
+void THawkesEM<T>::compute_residuals_ur(
+    const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+    const ArrayDouble &kernel_discretization,
+    SArrayDoublePtrList2D &residuals) {
+  // Obtain realization and node index from r_u
+  const ulong r = static_cast<const ulong>(r_u / n_nodes);
+  const ulong node_u = r_u % n_nodes;
+
+  // Fetch corresponding data
+  SArrayDoublePtrList1D &realization = timestamps_list[r];
+  const double mu_u = mu[node_u];
+  const ArrayDouble kernel_u = view_row(kernels, node_u);
+  const ArrayDouble timestamps_u = view(*realization[node_u]);
+  ArrayDouble &residuals_u = *residuals[r][node_u];
+
+  const double *discretization = kernel_discretization.data();
+  const double support = discretization[kernel_size];
+
+  // Primitives of the kernels of node u at each discretization point
+  ArrayDouble primitives_u(n_nodes * (kernel_size + 1));
+  for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+    double *primitive_v = primitives_u.data() + node_v * (kernel_size + 1);
+    primitive_v[0] = 0;
+    for (ulong m = 0; m < kernel_size; ++m) {
+      primitive_v[m + 1] =
+          primitive_v[m] + kernel_u[node_v * kernel_size + m] *
+                               (discretization[m + 1] - discretization[m]);
+    }
+  }
+
+  // Integral of the kernel of node v on node u between 0 and x
+  auto primitive = [&](const ulong node_v, const double x) {
+    const double *primitive_v =
+        primitives_u.data() + node_v * (kernel_size + 1);
+    if (x <= 0) return 0.;
+    if (x >= support) return primitive_v[kernel_size];
+    const ulong m = std::upper_bound(discretization,
+                                     discretization + kernel_size + 1, x) -
+                    discretization - 1;
+    return primitive_v[m] +
+           kernel_u[node_v * kernel_size + m] * (x - discretization[m]);
+  };
+
+  // Jumps of node v older than the previous jump of node u minus the kernel
+  // support do not contribute anymore
+  std::vector<ulong> first_jumps(n_nodes, 0);
+  double t_previous = 0;
+  for (ulong k = 0; k < timestamps_u.size(); ++k) {
+    const double t_k = timestamps_u[k];
+    double residual = mu_u * (t_k - t_previous);
+    for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+      const ArrayDouble &timestamps_v = *realization[node_v];
+      const ulong n_jumps_v = timestamps_v.size();
+      ulong &first_jump = first_jumps[node_v];
+      while (first_jump < n_jumps_v &&
+             timestamps_v[first_jump] <= t_previous - support) {
+        first_jump++;
+      }
+      for (ulong p = first_jump; p < n_jumps_v && timestamps_v[p] < t_k; ++p) {
+        residual += primitive(node_v, t_k - timestamps_v[p]) -
+                    primitive(node_v, t_previous - timestamps_v[p]);
+      }
+    }
+    residuals_u[k] = residual;
+    t_previous = t_k;
+  }
+}
+
+template <class T>
+double THawkesEM<T>::get_kernel_dt(const ulong m) const {
   if (kernel_discretization == nullptr) {
     return kernel_support / kernel_size;
   } else {
@@ -327,8 +766,9 @@ double HawkesEM::get_kernel_dt(const ulong m) const {
   }
 }
 
-void HawkesEM::check_baseline_and_kernels(const ArrayDouble &mu,
-                                          ArrayDouble2d &kernels) const {
+template <class T>
+void THawkesEM<T>::check_baseline_and_kernels(const ArrayDouble &mu,
+                                              ArrayDouble2d &kernels) const {
   if (mu.size() != n_nodes) {
     TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
   }
@@ -339,7 +779,8 @@ void HawkesEM::check_baseline_and_kernels(const ArrayDouble &mu,
   }
 }
 
-double HawkesEM::get_kernel_fixed_dt() const {
+template <class T>
+double THawkesEM<T>::get_kernel_fixed_dt() const {
   if (kernel_discretization == nullptr) {
     return get_kernel_dt();
   } else {
@@ -349,7 +790,8 @@ double HawkesEM::get_kernel_fixed_dt() const {
   }
 }
 
-void HawkesEM::set_kernel_support(const double kernel_support) {
+template <class T>
+void THawkesEM<T>::set_kernel_support(const double kernel_support) {
   if (kernel_discretization != nullptr) {
     TICK_ERROR(
         "kernel support cannot be set if kernel discretization "
@@ -363,7 +805,8 @@ void HawkesEM::set_kernel_support(const double kernel_support) {
   weights_computed = false;
 }
 
-void HawkesEM::set_kernel_size(const ulong kernel_size) {
+template <class T>
+void THawkesEM<T>::set_kernel_size(const ulong kernel_size) {
   if (kernel_discretization != nullptr) {
     TICK_ERROR(
         "kernel size cannot be set if kernel discretization "
@@ -377,7 +820,8 @@ void HawkesEM::set_kernel_size(const ulong kernel_size) {
   weights_computed = false;
 }
 
-void HawkesEM::set_kernel_dt(const double kernel_dt) {
+template <class T>
+void THawkesEM<T>::set_kernel_dt(const double kernel_dt) {
   if (kernel_discretization != nullptr) {
     TICK_ERROR(
         "kernel discretization parameter cannot be set if kernel "
@@ -400,8 +844,14 @@ void HawkesEM::set_kernel_dt(const double kernel_dt) {
   set_kernel_size(static_cast<ulong>(std::ceil(kernel_support / kernel_dt)));
 }
 
-void HawkesEM::set_kernel_discretization(
+template <class T>
+void THawkesEM<T>::set_kernel_discretization(
     const SArrayDoublePtr kernel_discretization1) {
+  if (fft_binning > 0) {
+    TICK_ERROR(
+        "kernel discretization cannot be set explicitly if fft binning is "
+        "used")
+  }
   set_kernel_support(kernel_discretization1->last());
   set_kernel_size(kernel_discretization1->size() - 1);
 
@@ -418,7 +868,8 @@ void HawkesEM::set_kernel_discretization(
   weights_computed = false;
 }
 
-SArrayDoublePtr HawkesEM::get_kernel_discretization() const {
+template <class T>
+SArrayDoublePtr THawkesEM<T>::get_kernel_discretization() const {
   if (kernel_discretization == nullptr) {
     ArrayDouble kernel_discretization_tmp = arange<double>(0, kernel_size + 1);
     kernel_discretization_tmp.mult_fill(kernel_discretization_tmp,
@@ -428,3 +879,17 @@ SArrayDoublePtr HawkesEM::get_kernel_discretization() const {
     return kernel_discretization;
   }
 }
+
+template <class T>
+void THawkesEM<T>::set_fft_binning(const ulong fft_binning) {
+  if (fft_binning > 0 && kernel_discretization != nullptr) {
+    TICK_ERROR(
+        "fft binning cannot be used if kernel discretization is explicitly "
+        "set")
+  }
+  this->fft_binning = fft_binning;
+  weights_computed = false;
+}
+
+template class DLL_PUBLIC THawkesEM<double>;
+template class DLL_PUBLIC THawkesEM<float>;
@@ -1,6 +1,10 @@
 // License: BSD 3 clause
 
 #include "tick/hawkes/inference/hawkes_sumgaussians.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "tick/base/base.h"
 
 // soft-thresholding operator
@@ -9,12 +13,53 @@ double soft_thres(double z, double alpha) {
                 : -std::max(std::abs(z) - alpha, 0.));
 }
 
-HawkesSumGaussians::HawkesSumGaussians(
+// Cubic Hermite interpolation between two consecutive points of a lookup
+// table separated by step, given the values and derivatives at both points
+static inline double hermite_interpolation(const double value_0,
+                                           const double derivative_0,
+                                           const double value_1,
+                                           const double derivative_1,
+                                           const double fraction,
+                                           const double step) {
+  const double fraction_sq = fraction * fraction;
+  const double fraction_cu = fraction_sq * fraction;
+  return (2 * fraction_cu - 3 * fraction_sq + 1) * value_0 +
+         (fraction_cu - 2 * fraction_sq + fraction) * step * derivative_0 +
+         (-2 * fraction_cu + 3 * fraction_sq) * value_1 +
+         (fraction_cu - fraction_sq) * step * derivative_1;
+}
+
+static const double sqrt_2_over_pi = std::sqrt(2. / M_PI);
+
+// Values recorded for each checked iteration of fit: iteration number and
+// relative changes of baseline and amplitudes
+static const ulong n_fit_history_columns = 3;
+
+// Iterations run by fit before convergence is accepted, the relative changes
+// are sometimes small at start
+static const ulong min_fit_iter = 7;
+
+// Norm of new_values - old_values relatively to the norm of old_values, as
+// tick.solver.base.utils.relative_distance does
+static double relative_distance(const double *new_values,
+                                const double *old_values, const ulong size) {
+  double norm_diff = 0, norm_old = 0;
+  for (ulong j = 0; j < size; ++j) {
+    const double diff = new_values[j] - old_values[j];
+    norm_diff += diff * diff;
+    norm_old += old_values[j] * old_values[j];
+  }
+  return std::sqrt(norm_diff / (norm_old == 0 ? 1. : norm_old));
+}
+
+template <class T>
+THawkesSumGaussians<T>::THawkesSumGaussians(
     const ulong n_gaussians, const double max_mean_gaussian,
     const double step_size, const double strength_lasso,
     const double strength_grouplasso, const ulong em_max_iter,
     const int max_n_threads, const unsigned int optimization_level)
-    : ModelHawkesList(max_n_threads, optimization_level) {
+    : ModelHawkesList(max_n_threads, optimization_level),
+      n_std_truncation(0) {
   set_n_gaussians(n_gaussians);
   set_em_max_iter(em_max_iter);
   set_max_mean_gaussian(max_mean_gaussian);
@@ -23,22 +68,16 @@ HawkesSumGaussians::HawkesSumGaussians(
   set_strength_grouplasso(strength_grouplasso);
 }
 
-void HawkesSumGaussians::compute_weights() {
+template <class T>
+void THawkesSumGaussians<T>::compute_weights() {
   // Allocate weights
   next_mu = ArrayDouble2d(n_realizations, n_nodes);
   next_C = ArrayDouble2d(n_realizations * n_nodes, n_nodes * n_gaussians);
-  unnormalized_next_C =
-      ArrayDouble2d(n_realizations * n_nodes, n_nodes * n_gaussians);
 
   kernel_integral = ArrayDouble(n_nodes * n_gaussians);
-  g = ArrayDouble2dList2D(n_realizations);
-  for (ulong r = 0; r < n_realizations; r++) {
-    g[r] = ArrayDouble2dList1D(n_nodes);
-    for (ulong u = 0; u < n_nodes; u++) {
-      g[r][u] =
-          ArrayDouble2d(timestamps_list[r][u]->size(), n_nodes * n_gaussians);
-    }
-  }
+  g_indptr = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  g_indices = std::vector<std::vector<ulong> >(n_realizations * n_nodes);
+  g_values = std::vector<std::vector<T> >(n_realizations * n_nodes);
 
   // Compute means_gaussians, std_gaussian and useful constants
   means_gaussians = ArrayDouble(n_gaussians);
@@ -51,13 +90,28 @@ void HawkesSumGaussians::compute_weights() {
   norm_constant_gauss = std_gaussian * std::sqrt(2. * M_PI);
   norm_constant_erf = std_gaussian * std::sqrt(2);
 
+  // Fill lookup tables, one extra point is needed for interpolation
+  if (n_std_truncation > 0) {
+    const ulong n_table_points =
+        static_cast<ulong>(
+            std::ceil(n_std_truncation * n_table_points_per_std)) +
+        2;
+    gaussian_table = ArrayDouble(n_table_points);
+    erf_table = ArrayDouble(n_table_points);
+    for (ulong k = 0; k < n_table_points; k++) {
+      const double x = static_cast<double>(k) / n_table_points_per_std;
+      gaussian_table[k] = std::exp(-x * x / 2.);
+      erf_table[k] = std::erf(x / std::sqrt(2.));
+    }
+  }
+
   // Compute weights
   // variable to compute kernel integral in parallel that will be reduced
   // afterwards
   ArrayDouble2d map_kernel_integral(n_realizations, n_nodes * n_gaussians);
   map_kernel_integral.init_to_zero();
   parallel_run(get_n_threads(), n_nodes * n_realizations,
-               &HawkesSumGaussians::compute_weights_ru, this,
+               &THawkesSumGaussians<T>::compute_weights_ru, this,
                map_kernel_integral);
 
   kernel_integral.init_to_zero();
@@ -74,48 +128,133 @@ void HawkesSumGaussians::compute_weights() {
   weights_computed = true;
 }
 
-void HawkesSumGaussians::compute_weights_ru(
+template <class T>
+double THawkesSumGaussians<T>::gaussian_density(const double x) {
+  if (n_std_truncation == 0) {
+    return cexp(-x * x / (2. * std_gaussian_sq)) / norm_constant_gauss;
+  }
+  const double position = std::abs(x) / std_gaussian * n_table_points_per_std;
+  if (position >= n_std_truncation * n_table_points_per_std) return 0.;
+  const ulong k = static_cast<ulong>(position);
+  // The derivative of exp(-y^2 / 2) is -y exp(-y^2 / 2)
+  const double y_k = static_cast<double>(k) / n_table_points_per_std;
+  const double y_k1 = static_cast<double>(k + 1) / n_table_points_per_std;
+  return hermite_interpolation(gaussian_table[k], -y_k * gaussian_table[k],
+                               gaussian_table[k + 1],
+                               -y_k1 * gaussian_table[k + 1], position - k,
+                               1. / n_table_points_per_std) /
+         norm_constant_gauss;
+}
+
+template <class T>
+double THawkesSumGaussians<T>::gaussian_cdf(const double x) {
+  if (n_std_truncation == 0) {
+    return 0.5 + 0.5 * std::erf(x / norm_constant_erf);
+  }
+  const double position = std::abs(x) / std_gaussian * n_table_points_per_std;
+  if (position >= n_std_truncation * n_table_points_per_std) {
+    return x > 0 ? 1. : 0.;
+  }
+  const ulong k = static_cast<ulong>(position);
+  // The derivative of erf(y / sqrt(2)) is sqrt(2 / pi) exp(-y^2 / 2)
+  const double erf_value = hermite_interpolation(
+      erf_table[k], sqrt_2_over_pi * gaussian_table[k], erf_table[k + 1],
+      sqrt_2_over_pi * gaussian_table[k + 1], position - k,
+      1. / n_table_points_per_std);
+  return x > 0 ? 0.5 + 0.5 * erf_value : 0.5 - 0.5 * erf_value;
+}
+
+template <class T>
+void THawkesSumGaussians<T>::compute_weights_ru(
     const ulong r_u, ArrayDouble2d &map_kernel_integral) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong u = r_u % n_nodes;
-  ArrayDouble2d g_ru = view(g[r][u]);
-  g_ru.init_to_zero();
   const ArrayDouble timestamps_ru = view(*timestamps_list[r][u]);
+  const ulong n_jumps_ru = timestamps_ru.size();
   const double end_time_r = (*end_times)[r];
   ArrayDouble map_kernel_integral_r = view_row(map_kernel_integral, r);
 
-  for (ulong v = 0; v < n_nodes; v++) {
-    const ArrayDouble timestamps_rv = view(*timestamps_list[r][v]);
-    for (ulong k = 0; k < timestamps_ru.size(); k++) {
-      const double t_ru_k = timestamps_ru[k];
-      ArrayDouble g_ru_k = view_row(g_ru, k);
-      for (ulong m = 0; m < n_gaussians; m++) {
-        ulong ij = 0;
-        while ((ij < timestamps_rv.size()) && (timestamps_rv[ij] < t_ru_k)) {
-          g_ru_k[v * n_gaussians + m] +=
-              cexp(-(t_ru_k - timestamps_rv[ij] - means_gaussians[m]) *
-                   (t_ru_k - timestamps_rv[ij] - means_gaussians[m]) /
-                   (2. * std_gaussian_sq)) /
-              norm_constant_gauss;
-          ij++;
+  // Gaussian m only needs to be evaluated for lags within cutoff of its mean
+  const bool truncated = n_std_truncation > 0;
+  const double cutoff = n_std_truncation * std_gaussian;
+  const double max_lag = means_gaussians[n_gaussians - 1] + cutoff;
+  const double mean_step = max_mean_gaussian / n_gaussians;
+
+  std::vector<ulong> &indptr = g_indptr[r_u];
+  std::vector<ulong> &indices = g_indices[r_u];
+  std::vector<T> &values = g_values[r_u];
+  indptr.assign(1, 0);
+  indices.clear();
+  values.clear();
+
+  // Dense accumulator of the current event, touched_at stores the last event
+  // (shifted by one) for which an entry has been touched
+  ArrayDouble g_ru_k(n_nodes * n_gaussians);
+  std::vector<ulong> touched_at(n_nodes * n_gaussians, 0);
+  std::vector<ulong> touched;
+  // First event of each node that might still be within max_lag
+  std::vector<ulong> first_events(n_nodes, 0);
+
+  for (ulong k = 0; k < n_jumps_ru; k++) {
+    const double t_ru_k = timestamps_ru[k];
+
+    for (ulong v = 0; v < n_nodes; v++) {
+      const ArrayDouble timestamps_rv = view(*timestamps_list[r][v]);
+      ulong &first_event_v = first_events[v];
+      if (truncated) {
+        while (first_event_v < timestamps_rv.size() &&
+               timestamps_rv[first_event_v] <= t_ru_k - max_lag) {
+          first_event_v++;
         }
       }
-      if (u == v) {
-        // We use this pass over the data to fill kernel_integral
-        for (ulong m = 0; m < n_gaussians; m++) {
-          map_kernel_integral_r[u * n_gaussians + m] +=
-              0.5 * std::erf((end_time_r - t_ru_k - means_gaussians[m]) /
-                             norm_constant_erf) +
-              0.5 * std::erf(means_gaussians[m] / norm_constant_erf);
+
+      for (ulong ij = first_event_v;
+           ij < timestamps_rv.size() && timestamps_rv[ij] < t_ru_k; ij++) {
+        const double lag = t_ru_k - timestamps_rv[ij];
+        ulong m_start = 0, m_end = n_gaussians;
+        if (truncated) {
+          if (lag > cutoff) {
+            m_start = static_cast<ulong>(std::ceil((lag - cutoff) / mean_step));
+          }
+          m_end = std::min(
+              n_gaussians,
+              static_cast<ulong>(std::floor((lag + cutoff) / mean_step)) + 1);
+        }
+        for (ulong m = m_start; m < m_end; m++) {
+          const double value = gaussian_density(lag - means_gaussians[m]);
+          if (value == 0) continue;
+          const ulong index = v * n_gaussians + m;
+          if (touched_at[index] != k + 1) {
+            touched_at[index] = k + 1;
+            touched.push_back(index);
+            g_ru_k[index] = 0;
+          }
+          g_ru_k[index] += value;
         }
       }
     }
+
+    std::sort(touched.begin(), touched.end());
+    for (const ulong index : touched) {
+      indices.push_back(index);
+      values.push_back(static_cast<T>(g_ru_k[index]));
+    }
+    indptr.push_back(indices.size());
+    touched.clear();
+
+    // We use this pass over the data to fill kernel_integral
+    for (ulong m = 0; m < n_gaussians; m++) {
+      map_kernel_integral_r[u * n_gaussians + m] +=
+          gaussian_cdf(end_time_r - t_ru_k - means_gaussians[m]) -
+          gaussian_cdf(-means_gaussians[m]);
+    }
   }
 }
 
 // The main method for performing one iteration
-void HawkesSumGaussians::solve(ArrayDouble &mu, ArrayDouble2d &amplitudes) {
+template <class T>
+void THawkesSumGaussians<T>::solve(ArrayDouble &mu, ArrayDouble2d &amplitudes) {
   if (!weights_computed) compute_weights();
 
   if (mu.size() != n_nodes) {
@@ -134,74 +273,119 @@ void HawkesSumGaussians::solve(ArrayDouble &mu, ArrayDouble2d &amplitudes) {
     next_mu.init_to_zero();
 
     parallel_run(get_n_threads(), n_nodes * n_realizations,
-                 &HawkesSumGaussians::estimate_ru, this, mu, amplitudes);
+                 &THawkesSumGaussians<T>::estimate_ru, this, mu, amplitudes);
     parallel_run(
         std::min(get_n_threads(), static_cast<const unsigned int>(n_nodes)),
-        n_nodes, &HawkesSumGaussians::update_u, this, mu, amplitudes);
+        n_nodes, &THawkesSumGaussians<T>::update_u, this, mu, amplitudes);
   }
 
   parallel_run(
       std::min(get_n_threads(), static_cast<const unsigned int>(n_nodes)),
-      n_nodes, &HawkesSumGaussians::prox_amplitudes_u, this, amplitudes,
+      n_nodes, &THawkesSumGaussians<T>::prox_amplitudes_u, this, amplitudes,
       amplitudes_old);
 }
 
-// Procedure called by HawkesSumGaussians::solve
-void HawkesSumGaussians::estimate_ru(const ulong r_u, ArrayDouble &mu,
-                                     ArrayDouble2d &amplitudes) {
+template <class T>
+ulong THawkesSumGaussians<T>::fit(ArrayDouble &mu, ArrayDouble2d &amplitudes,
+                                  const ulong max_iter, const double tol,
+                                  const double em_tol,
+                                  const ulong record_every) {
+  fit_history.clear();
+  ArrayDouble previous_mu(mu.size());
+  ArrayDouble previous_amplitudes(amplitudes.size());
+  // Without em_tol, iterations stop once they change the parameters a
+  // hundred times less than the last checked one
+  double max_relative_distance = 1e-1;
+  for (ulong iter = 0; iter < max_iter; ++iter) {
+    const bool is_last_iter = iter + 1 == max_iter;
+    const bool record =
+        is_last_iter || (record_every > 0 && iter % record_every == 0);
+    if (record) {
+      previous_mu.mult_fill(mu, 1.);
+      std::copy(amplitudes.data(), amplitudes.data() + amplitudes.size(),
+                previous_amplitudes.data());
+    }
+
+    solve(mu, amplitudes);
+
+    if (record) {
+      const double rel_baseline =
+          relative_distance(mu.data(), previous_mu.data(), mu.size());
+      const double rel_amplitudes =
+          relative_distance(amplitudes.data(), previous_amplitudes.data(),
+                            amplitudes.size());
+      fit_history.insert(fit_history.end(), {static_cast<double>(iter + 1),
+                                             rel_baseline, rel_amplitudes});
+
+      const double rel_max = std::max(rel_baseline, rel_amplitudes);
+      const double inner_tol =
+          em_tol < 0 ? max_relative_distance * 1e-2 : em_tol;
+      max_relative_distance = rel_max;
+      if (rel_max < inner_tol ||
+          (rel_max <= tol && iter + 1 >= min_fit_iter)) {
+        return iter + 1;
+      }
+    }
+  }
+  return max_iter;
+}
+
+template <class T>
+SArrayDouble2dPtr THawkesSumGaussians<T>::get_fit_history() const {
+  ArrayDouble2d history_array(fit_history.size() / n_fit_history_columns,
+                              n_fit_history_columns);
+  std::copy(fit_history.begin(), fit_history.end(), history_array.data());
+  return history_array.as_sarray2d_ptr();
+}
+
+// Procedure called by THawkesSumGaussians<T>::solve
+template <class T>
+void THawkesSumGaussians<T>::estimate_ru(const ulong r_u, ArrayDouble &mu,
+                                         ArrayDouble2d &amplitudes) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong node_u = r_u % n_nodes;
 
   // Fetch corresponding data
-  SArrayDoublePtrList1D &realization = timestamps_list[r];
   ArrayDouble amplitudes_u = view_row(amplitudes, node_u);
-  ArrayDouble2d g_ru = view(g[r][node_u]);
+  const std::vector<ulong> &indptr = g_indptr[r_u];
+  const ulong *indices = g_indices[r_u].data();
+  const T *values = g_values[r_u].data();
   double mu_u = mu[node_u];
 
   // initialize next data
   double &next_mu_ur = next_mu(r, node_u);
   ArrayDouble next_C_ru = view_row(next_C, r * n_nodes + node_u);
-  ArrayDouble unnormalized_next_C_ru =
-      view_row(unnormalized_next_C, r * n_nodes + node_u);
-
-  // We loop in reverse order to benefit from last_indices
-  for (ulong i = realization[node_u]->size() - 1; i != static_cast<ulong>(-1);
-       i--) {
-    // this array will store temporary values
-    unnormalized_next_C_ru.init_to_zero();
-    ArrayDouble g_ru_i = view_row(g_ru, i);
 
+  for (ulong i = 0; i + 1 < indptr.size(); i++) {
     // norm will be equal to mu_u + \sum_v \sum_m a_uv^m \sum_(t_j < t_i)
     // g_m(t_i - t_j)
     double norm = mu_u;
-
-    for (ulong node_v = 0; node_v < n_nodes; node_v++) {
-      for (ulong m = 0; m < n_gaussians; m++) {
-        const double sum_unnormalized_p_ij =
-            amplitudes_u[node_v * n_gaussians + m] *
-            g_ru_i[node_v * n_gaussians + m];
-        unnormalized_next_C_ru[node_v * n_gaussians + m] +=
-            sum_unnormalized_p_ij;
-        norm += sum_unnormalized_p_ij;
-      }
+    for (ulong p = indptr[i]; p < indptr[i + 1]; p++) {
+      norm += amplitudes_u[indices[p]] * values[p];
     }
+
     next_mu_ur += mu_u / norm;
-    next_C_ru.mult_incr(unnormalized_next_C_ru, 1. / norm);
+    const double inv_norm = 1. / norm;
+    for (ulong p = indptr[i]; p < indptr[i + 1]; p++) {
+      next_C_ru[indices[p]] += amplitudes_u[indices[p]] * values[p] * inv_norm;
+    }
   }
 }
 
 // A method called in parallel by the method 'solve' (see below)
-void HawkesSumGaussians::update_u(const ulong u, ArrayDouble &mu,
-                                  ArrayDouble2d &amplitudes) {
+template <class T>
+void THawkesSumGaussians<T>::update_u(const ulong u, ArrayDouble &mu,
+                                      ArrayDouble2d &amplitudes) {
   ArrayDouble amplitudes_u = view_row(amplitudes, u);
   update_amplitudes_u(u, amplitudes_u);
   update_baseline_u(u, mu);
 }
 
-// Procedure called by HawkesSumGaussians::solve
-void HawkesSumGaussians::update_amplitudes_u(const ulong u,
-                                             ArrayDouble &amplitudes_u) {
+// Procedure called by THawkesSumGaussians<T>::solve
+template <class T>
+void THawkesSumGaussians<T>::update_amplitudes_u(const ulong u,
+                                                 ArrayDouble &amplitudes_u) {
   for (ulong v = 0; v < n_nodes; v++) {
     // computation of updated values
     // computation of ||a_uv||_2
@@ -231,10 +415,11 @@ void HawkesSumGaussians::update_amplitudes_u(const ulong u,
   }
 }
 
-// Procedure called by HawkesSumGaussians::solve
-void HawkesSumGaussians::prox_amplitudes_u(const ulong u,
-                                           ArrayDouble2d &amplitudes,
-                                           ArrayDouble2d &amplitudes_old) {
+// Procedure called by THawkesSumGaussians<T>::solve
+template <class T>
+void THawkesSumGaussians<T>::prox_amplitudes_u(const ulong u,
+                                               ArrayDouble2d &amplitudes,
+                                               ArrayDouble2d &amplitudes_old) {
   ArrayDouble amplitudes_u = view_row(amplitudes, u);
 
   ArrayDouble amplitudes_u_old = view_row(amplitudes_old, u);
@@ -283,16 +468,19 @@ void HawkesSumGaussians::prox_amplitudes_u(const ulong u,
   }
 }
 
-void HawkesSumGaussians::update_baseline_u(const ulong u, ArrayDouble &mu) {
+template <class T>
+void THawkesSumGaussians<T>::update_baseline_u(const ulong u, ArrayDouble &mu) {
   mu[u] = 0;
   for (ulong r = 0; r < n_realizations; r++) {
     mu[u] += next_mu(r, u) / end_times->sum();
   }
 }
 
-ulong HawkesSumGaussians::get_n_gaussians() const { return n_gaussians; }
+template <class T>
+ulong THawkesSumGaussians<T>::get_n_gaussians() const { return n_gaussians; }
 
-void HawkesSumGaussians::set_n_gaussians(const ulong n_gaussians) {
+template <class T>
+void THawkesSumGaussians<T>::set_n_gaussians(const ulong n_gaussians) {
   if (n_gaussians <= 0) {
     TICK_ERROR("n_gaussians must be positive, received " << n_gaussians);
   }
@@ -300,20 +488,25 @@ void HawkesSumGaussians::set_n_gaussians(const ulong n_gaussians) {
   weights_computed = false;
 }
 
-ulong HawkesSumGaussians::get_em_max_iter() const { return em_max_iter; }
+template <class T>
+ulong THawkesSumGaussians<T>::get_em_max_iter() const { return em_max_iter; }
 
-void HawkesSumGaussians::set_em_max_iter(const ulong em_max_iter) {
+template <class T>
+void THawkesSumGaussians<T>::set_em_max_iter(const ulong em_max_iter) {
   if (em_max_iter <= 0) {
     TICK_ERROR("em_max_iter must be positive, received " << em_max_iter);
   }
   this->em_max_iter = em_max_iter;
 }
 
-double HawkesSumGaussians::get_max_mean_gaussian() const {
+template <class T>
+double THawkesSumGaussians<T>::get_max_mean_gaussian() const {
   return max_mean_gaussian;
 }
 
-void HawkesSumGaussians::set_max_mean_gaussian(const double max_mean_gaussian) {
+template <class T>
+void THawkesSumGaussians<T>::set_max_mean_gaussian(
+    const double max_mean_gaussian) {
   if (max_mean_gaussian <= 0) {
     TICK_ERROR("max_mean_gaussian must be positive, received "
                << max_mean_gaussian);
@@ -322,29 +515,37 @@ void HawkesSumGaussians::set_max_mean_gaussian(const double max_mean_gaussian) {
   weights_computed = false;
 }
 
-double HawkesSumGaussians::get_step_size() const { return step_size; }
+template <class T>
+double THawkesSumGaussians<T>::get_step_size() const { return step_size; }
 
-void HawkesSumGaussians::set_step_size(const double step_size) {
+template <class T>
+void THawkesSumGaussians<T>::set_step_size(const double step_size) {
   if (step_size <= 0) {
     TICK_ERROR("step_size must be positive, received " << step_size);
   }
   this->step_size = step_size;
 }
 
-double HawkesSumGaussians::get_strength_lasso() const { return strength_lasso; }
+template <class T>
+double THawkesSumGaussians<T>::get_strength_lasso() const {
+  return strength_lasso;
+}
 
-void HawkesSumGaussians::set_strength_lasso(const double strength_lasso) {
+template <class T>
+void THawkesSumGaussians<T>::set_strength_lasso(const double strength_lasso) {
   if (strength_lasso <= 0) {
     TICK_ERROR("strength_lasso must be positive, received " << strength_lasso);
   }
   this->strength_lasso = strength_lasso;
 }
 
-double HawkesSumGaussians::get_strength_grouplasso() const {
+template <class T>
+double THawkesSumGaussians<T>::get_strength_grouplasso() const {
   return strength_grouplasso;
 }
 
-void HawkesSumGaussians::set_strength_grouplasso(
+template <class T>
+void THawkesSumGaussians<T>::set_strength_grouplasso(
     const double strength_grouplasso) {
   if (strength_grouplasso <= 0) {
     TICK_ERROR("strength_grouplasso must be positive, received "
@@ -352,3 +553,22 @@ void HawkesSumGaussians::set_strength_grouplasso(
   }
   this->strength_grouplasso = strength_grouplasso;
 }
+
+template <class T>
+double THawkesSumGaussians<T>::get_n_std_truncation() const {
+  return n_std_truncation;
+}
+
+template <class T>
+void THawkesSumGaussians<T>::set_n_std_truncation(
+    const double n_std_truncation) {
+  if (n_std_truncation < 0) {
+    TICK_ERROR("n_std_truncation must be non negative, received "
+               << n_std_truncation);
+  }
+  this->n_std_truncation = n_std_truncation;
+  weights_computed = false;
+}
+
+template class DLL_PUBLIC THawkesSumGaussians<double>;
+template class DLL_PUBLIC THawkesSumGaussians<float>;
@@ -2,10 +2,21 @@
 
 #include "tick/hawkes/model/base/model_hawkes_loglik.h"
 
-ModelHawkesLogLik::ModelHawkesLogLik(const int max_n_threads)
+#include <algorithm>
+#include <numeric>
+
+namespace {
+// Minimal estimated cost of a chunk of the weights computation, below which
+// a (r, i, j) triplet is not split in time
+const ulong min_weights_chunk_cost = 1 << 14;
+}  // namespace
+
+template <class T>
+TModelHawkesLogLik<T>::TModelHawkesLogLik(const int max_n_threads)
     : ModelHawkesList(max_n_threads, 0) {}
 
-void ModelHawkesLogLik::incremental_set_data(
+template <class T>
+void TModelHawkesLogLik<T>::incremental_set_data(
     const SArrayDoublePtrList1D &timestamps, double end_time) {
   weights_computed = false;
   if (model_list.empty()) {
@@ -32,6 +43,7 @@ void ModelHawkesLogLik::incremental_set_data(
     (*n_jumps_per_node)[i] += timestamps[i]->size();
   }
   n_jumps_per_realization->append1(n_total_jumps);
+  compute_cum_n_jumps_per_realization();
 
   auto model = build_model(get_n_threads());
   model->set_data(timestamps, end_time);
@@ -41,23 +53,42 @@ void ModelHawkesLogLik::incremental_set_data(
   weights_computed = true;
 }
 
-void ModelHawkesLogLik::compute_weights() {
+template <class T>
+void TModelHawkesLogLik<T>::compute_weights() {
   if (!model_list.empty() && timestamps_list.size() != model_list.size()) {
     TICK_ERROR(
         "Cannot compute weights as timestamps have not been stored. "
         "Did you use incremental_fit?");
   }
+  compute_cum_n_jumps_per_realization();
+
   model_list =
-      std::vector<std::unique_ptr<ModelHawkesLogLikSingle> >(n_realizations);
+      std::vector<std::unique_ptr<TModelHawkesLogLikSingle<T> > >(
+          n_realizations);
 
   for (ulong r = 0; r < n_realizations; ++r) {
     model_list[r] = build_model(1);
     model_list[r]->set_data(timestamps_list[r], (*end_times)[r]);
     model_list[r]->allocate_weights();
+    model_list[r]->compute_cum_n_jumps_per_node();
   }
 
-  parallel_run(get_n_threads(), n_realizations * n_nodes,
-               &ModelHawkesLogLik::compute_weights_i_r, this);
+  // Weights are computed per (r, i, j) triplet, or per time chunk of a
+  // triplet, so that all threads can be used whatever n_nodes and
+  // n_realizations
+  WeightsSchedule schedule = schedule_weights(max_n_threads);
+  const ulong n_slices = schedule.slices.size() - 1;
+  const ulong n_triplets = schedule.triplets.size() - 1;
+
+  parallel_run(n_slices, n_slices, &TModelHawkesLogLik<T>::compute_weights_slice,
+               this, schedule);
+  parallel_run(max_n_threads, n_triplets,
+               &TModelHawkesLogLik<T>::carry_weights_triplet, this, schedule);
+  if (schedule.chunks.size() > n_triplets) {
+    parallel_run(n_slices, n_slices,
+                 &TModelHawkesLogLik<T>::add_carried_weights_slice, this,
+                 schedule);
+  }
 
   for (auto &model : model_list) {
     model->weights_computed = true;
@@ -65,40 +96,168 @@ void ModelHawkesLogLik::compute_weights() {
   weights_computed = true;
 }
 
-std::tuple<ulong, ulong> ModelHawkesLogLik::get_realization_node(ulong i_r) {
+template <class T>
+std::tuple<ulong, ulong> TModelHawkesLogLik<T>::get_realization_node(
+    ulong i_r) {
   const ulong r = static_cast<const ulong>(i_r / n_nodes);
   const ulong i = i_r % n_nodes;
   return std::make_tuple(r, i);
 }
 
-void ModelHawkesLogLik::compute_weights_i_r(const ulong i_r) {
-  ulong r, i;
-  std::tie(r, i) = get_realization_node(i_r);
-  model_list[r]->compute_weights_dim_i(i);
+template <class T>
+typename TModelHawkesLogLik<T>::WeightsSchedule
+TModelHawkesLogLik<T>::schedule_weights(const unsigned int n_threads) const {
+  WeightsSchedule schedule;
+
+  // A triplet (r, i, j) merges the jumps of nodes i and j of realization r
+  ulong total_cost = 0;
+  for (ulong r = 0; r < n_realizations; ++r) {
+    const ArrayULong &n_jumps_r = *model_list[r]->n_jumps_per_node;
+    total_cost += (2 * n_jumps_r.sum() + 1) * n_nodes;
+  }
+
+  // A few chunks per thread let the slices be balanced, but chunks must stay
+  // large enough for the carried state fix-up to remain negligible
+  const ulong chunk_cost = std::max<ulong>(
+      total_cost / (4 * n_threads), min_weights_chunk_cost);
+
+  std::vector<ulong> chunks_cost;
+  for (ulong r = 0; r < n_realizations; ++r) {
+    const ArrayULong &n_jumps_r = *model_list[r]->n_jumps_per_node;
+    for (ulong i = 0; i < n_nodes; ++i) {
+      const ulong n_k = n_jumps_r[i] + 1;
+      for (ulong j = 0; j < n_nodes; ++j) {
+        const ulong cost = n_k + n_jumps_r[j];
+        const ulong n_chunks =
+            std::min(n_k, std::max<ulong>(1, cost / chunk_cost));
+
+        schedule.triplets.push_back(schedule.chunks.size());
+        for (ulong c = 0; c < n_chunks; ++c) {
+          schedule.chunks.push_back(
+              {{r, i, j, (c * n_k) / n_chunks, ((c + 1) * n_k) / n_chunks}});
+          chunks_cost.push_back(cost / n_chunks);
+        }
+      }
+    }
+  }
+  const ulong n_chunks = schedule.chunks.size();
+  schedule.triplets.push_back(n_chunks);
+
+  // Contiguous slices of chunks of similar total cost, one per thread
+  const ulong n_slices = std::min<ulong>(n_threads, n_chunks);
+  const ulong sum_cost =
+      std::accumulate(chunks_cost.begin(), chunks_cost.end(), ulong{0});
+  schedule.slices.push_back(0);
+  ulong cumulated_cost = 0;
+  for (ulong c = 0; c < n_chunks; ++c) {
+    cumulated_cost += chunks_cost[c];
+    const ulong n_remaining_chunks = n_chunks - c - 1;
+    const ulong n_remaining_slices = n_slices - schedule.slices.size();
+    if (n_remaining_slices > 0 &&
+        (cumulated_cost * n_slices >= schedule.slices.size() * sum_cost ||
+         n_remaining_chunks == n_remaining_slices)) {
+      schedule.slices.push_back(c + 1);
+    }
+  }
+  schedule.slices.push_back(n_chunks);
+
+  const ulong n_decays = model_list[0]->get_n_kernel_decays();
+  schedule.chunks_sum_G = ArrayDouble2d(n_chunks, n_decays);
+  schedule.chunks_carry = ArrayDouble2d(n_chunks, n_decays);
+  schedule.chunks_carry.init_to_zero();
+  return schedule;
+}
+
+template <class T>
+void TModelHawkesLogLik<T>::compute_weights_slice(const ulong slice,
+                                                  WeightsSchedule &schedule) {
+  for (ulong c = schedule.slices[slice]; c < schedule.slices[slice + 1]; ++c) {
+    const std::array<ulong, 5> &chunk = schedule.chunks[c];
+    ArrayDouble sum_G_c = view_row(schedule.chunks_sum_G, c);
+    model_list[chunk[0]]->compute_weights_dim_i_j(chunk[1], chunk[2], chunk[3],
+                                                  chunk[4], sum_G_c);
+  }
+}
+
+template <class T>
+void TModelHawkesLogLik<T>::carry_weights_triplet(const ulong triplet,
+                                                  WeightsSchedule &schedule) {
+  const ulong first_chunk = schedule.triplets[triplet];
+  const ulong last_chunk = schedule.triplets[triplet + 1];
+  const std::array<ulong, 5> &first = schedule.chunks[first_chunk];
+  TModelHawkesLogLikSingle<T> &model = *model_list[first[0]];
+  const ulong i = first[1], j = first[2];
+  const ulong n_decays = model.get_n_kernel_decays();
+  Array2d<T> g_i = view(model.g[i]);
+
+  ArrayDouble sum_G_i_j(n_decays);
+  sum_G_i_j.init_to_zero();
+  for (ulong c = first_chunk; c < last_chunk; ++c) {
+    const ulong k_start = schedule.chunks[c][3];
+    const ulong k_end = schedule.chunks[c][4];
+    // Decay of the state from t_i_(k_start - 1) to t_i_(k_end - 1)
+    const double elapsed = k_start > 0 ? model.get_time_i_k(i, k_end - 1) -
+                                             model.get_time_i_k(i, k_start - 1)
+                                       : 0;
+    for (ulong u = 0; u < n_decays; ++u) {
+      const double decay = model.get_kernel_decay(u);
+      const double carry = schedule.chunks_carry(c, u);
+      const double ebt = std::exp(-decay * elapsed);
+      sum_G_i_j[u] += schedule.chunks_sum_G(c, u);
+      if (carry != 0) sum_G_i_j[u] += carry * (1 - ebt) / decay;
+
+      if (c + 1 < last_chunk) {
+        schedule.chunks_carry(c + 1, u) =
+            g_i[(k_end - 1) * n_nodes * n_decays + j * n_decays + u] +
+            carry * ebt;
+      }
+    }
+  }
+
+  Array<T> sum_G_i = view(model.sum_G[i]);
+  for (ulong u = 0; u < n_decays; ++u) {
+    sum_G_i[j * n_decays + u] = sum_G_i_j[u];
+  }
 }
 
-double ModelHawkesLogLik::loss_i_r(const ulong i_r, const ArrayDouble &coeffs) {
+template <class T>
+void TModelHawkesLogLik<T>::add_carried_weights_slice(
+    const ulong slice, WeightsSchedule &schedule) {
+  for (ulong c = schedule.slices[slice]; c < schedule.slices[slice + 1]; ++c) {
+    const std::array<ulong, 5> &chunk = schedule.chunks[c];
+    if (chunk[3] == 0) continue;
+    ArrayDouble carry = view_row(schedule.chunks_carry, c);
+    model_list[chunk[0]]->add_carried_weights_dim_i_j(chunk[1], chunk[2],
+                                                      chunk[3], chunk[4], carry);
+  }
+}
+
+template <class T>
+double TModelHawkesLogLik<T>::loss_i_r(const ulong i_r, const ArrayDouble &coeffs) {
   ulong r, i;
   std::tie(r, i) = get_realization_node(i_r);
 
   return model_list[r]->loss_dim_i(i, coeffs);
 }
 
-double ModelHawkesLogLik::loss(const ArrayDouble &coeffs) {
+template <class T>
+double TModelHawkesLogLik<T>::loss(const ArrayDouble &coeffs) {
   if (!weights_computed) compute_weights();
   return parallel_map_additive_reduce(get_n_threads(), n_realizations * n_nodes,
-                                      &ModelHawkesLogLik::loss_i_r, this,
+                                      &TModelHawkesLogLik<T>::loss_i_r, this,
                                       coeffs) /
          get_n_total_jumps();
 }
 
-double ModelHawkesLogLik::loss_i(const ulong i, const ArrayDouble &coeffs) {
+template <class T>
+double TModelHawkesLogLik<T>::loss_i(const ulong i, const ArrayDouble &coeffs) {
   if (!weights_computed) compute_weights();
   const auto r_i = sampled_i_to_realization(i);
   return model_list[r_i.first]->loss_i(r_i.second, coeffs);
 }
 
-void ModelHawkesLogLik::grad_i_r(const ulong i_r, ArrayDouble &out,
+template <class T>
+void TModelHawkesLogLik<T>::grad_i_r(const ulong i_r, ArrayDouble &out,
                                  const ArrayDouble &coeffs) {
   ulong r, i;
   std::tie(r, i) = get_realization_node(i_r);
@@ -109,24 +268,44 @@ void ModelHawkesLogLik::grad_i_r(const ulong i_r, ArrayDouble &out,
   out.mult_incr(tmp_grad_i, 1.);
 }
 
-void ModelHawkesLogLik::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
+template <class T>
+void TModelHawkesLogLik<T>::get_grad_i_support(const ulong i,
+                                               std::vector<ulong> &support) {
+  if (!weights_computed) compute_weights();
+  const auto r_i = sampled_i_to_realization(i);
+  model_list[r_i.first]->get_grad_i_support(r_i.second, support);
+}
+
+template <class T>
+void TModelHawkesLogLik<T>::grad_i_sparse(const ulong i,
+                                          const ArrayDouble &coeffs,
+                                          ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  const auto r_i = sampled_i_to_realization(i);
+  model_list[r_i.first]->grad_i_sparse(r_i.second, coeffs, out);
+}
+
+template <class T>
+void TModelHawkesLogLik<T>::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
   if (!weights_computed) compute_weights();
   out.init_to_zero();
   parallel_map_array<ArrayDouble>(
       get_n_threads(), n_realizations * n_nodes,
       [](ArrayDouble &r, const ArrayDouble &s) { r.mult_incr(s, 1.0); },
-      &ModelHawkesLogLik::grad_i_r, this, out, coeffs);
+      &TModelHawkesLogLik<T>::grad_i_r, this, out, coeffs);
   out /= get_n_total_jumps();
 }
 
-void ModelHawkesLogLik::grad_i(const ulong i, const ArrayDouble &coeffs,
+template <class T>
+void TModelHawkesLogLik<T>::grad_i(const ulong i, const ArrayDouble &coeffs,
                                ArrayDouble &out) {
   if (!weights_computed) compute_weights();
   const auto r_i = sampled_i_to_realization(i);
   model_list[r_i.first]->grad_i(r_i.second, coeffs, out);
 }
 
-double ModelHawkesLogLik::loss_and_grad(const ArrayDouble &coeffs,
+template <class T>
+double TModelHawkesLogLik<T>::loss_and_grad(const ArrayDouble &coeffs,
                                         ArrayDouble &out) {
   // TODO(svp) create parallel_map_array_reduce_result
   // In order to sum output (losses) and keep reducing gradients
@@ -135,7 +314,8 @@ double ModelHawkesLogLik::loss_and_grad(const ArrayDouble &coeffs,
   return loss(coeffs);
 }
 
-double ModelHawkesLogLik::hessian_norm_i_r(const ulong i_r,
+template <class T>
+double TModelHawkesLogLik<T>::hessian_norm_i_r(const ulong i_r,
                                            const ArrayDouble &coeffs,
                                            const ArrayDouble &vector) {
   ulong r, i;
@@ -144,16 +324,18 @@ double ModelHawkesLogLik::hessian_norm_i_r(const ulong i_r,
   return model_list[r]->hessian_norm_dim_i(i, coeffs, vector);
 }
 
-double ModelHawkesLogLik::hessian_norm(const ArrayDouble &coeffs,
+template <class T>
+double TModelHawkesLogLik<T>::hessian_norm(const ArrayDouble &coeffs,
                                        const ArrayDouble &vector) {
   if (!weights_computed) compute_weights();
   return parallel_map_additive_reduce(get_n_threads(), n_realizations * n_nodes,
-                                      &ModelHawkesLogLik::hessian_norm_i_r,
+                                      &TModelHawkesLogLik<T>::hessian_norm_i_r,
                                       this, coeffs, vector) /
          get_n_total_jumps();
 }
 
-void ModelHawkesLogLik::hessian_i_r(const ulong i_r, const ArrayDouble &coeffs,
+template <class T>
+void TModelHawkesLogLik<T>::hessian_i_r(const ulong i_r, const ArrayDouble &coeffs,
                                     ArrayDouble &out) {
   ulong r, i;
   std::tie(r, i) = get_realization_node(i_r);
@@ -161,27 +343,76 @@ void ModelHawkesLogLik::hessian_i_r(const ulong i_r, const ArrayDouble &coeffs,
   model_list[r]->hessian_i(i, coeffs, out);
 }
 
-void ModelHawkesLogLik::hessian(const ArrayDouble &coeffs, ArrayDouble &out) {
+template <class T>
+void TModelHawkesLogLik<T>::hessian(const ArrayDouble &coeffs, ArrayDouble &out) {
   if (!weights_computed) compute_weights();
   parallel_run(get_n_threads(), n_realizations * n_nodes,
-               &ModelHawkesLogLik::hessian_i_r, this, coeffs, out);
+               &TModelHawkesLogLik<T>::hessian_i_r, this, coeffs, out);
   out /= get_n_total_jumps();
 }
 
-std::pair<ulong, ulong> ModelHawkesLogLik::sampled_i_to_realization(
-    const ulong sampled_i) {
-  ulong cum_n_jumps = 0;
-  for (ulong r = 0; r < n_realizations; r++) {
-    cum_n_jumps += (*n_jumps_per_realization)[r];
-    if (sampled_i < cum_n_jumps) {
-      const ulong i_in_realization_r =
-          sampled_i - cum_n_jumps + (*n_jumps_per_realization)[r];
-      return std::pair<ulong, ulong>(r, i_in_realization_r);
+template <class T>
+void TModelHawkesLogLik<T>::residuals_i_r(const ulong i_r,
+                                          const ArrayDouble &coeffs,
+                                          SArrayDoublePtrList2D &residuals) {
+  ulong r, i;
+  std::tie(r, i) = get_realization_node(i_r);
+
+  model_list[r]->compute_residuals_dim_i(i, coeffs, residuals[r]);
+}
+
+template <class T>
+SArrayDoublePtrList2D TModelHawkesLogLik<T>::get_residuals(
+    const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  if (coeffs.size() != get_n_coeffs()) {
+    TICK_ERROR("coeffs must be an array of size " << get_n_coeffs()
+                                                  << " but has size "
+                                                  << coeffs.size());
+  }
+
+  SArrayDoublePtrList2D residuals(n_realizations);
+  for (ulong r = 0; r < n_realizations; ++r) {
+    const ArrayULong &n_jumps_r = *model_list[r]->n_jumps_per_node;
+    residuals[r] = SArrayDoublePtrList1D(n_nodes);
+    for (ulong i = 0; i < n_nodes; ++i) {
+      residuals[r][i] = SArrayDouble::new_ptr(n_jumps_r[i]);
     }
   }
-  TICK_ERROR("sampled_i out of range");
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &TModelHawkesLogLik<T>::residuals_i_r, this, coeffs,
+               residuals);
+  return residuals;
 }
 
-ulong ModelHawkesLogLik::get_n_coeffs() const {
+template <class T>
+std::pair<ulong, ulong> TModelHawkesLogLik<T>::sampled_i_to_realization(
+    const ulong sampled_i) {
+  if (sampled_i >= cum_n_jumps_per_realization[n_realizations])
+    TICK_ERROR("sampled_i out of range");
+
+  const ulong *cum_begin = cum_n_jumps_per_realization.data();
+  const ulong *cum_end = cum_begin + n_realizations + 1;
+  const ulong r =
+      std::upper_bound(cum_begin, cum_end, sampled_i) - cum_begin - 1;
+  return std::pair<ulong, ulong>(r,
+                                 sampled_i - cum_n_jumps_per_realization[r]);
+}
+
+template <class T>
+void TModelHawkesLogLik<T>::compute_cum_n_jumps_per_realization() {
+  cum_n_jumps_per_realization = ArrayULong(n_realizations + 1);
+  cum_n_jumps_per_realization[0] = 0;
+  for (ulong r = 0; r < n_realizations; ++r) {
+    cum_n_jumps_per_realization[r + 1] =
+        cum_n_jumps_per_realization[r] + (*n_jumps_per_realization)[r];
+  }
+}
+
+template <class T>
+ulong TModelHawkesLogLik<T>::get_n_coeffs() const {
   return n_nodes + n_nodes * n_nodes;
 }
+
+template class DLL_PUBLIC TModelHawkesLogLik<double>;
+template class DLL_PUBLIC TModelHawkesLogLik<float>;
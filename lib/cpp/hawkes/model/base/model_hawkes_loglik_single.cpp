@@ -2,34 +2,182 @@
 
 #include "tick/hawkes/model/base/model_hawkes_loglik_single.h"
 
-ModelHawkesLogLikSingle::ModelHawkesLogLikSingle(const int max_n_threads)
+#include <algorithm>
+
+namespace {
+
+// Weights may be stored in single precision, while coefficients, gradients and
+// reductions are always kept in double
+template <class T>
+double dot_weights(const ArrayDouble &coeffs, const Array<T> &weights) {
+  double result = 0;
+  for (ulong j = 0; j < coeffs.size(); ++j) result += coeffs[j] * weights[j];
+  return result;
+}
+
+double dot_weights(const ArrayDouble &coeffs, const ArrayDouble &weights) {
+  return coeffs.dot(weights);
+}
+
+template <class T>
+void mult_incr_weights(ArrayDouble &out, const Array<T> &weights,
+                       const double factor) {
+  for (ulong j = 0; j < out.size(); ++j) out[j] += factor * weights[j];
+}
+
+void mult_incr_weights(ArrayDouble &out, const ArrayDouble &weights,
+                       const double factor) {
+  out.mult_incr(weights, factor);
+}
+
+}  // namespace
+
+template <class T>
+TModelHawkesLogLikSingle<T>::TModelHawkesLogLikSingle(const int max_n_threads)
     : ModelHawkesSingle(max_n_threads, 0) {}
 
-void ModelHawkesLogLikSingle::compute_weights() {
+template <class T>
+void TModelHawkesLogLikSingle<T>::compute_weights() {
   allocate_weights();
+  compute_cum_n_jumps_per_node();
   parallel_run(get_n_threads(), n_nodes,
-               &ModelHawkesLogLikSingle::compute_weights_dim_i, this);
+               &TModelHawkesLogLikSingle<T>::compute_weights_dim_i, this);
   weights_computed = true;
 }
 
-void ModelHawkesLogLikSingle::allocate_weights() {
+template <class T>
+void TModelHawkesLogLikSingle<T>::allocate_weights() {
   TICK_CLASS_DOES_NOT_IMPLEMENT("");
 }
 
-void ModelHawkesLogLikSingle::compute_weights_dim_i(const ulong i) {
-  TICK_CLASS_DOES_NOT_IMPLEMENT("");
+template <class T>
+void TModelHawkesLogLikSingle<T>::compute_weights_dim_i(const ulong i) {
+  const ulong n_decays = get_n_kernel_decays();
+  Array<T> sum_G_i = view(sum_G[i]);
+
+  ArrayDouble sum_G_i_j(n_decays);
+  for (ulong j = 0; j < n_nodes; j++) {
+    compute_weights_dim_i_j(i, j, 0, (*n_jumps_per_node)[i] + 1, sum_G_i_j);
+    for (ulong u = 0; u < n_decays; ++u) {
+      sum_G_i[j * n_decays + u] = sum_G_i_j[u];
+    }
+  }
+}
+
+template <class T>
+void TModelHawkesLogLikSingle<T>::compute_weights_dim_i_j(
+    const ulong i, const ulong j, const ulong k_start, const ulong k_end,
+    ArrayDouble &sum_G_i_j) {
+  const ArrayDouble t_j = view(*timestamps[j]);
+  Array2d<T> g_i = view(g[i]);
+  Array2d<T> G_i = view(G[i]);
+
+  const ulong n_jumps_i = (*n_jumps_per_node)[i];
+  const ulong n_jumps_j = (*n_jumps_per_node)[j];
+  const ulong n_decays = get_n_kernel_decays();
+
+  auto get_index = [=](ulong k, ulong u) {
+    return n_nodes * n_decays * k + n_decays * j + u;
+  };
+
+  // Jumps of component j anterior to t_i_(k_start - 1) are accounted for by
+  // the carried state
+  ulong ij = 0;
+  if (k_start > 0) {
+    ij = std::lower_bound(t_j.data(), t_j.data() + n_jumps_j,
+                          get_time_i_k(i, k_start - 1)) -
+         t_j.data();
+  }
+
+  // The recursion is carried in double whatever the storage type
+  ArrayDouble g_i_k_j(n_decays);
+  ArrayDouble G_i_k_j(n_decays);
+  g_i_k_j.init_to_zero();
+  sum_G_i_j.init_to_zero();
+
+  for (ulong k = k_start; k < k_end; k++) {
+    const double t_i_k = get_time_i_k(i, k);
+
+    for (ulong u = 0; u < n_decays; ++u) {
+      const double decay = get_kernel_decay(u);
+      if (k > k_start) {
+        const double ebt = std::exp(-decay * (t_i_k - get_time_i_k(i, k - 1)));
+
+        G_i_k_j[u] = g_i_k_j[u] * (1 - ebt) / decay;
+        g_i_k_j[u] *= ebt;
+      } else {
+        G_i_k_j[u] = 0;
+      }
+    }
+
+    while ((ij < n_jumps_j) && (t_j[ij] < t_i_k)) {
+      for (ulong u = 0; u < n_decays; ++u) {
+        const double decay = get_kernel_decay(u);
+        const double ebt = std::exp(-decay * (t_i_k - t_j[ij]));
+        g_i_k_j[u] += decay * ebt;
+        G_i_k_j[u] += 1 - ebt;
+      }
+      ij++;
+    }
+
+    for (ulong u = 0; u < n_decays; ++u) {
+      if (k < n_jumps_i) g_i[get_index(k, u)] = g_i_k_j[u];
+      G_i[get_index(k, u)] = G_i_k_j[u];
+      sum_G_i_j[u] += G_i_k_j[u];
+    }
+  }
+}
+
+template <class T>
+void TModelHawkesLogLikSingle<T>::add_carried_weights_dim_i_j(
+    const ulong i, const ulong j, const ulong k_start, const ulong k_end,
+    const ArrayDouble &carry) {
+  if (k_start == 0) TICK_ERROR("No state can be carried before first jump");
+
+  Array2d<T> g_i = view(g[i]);
+  Array2d<T> G_i = view(G[i]);
+
+  const ulong n_jumps_i = (*n_jumps_per_node)[i];
+  const ulong n_decays = get_n_kernel_decays();
+  const double t_i_start = get_time_i_k(i, k_start - 1);
+
+  for (ulong u = 0; u < n_decays; ++u) {
+    if (carry[u] == 0) continue;
+    const double decay = get_kernel_decay(u);
+    // The carried state simply decays from t_i_(k_start - 1)
+    double ebt_previous = 1;
+    for (ulong k = k_start; k < k_end; k++) {
+      const double ebt = std::exp(-decay * (get_time_i_k(i, k) - t_i_start));
+      const ulong index = n_nodes * n_decays * k + n_decays * j + u;
+      if (k < n_jumps_i) g_i[index] += carry[u] * ebt;
+      G_i[index] += carry[u] * (ebt_previous - ebt) / decay;
+      ebt_previous = ebt;
+    }
+  }
+}
+
+template <class T>
+void TModelHawkesLogLikSingle<T>::compute_cum_n_jumps_per_node() {
+  cum_n_jumps_per_node = ArrayULong(n_nodes + 1);
+  cum_n_jumps_per_node[0] = 0;
+  for (ulong d = 0; d < n_nodes; ++d) {
+    cum_n_jumps_per_node[d + 1] =
+        cum_n_jumps_per_node[d] + (*n_jumps_per_node)[d];
+  }
 }
 
-double ModelHawkesLogLikSingle::loss(const ArrayDouble &coeffs) {
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss(const ArrayDouble &coeffs) {
   if (!weights_computed) compute_weights();
 
   const double loss = parallel_map_additive_reduce(
-      get_n_threads(), n_nodes, &ModelHawkesLogLikSingle::loss_dim_i, this,
+      get_n_threads(), n_nodes, &TModelHawkesLogLikSingle<T>::loss_dim_i, this,
       coeffs);
   return loss / n_total_jumps;
 }
 
-double ModelHawkesLogLikSingle::loss_i(const ulong sampled_i,
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss_i(const ulong sampled_i,
                                        const ArrayDouble &coeffs) {
   if (!weights_computed) compute_weights();
   ulong i;
@@ -39,19 +187,21 @@ double ModelHawkesLogLikSingle::loss_i(const ulong sampled_i,
   return loss_i_k(i, k, coeffs);
 }
 
-void ModelHawkesLogLikSingle::grad(const ArrayDouble &coeffs,
+template <class T>
+void TModelHawkesLogLikSingle<T>::grad(const ArrayDouble &coeffs,
                                    ArrayDouble &out) {
   if (!weights_computed) compute_weights();
   out.fill(0);
 
   // This allows to run in a multithreaded environment the computation of each
   // component
-  parallel_run(get_n_threads(), n_nodes, &ModelHawkesLogLikSingle::grad_dim_i,
+  parallel_run(get_n_threads(), n_nodes, &TModelHawkesLogLikSingle<T>::grad_dim_i,
                this, coeffs, out);
   out /= n_total_jumps;
 }
 
-void ModelHawkesLogLikSingle::grad_i(const ulong sampled_i,
+template <class T>
+void TModelHawkesLogLikSingle<T>::grad_i(const ulong sampled_i,
                                      const ArrayDouble &coeffs,
                                      ArrayDouble &out) {
   if (!weights_computed) compute_weights();
@@ -66,58 +216,118 @@ void ModelHawkesLogLikSingle::grad_i(const ulong sampled_i,
   grad_i_k(i, k, coeffs, out);
 }
 
-double ModelHawkesLogLikSingle::loss_and_grad(const ArrayDouble &coeffs,
+template <class T>
+void TModelHawkesLogLikSingle<T>::get_grad_i_support(
+    const ulong sampled_i, std::vector<ulong> &support) {
+  if (!weights_computed) compute_weights();
+
+  ulong i;
+  ulong k;
+  sampled_i_to_index(sampled_i, &i, &k);
+
+  support.clear();
+  support.push_back(i);
+  for (ulong j = get_alpha_i_first_index(i); j < get_alpha_i_last_index(i);
+       ++j) {
+    support.push_back(j);
+  }
+}
+
+template <class T>
+void TModelHawkesLogLikSingle<T>::grad_i_sparse(const ulong sampled_i,
+                                                const ArrayDouble &coeffs,
+                                                ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+
+  ulong i;
+  ulong k;
+  sampled_i_to_index(sampled_i, &i, &k);
+
+  // set grad to zero on its support only
+  out[i] = 0;
+  view(out, get_alpha_i_first_index(i), get_alpha_i_last_index(i))
+      .init_to_zero();
+
+  grad_i_k(i, k, coeffs, out);
+}
+
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss_and_grad(const ArrayDouble &coeffs,
                                               ArrayDouble &out) {
   if (!weights_computed) compute_weights();
   out.fill(0);
 
   const double loss = parallel_map_additive_reduce(
-      get_n_threads(), n_nodes, &ModelHawkesLogLikSingle::loss_and_grad_dim_i,
+      get_n_threads(), n_nodes, &TModelHawkesLogLikSingle<T>::loss_and_grad_dim_i,
       this, coeffs, out);
   out /= n_total_jumps;
   return loss / n_total_jumps;
 }
 
-double ModelHawkesLogLikSingle::hessian_norm(const ArrayDouble &coeffs,
+template <class T>
+double TModelHawkesLogLikSingle<T>::hessian_norm(const ArrayDouble &coeffs,
                                              const ArrayDouble &vector) {
   if (!weights_computed) compute_weights();
 
   const double norm_sum = parallel_map_additive_reduce(
-      get_n_threads(), n_nodes, &ModelHawkesLogLikSingle::hessian_norm_dim_i,
+      get_n_threads(), n_nodes, &TModelHawkesLogLikSingle<T>::hessian_norm_dim_i,
       this, coeffs, vector);
 
   return norm_sum / n_total_jumps;
 }
 
-void ModelHawkesLogLikSingle::hessian(const ArrayDouble &coeffs,
+template <class T>
+void TModelHawkesLogLikSingle<T>::hessian(const ArrayDouble &coeffs,
                                       ArrayDouble &out) {
   if (!weights_computed) compute_weights();
 
   // This allows to run in a multithreaded environment the computation of each
   // component
-  parallel_run(get_n_threads(), n_nodes, &ModelHawkesLogLikSingle::hessian_i,
+  parallel_run(get_n_threads(), n_nodes, &TModelHawkesLogLikSingle<T>::hessian_i,
                this, coeffs, out);
   out /= n_total_jumps;
 }
 
+template <class T>
+SArrayDoublePtrList1D TModelHawkesLogLikSingle<T>::get_residuals(
+    const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  if (coeffs.size() != get_n_coeffs()) {
+    TICK_ERROR("coeffs must be an array of size " << get_n_coeffs()
+                                                  << " but has size "
+                                                  << coeffs.size());
+  }
+
+  SArrayDoublePtrList1D residuals(n_nodes);
+  for (ulong i = 0; i < n_nodes; ++i) {
+    residuals[i] = SArrayDouble::new_ptr((*n_jumps_per_node)[i]);
+  }
+  parallel_run(get_n_threads(), n_nodes,
+               &TModelHawkesLogLikSingle<T>::compute_residuals_dim_i, this,
+               coeffs, residuals);
+  return residuals;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                    PRIVATE METHODS
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ModelHawkesLogLikSingle::sampled_i_to_index(const ulong sampled_i,
+template <class T>
+void TModelHawkesLogLikSingle<T>::sampled_i_to_index(const ulong sampled_i,
                                                  ulong *i, ulong *k) {
-  ulong cum_N_i = 0;
-  for (ulong d = 0; d < n_nodes; d++) {
-    cum_N_i += (*n_jumps_per_node)[d];
-    if (sampled_i < cum_N_i) {
-      *i = d;
-      *k = sampled_i - cum_N_i + (*n_jumps_per_node)[d];
-      break;
-    }
-  }
+  if (sampled_i >= n_total_jumps) TICK_ERROR("sampled_i out of range");
+
+  // First node whose cumulated number of jumps exceeds sampled_i, nodes with
+  // no jumps are skipped as they do not increase the cumulated number
+  const ulong *cum_begin = cum_n_jumps_per_node.data();
+  const ulong *cum_end = cum_begin + n_nodes + 1;
+  const ulong d = std::upper_bound(cum_begin, cum_end, sampled_i) - cum_begin - 1;
+  *i = d;
+  *k = sampled_i - cum_n_jumps_per_node[d];
 }
 
-double ModelHawkesLogLikSingle::loss_dim_i(const ulong i,
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss_dim_i(const ulong i,
                                            const ArrayDouble &coeffs) {
   const double mu_i = coeffs[i];
   const ArrayDouble alpha_i =
@@ -127,10 +337,10 @@ double ModelHawkesLogLikSingle::loss_dim_i(const ulong i,
   loss += end_time * mu_i;
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
+    const Array<T> g_i_k = view_row(g[i], k);
 
     double s = mu_i;
-    s += alpha_i.dot(g_i_k);
+    s += dot_weights(alpha_i, g_i_k);
     if (s <= 0) {
       TICK_ERROR(
           "The sum of the influence on someone cannot be negative. "
@@ -140,19 +350,20 @@ double ModelHawkesLogLikSingle::loss_dim_i(const ulong i,
     loss -= log(s);
   }
 
-  loss += alpha_i.dot(sum_G[i]);
+  loss += dot_weights(alpha_i, sum_G[i]);
   return loss;
 }
 
-double ModelHawkesLogLikSingle::loss_i_k(const ulong i, const ulong k,
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss_i_k(const ulong i, const ulong k,
                                          const ArrayDouble &coeffs) {
   const double mu_i = coeffs[i];
   const ArrayDouble alpha_i =
       view(coeffs, get_alpha_i_first_index(i), get_alpha_i_last_index(i));
   double loss = 0;
 
-  const ArrayDouble g_i_k = view_row(g[i], k);
-  const ArrayDouble G_i_k = view_row(G[i], k);
+  const Array<T> g_i_k = view_row(g[i], k);
+  const Array<T> G_i_k = view_row(G[i], k);
 
   // Both are correct, just a question of point of view
   const double t_i_k =
@@ -162,7 +373,7 @@ double ModelHawkesLogLikSingle::loss_i_k(const ulong i, const ulong k,
   //  loss += end_time * (mu[i] - 1) / (*n_jumps_per_node)[i];
 
   double s = mu_i;
-  s += alpha_i.dot(g_i_k);
+  s += dot_weights(alpha_i, g_i_k);
 
   if (s <= 0) {
     TICK_ERROR(
@@ -172,14 +383,15 @@ double ModelHawkesLogLikSingle::loss_i_k(const ulong i, const ulong k,
   }
   loss -= log(s);
 
-  loss += alpha_i.dot(G_i_k);
+  loss += dot_weights(alpha_i, G_i_k);
   if (k == (*n_jumps_per_node)[i] - 1)
-    loss += alpha_i.dot(view_row(G[i], k + 1));
+    loss += dot_weights(alpha_i, view_row(G[i], k + 1));
 
   return loss;
 }
 
-void ModelHawkesLogLikSingle::grad_dim_i(const ulong i,
+template <class T>
+void TModelHawkesLogLikSingle<T>::grad_dim_i(const ulong i,
                                          const ArrayDouble &coeffs,
                                          ArrayDouble &out) {
   const double mu_i = coeffs[i];
@@ -193,18 +405,19 @@ void ModelHawkesLogLikSingle::grad_dim_i(const ulong i,
   grad_mu_i += end_time;
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
+    const Array<T> g_i_k = view_row(g[i], k);
     double s = mu_i;
-    s += alpha_i.dot(g_i_k);
+    s += dot_weights(alpha_i, g_i_k);
 
     grad_mu_i -= 1. / s;
-    grad_alpha_i.mult_incr(g_i_k, -1. / s);
+    mult_incr_weights(grad_alpha_i, g_i_k, -1. / s);
   }
 
-  grad_alpha_i.mult_incr(sum_G[i], 1);
+  mult_incr_weights(grad_alpha_i, sum_G[i], 1);
 }
 
-void ModelHawkesLogLikSingle::grad_i_k(const ulong i, const ulong k,
+template <class T>
+void TModelHawkesLogLikSingle<T>::grad_i_k(const ulong i, const ulong k,
                                        const ArrayDouble &coeffs,
                                        ArrayDouble &out) {
   const double mu_i = coeffs[i];
@@ -215,8 +428,8 @@ void ModelHawkesLogLikSingle::grad_i_k(const ulong i, const ulong k,
   ArrayDouble grad_alpha_i =
       view(out, get_alpha_i_first_index(i), get_alpha_i_last_index(i));
 
-  const ArrayDouble g_i_k = view_row(g[i], k);
-  const ArrayDouble G_i_k = view_row(G[i], k);
+  const Array<T> g_i_k = view_row(g[i], k);
+  const Array<T> G_i_k = view_row(G[i], k);
 
   // Both are correct, just a question of point of view
   const double t_i_k =
@@ -226,17 +439,18 @@ void ModelHawkesLogLikSingle::grad_i_k(const ulong i, const ulong k,
   //  grad_mu[i] += end_time / (*n_jumps_per_node)[i];
 
   double s = mu_i;
-  s += alpha_i.dot(g_i_k);
+  s += dot_weights(alpha_i, g_i_k);
 
   grad_mu_i -= 1. / s;
-  grad_alpha_i.mult_incr(g_i_k, -1. / s);
-  grad_alpha_i.mult_incr(G_i_k, 1.);
+  mult_incr_weights(grad_alpha_i, g_i_k, -1. / s);
+  mult_incr_weights(grad_alpha_i, G_i_k, 1.);
 
   if (k == (*n_jumps_per_node)[i] - 1)
-    grad_alpha_i.mult_incr(view_row(G[i], k + 1), 1.);
+    mult_incr_weights(grad_alpha_i, view_row(G[i], k + 1), 1.);
 }
 
-double ModelHawkesLogLikSingle::loss_and_grad_dim_i(const ulong i,
+template <class T>
+double TModelHawkesLogLikSingle<T>::loss_and_grad_dim_i(const ulong i,
                                                     const ArrayDouble &coeffs,
                                                     ArrayDouble &out) {
   const double mu_i = coeffs[i];
@@ -252,10 +466,10 @@ double ModelHawkesLogLikSingle::loss_and_grad_dim_i(const ulong i,
   grad_mu_i += end_time;
   loss += end_time * mu_i;
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
+    const Array<T> g_i_k = view_row(g[i], k);
 
     double s = mu_i;
-    s += alpha_i.dot(g_i_k);
+    s += dot_weights(alpha_i, g_i_k);
 
     if (s <= 0) {
       TICK_ERROR(
@@ -266,16 +480,17 @@ double ModelHawkesLogLikSingle::loss_and_grad_dim_i(const ulong i,
     loss -= log(s);
     grad_mu_i -= 1. / s;
 
-    grad_alpha_i.mult_incr(g_i_k, -1. / s);
+    mult_incr_weights(grad_alpha_i, g_i_k, -1. / s);
   }
 
-  loss += alpha_i.dot(sum_G[i]);
-  grad_alpha_i.mult_incr(sum_G[i], 1);
+  loss += dot_weights(alpha_i, sum_G[i]);
+  mult_incr_weights(grad_alpha_i, sum_G[i], 1);
 
   return loss;
 }
 
-double ModelHawkesLogLikSingle::hessian_norm_dim_i(const ulong i,
+template <class T>
+double TModelHawkesLogLikSingle<T>::hessian_norm_dim_i(const ulong i,
                                                    const ArrayDouble &coeffs,
                                                    const ArrayDouble &vector) {
   const double mu_i = coeffs[i];
@@ -289,13 +504,13 @@ double ModelHawkesLogLikSingle::hessian_norm_dim_i(const ulong i,
   double hess_norm = 0;
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
+    const Array<T> g_i_k = view_row(g[i], k);
 
     double S = d_mu_i;
-    S += d_alpha_i.dot(g_i_k);
+    S += dot_weights(d_alpha_i, g_i_k);
 
     double s = mu_i;
-    s += alpha_i.dot(g_i_k);
+    s += dot_weights(alpha_i, g_i_k);
 
     double tmp = S / s;
     hess_norm += tmp * tmp;
@@ -303,7 +518,8 @@ double ModelHawkesLogLikSingle::hessian_norm_dim_i(const ulong i,
   return hess_norm;
 }
 
-void ModelHawkesLogLikSingle::hessian_i(const ulong i,
+template <class T>
+void TModelHawkesLogLikSingle<T>::hessian_i(const ulong i,
                                         const ArrayDouble &coeffs,
                                         ArrayDouble &out) {
   if (!weights_computed)
@@ -321,10 +537,10 @@ void ModelHawkesLogLikSingle::hessian_i(const ulong i,
   const ulong block_start = (n_nodes + i * n_alpha_i) * (n_alpha_i + 1);
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
+    const Array<T> g_i_k = view_row(g[i], k);
 
     double s = mu_i;
-    s += alpha_i.dot(g_i_k);
+    s += dot_weights(alpha_i, g_i_k);
     const double s_2 = s * s;
 
     // fill mu mu
@@ -345,3 +561,26 @@ void ModelHawkesLogLikSingle::hessian_i(const ulong i,
     }
   }
 }
+
+template <class T>
+void TModelHawkesLogLikSingle<T>::compute_residuals_dim_i(
+    const ulong i, const ArrayDouble &coeffs,
+    SArrayDoublePtrList1D &residuals) {
+  const double mu_i = coeffs[i];
+  const ArrayDouble alpha_i =
+      view(coeffs, get_alpha_i_first_index(i), get_alpha_i_last_index(i));
+  ArrayDouble &residuals_i = *residuals[i];
+
+  // Row k of G[i] already holds the compensator of the kernels between
+  // t_i_(k-1) and t_i_k
+  double t_i_k_minus_one = 0;
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
+    const double t_i_k = (*timestamps[i])[k];
+    residuals_i[k] = mu_i * (t_i_k - t_i_k_minus_one) +
+                     dot_weights(alpha_i, view_row(G[i], k));
+    t_i_k_minus_one = t_i_k;
+  }
+}
+
+template class DLL_PUBLIC TModelHawkesLogLikSingle<double>;
+template class DLL_PUBLIC TModelHawkesLogLikSingle<float>;
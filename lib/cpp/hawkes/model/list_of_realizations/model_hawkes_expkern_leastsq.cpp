@@ -33,6 +33,7 @@ void ModelHawkesExpKernLeastSq::compute_weights_timestamps_list() {
   for (ulong r = 0; r < n_realizations; ++r) {
     model_list[r] =
         ModelHawkesExpKernLeastSqSingle(decays, 1, optimization_level);
+    model_list[r].set_adjacency_mask(adjacency_mask);
     model_list[r].set_data(timestamps_list[r], (*end_times)[r]);
     model_list[r].allocate_weights();
   }
@@ -54,6 +55,7 @@ void ModelHawkesExpKernLeastSq::compute_weights_timestamps(
     const SArrayDoublePtrList1D &timestamps, double end_time) {
   auto model = ModelHawkesExpKernLeastSqSingle(decays, get_n_threads(),
                                                optimization_level);
+  model.set_adjacency_mask(adjacency_mask);
   model.set_data(timestamps, end_time);
   model.compute_weights();
 
@@ -64,13 +66,18 @@ void ModelHawkesExpKernLeastSq::compute_weights_timestamps(
 }
 
 void ModelHawkesExpKernLeastSq::allocate_weights() {
+  AdjacencySupport support = describe_adjacency_support(n_nodes, adjacency_mask);
+  source_indptr = support.source_indptr;
+  source_indices = support.source_indices;
+  E_indptr = support.block_indptr;
+
   Dg = ArrayDouble2d(n_nodes, n_nodes);
   Dg.init_to_zero();
   Dg2 = ArrayDouble2d(n_nodes, n_nodes);
   Dg2.init_to_zero();
   C = ArrayDouble2d(n_nodes, n_nodes);
   C.init_to_zero();
-  E = ArrayDouble2d(n_nodes, n_nodes * n_nodes);
+  E = ArrayDouble(E_indptr[n_nodes]);
   E.init_to_zero();
 
   weights_allocated = true;
@@ -88,6 +95,10 @@ void ModelHawkesExpKernLeastSq::synchronize_aggregated_model() {
   casted_model->Dg2 = view(Dg2);
   casted_model->C = view(C);
   casted_model->E = view(E);
+  casted_model->adjacency_mask = adjacency_mask;
+  casted_model->source_indptr = view(source_indptr);
+  casted_model->source_indices = view(source_indices);
+  casted_model->E_indptr = view(E_indptr);
   casted_model->end_time = end_times->sum();
 
   casted_model->n_total_jumps = n_jumps_per_realization->sum();
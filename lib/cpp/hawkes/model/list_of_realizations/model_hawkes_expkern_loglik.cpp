@@ -2,10 +2,15 @@
 
 #include "tick/hawkes/model/list_of_realizations/model_hawkes_expkern_loglik.h"
 
-ModelHawkesExpKernLogLik::ModelHawkesExpKernLogLik(const double decay,
-                                                   const int max_n_threads)
-    : ModelHawkesLogLik(max_n_threads), decay(decay) {}
+template <class T>
+TModelHawkesExpKernLogLik<T>::TModelHawkesExpKernLogLik(
+    const double decay, const int max_n_threads)
+    : TModelHawkesLogLik<T>(max_n_threads), decay(decay) {}
 
-ulong ModelHawkesExpKernLogLik::get_n_coeffs() const {
+template <class T>
+ulong TModelHawkesExpKernLogLik<T>::get_n_coeffs() const {
   return n_nodes + n_nodes * n_nodes;
 }
+
+template class DLL_PUBLIC TModelHawkesExpKernLogLik<double>;
+template class DLL_PUBLIC TModelHawkesExpKernLogLik<float>;
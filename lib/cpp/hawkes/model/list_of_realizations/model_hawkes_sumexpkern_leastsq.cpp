@@ -43,12 +43,12 @@ void ModelHawkesSumExpKernLeastSq::compute_weights_timestamps_list() {
                model_list);
 
   for (ulong r = 0; r < n_realizations; ++r) {
+    model_list[r].symmetrize_weights();
     L.mult_incr(model_list[r].L, 1);
+    Q.mult_incr(model_list[r].Q, 1);
+    C.mult_incr(model_list[r].C, 1);
+    Dg.mult_incr(model_list[r].Dg, 1);
     for (ulong i = 0; i < n_nodes; ++i) {
-      Dg[i].mult_incr(model_list[r].Dg[i], 1);
-      Dgg[i].mult_incr(model_list[r].Dgg[i], 1);
-      C[i].mult_incr(model_list[r].C[i], 1);
-      E[i].mult_incr(model_list[r].E[i], 1);
       K[i].mult_incr(model_list[r].K[i], 1);
     }
   }
@@ -62,11 +62,10 @@ void ModelHawkesSumExpKernLeastSq::compute_weights_timestamps(
   model.compute_weights();
 
   L.mult_incr(model.L, 1);
+  Q.mult_incr(model.Q, 1);
+  C.mult_incr(model.C, 1);
+  Dg.mult_incr(model.Dg, 1);
   for (ulong i = 0; i < n_nodes; ++i) {
-    Dg[i].mult_incr(model.Dg[i], 1);
-    Dgg[i].mult_incr(model.Dgg[i], 1);
-    C[i].mult_incr(model.C[i], 1);
-    E[i].mult_incr(model.E[i], 1);
     K[i].mult_incr(model.K[i], 1);
   }
 }
@@ -75,20 +74,15 @@ void ModelHawkesSumExpKernLeastSq::allocate_weights() {
   L = ArrayDouble(n_baselines);
   L.init_to_zero();
 
-  C = std::vector<ArrayDouble2d>(n_nodes);
-  Dgg = std::vector<ArrayDouble2d>(n_nodes);
-  E = std::vector<ArrayDouble2d>(n_nodes);
-  Dg = ArrayDouble2dList1D(n_nodes);
+  const ulong n_alpha_i = n_nodes * n_decays;
+  Q = ArrayDouble2d(n_alpha_i, n_alpha_i);
+  Q.init_to_zero();
+  C = ArrayDouble2d(n_nodes, n_alpha_i);
+  C.init_to_zero();
+  Dg = ArrayDouble2d(n_alpha_i, n_baselines);
+  Dg.init_to_zero();
   K = ArrayDoubleList1D(n_nodes);
   for (ulong i = 0; i < n_nodes; ++i) {
-    C[i] = ArrayDouble2d(n_nodes, n_decays);
-    C[i].init_to_zero();
-    Dg[i] = ArrayDouble2d(n_decays, n_baselines);
-    Dg[i].init_to_zero();
-    Dgg[i] = ArrayDouble2d(n_decays, n_decays);
-    Dgg[i].init_to_zero();
-    E[i] = ArrayDouble2d(n_nodes, n_decays * n_decays);
-    E[i].init_to_zero();
     K[i] = ArrayDouble(n_baselines);
     K[i].init_to_zero();
   }
@@ -105,18 +99,13 @@ void ModelHawkesSumExpKernLeastSq::synchronize_aggregated_model() {
   casted_model->period_length = period_length;
   casted_model->max_n_threads = max_n_threads;
 
+  // We make views to avoid copies
   casted_model->L = view(L);
-  casted_model->C = ArrayDouble2dList1D(n_nodes);
-  casted_model->Dg = ArrayDouble2dList1D(n_nodes);
-  casted_model->Dgg = ArrayDouble2dList1D(n_nodes);
-  casted_model->E = ArrayDouble2dList1D(n_nodes);
+  casted_model->Q = view(Q);
+  casted_model->C = view(C);
+  casted_model->Dg = view(Dg);
   casted_model->K = ArrayDoubleList1D(n_nodes);
-  // We make views to avoid copies
   for (ulong i = 0; i < n_nodes; ++i) {
-    casted_model->Dg[i] = view(Dg[i]);
-    casted_model->Dgg[i] = view(Dgg[i]);
-    casted_model->C[i] = view(C[i]);
-    casted_model->E[i] = view(E[i]);
     casted_model->K[i] = view(K[i]);
   }
   casted_model->end_time = end_times->sum();
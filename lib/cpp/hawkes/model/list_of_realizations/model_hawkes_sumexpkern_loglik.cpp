@@ -2,10 +2,15 @@
 
 #include "tick/hawkes/model/list_of_realizations/model_hawkes_sumexpkern_loglik.h"
 
-ModelHawkesSumExpKernLogLik::ModelHawkesSumExpKernLogLik(
+template <class T>
+TModelHawkesSumExpKernLogLik<T>::TModelHawkesSumExpKernLogLik(
     const ArrayDouble &decays, const int max_n_threads)
-    : ModelHawkesLogLik(max_n_threads), decays(decays) {}
+    : TModelHawkesLogLik<T>(max_n_threads), decays(decays) {}
 
-ulong ModelHawkesSumExpKernLogLik::get_n_coeffs() const {
+template <class T>
+ulong TModelHawkesSumExpKernLogLik<T>::get_n_coeffs() const {
   return n_nodes + n_nodes * n_nodes * get_n_decays();
 }
+
+template class DLL_PUBLIC TModelHawkesSumExpKernLogLik<double>;
+template class DLL_PUBLIC TModelHawkesSumExpKernLogLik<float>;
@@ -2,6 +2,8 @@
 
 #include "tick/hawkes/model/model_hawkes_expkern_leastsq_single.h"
 
+#include <algorithm>
+
 // Constructor
 ModelHawkesExpKernLeastSqSingle::ModelHawkesExpKernLeastSqSingle(
     const SArrayDouble2dPtr decays, const int max_n_threads,
@@ -29,7 +31,6 @@ double ModelHawkesExpKernLeastSqSingle::loss_i(const ulong i,
   if (!weights_computed)
     TICK_ERROR("Please compute weights before calling loss_i");
 
-  const ArrayDouble E_i = view_row(E, i);
   const ArrayDouble Dg_i = view_row(Dg, i);
   const ArrayDouble Dg2_i = view_row(Dg2, i);
   const ArrayDouble C_i = view_row(C, i);
@@ -39,17 +40,30 @@ double ModelHawkesExpKernLeastSqSingle::loss_i(const ulong i,
   double value = 0;
   value += mu[i] * mu[i] * end_time;
 
+  const ulong start_i = source_indptr[i];
+  const ulong n_sources_i = source_indptr[i + 1] - start_i;
+
   double temp1 = 0;
   double temp2 = 0;
   double temp3 = 0;
   double temp4 = 0;
-  for (ulong j = 0; j < n_nodes; j++) {
-    temp1 += alpha[i * n_nodes + j] * Dg_i[j];
-    temp2 += alpha[i * n_nodes + j] * alpha[i * n_nodes + j] * Dg2_i[j];
-    temp3 += alpha[i * n_nodes + j] * C_i[j];
-    for (ulong j1 = 0; j1 < n_nodes; j1++) {
-      temp4 += alpha[i * n_nodes + j] * alpha[i * n_nodes + j1] *
-               E_i[j * n_nodes + j1];
+  if (n_sources_i > 0) {
+    // Gather the coefficients of the nodes allowed to excite node i
+    ArrayDouble alpha_i(n_sources_i);
+    for (ulong a = 0; a < n_sources_i; a++) {
+      const ulong j = source_indices[start_i + a];
+      alpha_i[a] = alpha[i * n_nodes + j];
+      temp1 += alpha_i[a] * Dg_i[j];
+      temp2 += alpha_i[a] * alpha_i[a] * Dg2_i[j];
+      temp3 += alpha_i[a] * C_i[j];
+    }
+
+    // Quadratic form alpha_i^T E_i alpha_i, computed row by row
+    const ArrayDouble E_i = view(E, E_indptr[i], E_indptr[i + 1]);
+    for (ulong a = 0; a < n_sources_i; a++) {
+      const ArrayDouble E_i_a =
+          view(E_i, a * n_sources_i, (a + 1) * n_sources_i);
+      temp4 += alpha_i[a] * E_i_a.dot(alpha_i);
     }
   }
   value += 2 * mu[i] * temp1 + temp2 - 2 * temp3 + 2 * temp4 -
@@ -77,7 +91,6 @@ void ModelHawkesExpKernLeastSqSingle::grad_i(const ulong i,
   if (!weights_computed)
     TICK_ERROR("Please compute weights before calling grad_i");
 
-  const ArrayDouble E_i = view_row(E, i);
   const ArrayDouble Dg_i = view_row(Dg, i);
   const ArrayDouble Dg2_i = view_row(Dg2, i);
   const ArrayDouble C_i = view_row(C, i);
@@ -86,21 +99,37 @@ void ModelHawkesExpKernLeastSqSingle::grad_i(const ulong i,
   const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
   ArrayDouble grad_mu = view(out, 0, n_nodes);
   ArrayDouble grad_alpha = view(out, n_nodes, n_nodes + n_nodes * n_nodes);
+  ArrayDouble grad_alpha_i =
+      view(grad_alpha, i * n_nodes, (i + 1) * n_nodes);
 
   grad_mu[i] = 2 * mu[i] * end_time - 2 * (*n_jumps_per_node)[i];
+  // Entries outside of the adjacency support are fixed to zero
+  grad_alpha_i.init_to_zero();
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    grad_mu[i] += 2 * alpha[i * n_nodes + j] * Dg_i[j];
-    grad_alpha[i * n_nodes + j] =
-        2 * mu[i] * Dg_i[j] + 2 * alpha[i * n_nodes + j] * Dg2_i[j] +
-        4 * alpha[i * n_nodes + j] * E_i[j * n_nodes + j] - 2 * C_i[j];
-
-    for (ulong j1 = 0; j1 < n_nodes; j1++) {
-      if (j1 != j)
-        grad_alpha[i * n_nodes + j] +=
-            2 * alpha[i * n_nodes + j1] *
-            (E_i[j * n_nodes + j1] + E_i[j1 * n_nodes + j]);
-    }
+  const ulong start_i = source_indptr[i];
+  const ulong n_sources_i = source_indptr[i + 1] - start_i;
+  if (n_sources_i == 0) return;
+
+  ArrayDouble alpha_i(n_sources_i);
+  for (ulong a = 0; a < n_sources_i; a++) {
+    alpha_i[a] = alpha[i * n_nodes + source_indices[start_i + a]];
+  }
+
+  // (E_i + E_i^T) alpha_i, E_i^T alpha_i being accumulated row by row
+  const ArrayDouble E_i = view(E, E_indptr[i], E_indptr[i + 1]);
+  ArrayDouble E_i_alpha_i(n_sources_i);
+  E_i_alpha_i.init_to_zero();
+  for (ulong a = 0; a < n_sources_i; a++) {
+    const ArrayDouble E_i_a = view(E_i, a * n_sources_i, (a + 1) * n_sources_i);
+    E_i_alpha_i[a] += E_i_a.dot(alpha_i);
+    E_i_alpha_i.mult_incr(E_i_a, alpha_i[a]);
+  }
+
+  for (ulong a = 0; a < n_sources_i; a++) {
+    const ulong j = source_indices[start_i + a];
+    grad_mu[i] += 2 * alpha_i[a] * Dg_i[j];
+    grad_alpha_i[j] = 2 * mu[i] * Dg_i[j] + 2 * alpha_i[a] * Dg2_i[j] -
+                      2 * C_i[j] + 2 * E_i_alpha_i[a];
   }
 }
 
@@ -119,28 +148,35 @@ void ModelHawkesExpKernLeastSqSingle::hessian_i(const ulong i,
   if (!weights_computed)
     TICK_ERROR("Please compute weights before calling hessian_i");
 
+  const ulong start_i = source_indptr[i];
+  const ulong n_sources_i = source_indptr[i + 1] - start_i;
+
   // fill mu line of matrix
   const ulong start_mu_line = i * (n_nodes + 1);
   // fill mu in mu diag
   out[start_mu_line] = 2 * end_time;
   // fill alpha line
   const ArrayDouble Dg_i = view_row(Dg, i);
-  for (ulong j = 0; j < n_nodes; ++j) {
+  for (ulong a = 0; a < n_sources_i; ++a) {
+    const ulong j = source_indices[start_i + a];
     out[start_mu_line + j + 1] += 2 * Dg_i[j];
   }
+  if (n_sources_i == 0) return;
 
   // fill alpha lines
-  const ArrayDouble E_k = view_row(E, i);
+  const ArrayDouble E_k = view(E, E_indptr[i], E_indptr[i + 1]);
   const ArrayDouble Dg2_k = view_row(Dg2, i);
   const ArrayDouble Dg_k = view_row(Dg, i);
 
   const ulong block_start = (i + 1) * n_nodes * (n_nodes + 1);
-  for (ulong l = 0; l < n_nodes; ++l) {
+  for (ulong a = 0; a < n_sources_i; ++a) {
+    const ulong l = source_indices[start_i + a];
     const ulong start_alpha_line = block_start + l * (n_nodes + 1);
     out[start_alpha_line] += 2 * Dg_k[l];
-    for (ulong m = 0; m < n_nodes; ++m) {
-      out[start_alpha_line + m + 1] +=
-          2 * (E_k[l * n_nodes + m] + E_k[m * n_nodes + l]);
+    for (ulong b = 0; b < n_sources_i; ++b) {
+      const ulong m = source_indices[start_i + b];
+      out[start_alpha_line + m + 1] += 2 * (E_k[a * n_sources_i + b] +
+                                            E_k[b * n_sources_i + a]);
       if (l == m) {
         out[start_alpha_line + m + 1] += 2 * Dg2_k[l];
       }
@@ -161,6 +197,13 @@ void ModelHawkesExpKernLeastSqSingle::allocate_weights() {
     TICK_ERROR("Please provide valid timestamps before allocating weights")
   }
 
+  AdjacencySupport support = describe_adjacency_support(n_nodes, adjacency_mask);
+  source_indptr = support.source_indptr;
+  source_indices = support.source_indices;
+  target_indptr = support.target_indptr;
+  target_indices = support.target_indices;
+  E_indptr = support.block_indptr;
+
   // Allocation
   Dg = ArrayDouble2d(n_nodes, n_nodes);
   Dg.init_to_zero();
@@ -168,7 +211,7 @@ void ModelHawkesExpKernLeastSqSingle::allocate_weights() {
   Dg2.init_to_zero();
   C = ArrayDouble2d(n_nodes, n_nodes);
   C.init_to_zero();
-  E = ArrayDouble2d(n_nodes, n_nodes * n_nodes);
+  E = ArrayDouble(E_indptr[n_nodes]);
   E.init_to_zero();
 }
 
@@ -183,59 +226,110 @@ void ModelHawkesExpKernLeastSqSingle::compute_weights() {
 
 // Contribution of the ith component to the initialization
 // Computation of the arrays H, Dg, Dg2 and C
+// Only the entries allowed by the adjacency support are computed: E(j1, i, j)
+// is needed only if both i and j are allowed to excite j1
 void ModelHawkesExpKernLeastSqSingle::compute_weights_i(const ulong i) {
   const SArrayDoublePtr timestamps_i = timestamps[i];
-  ArrayDouble2d H(n_nodes, n_nodes);
-  H.init_to_zero();
   ArrayDouble Dg_i = view_row(Dg, i);
   ArrayDouble Dg2_i = view_row(Dg2, i);
   ArrayDouble C_i = view_row(C, i);
 
+  // Nodes j1 that node i is allowed to excite, along with the row of i in
+  // E_j1 and the column of j in E_j1 (n_nodes if j cannot excite j1)
+  const ulong start_targets_i = target_indptr[i];
+  const ulong n_targets_i = target_indptr[i + 1] - start_targets_i;
+  ArrayULong row_i(n_targets_i);
+  ArrayULong col_j(n_targets_i);
+  for (ulong t = 0; t < n_targets_i; t++) {
+    const ulong j1 = target_indices[start_targets_i + t];
+    const ulong *sources_j1 = source_indices.data() + source_indptr[j1];
+    const ulong n_sources_j1 = source_indptr[j1 + 1] - source_indptr[j1];
+    row_i[t] = std::lower_bound(sources_j1, sources_j1 + n_sources_j1, i) -
+               sources_j1;
+  }
+
+  // H(j1, j) for the targets of node i and H(i, j) which is needed for C
+  ArrayDouble H(n_targets_i);
+
+  const ulong start_sources_i = source_indptr[i];
+  const ulong end_sources_i = source_indptr[i + 1];
+  ulong next_source_i = start_sources_i;
+
   const ulong N_i_size = timestamps_i->size();
   for (ulong j = 0; j < n_nodes; j++) {
+    const bool is_source_ij = next_source_i < end_sources_i &&
+                              source_indices[next_source_i] == j;
+    if (is_source_ij) next_source_i++;
+
+    bool is_needed_j = is_source_ij;
+    for (ulong t = 0; t < n_targets_i; t++) {
+      const ulong j1 = target_indices[start_targets_i + t];
+      const ulong *sources_j1 = source_indices.data() + source_indptr[j1];
+      const ulong n_sources_j1 = source_indptr[j1 + 1] - source_indptr[j1];
+      const ulong *position =
+          std::lower_bound(sources_j1, sources_j1 + n_sources_j1, j);
+      const bool is_source_j1j =
+          position != sources_j1 + n_sources_j1 && *position == j;
+      col_j[t] = is_source_j1j ? position - sources_j1 : n_nodes;
+      is_needed_j |= is_source_j1j;
+    }
+    if (!is_needed_j) continue;
+
     const SArrayDoublePtr realization_j = timestamps[j];
     const ulong N_j_size = realization_j->size();
     const double betaij = (*decays)(i, j);
+    H.init_to_zero();
+    double H_ij = 0;
     ulong ij = 0;
     for (ulong k = 0; k < N_i_size; k++) {
       if (k > 0) {
-        for (ulong j1 = 0; j1 < n_nodes; j1++) {
+        const double delta_t_i = (*timestamps_i)[k] - (*timestamps_i)[k - 1];
+        for (ulong t = 0; t < n_targets_i; t++) {
+          if (col_j[t] == n_nodes) continue;
+          const ulong j1 = target_indices[start_targets_i + t];
           double beta_j1_j = (*decays)(j1, j);
-          H(j1, j) *=
-              cexp(-beta_j1_j * ((*timestamps_i)[k] - (*timestamps_i)[k - 1]));
+          H[t] *= cexp(-beta_j1_j * delta_t_i);
         }
+        H_ij *= cexp(-betaij * delta_t_i);
       }
       while ((ij < N_j_size) && ((*realization_j)[ij] < (*timestamps_i)[k])) {
-        for (ulong j1 = 0; j1 < n_nodes; j1++) {
+        for (ulong t = 0; t < n_targets_i; t++) {
+          if (col_j[t] == n_nodes) continue;
+          const ulong j1 = target_indices[start_targets_i + t];
           double beta_j1_j = (*decays)(j1, j);
-          H(j1, j) +=
-              beta_j1_j *
-              cexp(-beta_j1_j * ((*timestamps_i)[k] - (*realization_j)[ij]));
+          H[t] += beta_j1_j * cexp(-beta_j1_j * ((*timestamps_i)[k] -
+                                                 (*realization_j)[ij]));
+        }
+        if (is_source_ij) {
+          H_ij += betaij *
+                  cexp(-betaij * ((*timestamps_i)[k] - (*realization_j)[ij]));
+          Dg_i[j] += (1 - cexp(-betaij * (end_time - (*realization_j)[ij])));
+          Dg2_i[j] +=
+              betaij *
+              (1 - cexp(-2 * betaij * (end_time - (*realization_j)[ij]))) / 2;
         }
-        Dg_i[j] += (1 - cexp(-betaij * (end_time - (*realization_j)[ij])));
-        Dg2_i[j] +=
-            betaij *
-            (1 - cexp(-2 * betaij * (end_time - (*realization_j)[ij]))) / 2;
         ij++;
       }
 
-      C_i[j] += H(i, j);
+      if (is_source_ij) C_i[j] += H_ij;
 
       // Here we compute E(j1,i,j)
-      const ulong index = i * n_nodes + j;
-      for (ulong j1 = 0; j1 < n_nodes; j1++) {
+      for (ulong t = 0; t < n_targets_i; t++) {
+        if (col_j[t] == n_nodes) continue;
+        const ulong j1 = target_indices[start_targets_i + t];
         double beta_j1_i = (*decays)(j1, i);
         double beta_j1_j = (*decays)(j1, j);
-        ArrayDouble E_j1 = view_row(E, j1);
+        const ulong n_sources_j1 = source_indptr[j1 + 1] - source_indptr[j1];
         double r = beta_j1_i / (beta_j1_i + beta_j1_j);
-        E_j1[index] += r *
-                       (1 - cexp(-(end_time - (*timestamps_i)[k]) *
-                                 (beta_j1_i + beta_j1_j))) *
-                       H(j1, j);
+        E[E_indptr[j1] + row_i[t] * n_sources_j1 + col_j[t]] +=
+            r *
+            (1 - cexp(-(end_time - (*timestamps_i)[k]) *
+                      (beta_j1_i + beta_j1_j))) *
+            H[t];
       }
     }
 
-    if (ij < N_j_size) {
+    if (is_source_ij && ij < N_j_size) {
       while (ij < N_j_size) {
         Dg2_i[j] +=
             betaij *
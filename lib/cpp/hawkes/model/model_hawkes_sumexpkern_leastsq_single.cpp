@@ -17,11 +17,21 @@ double ModelHawkesSumExpKernLeastSqSingle::loss(const ArrayDouble &coeffs) {
   // The initialization should be performed if not performed yet
   if (!weights_computed) compute_weights();
 
+  // A Q is computed for all nodes at once, each thread handling a slice of
+  // its rows
+  const ulong n_alpha_i = n_nodes * n_decays;
+  ArrayDouble alpha_Q(n_nodes * n_alpha_i);
+  const unsigned int n_threads = get_n_threads();
+  parallel_run(n_threads, n_threads,
+               &ModelHawkesSumExpKernLeastSqSingle::compute_alpha_Q, this,
+               n_threads, coeffs, alpha_Q);
+
   // This allows to run in a multithreaded environment the computation of the
   // contribution of each component
-  SArrayDoublePtr values =
-      parallel_map(get_n_threads(), n_nodes,
-                   &ModelHawkesSumExpKernLeastSqSingle::loss_i, this, coeffs);
+  SArrayDoublePtr values = parallel_map(
+      n_threads, n_nodes,
+      &ModelHawkesSumExpKernLeastSqSingle::loss_i_from_alpha_Q, this, coeffs,
+      alpha_Q);
 
   // We just need to sum up the contribution
   return values->sum() / n_total_jumps;
@@ -33,41 +43,40 @@ double ModelHawkesSumExpKernLeastSqSingle::loss_i(const ulong i,
   if (!weights_computed)
     TICK_ERROR("Please compute weights before calling loss_i");
 
-  ArrayDouble mu_i = view(coeffs, i * n_baselines, (i + 1) * n_baselines);
-  ulong start_alpha_i = n_nodes * n_baselines + i * n_nodes * n_decays;
-  ulong end_alpha_i = n_nodes * n_baselines + (i + 1) * n_nodes * n_decays;
-  ArrayDouble alpha_i = view(coeffs, start_alpha_i, end_alpha_i);
+  const ulong n_alpha_i = n_nodes * n_decays;
+  const ulong start_alpha_i = n_nodes * n_baselines + i * n_alpha_i;
+  ArrayDouble alpha_i = view(coeffs, start_alpha_i, start_alpha_i + n_alpha_i);
 
-  double C_sum = 0;
-  double Dg_sum = 0;
-  double Dgg_sum = 0;
-  double E_sum = 0;
+  ArrayDouble Q_alpha_i(n_alpha_i);
+  tick::vector_operations<double>{}.dot_matrix_vector(
+      n_alpha_i, n_alpha_i, 1., Q.data(), alpha_i.data(), Q_alpha_i.data());
 
-  ArrayDouble2d &C_i = C[i];
-  for (ulong j = 0; j < n_nodes; ++j) {
-    ArrayDouble2d &Dg_j = Dg[j];
-    ArrayDouble2d &Dgg_j = Dgg[j];
-    ArrayDouble2d &E_j = E[j];
+  return loss_i_from_Q_alpha_i(i, coeffs, Q_alpha_i);
+}
 
-    for (ulong u = 0; u < n_decays; ++u) {
-      double alpha_i_j_u = alpha_i[j * n_decays + u];
-      C_sum += alpha_i_j_u * C_i(j, u);
+double ModelHawkesSumExpKernLeastSqSingle::loss_i_from_alpha_Q(
+    const ulong i, const ArrayDouble &coeffs, const ArrayDouble &alpha_Q) {
+  // Q is symmetric, hence row i of A Q is Q alpha_i
+  const ulong n_alpha_i = n_nodes * n_decays;
+  ArrayDouble Q_alpha_i = view(alpha_Q, i * n_alpha_i, (i + 1) * n_alpha_i);
+  return loss_i_from_Q_alpha_i(i, coeffs, Q_alpha_i);
+}
 
-      for (ulong p = 0; p < n_baselines; ++p) {
-        Dg_sum += alpha_i_j_u * mu_i[p] * Dg_j[u * n_baselines + p];
-      }
+double ModelHawkesSumExpKernLeastSqSingle::loss_i_from_Q_alpha_i(
+    const ulong i, const ArrayDouble &coeffs, const ArrayDouble &Q_alpha_i) {
+  ArrayDouble mu_i = view(coeffs, i * n_baselines, (i + 1) * n_baselines);
+  const ulong n_alpha_i = n_nodes * n_decays;
+  const ulong start_alpha_i = n_nodes * n_baselines + i * n_alpha_i;
+  ArrayDouble alpha_i = view(coeffs, start_alpha_i, start_alpha_i + n_alpha_i);
 
-      for (ulong u1 = 0; u1 < n_decays; ++u1) {
-        double alpha_i_j_u1 = alpha_i[j * n_decays + u1];
-        Dgg_sum += alpha_i_j_u * alpha_i_j_u1 * Dgg_j(u, u1);
+  // Dg mu_i, with Dg stacked over (node, decay) pairs
+  ArrayDouble Dg_mu_i(n_alpha_i);
+  tick::vector_operations<double>{}.dot_matrix_vector(
+      n_alpha_i, n_baselines, 1., Dg.data(), mu_i.data(), Dg_mu_i.data());
 
-        for (ulong j1 = 0; j1 < n_nodes; ++j1) {
-          double alpha_i_j1_u1 = alpha_i[j1 * n_decays + u1];
-          E_sum += alpha_i_j_u * alpha_i_j1_u1 * E_j(j1, u * n_decays + u1);
-        }
-      }
-    }
-  }
+  const double C_sum = view_row(C, i).dot(alpha_i);
+  const double Dg_sum = Dg_mu_i.dot(alpha_i);
+  const double Q_sum = Q_alpha_i.dot(alpha_i);
 
   double A_i = 0;
   double B_i = 0;
@@ -79,8 +88,7 @@ double ModelHawkesSumExpKernLeastSqSingle::loss_i(const ulong i,
   }
 
   A_i += 2 * Dg_sum;
-  A_i += Dgg_sum;
-  A_i += 2 * E_sum;
+  A_i += Q_sum / 2;
 
   B_i += C_sum;
 
@@ -93,10 +101,20 @@ void ModelHawkesSumExpKernLeastSqSingle::grad(const ArrayDouble &coeffs,
   // The initialization should be performed if not performed yet
   if (!weights_computed) compute_weights();
 
+  // The gradient with respect to A starts with A Q which is written in place
+  const ulong n_alpha_i = n_nodes * n_decays;
+  ArrayDouble grad_alpha = view(out, n_nodes * n_baselines,
+                                n_nodes * n_baselines + n_nodes * n_alpha_i);
+  const unsigned int n_threads = get_n_threads();
+  parallel_run(n_threads, n_threads,
+               &ModelHawkesSumExpKernLeastSqSingle::compute_alpha_Q, this,
+               n_threads, coeffs, grad_alpha);
+
   // This allows to run in a multithreaded environment the computation of each
   // component
-  parallel_run(get_n_threads(), n_nodes,
-               &ModelHawkesSumExpKernLeastSqSingle::grad_i, this, coeffs, out);
+  parallel_run(n_threads, n_nodes,
+               &ModelHawkesSumExpKernLeastSqSingle::grad_i_from_Q_alpha, this,
+               coeffs, out);
   out /= n_total_jumps;
 }
 
@@ -107,53 +125,61 @@ void ModelHawkesSumExpKernLeastSqSingle::grad_i(const ulong i,
   if (!weights_computed)
     TICK_ERROR("Please compute weights before calling hessian_i");
 
+  const ulong n_alpha_i = n_nodes * n_decays;
+  const ulong start_alpha_i = n_nodes * n_baselines + i * n_alpha_i;
+  ArrayDouble alpha_i = view(coeffs, start_alpha_i, start_alpha_i + n_alpha_i);
+  ArrayDouble grad_alpha_i =
+      view(out, start_alpha_i, start_alpha_i + n_alpha_i);
+
+  tick::vector_operations<double>{}.dot_matrix_vector(
+      n_alpha_i, n_alpha_i, 1., Q.data(), alpha_i.data(), grad_alpha_i.data());
+
+  grad_i_from_Q_alpha(i, coeffs, out);
+}
+
+void ModelHawkesSumExpKernLeastSqSingle::grad_i_from_Q_alpha(
+    const ulong i, const ArrayDouble &coeffs, ArrayDouble &out) {
   ArrayDouble mu_i = view(coeffs, i * n_baselines, (i + 1) * n_baselines);
-  ulong start_alpha_i = n_nodes * n_baselines + i * n_nodes * n_decays;
-  ulong end_alpha_i = n_nodes * n_baselines + (i + 1) * n_nodes * n_decays;
-  ArrayDouble alpha_i = view(coeffs, start_alpha_i, end_alpha_i);
+  const ulong n_alpha_i = n_nodes * n_decays;
+  const ulong start_alpha_i = n_nodes * n_baselines + i * n_alpha_i;
+  ArrayDouble alpha_i = view(coeffs, start_alpha_i, start_alpha_i + n_alpha_i);
 
   ArrayDouble grad_mu_i = view(out, i * n_baselines, (i + 1) * n_baselines);
-  ArrayDouble grad_alpha_i = view(out, start_alpha_i, end_alpha_i);
-  grad_alpha_i.init_to_zero();
+  ArrayDouble grad_alpha_i =
+      view(out, start_alpha_i, start_alpha_i + n_alpha_i);
 
   ArrayDouble &K_i = K[i];
   for (ulong p = 0; p < n_baselines; ++p) {
     grad_mu_i[p] = 2 * mu_i[p] * L[p] - 2 * K_i[p];
   }
 
-  ArrayDouble2d &C_i = C[i];
-  for (ulong j = 0; j < n_nodes; ++j) {
-    ArrayDouble2d &Dg_j = Dg[j];
-    ArrayDouble2d &Dgg_j = Dgg[j];
-    ArrayDouble2d &E_j = E[j];
-
-    for (ulong u = 0; u < n_decays; ++u) {
-      double alpha_i_j_u = alpha_i[j * n_decays + u];
-      double &grad_alpha_i_j_u = grad_alpha_i[j * n_decays + u];
-
-      grad_alpha_i_j_u -= 2 * C_i(j, u);
-
-      for (ulong p = 0; p < n_baselines; ++p) {
-        grad_mu_i[p] += 2 * alpha_i_j_u * Dg_j[u * n_baselines + p];
-        grad_alpha_i_j_u += 2 * mu_i[p] * Dg_j[u * n_baselines + p];
-      }
-
-      for (ulong u1 = 0; u1 < n_decays; ++u1) {
-        double alpha_i_j_u1 = alpha_i[j * n_decays + u1];
-
-        grad_alpha_i_j_u += 2 * alpha_i_j_u1 * Dgg_j(u, u1);
+  // grad_mu_i += 2 Dg^T alpha_i
+  for (ulong ju = 0; ju < n_alpha_i; ++ju) {
+    grad_mu_i.mult_incr(view_row(Dg, ju), 2 * alpha_i[ju]);
+  }
 
-        for (ulong j1 = 0; j1 < n_nodes; ++j1) {
-          double alpha_i_j1_u1 = alpha_i[j1 * n_decays + u1];
-          double &grad_alpha_i_j1_u1 = grad_alpha_i[j1 * n_decays + u1];
-          double E_j_j1_u_u1 = E_j(j1, u * n_decays + u1);
+  // grad_alpha_i = Q alpha_i + 2 Dg mu_i - 2 C_i
+  ArrayDouble Dg_mu_i(n_alpha_i);
+  tick::vector_operations<double>{}.dot_matrix_vector(
+      n_alpha_i, n_baselines, 2., Dg.data(), mu_i.data(), Dg_mu_i.data());
+  grad_alpha_i.mult_incr(Dg_mu_i, 1.);
+  grad_alpha_i.mult_incr(view_row(C, i), -2.);
+}
 
-          grad_alpha_i_j_u += 2 * alpha_i_j1_u1 * E_j_j1_u_u1;
-          grad_alpha_i_j1_u1 += 2 * alpha_i_j_u * E_j_j1_u_u1;
-        }
-      }
-    }
-  }
+void ModelHawkesSumExpKernLeastSqSingle::compute_alpha_Q(
+    const ulong slice, const ulong n_slices, const ArrayDouble &coeffs,
+    ArrayDouble &out) {
+  ulong start_row{}, end_row{};
+  std::tie(start_row, end_row) =
+      tick::get_thread_indices(slice, n_slices, n_nodes);
+  if (start_row >= end_row) return;
+
+  const ulong n_alpha_i = n_nodes * n_decays;
+  const double *alpha_slice =
+      coeffs.data() + n_nodes * n_baselines + start_row * n_alpha_i;
+  tick::vector_operations<double>{}.dot_matrix_matrix(
+      end_row - start_row, n_alpha_i, n_alpha_i, 1., alpha_slice, Q.data(), 0.,
+      out.data() + start_row * n_alpha_i);
 }
 
 // Computes both gradient and value
@@ -180,10 +206,7 @@ void ModelHawkesSumExpKernLeastSqSingle::compute_weights_i(const ulong i) {
   ArrayULong l = ArrayULong(n_nodes);
   l.init_to_zero();
 
-  ArrayDouble2d &C_i = C[i];
-  ArrayDouble2d &Dg_i = Dg[i];
-  ArrayDouble2d &Dgg_i = Dgg[i];
-  ArrayDouble2d &E_i = E[i];
+  ArrayDouble C_i = view_row(C, i);
   ArrayDouble &K_i = K[i];
 
   ulong N_i = timestamps_i.size();
@@ -234,22 +257,22 @@ void ModelHawkesSumExpKernLeastSqSingle::compute_weights_i(const ulong i) {
 
       for (ulong u = 0; u < n_decays; ++u) {
         double decay_u = decays[u];
-        C_i(j, u) += H(j, u);
+        C_i[j * n_decays + u] += H(j, u);
 
         for (ulong u1 = 0; u1 < n_decays; ++u1) {
           double decay_u1 = decays[u1];
 
-          // we fill E_i,j,u',u
+          // we fill E_i,j,u',u which pairs alpha_i_u' with alpha_j_u
           double ratio = decay_u1 / (decay_u1 + decay_u);
           double tmp = 1 - exponentials(u, u1);
-          E_i(j, u1 * n_decays + u) += ratio * tmp * H(j, u);
+          Q(i * n_decays + u1, j * n_decays + u) += 2 * ratio * tmp * H(j, u);
         }
       }
     }
 
     for (ulong u = 0; u < n_decays; ++u) {
       double decay_u = decays[u];
-      ArrayDouble Dg_i_u = view_row(Dg_i, u);
+      ArrayDouble Dg_i_u = view_row(Dg, i * n_decays + u);
       for (ulong p = 0; p < n_baselines; ++p) {
         ulong n_passed_periods =
             static_cast<ulong>(std::floor(t_k_i / period_length));
@@ -268,8 +291,10 @@ void ModelHawkesSumExpKernLeastSqSingle::compute_weights_i(const ulong i) {
       for (ulong u1 = 0; u1 < n_decays; ++u1) {
         double decay_u1 = decays[u1];
 
+        // we fill Dgg_i,u,u1
         double ratio = decay_u * decay_u1 / (decay_u + decay_u1);
-        Dgg_i(u, u1) += ratio * (1 - exponentials(u, u1));
+        Q(i * n_decays + u, i * n_decays + u1) +=
+            ratio * (1 - exponentials(u, u1));
       }
     }
   }
@@ -283,25 +308,32 @@ void ModelHawkesSumExpKernLeastSqSingle::allocate_weights() {
   L = ArrayDouble(n_baselines);
   L.init_to_zero();
 
-  C = ArrayDouble2dList1D(n_nodes);
-  Dgg = ArrayDouble2dList1D(n_nodes);
-  E = ArrayDouble2dList1D(n_nodes);
-  Dg = ArrayDouble2dList1D(n_nodes);
+  const ulong n_alpha_i = n_nodes * n_decays;
+  Q = ArrayDouble2d(n_alpha_i, n_alpha_i);
+  Q.init_to_zero();
+  C = ArrayDouble2d(n_nodes, n_alpha_i);
+  C.init_to_zero();
+  Dg = ArrayDouble2d(n_alpha_i, n_baselines);
+  Dg.init_to_zero();
   K = ArrayDoubleList1D(n_nodes);
   for (ulong i = 0; i < n_nodes; ++i) {
-    C[i] = ArrayDouble2d(n_nodes, n_decays);
-    C[i].init_to_zero();
-    Dg[i] = ArrayDouble2d(n_decays, n_baselines);
-    Dg[i].init_to_zero();
-    Dgg[i] = ArrayDouble2d(n_decays, n_decays);
-    Dgg[i].init_to_zero();
-    E[i] = ArrayDouble2d(n_nodes, n_decays * n_decays);
-    E[i].init_to_zero();
     K[i] = ArrayDouble(n_baselines);
     K[i].init_to_zero();
   }
 }
 
+void ModelHawkesSumExpKernLeastSqSingle::symmetrize_weights() {
+  const ulong n_alpha_i = n_nodes * n_decays;
+  for (ulong a = 0; a < n_alpha_i; ++a) {
+    Q(a, a) *= 2;
+    for (ulong b = a + 1; b < n_alpha_i; ++b) {
+      const double Q_a_b = Q(a, b) + Q(b, a);
+      Q(a, b) = Q_a_b;
+      Q(b, a) = Q_a_b;
+    }
+  }
+}
+
 // Full initialization of the arrays H, Dg, Dg2 and C
 // Must be performed just once
 void ModelHawkesSumExpKernLeastSqSingle::compute_weights() {
@@ -310,6 +342,7 @@ void ModelHawkesSumExpKernLeastSqSingle::compute_weights() {
   // Multithreaded computation of the arrays
   parallel_run(get_n_threads(), n_nodes,
                &ModelHawkesSumExpKernLeastSqSingle::compute_weights_i, this);
+  symmetrize_weights();
   weights_computed = true;
 }
 
@@ -69,3 +69,63 @@ TimestampListDescriptor describe_timestamps_list(
 
   return timestamps_list_descriptor;
 }
+
+AdjacencySupport describe_adjacency_support(
+    const ulong n_nodes, const SArrayULong2dPtr adjacency_mask) {
+  if (adjacency_mask != nullptr && (adjacency_mask->n_rows() != n_nodes ||
+                                    adjacency_mask->n_cols() != n_nodes)) {
+    TICK_ERROR("adjacency_mask must be (" << n_nodes << ", " << n_nodes
+                                          << ") array but received a ("
+                                          << adjacency_mask->n_rows() << ", "
+                                          << adjacency_mask->n_cols()
+                                          << ") array");
+  }
+
+  auto is_allowed = [&adjacency_mask](const ulong i, const ulong j) {
+    return adjacency_mask == nullptr || (*adjacency_mask)(i, j) != 0;
+  };
+
+  AdjacencySupport support;
+  support.source_indptr = ArrayULong(n_nodes + 1);
+  support.target_indptr = ArrayULong(n_nodes + 1);
+  support.block_indptr = ArrayULong(n_nodes + 1);
+  support.source_indptr.init_to_zero();
+  support.target_indptr.init_to_zero();
+  support.block_indptr.init_to_zero();
+
+  for (ulong i = 0; i < n_nodes; ++i) {
+    ulong n_sources_i = 0;
+    for (ulong j = 0; j < n_nodes; ++j) {
+      if (is_allowed(i, j)) {
+        n_sources_i++;
+        support.target_indptr[j + 1]++;
+      }
+    }
+    support.source_indptr[i + 1] = support.source_indptr[i] + n_sources_i;
+    support.block_indptr[i + 1] =
+        support.block_indptr[i] + n_sources_i * n_sources_i;
+  }
+  for (ulong j = 0; j < n_nodes; ++j) {
+    support.target_indptr[j + 1] += support.target_indptr[j];
+  }
+
+  const ulong n_allowed = support.source_indptr[n_nodes];
+  support.source_indices = ArrayULong(n_allowed);
+  support.target_indices = ArrayULong(n_allowed);
+
+  // Filling row by row keeps both index lists sorted
+  ArrayULong target_position(n_nodes);
+  for (ulong j = 0; j < n_nodes; ++j) {
+    target_position[j] = support.target_indptr[j];
+  }
+  ulong source_position = 0;
+  for (ulong i = 0; i < n_nodes; ++i) {
+    for (ulong j = 0; j < n_nodes; ++j) {
+      if (is_allowed(i, j)) {
+        support.source_indices[source_position++] = j;
+        support.target_indices[target_position[j]++] = i;
+      }
+    }
+  }
+  return support;
+}
@@ -0,0 +1,205 @@
+// License: BSD 3 clause
+
+#include "tick/hawkes/simulation/hawkes_intensity_filter.h"
+
+#include <algorithm>
+#include <limits>
+
+// The reference time is moved once the growth factor of the largest decay
+// exceeds exp(max_log_growth)
+static const double max_log_growth = 100.;
+
+HawkesIntensityFilter::HawkesIntensityFilter(const ArrayDouble &baseline,
+                                             const ArrayDouble2d &adjacency,
+                                             const ArrayDouble &decays)
+    : n_nodes(baseline.size()),
+      n_decays(decays.size()),
+      baseline(baseline),
+      decays(decays) {
+  if (n_decays == 0) {
+    TICK_ERROR("At least one decay must be given");
+  }
+  if (adjacency.n_rows() != n_nodes ||
+      adjacency.n_cols() != n_nodes * n_decays) {
+    TICK_ERROR("adjacency must be an array of shape ("
+               << n_nodes << ", " << n_nodes * n_decays << ")");
+  }
+  for (ulong u = 0; u < n_decays; ++u) {
+    if (decays[u] <= 0) {
+      TICK_ERROR("decays must be positive, received " << decays[u]);
+    }
+  }
+  max_decay = decays.max();
+
+  // Adjacency is stored by source node, zero entries are skipped
+  out_indptr.assign(1, 0);
+  for (ulong j = 0; j < n_nodes; ++j) {
+    for (ulong i = 0; i < n_nodes; ++i) {
+      for (ulong u = 0; u < n_decays; ++u) {
+        const double alpha = adjacency(i, j * n_decays + u);
+        if (alpha == 0) continue;
+        out_indices.push_back(i * n_decays + u);
+        out_weights.push_back(alpha * decays[u]);
+      }
+    }
+    out_indptr.push_back(out_indices.size());
+  }
+
+  excitations = ArrayDouble(n_nodes * n_decays);
+  node_reference_times.resize(n_nodes);
+  growths = ArrayDouble(n_decays);
+  shared_factors = ArrayDouble(n_decays);
+  reset();
+}
+
+void HawkesIntensityFilter::reset() {
+  excitations.init_to_zero();
+  reference_time = -std::numeric_limits<double>::infinity();
+  std::fill(node_reference_times.begin(), node_reference_times.end(),
+            reference_time);
+  last_time = -std::numeric_limits<double>::infinity();
+}
+
+void HawkesIntensityFilter::check_node(const ulong node) const {
+  if (node >= n_nodes) {
+    TICK_ERROR("node " << node << " does not exist, process has " << n_nodes
+                       << " nodes");
+  }
+}
+
+void HawkesIntensityFilter::check_time(const double t) const {
+  if (t < last_time) {
+    TICK_ERROR("time " << t << " is older than the last event given ("
+                       << last_time << ")");
+  }
+}
+
+void HawkesIntensityFilter::move_node_reference_time(const ulong i) {
+  const double elapsed = reference_time - node_reference_times[i];
+  for (ulong u = 0; u < n_decays; ++u) {
+    double &excitation = excitations[i * n_decays + u];
+    if (excitation != 0) excitation *= std::exp(-decays[u] * elapsed);
+  }
+  node_reference_times[i] = reference_time;
+}
+
+void HawkesIntensityFilter::on_event(const ulong node, const double t) {
+  check_node(node);
+  check_time(t);
+  add_event(node, t);
+}
+
+void HawkesIntensityFilter::add_event(const ulong node, const double t) {
+  last_time = t;
+
+  // Only the nodes excited by an event are rescaled to the new reference time
+  if (max_decay * (t - reference_time) > max_log_growth) {
+    reference_time = t;
+  }
+  for (ulong u = 0; u < n_decays; ++u) {
+    growths[u] = std::exp(decays[u] * (t - reference_time));
+  }
+
+  for (ulong p = out_indptr[node]; p < out_indptr[node + 1]; ++p) {
+    const ulong i = out_indices[p] / n_decays;
+    if (node_reference_times[i] != reference_time) {
+      move_node_reference_time(i);
+    }
+    excitations[out_indices[p]] +=
+        out_weights[p] * growths[out_indices[p] % n_decays];
+  }
+}
+
+void HawkesIntensityFilter::on_events(const ArrayULong &nodes,
+                                      const ArrayDouble &times,
+                                      ArrayDouble &event_intensities) {
+  if (nodes.size() != times.size() ||
+      event_intensities.size() != times.size()) {
+    TICK_ERROR("nodes (size="
+               << nodes.size() << "), times (size=" << times.size()
+               << ") and event_intensities (size=" << event_intensities.size()
+               << ") should have the same size");
+  }
+  for (ulong k = 0; k < times.size(); ++k) {
+    check_node(nodes[k]);
+    check_time(times[k]);
+    event_intensities[k] = compute_intensity(nodes[k], times[k]);
+    add_event(nodes[k], times[k]);
+  }
+}
+
+double HawkesIntensityFilter::get_intensity(const ulong node,
+                                            const double t) const {
+  check_node(node);
+  check_time(t);
+  return compute_intensity(node, t);
+}
+
+double HawkesIntensityFilter::compute_intensity(const ulong node,
+                                                const double t) const {
+  double intensity = baseline[node];
+  for (ulong u = 0; u < n_decays; ++u) {
+    const double excitation = excitations[node * n_decays + u];
+    if (excitation != 0) {
+      intensity += excitation *
+                   std::exp(-decays[u] * (t - node_reference_times[node]));
+    }
+  }
+  return intensity;
+}
+
+void HawkesIntensityFilter::intensity(const double t,
+                                      ArrayDouble &intensities) const {
+  if (intensities.size() != n_nodes) {
+    TICK_ERROR("intensities must be an array of size " << n_nodes);
+  }
+  check_time(t);
+  // Decay factors are shared by the nodes measured from reference_time
+  for (ulong u = 0; u < n_decays; ++u) {
+    shared_factors[u] = std::exp(-decays[u] * (t - reference_time));
+  }
+  for (ulong i = 0; i < n_nodes; ++i) {
+    if (node_reference_times[i] != reference_time) {
+      intensities[i] = compute_intensity(i, t);
+      continue;
+    }
+    intensities[i] = baseline[i];
+    for (ulong u = 0; u < n_decays; ++u) {
+      intensities[i] += excitations[i * n_decays + u] * shared_factors[u];
+    }
+  }
+}
+
+void HawkesIntensityFilter::compensator(const double t0, const double t1,
+                                        ArrayDouble &compensators) const {
+  if (compensators.size() != n_nodes) {
+    TICK_ERROR("compensators must be an array of size " << n_nodes);
+  }
+  check_time(t0);
+  if (t1 < t0) {
+    TICK_ERROR("t1 (" << t1 << ") must not be older than t0 (" << t0 << ")");
+  }
+  compensators.mult_fill(baseline, t1 - t0);
+  // Integrated factors are shared by the nodes measured from reference_time
+  for (ulong u = 0; u < n_decays; ++u) {
+    shared_factors[u] = (std::exp(-decays[u] * (t0 - reference_time)) -
+                             std::exp(-decays[u] * (t1 - reference_time))) /
+                            decays[u];
+  }
+  for (ulong i = 0; i < n_nodes; ++i) {
+    const double node_reference_time = node_reference_times[i];
+    for (ulong u = 0; u < n_decays; ++u) {
+      const double excitation = excitations[i * n_decays + u];
+      if (excitation == 0) continue;
+      if (node_reference_time == reference_time) {
+        compensators[i] += excitation * shared_factors[u];
+      } else {
+        compensators[i] +=
+            excitation *
+            (std::exp(-decays[u] * (t0 - node_reference_time)) -
+             std::exp(-decays[u] * (t1 - node_reference_time))) /
+            decays[u];
+      }
+    }
+  }
+}
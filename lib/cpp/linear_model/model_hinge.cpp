@@ -14,8 +14,14 @@ T TModelHinge<T, K>::loss_i(const ulong i, const Array<K> &coeffs) {
 
 template <class T, class K>
 T TModelHinge<T, K>::grad_i_factor(const ulong i, const Array<K> &coeffs) {
+  return grad_i_factor_from_inner_prod(i, get_inner_prod(i, coeffs));
+}
+
+template <class T, class K>
+T TModelHinge<T, K>::grad_i_factor_from_inner_prod(const ulong i,
+                                                   const T inner_prod) const {
   const T y = get_label(i);
-  const T z = y * get_inner_prod(i, coeffs);
+  const T z = y * inner_prod;
   if (z <= 1.) {
     return -y;
   } else {
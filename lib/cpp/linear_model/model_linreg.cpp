@@ -36,6 +36,31 @@ T TModelLinReg<T, K>::grad_i_factor(const ulong i, const Array<K> &coeffs) {
   return z - get_label(i);
 }
 
+template <class T, class K>
+T TModelLinReg<T, K>::conjugate_loss_i(const ulong i, const T dual_i) const {
+  // Conjugate of z -> (z - y)^2 / 2
+  return dual_i * dual_i / 2 + dual_i * get_label(i);
+}
+
+template <class T, class K>
+T TModelLinReg<T, K>::loss_i_from_inner_prod(const ulong i,
+                                             const T inner_prod) const {
+  const T d = get_label(i) - inner_prod;
+  return d * d / 2;
+}
+
+template <class T, class K>
+T TModelLinReg<T, K>::grad_i_factor_from_inner_prod(const ulong i,
+                                                    const T inner_prod) const {
+  return inner_prod - get_label(i);
+}
+
+template <class T, class K>
+T TModelLinReg<T, K>::hessian_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
+  return 1;
+}
+
 template <class T, class K>
 void TModelLinReg<T, K>::compute_lip_consts() {
   if (ready_lip_consts) {
@@ -6,6 +6,8 @@
 
 #include "tick/linear_model/model_logreg.h"
 
+#include <limits>
+
 template <class T, class K>
 void TModelLogReg<T, K>::sigmoid(const Array<T> &x, Array<T> &out) {
   for (ulong i = 0; i < x.size(); ++i) {
@@ -37,6 +39,39 @@ T TModelLogReg<T, K>::grad_i_factor(const ulong i, const Array<K> &coeffs) {
   return y_i * (sigmoid(y_i * z_i) - 1);
 }
 
+template <class T, class K>
+T TModelLogReg<T, K>::conjugate_loss_i(const ulong i, const T dual_i) const {
+  // Conjugate of z -> log(1 + exp(-y z)), finite for dual_i = -y s with s in
+  // [0, 1], where it is the negative entropy of s
+  const T s = -get_label(i) * dual_i;
+  if (s < 0 || s > 1) return std::numeric_limits<T>::infinity();
+  T conjugate = 0;
+  if (s > 0) conjugate += s * log(s);
+  if (s < 1) conjugate += (1 - s) * log(1 - s);
+  return conjugate;
+}
+
+template <class T, class K>
+T TModelLogReg<T, K>::loss_i_from_inner_prod(const ulong i,
+                                             const T inner_prod) const {
+  return logistic(get_label(i) * inner_prod);
+}
+
+template <class T, class K>
+T TModelLogReg<T, K>::grad_i_factor_from_inner_prod(const ulong i,
+                                                    const T inner_prod) const {
+  const T y_i = get_label(i);
+  return y_i * (sigmoid(y_i * inner_prod) - 1);
+}
+
+template <class T, class K>
+T TModelLogReg<T, K>::hessian_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
+  // Labels are in { -1, 1 }, so that y_i^2 = 1
+  const T sigmoid_i = sigmoid(get_label(i) * inner_prod);
+  return sigmoid_i * (1 - sigmoid_i);
+}
+
 template <class T, class K>
 T TModelLogReg<T, K>::sdca_dual_min_i(const ulong i, const T dual_i,
                                       const Array<K> &primal_vector,
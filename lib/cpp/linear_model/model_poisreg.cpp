@@ -191,6 +191,46 @@ T TModelPoisReg<T, K>::grad_i_factor(const ulong i, const Array<K> &coeffs) {
   }
 }
 
+template <class T, class K>
+T TModelPoisReg<T, K>::loss_i_from_inner_prod(const ulong i,
+                                              const T inner_prod) const {
+  const T y_i = get_label(i);
+  switch (link_type) {
+    case LinkType::exponential:
+      return exp(inner_prod) - y_i * inner_prod + std::lgamma(y_i + 1);
+    case LinkType::identity:
+      return inner_prod - y_i * log(inner_prod) + std::lgamma(y_i + 1);
+    default:
+      throw std::runtime_error("Undefined link type");
+  }
+}
+
+template <class T, class K>
+T TModelPoisReg<T, K>::grad_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
+  switch (link_type) {
+    case LinkType::exponential:
+      return exp(inner_prod) - get_label(i);
+    case LinkType::identity:
+      return 1 - get_label(i) / inner_prod;
+    default:
+      throw std::runtime_error("Undefined link type");
+  }
+}
+
+template <class T, class K>
+T TModelPoisReg<T, K>::hessian_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
+  switch (link_type) {
+    case LinkType::exponential:
+      return exp(inner_prod);
+    case LinkType::identity:
+      return get_label(i) / (inner_prod * inner_prod);
+    default:
+      throw std::runtime_error("Undefined link type");
+  }
+}
+
 template class DLL_PUBLIC TModelPoisReg<double, double>;
 template class DLL_PUBLIC TModelPoisReg<float, float>;
 
@@ -20,8 +20,14 @@ T TModelSmoothedHinge<T, K>::loss_i(const ulong i, const Array<K> &coeffs) {
 template <class T, class K>
 T TModelSmoothedHinge<T, K>::grad_i_factor(const ulong i,
                                            const Array<K> &coeffs) {
+  return grad_i_factor_from_inner_prod(i, get_inner_prod(i, coeffs));
+}
+
+template <class T, class K>
+T TModelSmoothedHinge<T, K>::grad_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
   const double y = get_label(i);
-  const double z = y * get_inner_prod(i, coeffs);
+  const double z = y * inner_prod;
   if (z >= 1) {
     return 0.;
   } else {
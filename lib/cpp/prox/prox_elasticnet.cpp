@@ -27,6 +27,27 @@ T TProxElasticNet<T, K>::call_single(T x, T step) const {
   return 0;
 }
 
+// Repeat n_times the prox on coordinate i, in closed form: after n steps
+// |x| becomes max(|x| - thresh (1 + c + ... + c^(n-1)), 0) / c^n
+template <class T, class K>
+T TProxElasticNet<T, K>::call_single(T x, T step, ulong n_times) const {
+  if (n_times == 0) return x;
+  if (positive && x < 0) return 0;
+  const T thresh = step * ratio * strength;
+  const T scaling = 1 + step * strength * (1 - ratio);
+  T abs_x;
+  if (scaling == 1) {
+    abs_x = std::abs(x) - n_times * thresh;
+  } else {
+    // Written with c^(-n) so that it does not overflow
+    const T inv_scaling_n = std::pow(scaling, -static_cast<T>(n_times));
+    abs_x = std::abs(x) * inv_scaling_n -
+            thresh * (1 - inv_scaling_n) / (scaling - 1);
+  }
+  if (abs_x <= 0) return 0;
+  return x > 0 ? abs_x : -abs_x;
+}
+
 template <class T, class K>
 T TProxElasticNet<T, K>::value_single(T x) const {
   return (1 - ratio) * 0.5 * x * x + ratio * std::abs(x);
@@ -44,6 +65,14 @@ void TProxElasticNet<T, K>::set_ratio(T ratio) {
   this->ratio = ratio;
 }
 
+template <class T, class K>
+bool TProxElasticNet<T, K>::get_shrinkage(T step, T &threshold,
+                                          T &scaling) const {
+  threshold = step * ratio * strength;
+  scaling = 1 + step * strength * (1 - ratio);
+  return true;
+}
+
 template class DLL_PUBLIC TProxElasticNet<double, double>;
 template class DLL_PUBLIC TProxElasticNet<float, float>;
 
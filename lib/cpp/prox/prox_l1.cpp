@@ -40,6 +40,13 @@ T TProxL1<T, K>::value_single(T x) const {
   return std::abs(x);
 }
 
+template <class T, class K>
+bool TProxL1<T, K>::get_shrinkage(T step, T &threshold, T &scaling) const {
+  threshold = step * strength;
+  scaling = 1;
+  return true;
+}
+
 template class DLL_PUBLIC TProxL1<double, double>;
 template class DLL_PUBLIC TProxL1<float, float>;
 
@@ -31,6 +31,13 @@ T TProxL2Sq<T, K>::value_single(T x) const {
   return x * x / 2;
 }
 
+template <class T, class K>
+bool TProxL2Sq<T, K>::get_shrinkage(T step, T &threshold, T &scaling) const {
+  threshold = 0;
+  scaling = 1 + step * strength;
+  return true;
+}
+
 template class DLL_PUBLIC TProxL2Sq<double, double>;
 template class DLL_PUBLIC TProxL2Sq<float, float>;
 
@@ -0,0 +1,87 @@
+// License: BSD 3 clause
+
+#include "tick/prox/prox_screened.h"
+
+template <class T>
+TProxScreened<T>::TProxScreened(std::shared_ptr<TProxSeparable<T, T> > prox)
+    : TProxSeparable<T, T>(prox->get_strength(), prox->get_positive()),
+      prox(prox) {
+  if (prox->get_has_range()) {
+    this->set_start_end(prox->get_start(), prox->get_end());
+  }
+}
+
+template <class T>
+void TProxScreened<T>::call(const Array<T> &coeffs, T step, Array<T> &out,
+                            ulong start, ulong end) {
+  for (ulong i = start; i < end; ++i) {
+    out[i] = call_single_with_index(coeffs[i], step, i);
+  }
+}
+
+template <class T>
+void TProxScreened<T>::call(const Array<T> &coeffs, const Array<T> &step,
+                            Array<T> &out, ulong start, ulong end) {
+  for (ulong i = start; i < end; ++i) {
+    out[i] = call_single_with_index(coeffs[i], step[i - start], i);
+  }
+}
+
+template <class T>
+void TProxScreened<T>::call_single(ulong i, const Array<T> &coeffs, T step,
+                                   Array<T> &out) const {
+  if (is_discarded(i)) {
+    out[i] = 0;
+  } else {
+    prox->call_single(i, coeffs, step, out);
+  }
+}
+
+template <class T>
+void TProxScreened<T>::call_single(ulong i, const Array<T> &coeffs, T step,
+                                   Array<T> &out, ulong n_times) const {
+  if (is_discarded(i)) {
+    out[i] = 0;
+  } else {
+    prox->call_single(i, coeffs, step, out, n_times);
+  }
+}
+
+template <class T>
+T TProxScreened<T>::call_single_with_index(T x, T step, ulong i) const {
+  return is_discarded(i) ? 0 : prox->call_single_with_index(x, step, i);
+}
+
+template <class T>
+T TProxScreened<T>::value(const Array<T> &coeffs) {
+  return prox->value(coeffs);
+}
+
+template <class T>
+T TProxScreened<T>::value(const Array<T> &coeffs, ulong start, ulong end) {
+  return prox->value(coeffs, start, end);
+}
+
+template <class T>
+bool TProxScreened<T>::get_shrinkage(T step, T &threshold, T &scaling) const {
+  return prox->get_shrinkage(step, threshold, scaling);
+}
+
+template <class T>
+void TProxScreened<T>::discard(const ulong i) {
+  if (i >= discarded.size()) discarded.resize(i + 1, false);
+  discarded[i] = true;
+}
+
+template <class T>
+void TProxScreened<T>::keep(const ulong i) {
+  if (i < discarded.size()) discarded[i] = false;
+}
+
+template <class T>
+void TProxScreened<T>::keep_all() {
+  discarded.clear();
+}
+
+template class DLL_PUBLIC TProxScreened<double>;
+template class DLL_PUBLIC TProxScreened<float>;
@@ -57,6 +57,12 @@ T TProxSeparable<T, K>::call_single_with_index(T x, T step, ulong i) const {
   return is_in_range(i) ? call_single(x, step): x;
 }
 
+template <class T, class K>
+bool TProxSeparable<T, K>::get_shrinkage(T step, T &threshold,
+                                         T &scaling) const {
+  return false;
+}
+
 template <class T, class K>
 T TProxSeparable<T, K>::call_single(T x, T step, ulong n_times) const {
   if (n_times >= 1) {
@@ -17,6 +17,13 @@ T TProxZero<T, K>::value(const Array<K> &coeffs, ulong start, ulong end) {
   return 0.;
 }
 
+template <class T, class K>
+bool TProxZero<T, K>::get_shrinkage(T step, T &threshold, T &scaling) const {
+  threshold = 0;
+  scaling = 1;
+  return true;
+}
+
 template class DLL_PUBLIC TProxZero<double, double>;
 template class DLL_PUBLIC TProxZero<float, float>;
 
@@ -0,0 +1,58 @@
+// License: BSD 3 clause
+
+#include "tick/random/alias_table.h"
+
+#include <vector>
+
+AliasTable::AliasTable(const ArrayDouble &weights)
+    : probabilities(weights.size()),
+      acceptance(weights.size()),
+      aliases(weights.size()) {
+  const ulong n = weights.size();
+  const double sum = weights.sum();
+  if (n == 0 || !(sum > 0) || weights.min() < 0) {
+    TICK_ERROR("AliasTable requires non-negative weights with a positive sum");
+  }
+
+  // Vose's construction: buckets whose scaled probability is below 1 are
+  // completed by an alias taken among the buckets above 1
+  ArrayDouble scaled(n);
+  std::vector<ulong> small, large;
+  for (ulong i = 0; i < n; ++i) {
+    probabilities[i] = weights[i] / sum;
+    scaled[i] = probabilities[i] * n;
+    if (scaled[i] < 1) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    const ulong i_small = small.back();
+    small.pop_back();
+    const ulong i_large = large.back();
+    acceptance[i_small] = scaled[i_small];
+    aliases[i_small] = i_large;
+    scaled[i_large] = (scaled[i_large] + scaled[i_small]) - 1;
+    if (scaled[i_large] < 1) {
+      large.pop_back();
+      small.push_back(i_large);
+    }
+  }
+  // Remaining buckets are full, up to rounding errors
+  for (const ulong i : large) {
+    acceptance[i] = 1;
+    aliases[i] = i;
+  }
+  for (const ulong i : small) {
+    acceptance[i] = 1;
+    aliases[i] = i;
+  }
+}
+
+ulong AliasTable::sample(Rand &rand) const {
+  const ulong n = probabilities.size();
+  const double u = rand.uniform() * n;
+  const ulong i = std::min(static_cast<ulong>(u), n - 1);
+  return u - i < acceptance[i] ? i : aliases[i];
+}
@@ -11,7 +11,13 @@ T TModelAbsoluteRegression<T, K>::loss_i(const ulong i,
 template <class T, class K>
 T TModelAbsoluteRegression<T, K>::grad_i_factor(const ulong i,
                                                 const Array<K> &coeffs) {
-  const T d = get_inner_prod(i, coeffs) - get_label(i);
+  return grad_i_factor_from_inner_prod(i, get_inner_prod(i, coeffs));
+}
+
+template <class T, class K>
+T TModelAbsoluteRegression<T, K>::grad_i_factor_from_inner_prod(
+    const ulong i, const T inner_prod) const {
+  const T d = inner_prod - get_label(i);
   if (d > 0) {
     return 1;
   } else {
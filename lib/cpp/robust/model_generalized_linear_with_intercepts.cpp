@@ -14,6 +14,17 @@ T TModelGeneralizedLinearWithIntercepts<T, K>::get_inner_prod(
   }
 }
 
+template <class T, class K>
+void TModelGeneralizedLinearWithIntercepts<T, K>::get_inner_prods(
+    const ArrayULong &indices, const Array<K> &coeffs, Array<T> &out) const {
+  TModelGeneralizedLinear<T, K>::get_inner_prods(indices, coeffs, out);
+  // Individual intercepts come after the features weights and the intercept
+  const ulong intercepts_start = n_features + static_cast<ulong>(fit_intercept);
+  for (ulong k = 0; k < indices.size(); ++k) {
+    out[k] += coeffs[intercepts_start + indices[k]];
+  }
+}
+
 template <class T, class K>
 void TModelGeneralizedLinearWithIntercepts<T, K>::compute_grad_i(
     const ulong i, const Array<K> &coeffs, Array<T> &out, const bool fill) {
@@ -15,7 +15,13 @@ T TModelHuber<T, K>::loss_i(const ulong i, const Array<K> &coeffs) {
 
 template <class T, class K>
 T TModelHuber<T, K>::grad_i_factor(const ulong i, const Array<K> &coeffs) {
-  const T d = get_inner_prod(i, coeffs) - get_label(i);
+  return grad_i_factor_from_inner_prod(i, get_inner_prod(i, coeffs));
+}
+
+template <class T, class K>
+T TModelHuber<T, K>::grad_i_factor_from_inner_prod(const ulong i,
+                                                   const T inner_prod) const {
+  const T d = inner_prod - get_label(i);
   if (std::abs(d) <= threshold) {
     return d;
   } else {
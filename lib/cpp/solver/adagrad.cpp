@@ -1,7 +1,6 @@
 // License: BSD 3 clause
 
 #include "tick/solver/adagrad.h"
-#include "tick/prox/prox_separable.h"
 
 template <class T>
 TAdaGrad<T>::TAdaGrad(ulong epoch_size, T tol, RandType rand_type, T step,
@@ -20,6 +19,11 @@ void TAdaGrad<T>::solve_one_epoch() {
                << prox->get_class_name());
   }
 
+  if (model->is_sparse()) {
+    solve_sparse(*casted_prox);
+    return;
+  }
+
   Array<T> grad_i(iterate.size());
   grad_i.init_to_zero();
 
@@ -54,6 +58,65 @@ void TAdaGrad<T>::solve_one_epoch() {
   }
 }
 
+template <class T>
+void TAdaGrad<T>::solve_sparse(TProxSeparable<T> &casted_prox) {
+  // The model is sparse, so it is a ModelGeneralizedLinear and the gradient
+  // of sample i is grad_i_factor * x_i
+  const ulong n_features = model->get_n_features();
+  const bool use_intercept = model->use_intercept();
+
+  // We add this constant in case the sqrt below approaches 0.0
+  const T jitter = 1e-6;
+
+  const ulong start_t = t;
+  // Coordinate j has received the first last_prox[j] prox steps of the
+  // epoch. Its step does not change while it is outside of the support, so
+  // the steps it missed are all applied with its current step
+  std::vector<ulong> last_prox(iterate.size(), 0);
+
+  auto apply_missed_prox = [&](const ulong j) {
+    const ulong n_missed = t - start_t - last_prox[j];
+    if (n_missed > 0) {
+      const T step_j = step / std::sqrt(hist_grad[j] + jitter);
+      casted_prox.call_single(j, iterate, step_j, iterate, n_missed);
+      last_prox[j] = t - start_t;
+    }
+  };
+
+  auto update = [&](const ulong j, const T grad_j) {
+    hist_grad[j] += grad_j * grad_j;
+    const T step_j = step / std::sqrt(hist_grad[j] + jitter);
+    iterate[j] -= step_j * grad_j;
+    casted_prox.call_single(j, iterate, step_j, iterate);
+    last_prox[j] = t - start_t + 1;
+  };
+
+  for (t = start_t; t < start_t + epoch_size; ++t) {
+    const ulong i = get_next_i();
+    BaseArray<T> x_i = model->get_features(i);
+    const bool sparse_x_i = x_i.is_sparse();
+    const ulong x_i_nnz = sparse_x_i ? x_i.size_sparse() : n_features;
+    const T *x_i_data = x_i.data();
+    const INDICE_TYPE *x_i_indices = sparse_x_i ? x_i.indices() : nullptr;
+
+    // The gradient only depends on the coordinates of the support
+    for (ulong idx_nnz = 0; idx_nnz < x_i_nnz; ++idx_nnz) {
+      apply_missed_prox(sparse_x_i ? x_i_indices[idx_nnz] : idx_nnz);
+    }
+    if (use_intercept) apply_missed_prox(n_features);
+
+    const T alpha_i = model->grad_i_factor(i, iterate);
+    for (ulong idx_nnz = 0; idx_nnz < x_i_nnz; ++idx_nnz) {
+      update(sparse_x_i ? x_i_indices[idx_nnz] : idx_nnz,
+             alpha_i * x_i_data[idx_nnz]);
+    }
+    if (use_intercept) update(n_features, alpha_i);
+  }
+
+  // Bring all coordinates up to date at the end of the epoch
+  for (ulong j = 0; j < iterate.size(); ++j) apply_missed_prox(j);
+}
+
 template <class T>
 void TAdaGrad<T>::set_starting_iterate(Array<T> &new_iterate) {
   TStoSolver<T>::set_starting_iterate(new_iterate);
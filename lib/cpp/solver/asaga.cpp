@@ -10,6 +10,15 @@ AtomicSAGA<T>::AtomicSAGA(ulong epoch_size, T tol,
   un_threads = (size_t)n_threads;
 }
 
+template <class T>
+void AtomicSAGA<T>::set_batch_size(ulong batch_size) {
+  if (batch_size != 1) {
+    TICK_ERROR("AtomicSAGA steps on one sample at a time, got batch_size "
+               << batch_size);
+  }
+  TBaseSAGA<T, T>::set_batch_size(batch_size);
+}
+
 template <class T>
 void AtomicSAGA<T>::initialize_solver() {
   ulong n_samples = model->get_n_samples();
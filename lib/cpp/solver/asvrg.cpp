@@ -0,0 +1,244 @@
+// License: BSD 3 clause
+
+#include "tick/solver/asvrg.h"
+
+#include <limits>
+#include <thread>
+
+#include "tick/robust/model_generalized_linear_with_intercepts.h"
+
+template <class T>
+AtomicSVRG<T>::AtomicSVRG(ulong epoch_size, T tol, RandType rand_type, T step,
+                          int record_every, int seed, int n_threads)
+    : TStoSolver<T, T>(epoch_size, tol, rand_type, record_every, seed),
+      step(step),
+      ready_step_corrections(false) {
+  set_n_threads(n_threads);
+  set_rand_type(rand_type);
+}
+
+template <class T>
+void AtomicSVRG<T>::set_n_threads(int n_threads) {
+  if (n_threads < 1) {
+    TICK_ERROR("AtomicSVRG needs at least one thread, got " << n_threads);
+  }
+  this->n_threads = n_threads;
+  un_threads = static_cast<size_t>(n_threads);
+}
+
+template <class T>
+void AtomicSVRG<T>::set_model(std::shared_ptr<TModel<T, T>> model) {
+  casted_model = std::dynamic_pointer_cast<TModelGeneralizedLinear<T>>(model);
+  // The inner products computed from the shared iterate ignore individual
+  // intercepts
+  if (!casted_model ||
+      std::dynamic_pointer_cast<TModelGeneralizedLinearWithIntercepts<T>>(
+          model)) {
+    TICK_ERROR(
+        "AtomicSVRG accepts only childs of `ModelGeneralizedLinear` without "
+        "individual intercepts")
+  }
+  TStoSolver<T, T>::set_model(model);
+  ready_step_corrections = false;
+}
+
+template <class T>
+void AtomicSVRG<T>::set_batch_size(ulong batch_size) {
+  if (batch_size != 1) {
+    TICK_ERROR("AtomicSVRG steps on one sample at a time, got batch_size "
+               << batch_size);
+  }
+  TStoSolver<T, T>::set_batch_size(batch_size);
+}
+
+template <class T>
+void AtomicSVRG<T>::set_rand_type(RandType rand_type) {
+  // Each thread draws its samples on its own, either uniformly or from
+  // permutations
+  if (rand_type == RandType::importance) {
+    TICK_ERROR("AtomicSVRG cannot use importance sampling");
+  }
+  TStoSolver<T, T>::set_rand_type(rand_type);
+}
+
+template <class T>
+void AtomicSVRG<T>::prepare_solve() {
+  // The point where we compute the full gradient for variance reduction is the
+  // last iterate of the previous epoch
+  const ulong n_coeffs = iterate.size();
+  fixed_w = Array<T>(n_coeffs);
+  fixed_w.mult_fill(iterate, 1);
+
+  full_gradient = Array<T>(n_coeffs);
+  model->grad(fixed_w, full_gradient);
+
+  // Derivatives at fixed_w are only read during the epoch, so they are
+  // computed once instead of at each step
+  const ulong n_samples = model->get_n_samples();
+  grad_factors_fixed_w = Array<T>(n_samples);
+  for (ulong i = 0; i < n_samples; ++i) {
+    grad_factors_fixed_w[i] = casted_model->grad_i_factor(i, fixed_w);
+  }
+
+  if (shared_iterate.size() != n_coeffs) {
+    shared_iterate = Array<std::atomic<T>>(n_coeffs);
+  }
+  for (ulong j = 0; j < n_coeffs; ++j) shared_iterate[j].store(iterate[j]);
+
+  if (model->is_sparse() && !ready_step_corrections) {
+    compute_step_corrections();
+  }
+}
+
+template <class T>
+void AtomicSVRG<T>::compute_step_corrections() {
+  ulong n_features = model->get_n_features();
+  Array<T> columns_sparsity = casted_model->get_column_sparsity_view();
+  steps_correction = Array<T>(n_features);
+  for (ulong j = 0; j < n_features; ++j) {
+    steps_correction[j] = 1. / columns_sparsity[j];
+  }
+  ready_step_corrections = true;
+}
+
+template <class T>
+void AtomicSVRG<T>::solve_one_epoch() {
+  if (!prox->is_separable()) {
+    TICK_ERROR("AtomicSVRG can be used with a separable prox only.")
+  }
+  auto casted_prox = std::static_pointer_cast<TProxSeparable<T>>(prox);
+
+  prepare_solve();
+
+  // Seeds are drawn from the solver generator so that a seeded solver stays
+  // reproducible up to the scheduling of the threads
+  std::vector<int> thread_seeds(un_threads);
+  for (size_t thread = 0; thread < un_threads; ++thread) {
+    thread_seeds[thread] =
+        rand.uniform_int(0, std::numeric_limits<int>::max());
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < un_threads; ++thread) {
+    threads.emplace_back(&AtomicSVRG<T>::threaded_solve, this, thread,
+                         thread_seeds[thread], std::ref(*casted_prox));
+  }
+  for (size_t thread = 0; thread < un_threads; ++thread) {
+    threads[thread].join();
+  }
+
+  for (ulong j = 0; j < iterate.size(); ++j) {
+    iterate[j] = shared_iterate[j].load();
+  }
+  t += epoch_size;
+}
+
+template <class T>
+ulong AtomicSVRG<T>::get_next_i(const size_t thread, Rand &thread_rand,
+                                std::vector<ulong> &permutation,
+                                ulong &i_perm) {
+  if (rand_type == RandType::perm) {
+    if (permutation.empty()) {
+      const ulong block_start = rand_max * thread / un_threads;
+      const ulong block_end = rand_max * (thread + 1) / un_threads;
+      for (ulong i = block_start; i < block_end; ++i) permutation.push_back(i);
+      i_perm = permutation.size();
+    }
+    if (!permutation.empty()) {
+      if (i_perm == permutation.size()) {
+        // Knuth shuffle of the block
+        for (ulong k = permutation.size() - 1; k > 0; --k) {
+          std::swap(permutation[k],
+                    permutation[thread_rand.uniform_int(ulong{0}, k)]);
+        }
+        i_perm = 0;
+      }
+      return permutation[i_perm++];
+    }
+  }
+  return thread_rand.uniform_int(ulong{0}, rand_max - 1);
+}
+
+template <class T>
+T AtomicSVRG<T>::get_shared_inner_prod(const BaseArray<T> &x_i) const {
+  T inner_prod = 0;
+  if (x_i.is_sparse()) {
+    for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
+      inner_prod += x_i.data()[idx_nnz] *
+                    shared_iterate[x_i.indices()[idx_nnz]].load();
+    }
+  } else {
+    for (ulong j = 0; j < x_i.size(); ++j) {
+      inner_prod += x_i.data()[j] * shared_iterate[j].load();
+    }
+  }
+  if (model->use_intercept()) {
+    inner_prod += shared_iterate[model->get_n_features()].load();
+  }
+  return inner_prod;
+}
+
+template <class T>
+void AtomicSVRG<T>::update_coordinate(const ulong j, const T descent_direction,
+                                      const T prox_step,
+                                      TProxSeparable<T> &casted_prox) {
+  T old_value = shared_iterate[j].load();
+  T new_value;
+  do {
+    new_value = casted_prox.call_single_with_index(
+        old_value - descent_direction, prox_step, j);
+  } while (!shared_iterate[j].compare_exchange_weak(old_value, new_value));
+}
+
+template <class T>
+void AtomicSVRG<T>::threaded_solve(const size_t thread, const int thread_seed,
+                                   TProxSeparable<T> &casted_prox) {
+  const ulong n_features = model->get_n_features();
+  const bool use_intercept = model->use_intercept();
+  const bool is_sparse = model->is_sparse();
+
+  ulong thread_epoch_size = epoch_size / un_threads;
+  thread_epoch_size += thread < (epoch_size % un_threads);
+
+  Rand thread_rand(thread_seed);
+  std::vector<ulong> permutation;
+  ulong i_perm = 0;
+
+  for (ulong step_t = 0; step_t < thread_epoch_size; ++step_t) {
+    const ulong i = get_next_i(thread, thread_rand, permutation, i_perm);
+    BaseArray<T> x_i = model->get_features(i);
+    const T grad_i_diff =
+        casted_model->grad_i_factor_from_inner_prod(
+            i, get_shared_inner_prod(x_i)) -
+        grad_factors_fixed_w[i];
+    if (is_sparse) {
+      // We update the iterate within the support of the features vector,
+      // with the probabilistic correction
+      for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
+        const ulong j = x_i.indices()[idx_nnz];
+        const T step_correction = steps_correction[j];
+        update_coordinate(j,
+                          step * (x_i.data()[idx_nnz] * grad_i_diff +
+                                  step_correction * full_gradient[j]),
+                          step * step_correction, casted_prox);
+      }
+    } else {
+      // Every thread writes all the coordinates, as the full gradient moves
+      // them all at each step
+      for (ulong j = 0; j < n_features; ++j) {
+        update_coordinate(
+            j, step * (x_i.data()[j] * grad_i_diff + full_gradient[j]), step,
+            casted_prox);
+      }
+    }
+    // The intercept is updated at each step, so no step-correction
+    if (use_intercept) {
+      update_coordinate(n_features,
+                        step * (grad_i_diff + full_gradient[n_features]), step,
+                        casted_prox);
+    }
+  }
+}
+
+template class DLL_PUBLIC AtomicSVRG<double>;
+template class DLL_PUBLIC AtomicSVRG<float>;
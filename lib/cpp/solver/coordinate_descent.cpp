@@ -0,0 +1,269 @@
+// License: BSD 3 clause
+
+#include "tick/solver/coordinate_descent.h"
+
+#include <cmath>
+#include <limits>
+
+#include "tick/linear_model/model_poisreg.h"
+
+// Maximum number of times the curvature of a Newton step is doubled
+static const ulong max_backtracks = 64;
+
+// The Poisson loss with identity link is only defined for positive inner
+// products, while coordinate steps start from any iterate and move the
+// inner products freely
+template <class T>
+static void check_link_type(TModel<T, T> &model) {
+  auto casted_model = dynamic_cast<TModelPoisReg<T> *>(&model);
+  if (casted_model && casted_model->get_link_type() == LinkType::identity) {
+    TICK_ERROR("CoordinateDescent cannot be used with ModelPoisReg and an "
+               "identity link");
+  }
+}
+
+template <class T>
+TCoordinateDescent<T>::TCoordinateDescent(ulong epoch_size, T tol,
+                                          RandType rand_type,
+                                          CoordinateDescent_StepType step_type,
+                                          ulong max_active_passes,
+                                          int record_every, int seed)
+    : TStoSolver<T, T>(epoch_size, tol, rand_type, record_every, seed),
+      step_type(step_type),
+      max_active_passes(max_active_passes) {}
+
+template <class T>
+void TCoordinateDescent<T>::set_model(std::shared_ptr<TModel<T, T> > model) {
+  casted_model = std::dynamic_pointer_cast<TModelGeneralizedLinear<T> >(model);
+  if (!casted_model) {
+    TICK_ERROR("CoordinateDescent accepts only generalized linear models");
+  }
+  check_link_type(*model);
+  TStoSolver<T, T>::set_model(model);
+  this->set_rand_max(model->get_n_coeffs());
+  tmp_iterate = Array<T>(model->get_n_coeffs());
+  columns_ready = false;
+  inner_prods_ready = false;
+}
+
+template <class T>
+void TCoordinateDescent<T>::init_columns() {
+  const ulong n_samples = model->get_n_samples();
+  const ulong n_features = model->get_n_features();
+  // Counting sort of the non-zero entries of the rows by column
+  columns_indptr.assign(n_features + 1, 0);
+  for (ulong i = 0; i < n_samples; ++i) {
+    const BaseArray<T> x_i = model->get_features(i);
+    for (ulong idx = 0; idx < x_i.size_data(); ++idx) {
+      const ulong j = x_i.is_dense() ? idx : x_i.indices()[idx];
+      if (x_i.data()[idx] != 0) ++columns_indptr[j + 1];
+    }
+  }
+  for (ulong j = 0; j < n_features; ++j) {
+    columns_indptr[j + 1] += columns_indptr[j];
+  }
+  columns_indices.resize(columns_indptr[n_features]);
+  columns_data.resize(columns_indptr[n_features]);
+  std::vector<INDICE_TYPE> next(columns_indptr.begin(),
+                                columns_indptr.end() - 1);
+  for (ulong i = 0; i < n_samples; ++i) {
+    const BaseArray<T> x_i = model->get_features(i);
+    for (ulong idx = 0; idx < x_i.size_data(); ++idx) {
+      const ulong j = x_i.is_dense() ? idx : x_i.indices()[idx];
+      if (x_i.data()[idx] != 0) {
+        columns_indices[next[j]] = i;
+        columns_data[next[j]] = x_i.data()[idx];
+        ++next[j];
+      }
+    }
+  }
+  complete_columns();
+}
+
+template <class T>
+void TCoordinateDescent<T>::set_col_major_features(
+    const SparseArray2d<T, ColMajor> &features) {
+  if (!model) TICK_ERROR("The model of the solver must be set");
+  const ulong n_features = model->get_n_features();
+  if (features.n_rows() != model->get_n_samples() ||
+      features.n_cols() != n_features) {
+    TICK_ERROR("features must have shape (" << model->get_n_samples() << ", "
+                                            << n_features << "), got ("
+                                            << features.n_rows() << ", "
+                                            << features.n_cols() << ")");
+  }
+  const INDICE_TYPE *indptr = features.row_indices();
+  columns_indptr.assign(indptr, indptr + n_features + 1);
+  columns_indices.assign(features.indices(),
+                         features.indices() + indptr[n_features]);
+  columns_data.assign(features.data(), features.data() + indptr[n_features]);
+  complete_columns();
+}
+
+template <class T>
+void TCoordinateDescent<T>::complete_columns() {
+  const ulong n_samples = model->get_n_samples();
+  const ulong n_coeffs = model->get_n_coeffs();
+  if (model->use_intercept()) {
+    for (ulong i = 0; i < n_samples; ++i) {
+      columns_indices.push_back(i);
+      columns_data.push_back(1);
+    }
+    columns_indptr.push_back(columns_indices.size());
+  }
+  columns_norm_sq = Array<T>(n_coeffs);
+  for (ulong j = 0; j < n_coeffs; ++j) {
+    T norm_sq = 0;
+    for (INDICE_TYPE idx = columns_indptr[j]; idx < columns_indptr[j + 1];
+         ++idx) {
+      norm_sq += columns_data[idx] * columns_data[idx];
+    }
+    columns_norm_sq[j] = norm_sq / n_samples;
+  }
+  columns_ready = true;
+}
+
+template <class T>
+void TCoordinateDescent<T>::init_inner_prods() {
+  const ulong n_samples = model->get_n_samples();
+  inner_prods = Array<T>(n_samples);
+  for (ulong i = 0; i < n_samples; ++i) {
+    inner_prods[i] = casted_model->get_inner_prod(i, iterate);
+  }
+  inner_prods_ready = true;
+}
+
+template <class T>
+void TCoordinateDescent<T>::set_starting_iterate(Array<T> &new_iterate) {
+  TStoSolver<T, T>::set_starting_iterate(new_iterate);
+  inner_prods_ready = false;
+}
+
+// With Newton steps, the curvature is doubled until the quadratic
+// approximation is an upper bound of the loss at the new coordinate, which
+// ensures that the objective decreases
+template <class T>
+T TCoordinateDescent<T>::update_coordinate(const ulong j,
+                                           TProxSeparable<T> &casted_prox) {
+  const ulong n_samples = model->get_n_samples();
+  const INDICE_TYPE start = columns_indptr[j];
+  const INDICE_TYPE end = columns_indptr[j + 1];
+  const bool newton = step_type == CoordinateDescent_StepType::Newton;
+
+  T grad_j = 0;
+  T hessian_j = 0;
+  for (INDICE_TYPE idx = start; idx < end; ++idx) {
+    const ulong i = columns_indices[idx];
+    const T x_ij = columns_data[idx];
+    grad_j +=
+        casted_model->grad_i_factor_from_inner_prod(i, inner_prods[i]) * x_ij;
+    if (newton) {
+      hessian_j += casted_model->hessian_i_factor_from_inner_prod(
+                       i, inner_prods[i]) *
+                   x_ij * x_ij;
+    }
+  }
+  grad_j /= n_samples;
+  if (newton) {
+    hessian_j /= n_samples;
+  } else {
+    hessian_j = casted_model->get_loss_smoothness() * columns_norm_sq[j];
+  }
+  // Empty column, or no curvature to scale the step
+  if (hessian_j <= 0) return 0;
+
+  const T coeff_j = iterate[j];
+  T delta_j = 0;
+  for (ulong n_backtracks = 0; n_backtracks < max_backtracks; ++n_backtracks) {
+    tmp_iterate[j] = coeff_j - grad_j / hessian_j;
+    casted_prox.call_single(j, tmp_iterate, 1 / hessian_j, iterate);
+    delta_j = iterate[j] - coeff_j;
+    if (delta_j == 0 || !newton) break;
+
+    T loss_change = 0;
+    T loss_scale = 0;
+    for (INDICE_TYPE idx = start; idx < end; ++idx) {
+      const ulong i = columns_indices[idx];
+      const T loss_i = casted_model->loss_i_from_inner_prod(i, inner_prods[i]);
+      loss_change += casted_model->loss_i_from_inner_prod(
+                         i, inner_prods[i] + delta_j * columns_data[idx]) -
+                     loss_i;
+      loss_scale += std::abs(loss_i);
+    }
+    // Rounding errors are tolerated, exact steps on quadratic losses would be
+    // rejected otherwise
+    const T upper_bound = grad_j * delta_j +
+                          hessian_j * delta_j * delta_j / 2 +
+                          16 * std::numeric_limits<T>::epsilon() * loss_scale /
+                              n_samples;
+    if (loss_change / n_samples <= upper_bound) break;
+
+    hessian_j *= 2;
+    iterate[j] = coeff_j;
+    delta_j = 0;
+  }
+  if (delta_j == 0) return 0;
+
+  for (INDICE_TYPE idx = start; idx < end; ++idx) {
+    inner_prods[columns_indices[idx]] += delta_j * columns_data[idx];
+  }
+  return std::abs(delta_j);
+}
+
+template <class T>
+void TCoordinateDescent<T>::solve_one_epoch() {
+  if (!prox->is_separable()) {
+    TICK_ERROR("CoordinateDescent can be used with a separable prox only, "
+               "but got "
+               << prox->get_class_name());
+  }
+  auto &casted_prox = static_cast<TProxSeparable<T> &>(*prox);
+  // The link type may have changed since the model was set
+  check_link_type(*model);
+  if (!columns_ready) init_columns();
+  if (!inner_prods_ready) init_inner_prods();
+
+  const ulong n_updates = epoch_size > 0 ? epoch_size : rand_max;
+  t += run_coordinate_updates(n_updates, iterate, [&](ulong j) {
+    return update_coordinate(j, casted_prox);
+  });
+}
+
+template <class T>
+ulong TCoordinateDescent<T>::run_coordinate_updates(
+    const ulong n_updates, const Array<T> &coeffs,
+    const std::function<T(ulong)> &update) {
+  for (ulong k = 0; k < n_updates; ++k) update(get_next_i());
+  ulong n_performed = n_updates;
+
+  // Passes on the coordinates that are not zero
+  std::vector<ulong> active;
+  for (ulong j = 0; j < rand_max; ++j) {
+    if (coeffs[j] != 0) active.push_back(j);
+  }
+  if (active.empty()) return n_performed;
+  for (ulong pass = 0; pass < max_active_passes; ++pass) {
+    if (rand_type == RandType::perm) {
+      for (ulong k = 1; k < active.size(); ++k) {
+        std::swap(active[k], active[rand_unif(k)]);
+      }
+    }
+    T max_delta = 0;
+    for (ulong k = 0; k < active.size(); ++k) {
+      const ulong j = rand_type == RandType::unif
+                          ? active[rand_unif(active.size() - 1)]
+                          : active[k];
+      max_delta = std::max(max_delta, update(j));
+    }
+    n_performed += active.size();
+    T max_coeff = 0;
+    for (ulong j : active) {
+      max_coeff = std::max(max_coeff, std::abs(coeffs[j]));
+    }
+    if (max_delta <= tol * max_coeff) break;
+  }
+  return n_performed;
+}
+
+template class DLL_PUBLIC TCoordinateDescent<double>;
+template class DLL_PUBLIC TCoordinateDescent<float>;
@@ -0,0 +1,139 @@
+// License: BSD 3 clause
+
+#include "tick/solver/newton_cg.h"
+
+#include <cmath>
+#include <limits>
+
+#include "tick/prox/prox_l2sq.h"
+
+// Maximum number of times the step is halved by the line search
+static const ulong max_backtracks = 64;
+
+// Fraction of the decrease predicted by the slope required by the line search
+static const double armijo_fraction = 1e-4;
+
+template <class T>
+TNewtonCG<T>::TNewtonCG(T tol, ulong max_cg_iter, int record_every)
+    : TStoSolver<T, T>(0, tol, RandType::unif, record_every),
+      max_cg_iter(max_cg_iter) {}
+
+template <class T>
+void TNewtonCG<T>::set_model(std::shared_ptr<TModel<T, T> > model) {
+  casted_model = std::dynamic_pointer_cast<TModelGeneralizedLinear<T> >(model);
+  if (!casted_model) {
+    TICK_ERROR("NewtonCG accepts only generalized linear models");
+  }
+  TStoSolver<T, T>::set_model(model);
+}
+
+template <class T>
+void TNewtonCG<T>::set_prox(std::shared_ptr<TProx<T, T> > prox) {
+  const bool is_l2sq =
+      static_cast<bool>(std::dynamic_pointer_cast<TProxL2Sq<T> >(prox));
+  if ((!is_l2sq && !std::dynamic_pointer_cast<TProxZero<T> >(prox)) ||
+      prox->get_positive()) {
+    TICK_ERROR("NewtonCG accepts only ProxZero or ProxL2Sq without positive "
+               "constraint, but got "
+               << prox->get_class_name());
+  }
+  TStoSolver<T, T>::set_prox(prox);
+}
+
+template <class T>
+T TNewtonCG<T>::get_l2sq_strength() const {
+  if (std::dynamic_pointer_cast<TProxL2Sq<T> >(prox)) {
+    return prox->get_strength();
+  }
+  return 0;
+}
+
+template <class T>
+void TNewtonCG<T>::hessian_vector_product(const Array<T> &vector,
+                                          const T l2sq_strength,
+                                          Array<T> &out) {
+  casted_model->hessian_vector_product(iterate, vector, out);
+  if (l2sq_strength == 0) return;
+  for (ulong j = 0; j < out.size(); ++j) {
+    if (prox->is_in_range(j)) out[j] += l2sq_strength * vector[j];
+  }
+}
+
+template <class T>
+void TNewtonCG<T>::compute_direction(const Array<T> &grad,
+                                     const T l2sq_strength,
+                                     Array<T> &direction) {
+  const ulong n_coeffs = grad.size();
+  direction.init_to_zero();
+  Array<T> residual(n_coeffs);
+  residual.mult_fill(grad, -1);
+  Array<T> conjugate(n_coeffs);
+  conjugate.mult_fill(residual, 1);
+  Array<T> hessian_conjugate(n_coeffs);
+
+  const T grad_norm = std::sqrt(grad.norm_sq());
+  const T cg_tol = std::min(T{0.5}, std::sqrt(grad_norm)) * grad_norm;
+  T residual_norm_sq = residual.norm_sq();
+  for (ulong k = 0; k < max_cg_iter; ++k) {
+    if (std::sqrt(residual_norm_sq) <= cg_tol) break;
+    hessian_vector_product(conjugate, l2sq_strength, hessian_conjugate);
+    const T curvature = conjugate.dot(hessian_conjugate);
+    if (curvature <= 0) {
+      // No curvature along the first direction, we follow the gradient
+      if (k == 0) direction.mult_fill(grad, -1);
+      break;
+    }
+    const T alpha = residual_norm_sq / curvature;
+    direction.mult_incr(conjugate, alpha);
+    residual.mult_incr(hessian_conjugate, -alpha);
+    const T new_residual_norm_sq = residual.norm_sq();
+    conjugate *= new_residual_norm_sq / residual_norm_sq;
+    conjugate.mult_incr(residual, 1);
+    residual_norm_sq = new_residual_norm_sq;
+  }
+}
+
+template <class T>
+void TNewtonCG<T>::solve_one_epoch() {
+  const ulong n_coeffs = iterate.size();
+  const T l2sq_strength = get_l2sq_strength();
+
+  Array<T> grad(n_coeffs);
+  model->grad(iterate, grad);
+  for (ulong j = 0; j < n_coeffs; ++j) {
+    if (l2sq_strength != 0 && prox->is_in_range(j)) {
+      grad[j] += l2sq_strength * iterate[j];
+    }
+  }
+  if (grad.norm_sq() == 0) return;
+
+  Array<T> direction(n_coeffs);
+  compute_direction(grad, l2sq_strength, direction);
+  const T slope = grad.dot(direction);
+  // Only happens with rounding errors, at the minimum
+  if (slope >= 0) return;
+
+  const T objective = model->loss(iterate) + prox->value(iterate);
+  // Rounding errors are tolerated, exact steps at the minimum would be
+  // rejected otherwise
+  const T rounding_tol =
+      16 * std::numeric_limits<T>::epsilon() * std::abs(objective);
+  Array<T> new_iterate(n_coeffs);
+  T step = 1;
+  for (ulong n_backtracks = 0; n_backtracks < max_backtracks; ++n_backtracks) {
+    new_iterate.mult_fill(direction, step);
+    new_iterate.mult_incr(iterate, 1);
+    const T new_objective = model->loss(new_iterate) + prox->value(new_iterate);
+    // Also rejects steps out of the domain of the loss, where it is nan
+    if (new_objective <=
+        objective + armijo_fraction * step * slope + rounding_tol) {
+      iterate.mult_fill(new_iterate, 1);
+      break;
+    }
+    step /= 2;
+  }
+  ++t;
+}
+
+template class DLL_PUBLIC TNewtonCG<double>;
+template class DLL_PUBLIC TNewtonCG<float>;
@@ -0,0 +1,208 @@
+// License: BSD 3 clause
+
+#include "tick/solver/path_solver.h"
+
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+
+namespace {
+
+//! @brief Gives back its original prox to a solver when going out of scope,
+//! so that the screened prox of the path is not left behind if a fit throws
+template <class T>
+class ProxRestorer {
+ private:
+  TStoSolver<T> &solver;
+  std::shared_ptr<TProx<T, T> > original_prox;
+
+ public:
+  explicit ProxRestorer(TStoSolver<T> &solver)
+      : solver(solver), original_prox(solver.get_prox()) {}
+
+  ProxRestorer(const ProxRestorer &) = delete;
+  ProxRestorer &operator=(const ProxRestorer &) = delete;
+
+  ~ProxRestorer() { solver.set_prox(original_prox); }
+};
+
+}  // namespace
+
+template <class T>
+TPathSolver<T>::TPathSolver(std::shared_ptr<TStoSolver<T> > solver,
+                            std::shared_ptr<TProxSeparable<T> > prox,
+                            ulong n_epochs, bool screening)
+    : solver(solver), prox(prox), n_epochs(n_epochs), screening(screening) {
+  if (!std::dynamic_pointer_cast<TProxL1<T> >(prox) &&
+      !std::dynamic_pointer_cast<TProxElasticNet<T> >(prox)) {
+    TICK_ERROR("PathSolver accepts only ProxL1 or ProxElasticNet");
+  }
+}
+
+template <class T>
+T TPathSolver<T>::get_l1_ratio() const {
+  auto casted_prox = std::dynamic_pointer_cast<TProxElasticNet<T> >(prox);
+  return casted_prox ? casted_prox->get_ratio() : T{1};
+}
+
+template <class T>
+T TPathSolver<T>::get_kkt_score(const T grad_j) const {
+  // With positive coefficients, zero is optimal as long as the gradient does
+  // not push towards positive values faster than the L1 penalization
+  if (prox->get_positive()) return std::max(-grad_j, T{0});
+  return std::abs(grad_j);
+}
+
+template <class T>
+T TPathSolver<T>::get_strength_max(const Array<T> &grad) const {
+  const T l1_ratio = get_l1_ratio();
+  if (l1_ratio == 0) {
+    TICK_ERROR("PathSolver requires a positive ratio of L1 penalization");
+  }
+  T max_score = 0;
+  for (ulong j = 0; j < grad.size(); ++j) {
+    if (prox->is_in_range(j)) {
+      max_score = std::max(max_score, get_kkt_score(grad[j]));
+    }
+  }
+  return max_score / l1_ratio;
+}
+
+template <class T>
+T TPathSolver<T>::get_strength_max() {
+  auto model = solver->get_model();
+  if (!model) TICK_ERROR("The model of the solver must be set");
+  Array<T> zero(model->get_n_coeffs());
+  zero.init_to_zero();
+  Array<T> grad(model->get_n_coeffs());
+  model->grad(zero, grad);
+  return get_strength_max(grad);
+}
+
+template <class T>
+void TPathSolver<T>::set_strengths(const Array<T> &strengths) {
+  for (ulong k = 0; k < strengths.size(); ++k) {
+    if (strengths[k] <= 0 || (k > 0 && strengths[k] > strengths[k - 1])) {
+      TICK_ERROR("strengths must be positive and decreasing");
+    }
+  }
+  this->strengths = strengths;
+}
+
+template <class T>
+void TPathSolver<T>::fit(Array<T> &coeffs) {
+  solver->solve(n_epochs);
+  solver->get_minimizer(coeffs);
+}
+
+template <class T>
+void TPathSolver<T>::solve() {
+  auto model = solver->get_model();
+  if (!model) TICK_ERROR("The model of the solver must be set");
+  if (strengths.size() == 0) {
+    TICK_ERROR("strengths must be set before calling solve");
+  }
+  const T l1_ratio = get_l1_ratio();
+  n_coeffs = model->get_n_coeffs();
+  const ulong n_strengths = strengths.size();
+
+  // The path starts from the current iterate of the solver
+  Array<T> coeffs(n_coeffs);
+  solver->get_minimizer(coeffs);
+  Array<T> grad(n_coeffs);
+  model->grad(coeffs, grad);
+
+  // The first strong rule is the basic one, as if the previous solution was
+  // the one at the strength for which zero is a solution
+  T previous_strength = strengths[0];
+  if (screening) {
+    previous_strength = std::max(previous_strength, get_strength_max(grad));
+  }
+
+  ProxRestorer<T> prox_restorer(*solver);
+  auto screened_prox = std::make_shared<TProxScreened<T> >(prox);
+  solver->set_prox(screened_prox);
+
+  path_row_indices.assign(1, 0);
+  path_indices.clear();
+  path_data.clear();
+  n_active_features = ArrayULong(n_strengths);
+  n_kkt_violations = ArrayULong(n_strengths);
+
+  for (ulong k = 0; k < n_strengths; ++k) {
+    const T strength = strengths[k];
+    prox->set_strength(strength);
+    screened_prox->keep_all();
+
+    if (screening) {
+      const T threshold = l1_ratio * (2 * strength - previous_strength);
+      bool moved = false;
+      for (ulong j = 0; j < n_coeffs; ++j) {
+        if (prox->is_in_range(j) && get_kkt_score(grad[j]) < threshold) {
+          screened_prox->discard(j);
+          moved |= coeffs[j] != 0;
+          coeffs[j] = 0;
+        }
+      }
+      // Only needed if a previous approximate solution was not sparse
+      // enough, as the solvers apply the prox on the support of the samples
+      if (moved) solver->set_starting_iterate(coeffs);
+    }
+
+    // Discarded features violating the KKT conditions at the solution are
+    // added back, until there is none. Solvers accepting screening skip the
+    // discarded features in their updates, the others only zero them in the
+    // prox
+    n_kkt_violations[k] = 0;
+    while (true) {
+      solver->set_screened_features(screened_prox->get_discarded());
+      fit(coeffs);
+      model->grad(coeffs, grad);
+      ulong n_violations = 0;
+      for (ulong j = 0; j < n_coeffs; ++j) {
+        if (screened_prox->is_discarded(j) &&
+            get_kkt_score(grad[j]) > l1_ratio * strength) {
+          screened_prox->keep(j);
+          ++n_violations;
+        }
+      }
+      if (n_violations == 0) break;
+      n_kkt_violations[k] += n_violations;
+    }
+
+    n_active_features[k] = 0;
+    for (ulong j = 0; j < n_coeffs; ++j) {
+      if (!screened_prox->is_discarded(j)) ++n_active_features[k];
+      if (coeffs[j] != 0) {
+        path_indices.push_back(j);
+        path_data.push_back(coeffs[j]);
+      }
+    }
+    path_row_indices.push_back(path_indices.size());
+    previous_strength = strength;
+  }
+}
+
+template <class T>
+std::shared_ptr<SSparseArray2d<T> > TPathSolver<T>::get_path() const {
+  if (path_row_indices.empty()) return SSparseArray2d<T>::new_ptr(0, 0, 0);
+  const ulong n_rows = path_row_indices.size() - 1;
+  const ulong size_sparse = path_data.size();
+  // Allocations are never empty so that a path of zeros is a valid array
+  T *data;
+  TICK_PYTHON_MALLOC(data, T, std::max(size_sparse, ulong{1}));
+  INDICE_TYPE *indices;
+  TICK_PYTHON_MALLOC(indices, INDICE_TYPE, std::max(size_sparse, ulong{1}));
+  INDICE_TYPE *row_indices;
+  TICK_PYTHON_MALLOC(row_indices, INDICE_TYPE, n_rows + 1);
+  std::copy(path_data.begin(), path_data.end(), data);
+  std::copy(path_indices.begin(), path_indices.end(), indices);
+  std::copy(path_row_indices.begin(), path_row_indices.end(), row_indices);
+
+  auto path = SSparseArray2d<T>::new_ptr(0, 0, 0);
+  path->set_data_indices_rowindices(data, indices, row_indices, n_rows,
+                                    n_coeffs);
+  return path;
+}
+
+template class DLL_PUBLIC TPathSolver<double>;
+template class DLL_PUBLIC TPathSolver<float>;
@@ -0,0 +1,141 @@
+// License: BSD 3 clause
+
+#include "tick/solver/prox_newton.h"
+
+#include <cmath>
+#include <limits>
+
+// Maximum number of times the step is halved by the line search
+static const ulong max_backtracks = 64;
+
+// Fraction of the decrease predicted by the approximation required by the
+// line search
+static const double armijo_fraction = 1e-4;
+
+template <class T>
+TProxNewton<T>::TProxNewton(T tol, RandType rand_type,
+                            ulong max_active_passes, int record_every,
+                            int seed)
+    : TCoordinateDescent<T>(0, tol, rand_type,
+                            CoordinateDescent_StepType::Newton,
+                            max_active_passes, record_every, seed) {}
+
+template <class T>
+T TProxNewton<T>::update_newton_coordinate(const ulong j,
+                                           TProxSeparable<T> &casted_prox) {
+  const T hessian_j = coordinates_hessian[j];
+  // Empty column, or no curvature to scale the step
+  if (hessian_j <= 0) return 0;
+
+  T grad_j = 0;
+  for (INDICE_TYPE idx = columns_indptr[j]; idx < columns_indptr[j + 1];
+       ++idx) {
+    const ulong i = columns_indices[idx];
+    grad_j += (loss_grads[i] + loss_hessians[i] * newton_inner_prods[i]) *
+              columns_data[idx];
+  }
+
+  const T coeff_j = newton_iterate[j];
+  tmp_iterate[j] = coeff_j - grad_j / hessian_j;
+  casted_prox.call_single(j, tmp_iterate, 1 / hessian_j, newton_iterate);
+  const T delta_j = newton_iterate[j] - coeff_j;
+  if (delta_j == 0) return 0;
+
+  for (INDICE_TYPE idx = columns_indptr[j]; idx < columns_indptr[j + 1];
+       ++idx) {
+    newton_inner_prods[columns_indices[idx]] += delta_j * columns_data[idx];
+  }
+  return std::abs(delta_j);
+}
+
+template <class T>
+void TProxNewton<T>::compute_newton_iterate(TProxSeparable<T> &casted_prox) {
+  newton_iterate = Array<T>(rand_max);
+  newton_iterate.mult_fill(iterate, 1);
+  newton_inner_prods = Array<T>(model->get_n_samples());
+  newton_inner_prods.init_to_zero();
+
+  run_coordinate_updates(rand_max, newton_iterate, [&](ulong j) {
+    return update_newton_coordinate(j, casted_prox);
+  });
+}
+
+template <class T>
+void TProxNewton<T>::solve_one_epoch() {
+  if (!prox->is_separable()) {
+    TICK_ERROR("ProxNewton can be used with a separable prox only, but got "
+               << prox->get_class_name());
+  }
+  auto &casted_prox = static_cast<TProxSeparable<T> &>(*prox);
+  if (!columns_ready) init_columns();
+  if (!inner_prods_ready) init_inner_prods();
+
+  const ulong n_samples = model->get_n_samples();
+  loss_grads = Array<T>(n_samples);
+  loss_hessians = Array<T>(n_samples);
+  T loss = 0;
+  T loss_scale = 0;
+  for (ulong i = 0; i < n_samples; ++i) {
+    const T loss_i = casted_model->loss_i_from_inner_prod(i, inner_prods[i]);
+    loss += loss_i;
+    loss_scale += std::abs(loss_i);
+    loss_grads[i] =
+        casted_model->grad_i_factor_from_inner_prod(i, inner_prods[i]) /
+        n_samples;
+    loss_hessians[i] =
+        casted_model->hessian_i_factor_from_inner_prod(i, inner_prods[i]) /
+        n_samples;
+  }
+  loss /= n_samples;
+
+  coordinates_hessian = Array<T>(rand_max);
+  for (ulong j = 0; j < rand_max; ++j) {
+    T hessian_j = 0;
+    for (INDICE_TYPE idx = columns_indptr[j]; idx < columns_indptr[j + 1];
+         ++idx) {
+      hessian_j +=
+          loss_hessians[columns_indices[idx]] * columns_data[idx] *
+          columns_data[idx];
+    }
+    coordinates_hessian[j] = hessian_j;
+  }
+
+  compute_newton_iterate(casted_prox);
+
+  // Decrease of the objective predicted by its first order approximation
+  const T penalization = prox->value(iterate);
+  const T decrease = loss_grads.dot(newton_inner_prods) +
+                     prox->value(newton_iterate) - penalization;
+  // Only happens with rounding errors, at the minimum
+  if (decrease >= 0) return;
+
+  const T objective = loss + penalization;
+  // Rounding errors are tolerated, exact steps at the minimum would be
+  // rejected otherwise
+  const T rounding_tol = 16 * std::numeric_limits<T>::epsilon() *
+                         (loss_scale / n_samples + std::abs(penalization));
+  T step = 1;
+  for (ulong n_backtracks = 0; n_backtracks < max_backtracks; ++n_backtracks) {
+    T new_loss = 0;
+    for (ulong i = 0; i < n_samples; ++i) {
+      new_loss += casted_model->loss_i_from_inner_prod(
+          i, inner_prods[i] + step * newton_inner_prods[i]);
+    }
+    new_loss /= n_samples;
+    for (ulong j = 0; j < rand_max; ++j) {
+      tmp_iterate[j] = iterate[j] + step * (newton_iterate[j] - iterate[j]);
+    }
+    // Also rejects steps out of the domain of the loss, where it is nan
+    if (new_loss + prox->value(tmp_iterate) <=
+        objective + armijo_fraction * step * decrease + rounding_tol) {
+      iterate.mult_fill(tmp_iterate, 1);
+      inner_prods.mult_incr(newton_inner_prods, step);
+      break;
+    }
+    step /= 2;
+  }
+  ++t;
+}
+
+template class DLL_PUBLIC TProxNewton<double>;
+template class DLL_PUBLIC TProxNewton<float>;
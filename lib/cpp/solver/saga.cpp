@@ -3,6 +3,9 @@
 #include "tick/solver/saga.h"
 #include "tick/base_model/model_generalized_linear.h"
 #include "tick/prox/prox_separable.h"
+#include "tick/solver/support_accumulator.h"
+
+#include <cmath>
 
 template <class T, class K>
 TBaseSAGA<T, K>::TBaseSAGA(ulong epoch_size, T tol, RandType rand_type, T step,
@@ -44,14 +47,37 @@ void TBaseSAGA<T, K>::prepare_solve() {
 template <class T, class K>
 void TBaseSAGA<T, K>::compute_step_corrections() {
   ulong n_features = model->get_n_features();
-  Array<T> columns_sparsity = casted_model->get_column_sparsity_view();
+  // Proportion of non-zero entries of each column, or its weighted version
+  // with importance sampling
+  Array<T> columns_sparsity = this->get_support_probabilities();
   steps_correction = Array<T>(n_features);
   for (ulong j = 0; j < n_features; ++j) {
-    steps_correction[j] = 1. / columns_sparsity[j];
+    // With batches, the correction is the inverse probability that feature j
+    // is in the union of the supports of the batch
+    if (batch_size == 1) {
+      steps_correction[j] = 1. / columns_sparsity[j];
+    } else {
+      steps_correction[j] =
+          1. / (1. - std::pow(1. - columns_sparsity[j], batch_size));
+    }
   }
   ready_step_corrections = true;
 }
 
+template <class T, class K>
+void TBaseSAGA<T, K>::set_batch_size(ulong batch_size) {
+  TStoSolver<T, K>::set_batch_size(batch_size);
+  // Step corrections depend on the batch size
+  ready_step_corrections = false;
+}
+
+template <class T, class K>
+void TBaseSAGA<T, K>::set_rand_type(RandType rand_type) {
+  TStoSolver<T, K>::set_rand_type(rand_type);
+  // Step corrections depend on the sampling probabilities
+  ready_step_corrections = false;
+}
+
 template <class T>
 void TSAGA<T>::initialize_solver() {
   ulong n_samples = model->get_n_samples();
@@ -63,6 +89,23 @@ void TSAGA<T>::initialize_solver() {
 }
 
 
+template <class T>
+void TSAGA<T>::restore_screened_features() {
+  if (!solver_ready) return;
+  // The gradients average is computed again from the gradients memory
+  const ulong n_samples = model->get_n_samples();
+  const ulong n_features = model->get_n_features();
+  gradients_average.init_to_zero();
+  Array<T> gradients_average_no_interc = view(gradients_average, 0, n_features);
+  for (ulong i = 0; i < n_samples; ++i) {
+    gradients_average_no_interc.mult_incr(model->get_features(i),
+                                          gradients_memory[i] / n_samples);
+    if (model->use_intercept()) {
+      gradients_average[n_features] += gradients_memory[i] / n_samples;
+    }
+  }
+}
+
 template <class T>
 void TSAGA<T>::solve_one_epoch() {
   prepare_solve();
@@ -76,12 +119,132 @@ void TSAGA<T>::solve_one_epoch() {
           "SAGA::solve_sparse_proba_updates can be used with a separable prox "
           "only.")
     }
-    solve_sparse_proba_updates(use_intercept, n_features);
+    if (batch_size > 1) {
+      solve_sparse_batch(use_intercept, n_features);
+    } else {
+      solve_sparse_proba_updates(use_intercept, n_features);
+    }
+  } else if (batch_size > 1) {
+    solve_dense_batch(use_intercept, n_features);
   } else {
     solve_dense(use_intercept, n_features);
   }
 }
 
+template <class T>
+void TSAGA<T>::compute_grad_factor_diffs(const ArrayULong &batch,
+                                         const Array<T> &factors,
+                                         Array<T> &grad_factor_diffs) const {
+  // Every draw is compared to the memory as it was before the batch, even a
+  // sample drawn several times, so that each term of the direction is the
+  // unbiased SAGA one
+  for (ulong idx = 0; idx < batch_size; ++idx) {
+    grad_factor_diffs[idx] = factors[idx] - gradients_memory[batch[idx]];
+  }
+}
+
+template <class T>
+void TSAGA<T>::update_gradients_memory(const ArrayULong &batch,
+                                       const Array<T> &factors,
+                                       bool use_intercept, ulong n_features) {
+  ulong n_samples = model->get_n_samples();
+  // Sized here as a deserialized solver is ready without it
+  if (sampled_in_batch.size() != n_samples) {
+    sampled_in_batch.assign(n_samples, false);
+  }
+  Array<T> gradients_average_no_interc = view(gradients_average, 0, n_features);
+  for (ulong idx = 0; idx < batch_size; ++idx) {
+    const ulong i = batch[idx];
+    // A sample drawn several times in the batch is stored once
+    if (sampled_in_batch[i]) continue;
+    sampled_in_batch[i] = true;
+    const T grad_factor_diff = factors[idx] - gradients_memory[i];
+    gradients_memory[i] = factors[idx];
+    gradients_average_no_interc.mult_incr(model->get_features(i),
+                                          grad_factor_diff / n_samples);
+    if (use_intercept) {
+      gradients_average[n_features] += grad_factor_diff / n_samples;
+    }
+  }
+  for (ulong idx = 0; idx < batch_size; ++idx) {
+    sampled_in_batch[batch[idx]] = false;
+  }
+}
+
+template <class T>
+void TSAGA<T>::solve_dense_batch(bool use_intercept, ulong n_features) {
+  ArrayULong batch(batch_size);
+  Array<T> factors(batch_size);
+  Array<T> grad_factor_diffs(batch_size);
+  Array<T> direction(n_features);
+
+  const ulong n_batches = get_n_batches();
+  for (ulong k = 0; k < n_batches; ++k) {
+    get_next_batch(batch);
+    // All the factors of the batch are computed at the same iterate
+    model->grad_i_factors(batch, iterate, factors);
+    compute_grad_factor_diffs(batch, factors, grad_factor_diffs);
+    direction.init_to_zero();
+    T intercept_direction = 0;
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      const T weighted_diff = grad_factor_diffs[idx] *
+                              get_sample_weight(batch[idx]) / batch_size;
+      direction.mult_incr(model->get_features(batch[idx]), weighted_diff);
+      intercept_direction += weighted_diff;
+    }
+    for (ulong j = 0; j < n_features; ++j) {
+      if (is_screened(j)) continue;
+      iterate[j] -= step * (direction[j] + gradients_average[j]);
+    }
+    if (use_intercept) {
+      iterate[n_features] -=
+          step * (intercept_direction + gradients_average[n_features]);
+    }
+    update_gradients_memory(batch, factors, use_intercept, n_features);
+    prox->call(iterate, step, iterate);
+  }
+  TStoSolver<T, T>::t += n_batches * batch_size;
+}
+
+template <class T>
+void TSAGA<T>::solve_sparse_batch(bool use_intercept, ulong n_features) {
+  // Same as solve_sparse_proba_updates, each step working on the union of the
+  // supports of the batch with the step corrections of this union
+  ArrayULong batch(batch_size);
+  Array<T> factors(batch_size);
+  Array<T> grad_factor_diffs(batch_size);
+  SupportAccumulator<T> direction(n_features);
+
+  const ulong n_batches = get_n_batches();
+  for (ulong k = 0; k < n_batches; ++k) {
+    get_next_batch(batch);
+    model->grad_i_factors(batch, iterate, factors);
+    compute_grad_factor_diffs(batch, factors, grad_factor_diffs);
+    T intercept_direction = 0;
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      const T weighted_diff = grad_factor_diffs[idx] *
+                              get_sample_weight(batch[idx]) / batch_size;
+      direction.incr(model->get_features(batch[idx]), weighted_diff);
+      intercept_direction += weighted_diff;
+    }
+    for (const ulong j : direction.get_support()) {
+      if (is_screened(j)) continue;
+      const T step_correction = steps_correction[j];
+      iterate[j] -=
+          step * (direction[j] + step_correction * gradients_average[j]);
+      casted_prox->call_single(j, iterate, step * step_correction, iterate);
+    }
+    if (use_intercept) {
+      iterate[n_features] -=
+          step * (intercept_direction + gradients_average[n_features]);
+      casted_prox->call_single(n_features, iterate, step, iterate);
+    }
+    update_gradients_memory(batch, factors, use_intercept, n_features);
+    direction.reset();
+  }
+  TStoSolver<T, T>::t += n_batches * batch_size;
+}
+
 template <class T>
 void TSAGA<T>::solve_dense(bool use_intercept, ulong n_features) {
   ulong n_samples = model->get_n_samples();
@@ -95,17 +258,22 @@ void TSAGA<T>::solve_dense(bool use_intercept, ulong n_features) {
     // Update gradient memory
     gradients_memory[i] = grad_i_factor;
     T grad_factor_diff = grad_i_factor - grad_i_factor_old;
+    // The step uses the difference reweighted with importance sampling
+    T weighted_diff = grad_factor_diff * get_sample_weight(i);
     for (ulong j = 0; j < n_features; ++j) {
+      // Screened features are zero and their gradients average is not kept
+      // up to date
+      if (is_screened(j)) continue;
       T x_ij = x_i._value_dense(j);
       T grad_avg_j = gradients_average[j];
-      iterate[j] -= step * (grad_factor_diff * x_ij + grad_avg_j);
+      iterate[j] -= step * (weighted_diff * x_ij + grad_avg_j);
       // Update the gradients average over seen samples
       gradients_average[j] += grad_factor_diff * x_ij / n_samples;
     }
     // deal with intercept here
     if (use_intercept) {
       iterate[n_features] -=
-          step * (grad_factor_diff + gradients_average[n_features]);
+          step * (weighted_diff + gradients_average[n_features]);
       gradients_average[n_features] += grad_factor_diff / n_samples;
     }
     // Call the prox on the iterate
@@ -134,15 +302,18 @@ void TSAGA<T>::solve_sparse_proba_updates(bool use_intercept,
     T grad_i_factor_old = gradients_memory[i];
     gradients_memory[i] = grad_i_factor;
     T grad_factor_diff = grad_i_factor - grad_i_factor_old;
+    // The step uses the difference reweighted with importance sampling
+    T weighted_diff = grad_factor_diff * get_sample_weight(i);
     for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
       // Get the index of the idx-th sparse feature of x_i
       ulong j = x_i.indices()[idx_nnz];
+      if (is_screened(j)) continue;
       T x_ij = x_i.data()[idx_nnz];
       T grad_avg_j = gradients_average[j];
       // Step-size correction for coordinate j
       T step_correction = steps_correction[j];
       iterate[j] -=
-          step * (grad_factor_diff * x_ij + step_correction * grad_avg_j);
+          step * (weighted_diff * x_ij + step_correction * grad_avg_j);
       gradients_average[j] += grad_factor_diff * x_ij / n_samples;
       // Prox is separable, apply regularization on the current coordinate
       casted_prox->call_single(j, iterate, step * step_correction, iterate);
@@ -153,7 +324,7 @@ void TSAGA<T>::solve_sparse_proba_updates(bool use_intercept,
     // weird desire to to regularize the intercept)
     if (use_intercept) {
       iterate[n_features] -=
-          step * (grad_factor_diff + gradients_average[n_features]);
+          step * (weighted_diff + gradients_average[n_features]);
       gradients_average[n_features] += grad_factor_diff / n_samples;
       casted_prox->call_single(n_features, iterate, step, iterate);
     }
@@ -5,13 +5,20 @@
 //
 
 #include "tick/solver/sdca.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 #include "tick/linear_model/model_poisreg.h"
 #include "tick/prox/prox_zero.h"
 
 template <class T, class K>
 TSDCA<T, K>::TSDCA(T l_l2sq, ulong epoch_size, T tol, RandType rand_type,
-                   int record_every, int seed)
-    : TStoSolver<T, K>(epoch_size, tol, rand_type, record_every, seed), l_l2sq(l_l2sq) {
+                   int record_every, int seed, size_t n_threads)
+    : TStoSolver<T, K>(epoch_size, tol, rand_type, record_every, seed),
+      l_l2sq(l_l2sq),
+      n_threads(n_threads) {
   stored_variables_ready = false;
 }
 
@@ -35,6 +42,23 @@ void TSDCA<T, K>::solve_one_epoch() {
     set_starting_iterate();
   }
 
+  // With a separable prox, only the coordinates of the support of the
+  // features need to go through the prox
+  std::shared_ptr<TProxSeparable<T, K>> casted_prox;
+  if (prox->is_separable()) {
+    casted_prox = std::static_pointer_cast<TProxSeparable<T, K>>(prox);
+  }
+
+  if (n_threads > 1) {
+    if (!casted_prox) {
+      TICK_ERROR("SDCA with several threads can be used with a separable "
+                 "prox only, but got "
+                 << prox->get_class_name());
+    }
+    solve_one_epoch_parallel(*casted_prox);
+    return;
+  }
+
   const SArrayULongPtr feature_index_map = model->get_sdca_index_map();
   const T scaled_l_l2sq = get_scaled_l_l2sq();
 
@@ -69,7 +93,171 @@ void TSDCA<T, K>::solve_one_epoch() {
       tmp_primal_vector.mult_incr(features_i, delta_dual_i * _1_over_lbda_n);
     }
     // Call prox on the primal variable
-    prox->call(tmp_primal_vector, 1. / scaled_l_l2sq, iterate);
+    if (casted_prox) {
+      const T prox_step = 1. / scaled_l_l2sq;
+      if (features_i.is_sparse()) {
+        for (ulong idx_nnz = 0; idx_nnz < features_i.size_sparse();
+             ++idx_nnz) {
+          casted_prox->call_single(features_i.indices()[idx_nnz],
+                                   tmp_primal_vector, prox_step, iterate);
+        }
+      } else {
+        for (ulong j = 0; j < features_i.size(); ++j) {
+          casted_prox->call_single(j, tmp_primal_vector, prox_step, iterate);
+        }
+      }
+      if (model->use_intercept()) {
+        casted_prox->call_single(model->get_n_features(), tmp_primal_vector,
+                                 prox_step, iterate);
+      }
+    } else {
+      prox->call(tmp_primal_vector, 1. / scaled_l_l2sq, iterate);
+    }
+  }
+}
+
+template <class T, class K>
+void TSDCA<T, K>::solve_one_epoch_parallel(
+    TProxSeparable<T, K> &casted_prox) {
+  Array<std::atomic<T>> shared_primal_vector(n_coeffs);
+  Array<std::atomic<T>> shared_iterate(n_coeffs);
+  for (ulong j = 0; j < n_coeffs; ++j) {
+    shared_primal_vector[j].store(tmp_primal_vector[j]);
+    shared_iterate[j].store(iterate[j]);
+  }
+
+  // Each thread owns a non empty block of dual coordinates, there are no
+  // more threads than dual coordinates
+  const size_t n_active_threads =
+      std::min(n_threads, static_cast<size_t>(rand_max));
+
+  // Seeds are drawn from the solver generator so that a seeded solver stays
+  // reproducible up to the scheduling of the threads
+  std::vector<int> thread_seeds(n_active_threads);
+  for (size_t thread = 0; thread < n_active_threads; ++thread) {
+    thread_seeds[thread] =
+        this->rand.uniform_int(0, std::numeric_limits<int>::max());
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < n_active_threads; ++thread) {
+    threads.emplace_back(&TSDCA<T, K>::threaded_solve_one_epoch, this, thread,
+                         n_active_threads, thread_seeds[thread],
+                         std::ref(shared_primal_vector),
+                         std::ref(shared_iterate), std::ref(casted_prox));
+  }
+  for (size_t thread = 0; thread < n_active_threads; ++thread) {
+    threads[thread].join();
+  }
+
+  for (ulong j = 0; j < n_coeffs; ++j) {
+    tmp_primal_vector[j] = shared_primal_vector[j].load();
+  }
+  // Lock-free writes may have left some coordinates of the iterate behind
+  // the primal vector they come from
+  for (ulong j = 0; j < n_coeffs; ++j) {
+    casted_prox.call_single(j, tmp_primal_vector, 1. / get_scaled_l_l2sq(),
+                            iterate);
+  }
+  t += epoch_size;
+}
+
+template <class T, class K>
+void TSDCA<T, K>::threaded_solve_one_epoch(
+    const size_t thread, const size_t n_active_threads, const int thread_seed,
+    Array<std::atomic<T>> &shared_primal_vector,
+    Array<std::atomic<T>> &shared_iterate, TProxSeparable<T, K> &casted_prox) {
+  // Dual coordinates of this thread, dual_vector and delta are only written
+  // on them
+  const ulong block_start = rand_max * thread / n_active_threads;
+  const ulong block_end = rand_max * (thread + 1) / n_active_threads;
+  const ulong block_size = block_end - block_start;
+
+  ulong thread_epoch_size = epoch_size / n_active_threads;
+  thread_epoch_size += thread < (epoch_size % n_active_threads);
+
+  const SArrayULongPtr feature_index_map = model->get_sdca_index_map();
+  const T scaled_l_l2sq = get_scaled_l_l2sq();
+  const T _1_over_lbda_n = 1 / (scaled_l_l2sq * rand_max);
+  const T prox_step = 1. / scaled_l_l2sq;
+  const bool use_intercept = model->use_intercept();
+  const ulong n_features = model->get_n_features();
+
+  Rand thread_rand(thread_seed);
+  std::vector<ulong> permutation;
+  ulong i_perm = block_size;
+  if (this->rand_type == RandType::perm) {
+    permutation.resize(block_size);
+    for (ulong k = 0; k < block_size; ++k) permutation[k] = block_start + k;
+  }
+
+  // Copy of the shared iterate read by the model, only refreshed on the
+  // support of the features of the sampled dual coordinate
+  Array<T> local_iterate(n_coeffs);
+  local_iterate.init_to_zero();
+  auto load_iterate = [&](const ulong j) {
+    local_iterate[j] = shared_iterate[j].load();
+  };
+
+  // Adds delta to the j-th coordinate of the primal vector before prox and
+  // updates the shared iterate accordingly
+  auto update_primal = [&](const ulong j, const T delta) {
+    T old_value = shared_primal_vector[j].load();
+    while (!shared_primal_vector[j].compare_exchange_weak(old_value,
+                                                          old_value + delta)) {
+    }
+    shared_iterate[j].store(
+        casted_prox.call_single_with_index(old_value + delta, prox_step, j));
+  };
+
+  for (ulong step = 0; step < thread_epoch_size; ++step) {
+    ulong i;
+    if (this->rand_type == RandType::perm) {
+      if (i_perm == block_size) {
+        // Knuth shuffle of the block
+        for (ulong k = block_size - 1; k > 0; --k) {
+          std::swap(permutation[k],
+                    permutation[thread_rand.uniform_int(0ul, k)]);
+        }
+        i_perm = 0;
+      }
+      i = permutation[i_perm++];
+    } else {
+      i = block_start + thread_rand.uniform_int(0ul, block_size - 1);
+    }
+    ulong feature_index = i;
+    if (feature_index_map != nullptr) {
+      feature_index = (*feature_index_map)[i];
+    }
+    BaseArray<T> features_i = model->get_features(feature_index);
+    if (features_i.is_sparse()) {
+      for (ulong idx_nnz = 0; idx_nnz < features_i.size_sparse(); ++idx_nnz) {
+        load_iterate(features_i.indices()[idx_nnz]);
+      }
+    } else {
+      for (ulong j = 0; j < features_i.size(); ++j) load_iterate(j);
+    }
+    if (use_intercept) load_iterate(n_features);
+
+    // Maximize the dual coordinate i
+    const T delta_dual_i = model->sdca_dual_min_i(
+        feature_index, dual_vector[i], local_iterate, delta[i], scaled_l_l2sq);
+    dual_vector[i] += delta_dual_i;
+    delta[i] = delta_dual_i;
+
+    // Update the shared primal variable on the support of the features
+    const T primal_delta = delta_dual_i * _1_over_lbda_n;
+    if (features_i.is_sparse()) {
+      for (ulong idx_nnz = 0; idx_nnz < features_i.size_sparse(); ++idx_nnz) {
+        update_primal(features_i.indices()[idx_nnz],
+                      features_i.data()[idx_nnz] * primal_delta);
+      }
+    } else {
+      for (ulong j = 0; j < features_i.size(); ++j) {
+        update_primal(j, features_i.data()[j] * primal_delta);
+      }
+    }
+    if (use_intercept) update_primal(n_features, primal_delta);
   }
 }
 
@@ -6,46 +6,295 @@
 
 #include "tick/solver/sgd.h"
 
+#include <cmath>
+#include <limits>
+
+#include "tick/prox/prox_separable.h"
+#include "tick/solver/support_accumulator.h"
+
 template <class T, class K>
 TSGD<T, K>::TSGD(ulong epoch_size, T tol, RandType rand_type, T step, int record_every, int seed)
     : TStoSolver<T, K>(epoch_size, tol, rand_type, record_every, seed), step(step) {}
 
 template <class T, class K>
 void TSGD<T, K>::solve_one_epoch() {
-  if (model->is_sparse()) {
+  if (model->is_sparse() ||
+      (batch_size == 1 && model->has_grad_i_sparse())) {
     solve_sparse();
+  } else if (batch_size > 1) {
+    solve_dense_batch();
   } else {
-    // Dense case
-    Array<T> grad(iterate.size());
-    grad.init_to_zero();
+    solve_dense();
+  }
+}
+
+template <class T, class K>
+void TSGD<T, K>::solve_dense() {
+  Array<T> grad(iterate.size());
+  grad.init_to_zero();
+
+  const ulong start_t = t;
+  for (t = start_t; t < start_t + epoch_size; ++t) {
+    const ulong i = get_next_i();
+    model->grad_i(i, iterate, grad);
+    step_t = get_step_t();
+    iterate.mult_incr(grad, -step_t * get_sample_weight(i));
+    prox->call(iterate, step_t, iterate);
+  }
+}
+
+template <class T, class K>
+void TSGD<T, K>::solve_dense_batch() {
+  Array<T> grad(iterate.size());
+  Array<T> batch_grad(iterate.size());
+  ArrayULong batch(batch_size);
+
+  const ulong n_batches = get_n_batches();
+  for (ulong k = 0; k < n_batches; ++k) {
+    get_next_batch(batch);
+    step_t = get_step_t();
+    // Average of the gradients of the batch, all taken at the same iterate
+    batch_grad.init_to_zero();
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      model->grad_i(batch[idx], iterate, grad);
+      batch_grad.mult_incr(grad, get_sample_weight(batch[idx]) / batch_size);
+    }
+    iterate.mult_incr(batch_grad, -step_t);
+    prox->call(iterate, step_t, iterate);
+    t += batch_size;
+  }
+}
+
+template <class T, class K>
+void TSGD<T, K>::solve_sparse() {
+  // The lazy updates require a prox that composes in closed form
+  T threshold, scaling;
+  std::shared_ptr<TProxSeparable<T, K>> casted_prox;
+  if (prox->is_separable()) {
+    casted_prox = std::static_pointer_cast<TProxSeparable<T, K>>(prox);
+  }
+  if (!casted_prox || !casted_prox->get_shrinkage(step, threshold, scaling)) {
+    if (model->is_sparse()) {
+      solve_sparse_full_prox();
+    } else {
+      solve_dense();
+    }
+    return;
+  }
+
+  // A sparse model is a ModelGeneralizedLinear and the iteration looks a
+  // little bit different. Otherwise the model gives the supports of the
+  // gradients, with no features nor intercept
+  const bool is_sparse = model->is_sparse();
+  const ulong n_features = is_sparse ? model->get_n_features() : 0;
+  const bool use_intercept = is_sparse && model->use_intercept();
+  const bool positive = casted_prox->get_positive();
+
+  // Coordinate j has received the first last_prox[j] prox steps of the epoch.
+  // The prox steps k0 < k <= k1 it missed compose into
+  // |x| <- max(|x| C_k0 - (A_k1 - A_k0), 0) / C_k1, where C_k is the product
+  // of the scalings of the first k steps and A_k the sum of their thresholds,
+  // each one multiplied by the scalings of the steps preceding it
+  std::vector<ulong> last_prox(iterate.size(), 0);
+  std::vector<T> cum_thresholds{0}, cum_scalings{1};
+  ulong n_prox = 0, first_cum_prox = 0;
+  // Cumulated scalings grow geometrically, they are restarted before they
+  // overflow
+  const T max_cum_scaling = std::sqrt(std::numeric_limits<T>::max());
+
+  auto apply_missed_prox = [&](const ulong j) {
+    const ulong k0 = last_prox[j];
+    if (k0 == n_prox) return;
+    last_prox[j] = n_prox;
+    const T x_j = iterate[j];
+    if (x_j == 0 || !casted_prox->is_in_range(j)) return;
+    if ((positive && x_j < 0) || casted_prox->is_discarded(j)) {
+      iterate[j] = 0;
+      return;
+    }
+    const ulong c0 = k0 - first_cum_prox, c1 = n_prox - first_cum_prox;
+    const T shrunk = std::abs(x_j) * cum_scalings[c0] -
+                     (cum_thresholds[c1] - cum_thresholds[c0]);
+    iterate[j] =
+        shrunk > 0 ? std::copysign(shrunk / cum_scalings[c1], x_j) : 0;
+  };
+
+  auto apply_missed_prox_support = [&](const BaseArray<T> &x_i) {
+    if (x_i.is_sparse()) {
+      for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
+        apply_missed_prox(x_i.indices()[idx_nnz]);
+      }
+    } else {
+      for (ulong j = 0; j < n_features; ++j) apply_missed_prox(j);
+    }
+    if (use_intercept) apply_missed_prox(n_features);
+  };
+
+  auto record_prox_step = [&]() {
+    casted_prox->get_shrinkage(step_t, threshold, scaling);
+    cum_thresholds.push_back(cum_thresholds.back() +
+                             threshold * cum_scalings.back());
+    cum_scalings.push_back(cum_scalings.back() * scaling);
+    n_prox++;
+  };
+
+  auto restart_cum_prox = [&]() {
+    if (cum_scalings.back() > max_cum_scaling) {
+      for (ulong j = 0; j < iterate.size(); ++j) apply_missed_prox(j);
+      cum_thresholds.assign(1, 0);
+      cum_scalings.assign(1, 1);
+      first_cum_prox = n_prox;
+    }
+  };
 
+  if (!is_sparse) {
+    // The gradients of the samples are given on their supports by the model,
+    // as with Hawkes log-likelihoods
+    std::vector<ulong> support;
+    Array<T> grad(iterate.size());
     const ulong start_t = t;
     for (t = start_t; t < start_t + epoch_size; ++t) {
       const ulong i = get_next_i();
-      model->grad_i(i, iterate, grad);
+      model->get_grad_i_support(i, support);
+      for (const ulong j : support) apply_missed_prox(j);
+      model->grad_i_sparse(i, iterate, grad);
       step_t = get_step_t();
-      iterate.mult_incr(grad, -step_t);
-      prox->call(iterate, step_t, iterate);
+      const T delta = -step_t * get_sample_weight(i);
+      for (const ulong j : support) iterate[j] += delta * grad[j];
+      record_prox_step();
+      for (const ulong j : support) apply_missed_prox(j);
+      restart_cum_prox();
+    }
+    for (ulong j = 0; j < iterate.size(); ++j) apply_missed_prox(j);
+    return;
+  }
+
+  if (batch_size > 1) {
+    // Each step works on the union of the supports of the batch
+    ArrayULong batch(batch_size);
+    Array<T> factors(batch_size);
+    SupportAccumulator<T> direction(n_features);
+
+    auto apply_missed_prox_batch_support = [&]() {
+      for (const ulong j : direction.get_support()) apply_missed_prox(j);
+      if (use_intercept) apply_missed_prox(n_features);
+    };
+
+    const ulong n_batches = get_n_batches();
+    for (ulong k = 0; k < n_batches; ++k) {
+      get_next_batch(batch);
+      for (ulong idx = 0; idx < batch_size; ++idx) {
+        direction.add_support(model->get_features(batch[idx]));
+      }
+      apply_missed_prox_batch_support();
+      // All the factors of the batch are computed at the same iterate
+      model->grad_i_factors(batch, iterate, factors);
+      for (ulong idx = 0; idx < batch_size; ++idx) {
+        factors[idx] *= get_sample_weight(batch[idx]);
+      }
+      step_t = get_step_t();
+      T intercept_direction = 0;
+      for (ulong idx = 0; idx < batch_size; ++idx) {
+        direction.incr(model->get_features(batch[idx]),
+                       factors[idx] / batch_size);
+        intercept_direction += factors[idx] / batch_size;
+      }
+      for (const ulong j : direction.get_support()) {
+        iterate[j] -= step_t * direction[j];
+      }
+      if (use_intercept) iterate[n_features] -= step_t * intercept_direction;
+
+      // One prox per batch, applied on the union of the supports
+      record_prox_step();
+      apply_missed_prox_batch_support();
+      direction.reset();
+      restart_cum_prox();
+      t += batch_size;
     }
+
+    for (ulong j = 0; j < iterate.size(); ++j) apply_missed_prox(j);
+    return;
   }
+
+  const ulong start_t = t;
+  for (t = start_t; t < start_t + epoch_size; ++t) {
+    ulong i = get_next_i();
+    // Sparse features vector
+    BaseArray<T> x_i = model->get_features(i);
+    // The gradient only depends on the coordinates of the support
+    apply_missed_prox_support(x_i);
+    // Gradient factor, reweighted with importance sampling
+    T alpha_i = model->grad_i_factor(i, iterate) * get_sample_weight(i);
+    // Update the step
+    step_t = get_step_t();
+    T delta = -step_t * alpha_i;
+    if (use_intercept) {
+      // Get the features vector, which is sparse here
+      Array<T> iterate_no_interc = view(iterate, 0, n_features);
+      iterate_no_interc.mult_incr(x_i, delta);
+      iterate[n_features] += delta;
+    } else {
+      // Stochastic gradient descent step
+      iterate.mult_incr(x_i, delta);
+    }
+
+    // The prox of this step is only applied on the support, the other
+    // coordinates will get it once needed
+    record_prox_step();
+    apply_missed_prox_support(x_i);
+    restart_cum_prox();
+  }
+
+  // Bring all coordinates up to date at the end of the epoch
+  for (ulong j = 0; j < iterate.size(); ++j) apply_missed_prox(j);
 }
 
 template <class T, class K>
-void TSGD<T, K>::solve_sparse() {
+void TSGD<T, K>::solve_sparse_full_prox() {
   // The model is sparse, so it is a ModelGeneralizedLinear and the iteration
   // looks a little bit different
   ulong n_features = model->get_n_features();
   bool use_intercept = model->use_intercept();
 
+  if (batch_size > 1) {
+    ArrayULong batch(batch_size);
+    Array<T> factors(batch_size);
+    SupportAccumulator<T> direction(n_features);
+    const ulong n_batches = get_n_batches();
+    for (ulong k = 0; k < n_batches; ++k) {
+      get_next_batch(batch);
+      model->grad_i_factors(batch, iterate, factors);
+      for (ulong idx = 0; idx < batch_size; ++idx) {
+        factors[idx] *= get_sample_weight(batch[idx]);
+      }
+      step_t = get_step_t();
+      T intercept_direction = 0;
+      for (ulong idx = 0; idx < batch_size; ++idx) {
+        direction.incr(model->get_features(batch[idx]),
+                       factors[idx] / batch_size);
+        intercept_direction += factors[idx] / batch_size;
+      }
+      for (const ulong j : direction.get_support()) {
+        iterate[j] -= step_t * direction[j];
+      }
+      if (use_intercept) iterate[n_features] -= step_t * intercept_direction;
+      direction.reset();
+      // Apply the prox on all coordinates, once per batch
+      prox->call(iterate, step_t, iterate);
+      t += batch_size;
+    }
+    return;
+  }
+
   ulong start_t = t;
   for (t = start_t; t < start_t + epoch_size; ++t) {
     ulong i = get_next_i();
     // Sparse features vector
     BaseArray<T> x_i = model->get_features(i);
-    // Gradient factor
-    T alpha_i = model->grad_i_factor(i, iterate);
+    // Gradient factor, reweighted with importance sampling
+    T alpha_i = model->grad_i_factor(i, iterate) * get_sample_weight(i);
     // Update the step
-    T step_t = get_step_t();
+    step_t = get_step_t();
     T delta = -step_t * alpha_i;
     if (use_intercept) {
       // Get the features vector, which is sparse here
@@ -56,7 +305,7 @@ void TSGD<T, K>::solve_sparse() {
       // Stochastic gradient descent step
       iterate.mult_incr(x_i, delta);
     }
-    // Apply the prox. No lazy-updating here yet
+    // Apply the prox on all coordinates
     prox->call(iterate, step_t, iterate);
   }
 }
@@ -6,6 +6,15 @@
 
 #include "tick/solver/sto_solver.h"
 
+#include "tick/base_model/model_generalized_linear.h"
+#include "tick/base_model/model_labels_features.h"
+#include "tick/base_model/model_lipschitz.h"
+#include "tick/prox/prox_elasticnet.h"
+#include "tick/prox/prox_l1.h"
+#include "tick/prox/prox_screened.h"
+
+#include <cmath>
+
 template <class T, class K>
 void TStoSolver<T, K>::init_permutation() {
   if ((rand_type == RandType::perm) && (rand_max > 0)) {
@@ -14,12 +23,210 @@ void TStoSolver<T, K>::init_permutation() {
   }
 }
 
+template <class T, class K>
+void TStoSolver<T, K>::init_importance_sampling() {
+  if (importance_ready) return;
+  if (!accepts_importance_sampling()) {
+    TICK_ERROR(get_class_name() << " does not accept RandType::importance")
+  }
+  auto casted_model =
+      std::dynamic_pointer_cast<TModelLipschitz<T, K> >(model);
+  if (!casted_model) {
+    TICK_ERROR(
+        "RandType::importance requires a model with Lipschitz constants")
+  }
+  Array<T> lip_consts = casted_model->get_lip_consts();
+  if (lip_consts.size() != rand_max) {
+    TICK_ERROR("RandType::importance requires one Lipschitz constant per "
+               "sample, got "
+               << lip_consts.size() << " for " << rand_max << " samples")
+  }
+  ArrayDouble weights(rand_max);
+  for (ulong i = 0; i < rand_max; ++i) weights[i] = lip_consts[i];
+  importance_sampler = AliasTable(weights);
+  importance_weights = Array<T>(rand_max);
+  for (ulong i = 0; i < rand_max; ++i) {
+    importance_weights[i] =
+        1. / (rand_max * importance_sampler.get_probability(i));
+  }
+  importance_ready = true;
+}
+
+template <class T, class K>
+T TStoSolver<T, K>::get_sample_probability(const ulong i) {
+  if (rand_type == RandType::importance) {
+    init_importance_sampling();
+    return importance_sampler.get_probability(i);
+  }
+  return T{1} / rand_max;
+}
+
+template <class T, class K>
+Array<T> TStoSolver<T, K>::get_support_probabilities() {
+  const ulong n_features = model->get_n_features();
+  if (rand_type != RandType::importance) {
+    // Uniform draws, this is the proportion of non-zero entries of the column
+    auto casted_model =
+        std::dynamic_pointer_cast<TModelLabelsFeatures<T, K> >(model);
+    return casted_model->get_column_sparsity_view();
+  }
+  init_importance_sampling();
+  Array<T> support_probabilities(n_features);
+  support_probabilities.init_to_zero();
+  for (ulong i = 0; i < rand_max; ++i) {
+    const BaseArray<T> x_i = model->get_features(i);
+    const T p_i = importance_sampler.get_probability(i);
+    for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
+      support_probabilities[x_i.indices()[idx_nnz]] += p_i;
+    }
+  }
+  return support_probabilities;
+}
+
+template <class T, class K>
+void TStoSolver<T, K>::get_screening_strengths(T &l1_strength,
+                                               T &l2_strength) const {
+  // The penalization of a screened prox is the one it wraps
+  auto penalization = prox;
+  if (auto screened_prox = std::dynamic_pointer_cast<TProxScreened<T> >(prox)) {
+    penalization =
+        std::dynamic_pointer_cast<TProx<T, K> >(screened_prox->get_prox());
+  }
+  T l1_ratio = 1;
+  if (auto casted_prox =
+          std::dynamic_pointer_cast<TProxElasticNet<T, K> >(penalization)) {
+    l1_ratio = casted_prox->get_ratio();
+  } else if (!std::dynamic_pointer_cast<TProxL1<T, K> >(penalization)) {
+    TICK_ERROR("Gap safe screening requires ProxL1 or ProxElasticNet")
+  }
+  l1_strength = penalization->get_strength() * l1_ratio;
+  l2_strength = penalization->get_strength() * (1 - l1_ratio);
+}
+
+template <class T, class K>
+void TStoSolver<T, K>::set_screened_features(
+    const std::vector<bool> &screened_features) {
+  if (!accepts_screening()) return;
+  clear_screening();
+  get_screening_strengths(screening_l1_strength, screening_l2_strength);
+  const ulong n_features = model->get_n_features();
+  screened.assign(n_features, false);
+  const ulong n_given = std::min<ulong>(n_features, screened_features.size());
+  for (ulong j = 0; j < n_given; ++j) {
+    if (screened_features[j]) {
+      screened[j] = true;
+      iterate[j] = 0;
+      ++n_screened;
+    }
+  }
+}
+
+template <class T, class K>
+void TStoSolver<T, K>::clear_screening() {
+  if (n_screened == 0) return;
+  screened.assign(screened.size(), false);
+  n_screened = 0;
+  restore_screened_features();
+}
+
+// The dual point is the vector of the derivatives of the losses at the
+// iterate, rescaled to be feasible without L2 penalization. Since the dual
+// objective is 1 / (n_samples L) strongly concave, L being the smoothness of
+// the losses, the dual optimum lies in a ball of radius
+// sqrt(2 n_samples L gap) around it, and feature j is zero at the optimum
+// when |x_j^T dual| / n_samples < l1_strength on this whole ball
+template <class T, class K>
+void TStoSolver<T, K>::screen() {
+  if (!accepts_screening()) {
+    TICK_ERROR(get_class_name() << " does not accept gap safe screening")
+  }
+  auto casted_model =
+      std::dynamic_pointer_cast<TModelGeneralizedLinear<T, K> >(model);
+  if (!casted_model) {
+    TICK_ERROR("Gap safe screening requires a generalized linear model")
+  }
+  const ulong n_samples = model->get_n_samples();
+  const ulong n_features = model->get_n_features();
+  if (model->use_intercept() || prox->get_positive() ||
+      !prox->is_in_range(0) || !prox->is_in_range(n_features - 1)) {
+    TICK_ERROR("Gap safe screening requires all coefficients to be "
+               "penalized, with no intercept nor positivity constraint")
+  }
+  T l1_strength, l2_strength;
+  get_screening_strengths(l1_strength, l2_strength);
+  if (l1_strength != screening_l1_strength ||
+      l2_strength != screening_l2_strength) {
+    clear_screening();
+    screening_l1_strength = l1_strength;
+    screening_l2_strength = l2_strength;
+  }
+  if (l1_strength <= 0) return;
+  if (screened.size() != n_features) screened.assign(n_features, false);
+
+  if (columns_norm.size() != n_features) {
+    columns_norm = Array<T>(n_features);
+    columns_norm.init_to_zero();
+    for (ulong i = 0; i < n_samples; ++i) {
+      const BaseArray<T> x_i = model->get_features(i);
+      for (ulong idx = 0; idx < x_i.size_data(); ++idx) {
+        const ulong j = x_i.is_dense() ? idx : x_i.indices()[idx];
+        columns_norm[j] += x_i.data()[idx] * x_i.data()[idx];
+      }
+    }
+    for (ulong j = 0; j < n_features; ++j) {
+      columns_norm[j] = std::sqrt(columns_norm[j]);
+    }
+  }
+
+  Array<T> dual(n_samples);
+  Array<T> correlations(n_features);
+  correlations.init_to_zero();
+  for (ulong i = 0; i < n_samples; ++i) {
+    dual[i] = casted_model->grad_i_factor(i, iterate);
+    correlations.mult_incr(model->get_features(i), dual[i] / n_samples);
+  }
+  T scaling = 1;
+  if (l2_strength == 0) {
+    for (ulong j = 0; j < n_features; ++j) {
+      scaling = std::max(scaling, std::abs(correlations[j]) / l1_strength);
+    }
+  }
+
+  T dual_objective = 0;
+  for (ulong i = 0; i < n_samples; ++i) {
+    dual_objective -=
+        casted_model->conjugate_loss_i(i, dual[i] / scaling) / n_samples;
+  }
+  if (l2_strength > 0) {
+    for (ulong j = 0; j < n_features; ++j) {
+      const T shrunk = std::max(std::abs(correlations[j]) - l1_strength, T{0});
+      dual_objective -= shrunk * shrunk / (2 * l2_strength);
+    }
+  }
+  const T primal_objective = model->loss(iterate) + prox->value(iterate);
+  duality_gap = std::max(primal_objective - dual_objective, T{0});
+
+  const T radius = std::sqrt(2 * n_samples *
+                             casted_model->get_loss_smoothness() * duality_gap);
+  for (ulong j = 0; j < n_features; ++j) {
+    if (!screened[j] && std::abs(correlations[j]) / scaling +
+                                columns_norm[j] * radius / n_samples <
+                            l1_strength) {
+      screened[j] = true;
+      iterate[j] = 0;
+      ++n_screened;
+    }
+  }
+}
+
 template <class T, class K>
 void TStoSolver<T, K>::reset() {
   t = 1;
   if (rand_type == RandType::perm) {
     i_perm = 0;
     shuffle();
+  } else if (rand_type == RandType::cyclic) {
+    i_perm = 0;
   }
   time_history.clear();
   iterate_history.clear();
@@ -43,10 +250,21 @@ ulong TStoSolver<T, K>::get_next_i() {
     if (i_perm >= rand_max) {
       shuffle();
     }
+  } else if (rand_type == RandType::importance) {
+    init_importance_sampling();
+    i = importance_sampler.sample(rand);
+  } else if (rand_type == RandType::cyclic) {
+    i = i_perm % rand_max;
+    i_perm = i + 1;
   }
   return i;
 }
 
+template <class T, class K>
+void TStoSolver<T, K>::get_next_batch(ArrayULong &batch) {
+  for (ulong k = 0; k < batch.size(); ++k) batch[k] = get_next_i();
+}
+
 // Simulation of a random permutation using Knuth's algorithm
 template <class T, class K>
 void TStoSolver<T, K>::shuffle() {
@@ -75,10 +293,22 @@ void TStoSolver<T, K>::solve(size_t n_epochs) {
   KUL_DBG_FUNC_ENTER
   double initial_time = last_record_time;
   size_t initial_epoch = last_record_epoch;
+  // Screened features are not safe anymore if the penalization has changed
+  if (n_screened > 0) {
+    T l1_strength, l2_strength;
+    get_screening_strengths(l1_strength, l2_strength);
+    if (l1_strength != screening_l1_strength ||
+        l2_strength != screening_l2_strength) {
+      clear_screening();
+    }
+  }
   auto start = std::chrono::steady_clock::now();
   for (size_t epoch = 1; epoch < (n_epochs + 1); ++epoch) {
     Interruption::throw_if_raised();
     solve_one_epoch();
+    if (screening_every > 0 && (initial_epoch + epoch) % screening_every == 0) {
+      screen();
+    }
     if ((initial_epoch + epoch) == 1 || ((initial_epoch + epoch) % record_every == 0)) {
       auto end = std::chrono::steady_clock::now();
       double time = ((end - start).count()) * std::chrono::steady_clock::period::num /
@@ -2,6 +2,9 @@
 
 #include "tick/solver/svrg.h"
 #include "tick/base_model/model_labels_features.h"
+#include "tick/solver/support_accumulator.h"
+
+#include <cmath>
 
 template <class T, class K>
 TSVRG<T, K>::TSVRG(size_t epoch_size, T tol, RandType rand_type, T step,
@@ -54,6 +57,8 @@ void TSVRG<T, K>::prepare_solve() {
     grad_i = Array<T>(iterate.size());
     grad_i_fixed_w = Array<T>(iterate.size());
   }
+  // The alias table is built before threads draw from it
+  if (rand_type == RandType::importance) this->init_importance_sampling();
   rand_index = 0;
   if (variance_reduction == SVRG_VarianceReductionMethod::Random ||
       variance_reduction == SVRG_VarianceReductionMethod::Average) {
@@ -64,13 +69,36 @@ void TSVRG<T, K>::prepare_solve() {
   }
 }
 
+template <class T, class K>
+void TSVRG<T, K>::set_batch_size(ulong batch_size) {
+  TStoSolver<T, K>::set_batch_size(batch_size);
+  // Step corrections depend on the batch size
+  ready_step_corrections = false;
+}
+
+template <class T, class K>
+void TSVRG<T, K>::set_rand_type(RandType rand_type) {
+  TStoSolver<T, K>::set_rand_type(rand_type);
+  // Step corrections depend on the sampling probabilities
+  ready_step_corrections = false;
+}
+
 template <class T, class K>
 void TSVRG<T, K>::solve_one_epoch() {
+  if (batch_size > 1 && n_threads > 1) {
+    TICK_ERROR("TSVRG<T, K> cannot use batch_size > 1 with n_threads > 1")
+  }
   prepare_solve();
   if ((model->is_sparse()) && (prox->is_separable())) {
     bool use_intercept = model->use_intercept();
     ulong n_features = model->get_n_features();
-    solve_sparse_proba_updates(use_intercept, n_features);
+    if (batch_size > 1) {
+      solve_sparse_batch(use_intercept, n_features);
+    } else {
+      solve_sparse_proba_updates(use_intercept, n_features);
+    }
+  } else if (batch_size > 1) {
+    solve_dense_batch();
   } else {
     solve_dense();
   }
@@ -79,16 +107,122 @@ void TSVRG<T, K>::solve_one_epoch() {
 template <class T, class K>
 void TSVRG<T, K>::compute_step_corrections() {
   ulong n_features = model->get_n_features();
-  std::shared_ptr<TModelLabelsFeatures<T, K>> casted_model;
-  casted_model = std::dynamic_pointer_cast<TModelLabelsFeatures<T, K>>(model);
-  Array<T> columns_sparsity = casted_model->get_column_sparsity_view();
+  // Proportion of non-zero entries of each column, or its weighted version
+  // with importance sampling
+  Array<T> columns_sparsity = this->get_support_probabilities();
   steps_correction = Array<T>(n_features);
   for (ulong j = 0; j < n_features; ++j) {
-    steps_correction[j] = 1. / columns_sparsity[j];
+    // With batches, the correction is the inverse probability that feature j
+    // is in the union of the supports of the batch
+    if (batch_size == 1) {
+      steps_correction[j] = 1. / columns_sparsity[j];
+    } else {
+      steps_correction[j] =
+          1. / (1. - std::pow(1. - columns_sparsity[j], batch_size));
+    }
   }
   ready_step_corrections = true;
 }
 
+template <class T, class K>
+void TSVRG<T, K>::update_next_iterate_batch(ulong k, ulong n_batches) {
+  if (variance_reduction == SVRG_VarianceReductionMethod::Random &&
+      k == std::min(rand_index / batch_size, n_batches - 1)) {
+    next_iterate = iterate;
+  }
+  if (variance_reduction == SVRG_VarianceReductionMethod::Average) {
+    next_iterate.mult_incr(iterate, 1.0 / n_batches);
+  }
+}
+
+template <class T, class K>
+void TSVRG<T, K>::solve_dense_batch() {
+  ArrayULong batch(batch_size);
+  Array<T> direction(iterate.size());
+  const ulong n_batches = get_n_batches();
+  for (ulong k = 0; k < n_batches; ++k) {
+    get_next_batch(batch);
+    // Average of the variance reduced gradients of the batch, all taken at
+    // the same iterate
+    direction.init_to_zero();
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      model->grad_i(batch[idx], iterate, grad_i);
+      model->grad_i(batch[idx], fixed_w, grad_i_fixed_w);
+      const T weight = get_sample_weight(batch[idx]);
+      direction.mult_incr(grad_i, weight / batch_size);
+      direction.mult_incr(grad_i_fixed_w, -weight / batch_size);
+    }
+    for (ulong j = 0; j < iterate.size(); ++j) {
+      if (is_screened(j)) continue;
+      iterate[j] -= step * (direction[j] + full_gradient[j]);
+    }
+    prox->call(iterate, step, iterate);
+    update_next_iterate_batch(k, n_batches);
+  }
+  if (variance_reduction == SVRG_VarianceReductionMethod::Last) {
+    next_iterate = iterate;
+  }
+  TStoSolver<T, K>::t += n_batches * batch_size;
+}
+
+template <class T, class K>
+void TSVRG<T, K>::solve_sparse_batch(bool use_intercept, ulong n_features) {
+  // Same as solve_sparse_proba_updates, each step working on the union of the
+  // supports of the batch with the step corrections of this union
+  if (!prox->is_separable()) {
+    TICK_ERROR(
+        "TSVRG<T, K>::solve_sparse_batch can be used with a separable prox "
+        "only.")
+  }
+  auto casted_prox = std::static_pointer_cast<TProxSeparable<T, K>>(prox);
+
+  ArrayULong batch(batch_size);
+  Array<T> factors(batch_size);
+  Array<T> factors_fixed_w(batch_size);
+  SupportAccumulator<T> direction(n_features);
+
+  auto update_coordinate = [&](const ulong j, const T descent_direction,
+                               const T prox_step) {
+    if (casted_prox->is_in_range(j))
+      iterate[j] = casted_prox->call_single_with_index(
+          iterate[j] - descent_direction, prox_step, j);
+    else
+      iterate[j] -= descent_direction;
+  };
+
+  const ulong n_batches = get_n_batches();
+  for (ulong k = 0; k < n_batches; ++k) {
+    get_next_batch(batch);
+    model->grad_i_factors(batch, iterate, factors);
+    model->grad_i_factors(batch, fixed_w, factors_fixed_w);
+    T intercept_direction = 0;
+    for (ulong idx = 0; idx < batch_size; ++idx) {
+      const T grad_i_diff = (factors[idx] - factors_fixed_w[idx]) *
+                            get_sample_weight(batch[idx]) / batch_size;
+      direction.incr(model->get_features(batch[idx]), grad_i_diff);
+      intercept_direction += grad_i_diff;
+    }
+    for (const ulong j : direction.get_support()) {
+      if (is_screened(j)) continue;
+      const T step_correction = steps_correction[j];
+      update_coordinate(
+          j, step * (direction[j] + step_correction * full_gradient[j]),
+          step * step_correction);
+    }
+    if (use_intercept) {
+      update_coordinate(
+          n_features,
+          step * (intercept_direction + full_gradient[n_features]), step);
+    }
+    direction.reset();
+    update_next_iterate_batch(k, n_batches);
+  }
+  if (variance_reduction == SVRG_VarianceReductionMethod::Last) {
+    next_iterate = iterate;
+  }
+  TStoSolver<T, K>::t += n_batches * batch_size;
+}
+
 template <class T, class K>
 void TSVRG<T, K>::solve_dense() {
   if (n_threads > 1) {
@@ -174,9 +308,11 @@ void TSVRG<T, K>::dense_single_thread_solver(const ulong& next_i) {
   const ulong& i = next_i;
   model->grad_i(i, iterate, grad_i);
   model->grad_i(i, fixed_w, grad_i_fixed_w);
+  const T weight = get_sample_weight(i);
   for (ulong j = 0; j < iterate.size(); ++j) {
-    iterate[j] =
-        iterate[j] - step * (grad_i[j] - grad_i_fixed_w[j] + full_gradient[j]);
+    if (is_screened(j)) continue;
+    iterate[j] = iterate[j] - step * (weight * (grad_i[j] - grad_i_fixed_w[j]) +
+                                      full_gradient[j]);
   }
   prox->call(iterate, step, iterate);
   if (variance_reduction == SVRG_VarianceReductionMethod::Random &&
@@ -198,12 +334,15 @@ void TSVRG<T, K>::sparse_single_thread_solver(
   // Gradients factors (model is a GLM)
   // TODO: a grad_i_factor(i, array1, array2) to loop once on the features
   T grad_i_diff =
-      model->grad_i_factor(i, iterate) - model->grad_i_factor(i, fixed_w);
+      (model->grad_i_factor(i, iterate) - model->grad_i_factor(i, fixed_w)) *
+      get_sample_weight(i);
   // We update the iterate within the support of the features vector, with the
   // probabilistic correction
   for (ulong idx_nnz = 0; idx_nnz < x_i.size_sparse(); ++idx_nnz) {
     // Get the index of the idx-th sparse feature of x_i
     ulong j = x_i.indices()[idx_nnz];
+    // Screened features are zero at the optimum and are left out
+    if (is_screened(j)) continue;
     T full_gradient_j = full_gradient[j];
     // Step-size correction for coordinate j
     T step_correction = steps_correction[j];
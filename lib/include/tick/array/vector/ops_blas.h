@@ -68,6 +68,15 @@ struct vector_operations_cblas<float> final
   void mult_incr(const uint64_t n, const float alpha, const float *x, float *y) const {
     cblas_saxpy(n, alpha, x, 1, y, 1);
   }
+  void dot_matrix_vector(const ulong m, const ulong n, const float alpha, const float *a,
+                         const float *x, float *y) const {
+    cblas_sgemv(CblasRowMajor, CblasNoTrans, m, n, alpha, a, n, x, 1, 0, y, 1);
+  }
+  void dot_matrix_matrix(const ulong m, const ulong n, const ulong k, const float alpha,
+                         const float *a, const float *b, const float beta, float *c) const {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha, a, k, b, n, beta, c,
+                n);
+  }
 
 #if defined(TICK_USE_CATLAS_)
   void set(const ulong n, const float alpha, float *x) const {
@@ -92,6 +101,15 @@ struct vector_operations_cblas<double> final
   void mult_incr(const uint64_t n, const double alpha, const double *x, double *y) const {
     cblas_daxpy(n, alpha, x, 1, y, 1);
   }
+  void dot_matrix_vector(const ulong m, const ulong n, const double alpha, const double *a,
+                         const double *x, double *y) const {
+    cblas_dgemv(CblasRowMajor, CblasNoTrans, m, n, alpha, a, n, x, 1, 0, y, 1);
+  }
+  void dot_matrix_matrix(const ulong m, const ulong n, const ulong k, const double alpha,
+                         const double *a, const double *b, const double beta, double *c) const {
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, alpha, a, k, b, n, beta, c,
+                n);
+  }
   void mult_incr(const uint64_t n, const double alpha, const std::atomic<double> *x, double *y) const {
     vector_operations_unoptimized<double>{}.mult_incr(n, alpha, x, y);
   }
@@ -73,7 +73,14 @@ struct vector_operations_unoptimized {
   typename std::enable_if<!std::is_same<T, std::atomic<K>>::value>::type dot_matrix_vector(
       const ulong m, const ulong n, const K alpha, const T *a, const T *x, T *y) const;
 
-
+  /**
+   * @brief c = alpha * a . b + beta * c, all matrices being row major
+   * \param m : number of rows of a and c
+   * \param n : number of columns of b and c
+   * \param k : number of columns of a and rows of b
+   */
+  void dot_matrix_matrix(const ulong m, const ulong n, const ulong k, const T alpha,
+                         const T *a, const T *b, const T beta, T *c) const;
 
   void solve_linear_system(int n, T *A, T *b, int* ipiv = nullptr) const;
 
@@ -260,6 +260,41 @@ vector_operations_unoptimized<T>::dot_matrix_vector(const ulong m, const ulong n
   }
 }
 
+// Blocked i-l-j loops so that tiles of a, b and c stay in cache while the
+// innermost loop runs contiguously over rows of b and c
+template <typename T>
+void vector_operations_unoptimized<T>::dot_matrix_matrix(const ulong m, const ulong n,
+                                                         const ulong k, const T alpha,
+                                                         const T *a, const T *b,
+                                                         const T beta, T *c) const {
+  CHECK_BLAS_OPTIMIZATION_PP(a, b, "dot_matrix_matrix");
+  const ulong block_size = 64;
+
+  for (ulong i = 0; i < m * n; ++i) {
+    c[i] = beta == 0 ? 0 : beta * c[i];
+  }
+
+  for (ulong i_start = 0; i_start < m; i_start += block_size) {
+    const ulong i_end = std::min(i_start + block_size, m);
+    for (ulong l_start = 0; l_start < k; l_start += block_size) {
+      const ulong l_end = std::min(l_start + block_size, k);
+      for (ulong j_start = 0; j_start < n; j_start += block_size) {
+        const ulong j_end = std::min(j_start + block_size, n);
+        for (ulong i = i_start; i < i_end; ++i) {
+          T *c_i = c + i * n;
+          for (ulong l = l_start; l < l_end; ++l) {
+            const T alpha_a_il = alpha * a[i * k + l];
+            const T *b_l = b + l * n;
+            for (ulong j = j_start; j < j_end; ++j) {
+              c_i[j] += alpha_a_il * b_l[j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 #undef CHECK_BLAS_OPTIMIZATION_PP
 #undef CHECK_BLAS_OPTIMIZATION_PS
 
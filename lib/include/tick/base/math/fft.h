@@ -0,0 +1,23 @@
+#ifndef LIB_INCLUDE_TICK_BASE_MATH_FFT_H_
+#define LIB_INCLUDE_TICK_BASE_MATH_FFT_H_
+
+// License: BSD 3 clause
+
+#include <complex>
+#include <vector>
+
+#include "tick/base/defs.h"
+
+//! @brief Smallest power of 2 greater or equal to n, suitable as fft size
+extern DLL_PUBLIC ulong fft_size(const ulong n);
+
+/**
+ * @brief In place radix-2 discrete Fourier transform
+ * \param values : Values to transform, their number must be a power of 2
+ * \param inverse : If true, the inverse transform is computed, including the
+ * normalization by the number of values
+ */
+extern DLL_PUBLIC void fft(std::vector<std::complex<double> > &values,
+                           const bool inverse = false);
+
+#endif  // LIB_INCLUDE_TICK_BASE_MATH_FFT_H_
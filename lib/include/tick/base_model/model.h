@@ -8,6 +8,7 @@
 // License: BSD 3 clause
 
 #include <iostream>
+#include <vector>
 
 #include "tick/base/base.h"
 
@@ -37,6 +38,29 @@ class TModel {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
 
+  //! @brief Whether the model implements get_grad_i_support and
+  //! grad_i_sparse
+  virtual bool has_grad_i_sparse() const { return false; }
+
+  /**
+   * @brief Coefficients on which the gradient of sample i depends, and out
+   * of which it is zero
+   * \param i : selected sample
+   * \param support : filled with the coefficients of the support
+   */
+  virtual void get_grad_i_support(const ulong i, std::vector<ulong> &support) {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  /**
+   * @brief Gradient of sample i written on its support only (see
+   * get_grad_i_support), the other coordinates of out being left untouched
+   */
+  virtual void grad_i_sparse(const ulong i, const Array<K> &coeffs,
+                             Array<T> &out) {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
   virtual void grad(const Array<K> &coeffs, Array<T> &out) {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
@@ -99,6 +123,19 @@ class TModel {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
 
+  /**
+   * @brief Gradient factors of a batch of samples, all computed at coeffs
+   * \param indices : samples of the batch
+   * \param coeffs : point at which the factors are computed
+   * \param out : filled with the factor of each sample of the batch
+   */
+  virtual void grad_i_factors(const ArrayULong &indices,
+                              const Array<K> &coeffs, Array<T> &out) {
+    for (ulong k = 0; k < indices.size(); ++k) {
+      out[k] = grad_i_factor(indices[k], coeffs);
+    }
+  }
+
   virtual void compute_lip_consts() {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
@@ -30,6 +30,12 @@ class DLL_PUBLIC TModelGeneralizedLinear
 
   Array<T> features_norm_sq;
 
+  // Second derivatives of the losses of the samples with respect to their
+  // inner products, at hessian_point where the hessian was last evaluated
+  bool ready_hessian_factors = false;
+  Array<T> hessian_point;
+  Array<T> hessian_factors;
+
   /**
    * Computes gradient fo ith observation
    * @param i : The selected observation
@@ -45,6 +51,25 @@ class DLL_PUBLIC TModelGeneralizedLinear
 
   Array<T> &get_features_norm_sq() { return features_norm_sq; }
 
+  //! @brief Whether the hessian factors were computed at coeffs
+  bool is_hessian_point(const Array<K> &coeffs) const;
+
+  /**
+   * To be used by hessian_vector_product with parallel_map_array, increments
+   * out by the hessian of the loss of sample i times vector
+   */
+  virtual void inc_hessian_vector_product_i(const ulong i, Array<T> &out,
+                                            const Array<T> &vector);
+
+  /**
+   * Same as inc_hessian_vector_product_i, computing first the hessian factor
+   * of sample i at coeffs, so that the first product at a new point takes a
+   * single pass over the data as well
+   */
+  void inc_hessian_vector_product_at_i(const ulong i, Array<T> &out,
+                                       const Array<K> &coeffs,
+                                       const Array<T> &vector);
+
  public:
   TModelGeneralizedLinear(const std::shared_ptr<BaseArray2d<T> > features,
                           const std::shared_ptr<SArray<T> > labels,
@@ -67,6 +92,17 @@ class DLL_PUBLIC TModelGeneralizedLinear
 
   T loss(const Array<K> &coeffs) override;
 
+  /**
+   * @brief Product of the hessian of the loss at coeffs with vector
+   * \f$ \frac{1}{n} \sum_i \ell_i''(z_i) x_i x_i^\top v \f$, where
+   * \f$ z_i \f$ is the inner product of sample i with coeffs
+   * @note The second derivatives of the losses are computed during the
+   * first product at coeffs and kept until coeffs changes, so that every
+   * product takes a single pass over the data
+   */
+  virtual void hessian_vector_product(const Array<K> &coeffs,
+                                      const Array<T> &vector, Array<T> &out);
+
   void sdca_primal_dual_relation(const T l_l2sq, const Array<T> &dual_vector,
                                  Array<T> &out_primal_vector) override;
 
@@ -80,6 +116,61 @@ class DLL_PUBLIC TModelGeneralizedLinear
 
   virtual T get_inner_prod(const ulong i, const Array<K> &coeffs) const;
 
+  /**
+   * @brief Inner products of a batch of samples with coeffs, computed in a
+   * single pass over the rows of the batch in the features matrix. With dense
+   * features, runs of consecutive samples are a matrix-vector product
+   * \param indices : samples of the batch
+   * \param coeffs : point at which the inner products are computed
+   * \param out : filled with the inner product of each sample of the batch
+   */
+  virtual void get_inner_prods(const ArrayULong &indices,
+                               const Array<K> &coeffs, Array<T> &out) const;
+
+  //! @brief Computes the inner products of the batch with get_inner_prods,
+  //! then maps them to derivatives with grad_i_factor_from_inner_prod
+  void grad_i_factors(const ArrayULong &indices, const Array<K> &coeffs,
+                      Array<T> &out) override;
+
+  /**
+   * @brief Convex conjugate of the loss of sample i, seen as a function of
+   * the inner product, evaluated at dual_i
+   * @note This is used to compute duality gaps
+   */
+  virtual T conjugate_loss_i(const ulong i, const T dual_i) const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  //! @brief Smoothness constant of the losses of the samples, seen as
+  //! functions of the inner product
+  virtual T get_loss_smoothness() const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  /**
+   * @brief Loss of sample i, seen as a function of the inner product
+   * \f$ z = x_i^\top w + b \f$, evaluated at inner_prod
+   * @note This is used by solvers maintaining the inner products of all
+   * samples, such as coordinate descent
+   */
+  virtual T loss_i_from_inner_prod(const ulong i, const T inner_prod) const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  //! @brief Derivative of the loss of sample i with respect to the inner
+  //! product, namely grad_i_factor given the inner product
+  virtual T grad_i_factor_from_inner_prod(const ulong i,
+                                          const T inner_prod) const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  //! @brief Second derivative of the loss of sample i with respect to the
+  //! inner product
+  virtual T hessian_i_factor_from_inner_prod(const ulong i,
+                                             const T inner_prod) const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
   virtual void set_fit_intercept(const bool fit_intercept) {
     this->fit_intercept = fit_intercept;
   }
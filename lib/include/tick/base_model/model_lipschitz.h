@@ -52,6 +52,12 @@ class DLL_PUBLIC TModelLipschitz : public virtual TModel<T, K> {
    */
   T get_lip_mean() override;
 
+  /**
+   * @brief Get the Lipschitz constants of all samples
+   * @note They are computed if needed
+   */
+  Array<T> get_lip_consts();
+
   template <class Archive>
   void serialize(Archive &ar) {
     ar(CEREAL_NVP(ready_lip_consts), CEREAL_NVP(ready_lip_max),
@@ -4,6 +4,8 @@
 
 // License: BSD 3 clause
 
+#include <functional>
+
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 
@@ -12,8 +14,11 @@
  * \brief Class for implementation of the algorithm described in the paper
  * `Learning Social Infectivity in Sparse Low-rank Networks Using
  * Multi-dimensional Hawkes Processes` by Zhou, Zha and Song (2013) in AISTATS
+ * \tparam T : type in which the weights of each event are stored. Baseline,
+ * adjacency, components and every accumulation remain in double
  */
-class DLL_PUBLIC HawkesADM4 : public ModelHawkesList {
+template <class T>
+class DLL_PUBLIC THawkesADM4 : public ModelHawkesList {
   //! @brief Decay shared by all Hawkes exponential kernels
   double decay;
 
@@ -24,19 +29,50 @@ class DLL_PUBLIC HawkesADM4 : public ModelHawkesList {
   //! for node u : kernel_integral[u] = \sum_r \int_0^{T - t_i^u} g(s) ds
   ArrayDouble kernel_integral;
 
-  //! @brief Weights storing sum of kernel values at specific points
-  //! for realization r: g[r][u][i][v] = \sum_{t_j^v < t_i^u} g(t_i^u - t_j^v)
-  ArrayDouble2dList2D g;
+  //! @brief Kernel values below this threshold are dropped from the weights,
+  //! which keeps them sparse on large graphs
+  double weights_threshold;
+
+  //! @brief Sparse weights storing sum of kernel values at specific points
+  //! for realization r and node u (index r * n_nodes + u), the entries of the
+  //! i-th event of node u are stored between g_indptr[r_u][i] and
+  //! g_indptr[r_u][i + 1], g_values holding
+  //! \sum_{t_j^v < t_i^u} g(t_i^u - t_j^v) for the node
+  //! v = g_columns[r_u][g_indices[r_u][p]]. g_columns lists the nodes having
+  //! at least one entry
+  std::vector<std::vector<ulong> > g_indptr;
+  std::vector<std::vector<ulong> > g_indices;
+  std::vector<std::vector<T> > g_values;
+  std::vector<std::vector<ulong> > g_columns;
+
+  //! @brief Majorization of realization r and node u (index r * n_nodes + u)
+  //! computed in parallel by estimate_ru, next_C_ru being aligned with
+  //! g_columns[r_u]
+  ArrayDouble2d next_mu;
+  std::vector<std::vector<double> > next_C_ru;
+
+  //! @brief Maximum rank of the low rank component computed by
+  //! update_components
+  ulong max_rank;
 
-  //! @brief Buffer variables used to compute p_ij
-  ArrayDouble2d next_C, unnormalized_next_C;
+  //! @brief Explicit factorization of the low rank component
+  //! z1 = low_rank_left^T diag(low_rank_singular_values) low_rank_right, each
+  //! row of the factors being a singular vector
+  ArrayDouble2d low_rank_left, low_rank_right;
+  ArrayDouble low_rank_singular_values;
 
-  //! @brief Buffer variables to compute next baseline (mu)
-  ArrayDouble2d next_mu;
+  //! @brief Sparse component z2, the non zero entries of row u being the
+  //! values sparse_values[u] in the columns sparse_indices[u]
+  std::vector<std::vector<ulong> > sparse_indices;
+  std::vector<std::vector<double> > sparse_values;
+
+  //! @brief Rows (iteration, relative change of mu, relative change of
+  //! adjacency) of the iterations checked by the last call to fit
+  std::vector<double> fit_history;
 
  public:
-  HawkesADM4(const double decay, const double rho, const int max_n_threads = 1,
-             const unsigned int optimization_level = 0);
+  THawkesADM4(const double decay, const double rho, const int max_n_threads = 1,
+              const unsigned int optimization_level = 0);
 
   //! @brief allocate buffer arrays once data has been given
   void compute_weights();
@@ -45,26 +81,145 @@ class DLL_PUBLIC HawkesADM4 : public ModelHawkesList {
   void solve(ArrayDouble &mu, ArrayDouble2d &adjacency, ArrayDouble2d &z1,
              ArrayDouble2d &z2, ArrayDouble2d &u1, ArrayDouble2d &u2);
 
+  /**
+   * @brief Runs iterations of the algorithm, z1, z2, u1 and u2 being fixed,
+   * until the relative changes of mu and adjacency are both below em_tol
+   * \param em_max_iter : maximum number of iterations
+   * \param em_tol : tolerance on the relative changes of mu and adjacency
+   * \return The number of iterations performed
+   */
+  ulong solve_em(ArrayDouble &mu, ArrayDouble2d &adjacency, ArrayDouble2d &z1,
+                 ArrayDouble2d &z2, ArrayDouble2d &u1, ArrayDouble2d &u2,
+                 const ulong em_max_iter, const double em_tol);
+
+  //! @brief Sets the low rank and sparse components kept by the object to
+  //! zero, as they are at the start of the ADMM
+  void reset_components();
+
+  /**
+   * @brief Same as solve_em, the low rank component z1 and the sparse
+   * component z2 being the ones kept by the object instead of dense matrices
+   */
+  ulong solve_em_low_rank(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                          ArrayDouble2d &u1, ArrayDouble2d &u2,
+                          const ulong em_max_iter, const double em_tol);
+
+  /**
+   * @brief Proximal and dual steps of the ADMM on the components kept by the
+   * object, z1 = prox_nuclear(adjacency + u1), z2 = prox_l1(adjacency + u2),
+   * u1 += adjacency - z1 and u2 += adjacency - z2
+   * \param adjacency : current adjacency matrix
+   * \param u1 : dual variable of the low rank constraint, updated in place
+   * \param u2 : dual variable of the sparse constraint, updated in place
+   * \param strength_lasso : strength of the L1 penalization, the entries are
+   * thresholded by strength_lasso / rho
+   * \param strength_nuclear : strength of the nuclear penalization, the
+   * singular values are thresholded by strength_nuclear / rho
+   * \note z1 is computed from a truncated randomized SVD of rank max_rank and
+   * only its factors are stored, z2 is stored in a compressed row storage.
+   * Neither of them is ever formed as a dense matrix
+   */
+  void update_components(ArrayDouble2d &adjacency, ArrayDouble2d &u1,
+                         ArrayDouble2d &u2, const double strength_lasso,
+                         const double strength_nuclear);
+
+  /**
+   * @brief Runs the whole ADMM from mu and adjacency, each iteration being
+   * solve_em_low_rank followed by update_components, the dual variables
+   * starting at zero
+   * \param strength_lasso : strength of the L1 penalization
+   * \param strength_nuclear : strength of the nuclear penalization
+   * \param max_iter : maximum number of iterations
+   * \param tol : the ADMM stops once the relative changes of mu and
+   * adjacency are both below tol, after at least 7 iterations
+   * \param em_max_iter : maximum number of iterations of each inner EM
+   * \param em_tol : tolerance of each inner EM, if negative it is a hundredth
+   * of the largest relative change of the last checked iteration
+   * \param record_every : relative changes are computed every record_every
+   * iterations and on the last one, if 0 only on the last one
+   * \return The number of iterations performed
+   * \note The low rank component keeps at most max_rank singular values,
+   * setting max_rank to n_nodes gives the full nuclear proximal operator
+   */
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &adjacency,
+            const double strength_lasso, const double strength_nuclear,
+            const ulong max_iter, const double tol, const ulong em_max_iter,
+            const double em_tol, const ulong record_every = 1);
+
+  //! @brief Iterations checked by the last call to fit, one row per check
+  SArrayDouble2dPtr get_fit_history() const;
+
  private:
   void compute_weights_ru(const ulong r_u, ArrayDouble2d &map_kernel_integral);
 
+  void check_shapes(const ArrayDouble &mu, const ArrayDouble2d &adjacency,
+                    const ArrayDouble2d &u1, const ArrayDouble2d &u2) const;
+
+  //! @brief Runs iteration until the relative changes of mu and adjacency are
+  //! both below em_tol
+  ulong run_em(ArrayDouble &mu, ArrayDouble2d &adjacency,
+               const ulong em_max_iter, const double em_tol,
+               const std::function<void()> &iteration);
+
+  //! @brief Majorization of the events of node u of realization r, stored in
+  //! next_mu and next_C_ru
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  void estimate_ru(const ulong r_u, const ArrayDouble &mu,
+                   const ArrayDouble2d &adjacency);
+
+  //! @brief Update of the baseline and of the row u of adjacency from the
+  //! majorization, with dense components z1 and z2
   void update_u(const ulong u, ArrayDouble &mu, ArrayDouble2d &adjacency,
                 ArrayDouble2d &z1, ArrayDouble2d &z2, ArrayDouble2d &u1,
                 ArrayDouble2d &u2);
 
-  void estimate_ru(const ulong r_u, ArrayDouble &mu, ArrayDouble2d &adjacency);
+  //! @brief Update of the baseline and of the row u of adjacency from the
+  //! majorization, with the components kept by the object
+  void update_low_rank_u(const ulong u, ArrayDouble &mu,
+                         ArrayDouble2d &adjacency, ArrayDouble2d &u1,
+                         ArrayDouble2d &u2);
+
+  //! @brief Reduces the majorization of node u over realizations and updates
+  //! mu_u and adjacency_u
+  void update_adjacency_u(const ulong u, ArrayDouble &mu,
+                          ArrayDouble &adjacency_u, const ArrayDouble &z1_u,
+                          const ArrayDouble &z2_u, const ArrayDouble &u1_u,
+                          const ArrayDouble &u2_u);
 
-  void update_adjacency_u(const ulong u, ArrayDouble &adjacency_u,
-                          ArrayDouble &z1_u, ArrayDouble &z2_u,
-                          ArrayDouble &u1_u, ArrayDouble &u2_u);
+  //! @brief Computes the row u of the low rank component z1 from its factors
+  void fill_low_rank_row(const ulong u, ArrayDouble &z1_u) const;
 
-  void update_baseline_u(const ulong u, ArrayDouble &mu);
+  //! @brief Computes the row u of the sparse component z2
+  void fill_sparse_row(const ulong u, ArrayDouble &z2_u) const;
+
+  //! @brief Computes the factors of z1 = prox_nuclear(adjacency + u1) with a
+  //! truncated randomized SVD
+  void compute_low_rank(const ArrayDouble2d &adjacency, const ArrayDouble2d &u1,
+                        const double threshold);
+
+  //! @brief Computes row u of z2 = prox_l1(adjacency + u2) and updates rows u
+  //! of u1 and u2
+  void update_components_u(const ulong u, ArrayDouble2d &adjacency,
+                           ArrayDouble2d &u1, ArrayDouble2d &u2,
+                           const double threshold);
 
  public:
   double get_decay() const;
   void set_decay(const double decay);
   double get_rho() const;
   void set_rho(const double rho);
+  double get_weights_threshold() const;
+  void set_weights_threshold(const double weights_threshold);
+  ulong get_max_rank() const;
+  void set_max_rank(const ulong max_rank);
+
+  SArrayDouble2dPtr get_low_rank_left() const;
+  SArrayDoublePtr get_low_rank_singular_values() const;
+  SArrayDouble2dPtr get_low_rank_right() const;
 };
 
+using HawkesADM4 = THawkesADM4<double>;
+using HawkesADM4Double = THawkesADM4<double>;
+using HawkesADM4Float = THawkesADM4<float>;
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_ADM4_H_
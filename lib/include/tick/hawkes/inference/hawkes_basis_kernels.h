@@ -4,6 +4,8 @@
 
 // License: BSD 3 clause
 
+#include <vector>
+
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 
@@ -17,10 +19,14 @@
 // the file hawkes_basis_kernels.pdf in the directory tex/hawkes_basis_kernels
 // (LaTeX)
 //
+// The class is templated on the type T in which the index of pairs of events,
+// which grows with the number of events, is stored. Baseline, kernels,
+// amplitudes and every accumulation remain in double
 //
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-class DLL_PUBLIC HawkesBasisKernels : public ModelHawkesList {
+template <class T>
+class DLL_PUBLIC THawkesBasisKernels : public ModelHawkesList {
   //! @brief Maximum support of the kernel
   double kernel_support;
 
@@ -33,24 +39,90 @@ class DLL_PUBLIC HawkesBasisKernels : public ModelHawkesList {
   //! @brief penalty parameter
   double alpha;
 
-  //! @brief Buffer variables
-  ArrayDouble2d rud, Dudm, Dudm_temp, Cudm, Gdm, a_sum_vd;
-  ArrayDouble2d quvd, quvd_temp;
+  //! @brief Buffer variables, rud and quvd are filled node per node
+  ArrayDouble2d rud, Gdm, a_sum_vd, quvd;
+
+  //! @brief Buffer variables filled by each thread, of shape
+  //! (n_threads, n_basis * kernel_size), and their sum over threads
+  ArrayDouble2d thread_Cdm, thread_Ddm;
+  ArrayDouble Cdm, Ddm;
+
+  //! @brief Index of the pairs of events closer than kernel_support, built
+  //! once in allocate_weights. For realization r and node u
+  //! (index r_u = r * n_nodes + u), the pairs of the i-th event of node u are
+  //! stored between pairs_indptr[r_u][i] and pairs_indptr[r_u][i + 1] in
+  //! pairs_bins, the flat kernel bin v * kernel_size + m in which earlier
+  //! events of node v fall, and in pairs_counts, the number of such events
+  std::vector<std::vector<ulong> > pairs_indptr;
+  std::vector<std::vector<ulong> > pairs_bins;
+  std::vector<std::vector<T> > pairs_counts;
+
+  //! @brief History of the last fit, five values per checked iteration
+  std::vector<double> fit_history;
 
  public:
-  HawkesBasisKernels(const double kernel_support, const ulong kernel_size,
-                     const ulong n_basis, const double alpha,
-                     const int max_n_threads = 1);
+  THawkesBasisKernels(const double kernel_support, const ulong kernel_size,
+                      const ulong n_basis, const double alpha,
+                      const int max_n_threads = 1);
 
   double solve(ArrayDouble &mu, ArrayDouble2d &gdm, ArrayDouble2d &auvd,
                ulong max_iter_gdm, double max_tol_gdm);
 
+  /**
+   * @brief Runs the iterations of the algorithm until convergence
+   * \param mu : Starting baseline, replaced by the fitted one
+   * \param gdm : Starting basis kernels of shape (n_basis, kernel_size),
+   * replaced by the fitted ones
+   * \param auvd : Starting amplitudes of shape (n_nodes, n_nodes * n_basis),
+   * replaced by the fitted ones
+   * \param max_iter : Maximum number of iterations
+   * \param tol : The iterations stop once the relative changes of baseline,
+   * amplitudes and basis kernels are all below tol
+   * \param max_iter_gdm : Maximum number of iterations of each basis kernels
+   * update, as in solve
+   * \param max_tol_gdm : Tolerance of each basis kernels update, as in solve
+   * \param record_every : Convergence is checked and the relative changes
+   * recorded every record_every iterations and at the last one. If 0, only
+   * the last iteration is checked
+   * \return The number of iterations run
+   */
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &gdm, ArrayDouble2d &auvd,
+            const ulong max_iter, const double tol, const ulong max_iter_gdm,
+            const double max_tol_gdm, const ulong record_every = 1);
+
+  //! @brief History of the last fit, each row holding the iteration number,
+  //! the relative changes of baseline, amplitudes and basis kernels and the
+  //! relative error of the basis kernels update returned by solve
+  SArrayDouble2dPtr get_fit_history() const;
+
  private:
+  //! @brief Runs solve_u on the contiguous range of nodes of thread
+  //! thread_index, accumulating in its rows of thread_Cdm and thread_Ddm
+  void solve_thread(const ulong thread_index, ArrayDouble &mu,
+                    ArrayDouble2d &gdm, ArrayDouble2d &auvd);
+
   void solve_u(ulong u, ArrayDouble &mu, ArrayDouble2d &gdm,
-               ArrayDouble2d &auvd);
+               ArrayDouble2d &auvd, ArrayDouble2d &Cdm, ArrayDouble2d &Ddm);
+
+  //! @brief E-step over the events of node u of realization r, returns the
+  //! contribution to the next baseline of u
+  double compute_mu_q_D_ur(const ulong r, const ulong u, const double mu_u,
+                           ArrayDouble2d &gdm, ArrayDouble2d &avd,
+                           ArrayDouble2d &qvd, ArrayDouble2d &Ddm);
+
+  void update_amplitudes_u(const ulong u, ArrayDouble2d &auvd);
+
+  //! @brief Updates basis function d, returns the maximum relative error
+  //! reached
+  double update_gdm_d(const ulong d, ArrayDouble2d &gdm, ulong max_iter_gdm,
+                      double max_tol_gdm);
 
   void allocate_weights();
 
+  //! @brief Fills pairs_indptr, pairs_bins and pairs_counts for the events
+  //! of node u of realization r
+  void compute_pairs_index_ur(const ulong r_u);
+
  public:
   //! @brief we need to override this function as we do not parallelize over
   //! realizations
@@ -91,4 +163,8 @@ class DLL_PUBLIC HawkesBasisKernels : public ModelHawkesList {
   void set_alpha(const double alpha);
 };
 
+using HawkesBasisKernels = THawkesBasisKernels<double>;
+using HawkesBasisKernelsDouble = THawkesBasisKernels<double>;
+using HawkesBasisKernelsFloat = THawkesBasisKernels<float>;
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_BASIS_KERNELS_H_
@@ -12,4 +12,28 @@ extern void PointProcessCondLaw(ArrayDouble &y_time, ArrayDouble &z_time,
                                 double y_lambda, ArrayDouble &res_X,
                                 ArrayDouble &res_Y);
 
+/**
+ * @brief Batch version of PointProcessCondLaw computing the signals of many
+ * (y, z, mark interval) triplets at once
+ * \param timestamps : timestamps of each node of the realization
+ * \param marks : cumulated marks of each node of the realization
+ * \param lags : array of lags of size N+1
+ * \param y_nodes : node used as Y process for each triplet
+ * \param z_nodes : node used as Z process for each triplet
+ * \param zmins : lower bound of the mark interval of each triplet
+ * \param zmaxs : upper bound of the mark interval of each triplet
+ * \param y_T : end time of the realization
+ * \param res_X : abscissa of the signals, of size N
+ * \param res_Y : ordinates of the signals, of shape (n_triplets, N)
+ * \param max_n_threads : number of threads used, z events of a triplet are
+ * split across threads when there are less triplets than threads
+ */
+extern void PointProcessCondLawBatch(const SArrayDoublePtrList1D &timestamps,
+                                     const SArrayDoublePtrList1D &marks,
+                                     ArrayDouble &lags, ArrayULong &y_nodes,
+                                     ArrayULong &z_nodes, ArrayDouble &zmins,
+                                     ArrayDouble &zmaxs, double y_T,
+                                     ArrayDouble &res_X, ArrayDouble2d &res_Y,
+                                     int max_n_threads = 1);
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_CONDITIONAL_LAW_H_
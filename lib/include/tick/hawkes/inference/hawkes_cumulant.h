@@ -6,12 +6,41 @@
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 
-class DLL_PUBLIC HawkesCumulant : public ModelHawkesList {
+/**
+ * \class THawkesCumulant
+ * \brief Integrated cumulants of Hawkes processes, used by
+ * HawkesCumulantMatching
+ * \tparam T : type in which the cumulants of each realization are stored.
+ * They are accumulated in double, and so are their averages over
+ * realizations
+ */
+template <class T>
+class DLL_PUBLIC THawkesCumulant : public ModelHawkesList {
   double integration_support;
   bool are_cumulants_ready;
 
+  //! @brief Mean intensity of each node in each realization, shape
+  //! (n_realizations, n_nodes)
+  ArrayDouble2d mean_intensity_per_realization;
+
+  //! @brief Integrated covariance C and J of each realization (row
+  //! r * n_nodes + i holds C_ij or J_ij of realization r for all j)
+  Array2d<T> covariance_per_realization;
+  Array2d<T> J_per_realization;
+
+  //! @brief Third order cumulant terms of each realization (row r * n_nodes +
+  //! k holds E_ikk for all i, resp. E_jjk for all j, of realization r)
+  Array2d<T> E_ikk_per_realization;
+  Array2d<T> E_jjk_per_realization;
+
+  //! @brief Bulk results averaged over realizations
+  ArrayDouble mean_intensity;
+  ArrayDouble2d covariance;
+  ArrayDouble2d skewness;
+
  public:
-  explicit HawkesCumulant(double integration_support);
+  explicit THawkesCumulant(double integration_support,
+                           const int max_n_threads = 1);
 
   SArrayDoublePtr compute_A_and_I_ij(ulong r, ulong i, ulong j,
                                      double mean_intensity_j);
@@ -20,6 +49,26 @@ class DLL_PUBLIC HawkesCumulant : public ModelHawkesList {
                        double mean_intensity_i, double mean_intensity_j,
                        double J_ij);
 
+  /**
+   * @brief Computes in bulk mean intensities, integrated covariance and the
+   * contraction K_c of the integrated skewness of all realizations
+   * \note Each node is swept once per realization with sliding windows over
+   * all other nodes, and work is sharded over threads by (realization, node).
+   * K_c is contracted on the fly, the full n_nodes^3 skewness tensor is never
+   * stored
+   */
+  void compute_cumulants();
+
+  //! @brief Mean intensity of each node, averaged over realizations
+  SArrayDoublePtr get_mean_intensity() const;
+
+  //! @brief Integrated covariance C, averaged over realizations
+  SArrayDouble2dPtr get_covariance() const;
+
+  //! @brief Contraction K_c of the integrated skewness, averaged over
+  //! realizations
+  SArrayDouble2dPtr get_skewness() const;
+
   double get_integration_support() const { return integration_support; }
 
   void set_integration_support(const double integration_support) {
@@ -33,6 +82,21 @@ class DLL_PUBLIC HawkesCumulant : public ModelHawkesList {
   void set_are_cumulants_ready(const bool are_cumulants_ready) {
     this->are_cumulants_ready = are_cumulants_ready;
   }
+
+ private:
+  //! @brief Computes C_ij and J_ij of realization r for all j
+  //! @param r_i : r * n_nodes + i, tells which realization and which node
+  void compute_A_and_I_ri(const ulong r_i);
+
+  //! @brief Computes E_ikk and E_jjk of realization r for all i and j
+  //! @param r_k : r * n_nodes + k, tells which realization and which node
+  void compute_E_rk(const ulong r_k);
+
+  void check_cumulants_computed() const;
 };
 
+using HawkesCumulant = THawkesCumulant<double>;
+using HawkesCumulantDouble = THawkesCumulant<double>;
+using HawkesCumulantFloat = THawkesCumulant<float>;
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_CUMULANT_H_
@@ -4,6 +4,8 @@
 
 // License: BSD 3 clause
 
+#include <complex>
+
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 
@@ -16,9 +18,14 @@
 //
 // The implementation is detailed in tex/HawkesEM.tex
 //
+// The class is templated on the type T in which the index of pairs of events
+// and the binned counts, which grow with the number of events, are stored.
+// Baselines, kernels and every accumulation remain in double
+//
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-class DLL_PUBLIC HawkesEM : public ModelHawkesList {
+template <class T>
+class DLL_PUBLIC THawkesEM : public ModelHawkesList {
   //! @brief Maximum support of the kernel
   double kernel_support;
 
@@ -31,26 +38,89 @@ class DLL_PUBLIC HawkesEM : public ModelHawkesList {
   //! @brief buffer variables
   ArrayDouble2d next_mu;
   ArrayDouble2d next_kernels;
-  ArrayDouble2d unnormalized_kernels;
+
+  //! @brief History of the last fit, n_fit_history_columns values per
+  //! record for each starting point
+  std::vector<std::vector<double> > fit_histories;
+
+  //! @brief Index of the pairs of events closer than kernel_support, built
+  //! once per dataset by allocate_weights. For a realization r and a node u
+  //! (index r_u = r * n_nodes + u), the pairs of the i-th event of node u are
+  //! stored between pairs_indptr[r_u][i] and pairs_indptr[r_u][i + 1] in
+  //! pairs_bins, the flat kernel bin v * kernel_size + m in which earlier
+  //! events of node v fall, and in pairs_counts, the number of such events
+  std::vector<std::vector<ulong> > pairs_indptr;
+  std::vector<std::vector<ulong> > pairs_bins;
+  std::vector<std::vector<T> > pairs_counts;
+
+  //! @brief Number of grid bins per kernel bin in binned mode. In this mode,
+  //! events are binned on a grid of step kernel_dt / fft_binning and the
+  //! E-step correlations are computed with FFTs. 0 means the exact pairwise
+  //! mode
+  ulong fft_binning;
+
+  //! @brief Number of events of each realization r and node v (index
+  //! r * n_nodes + v) in each grid bin, in binned mode
+  std::vector<std::vector<T> > binned_counts;
+
+  //! @brief FFT of binned_counts zero padded so that circular convolutions
+  //! with kernels match linear ones
+  std::vector<std::vector<std::complex<double> > > binned_counts_fft;
 
  public:
-  HawkesEM(const double kernel_support, const ulong kernel_size,
-           const int max_n_threads = 1);
+  THawkesEM(const double kernel_support, const ulong kernel_size,
+            const int max_n_threads = 1);
 
-  explicit HawkesEM(const SArrayDoublePtr kernel_discretization,
-                    const int max_n_threads = 1);
+  explicit THawkesEM(const SArrayDoublePtr kernel_discretization,
+                     const int max_n_threads = 1);
 
-  //! @brief allocate buffer arrays once data has been given
+  //! @brief allocate buffer arrays and build the index of pairs of events
+  //! once data has been given
   void allocate_weights();
 
   //! @brief The main method to perform one iteration
   void solve(ArrayDouble &mu, ArrayDouble2d &kernels);
 
+  /**
+   * @brief Runs the iterations from several starting points until convergence.
+   * Starting points are run in parallel, threads left are used within each of
+   * them. All of them share the index of pairs of events
+   * \param mu_starts : Array of shape (n_starts, n_nodes) of starting
+   * baselines. Each row is replaced by the baseline fitted from it
+   * \param kernels_starts : Array of shape (n_starts, n_nodes * n_nodes *
+   * kernel_size) of starting kernels. Each row is replaced by the kernels
+   * fitted from it
+   * \param max_iter : Maximum number of iterations of each starting point
+   * \param tol : The iterations of a starting point stop once the relative
+   * changes of its baseline and of its kernels are both below tol
+   * \param record_every : Convergence is checked and the log-likelihood
+   * recorded every record_every iterations and at the last one. If 0, all
+   * iterations are run and only the last one is recorded
+   * \return The index of the starting point reaching the highest finite
+   * log-likelihood, starting points reaching a non positive intensity are
+   * never chosen unless all of them do
+   */
+  ulong fit(ArrayDouble2d &mu_starts, ArrayDouble2d &kernels_starts,
+            const ulong max_iter, const double tol,
+            const ulong record_every = 1);
+
+  //! @brief History of the last fit of a starting point, each row holding
+  //! the iteration number, the relative changes of baseline and kernels and
+  //! the log-likelihood
+  SArrayDouble2dPtr get_fit_history(const ulong start) const;
+
   //! @brief Compute loglikelihood of a given kernel and baseline
   double loglikelihood(const ArrayDouble &mu, ArrayDouble2d &kernels);
 
   SArrayDouble2dPtr get_kernel_norms(ArrayDouble2d &kernels) const;
 
+  //! @brief Compute the residuals of the time rescaling theorem, that is the
+  //! compensator of each node between two consecutive jumps of this node,
+  //! for each realization. If the model is well specified, they are i.i.d.
+  //! exponential random variables of mean 1
+  SArrayDoublePtrList2D get_residuals(const ArrayDouble &mu,
+                                      ArrayDouble2d &kernels);
+
   double get_kernel_support() const { return kernel_support; }
 
   ulong get_kernel_size() const { return kernel_size; }
@@ -71,34 +141,101 @@ class DLL_PUBLIC HawkesEM : public ModelHawkesList {
 
   void set_kernel_discretization(const SArrayDoublePtr kernel_discretization);
 
+  ulong get_fft_binning() const { return fft_binning; }
+
+  //! @brief set the number of grid bins per kernel bin of the binned FFT
+  //! mode, 0 to use the exact pairwise mode
+  //! \note The binned mode is exact up to the grid resolution, it costs
+  //! O(n_nodes^2 T / dt log(T / dt)) per iteration, whatever the number of
+  //! events. It requires a uniform kernel discretization
+  void set_fft_binning(const ulong fft_binning);
+
  private:
+  //! @brief Performs one iteration, storing intermediate results in the
+  //! given buffers of the shapes of next_mu and next_kernels
+  void solve(ArrayDouble &mu, ArrayDouble2d &kernels,
+             ArrayDouble2d &next_mu_buffer, ArrayDouble2d &next_kernels_buffer,
+             const unsigned int n_threads);
+
+  //! @brief Computes loglikelihood using n_threads threads
+  double loglikelihood(const ArrayDouble &mu, ArrayDouble2d &kernels,
+                       const unsigned int n_threads);
+
+  //! @brief A method called in parallel by the method 'fit', running the
+  //! iterations of one starting point
+  void fit_start(const ulong start, ArrayDouble2d &mu_starts,
+                 ArrayDouble2d &kernels_starts, const ulong max_iter,
+                 const double tol, const ulong record_every,
+                 const unsigned int n_threads_per_start,
+                 ArrayDouble &loglikelihoods);
+
   //! @brief A method called in parallel by the method 'solve'
-  //! @param r_u : r * n_realizations + u, tells which realization and which
-  //! node
-  void solve_ur(const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernel);
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  void solve_ur(const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernels,
+                ArrayDouble2d &next_mu_buffer,
+                ArrayDouble2d &next_kernels_buffer);
 
   //! @brief A method called in parallel by the method 'loglikelihood'
-  //! @param r_u : r * n_realizations + u, tells which realization and which
-  //! node
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
   double loglikelihood_ur(const ulong r_u, const ArrayDouble &mu,
-                          ArrayDouble2d &kernels);
+                          ArrayDouble2d &kernels,
+                          const ArrayDouble2d &kernel_norms,
+                          const ArrayDouble &kernel_discretization);
+
+  //! @brief A method called in parallel by allocate_weights to build the
+  //! index of pairs of events of node u of realization r
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  void compute_pairs_index_ur(const ulong r_u);
+
+  //! @brief A method called in parallel by the method 'solve' in binned mode
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  void solve_binned_ur(const ulong r_u, const ArrayDouble &mu,
+                       ArrayDouble2d &kernels, ArrayDouble2d &next_mu_buffer,
+                       ArrayDouble2d &next_kernels_buffer);
+
+  //! @brief A method called in parallel by the method 'loglikelihood' in
+  //! binned mode
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  double loglikelihood_binned_ur(const ulong r_u, const ArrayDouble &mu,
+                                 ArrayDouble2d &kernels,
+                                 const ArrayDouble2d &kernel_norms,
+                                 const ArrayDouble &kernel_discretization);
+
+  //! @brief A method called in parallel by allocate_weights to bin the
+  //! events of node v of realization r and compute their FFT
+  //! @param r_v : r * n_nodes + v, tells which realization and which node
+  void compute_binned_counts_rv(const ulong r_v);
+
+  //! @brief Computes the intensity of node u of realization r in each grid
+  //! bin, as seen by the events of this bin, in binned mode
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  //! @param intensities : vector in which the intensities are stored
+  void compute_binned_intensities_ur(const ulong r_u, const ArrayDouble &mu,
+                                     ArrayDouble2d &kernels,
+                                     std::vector<double> &intensities);
 
   //! @brief A method called by solve_ur and logliklihood_ur to compute all
   //! intensities at all timestamps occuring in node u of realization r
-  //! @param r_u : r * n_realizations + u, tells which realization and which
-  //! node
-  //! @param intensity_func : function that will be called for all timestamps
-  //! with the intensity at this timestamp as argument
-  //! @param store_unnormalized_kernel : solve_ur method needs to store an
-  //! unnormalized version of the kernels in the class variable
-  //! unnormalized_kernels
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  //! @param intensity_func : functor that will be called for all timestamps
+  //! with the range of their pairs in the index and the intensity at this
+  //! timestamp as arguments
+  template <class IntensityFunc>
   void compute_intensities_ur(const ulong r_u, const ArrayDouble &mu,
                               ArrayDouble2d &kernels,
-                              std::function<void(double)> intensity_func,
-                              bool store_unnormalized_kernel);
+                              IntensityFunc &intensity_func);
 
   double compute_compensator_ur(const ulong r_u, const ArrayDouble &mu,
-                                ArrayDouble2d &kernels);
+                                ArrayDouble2d &kernels,
+                                const ArrayDouble2d &kernel_norms,
+                                const ArrayDouble &kernel_discretization);
+
+  //! @brief A method called in parallel by the method 'get_residuals'
+  //! @param r_u : r * n_nodes + u, tells which realization and which node
+  void compute_residuals_ur(const ulong r_u, const ArrayDouble &mu,
+                            ArrayDouble2d &kernels,
+                            const ArrayDouble &kernel_discretization,
+                            SArrayDoublePtrList2D &residuals);
 
   void check_baseline_and_kernels(const ArrayDouble &mu,
                                   ArrayDouble2d &kernels) const;
@@ -110,4 +247,8 @@ class DLL_PUBLIC HawkesEM : public ModelHawkesList {
   double get_kernel_dt(const ulong m = 0) const;
 };
 
+using HawkesEM = THawkesEM<double>;
+using HawkesEMDouble = THawkesEM<double>;
+using HawkesEMFloat = THawkesEM<float>;
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_EM_H_
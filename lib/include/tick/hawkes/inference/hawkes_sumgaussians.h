@@ -4,6 +4,8 @@
 
 // License: BSD 3 clause
 
+#include <vector>
+
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 
@@ -12,8 +14,11 @@
  * \brief Class for implementation of the algorithm described in the paper
  * `Learning Granger Causality for Hawkes Processes`
  *  by Xu, Farajtabar, and Zha (2016) in ICML
+ * \tparam T : type in which the weights of each event are stored. Baseline,
+ * amplitudes and every accumulation remain in double
  */
-class DLL_PUBLIC HawkesSumGaussians : public ModelHawkesList {
+template <class T>
+class DLL_PUBLIC THawkesSumGaussians : public ModelHawkesList {
   //! @brief Number of gaussian functions to approximate each kernel
   ulong n_gaussians;
 
@@ -50,23 +55,41 @@ class DLL_PUBLIC HawkesSumGaussians : public ModelHawkesList {
   //! ds
   ArrayDouble kernel_integral;
 
-  //! @brief Weights storing sum of kernel values at specific points
-  //! for realization r: g[r][u][i][v*n_nodes+m] = \sum_{t_j^v < t_i^u}
-  //! g_m(t_i^u - t_j^v)
-  ArrayDouble2dList2D g;
+  //! @brief Number of standard deviations after which gaussian functions are
+  //! considered null. If 0, gaussian functions are evaluated exactly on their
+  //! whole support, otherwise they are read from lookup tables
+  double n_std_truncation;
+
+  //! @brief Lookup tables of exp(-x^2 / 2) and erf(x / sqrt(2)) on
+  //! [0, n_std_truncation] with n_table_points_per_std points per standard
+  //! deviation. Values in between are interpolated with cubic Hermite
+  //! polynomials, using the derivatives known in closed form
+  ArrayDouble gaussian_table, erf_table;
+  static const ulong n_table_points_per_std = 1024;
+
+  //! @brief Sparse weights storing sum of kernel values at specific points
+  //! for realization r and node u (index r * n_nodes + u): the non zero values
+  //! of g[i][v*n_gaussians+m] = \sum_{t_j^v < t_i^u} g_m(t_i^u - t_j^v)
+  //! for the i-th event of node u are stored between g_indptr[r_u][i] and
+  //! g_indptr[r_u][i + 1], g_indices holding v*n_gaussians+m
+  std::vector<std::vector<ulong> > g_indptr, g_indices;
+  std::vector<std::vector<T> > g_values;
 
   //! @brief Buffer variables used to compute p_ij
-  ArrayDouble2d next_C, unnormalized_next_C;
+  ArrayDouble2d next_C;
 
   //! @brief Buffer variables to compute next baseline (mu)
   ArrayDouble2d next_mu;
 
+  //! @brief History of the last fit, three values per checked iteration
+  std::vector<double> fit_history;
+
  public:
-  HawkesSumGaussians(const ulong n_gaussians, const double max_mean_gaussian,
-                     const double step_size, const double strength_lasso,
-                     const double strength_grouplasso, const ulong em_max_iter,
-                     const int max_n_threads = 1,
-                     const unsigned int optimization_level = 0);
+  THawkesSumGaussians(const ulong n_gaussians, const double max_mean_gaussian,
+                      const double step_size, const double strength_lasso,
+                      const double strength_grouplasso, const ulong em_max_iter,
+                      const int max_n_threads = 1,
+                      const unsigned int optimization_level = 0);
 
   //! @brief allocate buffer arrays once data has been given
   void compute_weights();
@@ -74,9 +97,39 @@ class DLL_PUBLIC HawkesSumGaussians : public ModelHawkesList {
   //! @brief Perform one iteration of the algorithm
   void solve(ArrayDouble &mu, ArrayDouble2d &amplitudes);
 
+  /**
+   * @brief Runs the iterations of the algorithm until convergence
+   * \param mu : Starting baseline, replaced by the fitted one
+   * \param amplitudes : Starting amplitudes of shape (n_nodes, n_nodes *
+   * n_gaussians), replaced by the fitted ones
+   * \param max_iter : Maximum number of iterations
+   * \param tol : The iterations stop once the relative changes of baseline
+   * and amplitudes are both below tol, after at least 7 iterations
+   * \param em_tol : The iterations also stop once both relative changes are
+   * below em_tol. If negative, a hundredth of the largest relative change of
+   * the previous checked iteration is used instead
+   * \param record_every : Convergence is checked and the relative changes
+   * recorded every record_every iterations and at the last one. If 0, only
+   * the last iteration is checked
+   * \return The number of iterations run
+   */
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &amplitudes, const ulong max_iter,
+            const double tol, const double em_tol,
+            const ulong record_every = 1);
+
+  //! @brief History of the last fit, each row holding the iteration number
+  //! and the relative changes of baseline and amplitudes
+  SArrayDouble2dPtr get_fit_history() const;
+
  private:
   void compute_weights_ru(const ulong r_u, ArrayDouble2d &map_kernel_integral);
 
+  //! @brief Gaussian density of standard deviation std_gaussian at x
+  double gaussian_density(const double x);
+
+  //! @brief Integral of this gaussian density from -infinity to x
+  double gaussian_cdf(const double x);
+
   void update_u(const ulong u, ArrayDouble &mu, ArrayDouble2d &amplitudes);
 
   void estimate_ru(const ulong r_u, ArrayDouble &mu, ArrayDouble2d &amplitudes);
@@ -101,6 +154,12 @@ class DLL_PUBLIC HawkesSumGaussians : public ModelHawkesList {
   void set_strength_lasso(const double strength_lasso);
   double get_strength_grouplasso() const;
   void set_strength_grouplasso(const double strength_grouplasso);
+  double get_n_std_truncation() const;
+  void set_n_std_truncation(const double n_std_truncation);
 };
 
+using HawkesSumGaussians = THawkesSumGaussians<double>;
+using HawkesSumGaussiansDouble = THawkesSumGaussians<double>;
+using HawkesSumGaussiansFloat = THawkesSumGaussians<float>;
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_INFERENCE_HAWKES_SUMGAUSSIANS_H_
@@ -8,15 +8,23 @@
 #include "tick/hawkes/model/base/model_hawkes_list.h"
 #include "tick/hawkes/model/base/model_hawkes_loglik_single.h"
 
-/** \class ModelHawkesLogLik
+#include <array>
+
+/** \class TModelHawkesLogLik
  * \brief Class for computing L2 Contrast function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e.,
  * alpha*beta*e^{-beta t}, with fixed beta) on a list of realizations
+ * \tparam T : type in which the weights of each realization are stored
  */
-class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
+template <class T>
+class DLL_PUBLIC TModelHawkesLogLik : public ModelHawkesList {
   //! @brief Value of decay for this model. Shared by all kernels
 
-  std::vector<std::unique_ptr<ModelHawkesLogLikSingle> > model_list;
+  std::vector<std::unique_ptr<TModelHawkesLogLikSingle<T> > > model_list;
+
+  //! @brief (n_realizations + 1) prefix sums of n_jumps_per_realization, used
+  //! to map a sampled timestamp to its realization by binary search
+  ArrayULong cum_n_jumps_per_realization;
 
  public:
   /**
@@ -25,7 +33,7 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
    * \param max_n_threads : number of cores to be used for multithreading. If
    * negative, the number of physical cores will be used
    */
-  explicit ModelHawkesLogLik(const int max_n_threads = 1);
+  explicit TModelHawkesLogLik(const int max_n_threads = 1);
 
   /**
    * These lines are required for visual studio but are suggested in general
@@ -33,8 +41,9 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
    *  Visual studio seems to get confused and tries to copy this class, and it
    *   errors as unique_ptrs are not copy-able
    */
-  ModelHawkesLogLik(const ModelHawkesLogLik &model) = delete;
-  ModelHawkesLogLik &operator=(const ModelHawkesLogLik &model) = delete;
+  TModelHawkesLogLik(const TModelHawkesLogLik<T> &model) = delete;
+  TModelHawkesLogLik<T> &operator=(const TModelHawkesLogLik<T> &model) =
+      delete;
 
   void incremental_set_data(const SArrayDoublePtrList1D &timestamps,
                             double end_time);
@@ -74,6 +83,36 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
   void grad_i(const ulong i, const ArrayDouble &coeffs,
               ArrayDouble &out) override;
 
+  bool has_grad_i_sparse() const override { return true; }
+
+  /**
+   * @brief Coefficients on which the gradient of sample i depends: the
+   * baseline of the node of sample i and the coefficients between
+   * get_alpha_i_first_index(node) and get_alpha_i_last_index(node)
+   */
+  void get_grad_i_support(const ulong i, std::vector<ulong> &support) override;
+
+  /**
+   * @brief Compute gradient corresponding to sample i (between 0 and rand_max)
+   * on its support only
+   * \param i : selected sample
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored. Only the
+   * coordinates of the support are written, the others are left untouched
+   */
+  void grad_i_sparse(const ulong i, const ArrayDouble &coeffs,
+                     ArrayDouble &out) override;
+
+  //! @brief Return the start of alpha i coefficients in a coeffs vector
+  ulong get_alpha_i_first_index(const ulong i) const {
+    return n_nodes + i * (get_n_coeffs() - n_nodes) / n_nodes;
+  }
+
+  //! @brief Return the end of alpha i coefficients in a coeffs vector
+  ulong get_alpha_i_last_index(const ulong i) const {
+    return n_nodes + (i + 1) * (get_n_coeffs() - n_nodes) / n_nodes;
+  }
+
   /**
    * @brief Compute loss and gradient
    * \param coeffs : Point in which loss and gradient are computed
@@ -98,6 +137,15 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
    */
   void hessian(const ArrayDouble &coeffs, ArrayDouble &out);
 
+  /**
+   * @brief Compute the residuals of the time rescaling theorem, that is the
+   * compensator of each node between two consecutive jumps of this node
+   * \param coeffs : Point in which residuals are computed
+   * \return For each realization, list of n_nodes arrays holding the
+   * residuals of each jump
+   */
+  SArrayDoublePtrList2D get_residuals(const ArrayDouble &coeffs);
+
   ulong get_rand_max() const { return get_n_total_jumps(); }
 
   ulong get_n_coeffs() const override;
@@ -108,24 +156,28 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
                         cereal::base_class<ModelHawkesList>(this)));
 
     ar(CEREAL_NVP(model_list));
+    ar(CEREAL_NVP(cum_n_jumps_per_realization));
   }
 
-  BoolStrReport compare(const ModelHawkesLogLik &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesLogLik<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
     auto are_equal = ModelHawkesList::compare(that, ss) &&
-                     TICK_CMP_REPORT_VECTOR_UPTR_1D(ss, model_list, ModelHawkesLogLikSingle);
+                     TICK_CMP_REPORT_VECTOR_UPTR_1D(ss, model_list,
+                                                    TModelHawkesLogLikSingle<T>) &&
+                     TICK_CMP_REPORT(ss, cum_n_jumps_per_realization);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesLogLik &that) {
+  BoolStrReport compare(const TModelHawkesLogLik<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesLogLik &that) {
-    return ModelHawkesLogLik::compare(that);
+  BoolStrReport operator==(const TModelHawkesLogLik<T> &that) {
+    return TModelHawkesLogLik<T>::compare(that);
   }
 
  protected:
-  virtual std::unique_ptr<ModelHawkesLogLikSingle> build_model(
+  virtual std::unique_ptr<TModelHawkesLogLikSingle<T> > build_model(
       const int n_threads) {
     TICK_CLASS_DOES_NOT_IMPLEMENT("");
   }
@@ -140,10 +192,51 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
   std::tuple<ulong, ulong> get_realization_node(ulong i_r);
 
   /**
-   * @brief Compute weights for one index between 0 and n_realizations * n_nodes
-   * @param i_r : r * n_realizations + i, tells which realization and which node
+   * @brief Splitting of the weights computation in chunks of similar costs.
+   * A chunk covers the timestamps k_start <= k < k_end of node i of
+   * realization r against the jumps of node j. The chunks of a same (r, i, j)
+   * triplet are consecutive and chained through the kernels state carried
+   * from one chunk to the next one
    */
-  void compute_weights_i_r(const ulong i_r);
+  struct WeightsSchedule {
+    //! @brief (r, i, j, k_start, k_end) of each chunk
+    std::vector<std::array<ulong, 5> > chunks;
+    //! @brief Index of the first chunk of each (r, i, j) triplet, followed by
+    //! the total number of chunks
+    std::vector<ulong> triplets;
+    //! @brief Index of the first chunk run by each thread, followed by the
+    //! total number of chunks
+    std::vector<ulong> slices;
+    //! @brief Sum of G values computed by each chunk, for each decay
+    ArrayDouble2d chunks_sum_G;
+    //! @brief Kernels state carried at the start of each chunk, for each decay
+    ArrayDouble2d chunks_carry;
+  };
+
+  /**
+   * @brief Splits the weights computation in (r, i, j) triplets, themselves
+   * split in time chunks if needed, and balances them over n_threads threads.
+   * The cost of a triplet is estimated by the number of jumps of nodes i and j
+   * in realization r
+   */
+  WeightsSchedule schedule_weights(const unsigned int n_threads) const;
+
+  /**
+   * @brief Compute the weights of the chunks of one thread slice, as if no
+   * state were carried from previous chunks
+   */
+  void compute_weights_slice(const ulong slice, WeightsSchedule &schedule);
+
+  /**
+   * @brief Chains the chunks of one (r, i, j) triplet: computes the state
+   * carried at the start of each chunk and the resulting sum_G
+   */
+  void carry_weights_triplet(const ulong triplet, WeightsSchedule &schedule);
+
+  //! @brief Adds the carried state to the weights of the chunks of one thread
+  //! slice
+  void add_carried_weights_slice(const ulong slice,
+                                 WeightsSchedule &schedule);
 
   /**
    * @brief Compute loss for one index between 0 and n_realizations * n_nodes
@@ -180,10 +273,30 @@ class DLL_PUBLIC ModelHawkesLogLik : public ModelHawkesList {
   void hessian_i_r(const ulong i_r, const ArrayDouble &coeffs,
                    ArrayDouble &out);
 
+  /**
+   * @brief Compute residuals for one index between 0 and n_realizations *
+   * n_nodes
+   * \param i_r : r * n_nodes + i, tells which realization and which node
+   * \param coeffs : Point in which residuals are computed
+   * \param residuals : Lists of arrays in which residuals are stored
+   */
+  void residuals_i_r(const ulong i_r, const ArrayDouble &coeffs,
+                     SArrayDoublePtrList2D &residuals);
+
   std::pair<ulong, ulong> sampled_i_to_realization(const ulong sampled_i);
+
+  //! @brief Fills cum_n_jumps_per_realization from n_jumps_per_realization
+  void compute_cum_n_jumps_per_realization();
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLik,
+using ModelHawkesLogLik = TModelHawkesLogLik<double>;
+
+using ModelHawkesLogLikDouble = TModelHawkesLogLik<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLikDouble,
+                                   cereal::specialization::member_serialize)
+
+using ModelHawkesLogLikFloat = TModelHawkesLogLik<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLikFloat,
                                    cereal::specialization::member_serialize)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_BASE_MODEL_HAWKES_LOGLIK_H_
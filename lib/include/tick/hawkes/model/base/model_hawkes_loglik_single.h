@@ -8,28 +8,36 @@
 
 #include "tick/hawkes/model/base/model_hawkes_single.h"
 
-class ModelHawkesLogLik;
+template <class T>
+class TModelHawkesLogLik;
 
 /**
- * \class ModelHawkesLogLikSingle
+ * \class TModelHawkesLogLikSingle
  * \brief Class for computing loglikelihood function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e., \f$ \alpha
  * \beta e^{-\beta t} \f$, with fixed decay)
+ * \tparam T : type in which weights g, G and sum_G are stored. Coefficients,
+ * gradients and all reductions (loss sums, dot products) remain in double
  */
-class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
+template <class T>
+class DLL_PUBLIC TModelHawkesLogLikSingle : public ModelHawkesSingle {
  protected:
   // Some arrays used for intermediate computings. They are initialized in
   // init()
   //! @brief kernel intensity of node j on node i at time t_i_k
-  ArrayDouble2dList1D g;
+  std::vector<Array2d<T> > g;
 
   //! @brief compensator of kernel intensity of node j on node i between t_i_k
   //! and t_i_(k-1)
-  ArrayDouble2dList1D G;
+  std::vector<Array2d<T> > G;
 
   //! @brief compensator of kernel intensity of node j on node i between 0 and
   //! end_time
-  ArrayDoubleList1D sum_G;
+  std::vector<Array<T> > sum_G;
+
+  //! @brief (n_nodes + 1) prefix sums of n_jumps_per_node, used to map a
+  //! sampled timestamp to its node by binary search
+  ArrayULong cum_n_jumps_per_node;
 
  public:
   /**
@@ -37,7 +45,7 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
    * \param n_threads : number of threads that will be used for parallel
    * computations
    */
-  explicit ModelHawkesLogLikSingle(const int max_n_threads = 1);
+  explicit TModelHawkesLogLikSingle(const int max_n_threads = 1);
 
   /**
    * @brief Precomputations of intermediate values
@@ -90,6 +98,27 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
   void grad_i(const ulong i, const ArrayDouble &coeffs,
               ArrayDouble &out) override;
 
+  bool has_grad_i_sparse() const override { return true; }
+
+  /**
+   * @brief Coefficients on which the gradient of sample i depends: the
+   * baseline of the node of sample i and the coefficients between
+   * get_alpha_i_first_index(node) and get_alpha_i_last_index(node)
+   */
+  void get_grad_i_support(const ulong i, std::vector<ulong> &support) override;
+
+  /**
+   * @brief Compute gradient corresponding to sample i (between 0 and rand_max)
+   * on its support only
+   * \param i : selected sample
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored. Only the
+   * coordinates of the support are written, the others are left untouched
+   * \note This costs O(n_nodes) instead of O(n_coeffs) for grad_i
+   */
+  void grad_i_sparse(const ulong i, const ArrayDouble &coeffs,
+                     ArrayDouble &out) override;
+
   /**
    * @brief Compute the hessian norm \f$ \sqrt{ d^T \nabla^2 f(x) d} \f$
    * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
@@ -106,6 +135,19 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
    */
   void hessian(const ArrayDouble &coeffs, ArrayDouble &out);
 
+  /**
+   * @brief Compute the residuals of the time rescaling theorem, that is the
+   * compensator of each node between two consecutive jumps of this node
+   * \f[
+   *     \int_{t^i_{k-1}}^{t^i_k} \lambda_i(t) dt
+   * \f]
+   * with \f$ t^i_{-1} = 0 \f$. If the model is well specified, they are
+   * i.i.d. exponential random variables of mean 1
+   * \param coeffs : Point in which residuals are computed
+   * \return List of n_nodes arrays holding the residuals of each jump
+   */
+  SArrayDoublePtrList1D get_residuals(const ArrayDouble &coeffs);
+
  protected:
   virtual void allocate_weights();
   /**
@@ -114,6 +156,57 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
    */
   virtual void compute_weights_dim_i(const ulong i);
 
+  /**
+   * @brief Precomputations of intermediate values of component i due to the
+   * kernels of component j, restricted to the timestamps of indices
+   * k_start <= k < k_end of component i (index n_jumps_i stands for end_time)
+   * \param i : selected component
+   * \param j : component whose jumps excite component i
+   * \param k_start : first timestamp index of component i
+   * \param k_end : last timestamp index of component i (excluded)
+   * \param sum_G_i_j : Array of size get_n_kernel_decays() in which the sum of
+   * the computed G values is stored
+   * \note The state of the kernels at t_i_(k_start - 1) is considered null,
+   * its contribution is added afterwards by add_carried_weights_dim_i_j. For
+   * different values of (i, j) or disjoint ranges of k, this function modifies
+   * different weights. Hence, it is thread safe.
+   */
+  void compute_weights_dim_i_j(const ulong i, const ulong j,
+                               const ulong k_start, const ulong k_end,
+                               ArrayDouble &sum_G_i_j);
+
+  /**
+   * @brief Adds to the weights computed by compute_weights_dim_i_j the
+   * contribution of the kernels state at t_i_(k_start - 1)
+   * \param i : selected component
+   * \param j : component whose jumps excite component i
+   * \param k_start : first timestamp index of component i, must be positive
+   * \param k_end : last timestamp index of component i (excluded)
+   * \param carry : value of g for each decay at t_i_(k_start - 1)
+   */
+  void add_carried_weights_dim_i_j(const ulong i, const ulong j,
+                                   const ulong k_start, const ulong k_end,
+                                   const ArrayDouble &carry);
+
+  //! @brief Returns the number of exponential decays per kernel
+  virtual ulong get_n_kernel_decays() const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT("");
+  }
+
+  //! @brief Returns the u-th exponential decay shared by all kernels
+  virtual double get_kernel_decay(const ulong u) const {
+    TICK_CLASS_DOES_NOT_IMPLEMENT("");
+  }
+
+  //! @brief Returns the k-th timestamp of component i, or end_time if k is
+  //! n_jumps_i
+  inline double get_time_i_k(const ulong i, const ulong k) const {
+    return k < (*n_jumps_per_node)[i] ? (*timestamps[i])[k] : end_time;
+  }
+
+  //! @brief Fills cum_n_jumps_per_node from n_jumps_per_node
+  void compute_cum_n_jumps_per_node();
+
   /**
    * @brief Convert sample i (between 0 and rand_max) to a tuple component,
    * timestamp index \param samples_d : selected sample \param i : Where the
@@ -191,6 +284,17 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
    */
   void hessian_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out);
 
+  /**
+   * @brief Compute residuals corresponding to component i from the weights G
+   * \param i : selected component
+   * \param coeffs : Point in which residuals are computed
+   * \param residuals : List of arrays in which residuals are stored, only
+   * residuals[i] is modified. Hence, it is thread safe.
+   */
+  void compute_residuals_dim_i(const ulong i, const ArrayDouble &coeffs,
+                               SArrayDoublePtrList1D &residuals);
+
+ public:
   /**
    * @brief Return the start of alpha i coefficients in a coeffs vector
    * @param i : selected dimension
@@ -207,12 +311,12 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
     TICK_CLASS_DOES_NOT_IMPLEMENT("");
   }
 
- public:
   //! @brief Returns max of the range of feasible grad_i and loss_i (total
   //! number of timestamps)
   inline ulong get_rand_max() const { return n_total_jumps; }
 
-  friend ModelHawkesLogLik;
+  template <class>
+  friend class TModelHawkesLogLik;
 
   template <class Archive>
   void serialize(Archive &ar) {
@@ -222,26 +326,36 @@ class DLL_PUBLIC ModelHawkesLogLikSingle : public ModelHawkesSingle {
     ar(CEREAL_NVP(g));
     ar(CEREAL_NVP(G));
     ar(CEREAL_NVP(sum_G));
+    ar(CEREAL_NVP(cum_n_jumps_per_node));
   }
 
-  BoolStrReport compare(const ModelHawkesLogLikSingle &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesLogLikSingle<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
     auto are_equal = ModelHawkesSingle::compare(that, ss) &&
                      TICK_CMP_REPORT_VECTOR(ss, g) &&
                      TICK_CMP_REPORT_VECTOR(ss, G) &&
-                     TICK_CMP_REPORT_VECTOR(ss, sum_G);
+                     TICK_CMP_REPORT_VECTOR(ss, sum_G) &&
+                     TICK_CMP_REPORT(ss, cum_n_jumps_per_node);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesLogLikSingle &that) {
+  BoolStrReport compare(const TModelHawkesLogLikSingle<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesLogLikSingle &that) {
-    return ModelHawkesLogLikSingle::compare(that);
+  BoolStrReport operator==(const TModelHawkesLogLikSingle<T> &that) {
+    return TModelHawkesLogLikSingle<T>::compare(that);
   }
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLikSingle,
+using ModelHawkesLogLikSingle = TModelHawkesLogLikSingle<double>;
+
+using ModelHawkesLogLikSingleDouble = TModelHawkesLogLikSingle<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLikSingleDouble,
+                                   cereal::specialization::member_serialize)
+
+using ModelHawkesLogLikSingleFloat = TModelHawkesLogLikSingle<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesLogLikSingleFloat,
                                    cereal::specialization::member_serialize)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_BASE_MODEL_HAWKES_LOGLIK_SINGLE_H_
@@ -16,11 +16,22 @@
 class DLL_PUBLIC ModelHawkesExpKernLeastSq : public ModelHawkesLeastSq {
   //! @brief Some arrays used for intermediate computings. They are initialized
   //! in init()
-  ArrayDouble2d E, Dg, Dg2, C;
+  ArrayDouble2d Dg, Dg2, C;
+
+  //! @brief Flat storage of the E_i blocks, see
+  //! ModelHawkesExpKernLeastSqSingle
+  ArrayDouble E;
 
   //! @brief The 2d array of decays (remember that the decays are fixed!)
   SArrayDouble2dPtr decays;
 
+  //! @brief Node j might excite node i only if adjacency_mask(i, j) != 0.
+  //! If nullptr, all pairs of nodes are considered
+  SArrayULong2dPtr adjacency_mask;
+
+  //! @brief Compressed adjacency support shared with the aggregated model
+  ArrayULong source_indptr, source_indices, E_indptr;
+
  public:
   //! @brief Empty constructor
   //! This constructor should only be used for serialization
@@ -59,6 +70,21 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSq : public ModelHawkesLeastSq {
     this->decays = decays;
   }
 
+  /**
+   * @brief Restrict the adjacency matrix to a sparsity pattern and reset
+   * weights computing. Only the allowed pairs of nodes are computed and
+   * stored, which is needed when n_nodes is large
+   * @param adjacency_mask : (n_nodes, n_nodes) array, node j might excite
+   * node i only if adjacency_mask(i, j) != 0. If nullptr, no restriction is
+   * applied
+   */
+  void set_adjacency_mask(const SArrayULong2dPtr adjacency_mask) {
+    weights_computed = false;
+    this->adjacency_mask = adjacency_mask;
+  }
+
+  SArrayULong2dPtr get_adjacency_mask() const { return adjacency_mask; }
+
   ulong get_n_coeffs() const override;
 
  private:
@@ -93,6 +119,10 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSq : public ModelHawkesLeastSq {
     ar(CEREAL_NVP(Dg2));
     ar(CEREAL_NVP(C));
     ar(CEREAL_NVP(decays));
+    ar(CEREAL_NVP(adjacency_mask));
+    ar(CEREAL_NVP(source_indptr));
+    ar(CEREAL_NVP(source_indices));
+    ar(CEREAL_NVP(E_indptr));
   }
 
   BoolStrReport compare(const ModelHawkesExpKernLeastSq &that, std::stringstream &ss) {
@@ -102,7 +132,11 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSq : public ModelHawkesLeastSq {
                      TICK_CMP_REPORT(ss, Dg) &&
                      TICK_CMP_REPORT(ss, Dg2) &&
                      TICK_CMP_REPORT(ss, C) &&
-                     TICK_CMP_REPORT_PTR(ss, decays);
+                     TICK_CMP_REPORT_PTR(ss, decays) &&
+                     TICK_CMP_REPORT_PTR(ss, adjacency_mask) &&
+                     TICK_CMP_REPORT(ss, source_indptr) &&
+                     TICK_CMP_REPORT(ss, source_indices) &&
+                     TICK_CMP_REPORT(ss, E_indptr);
     return BoolStrReport(are_equal, ss.str());
   }
   BoolStrReport compare(const ModelHawkesExpKernLeastSq &that) {
@@ -8,25 +8,35 @@
 #include "tick/hawkes/model/base/model_hawkes_loglik.h"
 #include "tick/hawkes/model/model_hawkes_expkern_loglik_single.h"
 
-/** \class ModelHawkesExpKernLogLik
+/** \class TModelHawkesExpKernLogLik
  * \brief Class for computing L2 Contrast function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e.,
  * alpha*beta*e^{-beta t}, with fixed beta) on a list of realizations
+ * \tparam T : type in which weights are stored
  */
-class DLL_PUBLIC ModelHawkesExpKernLogLik : public ModelHawkesLogLik {
+template <class T>
+class DLL_PUBLIC TModelHawkesExpKernLogLik : public TModelHawkesLogLik<T> {
+ protected:
+  using TModelHawkesLogLik<T>::n_nodes;
+  using TModelHawkesLogLik<T>::weights_computed;
+
+ public:
+  using TModelHawkesLogLik<T>::get_class_name;
+
+ private:
   //! @brief Value of decay for this model. Shared by all kernels
   double decay;
 
  public:
-  ModelHawkesExpKernLogLik() {}
+  TModelHawkesExpKernLogLik() {}
   /**
    * @brief Constructor
    * \param decay : decay for this model (remember that decay is fixed!)
    * \param max_n_threads : number of cores to be used for multithreading. If
    * negative, the number of physical cores will be used
    */
-  explicit ModelHawkesExpKernLogLik(const double decay,
-                                    const int max_n_threads = 1);
+  explicit TModelHawkesExpKernLogLik(const double decay,
+                                     const int max_n_threads = 1);
 
   /**
    * @brief Set decays and reset weights computing
@@ -39,39 +49,49 @@ class DLL_PUBLIC ModelHawkesExpKernLogLik : public ModelHawkesLogLik {
 
   double get_decay() const { return decay; }
 
-  std::unique_ptr<ModelHawkesLogLikSingle> build_model(
+  std::unique_ptr<TModelHawkesLogLikSingle<T> > build_model(
       const int n_threads) override {
-    return std::unique_ptr<ModelHawkesExpKernLogLikSingle>(
-        new ModelHawkesExpKernLogLikSingle(decay, n_threads));
+    return std::unique_ptr<TModelHawkesExpKernLogLikSingle<T> >(
+        new TModelHawkesExpKernLogLikSingle<T>(decay, n_threads));
   }
 
   ulong get_n_coeffs() const override;
 
   template <class Archive>
   void serialize(Archive &ar) {
-    ar(cereal::make_nvp("ModelHawkesLogLik",
-                        cereal::base_class<ModelHawkesLogLik>(this)));
+    ar(cereal::make_nvp(
+        "ModelHawkesLogLik",
+        typename cereal::base_class<TModelHawkesLogLik<T> >(this)));
 
     ar(CEREAL_NVP(decay));
   }
 
-  BoolStrReport compare(const ModelHawkesExpKernLogLik &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesExpKernLogLik<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
-    auto are_equal = ModelHawkesLogLik::compare(that, ss) &&
+    auto are_equal = TModelHawkesLogLik<T>::compare(that, ss) &&
                      TICK_CMP_REPORT(ss, decay);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesExpKernLogLik &that) {
+  BoolStrReport compare(const TModelHawkesExpKernLogLik<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesExpKernLogLik &that) {
-    return ModelHawkesExpKernLogLik::compare(that);
+  BoolStrReport operator==(const TModelHawkesExpKernLogLik<T> &that) {
+    return TModelHawkesExpKernLogLik<T>::compare(that);
   }
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLik,
+using ModelHawkesExpKernLogLik = TModelHawkesExpKernLogLik<double>;
+
+using ModelHawkesExpKernLogLikDouble = TModelHawkesExpKernLogLik<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLikDouble,
+                                   cereal::specialization::member_serialize)
+CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLikDouble)
+
+using ModelHawkesExpKernLogLikFloat = TModelHawkesExpKernLogLik<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLikFloat,
                                    cereal::specialization::member_serialize)
-CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLik)
+CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLikFloat)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_LIST_OF_REALIZATIONS_MODEL_HAWKES_EXPKERN_LOGLIK_H_
@@ -15,9 +15,9 @@
  * alpha*beta*e^{-beta t}, with fixed beta)
  */
 class DLL_PUBLIC ModelHawkesSumExpKernLeastSq : public ModelHawkesLeastSq {
-  //! @brief Some arrays used for intermediate computings.
-  std::vector<ArrayDouble2d> E, Dgg, C;
-  ArrayDouble2dList1D Dg;
+  //! @brief Some arrays used for intermediate computings, summed over
+  //! realizations (see ModelHawkesSumExpKernLeastSqSingle for their shapes)
+  ArrayDouble2d Q, C, Dg;
 
   //! @brief some arrays used for intermediate computings in varying baseline
   //! case
@@ -94,8 +94,7 @@ class DLL_PUBLIC ModelHawkesSumExpKernLeastSq : public ModelHawkesLeastSq {
     ar(cereal::make_nvp("ModelHawkesLeastSq",
                         cereal::base_class<ModelHawkesLeastSq>(this)));
 
-    ar(CEREAL_NVP(E));
-    ar(CEREAL_NVP(Dgg));
+    ar(CEREAL_NVP(Q));
     ar(CEREAL_NVP(C));
     ar(CEREAL_NVP(Dg));
     ar(CEREAL_NVP(L));
@@ -109,10 +108,9 @@ class DLL_PUBLIC ModelHawkesSumExpKernLeastSq : public ModelHawkesLeastSq {
   BoolStrReport compare(const ModelHawkesSumExpKernLeastSq &that, std::stringstream &ss) {
     ss << get_class_name() << std::endl;
     auto are_equal = ModelHawkesLeastSq::compare(that, ss) &&
-                     TICK_CMP_REPORT_VECTOR(ss, E) &&
-                     TICK_CMP_REPORT_VECTOR(ss, Dgg) &&
-                     TICK_CMP_REPORT_VECTOR(ss, C) &&
-                     TICK_CMP_REPORT_VECTOR(ss, Dg) &&
+                     TICK_CMP_REPORT(ss, Q) &&
+                     TICK_CMP_REPORT(ss, C) &&
+                     TICK_CMP_REPORT(ss, Dg) &&
                      TICK_CMP_REPORT(ss, L) &&
                      TICK_CMP_REPORT_VECTOR(ss, K) &&
                      TICK_CMP_REPORT(ss, n_baselines) &&
@@ -8,18 +8,29 @@
 #include "tick/hawkes/model/base/model_hawkes_loglik.h"
 #include "tick/hawkes/model/model_hawkes_sumexpkern_loglik_single.h"
 
-/** \class ModelHawkesSumExpKernLogLik
+/** \class TModelHawkesSumExpKernLogLik
  * \brief Class for computing L2 Contrast function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e.,
  * alpha*beta*e^{-beta t}, with fixed beta) on a list of realizations
+ * \tparam T : type in which weights are stored
  */
-class DLL_PUBLIC ModelHawkesSumExpKernLogLik : public ModelHawkesLogLik {
+template <class T>
+class DLL_PUBLIC TModelHawkesSumExpKernLogLik : public TModelHawkesLogLik<T> {
+ protected:
+  using TModelHawkesLogLik<T>::n_nodes;
+  using TModelHawkesLogLik<T>::weights_computed;
+
+ public:
+  using TModelHawkesLogLik<T>::get_class_name;
+
+ private:
   //! @brief Value of decays array for this model
   ArrayDouble decays;
 
  public:
   // This exists soley for cereal/swig
-  ModelHawkesSumExpKernLogLik() : ModelHawkesSumExpKernLogLik(ArrayDouble(), 0) {}
+  TModelHawkesSumExpKernLogLik()
+      : TModelHawkesSumExpKernLogLik(ArrayDouble(), 0) {}
 
   /**
    * @brief Constructor
@@ -28,10 +39,10 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLik : public ModelHawkesLogLik {
    * negative, the number of physical cores will be used
    */
 
-  ModelHawkesSumExpKernLogLik(const ArrayDouble &decay,
-                              const int max_n_threads = 1);
+  TModelHawkesSumExpKernLogLik(const ArrayDouble &decay,
+                               const int max_n_threads = 1);
 
-  ~ModelHawkesSumExpKernLogLik() {}
+  ~TModelHawkesSumExpKernLogLik() {}
 
   //! @brief Returns decay that was set
   SArrayDoublePtr get_decays() const {
@@ -51,40 +62,49 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLik : public ModelHawkesLogLik {
 
   ulong get_n_decays() const { return decays.size(); }
 
-  std::unique_ptr<ModelHawkesLogLikSingle> build_model(
+  std::unique_ptr<TModelHawkesLogLikSingle<T> > build_model(
       const int n_threads) override {
-    return std::unique_ptr<ModelHawkesSumExpKernLogLikSingle>(
-        new ModelHawkesSumExpKernLogLikSingle(decays, n_threads));
+    return std::unique_ptr<TModelHawkesSumExpKernLogLikSingle<T> >(
+        new TModelHawkesSumExpKernLogLikSingle<T>(decays, n_threads));
   }
 
   ulong get_n_coeffs() const override;
 
   template <class Archive>
   void serialize(Archive &ar) {
-    ar(cereal::make_nvp("ModelHawkesLogLik",
-                        cereal::base_class<ModelHawkesLogLik>(this)));
+    ar(cereal::make_nvp(
+        "ModelHawkesLogLik",
+        typename cereal::base_class<TModelHawkesLogLik<T> >(this)));
 
     ar(CEREAL_NVP(decays));
   }
 
-  BoolStrReport compare(const ModelHawkesSumExpKernLogLik &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesSumExpKernLogLik<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
-    auto are_equal = ModelHawkesLogLik::compare(that, ss) &&
+    auto are_equal = TModelHawkesLogLik<T>::compare(that, ss) &&
                      TICK_CMP_REPORT(ss, decays);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesSumExpKernLogLik &that) {
+  BoolStrReport compare(const TModelHawkesSumExpKernLogLik<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesSumExpKernLogLik &that) {
-    return ModelHawkesSumExpKernLogLik::compare(that);
+  BoolStrReport operator==(const TModelHawkesSumExpKernLogLik<T> &that) {
+    return TModelHawkesSumExpKernLogLik<T>::compare(that);
   }
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLik,
+using ModelHawkesSumExpKernLogLik = TModelHawkesSumExpKernLogLik<double>;
+
+using ModelHawkesSumExpKernLogLikDouble = TModelHawkesSumExpKernLogLik<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLikDouble,
                                    cereal::specialization::member_serialize)
+CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLikDouble)
 
-CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLik)
+using ModelHawkesSumExpKernLogLikFloat = TModelHawkesSumExpKernLogLik<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLikFloat,
+                                   cereal::specialization::member_serialize)
+CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLikFloat)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_LIST_OF_REALIZATIONS_MODEL_HAWKES_SUMEXPKERN_LOGLIK_H_
@@ -6,6 +6,7 @@
 
 #include "tick/base/base.h"
 #include "tick/hawkes/model/base/model_hawkes_single.h"
+#include "tick/hawkes/model/model_hawkes_utils.h"
 
 class ModelHawkesExpKernLeastSq;
 
@@ -13,15 +14,39 @@ class ModelHawkesExpKernLeastSq;
  * \brief Class for computing L2 Contrast function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e.,
  * alpha*beta*e^{-beta t}, with fixed beta)
+ * \note If an adjacency mask is given, only the pairs (i, j) it allows are
+ * computed and stored, the other entries of the adjacency matrix are
+ * considered to be zero
  */
 class DLL_PUBLIC ModelHawkesExpKernLeastSqSingle : public ModelHawkesSingle {
   //! @brief Some arrays used for intermediate computings. They are initialized
   //! in init()
-  ArrayDouble2d E, Dg, Dg2, C;
+  ArrayDouble2d Dg, Dg2, C;
+
+  //! @brief Flat storage of the E_i blocks. E_i is a dense (s_i, s_i) array
+  //! starting at E_indptr[i], where s_i is the number of nodes allowed to
+  //! excite node i
+  ArrayDouble E;
 
   //! @brief The 2d array of decays (remember that the decays are fixed!)
   SArrayDouble2dPtr decays;
 
+  //! @brief Node j might excite node i only if adjacency_mask(i, j) != 0.
+  //! If nullptr, all pairs of nodes are considered
+  SArrayULong2dPtr adjacency_mask;
+
+  //! @brief Nodes allowed to excite node i are
+  //! source_indices[source_indptr[i]:source_indptr[i + 1]]
+  ArrayULong source_indptr, source_indices;
+
+  //! @brief Start of each E_i block in E
+  ArrayULong E_indptr;
+
+  //! @brief Nodes that node j is allowed to excite are
+  //! target_indices[target_indptr[j]:target_indptr[j + 1]]. Only used to
+  //! compute weights
+  ArrayULong target_indptr, target_indices;
+
  public:
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of
@@ -94,6 +119,17 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSqSingle : public ModelHawkesSingle {
     weights_computed = false;
   }
 
+  /**
+   * @brief Restrict the adjacency matrix to a sparsity pattern
+   * \param adjacency_mask : (n_nodes, n_nodes) array, node j might excite
+   * node i only if adjacency_mask(i, j) != 0. If nullptr, no restriction is
+   * applied
+   */
+  void set_adjacency_mask(const SArrayULong2dPtr adjacency_mask) {
+    this->adjacency_mask = adjacency_mask;
+    weights_computed = false;
+  }
+
   ulong get_n_coeffs() const override;
 
  private:
@@ -126,6 +162,10 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSqSingle : public ModelHawkesSingle {
     ar(CEREAL_NVP(Dg2));
     ar(CEREAL_NVP(C));
     ar(CEREAL_NVP(decays));
+    ar(CEREAL_NVP(adjacency_mask));
+    ar(CEREAL_NVP(source_indptr));
+    ar(CEREAL_NVP(source_indices));
+    ar(CEREAL_NVP(E_indptr));
   }
 
   BoolStrReport compare(const ModelHawkesExpKernLeastSqSingle &that, std::stringstream &ss) {
@@ -135,7 +175,11 @@ class DLL_PUBLIC ModelHawkesExpKernLeastSqSingle : public ModelHawkesSingle {
                      TICK_CMP_REPORT(ss, Dg) &&
                      TICK_CMP_REPORT(ss, Dg2) &&
                      TICK_CMP_REPORT(ss, C) &&
-                     TICK_CMP_REPORT_PTR(ss, decays);
+                     TICK_CMP_REPORT_PTR(ss, decays) &&
+                     TICK_CMP_REPORT_PTR(ss, adjacency_mask) &&
+                     TICK_CMP_REPORT(ss, source_indptr) &&
+                     TICK_CMP_REPORT(ss, source_indices) &&
+                     TICK_CMP_REPORT(ss, E_indptr);
     return BoolStrReport(are_equal, ss.str());
   }
   BoolStrReport compare(const ModelHawkesExpKernLeastSqSingle &that) {
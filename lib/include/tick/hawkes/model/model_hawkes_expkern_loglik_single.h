@@ -11,16 +11,32 @@
 
 #include "tick/hawkes/model/base/model_hawkes_loglik_single.h"
 
-class ModelHawkesExpKernLogLik;
+template <class T>
+class TModelHawkesExpKernLogLik;
 
 /**
- * \class ModelHawkesExpKernLogLikSingle
+ * \class TModelHawkesExpKernLogLikSingle
  * \brief Class for computing loglikelihood function and gradient for Hawkes
  * processes with exponential kernels with fixed exponent (i.e., \f$ \alpha
  * \beta e^{-\beta t} \f$, with fixed decay)
+ * \tparam T : type in which weights are stored
  */
-class DLL_PUBLIC ModelHawkesExpKernLogLikSingle
-    : public ModelHawkesLogLikSingle {
+template <class T>
+class DLL_PUBLIC TModelHawkesExpKernLogLikSingle
+    : public TModelHawkesLogLikSingle<T> {
+ protected:
+  using TModelHawkesLogLikSingle<T>::g;
+  using TModelHawkesLogLikSingle<T>::G;
+  using TModelHawkesLogLikSingle<T>::sum_G;
+  using TModelHawkesLogLikSingle<T>::n_nodes;
+  using TModelHawkesLogLikSingle<T>::n_jumps_per_node;
+  using TModelHawkesLogLikSingle<T>::timestamps;
+  using TModelHawkesLogLikSingle<T>::end_time;
+  using TModelHawkesLogLikSingle<T>::weights_computed;
+
+ public:
+  using TModelHawkesLogLikSingle<T>::get_class_name;
+
  private:
   //! @brief Value of decay for this model
   double decay;
@@ -29,7 +45,7 @@ class DLL_PUBLIC ModelHawkesExpKernLogLikSingle
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of
   //! ModelHawkesExpKernLogLikSingle
-  ModelHawkesExpKernLogLikSingle() : ModelHawkesLogLikSingle() {}
+  TModelHawkesExpKernLogLikSingle() : TModelHawkesLogLikSingle<T>() {}
 
   /**
    * @brief Constructor
@@ -37,16 +53,15 @@ class DLL_PUBLIC ModelHawkesExpKernLogLikSingle
    * \param n_threads : number of threads that will be used for parallel
    * computations
    */
-  explicit ModelHawkesExpKernLogLikSingle(const double decay,
-                                          const int max_n_threads = 1);
+  explicit TModelHawkesExpKernLogLikSingle(const double decay,
+                                           const int max_n_threads = 1);
 
  private:
   void allocate_weights() override;
-  /**
-   * @brief Precomputations of intermediate values for component i
-   * \param i : selected component
-   */
-  void compute_weights_dim_i(const ulong i) override;
+
+  ulong get_n_kernel_decays() const override { return 1; }
+
+  double get_kernel_decay(const ulong u) const override { return decay; }
 
   /**
    * @brief Return the start of alpha i coefficients in a coeffs vector
@@ -80,33 +95,46 @@ class DLL_PUBLIC ModelHawkesExpKernLogLikSingle
     weights_computed = false;
   }
 
-  friend ModelHawkesExpKernLogLik;
+  template <class>
+  friend class TModelHawkesExpKernLogLik;
 
   template <class Archive>
   void serialize(Archive &ar) {
-    ar(cereal::make_nvp("ModelHawkesLogLikSingle",
-                        cereal::base_class<ModelHawkesLogLikSingle>(this)));
+    ar(cereal::make_nvp(
+        "ModelHawkesLogLikSingle",
+        typename cereal::base_class<TModelHawkesLogLikSingle<T> >(this)));
 
     ar(CEREAL_NVP(decay));
   }
 
-  BoolStrReport compare(const ModelHawkesExpKernLogLikSingle &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesExpKernLogLikSingle<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
-    auto are_equal = ModelHawkesLogLikSingle::compare(that, ss) &&
+    auto are_equal = TModelHawkesLogLikSingle<T>::compare(that, ss) &&
                      TICK_CMP_REPORT(ss, decay);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesExpKernLogLikSingle &that) {
+  BoolStrReport compare(const TModelHawkesExpKernLogLikSingle<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesExpKernLogLikSingle &that) {
-    return ModelHawkesExpKernLogLikSingle::compare(that);
+  BoolStrReport operator==(const TModelHawkesExpKernLogLikSingle<T> &that) {
+    return TModelHawkesExpKernLogLikSingle<T>::compare(that);
   }
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLikSingle,
+using ModelHawkesExpKernLogLikSingle = TModelHawkesExpKernLogLikSingle<double>;
+
+using ModelHawkesExpKernLogLikSingleDouble =
+    TModelHawkesExpKernLogLikSingle<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLikSingleDouble,
+                                   cereal::specialization::member_serialize)
+CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLikSingleDouble)
+
+using ModelHawkesExpKernLogLikSingleFloat =
+    TModelHawkesExpKernLogLikSingle<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesExpKernLogLikSingleFloat,
                                    cereal::specialization::member_serialize)
-CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLikSingle);
+CEREAL_REGISTER_TYPE(ModelHawkesExpKernLogLikSingleFloat)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_MODEL_HAWKES_EXPKERN_LOGLIK_SINGLE_H_
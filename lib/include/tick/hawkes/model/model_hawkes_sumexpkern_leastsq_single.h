@@ -11,16 +11,25 @@
  * \brief Class for computing L2 Contrast function and gradient for Hawkes
  * processes with sum exponential kernels with fixed exponent (i.e., \sum_u
  * alpha_u*beta_u*e^{-beta_u t}, with fixed beta)
+ * \note Stacking the alpha_i as rows of a (n_nodes, n_nodes * n_decays)
+ * matrix A, the quadratic part of the loss is 1/2 tr(A Q A^T) and the
+ * gradient with respect to A is A Q + 2 mu Dg^T - 2 C. Hence loss and
+ * gradient of all nodes are obtained with one matrix-matrix product.
  */
 class DLL_PUBLIC ModelHawkesSumExpKernLeastSqSingle : public ModelHawkesSingle {
-  //! @brief Some arrays used for intermediate computings.
-  ArrayDouble2dList1D E, Dgg, C;
+  //! @brief Symmetric (n_nodes * n_decays, n_nodes * n_decays) array such that
+  //! 1/2 alpha_i^T Q alpha_i is the quadratic part of loss_i. It gathers the
+  //! E and Dgg weights and does not depend on i.
+  ArrayDouble2d Q;
+
+  //! @brief (n_nodes, n_nodes * n_decays) array, row i is linear in alpha_i
+  ArrayDouble2d C;
 
   //! @brief some arrays used for intermediate computings in varying baseline
-  //! case
+  //! case. Dg is a (n_nodes * n_decays, n_baselines) array
   ArrayDouble L;
   ArrayDoubleList1D K;
-  ArrayDouble2dList1D Dg;
+  ArrayDouble2d Dg;
 
   ulong n_baselines;
   double period_length;
@@ -108,9 +117,39 @@ class DLL_PUBLIC ModelHawkesSumExpKernLeastSqSingle : public ModelHawkesSingle {
   /**
    * @brief Precomputations of intermediate values for component i
    * \param i : selected component
+   * \note Only rows (i, u) of Q are filled, they must be symmetrized with
+   * symmetrize_weights once all components have been computed
    */
   void compute_weights_i(const ulong i);
 
+  //! @brief Replaces Q by Q + Q^T
+  void symmetrize_weights();
+
+  /**
+   * @brief Compute rows of A Q where A stacks the alpha_i of all nodes
+   * \param slice : index of the slice of rows to compute
+   * \param n_slices : number of slices in which rows are dispatched
+   * \param coeffs : Point in which A Q is computed
+   * \param out : (n_nodes * n_nodes * n_decays) array that stores A Q
+   */
+  void compute_alpha_Q(const ulong slice, const ulong n_slices,
+                       const ArrayDouble &coeffs, ArrayDouble &out);
+
+  //! @brief Contribution of component i to the loss given A Q
+  double loss_i_from_alpha_Q(const ulong i, const ArrayDouble &coeffs,
+                             const ArrayDouble &alpha_Q);
+
+  //! @brief Contribution of component i to the loss given Q alpha_i
+  double loss_i_from_Q_alpha_i(const ulong i, const ArrayDouble &coeffs,
+                               const ArrayDouble &Q_alpha_i);
+
+  /**
+   * @brief Contribution of component i to the gradient given Q alpha_i
+   * already stored in the alpha_i part of out
+   */
+  void grad_i_from_Q_alpha(const ulong i, const ArrayDouble &coeffs,
+                           ArrayDouble &out);
+
   ulong get_baseline_interval(const double t);
   double get_baseline_interval_length(const ulong interval_p);
 
@@ -122,8 +161,7 @@ class DLL_PUBLIC ModelHawkesSumExpKernLeastSqSingle : public ModelHawkesSingle {
     ar(cereal::make_nvp("ModelHawkesSingle",
                         cereal::base_class<ModelHawkesSingle>(this)));
 
-    ar(CEREAL_NVP(E));
-    ar(CEREAL_NVP(Dgg));
+    ar(CEREAL_NVP(Q));
     ar(CEREAL_NVP(C));
     ar(CEREAL_NVP(L));
     ar(CEREAL_NVP(K));
@@ -137,10 +175,9 @@ class DLL_PUBLIC ModelHawkesSumExpKernLeastSqSingle : public ModelHawkesSingle {
   BoolStrReport compare(const ModelHawkesSumExpKernLeastSqSingle &that, std::stringstream &ss) {
     ss << get_class_name() << std::endl;
     auto are_equal = ModelHawkesSingle::compare(that, ss) &&
-                     TICK_CMP_REPORT_VECTOR(ss, E) &&
-                     TICK_CMP_REPORT_VECTOR(ss, Dgg) &&
-                     TICK_CMP_REPORT_VECTOR(ss, C) &&
-                     TICK_CMP_REPORT_VECTOR(ss, Dg) &&
+                     TICK_CMP_REPORT(ss, Q) &&
+                     TICK_CMP_REPORT(ss, C) &&
+                     TICK_CMP_REPORT(ss, Dg) &&
                      TICK_CMP_REPORT(ss, L) &&
                      TICK_CMP_REPORT_VECTOR(ss, K) &&
                      TICK_CMP_REPORT(ss, n_baselines) &&
@@ -8,16 +8,32 @@
 
 #include "tick/hawkes/model/base/model_hawkes_loglik_single.h"
 
-class ModelHawkesSumExpKernLogLik;
+template <class T>
+class TModelHawkesSumExpKernLogLik;
 
 /**
- * \class ModelHawkesSumExpKernLogLikSingle
+ * \class TModelHawkesSumExpKernLogLikSingle
  * \brief Class for computing loglikelihood function and gradient for Hawkes
  * processes with sum exponential kernels with fixed exponent (i.e., \f$ \sum_u
  * \alpha_u \beta_u e^{-\beta_u t} \f$, with fixed decays)
+ * \tparam T : type in which weights are stored
  */
-class DLL_PUBLIC ModelHawkesSumExpKernLogLikSingle
-    : public ModelHawkesLogLikSingle {
+template <class T>
+class DLL_PUBLIC TModelHawkesSumExpKernLogLikSingle
+    : public TModelHawkesLogLikSingle<T> {
+ protected:
+  using TModelHawkesLogLikSingle<T>::g;
+  using TModelHawkesLogLikSingle<T>::G;
+  using TModelHawkesLogLikSingle<T>::sum_G;
+  using TModelHawkesLogLikSingle<T>::n_nodes;
+  using TModelHawkesLogLikSingle<T>::n_jumps_per_node;
+  using TModelHawkesLogLikSingle<T>::timestamps;
+  using TModelHawkesLogLikSingle<T>::end_time;
+  using TModelHawkesLogLikSingle<T>::weights_computed;
+
+ public:
+  using TModelHawkesLogLikSingle<T>::get_class_name;
+
  private:
   //! @brief Value of decays array for this model
   ArrayDouble decays;
@@ -26,7 +42,7 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLikSingle
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of
   //! ModelHawkesSumExpKernLogLikSingle
-  ModelHawkesSumExpKernLogLikSingle();
+  TModelHawkesSumExpKernLogLikSingle();
 
   /**
    * @brief Constructor
@@ -34,18 +50,17 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLikSingle
    * \param n_threads : number of threads that will be used for parallel
    * computations
    */
-  explicit ModelHawkesSumExpKernLogLikSingle(const ArrayDouble &decays,
-                                             const int max_n_threads = 1);
+  explicit TModelHawkesSumExpKernLogLikSingle(const ArrayDouble &decays,
+                                              const int max_n_threads = 1);
 
  protected:
   void allocate_weights() override;
 
-  /**
-   * @brief Precomputations of intermediate values for component i
-   * \param i : selected component
-   */
-  void compute_weights_dim_i(const ulong i) override;
+  ulong get_n_kernel_decays() const override { return get_n_decays(); }
 
+  double get_kernel_decay(const ulong u) const override { return decays[u]; }
+
+ public:
   /**
    * @brief Return the start of alpha i coefficients in a coeffs vector
    * @param i : selected dimension
@@ -62,7 +77,6 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLikSingle
     return n_nodes + (i + 1) * n_nodes * get_n_decays();
   }
 
- public:
   ulong get_n_coeffs() const override;
 
   //! @brief Returns decay that was set
@@ -83,33 +97,47 @@ class DLL_PUBLIC ModelHawkesSumExpKernLogLikSingle
 
   ulong get_n_decays() const { return decays.size(); }
 
-  friend ModelHawkesSumExpKernLogLik;
+  template <class>
+  friend class TModelHawkesSumExpKernLogLik;
 
   template <class Archive>
   void serialize(Archive &ar) {
-    ar(cereal::make_nvp("ModelHawkesLogLikSingle",
-                        cereal::base_class<ModelHawkesLogLikSingle>(this)));
+    ar(cereal::make_nvp(
+        "ModelHawkesLogLikSingle",
+        typename cereal::base_class<TModelHawkesLogLikSingle<T> >(this)));
 
     ar(CEREAL_NVP(decays));
   }
 
-  BoolStrReport compare(const ModelHawkesSumExpKernLogLikSingle &that, std::stringstream &ss) {
+  BoolStrReport compare(const TModelHawkesSumExpKernLogLikSingle<T> &that,
+                        std::stringstream &ss) {
     ss << get_class_name() << std::endl;
-    auto are_equal = ModelHawkesLogLikSingle::compare(that, ss) &&
+    auto are_equal = TModelHawkesLogLikSingle<T>::compare(that, ss) &&
                      TICK_CMP_REPORT(ss, decays);
     return BoolStrReport(are_equal, ss.str());
   }
-  BoolStrReport compare(const ModelHawkesSumExpKernLogLikSingle &that) {
+  BoolStrReport compare(const TModelHawkesSumExpKernLogLikSingle<T> &that) {
     std::stringstream ss;
     return compare(that, ss);
   }
-  BoolStrReport operator==(const ModelHawkesSumExpKernLogLikSingle &that) {
-    return ModelHawkesSumExpKernLogLikSingle::compare(that);
+  BoolStrReport operator==(const TModelHawkesSumExpKernLogLikSingle<T> &that) {
+    return TModelHawkesSumExpKernLogLikSingle<T>::compare(that);
   }
 };
 
-CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLikSingle,
+using ModelHawkesSumExpKernLogLikSingle =
+    TModelHawkesSumExpKernLogLikSingle<double>;
+
+using ModelHawkesSumExpKernLogLikSingleDouble =
+    TModelHawkesSumExpKernLogLikSingle<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLikSingleDouble,
+                                   cereal::specialization::member_serialize)
+CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLikSingleDouble)
+
+using ModelHawkesSumExpKernLogLikSingleFloat =
+    TModelHawkesSumExpKernLogLikSingle<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(ModelHawkesSumExpKernLogLikSingleFloat,
                                    cereal::specialization::member_serialize)
-CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLikSingle)
+CEREAL_REGISTER_TYPE(ModelHawkesSumExpKernLogLikSingleFloat)
 
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_MODEL_HAWKES_SUMEXPKERN_LOGLIK_SINGLE_H_
@@ -20,4 +20,30 @@ TimestampListDescriptor describe_timestamps_list(
     const SArrayDoublePtrList2D &timestamps_list,
     const VArrayDoublePtr end_times);
 
+/** \struct AdjacencySupport
+ * \brief Compressed sparsity pattern of a Hawkes adjacency matrix
+ * Nodes allowed to excite node i are
+ * source_indices[source_indptr[i]:source_indptr[i + 1]] (sorted) and nodes
+ * node j is allowed to excite are
+ * target_indices[target_indptr[j]:target_indptr[j + 1]] (sorted).
+ * block_indptr[i] gives where a dense (s_i, s_i) block of node i starts in a
+ * flat array, s_i being the number of sources of node i
+ */
+struct AdjacencySupport {
+  ArrayULong source_indptr;
+  ArrayULong source_indices;
+  ArrayULong target_indptr;
+  ArrayULong target_indices;
+  ArrayULong block_indptr;
+};
+
+/**
+ * @brief Describe which entries of the adjacency matrix might be non zero
+ * \param n_nodes : number of nodes of the Hawkes process
+ * \param adjacency_mask : (n_nodes, n_nodes) array, node j might excite node
+ * i only if adjacency_mask(i, j) != 0. If nullptr all entries are allowed.
+ */
+AdjacencySupport describe_adjacency_support(
+    const ulong n_nodes, const SArrayULong2dPtr adjacency_mask);
+
 #endif  // LIB_INCLUDE_TICK_HAWKES_MODEL_MODEL_HAWKES_UTILS_H_
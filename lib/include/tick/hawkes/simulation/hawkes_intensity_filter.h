@@ -0,0 +1,149 @@
+
+#ifndef LIB_INCLUDE_TICK_HAWKES_SIMULATION_HAWKES_INTENSITY_FILTER_H_
+#define LIB_INCLUDE_TICK_HAWKES_SIMULATION_HAWKES_INTENSITY_FILTER_H_
+
+// License: BSD 3 clause
+
+#include <vector>
+
+#include "tick/base/base.h"
+
+/**
+ * @class HawkesIntensityFilter
+ * @brief Online computation of the intensity of a fitted Hawkes process with
+ * sum of exponential kernels
+ *
+ * \f[
+ *     \lambda_i(t) = \mu_i + \sum_{j=1}^{D} \sum_{t_k^j < t} \sum_{u=1}^{U}
+ *     \alpha^u_{ij} \beta_u \exp (- \beta_u (t - t_k^j))
+ * \f]
+ * Events are given one by one, in chronological order, and only the current
+ * excitation of each node for each decay is kept. It is stored relatively to
+ * a reference time, so that an event only updates the nodes it excites. When
+ * the reference time moves, nodes are only rescaled the next time they are
+ * excited.
+ */
+class DLL_PUBLIC HawkesIntensityFilter {
+  //! Number of nodes of the process, also noted \f$ D \f$
+  ulong n_nodes;
+
+  //! Number of decays of the kernels, also noted \f$ U \f$
+  ulong n_decays;
+
+  //! Baseline of each node, also noted \f$ \mu \f$
+  ArrayDouble baseline;
+
+  //! Decays of the kernels, also noted \f$ \beta \f$
+  ArrayDouble decays;
+
+  //! Largest decay, used to decide when the reference time must be moved
+  double max_decay;
+
+  //! Excited nodes of each source node j, the entries of j are stored between
+  //! out_indptr[j] and out_indptr[j + 1], out_indices holding i * U + u and
+  //! out_weights \f$ \alpha^u_{ij} \beta_u \f$
+  std::vector<ulong> out_indptr, out_indices;
+  std::vector<double> out_weights;
+
+  //! Excitation of node i for decay u at time t is
+  //! excitations[i * U + u] * exp(- decays[u] * (t - node_reference_times[i]))
+  ArrayDouble excitations;
+
+  //! Time from which excitations of the nodes excited by new events are
+  //! measured
+  double reference_time;
+
+  //! Time from which excitations of each node are measured, older than
+  //! reference_time for nodes not excited since it moved
+  std::vector<double> node_reference_times;
+
+  //! Time of the last event given
+  double last_time;
+
+  //! Buffer storing exp(decays[u] * (t - reference_time)) for the current
+  //! event
+  ArrayDouble growths;
+
+  //! Buffer storing, for each decay, the factor shared by the nodes measured
+  //! from reference_time in intensity and compensator. These const methods
+  //! thus must not be called concurrently on the same filter
+  mutable ArrayDouble shared_factors;
+
+  //! Rescales the excitations of node i so that they are measured from
+  //! reference_time
+  void move_node_reference_time(const ulong i);
+
+  void check_node(const ulong node) const;
+
+  void check_time(const double t) const;
+
+  //! on_event, without checking its arguments
+  void add_event(const ulong node, const double t);
+
+  //! get_intensity, without checking its arguments
+  double compute_intensity(const ulong node, const double t) const;
+
+ public:
+  /**
+   * Constructor
+   * @param baseline: Array of shape (n_nodes, ) of the baselines
+   * @param adjacency: Array of shape (n_nodes, n_nodes * n_decays) storing
+   * \f$ \alpha^u_{ij} \f$ at position (i, j * n_decays + u)
+   * @param decays: Array of the decays shared by all kernels, of size 1 for
+   * exponential kernels
+   */
+  HawkesIntensityFilter(const ArrayDouble &baseline,
+                        const ArrayDouble2d &adjacency,
+                        const ArrayDouble &decays);
+
+  //! @brief Forget all events given so far
+  void reset();
+
+  /**
+   * @brief Add an event, in amortized O(out-degree of node * n_decays)
+   * @param node: node on which the event occurred
+   * @param t: time of the event, not older than the last event given
+   */
+  void on_event(const ulong node, const double t);
+
+  /**
+   * @brief Add a batch of events, sorted by time
+   * @param nodes: nodes on which the events occurred
+   * @param times: times of the events
+   * @param event_intensities: filled with the intensity of the node of each
+   * event, just before it occurred
+   */
+  void on_events(const ArrayULong &nodes, const ArrayDouble &times,
+                 ArrayDouble &event_intensities);
+
+  /**
+   * @brief Intensity of one node at time t, not older than the last event
+   */
+  double get_intensity(const ulong node, const double t) const;
+
+  /**
+   * @brief Intensities of all nodes at time t, not older than the last event
+   * @param intensities: Array of shape (n_nodes, ) in which intensities are
+   * stored
+   */
+  void intensity(const double t, ArrayDouble &intensities) const;
+
+  /**
+   * @brief Integrals of the intensities of all nodes between t0 and t1,
+   * assuming no event occurs in between
+   * @param t0: start time, not older than the last event
+   * @param t1: end time, not older than t0
+   * @param compensators: Array of shape (n_nodes, ) in which compensators are
+   * stored
+   */
+  void compensator(const double t0, const double t1,
+                   ArrayDouble &compensators) const;
+
+  ulong get_n_nodes() const { return n_nodes; }
+
+  ulong get_n_decays() const { return n_decays; }
+
+  double get_last_time() const { return last_time; }
+};
+
+#endif  // LIB_INCLUDE_TICK_HAWKES_SIMULATION_HAWKES_INTENSITY_FILTER_H_
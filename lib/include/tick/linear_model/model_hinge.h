@@ -34,6 +34,9 @@ class DLL_PUBLIC TModelHinge : public virtual TModelGeneralizedLinear<T, K> {
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
   template <class Archive>
   void serialize(Archive &ar) {
     ar(cereal::make_nvp(
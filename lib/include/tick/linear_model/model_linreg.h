@@ -48,6 +48,18 @@ class DLL_PUBLIC TModelLinReg : public virtual TModelGeneralizedLinear<T, K>,
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T conjugate_loss_i(const ulong i, const T dual_i) const override;
+
+  T get_loss_smoothness() const override { return 1; }
+
+  T loss_i_from_inner_prod(const ulong i, const T inner_prod) const override;
+
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
+  T hessian_i_factor_from_inner_prod(const ulong i,
+                                     const T inner_prod) const override;
+
   void compute_lip_consts() override;
 
   template <class Archive>
@@ -59,6 +59,14 @@ class DLL_PUBLIC TModelPoisReg : public TModelGeneralizedLinear<T, K> {
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T loss_i_from_inner_prod(const ulong i, const T inner_prod) const override;
+
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
+  T hessian_i_factor_from_inner_prod(const ulong i,
+                                     const T inner_prod) const override;
+
   T sdca_dual_min_i(const ulong i, const T dual_i,
                     const Array<K> &primal_vector,
                     const T previous_delta_dual_i, T l_l2sq) override;
@@ -44,6 +44,9 @@ class DLL_PUBLIC TModelSmoothedHinge
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
   void compute_lip_consts() override;
 
   T get_smoothness() const { return smoothness; }
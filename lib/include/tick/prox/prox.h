@@ -87,6 +87,9 @@ class DLL_PUBLIC TProx {
   //! @brief tells whether prox should be applied to this index or not
   bool is_in_range(ulong i) const;
 
+  //! @brief tells whether prox is restricted to the range [start, end)
+  bool get_has_range() const { return has_range; }
+
   template <class Archive>
   void serialize(Archive& ar) {
     ar(CEREAL_NVP(strength), CEREAL_NVP(has_range), CEREAL_NVP(start),
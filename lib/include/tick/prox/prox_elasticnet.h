@@ -37,6 +37,8 @@ class DLL_PUBLIC TProxElasticNet : public TProxSeparable<T, K> {
 
   virtual void set_ratio(T ratio);
 
+  bool get_shrinkage(T step, T& threshold, T& scaling) const override;
+
   template <class Archive>
   void serialize(Archive& ar) {
     ar(cereal::make_nvp("ProxSeparable",
@@ -59,6 +61,9 @@ class DLL_PUBLIC TProxElasticNet : public TProxSeparable<T, K> {
  private:
   T call_single(T x, T step) const override;
 
+  // Repeat n_times the prox on coordinate i
+  T call_single(T x, T step, ulong n_times) const override;
+
   T value_single(T x) const override;
 };
 
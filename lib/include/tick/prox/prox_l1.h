@@ -26,6 +26,8 @@ class DLL_PUBLIC TProxL1 : public TProxSeparable<T, K> {
   T value_single(T x) const override;
 
  public:
+  bool get_shrinkage(T step, T& threshold, T& scaling) const override;
+
   // This exists soley for cereal/swig
   TProxL1() : TProxL1<T, K>(0, 0) {}
 
@@ -43,6 +43,9 @@ class DLL_PUBLIC TProxL2Sq : public TProxSeparable<T, K> {
     return compare(that);
   }
 
+ public:
+  bool get_shrinkage(T step, T& threshold, T& scaling) const override;
+
  protected:
   T value_single(T x) const override;
 
@@ -0,0 +1,81 @@
+#ifndef LIB_INCLUDE_TICK_PROX_PROX_SCREENED_H_
+#define LIB_INCLUDE_TICK_PROX_PROX_SCREENED_H_
+
+// License: BSD 3 clause
+
+#include <vector>
+
+#include "prox_separable.h"
+
+/**
+ * @class TProxScreened
+ * @brief Applies a separable prox on the coordinates that are kept, and sets
+ * the discarded ones to zero. This is used by TPathSolver to restrict the
+ * fit to the features surviving screening rules.
+ * @note The strength and positivity are the ones of the wrapped prox, which
+ * can be modified while being wrapped. Its range is the one of the wrapped
+ * prox at construction
+ */
+template <class T>
+class DLL_PUBLIC TProxScreened : public TProxSeparable<T, T> {
+ public:
+  using TProxSeparable<T, T>::get_class_name;
+  using TProxSeparable<T, T>::call;
+
+ private:
+  std::shared_ptr<TProxSeparable<T, T> > prox;
+
+  // Indexed by coordinates, coordinates beyond its size are kept
+  std::vector<bool> discarded;
+
+ public:
+  explicit TProxScreened(std::shared_ptr<TProxSeparable<T, T> > prox);
+
+  void call(const Array<T> &coeffs, T step, Array<T> &out, ulong start,
+            ulong end) override;
+
+  void call(const Array<T> &coeffs, const Array<T> &step, Array<T> &out,
+            ulong start, ulong end) override;
+
+  void call_single(ulong i, const Array<T> &coeffs, T step,
+                   Array<T> &out) const override;
+
+  void call_single(ulong i, const Array<T> &coeffs, T step, Array<T> &out,
+                   ulong n_times) const override;
+
+  T call_single_with_index(T x, T step, ulong i) const override;
+
+  T value(const Array<T> &coeffs) override;
+
+  T value(const Array<T> &coeffs, ulong start, ulong end) override;
+
+  T get_strength() const override { return prox->get_strength(); }
+
+  bool get_positive() const override { return prox->get_positive(); }
+
+  //! @brief The shrinkage of the wrapped prox, that applies to the kept
+  //! coordinates only
+  bool get_shrinkage(T step, T &threshold, T &scaling) const override;
+
+  bool is_discarded(const ulong i) const override {
+    return i < discarded.size() && discarded[i];
+  }
+
+  const std::vector<bool> &get_discarded() const { return discarded; }
+
+  //! @brief Discards coordinate i, which is set to zero by the prox
+  void discard(ulong i);
+
+  //! @brief Keeps coordinate i, on which the wrapped prox is applied
+  void keep(ulong i);
+
+  //! @brief Keeps all coordinates
+  void keep_all();
+
+  std::shared_ptr<TProxSeparable<T, T> > get_prox() const { return prox; }
+};
+
+using ProxScreenedDouble = TProxScreened<double>;
+using ProxScreenedFloat = TProxScreened<float>;
+
+#endif  // LIB_INCLUDE_TICK_PROX_PROX_SCREENED_H_
@@ -66,6 +66,21 @@ class DLL_PUBLIC TProxSeparable : public TProx<T, K> {
   //! @note this is useful for prox that don't apply the exact same operation to all indexes
   virtual T call_single_with_index(T x, T step, ulong i) const;
 
+  /**
+   * @brief Writes the prox with a given step, on any coordinate of its range,
+   * as a soft-thresholding followed by a rescaling
+   * \f$ \text{sign}(x) \max(|x| - \text{threshold}, 0) / \text{scaling} \f$,
+   * negative values being set to 0 if positive is true
+   * @return false if the prox cannot be written this way
+   * @note Such proxs can be applied lazily: several steps of different step
+   * sizes then compose into a single one
+   */
+  virtual bool get_shrinkage(T step, T &threshold, T &scaling) const;
+
+  //! @brief tells whether the prox sets coordinate i to zero whatever its
+  //! value, lazy updates then zero it instead of applying get_shrinkage
+  virtual bool is_discarded(ulong i) const { return false; }
+
  private:
   //! @brief apply prox on a single value several times
   virtual T call_single(T x, T step, ulong n_times) const;
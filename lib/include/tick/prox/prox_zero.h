@@ -27,6 +27,8 @@ class DLL_PUBLIC TProxZero : public TProxSeparable<T, K> {
 
   T value(const Array<K>& coeffs, ulong start, ulong end) override;
 
+  bool get_shrinkage(T step, T& threshold, T& scaling) const override;
+
   template <class Archive>
   void serialize(Archive& ar) {
     ar(cereal::make_nvp("ProxSeparable",
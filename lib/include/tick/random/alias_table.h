@@ -0,0 +1,43 @@
+#ifndef LIB_INCLUDE_TICK_RANDOM_ALIAS_TABLE_H_
+#define LIB_INCLUDE_TICK_RANDOM_ALIAS_TABLE_H_
+
+// License: BSD 3 clause
+
+#include "tick/array/array.h"
+#include "tick/random/rand.h"
+
+/**
+ * @class AliasTable
+ * @brief Walker's alias table of a fixed discrete distribution. It is built
+ * in O(n) and then gives realizations in O(1), with a single uniform draw.
+ */
+class DLL_PUBLIC AliasTable {
+ private:
+  ArrayDouble probabilities;
+
+  //! Probability to keep the drawn bucket rather than its alias
+  ArrayDouble acceptance;
+  ArrayULong aliases;
+
+ public:
+  AliasTable() {}
+
+  /**
+   * @brief Builds the table of the distribution proportional to weights
+   * \param weights : non-negative weights, with a positive sum
+   */
+  explicit AliasTable(const ArrayDouble &weights);
+
+  /**
+   * @brief Returns a realization of the distribution
+   * \param rand : generator used for the uniform draw
+   */
+  ulong sample(Rand &rand) const;
+
+  //! @brief Probability of the i-th event
+  double get_probability(ulong i) const { return probabilities[i]; }
+
+  ulong size() const { return probabilities.size(); }
+};
+
+#endif  // LIB_INCLUDE_TICK_RANDOM_ALIAS_TABLE_H_
@@ -48,6 +48,9 @@ class DLL_PUBLIC TModelEpsilonInsensitive
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
   virtual T get_threshold(void) const { return threshold; }
 
   virtual void set_threshold(const T threshold) {
@@ -60,6 +60,9 @@ class DLL_PUBLIC TModelGeneralizedLinearWithIntercepts
 
   T get_inner_prod(const ulong i, const Array<K> &coeffs) const override;
 
+  void get_inner_prods(const ArrayULong &indices, const Array<K> &coeffs,
+                       Array<T> &out) const override;
+
   ulong get_n_coeffs() const override {
     return n_features + n_samples + static_cast<int>(fit_intercept);
   }
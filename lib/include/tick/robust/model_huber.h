@@ -50,6 +50,9 @@ class DLL_PUBLIC TModelHuber : public virtual TModelGeneralizedLinear<T, K>,
 
   T grad_i_factor(const ulong i, const Array<K> &coeffs) override;
 
+  T grad_i_factor_from_inner_prod(const ulong i,
+                                  const T inner_prod) const override;
+
   void compute_lip_consts() override;
 
   virtual T get_threshold(void) const { return threshold; }
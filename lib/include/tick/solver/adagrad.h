@@ -4,6 +4,7 @@
 // License: BSD 3 clause
 
 #include "sto_solver.h"
+#include "tick/prox/prox_separable.h"
 
 template <class T>
 class DLL_PUBLIC TAdaGrad : public TStoSolver<T> {
@@ -31,6 +32,12 @@ class DLL_PUBLIC TAdaGrad : public TStoSolver<T> {
 
   void solve_one_epoch() override;
 
+  //! @brief Epoch for sparse models. Accumulated gradients, steps and
+  //! iterate are only updated on the support of each sample, the prox steps
+  //! missed by the other coordinates being applied once they are needed, so
+  //! that each step costs O(nnz(x_i)) instead of O(n_coeffs)
+  void solve_sparse(TProxSeparable<T> &casted_prox);
+
   void set_starting_iterate(Array<T> &new_iterate) override;
 
   template <class Archive>
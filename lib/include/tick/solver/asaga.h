@@ -57,6 +57,8 @@ class DLL_PUBLIC AtomicSAGA : public TBaseSAGA<T, T> {
 
   void solve(size_t n_epochs = 1) override;
 
+  void set_batch_size(ulong batch_size) override;
+
   template <class Archive>
   void load(Archive &ar) {
     ar(cereal::make_nvp("BaseSAGA", cereal::base_class<TBaseSAGA<T, T>>(this)));
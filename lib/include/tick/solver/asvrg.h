@@ -0,0 +1,167 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_ASVRG_H_
+#define LIB_INCLUDE_TICK_SOLVER_ASVRG_H_
+
+// License: BSD 3 clause
+
+#include "sto_solver.h"
+#include "tick/base_model/model_generalized_linear.h"
+#include "tick/prox/prox_separable.h"
+
+/**
+ * @class AtomicSVRG
+ * @brief Lock-free multi-threaded SVRG. During an epoch, the threads share an
+ * iterate made of atomics, each thread sampling points with its own generator
+ * and writing every coordinate of its steps with compare-exchange. The full
+ * gradient is computed at the beginning of each epoch and only read during
+ * it. The variance reduction point is the last iterate of the previous epoch.
+ * With sparse features, each step updates the support of the features, with
+ * the probabilistic step corrections of TSVRG.
+ * @note The model must be a generalized linear model without individual
+ * intercepts, and the prox must be separable
+ */
+template <class T>
+class DLL_PUBLIC AtomicSVRG : public TStoSolver<T, T> {
+  // Grants cereal access to default constructor/serialize functions
+  friend class cereal::access;
+
+ protected:
+  using TStoSolver<T, T>::t;
+  using TStoSolver<T, T>::model;
+  using TStoSolver<T, T>::iterate;
+  using TStoSolver<T, T>::prox;
+  using TStoSolver<T, T>::epoch_size;
+  using TStoSolver<T, T>::rand_max;
+  using TStoSolver<T, T>::rand_type;
+  using TStoSolver<T, T>::rand;
+
+ public:
+  using TStoSolver<T, T>::get_class_name;
+
+ private:
+  int n_threads = 0;      // SWIG doesn't support uints
+  size_t un_threads = 0;  //   uint == int = Werror
+  T step;
+
+  // Probabilistic correction of the step-sizes of all model weights,
+  // given by the inverse proportion of non-zero entries in each feature column
+  Array<T> steps_correction;
+  bool ready_step_corrections;
+
+  Array<T> full_gradient;
+  Array<T> fixed_w;
+
+  // Derivatives of the losses of all samples at fixed_w
+  Array<T> grad_factors_fixed_w;
+
+  std::shared_ptr<TModelGeneralizedLinear<T>> casted_model;
+
+  // Iterate shared by the threads during an epoch
+  Array<std::atomic<T>> shared_iterate;
+
+  void prepare_solve();
+
+  void compute_step_corrections();
+
+  //! @brief Steps of one thread during an epoch
+  void threaded_solve(size_t thread, int thread_seed,
+                      TProxSeparable<T> &casted_prox);
+
+  //! @brief Inner product of sample i with the shared iterate
+  T get_shared_inner_prod(const BaseArray<T> &x_i) const;
+
+  //! @brief Applies the descent step and the prox to coordinate j of the
+  //! shared iterate, retrying if another thread wrote it in the meantime
+  void update_coordinate(ulong j, T descent_direction, T prox_step,
+                         TProxSeparable<T> &casted_prox);
+
+  //! @brief Draws the next sample of a thread, each thread drawing uniformly
+  //! among all samples or, for random permutations, running through the
+  //! permutations of its own block of samples
+  ulong get_next_i(size_t thread, Rand &thread_rand,
+                   std::vector<ulong> &permutation, ulong &i_perm);
+
+ public:
+  AtomicSVRG() : AtomicSVRG(0, 0, RandType::unif, 0) {}
+
+  AtomicSVRG(ulong epoch_size, T tol, RandType rand_type, T step,
+             int record_every = 1, int seed = -1, int n_threads = 2);
+
+  void solve_one_epoch() override;
+
+  void set_model(std::shared_ptr<TModel<T, T>> model) override;
+
+  void set_batch_size(ulong batch_size) override;
+
+  void set_rand_type(RandType rand_type) override;
+
+  T get_step() const { return step; }
+
+  void set_step(T step) { this->step = step; }
+
+  int get_n_threads() const { return n_threads; }
+
+  void set_n_threads(int n_threads);
+
+  template <class Archive>
+  void load(Archive &ar) {
+    ar(cereal::make_nvp("StoSolver",
+                        cereal::base_class<TStoSolver<T, T>>(this)));
+    ar(CEREAL_NVP(n_threads));
+    ar(CEREAL_NVP(un_threads));
+    ar(CEREAL_NVP(step));
+    ar(CEREAL_NVP(steps_correction));
+    ar(CEREAL_NVP(ready_step_corrections));
+    ar(CEREAL_NVP(full_gradient));
+    ar(CEREAL_NVP(fixed_w));
+    ar(CEREAL_NVP(grad_factors_fixed_w));
+    casted_model =
+        std::dynamic_pointer_cast<TModelGeneralizedLinear<T>>(model);
+  }
+
+  template <class Archive>
+  void save(Archive &ar) const {
+    ar(cereal::make_nvp("StoSolver",
+                        cereal::base_class<TStoSolver<T, T>>(this)));
+    ar(CEREAL_NVP(n_threads));
+    ar(CEREAL_NVP(un_threads));
+    ar(CEREAL_NVP(step));
+    ar(CEREAL_NVP(steps_correction));
+    ar(CEREAL_NVP(ready_step_corrections));
+    ar(CEREAL_NVP(full_gradient));
+    ar(CEREAL_NVP(fixed_w));
+    ar(CEREAL_NVP(grad_factors_fixed_w));
+  }
+
+  BoolStrReport compare(const AtomicSVRG<T> &that) {
+    std::stringstream ss;
+    ss << get_class_name() << std::endl;
+    auto are_equal = TStoSolver<T, T>::compare(that, ss) &&
+                     TICK_CMP_REPORT(ss, n_threads) &&
+                     TICK_CMP_REPORT(ss, un_threads) &&
+                     TICK_CMP_REPORT(ss, step) &&
+                     TICK_CMP_REPORT(ss, steps_correction) &&
+                     TICK_CMP_REPORT(ss, ready_step_corrections) &&
+                     TICK_CMP_REPORT(ss, full_gradient) &&
+                     TICK_CMP_REPORT(ss, fixed_w) &&
+                     TICK_CMP_REPORT(ss, grad_factors_fixed_w);
+    return BoolStrReport(are_equal, ss.str());
+  }
+
+  BoolStrReport operator==(const AtomicSVRG<T> &that) { return compare(that); }
+
+  static std::shared_ptr<AtomicSVRG<T>> AS_NULL() {
+    return std::move(std::shared_ptr<AtomicSVRG<T>>(new AtomicSVRG<T>));
+  }
+};
+
+using ASVRG = AtomicSVRG<double>;
+using AtomicSVRGDouble = AtomicSVRG<double>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(AtomicSVRGDouble,
+                                   cereal::specialization::member_load_save)
+CEREAL_REGISTER_TYPE(AtomicSVRGDouble)
+using AtomicSVRGFloat = AtomicSVRG<float>;
+CEREAL_SPECIALIZE_FOR_ALL_ARCHIVES(AtomicSVRGFloat,
+                                   cereal::specialization::member_load_save)
+CEREAL_REGISTER_TYPE(AtomicSVRGFloat)
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_ASVRG_H_
@@ -0,0 +1,132 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_COORDINATE_DESCENT_H_
+#define LIB_INCLUDE_TICK_SOLVER_COORDINATE_DESCENT_H_
+
+// License: BSD 3 clause
+
+#include <functional>
+#include <vector>
+
+#include "sto_solver.h"
+#include "tick/base_model/model_generalized_linear.h"
+#include "tick/prox/prox_separable.h"
+
+/**
+ * @class TCoordinateDescent
+ * @brief Proximal coordinate descent for generalized linear models penalized
+ * by a separable prox, such as ModelLinReg, ModelLogReg or ModelPoisReg with
+ * a ProxL1 or a ProxElasticNet.
+ * The features are copied in column-major order (CSC), the intercept being a
+ * column of ones, and the inner products of all samples are updated each
+ * time a coordinate changes. Coordinate j is updated by a prox step on the
+ * quadratic approximation of the loss along it
+ * \f$ w_j \leftarrow \text{prox}_{P / h_j}(w_j - g_j / h_j) \f$, where
+ * \f$ g_j \f$ is the partial derivative of the loss and \f$ h_j \f$ its
+ * curvature, given by step_type.
+ * An epoch runs epoch_size coordinate updates (n_coeffs if epoch_size is 0),
+ * in cyclic order, following random permutations or drawn uniformly depending
+ * on rand_type. It then cycles on the active set, the non-zero coordinates,
+ * for at most max_active_passes passes or until the largest change of a
+ * coordinate is below tol times the largest coordinate.
+ * @note ModelPoisReg with an identity link is rejected, its loss being
+ * infinite at the inner products of the starting iterate zero
+ */
+template <class T>
+class DLL_PUBLIC TCoordinateDescent : public TStoSolver<T, T> {
+ protected:
+  using TStoSolver<T, T>::t;
+  using TStoSolver<T, T>::model;
+  using TStoSolver<T, T>::iterate;
+  using TStoSolver<T, T>::prox;
+  using TStoSolver<T, T>::epoch_size;
+  using TStoSolver<T, T>::rand_max;
+  using TStoSolver<T, T>::rand_type;
+  using TStoSolver<T, T>::tol;
+  using TStoSolver<T, T>::get_next_i;
+  using TStoSolver<T, T>::rand_unif;
+
+ public:
+  using TStoSolver<T, T>::get_class_name;
+
+ protected:
+  std::shared_ptr<TModelGeneralizedLinear<T> > casted_model;
+
+  CoordinateDescent_StepType step_type;
+
+  ulong max_active_passes;
+
+  // Features in CSC format, with one more column of ones with an intercept
+  bool columns_ready = false;
+  std::vector<INDICE_TYPE> columns_indptr;
+  std::vector<INDICE_TYPE> columns_indices;
+  std::vector<T> columns_data;
+
+  // Squared norms of the columns divided by n_samples, used by the
+  // quadratic bound
+  Array<T> columns_norm_sq;
+
+  // Inner products of the samples with the iterate, intercept included
+  bool inner_prods_ready = false;
+  Array<T> inner_prods;
+
+  // Iterate before prox, on which the prox is applied coordinate-wise
+  Array<T> tmp_iterate;
+
+  //! @brief Copies the features of the model in CSC format
+  void init_columns();
+
+  //! @brief Adds the column of the intercept and computes the norms
+  void complete_columns();
+
+  void init_inner_prods();
+
+  //! @brief Updates coordinate j and the inner products
+  //! @return The absolute change of the coordinate
+  T update_coordinate(ulong j, TProxSeparable<T> &casted_prox);
+
+  /**
+   * @brief Runs n_updates coordinate updates following rand_type, then
+   * passes on the non-zero coordinates of coeffs, as described above
+   * \param coeffs : coefficients updated by update, whose non-zero entries
+   * form the active set
+   * \param update : updates the given coordinate of coeffs and returns its
+   * absolute change
+   * \return The number of coordinate updates performed
+   */
+  ulong run_coordinate_updates(ulong n_updates, const Array<T> &coeffs,
+                               const std::function<T(ulong)> &update);
+
+ public:
+  TCoordinateDescent(
+      ulong epoch_size = 0, T tol = 0., RandType rand_type = RandType::cyclic,
+      CoordinateDescent_StepType step_type = CoordinateDescent_StepType::Newton,
+      ulong max_active_passes = 10, int record_every = 1, int seed = -1);
+
+  void set_model(std::shared_ptr<TModel<T, T> > model) override;
+
+  //! @brief Sets the features in column-major order, instead of converting
+  //! the ones of the model. They must be the features of the model, which
+  //! must be set first
+  void set_col_major_features(const SparseArray2d<T, ColMajor> &features);
+
+  void solve_one_epoch() override;
+
+  void set_starting_iterate(Array<T> &new_iterate) override;
+
+  CoordinateDescent_StepType get_step_type() const { return step_type; }
+
+  void set_step_type(CoordinateDescent_StepType step_type) {
+    this->step_type = step_type;
+  }
+
+  ulong get_max_active_passes() const { return max_active_passes; }
+
+  void set_max_active_passes(ulong max_active_passes) {
+    this->max_active_passes = max_active_passes;
+  }
+};
+
+using CoordinateDescent = TCoordinateDescent<double>;
+using CoordinateDescentDouble = TCoordinateDescent<double>;
+using CoordinateDescentFloat = TCoordinateDescent<float>;
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_COORDINATE_DESCENT_H_
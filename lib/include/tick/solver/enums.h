@@ -23,4 +23,17 @@ inline std::ostream &operator<<(std::ostream &s, const SVRG_StepType r) {
   return s << static_cast<utype>(r);
 }
 
+// Curvature used by coordinate descent in the quadratic approximation of the
+// loss along a coordinate: the bound given by the smoothness of the losses,
+// or their second derivative at the iterate, safeguarded by backtracking
+enum class CoordinateDescent_StepType : uint16_t {
+  QuadraticBound = 1,
+  Newton = 2,
+};
+inline std::ostream &operator<<(std::ostream &s,
+                                const CoordinateDescent_StepType r) {
+  typedef std::underlying_type<CoordinateDescent_StepType>::type utype;
+  return s << static_cast<utype>(r);
+}
+
 #endif  // LIB_INCLUDE_TICK_SOLVER_ENUMS_H_
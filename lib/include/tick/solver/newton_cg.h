@@ -0,0 +1,69 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_NEWTON_CG_H_
+#define LIB_INCLUDE_TICK_SOLVER_NEWTON_CG_H_
+
+// License: BSD 3 clause
+
+#include "sto_solver.h"
+#include "tick/base_model/model_generalized_linear.h"
+
+/**
+ * @class TNewtonCG
+ * @brief Truncated Newton method for smooth generalized linear models, such
+ * as ModelLinReg, ModelLogReg or ModelPoisReg, with no penalization or a
+ * ProxL2Sq.
+ * Each epoch is a Newton step: the Newton direction is approximated by
+ * conjugate gradient, using the hessian-vector products of the model, until
+ * the residual is below min(0.5, sqrt(|g|)) |g| for a gradient g, or after
+ * max_cg_iter iterations. The step along this direction is halved until the
+ * objective decreases enough (Armijo condition).
+ * @note Each hessian-vector product is a pass over the data, and so is each
+ * evaluation of the objective
+ */
+template <class T>
+class DLL_PUBLIC TNewtonCG : public TStoSolver<T, T> {
+ protected:
+  using TStoSolver<T, T>::t;
+  using TStoSolver<T, T>::model;
+  using TStoSolver<T, T>::iterate;
+  using TStoSolver<T, T>::prox;
+
+ public:
+  using TStoSolver<T, T>::get_class_name;
+
+ private:
+  std::shared_ptr<TModelGeneralizedLinear<T> > casted_model;
+
+  ulong max_cg_iter;
+
+  //! @brief Strength of the L2 penalization, 0 with a ProxZero
+  T get_l2sq_strength() const;
+
+  //! @brief Product of the hessian of the objective at the iterate with
+  //! vector, the model giving the one of the loss
+  void hessian_vector_product(const Array<T> &vector, const T l2sq_strength,
+                              Array<T> &out);
+
+  //! @brief Approximates the Newton direction -H^{-1} grad by conjugate
+  //! gradient
+  void compute_direction(const Array<T> &grad, const T l2sq_strength,
+                         Array<T> &direction);
+
+ public:
+  explicit TNewtonCG(T tol = 0., ulong max_cg_iter = 20, int record_every = 1);
+
+  void set_model(std::shared_ptr<TModel<T, T> > model) override;
+
+  void set_prox(std::shared_ptr<TProx<T, T> > prox) override;
+
+  void solve_one_epoch() override;
+
+  ulong get_max_cg_iter() const { return max_cg_iter; }
+
+  void set_max_cg_iter(ulong max_cg_iter) { this->max_cg_iter = max_cg_iter; }
+};
+
+using NewtonCG = TNewtonCG<double>;
+using NewtonCGDouble = TNewtonCG<double>;
+using NewtonCGFloat = TNewtonCG<float>;
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_NEWTON_CG_H_
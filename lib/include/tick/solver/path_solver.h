@@ -0,0 +1,107 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_PATH_SOLVER_H_
+#define LIB_INCLUDE_TICK_SOLVER_PATH_SOLVER_H_
+
+// License: BSD 3 clause
+
+#include <vector>
+
+#include "sto_solver.h"
+#include "tick/prox/prox_screened.h"
+
+/**
+ * @class TPathSolver
+ * @brief Fits the regularization path of a model penalized by a ProxL1 or a
+ * ProxElasticNet, over a decreasing grid of strengths.
+ * Each fit is warm-started from the previous one, by running n_epochs epochs
+ * of the wrapped solver, whose state is kept along the path.
+ * Before each fit, the sequential strong rule discards the features j such
+ * that \f$ |\nabla_j f(w_{k-1})| < r (2 \lambda_k - \lambda_{k-1}) \f$, where
+ * \f$ r \f$ is the ratio of L1 penalization and \f$ w_{k-1} \f$ the previous
+ * solution. Discarded features are held at zero by the prox, and the fit is
+ * resumed with the features violating the KKT conditions until there is none.
+ * The wrapped solver gets its own prox back at the end of solve, even if a
+ * fit throws.
+ * @note Features outside of the range of the prox are never discarded
+ */
+template <class T>
+class DLL_PUBLIC TPathSolver {
+ private:
+  std::shared_ptr<TStoSolver<T> > solver;
+  std::shared_ptr<TProxSeparable<T> > prox;
+
+  ulong n_epochs;
+  bool screening;
+
+  Array<T> strengths;
+
+  // The path, stored row by row in CSR format, with n_coeffs columns
+  ulong n_coeffs = 0;
+  std::vector<INDICE_TYPE> path_row_indices;
+  std::vector<INDICE_TYPE> path_indices;
+  std::vector<T> path_data;
+
+  // Number of features that were not discarded at the end of each fit, and
+  // number of features added back because of KKT violations
+  ArrayULong n_active_features;
+  ArrayULong n_kkt_violations;
+
+  //! @brief Ratio of the strength given to the L1 penalization
+  T get_l1_ratio() const;
+
+  //! @brief Score of coordinate j in the KKT conditions of the L1
+  //! penalization, which are met at zero if it is below l1_ratio * strength
+  T get_kkt_score(T grad_j) const;
+
+  //! @brief Smallest strength for which the KKT conditions at zero of the
+  //! coordinates in the range of the prox are met, given their gradient
+  T get_strength_max(const Array<T> &grad) const;
+
+  //! @brief Runs n_epochs of the solver and stores its minimizer in coeffs
+  void fit(Array<T> &coeffs);
+
+ public:
+  TPathSolver(std::shared_ptr<TStoSolver<T> > solver,
+              std::shared_ptr<TProxSeparable<T> > prox, ulong n_epochs = 10,
+              bool screening = true);
+
+  //! @brief Smallest strength for which zero is a solution, when no
+  //! coefficient out of the range of the prox is fitted
+  T get_strength_max();
+
+  void solve();
+
+  //! @brief All solutions of the path, one row per strength
+  std::shared_ptr<SSparseArray2d<T> > get_path() const;
+
+  SArrayULongPtr get_n_active_features() const {
+    ArrayULong copy = n_active_features;
+    return copy.as_sarray_ptr();
+  }
+
+  SArrayULongPtr get_n_kkt_violations() const {
+    ArrayULong copy = n_kkt_violations;
+    return copy.as_sarray_ptr();
+  }
+
+  //! @brief Sets the grid of strengths, which must be positive and decreasing
+  void set_strengths(const Array<T> &strengths);
+
+  std::shared_ptr<SArray<T> > get_strengths() const {
+    Array<T> copy = strengths;
+    return copy.as_sarray_ptr();
+  }
+
+  ulong get_n_epochs() const { return n_epochs; }
+
+  void set_n_epochs(ulong n_epochs) { this->n_epochs = n_epochs; }
+
+  bool get_screening() const { return screening; }
+
+  void set_screening(bool screening) { this->screening = screening; }
+};
+
+using PathSolver = TPathSolver<double>;
+using PathSolverDouble = TPathSolver<double>;
+using PathSolverFloat = TPathSolver<float>;
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_PATH_SOLVER_H_
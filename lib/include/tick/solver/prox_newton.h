@@ -0,0 +1,77 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_PROX_NEWTON_H_
+#define LIB_INCLUDE_TICK_SOLVER_PROX_NEWTON_H_
+
+// License: BSD 3 clause
+
+#include "coordinate_descent.h"
+
+/**
+ * @class TProxNewton
+ * @brief Proximal Newton method for generalized linear models penalized by a
+ * separable prox, such as ProxL1 or ProxElasticNet.
+ * Each epoch is a Newton step: the loss is replaced by its second order
+ * approximation at the iterate, given by the derivatives of the losses of
+ * the samples at their inner products, and the penalized approximation is
+ * minimized by coordinate descent, as TCoordinateDescent does, with a full
+ * pass on the coordinates followed by at most max_active_passes passes on
+ * the non-zero ones. The step towards the minimizer of the approximation is
+ * halved until the objective decreases enough (Armijo condition).
+ * @note The step_type of TCoordinateDescent is not used, the coordinates
+ * being updated with the exact curvature of the approximation
+ */
+template <class T>
+class DLL_PUBLIC TProxNewton : public TCoordinateDescent<T> {
+ protected:
+  using TStoSolver<T, T>::t;
+  using TStoSolver<T, T>::model;
+  using TStoSolver<T, T>::iterate;
+  using TStoSolver<T, T>::prox;
+  using TStoSolver<T, T>::rand_max;
+  using TCoordinateDescent<T>::casted_model;
+  using TCoordinateDescent<T>::columns_ready;
+  using TCoordinateDescent<T>::columns_indptr;
+  using TCoordinateDescent<T>::columns_indices;
+  using TCoordinateDescent<T>::columns_data;
+  using TCoordinateDescent<T>::inner_prods_ready;
+  using TCoordinateDescent<T>::inner_prods;
+  using TCoordinateDescent<T>::tmp_iterate;
+  using TCoordinateDescent<T>::init_columns;
+  using TCoordinateDescent<T>::init_inner_prods;
+  using TCoordinateDescent<T>::run_coordinate_updates;
+
+ public:
+  using TStoSolver<T, T>::get_class_name;
+
+ private:
+  // Derivatives of the losses of the samples at their inner products,
+  // divided by n_samples
+  Array<T> loss_grads;
+  Array<T> loss_hessians;
+
+  // Minimizer of the approximation, and its change of the inner products
+  Array<T> newton_iterate;
+  Array<T> newton_inner_prods;
+
+  // Curvature of the approximation along each coordinate
+  Array<T> coordinates_hessian;
+
+  //! @brief Updates coordinate j of the minimizer of the approximation
+  //! @return The absolute change of the coordinate
+  T update_newton_coordinate(ulong j, TProxSeparable<T> &casted_prox);
+
+  //! @brief Minimizes the penalized approximation by coordinate descent
+  void compute_newton_iterate(TProxSeparable<T> &casted_prox);
+
+ public:
+  TProxNewton(T tol = 0., RandType rand_type = RandType::cyclic,
+              ulong max_active_passes = 10, int record_every = 1,
+              int seed = -1);
+
+  void solve_one_epoch() override;
+};
+
+using ProxNewton = TProxNewton<double>;
+using ProxNewtonDouble = TProxNewton<double>;
+using ProxNewtonFloat = TProxNewton<float>;
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_PROX_NEWTON_H_
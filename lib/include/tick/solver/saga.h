@@ -19,6 +19,7 @@ class DLL_PUBLIC TBaseSAGA : public TStoSolver<T, K> {
   using TStoSolver<T, K>::epoch_size;
   using TStoSolver<T, K>::get_next_i;
   using TStoSolver<T, K>::rand_unif;
+  using TStoSolver<T, K>::batch_size;
 
  public:
   using TStoSolver<T, K>::set_model;
@@ -53,6 +54,10 @@ class DLL_PUBLIC TBaseSAGA : public TStoSolver<T, K> {
 
   void set_model(std::shared_ptr<TModel<T, K>> model) override;
 
+  void set_batch_size(ulong batch_size) override;
+
+  void set_rand_type(RandType rand_type) override;
+
   T get_step() const { return step; }
 
   void set_step(T step) { this->step = step; }
@@ -113,6 +118,17 @@ class DLL_PUBLIC TSAGA : public TBaseSAGA<T, T> {
   using TBaseSAGA<T, T>::step;
   using TBaseSAGA<T, T>::t;
   using TBaseSAGA<T, T>::solver_ready;
+  using TBaseSAGA<T, T>::batch_size;
+  using TBaseSAGA<T, T>::get_next_batch;
+  using TBaseSAGA<T, T>::get_n_batches;
+  using TBaseSAGA<T, T>::get_sample_weight;
+  using TBaseSAGA<T, T>::is_screened;
+
+  bool accepts_importance_sampling() const override { return true; }
+
+  bool accepts_screening() const override { return true; }
+
+  void restore_screened_features() override;
 
  public:
   using TBaseSAGA<T, T>::set_starting_iterate;
@@ -124,12 +140,35 @@ class DLL_PUBLIC TSAGA : public TBaseSAGA<T, T> {
   Array<T> gradients_memory;
   Array<T> gradients_average;
 
+  //! @brief Samples already stored by update_gradients_memory in the current
+  //! batch, cleared at its end
+  std::vector<bool> sampled_in_batch;
+
   void initialize_solver() override;
 
   void solve_dense(bool use_intercept, ulong n_features);
 
   void solve_sparse_proba_updates(bool use_intercept, ulong n_features);
 
+  //! @brief Epochs with batch_size > 1: each step uses the gradients of a
+  //! batch, taken at the same iterate, and applies the prox once. With sparse
+  //! features, only the union of the supports of the batch is updated
+  void solve_dense_batch(bool use_intercept, ulong n_features);
+
+  void solve_sparse_batch(bool use_intercept, ulong n_features);
+
+  //! @brief Differences between the factors of each draw of the batch and
+  //! the gradients memory before the batch
+  void compute_grad_factor_diffs(const ArrayULong &batch,
+                                 const Array<T> &factors,
+                                 Array<T> &grad_factor_diffs) const;
+
+  //! @brief Stores the factors of the distinct samples of the batch in the
+  //! gradients memory and updates their average over all samples
+  void update_gradients_memory(const ArrayULong &batch,
+                               const Array<T> &factors, bool use_intercept,
+                               ulong n_features);
+
  public:
   // This exists soley for cereal/swig
   TSAGA() : TSAGA<T>(0, 0, RandType::unif, 0, 0) {}
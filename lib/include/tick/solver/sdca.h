@@ -9,6 +9,7 @@
 
 #include "sto_solver.h"
 #include "tick/base_model/model.h"
+#include "tick/prox/prox_separable.h"
 
 // TODO: profile the code of SDCA to check if it's faster
 // TODO: code accelerated SDCA
@@ -47,12 +48,17 @@ class DLL_PUBLIC TSDCA : public TStoSolver<T, K> {
   // The dual variable
   Array<T> dual_vector;
 
+  // Number of threads sharing the primal vector, each of them owning a block
+  // of dual coordinates
+  size_t n_threads = 1;
+
  public:
   // This exists soley for cereal/swig
   TSDCA() : TSDCA<T, K>(0, 0, 0) {}
 
   explicit TSDCA(T l_l2sq, ulong epoch_size = 0, T tol = 0.,
-                 RandType rand_type = RandType::unif,  int record_every = 1, int seed = -1);
+                 RandType rand_type = RandType::unif,  int record_every = 1, int seed = -1,
+                 size_t n_threads = 1);
 
   void reset() override;
 
@@ -64,6 +70,10 @@ class DLL_PUBLIC TSDCA : public TStoSolver<T, K> {
 
   void set_l_l2sq(T l_l2sq) { this->l_l2sq = l_l2sq; }
 
+  size_t get_n_threads() const { return n_threads; }
+
+  void set_n_threads(size_t n_threads) { this->n_threads = n_threads; }
+
   SArrayTPtr get_primal_vector() const {
     Array<T> copy = iterate;
     return copy.as_sarray_ptr();
@@ -85,6 +95,18 @@ class DLL_PUBLIC TSDCA : public TStoSolver<T, K> {
     return l_l2sq * model->get_n_samples() / rand_max;
   }
 
+  //! @brief Epoch run by several threads, each one maximizing the dual
+  //! coordinates of its own block. The primal vector and the iterate are
+  //! shared as atomics: coordinates before prox are updated with
+  //! compare-and-swap and the iterate is stored without locks (Hogwild)
+  void solve_one_epoch_parallel(TProxSeparable<T, K> &casted_prox);
+
+  void threaded_solve_one_epoch(size_t thread, size_t n_active_threads,
+                                int thread_seed,
+                                Array<std::atomic<T>> &shared_primal_vector,
+                                Array<std::atomic<T>> &shared_iterate,
+                                TProxSeparable<T, K> &casted_prox);
+
  public:
   template <class Archive>
   void serialize(Archive &ar) {
@@ -96,6 +118,7 @@ class DLL_PUBLIC TSDCA : public TStoSolver<T, K> {
     ar(CEREAL_NVP(l_l2sq));
     ar(CEREAL_NVP(delta));
     ar(CEREAL_NVP(dual_vector));
+    ar(CEREAL_NVP(n_threads));
   }
 
   BoolStrReport compare(const TSDCA<T, K> &that) {
@@ -105,7 +128,7 @@ class DLL_PUBLIC TSDCA : public TStoSolver<T, K> {
         TStoSolver<T, K>::compare(that, ss) && TICK_CMP_REPORT(ss, n_coeffs) &&
         TICK_CMP_REPORT(ss, stored_variables_ready) &&
         TICK_CMP_REPORT(ss, l_l2sq) && TICK_CMP_REPORT(ss, delta) &&
-        TICK_CMP_REPORT(ss, dual_vector);
+        TICK_CMP_REPORT(ss, dual_vector) && TICK_CMP_REPORT(ss, n_threads);
     return BoolStrReport(are_equal, ss.str());
   }
 
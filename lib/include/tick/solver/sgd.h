@@ -20,6 +20,12 @@ class DLL_PUBLIC TSGD : public TStoSolver<T, K> {
   using TStoSolver<T, K>::prox;
   using TStoSolver<T, K>::epoch_size;
   using TStoSolver<T, K>::get_next_i;
+  using TStoSolver<T, K>::get_next_batch;
+  using TStoSolver<T, K>::get_n_batches;
+  using TStoSolver<T, K>::batch_size;
+  using TStoSolver<T, K>::get_sample_weight;
+
+  bool accepts_importance_sampling() const override { return true; }
 
  public:
   using TStoSolver<T, K>::get_class_name;
@@ -40,8 +46,28 @@ class DLL_PUBLIC TSGD : public TStoSolver<T, K> {
 
   void solve_one_epoch() override;
 
+  //! @brief Epoch for dense models, the prox being applied on all
+  //! coefficients at each step
+  void solve_dense();
+
+  //! @brief Epoch for dense models with batch_size > 1. Each step averages
+  //! the gradients of a batch of samples, taken at the same iterate, and
+  //! applies the prox once
+  void solve_dense_batch();
+
+  //! @brief Epoch for sparse models. When the prox is separable and composes
+  //! in closed form (see TProxSeparable::get_shrinkage), it is applied
+  //! lazily, so that each step costs O(nnz(x_i)) instead of O(n_coeffs).
+  //! With batch_size > 1, each step works on the union of the supports of
+  //! its batch. Models implementing grad_i_sparse, such as Hawkes
+  //! log-likelihoods, also go through this epoch when batch_size is 1, each
+  //! step costing the size of the support of the gradient
   void solve_sparse();
 
+  //! @brief Epoch for sparse models applying the prox on all coefficients
+  //! at each step
+  void solve_sparse_full_prox();
+
   inline T get_step_t();
 
   template <class Archive>
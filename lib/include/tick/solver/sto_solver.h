@@ -12,18 +12,24 @@
 
 #include "tick/prox/prox.h"
 #include "tick/prox/prox_zero.h"
+#include "tick/random/alias_table.h"
 #include "tick/random/rand.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <vector>
 
 #include "tick/solver/enums.h"
 
 // TODO: code an abstract class and use it for StoSolvers
 // TODO: StoSolver and LabelsFeaturesSolver
 
-// Type of randomness used when sampling at random data points
-enum class RandType { unif = 0, perm };
+// Type of randomness used when sampling at random data points. With
+// importance, samples are drawn proportionally to their Lipschitz constants,
+// and with cyclic they are visited in order, without randomness
+enum class RandType { unif = 0, perm, importance, cyclic };
 inline std::ostream &operator<<(std::ostream &s, const RandType &r) {
   typedef std::underlying_type<RandType>::type utype;
   return s << static_cast<utype>(r);
@@ -56,9 +62,13 @@ class DLL_PUBLIC TStoSolver {
   // Number of steps within an epoch
   ulong epoch_size;
 
+  // Number of samples used by each step of the solvers supporting
+  // mini-batches (TSGD, TSVRG and TSAGA)
+  ulong batch_size = 1;
+
   // Current index in the permutation (useful when using random permutation
-  // sampling)
-  ulong i_perm;
+  // or cyclic sampling)
+  ulong i_perm = 0;
 
   // Tolerance for convergence. Not used yet.
   T tol;
@@ -79,6 +89,23 @@ class DLL_PUBLIC TStoSolver {
   // An array that allows to store the sampled random permutation
   ArrayULong permutation;
 
+  // Alias table of the importance sampling, and weights 1 / (rand_max p_i)
+  // keeping the stochastic gradients unbiased. They are built from the
+  // Lipschitz constants of the model at the first draw
+  bool importance_ready = false;
+  AliasTable importance_sampler;
+  Array<T> importance_weights;
+
+  // Gap safe screening, done every screening_every epochs if positive. A
+  // feature is screened once the duality gap proves it is zero at the
+  // optimum, for the L1 and L2 strengths of the screening
+  ulong screening_every = 0;
+  std::vector<bool> screened;
+  ulong n_screened = 0;
+  T duality_gap = std::numeric_limits<T>::infinity();
+  T screening_l1_strength = 0, screening_l2_strength = 0;
+  Array<T> columns_norm;
+
   int record_every = 1;
   size_t last_record_epoch = 0;
   double last_record_time = 0;
@@ -99,8 +126,55 @@ class DLL_PUBLIC TStoSolver {
   // Init permutation array in case of Random is srt to permutation
   void init_permutation();
 
+  // Builds the alias table of importance sampling, if not done yet
+  void init_importance_sampling();
+
+  // Solvers reweighting the gradients with get_sample_weight accept
+  // importance sampling
+  virtual bool accepts_importance_sampling() const { return false; }
+
+  // Weight of the gradient of sample i, 1 unless importance sampling is used
+  inline T get_sample_weight(const ulong i) const {
+    return rand_type == RandType::importance ? importance_weights[i] : T{1};
+  }
+
+  // Probability to draw sample i
+  T get_sample_probability(ulong i);
+
+  // For sparse models, probability that feature j is in the support of the
+  // features vector of a drawn sample, for each feature
+  Array<T> get_support_probabilities();
+
   virtual void save_history(double time, int epoch);
 
+  // Solvers skipping the screened features in their updates accept screening
+  virtual bool accepts_screening() const { return false; }
+
+  // Computes the duality gap at the iterate, and screens the features it
+  // proves to be zero at the optimum
+  void screen();
+
+  // L1 and L2 strengths of the penalization, that must be a ProxL1 or a
+  // ProxElasticNet
+  void get_screening_strengths(T &l1_strength, T &l2_strength) const;
+
+  // Gives back all screened features
+  void clear_screening();
+
+  // Called when screened features are given back, for solvers that stopped
+  // updating their state on them
+  virtual void restore_screened_features() {}
+
+  inline bool is_screened(const ulong j) const {
+    return n_screened > 0 && j < screened.size() && screened[j];
+  }
+
+  // Number of mini-batch steps within an epoch, each one using batch_size
+  // samples
+  inline ulong get_n_batches() const {
+    return std::max(epoch_size / batch_size, ulong{1});
+  }
+
  public:
   inline TStoSolver(ulong epoch_size = 0, T tol = 0.,
                     RandType rand_type = RandType::unif, int record_every = 1, int seed = -1)
@@ -118,12 +192,18 @@ class DLL_PUBLIC TStoSolver {
   virtual void set_model(std::shared_ptr<TModel<T, K> > _model) {
     this->model = _model;
     permutation_ready = false;
+    importance_ready = false;
     iterate = Array<K>(_model->get_n_coeffs());
     iterate.init_to_zero();
+    screened.clear();
+    n_screened = 0;
+    duality_gap = std::numeric_limits<T>::infinity();
+    columns_norm = Array<T>();
   }
 
   virtual void set_prox(std::shared_ptr<TProx<T, K> > prox) {
     this->prox = prox;
+    clear_screening();
   }
 
   void set_seed(int seed) {
@@ -135,6 +215,9 @@ class DLL_PUBLIC TStoSolver {
 
   ulong get_next_i();
 
+  // Fills batch with its size next samples
+  void get_next_batch(ArrayULong &batch);
+
   void shuffle();
 
   virtual void solve_one_epoch() { TICK_CLASS_DOES_NOT_IMPLEMENT("TStoSolver<T, K>"); }
@@ -160,17 +243,52 @@ class DLL_PUBLIC TStoSolver {
     this->epoch_size = epoch_size;
   }
 
+  inline ulong get_batch_size() const { return batch_size; }
+
+  virtual void set_batch_size(ulong batch_size) {
+    if (batch_size == 0) {
+      TICK_ERROR("batch_size must be positive");
+    }
+    this->batch_size = batch_size;
+  }
+
   inline ulong get_t() const { return t; }
 
+  inline ulong get_screening_every() const { return screening_every; }
+
+  inline void set_screening_every(ulong screening_every) {
+    if (screening_every > 0 && !accepts_screening()) {
+      TICK_ERROR(get_class_name() << " does not accept gap safe screening")
+    }
+    this->screening_every = screening_every;
+  }
+
+  // Screens the features j for which screened_features[j] is true, until the
+  // strengths of the prox change. TPathSolver gives this way the features
+  // discarded by strong rules. Solvers not accepting screening ignore it
+  void set_screened_features(const std::vector<bool> &screened_features);
+
+  // Proportion of the features that are screened
+  inline T get_screening_rate() const {
+    return screened.empty() ? 0 : static_cast<T>(n_screened) / screened.size();
+  }
+
+  // Duality gap computed at the last screening
+  inline T get_duality_gap() const { return duality_gap; }
+
   inline RandType get_rand_type() const { return rand_type; }
 
-  inline void set_rand_type(RandType rand_type) { this->rand_type = rand_type; }
+  virtual void set_rand_type(RandType rand_type) {
+    this->rand_type = rand_type;
+    importance_ready = false;
+  }
 
   inline ulong get_rand_max() const { return rand_max; }
 
   inline void set_rand_max(ulong rand_max) {
     this->rand_max = rand_max;
     permutation_ready = false;
+    importance_ready = false;
   }
 
   inline int get_record_every() const { return record_every; }
@@ -205,6 +323,8 @@ class DLL_PUBLIC TStoSolver {
     ar(CEREAL_NVP(iterate));
     ar(CEREAL_NVP(rand_max));
     ar(CEREAL_NVP(epoch_size));
+    ar(CEREAL_NVP(batch_size));
+    ar(CEREAL_NVP(screening_every));
     ar(CEREAL_NVP(tol));
     ar(CEREAL_NVP(rand_type));
     ar(CEREAL_NVP(permutation));
@@ -224,6 +344,8 @@ class DLL_PUBLIC TStoSolver {
     ar(CEREAL_NVP(iterate));
     ar(CEREAL_NVP(rand_max));
     ar(CEREAL_NVP(epoch_size));
+    ar(CEREAL_NVP(batch_size));
+    ar(CEREAL_NVP(screening_every));
     ar(CEREAL_NVP(tol));
     ar(CEREAL_NVP(rand_type));
     ar(CEREAL_NVP(permutation));
@@ -241,7 +363,9 @@ class DLL_PUBLIC TStoSolver {
     return BoolStrReport(
         TICK_CMP_REPORT(ss, t) && TICK_CMP_REPORT(ss, iterate) &&
             TICK_CMP_REPORT(ss, rand_max) && TICK_CMP_REPORT(ss, epoch_size) &&
-            TICK_CMP_REPORT(ss, tol) && TICK_CMP_REPORT(ss, rand_type) &&
+            TICK_CMP_REPORT(ss, batch_size) &&
+            TICK_CMP_REPORT(ss, screening_every) && TICK_CMP_REPORT(ss, tol) &&
+            TICK_CMP_REPORT(ss, rand_type) &&
             TICK_CMP_REPORT(ss, permutation) && TICK_CMP_REPORT(ss, i_perm) &&
             TICK_CMP_REPORT(ss, permutation_ready) && TICK_CMP_REPORT(ss, record_every),
         ss.str());
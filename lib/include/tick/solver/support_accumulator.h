@@ -0,0 +1,65 @@
+#ifndef LIB_INCLUDE_TICK_SOLVER_SUPPORT_ACCUMULATOR_H_
+#define LIB_INCLUDE_TICK_SOLVER_SUPPORT_ACCUMULATOR_H_
+
+// License: BSD 3 clause
+
+#include <vector>
+
+#include "tick/array/array.h"
+
+/**
+ * @class SupportAccumulator
+ * @brief Accumulates a linear combination of sparse features vectors in a
+ * dense buffer, keeping track of the union of their supports. This is used by
+ * the mini-batch steps of the stochastic solvers, which only read and write
+ * the coordinates of this union.
+ */
+template <class T>
+class SupportAccumulator {
+ private:
+  Array<T> values;
+  std::vector<bool> in_support;
+  std::vector<ulong> support;
+
+ public:
+  explicit SupportAccumulator(ulong size = 0)
+      : values(size), in_support(size, false) {
+    values.init_to_zero();
+  }
+
+  //! @brief Adds the support of the sparse vector x to the union
+  inline void add_support(const BaseArray<T> &x) {
+    for (ulong idx_nnz = 0; idx_nnz < x.size_sparse(); ++idx_nnz) {
+      const ulong j = x.indices()[idx_nnz];
+      if (!in_support[j]) {
+        in_support[j] = true;
+        support.push_back(j);
+      }
+    }
+  }
+
+  //! @brief Adds factor * x to the accumulated values, x being sparse
+  inline void incr(const BaseArray<T> &x, const T factor) {
+    add_support(x);
+    for (ulong idx_nnz = 0; idx_nnz < x.size_sparse(); ++idx_nnz) {
+      values[x.indices()[idx_nnz]] += factor * x.data()[idx_nnz];
+    }
+  }
+
+  //! @brief Union of the supports added since the last reset
+  inline const std::vector<ulong> &get_support() const { return support; }
+
+  inline T operator[](const ulong j) const { return values[j]; }
+
+  //! @brief Sets the values back to zero and empties the support, in
+  //! O(size of the support)
+  inline void reset() {
+    for (const ulong j : support) {
+      values[j] = 0;
+      in_support[j] = false;
+    }
+    support.clear();
+  }
+};
+
+#endif  // LIB_INCLUDE_TICK_SOLVER_SUPPORT_ACCUMULATOR_H_
@@ -19,6 +19,16 @@ class DLL_PUBLIC TSVRG : public TStoSolver<T, K> {
   using TStoSolver<T, K>::epoch_size;
   using TStoSolver<T, K>::get_next_i;
   using TStoSolver<T, K>::rand_unif;
+  using TStoSolver<T, K>::get_next_batch;
+  using TStoSolver<T, K>::get_n_batches;
+  using TStoSolver<T, K>::batch_size;
+  using TStoSolver<T, K>::rand_type;
+  using TStoSolver<T, K>::get_sample_weight;
+  using TStoSolver<T, K>::is_screened;
+
+  bool accepts_importance_sampling() const override { return true; }
+
+  bool accepts_screening() const override { return true; }
 
  public:
   using TStoSolver<T, K>::get_class_name;
@@ -51,6 +61,16 @@ class DLL_PUBLIC TSVRG : public TStoSolver<T, K> {
 
   void compute_step_corrections();
 
+  //! @brief Epochs with batch_size > 1: each step averages the variance
+  //! reduced gradients of a batch, taken at the same iterate, and applies the
+  //! prox once. With sparse features, only the union of the supports of the
+  //! batch is updated
+  void solve_dense_batch();
+
+  void solve_sparse_batch(bool use_intercept, ulong n_features);
+
+  void update_next_iterate_batch(ulong k, ulong n_batches);
+
   void dense_single_thread_solver(const ulong& next_i);
 
   // TProxSeparable<T, K>* is a raw pointer here as the
@@ -74,6 +94,10 @@ class DLL_PUBLIC TSVRG : public TStoSolver<T, K> {
 
   void set_model(std::shared_ptr<TModel<T, K>> model) override;
 
+  void set_batch_size(ulong batch_size) override;
+
+  void set_rand_type(RandType rand_type) override;
+
   T get_step() const { return step; }
 
   void set_step(T step) { TSVRG<T, K>::step = step; }
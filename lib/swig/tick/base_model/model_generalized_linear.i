@@ -18,6 +18,8 @@ class TModelGeneralizedLinear : public virtual TModelLabelsFeatures<T, K> {
   );
   unsigned long get_n_coeffs() const override;
   virtual void set_fit_intercept(bool fit_intercept);
+  virtual void hessian_vector_product(const Array<K> &coeffs,
+                                      const Array<T> &vector, Array<T> &out);
   void sdca_primal_dual_relation(const T l_l2sq,
                                  const Array<T> &dual_vector,
                                  Array<T> &out_primal_vector) override;
@@ -32,6 +34,9 @@ class TModelGeneralizedLinear<double, double> : public virtual TModelLabelsFeatu
                          const int n_threads = 1);
   unsigned long get_n_coeffs() const override;
   virtual void set_fit_intercept(bool fit_intercept);
+  virtual void hessian_vector_product(const ArrayDouble &coeffs,
+                                      const ArrayDouble &vector,
+                                      ArrayDouble &out);
   void sdca_primal_dual_relation(const double l_l2sq,
                                  const ArrayDouble &dual_vector,
                                  ArrayDouble &out_primal_vector);
@@ -47,6 +52,9 @@ class TModelGeneralizedLinear<float, float> : public virtual TModelLabelsFeature
                          const int n_threads = 1);
   unsigned long get_n_coeffs() const override;
   virtual void set_fit_intercept(bool fit_intercept);
+  virtual void hessian_vector_product(const ArrayFloat &coeffs,
+                                      const ArrayFloat &vector,
+                                      ArrayFloat &out);
   void sdca_primal_dual_relation(const float l_l2sq,
                                  const ArrayFloat &dual_vector,
                                  ArrayFloat &out_primal_vector);
@@ -2,27 +2,63 @@
 
 
 %include std_shared_ptr.i
-%shared_ptr(HawkesADM4);
+%shared_ptr(THawkesADM4<double>);
+%shared_ptr(THawkesADM4<float>);
 
 %{
 #include "tick/hawkes/inference/hawkes_adm4.h"
 %}
 
-class HawkesADM4 : public ModelHawkesList {
+template <class T>
+class THawkesADM4 : public ModelHawkesList {
 
  public:
 
-  HawkesADM4(const double decay, const double rho, const int max_n_threads=1,
-             const unsigned int optimization_level=0);
+  THawkesADM4(const double decay, const double rho, const int max_n_threads=1,
+              const unsigned int optimization_level=0);
 
   void solve(ArrayDouble &mu, ArrayDouble2d &auv, ArrayDouble2d &z1uv, ArrayDouble2d &z2uv,
              ArrayDouble2d &u1uv, ArrayDouble2d &u2uv);
 
+  ulong solve_em(ArrayDouble &mu, ArrayDouble2d &adjacency, ArrayDouble2d &z1,
+                 ArrayDouble2d &z2, ArrayDouble2d &u1, ArrayDouble2d &u2,
+                 const ulong em_max_iter, const double em_tol);
+
+  void reset_components();
+
+  ulong solve_em_low_rank(ArrayDouble &mu, ArrayDouble2d &adjacency,
+                          ArrayDouble2d &u1, ArrayDouble2d &u2,
+                          const ulong em_max_iter, const double em_tol);
+
+  void update_components(ArrayDouble2d &adjacency, ArrayDouble2d &u1,
+                         ArrayDouble2d &u2, const double strength_lasso,
+                         const double strength_nuclear);
+
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &adjacency,
+            const double strength_lasso, const double strength_nuclear,
+            const ulong max_iter, const double tol, const ulong em_max_iter,
+            const double em_tol, const ulong record_every = 1);
+
+  SArrayDouble2dPtr get_fit_history() const;
+
   void compute_weights();
 
   double get_decay() const;
   void set_decay(const double decay);
   double get_rho() const;
   void set_rho(const double rho);
+  double get_weights_threshold() const;
+  void set_weights_threshold(const double weights_threshold);
+  ulong get_max_rank() const;
+  void set_max_rank(const ulong max_rank);
+
+  SArrayDouble2dPtr get_low_rank_left() const;
+  SArrayDoublePtr get_low_rank_singular_values() const;
+  SArrayDouble2dPtr get_low_rank_right() const;
 };
 
+%template(HawkesADM4) THawkesADM4<double>;
+typedef THawkesADM4<double> HawkesADM4;
+
+%template(HawkesADM4Float) THawkesADM4<float>;
+typedef THawkesADM4<float> HawkesADM4Float;
@@ -2,19 +2,21 @@
 
 
 %include std_shared_ptr.i
-%shared_ptr(HawkesBasisKernels);
+%shared_ptr(THawkesBasisKernels<double>);
+%shared_ptr(THawkesBasisKernels<float>);
 
 %{
 #include "tick/hawkes/inference/hawkes_basis_kernels.h"
 %}
 
-class HawkesBasisKernels : public ModelHawkesList {
+template <class T>
+class THawkesBasisKernels : public ModelHawkesList {
  public :
-  HawkesBasisKernels(const ulong D,
-                       const double kernel_dt,
-                       const double kernel_tmax,
-                       const double alpha,
-                       const int max_n_threads = 1);
+  THawkesBasisKernels(const ulong D,
+                        const double kernel_dt,
+                        const double kernel_tmax,
+                        const double alpha,
+                        const int max_n_threads = 1);
 
   double solve(ArrayDouble &mu,
                ArrayDouble2d &gdm,
@@ -22,6 +24,11 @@ class HawkesBasisKernels : public ModelHawkesList {
                ulong max_iter_gdm,
                double max_tol_gdm);
 
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &gdm, ArrayDouble2d &auvd,
+            const ulong max_iter, const double tol, const ulong max_iter_gdm,
+            const double max_tol_gdm, const ulong record_every = 1);
+  SArrayDouble2dPtr get_fit_history() const;
+
   double get_kernel_support() const;
   ulong get_kernel_size() const;
   inline double get_kernel_dt() const;
@@ -36,3 +43,8 @@ class HawkesBasisKernels : public ModelHawkesList {
   void set_alpha(const double alpha);
 };
 
+%template(HawkesBasisKernels) THawkesBasisKernels<double>;
+typedef THawkesBasisKernels<double> HawkesBasisKernels;
+
+%template(HawkesBasisKernelsFloat) THawkesBasisKernels<float>;
+typedef THawkesBasisKernels<float> HawkesBasisKernelsFloat;
@@ -11,3 +11,12 @@ extern void PointProcessCondLaw(ArrayDouble &y_time,
                                 double y_T,
                                 double y_lambda,
                                 ArrayDouble &res_X, ArrayDouble &res_Y);
+
+extern void PointProcessCondLawBatch(const SArrayDoublePtrList1D &timestamps,
+                                     const SArrayDoublePtrList1D &marks,
+                                     ArrayDouble &lags,
+                                     ArrayULong &y_nodes, ArrayULong &z_nodes,
+                                     ArrayDouble &zmins, ArrayDouble &zmaxs,
+                                     double y_T,
+                                     ArrayDouble &res_X, ArrayDouble2d &res_Y,
+                                     int max_n_threads = 1);
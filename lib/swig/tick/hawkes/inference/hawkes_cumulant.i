@@ -1,17 +1,19 @@
 
 
 %include std_shared_ptr.i
-%shared_ptr(HawkesCumulant);
+%shared_ptr(THawkesCumulant<double>);
+%shared_ptr(THawkesCumulant<float>);
 
 %{
 #include "tick/hawkes/inference/hawkes_cumulant.h"
 %}
 
 
-class HawkesCumulant : public ModelHawkesList {
+template <class T>
+class THawkesCumulant : public ModelHawkesList {
 
 public:
-  HawkesCumulant(double integration_support);
+  THawkesCumulant(double integration_support, const int max_n_threads = 1);
 
   SArrayDoublePtr compute_A_and_I_ij(ulong r, ulong i, ulong j, double mean_intensity_j);
 
@@ -19,8 +21,19 @@ public:
                        double mean_intensity_i, double mean_intensity_j,
                        double J_ij);
 
+  void compute_cumulants();
+  SArrayDoublePtr get_mean_intensity() const;
+  SArrayDouble2dPtr get_covariance() const;
+  SArrayDouble2dPtr get_skewness() const;
+
   double get_integration_support() const;
   void set_integration_support(const double integration_support);
   bool get_are_cumulants_ready() const;
   void set_are_cumulants_ready(const bool recompute_cumulants);
-};
\ No newline at end of file
+};
+
+%template(HawkesCumulant) THawkesCumulant<double>;
+typedef THawkesCumulant<double> HawkesCumulant;
+
+%template(HawkesCumulantFloat) THawkesCumulant<float>;
+typedef THawkesCumulant<float> HawkesCumulantFloat;
@@ -2,25 +2,33 @@
 
 
 %include std_shared_ptr.i
-%shared_ptr(HawkesEM);
+%shared_ptr(THawkesEM<double>);
+%shared_ptr(THawkesEM<float>);
 
 %{
 #include "tick/hawkes/inference/hawkes_em.h"
 %}
 
-class HawkesEM : public ModelHawkesList {
+template <class T>
+class THawkesEM : public ModelHawkesList {
  public :
-  HawkesEM(const double kernel_support, const ulong kernel_size,
-           const int max_n_threads = 1);
+  THawkesEM(const double kernel_support, const ulong kernel_size,
+            const int max_n_threads = 1);
 
-  HawkesEM(const SArrayDoublePtr kernel_discretization, const int max_n_threads = 1);
+  THawkesEM(const SArrayDoublePtr kernel_discretization, const int max_n_threads = 1);
 
   void allocate_weights();
 
   void solve(ArrayDouble &mu, ArrayDouble2d &kernels);
 
+  ulong fit(ArrayDouble2d &mu_starts, ArrayDouble2d &kernels_starts,
+            const ulong max_iter, const double tol,
+            const ulong record_every = 1);
+  SArrayDouble2dPtr get_fit_history(const ulong start) const;
+
   SArrayDouble2dPtr get_kernel_norms(ArrayDouble2d &kernels) const;
   double loglikelihood(ArrayDouble &mu, ArrayDouble2d &kernels);
+  SArrayDoublePtrList2D get_residuals(ArrayDouble &mu, ArrayDouble2d &kernels);
 
   double get_kernel_support() const;
   ulong get_kernel_size() const;
@@ -31,4 +39,13 @@ class HawkesEM : public ModelHawkesList {
   void set_kernel_size(const ulong kernel_size);
   void set_kernel_dt(const double kernel_dt);
   void set_kernel_discretization(const SArrayDoublePtr kernel_discretization);
+
+  ulong get_fft_binning() const;
+  void set_fft_binning(const ulong fft_binning);
 };
+
+%template(HawkesEM) THawkesEM<double>;
+typedef THawkesEM<double> HawkesEM;
+
+%template(HawkesEMFloat) THawkesEM<float>;
+typedef THawkesEM<float> HawkesEMFloat;
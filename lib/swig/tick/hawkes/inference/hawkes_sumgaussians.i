@@ -2,25 +2,32 @@
 
 
 %include std_shared_ptr.i
-%shared_ptr(HawkesSumGaussians);
+%shared_ptr(THawkesSumGaussians<double>);
+%shared_ptr(THawkesSumGaussians<float>);
 
 %{
 #include "tick/hawkes/inference/hawkes_sumgaussians.h"
 %}
 
-class HawkesSumGaussians : public ModelHawkesList {
+template <class T>
+class THawkesSumGaussians : public ModelHawkesList {
 
  public:
 
-  HawkesSumGaussians(const ulong n_gaussians, const double max_mean_gaussian, const double step_size,
-                     const double strength_lasso, const double strength_grouplasso,
-                     const ulong em_max_iter, const int max_n_threads = 1,
-                     const unsigned int optimization_level = 0);
+  THawkesSumGaussians(const ulong n_gaussians, const double max_mean_gaussian, const double step_size,
+                      const double strength_lasso, const double strength_grouplasso,
+                      const ulong em_max_iter, const int max_n_threads = 1,
+                      const unsigned int optimization_level = 0);
 
   void compute_weights();
 
   void solve(ArrayDouble &mu, ArrayDouble2d &amplitudes);
 
+  ulong fit(ArrayDouble &mu, ArrayDouble2d &amplitudes, const ulong max_iter,
+            const double tol, const double em_tol,
+            const ulong record_every = 1);
+  SArrayDouble2dPtr get_fit_history() const;
+
   ulong get_n_gaussians() const;
   void set_n_gaussians(const ulong n_gaussians);
   ulong get_em_max_iter() const;
@@ -33,4 +40,12 @@ class HawkesSumGaussians : public ModelHawkesList {
   void set_strength_lasso(const double strength_lasso);
   double get_strength_grouplasso() const;
   void set_strength_grouplasso(const double strength_grouplasso);
-};
\ No newline at end of file
+  double get_n_std_truncation() const;
+  void set_n_std_truncation(const double n_std_truncation);
+};
+
+%template(HawkesSumGaussians) THawkesSumGaussians<double>;
+typedef THawkesSumGaussians<double> HawkesSumGaussians;
+
+%template(HawkesSumGaussiansFloat) THawkesSumGaussians<float>;
+typedef THawkesSumGaussians<float> HawkesSumGaussiansFloat;
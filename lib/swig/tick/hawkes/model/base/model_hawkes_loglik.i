@@ -6,17 +6,25 @@
 %}
 
 
-class ModelHawkesLogLik : public ModelHawkesList {
+template <class T>
+class TModelHawkesLogLik : public ModelHawkesList {
 
 public:
 
-  ModelHawkesLogLik(const int max_n_threads = 1);
+  TModelHawkesLogLik(const int max_n_threads = 1);
 
   double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
   double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
   void hessian(const ArrayDouble &coeffs, ArrayDouble &out);
+  SArrayDoublePtrList2D get_residuals(const ArrayDouble &coeffs);
 
   void incremental_set_data(const SArrayDoublePtrList1D &timestamps, double end_time);
 
   void compute_weights();
 };
+
+%template(ModelHawkesLogLik) TModelHawkesLogLik<double>;
+typedef TModelHawkesLogLik<double> ModelHawkesLogLik;
+
+%template(ModelHawkesLogLikFloat) TModelHawkesLogLik<float>;
+typedef TModelHawkesLogLik<float> ModelHawkesLogLikFloat;
@@ -17,12 +17,15 @@
 %shared_ptr(ModelHawkes);
 %shared_ptr(ModelHawkesList);
 %shared_ptr(ModelHawkesLeastSq);
-%shared_ptr(ModelHawkesLogLik);
+%shared_ptr(TModelHawkesLogLik<double>);
+%shared_ptr(TModelHawkesLogLik<float>);
 
 %shared_ptr(ModelHawkesExpKernLeastSq);
 %shared_ptr(ModelHawkesSumExpKernLeastSq);
-%shared_ptr(ModelHawkesExpKernLogLik);
-%shared_ptr(ModelHawkesSumExpKernLogLik);
+%shared_ptr(TModelHawkesExpKernLogLik<double>);
+%shared_ptr(TModelHawkesExpKernLogLik<float>);
+%shared_ptr(TModelHawkesSumExpKernLogLik<double>);
+%shared_ptr(TModelHawkesSumExpKernLogLik<float>);
 
 
 %include base/model_hawkes.i
@@ -16,6 +16,8 @@ public:
 
   void hessian(ArrayDouble &out);
   void set_decays(const SArrayDouble2dPtr decays);
+  void set_adjacency_mask(const SArrayULong2dPtr adjacency_mask);
+  SArrayULong2dPtr get_adjacency_mask() const;
 };
 
 TICK_MAKE_PICKLABLE(ModelHawkesExpKernLeastSq);
\ No newline at end of file
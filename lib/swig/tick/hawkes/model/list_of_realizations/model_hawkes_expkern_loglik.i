@@ -6,12 +6,19 @@
 %}
 
 
-class ModelHawkesExpKernLogLik : public ModelHawkesLogLik {
+template <class T>
+class TModelHawkesExpKernLogLik : public TModelHawkesLogLik<T> {
     
 public:
     
-  ModelHawkesExpKernLogLik(const double decay,
-                                    const int max_n_threads = 1);
+  TModelHawkesExpKernLogLik(const double decay,
+                            const int max_n_threads = 1);
 
   void set_decay(const double decay);
 };
+
+%template(ModelHawkesExpKernLogLik) TModelHawkesExpKernLogLik<double>;
+typedef TModelHawkesExpKernLogLik<double> ModelHawkesExpKernLogLik;
+
+%template(ModelHawkesExpKernLogLikFloat) TModelHawkesExpKernLogLik<float>;
+typedef TModelHawkesExpKernLogLik<float> ModelHawkesExpKernLogLikFloat;
@@ -6,13 +6,20 @@
 %}
 
 
-class ModelHawkesSumExpKernLogLik : public ModelHawkesLogLik {
+template <class T>
+class TModelHawkesSumExpKernLogLik : public TModelHawkesLogLik<T> {
     
 public:
     
-  ModelHawkesSumExpKernLogLik(const ArrayDouble &decays,
-                                       const int max_n_threads = 1);
+  TModelHawkesSumExpKernLogLik(const ArrayDouble &decays,
+                               const int max_n_threads = 1);
 
   void set_decays(ArrayDouble &decays);
   SArrayDoublePtr get_decays() const;
 };
+
+%template(ModelHawkesSumExpKernLogLik) TModelHawkesSumExpKernLogLik<double>;
+typedef TModelHawkesSumExpKernLogLik<double> ModelHawkesSumExpKernLogLik;
+
+%template(ModelHawkesSumExpKernLogLikFloat) TModelHawkesSumExpKernLogLik<float>;
+typedef TModelHawkesSumExpKernLogLik<float> ModelHawkesSumExpKernLogLikFloat;
@@ -0,0 +1,31 @@
+// License: BSD 3 clause
+
+
+%include tick/base/defs.i
+
+%{
+#include "tick/hawkes/simulation/hawkes_intensity_filter.h"
+%}
+
+class HawkesIntensityFilter {
+
+    public :
+        HawkesIntensityFilter(const ArrayDouble &baseline,
+                              const ArrayDouble2d &adjacency,
+                              const ArrayDouble &decays);
+
+        void reset();
+
+        void on_event(const ulong node, const double t);
+        void on_events(const ArrayULong &nodes, const ArrayDouble &times,
+                       ArrayDouble &event_intensities);
+
+        double get_intensity(const ulong node, const double t) const;
+        void intensity(const double t, ArrayDouble &intensities) const;
+        void compensator(const double t0, const double t1,
+                         ArrayDouble &compensators) const;
+
+        ulong get_n_nodes() const;
+        ulong get_n_decays() const;
+        double get_last_time() const;
+};
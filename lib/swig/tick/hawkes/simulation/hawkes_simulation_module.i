@@ -23,3 +23,4 @@
 %include simu_inhomogeneous_poisson.i
 %include simu_hawkes.i
 %include hawkes_kernels.i
+%include hawkes_intensity_filter.i
@@ -0,0 +1,39 @@
+// License: BSD 3 clause
+
+%include "sto_solver.i"
+
+%{
+#include "tick/solver/asvrg.h"
+%}
+
+template <class T>
+class AtomicSVRG : public TStoSolver<T, T> {
+ public:
+    AtomicSVRG();
+
+    AtomicSVRG(
+      unsigned long epoch_size,
+      T tol,
+      RandType rand_type,
+      T step,
+      int record_every = 1,
+      int seed = -1,
+      int n_threads = 2
+    );
+
+    T get_step();
+    void set_step(T step);
+
+    int get_n_threads();
+    void set_n_threads(int n_threads);
+
+    bool compare(const AtomicSVRG<T> &that);
+};
+
+%template(AtomicSVRGDouble) AtomicSVRG<double>;
+typedef AtomicSVRG<double> AtomicSVRGDouble;
+TICK_MAKE_TEMPLATED_PICKLABLE(AtomicSVRG, AtomicSVRGDouble , double);
+
+%template(AtomicSVRGFloat) AtomicSVRG<float>;
+typedef AtomicSVRG<float> AtomicSVRGFloat;
+TICK_MAKE_TEMPLATED_PICKLABLE(AtomicSVRG, AtomicSVRGFloat , float);
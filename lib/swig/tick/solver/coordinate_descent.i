@@ -0,0 +1,40 @@
+// License: BSD 3 clause
+
+%include "sto_solver.i"
+
+%{
+#include "tick/solver/coordinate_descent.h"
+%}
+
+enum class CoordinateDescent_StepType : uint16_t {
+    QuadraticBound = 1,
+    Newton = 2,
+};
+
+template <class T>
+class TCoordinateDescent : public TStoSolver<T, T> {
+ public:
+    TCoordinateDescent(
+      unsigned long epoch_size = 0,
+      T tol = 0.,
+      RandType rand_type = RandType::cyclic,
+      CoordinateDescent_StepType step_type = CoordinateDescent_StepType::Newton,
+      unsigned long max_active_passes = 10,
+      int record_every = 1,
+      int seed = -1
+    );
+
+    void set_model(std::shared_ptr<TModel<T, T> > model) override;
+
+    CoordinateDescent_StepType get_step_type() const;
+    void set_step_type(CoordinateDescent_StepType step_type);
+
+    unsigned long get_max_active_passes() const;
+    void set_max_active_passes(unsigned long max_active_passes);
+};
+
+%template(CoordinateDescentDouble) TCoordinateDescent<double>;
+typedef TCoordinateDescent<double> CoordinateDescentDouble;
+
+%template(CoordinateDescentFloat) TCoordinateDescent<float>;
+typedef TCoordinateDescent<float> CoordinateDescentFloat;
@@ -0,0 +1,29 @@
+// License: BSD 3 clause
+
+%include "sto_solver.i"
+
+%{
+#include "tick/solver/newton_cg.h"
+%}
+
+template <class T>
+class TNewtonCG : public TStoSolver<T, T> {
+ public:
+    TNewtonCG(
+      T tol = 0.,
+      unsigned long max_cg_iter = 20,
+      int record_every = 1
+    );
+
+    void set_model(std::shared_ptr<TModel<T, T> > model) override;
+    void set_prox(std::shared_ptr<TProx<T, T> > prox) override;
+
+    unsigned long get_max_cg_iter() const;
+    void set_max_cg_iter(unsigned long max_cg_iter);
+};
+
+%template(NewtonCGDouble) TNewtonCG<double>;
+typedef TNewtonCG<double> NewtonCGDouble;
+
+%template(NewtonCGFloat) TNewtonCG<float>;
+typedef TNewtonCG<float> NewtonCGFloat;
@@ -0,0 +1,72 @@
+// License: BSD 3 clause
+
+%include "sto_solver.i"
+
+%{
+#include "tick/solver/path_solver.h"
+%}
+
+template <class T>
+class TPathSolver {
+ public:
+    TPathSolver(std::shared_ptr<TStoSolver<T, T> > solver,
+                std::shared_ptr<TProxSeparable<T, T> > prox,
+                unsigned long n_epochs = 10,
+                bool screening = true);
+
+    T get_strength_max();
+    void solve();
+    std::shared_ptr<SSparseArray2d<T> > get_path() const;
+    SArrayULongPtr get_n_active_features() const;
+    SArrayULongPtr get_n_kkt_violations() const;
+    void set_strengths(const Array<T> &strengths);
+    std::shared_ptr<SArray<T> > get_strengths() const;
+    unsigned long get_n_epochs() const;
+    void set_n_epochs(unsigned long n_epochs);
+    bool get_screening() const;
+    void set_screening(bool screening);
+};
+
+%rename(PathSolverDouble) TPathSolver<double>;
+class PathSolverDouble {
+ public:
+    PathSolverDouble(std::shared_ptr<TStoSolver<double, double> > solver,
+                     std::shared_ptr<TProxSeparable<double, double> > prox,
+                     unsigned long n_epochs = 10,
+                     bool screening = true);
+
+    double get_strength_max();
+    void solve();
+    SSparseArrayDouble2dPtr get_path() const;
+    SArrayULongPtr get_n_active_features() const;
+    SArrayULongPtr get_n_kkt_violations() const;
+    void set_strengths(const ArrayDouble &strengths);
+    SArrayDoublePtr get_strengths() const;
+    unsigned long get_n_epochs() const;
+    void set_n_epochs(unsigned long n_epochs);
+    bool get_screening() const;
+    void set_screening(bool screening);
+};
+typedef TPathSolver<double> PathSolverDouble;
+
+%rename(PathSolverFloat) TPathSolver<float>;
+class PathSolverFloat {
+ public:
+    PathSolverFloat(std::shared_ptr<TStoSolver<float, float> > solver,
+                    std::shared_ptr<TProxSeparable<float, float> > prox,
+                    unsigned long n_epochs = 10,
+                    bool screening = true);
+
+    float get_strength_max();
+    void solve();
+    SSparseArrayFloat2dPtr get_path() const;
+    SArrayULongPtr get_n_active_features() const;
+    SArrayULongPtr get_n_kkt_violations() const;
+    void set_strengths(const ArrayFloat &strengths);
+    SArrayFloatPtr get_strengths() const;
+    unsigned long get_n_epochs() const;
+    void set_n_epochs(unsigned long n_epochs);
+    bool get_screening() const;
+    void set_screening(bool screening);
+};
+typedef TPathSolver<float> PathSolverFloat;
@@ -0,0 +1,25 @@
+// License: BSD 3 clause
+
+%include "coordinate_descent.i"
+
+%{
+#include "tick/solver/prox_newton.h"
+%}
+
+template <class T>
+class TProxNewton : public TCoordinateDescent<T> {
+ public:
+    TProxNewton(
+      T tol = 0.,
+      RandType rand_type = RandType::cyclic,
+      unsigned long max_active_passes = 10,
+      int record_every = 1,
+      int seed = -1
+    );
+};
+
+%template(ProxNewtonDouble) TProxNewton<double>;
+typedef TProxNewton<double> ProxNewtonDouble;
+
+%template(ProxNewtonFloat) TProxNewton<float>;
+typedef TProxNewton<float> ProxNewtonFloat;
@@ -16,7 +16,8 @@ public:
          T tol = 0.,
          RandType rand_type = RandType::unif,
          int record_every = 1,
-         int seed = -1);
+         int seed = -1,
+         size_t n_threads = 1);
 
     void set_model(std::shared_ptr<TModel<T, K>> model);
     void reset();
@@ -24,6 +25,8 @@ public:
     void set_starting_iterate(Array<T> &dual_vector);
     T get_l_l2sq() const;
     void set_l_l2sq(T l_l2sq);
+    size_t get_n_threads() const;
+    void set_n_threads(size_t n_threads);
     std::shared_ptr<Array<T> > get_primal_vector();
     std::shared_ptr<Array<T> > get_dual_vector();
 
@@ -39,7 +42,8 @@ public:
          double tol = 0.,
          RandType rand_type = RandType::unif,
          int record_every = 1,
-         int seed = -1);
+         int seed = -1,
+         size_t n_threads = 1);
 
     void set_model(ModelDoublePtr model);
     void reset();
@@ -47,6 +51,8 @@ public:
     void set_starting_iterate(ArrayDouble &dual_vector);
     double get_l_l2sq() const;
     void set_l_l2sq(double l_l2sq);
+    size_t get_n_threads() const;
+    void set_n_threads(size_t n_threads);
     SArrayDoublePtr get_primal_vector();
     SArrayDoublePtr get_dual_vector();
 
@@ -64,7 +70,8 @@ public:
          float tol = 0.,
          RandType rand_type = RandType::unif,
          int record_every = 1,
-         int seed = -1);
+         int seed = -1,
+         size_t n_threads = 1);
 
     void set_model(ModelFloatPtr model);
     void reset();
@@ -72,6 +79,8 @@ public:
     void set_starting_iterate(ArrayFloat &dual_vector);
     float get_l_l2sq() const;
     void set_l_l2sq(float l_l2sq);
+    size_t get_n_threads() const;
+    void set_n_threads(size_t n_threads);
     SArrayFloatPtr get_primal_vector();
     SArrayFloatPtr get_dual_vector();
 
@@ -5,6 +5,63 @@
 %include tick/base/defs.i
 %include std_shared_ptr.i
 
+// Solvers are held by shared pointers so that they can be given to the
+// PathSolver
+%shared_ptr(TStoSolver<double, double>);
+%shared_ptr(TStoSolver<float, float>);
+%shared_ptr(StoSolverDouble);
+%shared_ptr(StoSolverFloat);
+
+%shared_ptr(TAdaGrad<double>);
+%shared_ptr(TAdaGrad<float>);
+%shared_ptr(AdaGradDouble);
+%shared_ptr(AdaGradFloat);
+
+%shared_ptr(TSDCA<double, double>);
+%shared_ptr(TSDCA<float, float>);
+%shared_ptr(SDCADouble);
+%shared_ptr(SDCAFloat);
+
+%shared_ptr(TSGD<double, double>);
+%shared_ptr(TSGD<float, float>);
+%shared_ptr(SGDDouble);
+%shared_ptr(SGDFloat);
+
+%shared_ptr(TSAGA<double>);
+%shared_ptr(TSAGA<float>);
+%shared_ptr(SAGADouble);
+%shared_ptr(SAGAFloat);
+
+%shared_ptr(AtomicSAGA<double>);
+%shared_ptr(AtomicSAGA<float>);
+%shared_ptr(AtomicSAGADouble);
+%shared_ptr(AtomicSAGAFloat);
+
+%shared_ptr(TSVRG<double, double>);
+%shared_ptr(TSVRG<float, float>);
+%shared_ptr(SVRGDouble);
+%shared_ptr(SVRGFloat);
+
+%shared_ptr(AtomicSVRG<double>);
+%shared_ptr(AtomicSVRG<float>);
+%shared_ptr(AtomicSVRGDouble);
+%shared_ptr(AtomicSVRGFloat);
+
+%shared_ptr(TCoordinateDescent<double>);
+%shared_ptr(TCoordinateDescent<float>);
+%shared_ptr(CoordinateDescentDouble);
+%shared_ptr(CoordinateDescentFloat);
+
+%shared_ptr(TProxNewton<double>);
+%shared_ptr(TProxNewton<float>);
+%shared_ptr(ProxNewtonDouble);
+%shared_ptr(ProxNewtonFloat);
+
+%shared_ptr(TNewtonCG<double>);
+%shared_ptr(TNewtonCG<float>);
+%shared_ptr(NewtonCGDouble);
+%shared_ptr(NewtonCGFloat);
+
 %{
 #include "tick/base/tick_python.h"
 %}
@@ -27,3 +84,10 @@
 %include saga.i
 %include asaga.i
 %include svrg.i
+%include asvrg.i
+
+%include coordinate_descent.i
+%include prox_newton.i
+%include newton_cg.i
+
+%include path_solver.i
@@ -20,7 +20,9 @@
 // Type of randomness used when sampling at random data points
 enum class RandType {
     unif = 0,
-    perm
+    perm,
+    importance,
+    cyclic
 };
 
 template <class T, class K = T>
@@ -43,16 +45,22 @@ class TStoSolver {
   inline T get_tol() const;
   inline void set_epoch_size(unsigned long epoch_size);
   inline unsigned long get_epoch_size() const;
+  virtual void set_batch_size(unsigned long batch_size);
+  inline unsigned long get_batch_size() const;
   inline void set_rand_type(RandType rand_type);
   inline RandType get_rand_type() const;
   inline void set_rand_max(unsigned long rand_max);
   inline unsigned long get_rand_max() const;
   inline int get_record_every() const;
   inline void set_record_every(int record_every);
+  inline unsigned long get_screening_every() const;
+  inline void set_screening_every(unsigned long screening_every);
 
   std::vector<double> get_time_history() const;
   std::vector<int> get_epoch_history() const;
   std::vector<double> get_objectives() const;
+  inline T get_screening_rate() const;
+  inline T get_duality_gap() const;
   void set_prev_obj(const double obj);
   void set_first_obj(const double obj);
   double get_first_obj() const;
@@ -84,16 +92,22 @@ class TStoSolver<double, double> {
   inline double get_tol() const;
   inline void set_epoch_size(unsigned long epoch_size);
   inline unsigned long get_epoch_size() const;
+  virtual void set_batch_size(unsigned long batch_size);
+  inline unsigned long get_batch_size() const;
   inline void set_rand_type(RandType rand_type);
   inline RandType get_rand_type() const;
   inline void set_rand_max(unsigned long rand_max);
   inline unsigned long get_rand_max() const;
   inline int get_record_every() const;
   inline void set_record_every(int record_every);
+  inline unsigned long get_screening_every() const;
+  inline void set_screening_every(unsigned long screening_every);
 
   std::vector<double> get_time_history() const;
   std::vector<int> get_epoch_history() const;
   std::vector<double> get_objectives() const;
+  inline double get_screening_rate() const;
+  inline double get_duality_gap() const;
   void set_prev_obj(const double obj);
   void set_first_obj(const double obj);
   double get_first_obj() const;
@@ -127,16 +141,22 @@ class TStoSolver<float, float> {
   inline float get_tol() const;
   inline void set_epoch_size(unsigned long epoch_size);
   inline unsigned long get_epoch_size() const;
+  virtual void set_batch_size(unsigned long batch_size);
+  inline unsigned long get_batch_size() const;
   inline void set_rand_type(RandType rand_type);
   inline RandType get_rand_type() const;
   inline void set_rand_max(unsigned long rand_max);
   inline unsigned long get_rand_max() const;
   inline int get_record_every() const;
   inline void set_record_every(int record_every);
+  inline unsigned long get_screening_every() const;
+  inline void set_screening_every(unsigned long screening_every);
 
   std::vector<double> get_time_history() const;
   std::vector<int> get_epoch_history() const;
   std::vector<double> get_objectives() const;
+  inline float get_screening_rate() const;
+  inline float get_duality_gap() const;
   void set_prev_obj(const double obj);
   void set_first_obj(const double obj);
   double get_first_obj() const;
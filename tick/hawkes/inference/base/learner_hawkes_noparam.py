@@ -1,5 +1,7 @@
 # License: BSD 3 clause
 
+from math import gcd
+
 import numpy as np
 
 from tick.solver.base import Solver
@@ -34,6 +36,10 @@ class LearnerHawkesNoParam(Solver):
     -----
     This class should be not used by end-users, it is intended for
     development only.
+
+    The C++ learner stores its per-event weights in the dtype of the given
+    timestamps: `float32` when all of them are `float32`, `float64`
+    otherwise. Its accumulations always run in double precision.
     """
 
     _attrinfos = {
@@ -52,6 +58,9 @@ class LearnerHawkesNoParam(Solver):
         },
         "_learner": {
             "writable": False
+        },
+        "dtype": {
+            "writable": False
         }
     }
 
@@ -69,10 +78,37 @@ class LearnerHawkesNoParam(Solver):
         self._end_times = None
         self._fitted = False
         self._learner = None
+        self._set('dtype', np.dtype('float64'))
 
     def _get_n_coeffs(self):
         return self._learner.get_n_coeffs()
 
+    def _get_check_every(self):
+        """Number of iterations between two convergence checks of the
+        iterations run in C++, every iteration recorded or printed is checked.
+        If 0, only the last iteration is checked
+        """
+        if self.max_iter < self.print_every and \
+                self.max_iter < self.record_every:
+            return 0
+        return gcd(self.print_every, self.record_every)
+
+    def _handle_fit_history(self, fit_history, names):
+        """Records and prints the iterations checked by a fit run in C++
+
+        Parameters
+        ----------
+        fit_history : `np.ndarray`, shape=(n_checks, 1 + len(names))
+            Iteration number followed by the recorded values of each
+            checked iteration, the last iteration run always being checked
+
+        names : `list` of `str`
+            Names under which the recorded values are stored in history
+        """
+        for k, row in enumerate(fit_history):
+            self._handle_history(int(row[0]), force=k + 1 == len(fit_history),
+                                 **dict(zip(names, row[1:])))
+
     def fit(self, events, end_times=None):
         """Set the corresponding realization(s) of the process.
 
@@ -111,6 +147,7 @@ class LearnerHawkesNoParam(Solver):
         """
         self._set("data", events)
 
+        self._set_learner_dtype(self._get_events_dtype(events))
         events, end_times = self._clean_events_and_endtimes(events)
 
         try:
@@ -118,9 +155,36 @@ class LearnerHawkesNoParam(Solver):
         except TypeError:
             self._learner.set_data(events)
 
+    def _construct_learner(self, dtype):
+        """Build the C++ learner of the given dtype with the current
+        parameters of this learner
+        """
+        raise NotImplementedError
+
+    def _set_learner_dtype(self, dtype):
+        """Swap the C++ learner for one storing its weights in dtype
+        """
+        dtype = np.dtype(dtype)
+        if dtype != self.dtype:
+            self._set('_learner', self._construct_learner(dtype))
+            self._set('dtype', dtype)
+
+    @staticmethod
+    def _get_events_dtype(events):
+        if len(events[0]) == 0 or not isinstance(events[0][0], np.ndarray):
+            events = [events]
+        dtypes = {np.asarray(timestamps).dtype
+                  for realization in events for timestamps in realization}
+        if dtypes == {np.dtype('float32')}:
+            return np.dtype('float32')
+        return np.dtype('float64')
+
     def _clean_events_and_endtimes(self, events):
         if len(events[0]) == 0 or not isinstance(events[0][0], np.ndarray):
             events = [events]
+        events = [[np.ascontiguousarray(timestamps, dtype=float)
+                   for timestamps in realization]
+                  for realization in events]
 
         end_times = self._end_times
         if end_times is None:
@@ -6,9 +6,15 @@ from tick.hawkes import ModelHawkesExpKernLogLik, SimuHawkesExpKernels
 from tick.hawkes.inference.base import LearnerHawkesNoParam
 from tick.hawkes.inference.build.hawkes_inference import (HawkesADM4 as
                                                           _HawkesADM4)
+from tick.hawkes.inference.build.hawkes_inference import (HawkesADM4Float as
+                                                          _HawkesADM4Float)
 from tick.prox import ProxNuclear
 from tick.prox.prox_l1 import ProxL1
-from tick.solver.base.utils import relative_distance
+
+dtype_class_mapper = {
+    np.dtype('float32'): _HawkesADM4Float,
+    np.dtype('float64'): _HawkesADM4
+}
 
 
 class HawkesADM4(LearnerHawkesNoParam):
@@ -110,6 +116,17 @@ class HawkesADM4(LearnerHawkesNoParam):
         If None, it will be set given a heuristic which look at last
         relative difference obtained in the main loop.
 
+    weights_threshold : `float`, default=0
+        Kernel values below this threshold are dropped from the weights
+        used by the inner em algorithm, which keeps them sparse on large
+        networks. If 0, weights are exact.
+
+    max_rank : `int`, default=None
+        If given, the nuclear norm proximal step is computed from a
+        truncated randomized SVD of this rank instead of a full SVD. The
+        low rank component is always stored through its factors and the
+        sparse component as a sparse matrix.
+
     Attributes
     ----------
     n_nodes : `int`
@@ -142,6 +159,9 @@ class HawkesADM4(LearnerHawkesNoParam):
         "rho": {
             "cpp_setter": "set_rho"
         },
+        "weights_threshold": {
+            "cpp_setter": "set_weights_threshold"
+        },
         "_C": {
             "writable": False
         },
@@ -168,7 +188,7 @@ class HawkesADM4(LearnerHawkesNoParam):
     def __init__(self, decay, C=1e3, lasso_nuclear_ratio=0.5, max_iter=50,
                  tol=1e-5, n_threads=1, verbose=False, print_every=10,
                  record_every=10, rho=.1, approx=0, em_max_iter=30,
-                 em_tol=None):
+                 em_tol=None, weights_threshold=0., max_rank=None):
 
         LearnerHawkesNoParam.__init__(
             self, verbose=verbose, max_iter=max_iter, print_every=print_every,
@@ -192,6 +212,8 @@ class HawkesADM4(LearnerHawkesNoParam):
         self.em_tol = em_tol
 
         self._learner = _HawkesADM4(decay, rho, n_threads, approx)
+        self.weights_threshold = weights_threshold
+        self.max_rank = max_rank
 
         # TODO add approx to model
         self._model = ModelHawkesExpKernLogLik(self.decay,
@@ -253,6 +275,12 @@ class HawkesADM4(LearnerHawkesNoParam):
         self._model.fit(events, end_times=end_times)
         self._prox_nuclear.n_rows = self.n_nodes
 
+    def _construct_learner(self, dtype):
+        learner = dtype_class_mapper[dtype](self.decay, self.rho,
+                                            self.n_threads, self.approx)
+        learner.set_weights_threshold(self.weights_threshold)
+        return learner
+
     def _solve(self, baseline_start=None, adjacency_start=None):
         """Perform one iteration of the algorithm
 
@@ -278,72 +306,25 @@ class HawkesADM4(LearnerHawkesNoParam):
                                                 (self.n_nodes, self.n_nodes))
         self._set('adjacency', adjacency_start.copy())
 
-        z1 = np.zeros_like(self.adjacency)
-        z2 = np.zeros_like(self.adjacency)
-        u1 = np.zeros_like(self.adjacency)
-        u2 = np.zeros_like(self.adjacency)
-
         if self.rho <= 0:
             raise ValueError("The parameter rho equals {}, while it should "
                              "be strictly positive.".format(self.rho))
 
-        max_relative_distance = 1e-1
-        for i in range(self.max_iter):
-
-            if self._should_record_iter(i):
-                prev_objective = self.objective(self.coeffs)
-                prev_baseline = self.baseline.copy()
-                prev_adjacency = self.adjacency.copy()
-
-            for _ in range(self.em_max_iter):
-                inner_prev_baseline = self.baseline.copy()
-                inner_prev_adjacency = self.adjacency.copy()
-                self._learner.solve(self.baseline, self.adjacency, z1, z2, u1,
-                                    u2)
-                inner_rel_baseline = relative_distance(self.baseline,
-                                                       inner_prev_baseline)
-                inner_rel_adjacency = relative_distance(
-                    self.adjacency, inner_prev_adjacency)
-
-                if self.em_tol is None:
-                    inner_tol = max_relative_distance * 1e-2
-                else:
-                    inner_tol = self.em_tol
-
-                if max(inner_rel_baseline, inner_rel_adjacency) < inner_tol:
-                    break
-
-            z1 = self._prox_nuclear.call(np.ravel(self.adjacency + u1),
-                                         step=1. / self.rho) \
-                .reshape(self.n_nodes, self.n_nodes)
-            z2 = self._prox_l1.call(np.ravel(self.adjacency + u2),
-                                    step=1. / self.rho) \
-                .reshape(self.n_nodes, self.n_nodes)
-
-            u1 += self.adjacency - z1
-            u2 += self.adjacency - z2
-
-            if self._should_record_iter(i):
-                objective = self.objective(self.coeffs)
-
-                rel_obj = abs(objective - prev_objective) / abs(prev_objective)
-                rel_baseline = relative_distance(self.baseline, prev_baseline)
-                rel_adjacency = relative_distance(self.adjacency,
-                                                  prev_adjacency)
-
-                max_relative_distance = max(rel_baseline, rel_adjacency)
-                # We perform at least 5 iterations as at start we sometimes
-                # reach a low tolerance if inner_tol is too low
-                converged = max_relative_distance <= self.tol and i > 5
-                force_print = (i + 1 == self.max_iter) or converged
-
-                self._handle_history(i + 1, obj=objective, rel_obj=rel_obj,
-                                     rel_baseline=rel_baseline,
-                                     rel_adjacency=rel_adjacency,
-                                     force=force_print)
-
-                if converged:
-                    break
+        # The iterations are run in C++, where the low rank and sparse
+        # components are kept as factors and as a sparse matrix. Without
+        # max_rank all singular values are kept, which is the full nuclear
+        # proximal operator
+        max_rank = self.n_nodes if self.max_rank is None else self.max_rank
+        self._learner.set_max_rank(max_rank)
+        # A negative em_tol lets it adapt the tolerance of the EM steps to the
+        # last relative change
+        em_tol = -1. if self.em_tol is None else self.em_tol
+        self._learner.fit(self.baseline, self.adjacency, self.strength_lasso,
+                          self.strength_nuclear, self.max_iter, self.tol,
+                          self.em_max_iter, em_tol, self._get_check_every())
+
+        self._handle_fit_history(self._learner.get_fit_history(),
+                                 ['rel_baseline', 'rel_adjacency'])
 
     def objective(self, coeffs, loss: float = None):
         """Compute the objective minimized by the learner at `coeffs`
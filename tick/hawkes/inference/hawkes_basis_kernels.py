@@ -5,7 +5,13 @@ import numpy as np
 from tick.hawkes.inference.base import LearnerHawkesNoParam
 from tick.hawkes.inference.build.hawkes_inference import (HawkesBasisKernels as
                                                           _HawkesBasisKernels)
-from tick.solver.base.utils import relative_distance
+from tick.hawkes.inference.build.hawkes_inference import (
+    HawkesBasisKernelsFloat as _HawkesBasisKernelsFloat)
+
+dtype_class_mapper = {
+    np.dtype('float32'): _HawkesBasisKernelsFloat,
+    np.dtype('float64'): _HawkesBasisKernels
+}
 
 
 class HawkesBasisKernels(LearnerHawkesNoParam):
@@ -208,6 +214,11 @@ class HawkesBasisKernels(LearnerHawkesNoParam):
                    basis_kernels_start=basis_kernels_start)
         return self
 
+    def _construct_learner(self, dtype):
+        return dtype_class_mapper[dtype](self.kernel_support, self.kernel_size,
+                                         self.n_basis, 1. / self.C,
+                                         self.n_threads)
+
     def _solve(self, baseline_start=None, amplitudes_start=None,
                basis_kernels_start=None):
         """Perform nonparametric estimation
@@ -253,34 +264,14 @@ class HawkesBasisKernels(LearnerHawkesNoParam):
             self.amplitudes.reshape((self.n_nodes,
                                      self.n_nodes * self.n_basis)))
 
-        for i in range(self.max_iter):
-            if self._should_record_iter(i):
-                prev_baseline = self.baseline.copy()
-                prev_amplitudes = self.amplitudes.copy()
-                prev_basis_kernels = self.basis_kernels.copy()
-
-            rel_ode = self._learner.solve(self.baseline, self.basis_kernels,
-                                          self._amplitudes_2d,
-                                          self.ode_max_iter, self.ode_tol)
-
-            if self._should_record_iter(i):
-                rel_baseline = relative_distance(self.baseline, prev_baseline)
-                rel_amplitudes = relative_distance(self.amplitudes,
-                                                   prev_amplitudes)
-                rel_basis_kernels = relative_distance(self.basis_kernels,
-                                                      prev_basis_kernels)
-
-                converged = max(rel_baseline, rel_amplitudes,
-                                rel_basis_kernels) <= self.tol
-                force_print = (i + 1 == self.max_iter) or converged
-
-                self._handle_history(i + 1, rel_baseline=rel_baseline,
-                                     rel_amplitudes=rel_amplitudes,
-                                     rel_basis_kernels=rel_basis_kernels,
-                                     rel_ode=rel_ode, force=force_print)
-
-                if converged:
-                    break
+        self._learner.fit(self.baseline, self.basis_kernels,
+                          self._amplitudes_2d, self.max_iter, self.tol,
+                          self.ode_max_iter, self.ode_tol,
+                          self._get_check_every())
+
+        self._handle_fit_history(self._learner.get_fit_history(), [
+            'rel_baseline', 'rel_amplitudes', 'rel_basis_kernels', 'rel_ode'
+        ])
 
     def get_kernel_supports(self):
         return np.zeros((self.n_nodes, self.n_nodes)) + self.kernel_support
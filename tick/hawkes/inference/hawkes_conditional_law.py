@@ -8,8 +8,9 @@ import numpy as np
 from numpy.polynomial.legendre import leggauss
 from scipy.linalg import solve
 
-from tick.base import Base, ThreadPool
-from tick.hawkes.inference.build.hawkes_inference import (PointProcessCondLaw)
+from tick.base import Base
+from tick.hawkes.inference.build.hawkes_inference import (
+    PointProcessCondLawBatch)
 
 
 # noinspection PyPep8Naming
@@ -155,9 +156,6 @@ class HawkesConditionalLaw(Base):
     _attrinfos = {
         '_hawkes_object': {},
         '_lags': {},
-        '_lock': {
-            'writable': False
-        },
         '_phi_ijl': {},
         '_norm_ijl': {},
         '_ijl2index': {},
@@ -224,7 +222,6 @@ class HawkesConditionalLaw(Base):
         # Represents the conditional laws written above without conditioning by
         # the mark (so a i,j list)
         self._claw1 = None
-        self._lock = None
 
         # quad_x : `np.ndarray`, shape=(n_quad, )
         # The abscissa of the quadrature points used for the Fredholm system
@@ -580,21 +577,9 @@ class HawkesConditionalLaw(Base):
             self._n_events[0, i] += good
             self._n_events[1, i] += bad
 
-        # We might want to use threads, since this is the time consuming part
-        with_multi_processing = self.n_threads > 1
-        if with_multi_processing:
-            pool = ThreadPool(with_lock=True, max_threads=self.n_threads)
-            self._set('_lock', pool.lock)
-
-        for index, (i, j, l) in enumerate(self._index2ijl):
-            if with_multi_processing:
-                pool.add_work(self._PointProcessCondLaw, realization, index, i,
-                              j, l, T)
-            else:
-                self._PointProcessCondLaw(realization, index, i, j, l, T)
-
-        if with_multi_processing:
-            pool.start()
+        # This is the time consuming part, all (i, j, l) triplets are computed
+        # at once in C++, using several threads
+        self._PointProcessCondLawBatch(realization, T)
 
         # Here we compute the G^ij (not conditioned to l)
         # It is recomputed each time
@@ -652,41 +637,41 @@ class HawkesConditionalLaw(Base):
                 self._claw[index1] = t
                 self._claw[index2] = t
 
-        # We can remove the thread lock (lock disallows pickling)
-        self._set('_lock', None)
-
         if compute:
             self.compute()
 
-    def _PointProcessCondLaw(self, realization, index, i, j, l, T):
+    def _PointProcessCondLawBatch(self, realization, T):
+        n_index = len(self._index2ijl)
+        y_nodes = np.array([i for (i, j, l) in self._index2ijl],
+                           dtype='uint64')
+        z_nodes = np.array([j for (i, j, l) in self._index2ijl],
+                           dtype='uint64')
+        zmins = np.array([self.marked_components[j][l][0]
+                          for (i, j, l) in self._index2ijl], dtype=float)
+        zmaxs = np.array([self.marked_components[j][l][1]
+                          for (i, j, l) in self._index2ijl], dtype=float)
+
+        timestamps = [np.ascontiguousarray(r[0], dtype=float)
+                      for r in realization]
+        marks = [np.ascontiguousarray(r[1], dtype=float) for r in realization]
 
         claw_X = np.zeros(len(self._lags) - 1)
-        claw_Y = np.zeros(len(self._lags) - 1)
-
-        lambda_i = len(realization[i][0]) / T
+        claw_Y = np.zeros((n_index, len(self._lags) - 1))
 
-        PointProcessCondLaw(
-            realization[i][0], realization[j][0], realization[j][1],
-            self._lags, self.marked_components[j][l][0],
-            self.marked_components[j][l][1], T, lambda_i, claw_X, claw_Y)
+        PointProcessCondLawBatch(timestamps, marks, self._lags, y_nodes,
+                                 z_nodes, zmins, zmaxs, T, claw_X, claw_Y,
+                                 self.n_threads)
 
         self._claw_X = claw_X
 
-        # TODO: this lock acquire is very expensive here
-        if self.n_threads > 1:
-            self._lock.acquire()
-
         # Update claw
-        if self.n_realizations == 0:
-            self._claw[index] = claw_Y
-        else:
-            self._claw[index] *= self.n_realizations
-            self._claw[index] += claw_Y
-            self._claw[index] /= self.n_realizations + 1
-
-        # Unlock
-        if self.n_threads > 1:
-            self._lock.release()
+        for index in range(n_index):
+            if self.n_realizations == 0:
+                self._claw[index] = claw_Y[index]
+            else:
+                self._claw[index] *= self.n_realizations
+                self._claw[index] += claw_Y[index]
+                self._claw[index] /= self.n_realizations + 1
 
     def _compute_lags(self):
         """Computes the lags at which the claw will be computed
@@ -1,4 +1,3 @@
-from itertools import product
 
 import numpy as np
 import scipy
@@ -8,6 +7,13 @@ from tick.base import Base
 from tick.hawkes.inference.base import LearnerHawkesNoParam
 from tick.hawkes.inference.build.hawkes_inference import (HawkesCumulant as
                                                           _HawkesCumulant)
+from tick.hawkes.inference.build.hawkes_inference import (
+    HawkesCumulantFloat as _HawkesCumulantFloat)
+
+dtype_class_mapper = {
+    np.dtype('float32'): _HawkesCumulantFloat,
+    np.dtype('float64'): _HawkesCumulant
+}
 
 # Tensorflow is not a project requirement but is needed for this class
 try:
@@ -71,6 +77,13 @@ class HawkesCumulantMatching(LearnerHawkesNoParam):
         Record history information when ``n_iter`` (iteration number) is
         a multiple of ``record_every``
 
+    n_threads : `int`, default=1
+        Number of threads used to compute the cumulants, work is shared by
+        realization and node.
+
+        * if `int <= 0`: the number of physical cores available on the CPU
+        * otherwise the desired number of threads
+
     elastic_net_ratio : `float`, default=0.95
         Ratio of elastic net mixing parameter with 0 <= ratio <= 1.
 
@@ -156,7 +169,8 @@ class HawkesCumulantMatching(LearnerHawkesNoParam):
     def __init__(self, integration_support, C=1e3, penalty='none',
                  solver='adam', step=1e-2, tol=1e-8, max_iter=1000,
                  verbose=False, print_every=100, record_every=10,
-                 solver_kwargs=None, cs_ratio=None, elastic_net_ratio=0.95):
+                 solver_kwargs=None, cs_ratio=None, elastic_net_ratio=0.95,
+                 n_threads=1):
         try:
             import tensorflow
         except ImportError:
@@ -167,7 +181,8 @@ class HawkesCumulantMatching(LearnerHawkesNoParam):
 
         LearnerHawkesNoParam.__init__(
             self, tol=tol, verbose=verbose, max_iter=max_iter,
-            print_every=print_every, record_every=record_every)
+            print_every=print_every, record_every=record_every,
+            n_threads=n_threads)
 
         self._elastic_net_ratio = None
         self.C = C
@@ -180,7 +195,7 @@ class HawkesCumulantMatching(LearnerHawkesNoParam):
             self.solver_kwargs = {}
 
         self._cumulant_computer = _HawkesCumulantComputer(
-            integration_support=integration_support)
+            integration_support=integration_support, n_threads=n_threads)
         self._learner = self._cumulant_computer._learner
         self._solver = solver
         self._tf_feed_dict = None
@@ -364,6 +379,15 @@ class HawkesCumulantMatching(LearnerHawkesNoParam):
         LearnerHawkesNoParam.fit(self, events, end_times=end_times)
         self.solve(adjacency_start=adjacency_start, R_start=R_start)
 
+    def _construct_learner(self, dtype):
+        return dtype_class_mapper[dtype](
+            self._cumulant_computer.integration_support, self.n_threads)
+
+    def _set_learner_dtype(self, dtype):
+        LearnerHawkesNoParam._set_learner_dtype(self, dtype)
+        # The cumulant computer shares the C++ learner
+        self._cumulant_computer._set('_learner', self._learner)
+
     def _solve(self, adjacency_start=None, R_start=None):
         """Launch optimization algorithm
 
@@ -568,22 +592,18 @@ class _HawkesCumulantComputer(Base):
         'L': {},
         'C': {},
         'K_c': {},
-        '_L_day': {},
-        '_J': {},
         '_events_of_cumulants': {},
     }
 
-    def __init__(self, integration_support=100.):
+    def __init__(self, integration_support=100., n_threads=1):
         Base.__init__(self)
         self.integration_support = integration_support
-        self._learner = _HawkesCumulant(self.integration_support)
+        self._learner = _HawkesCumulant(self.integration_support, n_threads)
 
         self.L = None
         self.C = None
         self.K_c = None
 
-        self._L_day = None
-        self._J = None
         self._events_of_cumulants = None
 
     def compute_cumulants(self, verbose=False, force=False):
@@ -610,11 +630,10 @@ class _HawkesCumulantComputer(Base):
 
         # Remember for which realizations cumulants have been computed
         self._events_of_cumulants = self.realizations
-        self.compute_L()
-        self.compute_C_and_J()
-        self.K_c = self.compute_E_c()
-
-        self._learner.set_are_cumulants_ready(True)
+        self._learner.compute_cumulants()
+        self.L = self._learner.get_mean_intensity()
+        self.C = self._learner.get_covariance()
+        self.K_c = self._learner.get_skewness()
 
     @staticmethod
     def _same_realizations(events_1, events_2):
@@ -632,60 +651,6 @@ class _HawkesCumulantComputer(Base):
                     return False
         return True
 
-    def compute_L(self):
-        self._L_day = np.zeros((self.n_realizations, self.n_nodes))
-
-        for day, realization in enumerate(self.realizations):
-            for i in range(self.n_nodes):
-                process = realization[i]
-                self._L_day[day][i] = len(process) / self.end_times[day]
-
-        self.L = np.mean(self._L_day, axis=0)
-
-    def compute_C_and_J(self):
-        self.C = np.zeros((self.n_nodes, self.n_nodes))
-        self._J = np.zeros((self.n_realizations, self.n_nodes, self.n_nodes))
-
-        d = self.n_nodes
-        for day in range(len(self.realizations)):
-            C = np.zeros((d, d))
-            J = np.zeros((d, d))
-            for i, j in product(range(d), repeat=2):
-                res = self._learner.compute_A_and_I_ij(day, i, j,
-                                                       self._L_day[day][j])
-                C[i, j] = res[0]
-                J[i, j] = res[1]
-            # we keep the symmetric part to remove edge effects
-            C[:] = 0.5 * (C + C.T)
-            J[:] = 0.5 * (J + J.T)
-            self.C += C / self.n_realizations
-            self._J[day] = J.copy()
-
-    def compute_E_c(self):
-        E_c = np.zeros((self.n_nodes, self.n_nodes, 2))
-
-        d = self.n_nodes
-
-        for day in range(len(self.realizations)):
-            for i in range(d):
-                for j in range(d):
-                    E_c[i, j, 0] += self._learner.compute_E_ijk(
-                        day, i, j, j, self._L_day[day][i], self._L_day[day][j],
-                        self._J[day][i, j])
-
-                    E_c[i, j, 1] += self._learner.compute_E_ijk(
-                        day, j, j, i, self._L_day[day][j], self._L_day[day][j],
-                        self._J[day][j, j])
-
-        E_c /= self.n_realizations
-
-        K_c = np.zeros((self.n_nodes, self.n_nodes))
-        K_c += 2 * E_c[:, :, 0]
-        K_c += E_c[:, :, 1]
-        K_c /= 3.
-
-        return K_c
-
     @property
     def n_nodes(self):
         return self._learner.get_n_nodes()
@@ -5,7 +5,13 @@ import numpy as np
 from tick.hawkes.inference.base import LearnerHawkesNoParam
 from tick.hawkes.inference.build.hawkes_inference import (HawkesEM as
                                                           _HawkesEM)
-from tick.solver.base.utils import relative_distance
+from tick.hawkes.inference.build.hawkes_inference import (HawkesEMFloat as
+                                                          _HawkesEMFloat)
+
+dtype_class_mapper = {
+    np.dtype('float32'): _HawkesEMFloat,
+    np.dtype('float64'): _HawkesEM
+}
 
 
 class HawkesEM(LearnerHawkesNoParam):
@@ -64,6 +70,11 @@ class HawkesEM(LearnerHawkesNoParam):
         * if `int <= 0`: the number of physical cores available on the CPU
         * otherwise the desired number of threads
 
+    n_starts : `int`, default=1
+        Number of starting points, run in parallel. The first one is given by
+        `baseline_start` and `kernel_start`, the others are random. The fit
+        reaching the highest log-likelihood is kept, along with its history
+
     Attributes
     ----------
     n_nodes : `int`
@@ -90,15 +101,24 @@ class HawkesEM(LearnerHawkesNoParam):
     .. _preprint, 1-16: http://paleo.sscnet.ucla.edu/Lewis-Molher-EM_Preprint.pdf
     """
 
+    _attrinfos = {
+        "_explicit_discretization": {
+            "writable": False
+        }
+    }
+
     def __init__(self, kernel_support=None, kernel_size=10,
                  kernel_discretization=None, tol=1e-5, max_iter=100,
-                 print_every=10, record_every=10, verbose=False, n_threads=1):
+                 print_every=10, record_every=10, verbose=False, n_threads=1,
+                 n_starts=1):
 
         LearnerHawkesNoParam.__init__(
             self, n_threads=n_threads, verbose=verbose, tol=tol,
             max_iter=max_iter, print_every=print_every,
             record_every=record_every)
 
+        self._set('_explicit_discretization',
+                  kernel_discretization is not None)
         if kernel_discretization is not None:
             self._learner = _HawkesEM(kernel_discretization, n_threads)
         elif kernel_support is not None:
@@ -107,6 +127,7 @@ class HawkesEM(LearnerHawkesNoParam):
             raise ValueError('Either kernel support or kernel discretization '
                              'must be provided')
 
+        self.n_starts = n_starts
         self.baseline = None
         self.kernel = None
 
@@ -158,42 +179,40 @@ class HawkesEM(LearnerHawkesNoParam):
             Used to force start values for kernel parameter
             If `None` starts with random values
         """
+        if self.n_starts < 1:
+            raise ValueError('n_starts must be positive, '
+                             'received {}'.format(self.n_starts))
+
+        kernel_shape = (self.n_nodes, self.n_nodes, self.kernel_size)
+        kernels_starts = np.empty((self.n_starts, ) + kernel_shape)
         if kernel_start is None:
-            self.kernel = 0.1 * np.random.uniform(
-                size=(self.n_nodes, self.n_nodes, self.kernel_size))
+            kernels_starts[:] = 0.1 * np.random.uniform(
+                size=kernels_starts.shape)
         else:
-            if kernel_start.shape != (self.n_nodes, self.n_nodes,
-                                      self.kernel_size):
-                raise ValueError(
-                    'kernel_start has shape {} but should have '
-                    'shape {}'.format(
-                        kernel_start.shape,
-                        (self.n_nodes, self.n_nodes, self.kernel_size)))
-            self.kernel = kernel_start.copy()
-
-        if baseline_start is None:
-            self.baseline = np.zeros(self.n_nodes) + 1
-        else:
-            self.baseline = baseline_start.copy()
-
-        for i in range(self.max_iter):
-            if self._should_record_iter(i):
-                prev_baseline = self.baseline.copy()
-                prev_kernel = self.kernel.copy()
-
-            self._learner.solve(self.baseline, self._flat_kernels)
-
-            if self._should_record_iter(i):
-                rel_baseline = relative_distance(self.baseline, prev_baseline)
-                rel_kernel = relative_distance(self.kernel, prev_kernel)
-
-                converged = max(rel_baseline, rel_kernel) <= self.tol
-                force_print = (i + 1 == self.max_iter) or converged
-                self._handle_history(i, rel_baseline=rel_baseline,
-                                     rel_kernel=rel_kernel, force=force_print)
-
-                if converged:
-                    break
+            if kernel_start.shape != kernel_shape:
+                raise ValueError('kernel_start has shape {} but should have '
+                                 'shape {}'.format(kernel_start.shape,
+                                                   kernel_shape))
+            kernels_starts[0] = kernel_start
+            kernels_starts[1:] = 0.1 * np.random.uniform(
+                size=kernels_starts[1:].shape)
+
+        baselines_starts = np.ones((self.n_starts, self.n_nodes))
+        if baseline_start is not None:
+            baselines_starts[0] = baseline_start
+
+        kernels_starts = kernels_starts.reshape(
+            (self.n_starts, self.n_nodes * self.n_nodes * self.kernel_size))
+        best_start = self._learner.fit(baselines_starts, kernels_starts,
+                                       self.max_iter, self.tol,
+                                       self._get_check_every())
+
+        self.baseline = baselines_starts[best_start].copy()
+        self.kernel = kernels_starts[best_start].reshape(kernel_shape)
+
+        self._handle_fit_history(
+            self._learner.get_fit_history(best_start),
+            ['rel_baseline', 'rel_kernel', 'llh'])
 
     def get_kernel_supports(self):
         """Computes kernel support. This makes our learner compliant with
@@ -251,6 +270,44 @@ class HawkesEM(LearnerHawkesNoParam):
         """
         return self._learner.get_kernel_norms(self._flat_kernels)
 
+    def get_residuals(self, baseline=None, kernel=None):
+        """Computes the residuals of the estimated process on the fitted
+        events, to check the goodness of fit with the time rescaling
+        theorem. The residual of an event is the integral of the intensity
+        of its node since the previous event of this node. As the kernels are
+        piecewise constant on `kernel_discretization`, it is computed
+        exactly. If the estimated process is the right one, residuals are
+        i.i.d. exponential random variables of mean 1
+
+        Parameters
+        ----------
+        baseline : `np.ndarray`, shape=(n_nodes, ), default = None
+            Baseline vector for which the residuals are computed
+            If `None` baseline obtained during fitting is used
+
+        kernel : `None` or `np.ndarray`, shape=(n_nodes, n_nodes, kernel_size), default=None
+            Kernels for which the residuals are computed
+            If `None` kernel obtained during fitting is used
+
+        Returns
+        -------
+        residuals : `list` of `list` of `np.ndarray`
+            `residuals[r][i]` holds the residuals of the events of node i of
+            realization r
+        """
+        if not self._fitted:
+            raise ValueError('You must call `fit` before `get_residuals`')
+
+        if baseline is None:
+            baseline = self.baseline
+
+        if kernel is None:
+            kernel = self.kernel
+
+        flat_kernels = kernel.reshape((self.n_nodes,
+                                       self.n_nodes * self.kernel_size))
+        return self._learner.get_residuals(baseline, flat_kernels)
+
     def objective(self, coeffs, loss: float = None):
         raise NotImplementedError()
 
@@ -311,6 +368,17 @@ class HawkesEM(LearnerHawkesNoParam):
 
         return learner._learner.loglikelihood(baseline, flat_kernels)
 
+    def _construct_learner(self, dtype):
+        learner_class = dtype_class_mapper[dtype]
+        if self._explicit_discretization:
+            learner = learner_class(self.kernel_discretization,
+                                    self.n_threads)
+        else:
+            learner = learner_class(self.kernel_support, self.kernel_size,
+                                    self.n_threads)
+        learner.set_fft_binning(self._learner.get_fft_binning())
+        return learner
+
     def get_params(self):
         return {
             'kernel_support': self.kernel_support,
@@ -321,7 +389,8 @@ class HawkesEM(LearnerHawkesNoParam):
             'print_every': self.print_every,
             'record_every': self.record_every,
             'verbose': self.verbose,
-            'n_threads': self.n_threads
+            'n_threads': self.n_threads,
+            'n_starts': self.n_starts
         }
 
     @property
@@ -7,7 +7,13 @@ from scipy.stats import norm
 from tick.hawkes.inference.base import LearnerHawkesNoParam
 from tick.hawkes.inference.build.hawkes_inference import (HawkesSumGaussians as
                                                           _HawkesSumGaussians)
-from tick.solver.base.utils import relative_distance
+from tick.hawkes.inference.build.hawkes_inference import (
+    HawkesSumGaussiansFloat as _HawkesSumGaussiansFloat)
+
+dtype_class_mapper = {
+    np.dtype('float32'): _HawkesSumGaussiansFloat,
+    np.dtype('float64'): _HawkesSumGaussians
+}
 
 
 class HawkesSumGaussians(LearnerHawkesNoParam):
@@ -114,6 +120,12 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
         will stop.
         If None, it will be set given a heuristic which look at last
 
+    n_std_truncation : `float`, default=0
+        Number of standard deviations after which gaussian basis functions
+        are considered null. If positive, weights are only computed for
+        nearby basis functions, using precomputed lookup tables. If 0,
+        gaussian basis functions are evaluated exactly.
+
     Attributes
     ----------
     n_nodes : `int`
@@ -158,6 +170,9 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
         "step_size": {
             "cpp_setter": "set_step_size"
         },
+        "n_std_truncation": {
+            "cpp_setter": "set_n_std_truncation"
+        },
         "baseline": {
             "writable": False
         },
@@ -172,7 +187,7 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
     def __init__(self, max_mean_gaussian, n_gaussians=5, step_size=1e-7, C=1e3,
                  lasso_grouplasso_ratio=0.5, max_iter=50, tol=1e-5,
                  n_threads=1, verbose=False, print_every=10, record_every=10,
-                 approx=0, em_max_iter=30, em_tol=None):
+                 approx=0, em_max_iter=30, em_tol=None, n_std_truncation=0.):
 
         LearnerHawkesNoParam.__init__(
             self, verbose=verbose, max_iter=max_iter, print_every=print_every,
@@ -193,6 +208,7 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
         self._learner = _HawkesSumGaussians(
             n_gaussians, max_mean_gaussian, step_size, strength_lasso,
             strength_grouplasso, em_max_iter, n_threads, approx)
+        self.n_std_truncation = n_std_truncation
 
         self.verbose = verbose
 
@@ -232,6 +248,14 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
                    amplitudes_start=amplitudes_start)
         return self
 
+    def _construct_learner(self, dtype):
+        learner = dtype_class_mapper[dtype](
+            self.n_gaussians, self.max_mean_gaussian, self.step_size,
+            self.strength_lasso, self.strength_grouplasso, self.em_max_iter,
+            self.n_threads, self.approx)
+        learner.set_n_std_truncation(self.n_std_truncation)
+        return learner
+
     def _solve(self, baseline_start=None, amplitudes_start=None):
         """Perform one iteration of the algorithm
 
@@ -269,47 +293,14 @@ class HawkesSumGaussians(LearnerHawkesNoParam):
         _amplitudes_2d = self.amplitudes.reshape(
             (self.n_nodes, self.n_nodes * self.n_gaussians))
 
-        max_relative_distance = 1e-1
-        for i in range(self.max_iter):
-            if self._should_record_iter(i):
-                prev_baseline = self.baseline.copy()
-                prev_amplitudes = self.amplitudes.copy()
-
-                inner_prev_baseline = self.baseline.copy()
-                inner_prev_amplitudes = self.amplitudes.copy()
-
-            self._learner.solve(self.baseline, _amplitudes_2d)
-
-            if self._should_record_iter(i):
-                inner_rel_baseline = relative_distance(self.baseline,
-                                                       inner_prev_baseline)
-                inner_rel_adjacency = relative_distance(
-                    self.amplitudes, inner_prev_amplitudes)
-
-                if self.em_tol is None:
-                    inner_tol = max_relative_distance * 1e-2
-                else:
-                    inner_tol = self.em_tol
-
-                if max(inner_rel_baseline, inner_rel_adjacency) < inner_tol:
-                    break
-
-                rel_baseline = relative_distance(self.baseline, prev_baseline)
-                rel_amplitudes = relative_distance(self.amplitudes,
-                                                   prev_amplitudes)
-
-                max_relative_distance = max(rel_baseline, rel_amplitudes)
-                # We perform at least 5 iterations as at start we sometimes
-                # reach a low tolerance if inner_tol is too low
-                converged = max_relative_distance <= self.tol and i > 5
-                force_print = (i + 1 == self.max_iter) or converged
-
-                self._handle_history(i + 1, rel_baseline=rel_baseline,
-                                     rel_amplitudes=rel_amplitudes,
-                                     force=force_print)
+        # The iterations are run in C++, a negative em_tol lets it adapt the
+        # tolerance of the EM steps to the last relative change
+        em_tol = -1. if self.em_tol is None else self.em_tol
+        self._learner.fit(self.baseline, _amplitudes_2d, self.max_iter,
+                          self.tol, em_tol, self._get_check_every())
 
-                if converged:
-                    break
+        self._handle_fit_history(self._learner.get_fit_history(),
+                                 ['rel_baseline', 'rel_amplitudes'])
 
     @property
     def C(self):
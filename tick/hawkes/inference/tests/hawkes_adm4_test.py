@@ -86,6 +86,33 @@ class Test(unittest.TestCase):
         np.testing.assert_array_almost_equal(learner.adjacency, adjacency,
                                              decimal=6)
 
+    def test_hawkes_adm4_low_rank(self):
+        """...Test that HawkesADM4 keeping the low rank component as factors
+        reaches the solution of the full SVD when max_rank covers all nodes
+        """
+        events = [
+            np.array([1, 1.2, 3.4, 5.8, 10.3, 11, 13.4]),
+            np.array([2, 5, 8.3, 9.10, 15, 18, 20, 33]),
+            np.array([0.5, 4, 7.7, 12.1, 19.5, 25])
+        ]
+        n_nodes = len(events)
+        baseline_start = np.zeros(n_nodes) + .2
+        adjacency_start = np.zeros((n_nodes, n_nodes)) + .2
+
+        learners = [
+            HawkesADM4(self.decay, rho=0.5, C=10, lasso_nuclear_ratio=0.7,
+                       n_threads=2, max_iter=11, em_max_iter=3,
+                       max_rank=max_rank) for max_rank in [None, n_nodes]
+        ]
+        for learner in learners:
+            learner.fit(events, baseline_start=baseline_start,
+                        adjacency_start=adjacency_start)
+
+        np.testing.assert_array_almost_equal(learners[1].baseline,
+                                             learners[0].baseline, decimal=6)
+        np.testing.assert_array_almost_equal(learners[1].adjacency,
+                                             learners[0].adjacency, decimal=6)
+
     def test_hawkes_adm4_score(self):
         """...Test HawkesADM4 score method
         """
@@ -76,6 +76,11 @@ class Test(unittest.TestCase):
         np.testing.assert_array_almost_equal(em.basis_kernels, basis_kernels,
                                              decimal=3)
 
+        # The iterations are run in C++, with max_iter below record_every
+        # only the last one is checked and recorded
+        self.assertEqual(em.history.values['n_iter'], [5])
+        self.assertEqual(len(em.history.values['rel_ode']), 1)
+
 
 if __name__ == "__main__":
     unittest.main()
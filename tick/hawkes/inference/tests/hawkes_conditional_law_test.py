@@ -8,6 +8,8 @@ from numpy.random import random, randint
 
 from tick.base.inference import InferenceTest
 from tick.hawkes.inference import HawkesConditionalLaw
+from tick.hawkes.inference.build.hawkes_inference import (
+    PointProcessCondLaw, PointProcessCondLawBatch)
 
 
 class Test(InferenceTest):
@@ -112,6 +114,61 @@ class Test(InferenceTest):
         with self.assertWarnsRegex(UserWarning, msg):
             new_model.incremental_fit(self.timestamps, compute=True)
 
+    def test_point_process_cond_law_batch(self):
+        """...Test that PointProcessCondLawBatch gives the same signals as
+        PointProcessCondLaw called on each triplet
+        """
+        T = 50.
+        timestamps = [
+            np.sort(random(n_events)) * max_time
+            for n_events, max_time in [(300, T), (150, T), (80, T / 3)]
+        ]
+        # Marks are given as their cumulated sum
+        marks = [np.cumsum(random(len(t)) * 2) for t in timestamps]
+        lags = np.hstack((0, 1e-3 * 1.4 ** np.arange(1, 26)))
+        intervals = [(-np.inf, np.inf), (-np.inf, .5), (.5, 1.5),
+                     (1.5, np.inf)]
+        triplets = [(i, j, l) for i in range(3) for j in range(3)
+                    for l in range(len(intervals))]
+
+        y_nodes = np.array([i for i, _, _ in triplets], dtype='uint64')
+        z_nodes = np.array([j for _, j, _ in triplets], dtype='uint64')
+        zmins = np.array([intervals[l][0] for _, _, l in triplets])
+        zmaxs = np.array([intervals[l][1] for _, _, l in triplets])
+
+        expected_res_X = np.zeros(len(lags) - 1)
+        expected_res_Y = np.zeros((len(triplets), len(lags) - 1))
+        for index, (i, j, l) in enumerate(triplets):
+            PointProcessCondLaw(timestamps[i], timestamps[j], marks[j], lags,
+                                zmins[index], zmaxs[index], T,
+                                len(timestamps[i]) / T, expected_res_X,
+                                expected_res_Y[index])
+
+        for n_threads in [1, 4]:
+            res_X = np.zeros(len(lags) - 1)
+            res_Y = np.zeros((len(triplets), len(lags) - 1))
+            PointProcessCondLawBatch(timestamps, marks, lags, y_nodes,
+                                     z_nodes, zmins, zmaxs, T, res_X, res_Y,
+                                     n_threads)
+            np.testing.assert_array_almost_equal(res_X, expected_res_X)
+            np.testing.assert_array_almost_equal(res_Y, expected_res_Y)
+
+    def test_hawkes_conditional_law_n_threads(self):
+        """...Test that HawkesConditionalLaw estimates with marked
+        components do not depend on the number of threads
+        """
+        realization = [(t, np.cumsum(random(len(t)) * 2))
+                       for t in self.timestamps]
+        kernels_norms = []
+        for n_threads in [1, 4]:
+            model = HawkesConditionalLaw(n_quad=5,
+                                         marked_components={0: [.5, 1.5]},
+                                         n_threads=n_threads)
+            model.fit(realization)
+            kernels_norms.append(model.kernels_norms)
+        np.testing.assert_array_almost_equal(kernels_norms[0],
+                                             kernels_norms[1])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -72,6 +72,17 @@ if not skip:
             learner._set_data(timestamps)
             self.assertTrue(learner._cumulant_computer.cumulants_ready)
 
+            # Work shared over threads leads to the same cumulants
+            threaded_learner = HawkesCumulantMatching(100., n_threads=3)
+            threaded_learner._set_data(timestamps)
+            threaded_learner.compute_cumulants()
+            np.testing.assert_array_almost_equal(
+                threaded_learner.mean_intensity, expected_L)
+            np.testing.assert_array_almost_equal(threaded_learner.covariance,
+                                                 expected_C)
+            np.testing.assert_array_almost_equal(threaded_learner.skewness,
+                                                 expected_K)
+
         def test_hawkes_cumulants_solve(self):
             """...Test that hawkes cumulant reached expected value
             """
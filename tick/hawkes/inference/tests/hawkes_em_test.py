@@ -27,6 +27,27 @@ class Test(unittest.TestCase):
         self.assertEqual(em.n_nodes, self.n_nodes)
         self.assertEqual(em.n_realizations, self.n_realizations)
 
+    def test_hawkes_em_float32_events(self):
+        """...Test that float32 timestamps select the float learner
+        """
+        events_float32 = [[timestamps.astype(np.float32)
+                           for timestamps in realization]
+                          for realization in self.events]
+        events_float64 = [[timestamps.astype(np.float32).astype(np.float64)
+                           for timestamps in realization]
+                          for realization in self.events]
+
+        em = HawkesEM(kernel_support=3, kernel_size=3, max_iter=5)
+        em.fit(events_float32)
+        em_float64 = HawkesEM(kernel_support=3, kernel_size=3, max_iter=5)
+        em_float64.fit(events_float64)
+        self.assertEqual(em.dtype, np.dtype('float32'))
+        self.assertEqual(em_float64.dtype, np.dtype('float64'))
+        np.testing.assert_allclose(em.baseline, em_float64.baseline,
+                                   rtol=1e-5)
+        np.testing.assert_allclose(em.kernel, em_float64.kernel, rtol=1e-5,
+                                   atol=1e-10)
+
     def test_hawkes_em_fit(self):
         """...Test fit method of HawkesEM
         """
@@ -76,6 +97,68 @@ class Test(unittest.TestCase):
             em.get_kernel_supports(),
             np.ones((self.n_nodes, self.n_nodes)) * 3)
 
+    def test_hawkes_em_n_starts(self):
+        """...Test that HawkesEM keeps the starting point of highest
+        log-likelihood
+        """
+        kernel_support = 3
+        kernel_size = 3
+        n_starts = 4
+        kernel_shape = (self.n_nodes, self.n_nodes, kernel_size)
+        baseline = np.zeros(self.n_nodes) + .2
+        kernel = np.zeros(kernel_shape) + .4
+
+        np.random.seed(2310)
+        em = HawkesEM(kernel_support=kernel_support, kernel_size=kernel_size,
+                      n_threads=3, max_iter=7, n_starts=n_starts,
+                      record_every=2)
+        em.fit(self.events, baseline_start=baseline, kernel_start=kernel)
+
+        # The random starting points are drawn again, each of them is then
+        # fitted alone
+        np.random.seed(2310)
+        kernels_starts = np.empty((n_starts, ) + kernel_shape)
+        kernels_starts[0] = kernel
+        kernels_starts[1:] = 0.1 * np.random.uniform(
+            size=kernels_starts[1:].shape)
+        baselines_starts = np.ones((n_starts, self.n_nodes))
+        baselines_starts[0] = baseline
+
+        scores = []
+        for baseline_start, kernel_start in zip(baselines_starts,
+                                                kernels_starts):
+            em_start = HawkesEM(kernel_support=kernel_support,
+                                kernel_size=kernel_size, max_iter=7,
+                                record_every=2)
+            em_start.fit(self.events, baseline_start=baseline_start,
+                         kernel_start=kernel_start)
+            scores.append(em_start.score())
+            if len(scores) == 1 or scores[-1] > max(scores[:-1]):
+                best_em = em_start
+
+        self.assertAlmostEqual(em.score(), max(scores))
+        np.testing.assert_array_almost_equal(em.baseline, best_em.baseline)
+        np.testing.assert_array_almost_equal(em.kernel, best_em.kernel)
+        # The history is the one of the starting point kept
+        self.assertEqual(em.history.values['n_iter'], [0, 2, 4, 6])
+        np.testing.assert_array_almost_equal(
+            em.history.values['rel_baseline'],
+            best_em.history.values['rel_baseline'])
+
+        with self.assertRaises(ValueError):
+            HawkesEM(kernel_support=kernel_support, n_starts=0).fit(
+                self.events)
+
+    def test_hawkes_em_history_last_iteration(self):
+        """...Test that the last iteration of HawkesEM is recorded even
+        when max_iter is below record_every and print_every
+        """
+        em = HawkesEM(kernel_support=3, kernel_size=3, max_iter=4,
+                      record_every=10, print_every=10)
+        em.fit(self.events)
+        self.assertEqual(em.history.values['n_iter'], [3])
+        self.assertAlmostEqual(em.history.values['llh'][-1], em.score())
+
     def test_hawkes_em_score(self):
         """...Test score (ie. likelihood) function of Hawkes EM
         """
@@ -148,6 +231,44 @@ class Test(unittest.TestCase):
                 approximate_likelihood(em, test_events, test_end_times, 4),
                 delta=1e-3, msg='Failed on test for {}'.format(kwargs))
 
+    def test_hawkes_em_get_residuals(self):
+        """...Test that residuals of HawkesEM integrate the estimated
+        intensity between consecutive events of each node
+        """
+        em = HawkesEM(kernel_discretization=np.array([0., .3, 1., 2.]),
+                      max_iter=5, n_threads=2)
+        with self.assertRaises(ValueError):
+            em.get_residuals()
+        em.fit(self.events)
+
+        discretization = em.kernel_discretization
+        baseline = em.baseline + .1
+        kernel = em.kernel + .05
+        for residuals, (mu, phi) in [
+            (em.get_residuals(), (em.baseline, em.kernel)),
+            (em.get_residuals(baseline, kernel), (baseline, kernel)),
+        ]:
+            self.assertEqual(len(residuals), self.n_realizations)
+            for r, realization in enumerate(self.events):
+                for u, timestamps_u in enumerate(realization):
+                    expected = []
+                    t_previous = 0
+                    for t_k in timestamps_u:
+                        # Kernels are integrated bin by bin
+                        residual = mu[u] * (t_k - t_previous)
+                        for v, timestamps_v in enumerate(realization):
+                            for t_p in timestamps_v:
+                                start = np.maximum(
+                                    t_previous, t_p + discretization[:-1])
+                                end = np.minimum(t_k,
+                                                 t_p + discretization[1:])
+                                residual += np.sum(
+                                    phi[u, v] * np.maximum(end - start, 0))
+                        expected.append(residual)
+                        t_previous = t_k
+                    np.testing.assert_array_almost_equal(
+                        residuals[r][u], expected)
+
     def test_hawkes_em_kernel_support(self):
         """...Test that Hawkes em kernel support parameter is correctly
         synchronized
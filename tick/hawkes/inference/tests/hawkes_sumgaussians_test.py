@@ -68,6 +68,10 @@ class Test(unittest.TestCase):
         np.testing.assert_almost_equal(learner.get_kernel_norms(),
                                        kernels_norm)
 
+        # The iterations are run in C++, the first and last ones are checked
+        # and only the last one falls on record_every
+        self.assertEqual(learner.history.values['n_iter'], [11])
+
         means_gaussians = np.array([0., 1.66666667, 3.33333333])
         std_gaussian = 0.5305164769729844
         np.testing.assert_array_almost_equal(learner.means_gaussians,
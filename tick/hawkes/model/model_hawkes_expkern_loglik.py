@@ -118,6 +118,29 @@ class ModelHawkesExpKernLogLik(ModelHawkes, ModelSecondOrder,
     def _hessian_norm(self, coeffs: np.ndarray, point: np.ndarray) -> float:
         return self._model.hessian_norm(coeffs, point)
 
+    def get_residuals(self, coeffs: np.ndarray):
+        """Computes the compensator of each node between two of its
+        consecutive events, for a Hawkes process with exponential kernels
+        parametrized by `coeffs`. According to the time rescaling theorem,
+        if the data was generated by this process, these residuals are i.i.d.
+        exponential random variables of mean 1
+
+        Parameters
+        ----------
+        coeffs : `np.ndarray`, shape=(n_nodes * n_nodes + n_nodes, )
+            Baseline followed by the flattened adjacency matrix, as given
+            to `loss`
+
+        Returns
+        -------
+        residuals : `list` of `list` of `np.ndarray`
+            `residuals[r][i]` holds the residuals of the events of node i of
+            realization r
+        """
+        if not self._fitted:
+            raise ValueError('call ``fit`` before using ``get_residuals``')
+        return self._model.get_residuals(coeffs)
+
     def _get_sc_constant(self) -> float:
         return 2.0
 
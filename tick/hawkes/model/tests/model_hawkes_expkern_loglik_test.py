@@ -196,6 +196,29 @@ class Test(unittest.TestCase):
 
                 self.assertLess(check_grad(g_i, h_i, self.coeffs), 1e-5)
 
+    def test_model_hawkes_loglik_get_residuals(self):
+        """...Test that residuals are the compensators between consecutive
+        events of each node
+        """
+        residuals = self.model_list.get_residuals(self.coeffs)
+        self.assertEqual(len(residuals), self.n_realizations)
+        for r, timestamps in enumerate(self.timestamps_list):
+            for i, timestamps_i in enumerate(timestamps):
+                expected = []
+                t_previous = 0
+                for t_k in timestamps_i:
+                    residual = self.baseline[i] * (t_k - t_previous)
+                    for j, timestamps_j in enumerate(timestamps):
+                        t_j = timestamps_j[timestamps_j < t_k]
+                        start = np.maximum(t_previous, t_j)
+                        residual += self.adjacency[i, j] * np.sum(
+                            np.exp(-self.decay * (start - t_j)) -
+                            np.exp(-self.decay * (t_k - t_j)))
+                    expected.append(residual)
+                    t_previous = t_k
+                np.testing.assert_array_almost_equal(residuals[r][i],
+                                                     expected)
+
     def test_ModelHawkesExpKernLogLik_refit(self):
         model = ModelHawkesExpKernLogLik(decay=1.0)
         model.fit(events=[np.array([0.0, 50.0])], end_times=100.0)
@@ -154,6 +154,30 @@ class Test(unittest.TestCase):
             self.model_list.loss(self.coeffs),
             model_change_decay.loss(self.coeffs))
 
+    def test_model_hawkes_loglik_get_residuals(self):
+        """...Test that residuals are the compensators between consecutive
+        events of each node
+        """
+        residuals = self.model_list.get_residuals(self.coeffs)
+        self.assertEqual(len(residuals), self.n_realizations)
+        for r, timestamps in enumerate(self.timestamps_list):
+            for i, timestamps_i in enumerate(timestamps):
+                expected = []
+                t_previous = 0
+                for t_k in timestamps_i:
+                    residual = self.baseline[i] * (t_k - t_previous)
+                    for j, timestamps_j in enumerate(timestamps):
+                        t_j = timestamps_j[timestamps_j < t_k]
+                        start = np.maximum(t_previous, t_j)
+                        for u, decay in enumerate(self.decays):
+                            residual += self.adjacency[i, j, u] * np.sum(
+                                np.exp(-decay * (start - t_j)) -
+                                np.exp(-decay * (t_k - t_j)))
+                    expected.append(residual)
+                    t_previous = t_k
+                np.testing.assert_array_almost_equal(residuals[r][i],
+                                                     expected)
+
     def test_hawkes_list_n_threads(self):
         """...Test that the number of used threads is as expected
         """
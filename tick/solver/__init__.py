@@ -14,9 +14,14 @@ from .saga import SAGA
 from .sdca import SDCA
 from .gfb import GFB
 from .adagrad import AdaGrad
+from .coordinate_descent import CoordinateDescent
+from .prox_newton import ProxNewton
+from .newton_cg import NewtonCG
+from .path_solver import PathSolver
 from .history import History
 
 __all__ = [
     "GD", "AGD", "BFGS", "SCPG", "SGD", "SVRG", "SAGA", "SDCA", "GFB",
-    "AdaGrad", "History"
+    "AdaGrad", "CoordinateDescent", "ProxNewton", "NewtonCG", "PathSolver",
+    "History"
 ]
@@ -7,6 +7,7 @@ from tick.base_model import Model
 from tick.prox.base import Prox
 
 from ..build.solver import RandType_perm as perm
+from ..build.solver import RandType_importance as importance
 from ..build.solver import RandType_unif as unif
 
 
@@ -28,6 +29,9 @@ class SolverSto(Base):
         * if ``"perm"`` a random permutation of all possibilities is
           generated and samples are sequentially taken from it. Once all of
           them have been taken, a new random permutation is generated
+        * if ``"importance"`` samples are drawn proportionally to their
+          Lipschitz constants. Only available for solvers reweighting the
+          gradients accordingly (SGD, SVRG and SAGA)
 
     seed : `int`
         The seed of the random sampling. If it is negative then a random seed
@@ -103,18 +107,23 @@ class SolverSto(Base):
             return "unif"
         if self._rand_type == perm:
             return "perm"
+        if self._rand_type == importance:
+            return "importance"
         else:
             raise ValueError("No known ``rand_type``")
 
     @rand_type.setter
     def rand_type(self, val):
-        if val not in ["unif", "perm"]:
-            raise ValueError("``rand_type`` can be 'unif' or " "'perm'")
+        if val not in ["unif", "perm", "importance"]:
+            raise ValueError("``rand_type`` can be 'unif', 'perm' or "
+                             "'importance'")
         else:
             if val == "unif":
                 enum_val = unif
             if val == "perm":
                 enum_val = perm
+            if val == "importance":
+                enum_val = importance
             self._set("_rand_type", enum_val)
 
     def _set_rand_max(self, model):
@@ -0,0 +1,236 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from tick.base_model import Model
+from .base import SolverFirstOrder, SolverFirstOrderSto
+
+from .build.solver import CoordinateDescentDouble as _CoordinateDescentDouble
+from .build.solver import CoordinateDescentFloat as _CoordinateDescentFloat
+from .build.solver import RandType_cyclic, RandType_perm, RandType_unif
+
+from .build.solver import CoordinateDescent_StepType_Newton
+from .build.solver import CoordinateDescent_StepType_QuadraticBound
+
+dtype_class_mapper = {
+    np.dtype('float32'): _CoordinateDescentFloat,
+    np.dtype('float64'): _CoordinateDescentDouble
+}
+
+rand_types_mapper = {
+    'cyclic': RandType_cyclic,
+    'perm': RandType_perm,
+    'unif': RandType_unif
+}
+
+step_types_mapper = {
+    'newton': CoordinateDescent_StepType_Newton,
+    'bound': CoordinateDescent_StepType_QuadraticBound
+}
+
+
+class CoordinateDescent(SolverFirstOrderSto):
+    """Proximal coordinate descent solver
+
+    For the minimization of objectives of the form
+
+    .. math::
+        \\frac 1n \\sum_{i=1}^n f_i(w^\\top x_i) + g(w),
+
+    where the functions :math:`f_i` are twice differentiable and :math:`g`
+    is separable, such as `ProxL1` or `ProxElasticNet`. Each coordinate
+    update minimizes a quadratic approximation of the loss along the
+    coordinate, followed by a prox step:
+
+    .. math::
+        w_j \\gets \\mathrm{prox}_{g / h_j} \\big(w_j - g_j / h_j \\big),
+
+    where :math:`g_j` is the partial derivative of the loss and :math:`h_j`
+    its curvature, chosen by ``step_type``. The inner products of all
+    samples are kept up to date, so that each update only goes through the
+    non-zero entries of the column of the features. An epoch runs
+    ``epoch_size`` updates, followed by at most ``max_active_passes``
+    passes over the non-zero coordinates, which stop once the largest
+    change of a coordinate is below ``tol`` times the largest coordinate.
+
+    The model must be a generalized linear model, such as `ModelLinReg`,
+    `ModelLogReg` or `ModelPoisReg` with an exponential link.
+
+    Parameters
+    ----------
+    epoch_size : `int`, default=None
+        Number of coordinate updates of an epoch. If `None`, it is the number
+        of coefficients of the model
+
+    rand_type : {'cyclic', 'perm', 'unif'}, default='cyclic'
+        Order in which the coordinates are updated
+
+        * if ``'cyclic'`` coordinates are updated in order
+        * if ``'perm'`` coordinates follow random permutations, drawn again
+          after each of them
+        * if ``'unif'`` coordinates are drawn uniformly
+
+    step_type : {'newton', 'bound'}, default='newton'
+        Curvature of the quadratic approximation of the loss
+
+        * if ``'newton'`` the second derivative of the loss at the iterate,
+          doubled until the approximation is an upper bound of the loss
+          along the update
+        * if ``'bound'`` the bound given by the smoothness of the losses,
+          which requires a model with smooth losses
+
+    max_active_passes : `int`, default=10
+        Maximum number of passes over the non-zero coordinates after each
+        epoch
+
+    tol : `float`, default=0.
+        The tolerance of the solver (iterations stop when the stopping
+        criterion is below it). It also stops the passes over the non-zero
+        coordinates
+
+    max_iter : `int`, default=10
+        Maximum number of iterations of the solver, namely maximum number of
+        epochs
+
+    verbose : `bool`, default=True
+        If `True`, solver verboses history, otherwise nothing is displayed,
+        but history is recorded anyway
+
+    print_every : `int`, default=1
+        Print history information every time the iteration number is a
+        multiple of ``print_every``. Used only is ``verbose`` is True
+
+    record_every : `int`, default=1
+        Save history information every time the iteration number is a
+        multiple of ``record_every``
+
+    seed : `int`, default=-1
+        The seed of the random order of the coordinates. If it is negative
+        then a random seed (different at each run) will be chosen.
+
+    Attributes
+    ----------
+    model : `Model`
+        The model used by the solver, passed with the ``set_model`` method
+
+    prox : `Prox`
+        Proximal operator used by the solver, passed with the ``set_prox``
+        method
+
+    solution : `numpy.array`, shape=(n_coeffs,)
+        Minimizer found by the solver
+
+    history : `dict`-like
+        A dict-type of object that contains history of the solver along
+        iterations. It should be accessed using the ``get_history`` method
+
+    time_start : `str`
+        Start date of the call to ``solve()``
+
+    time_elapsed : `float`
+        Duration of the call to ``solve()``, in seconds
+
+    time_end : `str`
+        End date of the call to ``solve()``
+
+    dtype : `{'float64', 'float32'}`, default='float64'
+        Type of the arrays used. This value is set from model and prox dtypes.
+
+    References
+    ----------
+    * J. Friedman, T. Hastie and R. Tibshirani, Regularization paths for
+      generalized linear models via coordinate descent, *Journal of
+      Statistical Software*, 2010
+    """
+
+    _attrinfos = {
+        "max_active_passes": {
+            "cpp_setter": "set_max_active_passes"
+        },
+        "_step_type_str": {}
+    }
+
+    def __init__(self, epoch_size: int = None, rand_type: str = 'cyclic',
+                 step_type: str = 'newton', max_active_passes: int = 10,
+                 tol: float = 0., max_iter: int = 10, verbose: bool = True,
+                 print_every: int = 1, record_every: int = 1,
+                 seed: int = -1):
+        if step_type not in step_types_mapper:
+            raise ValueError(
+                'step_type should be one of "{}", got "{}"'.format(
+                    ', '.join(sorted(step_types_mapper.keys())), step_type))
+        self.max_active_passes = max_active_passes
+        # temporary to hold step type before the C++ solver is built
+        self._step_type_str = step_type
+
+        SolverFirstOrderSto.__init__(
+            self, step=0, epoch_size=epoch_size, rand_type=rand_type, tol=tol,
+            max_iter=max_iter, verbose=verbose, print_every=print_every,
+            record_every=record_every, seed=seed)
+
+    @property
+    def rand_type(self):
+        return next((k for k, v in rand_types_mapper.items()
+                     if v == self._rand_type), None)
+
+    @rand_type.setter
+    def rand_type(self, val: str):
+        if val not in rand_types_mapper:
+            raise ValueError(
+                'rand_type should be one of "{}", got "{}"'.format(
+                    ', '.join(sorted(rand_types_mapper.keys())), val))
+        self._set("_rand_type", rand_types_mapper[val])
+
+    @property
+    def step_type(self):
+        return next((k for k, v in step_types_mapper.items()
+                     if v == self._solver.get_step_type()), None)
+
+    @step_type.setter
+    def step_type(self, val: str):
+        if val not in step_types_mapper:
+            raise ValueError(
+                'step_type should be one of "{}", got "{}"'.format(
+                    ', '.join(sorted(step_types_mapper.keys())), val))
+        self._step_type_str = val
+        self._solver.set_step_type(step_types_mapper[val])
+
+    def set_model(self, model: Model):
+        """Set model in the solver
+
+        Parameters
+        ----------
+        model : `Model`
+            Generalized linear model whose loss is minimized
+
+        Returns
+        -------
+        output : `Solver`
+            The `Solver` with given model
+        """
+        self.validate_model(model)
+        if self.dtype != model.dtype or self._solver is None:
+            self._set_cpp_solver(model.dtype)
+
+        self.dtype = model.dtype
+        SolverFirstOrder.set_model(self, model)
+        # The C++ solver draws coordinates, not samples, so it sets its own
+        # rand_max and epoch size
+        self._solver.set_model(model._model)
+        return self
+
+    def _set_cpp_solver(self, dtype_or_object_with_dtype):
+        self.dtype = self._extract_dtype(dtype_or_object_with_dtype)
+        solver_class = self._get_typed_class(dtype_or_object_with_dtype,
+                                             dtype_class_mapper)
+
+        epoch_size = self.epoch_size
+        if epoch_size is None:
+            epoch_size = 0
+
+        self._set(
+            '_solver',
+            solver_class(epoch_size, self.tol, self._rand_type,
+                         step_types_mapper[self._step_type_str],
+                         self.max_active_passes, self.record_every,
+                         self.seed))
@@ -0,0 +1,114 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from .base import SolverFirstOrderSto
+
+from .build.solver import NewtonCGDouble as _NewtonCGDouble
+from .build.solver import NewtonCGFloat as _NewtonCGFloat
+
+dtype_class_mapper = {
+    np.dtype('float32'): _NewtonCGFloat,
+    np.dtype('float64'): _NewtonCGDouble
+}
+
+
+class NewtonCG(SolverFirstOrderSto):
+    """Truncated Newton solver
+
+    For the minimization of objectives of the form
+
+    .. math::
+        \\frac 1n \\sum_{i=1}^n f_i(w^\\top x_i) + g(w),
+
+    where the functions :math:`f_i` are twice differentiable and :math:`g`
+    is either zero (`ProxZero`) or a `ProxL2Sq`. Each iteration is a Newton
+    step: the Newton direction is approximated by conjugate gradient, using
+    the hessian-vector products of the model, until the residual is below
+    :math:`\\min(0.5, \\sqrt{\\|\\nabla\\|}) \\|\\nabla\\|` or after
+    ``max_cg_iter`` iterations. The step along this direction is halved
+    until the objective decreases enough (Armijo condition).
+
+    The model must be a generalized linear model with smooth losses, such as
+    `ModelLinReg`, `ModelLogReg` or `ModelPoisReg`.
+
+    Parameters
+    ----------
+    max_cg_iter : `int`, default=20
+        Maximum number of conjugate gradient iterations of each Newton step
+
+    tol : `float`, default=0.
+        The tolerance of the solver (iterations stop when the stopping
+        criterion is below it). By default the solver does ``max_iter``
+        iterations
+
+    max_iter : `int`, default=10
+        Maximum number of iterations of the solver, namely maximum number of
+        Newton steps
+
+    verbose : `bool`, default=True
+        If `True`, solver verboses history, otherwise nothing is displayed,
+        but history is recorded anyway
+
+    print_every : `int`, default=1
+        Print history information every time the iteration number is a
+        multiple of ``print_every``. Used only is ``verbose`` is True
+
+    record_every : `int`, default=1
+        Save history information every time the iteration number is a
+        multiple of ``record_every``
+
+    Attributes
+    ----------
+    model : `Model`
+        The model used by the solver, passed with the ``set_model`` method
+
+    prox : `Prox`
+        Proximal operator used by the solver, passed with the ``set_prox``
+        method
+
+    solution : `numpy.array`, shape=(n_coeffs,)
+        Minimizer found by the solver
+
+    history : `dict`-like
+        A dict-type of object that contains history of the solver along
+        iterations. It should be accessed using the ``get_history`` method
+
+    time_start : `str`
+        Start date of the call to ``solve()``
+
+    time_elapsed : `float`
+        Duration of the call to ``solve()``, in seconds
+
+    time_end : `str`
+        End date of the call to ``solve()``
+
+    dtype : `{'float64', 'float32'}`, default='float64'
+        Type of the arrays used. This value is set from model and prox dtypes.
+
+    References
+    ----------
+    * J. Nocedal and S. Wright, Numerical optimization, *Springer*, 2006,
+      chapter 7.1
+    """
+
+    _attrinfos = {
+        "max_cg_iter": {
+            "cpp_setter": "set_max_cg_iter"
+        }
+    }
+
+    def __init__(self, max_cg_iter: int = 20, tol: float = 0.,
+                 max_iter: int = 10, verbose: bool = True,
+                 print_every: int = 1, record_every: int = 1):
+        self.max_cg_iter = max_cg_iter
+        SolverFirstOrderSto.__init__(
+            self, step=0, tol=tol, max_iter=max_iter, verbose=verbose,
+            print_every=print_every, record_every=record_every)
+
+    def _set_cpp_solver(self, dtype_or_object_with_dtype):
+        self.dtype = self._extract_dtype(dtype_or_object_with_dtype)
+        solver_class = self._get_typed_class(dtype_or_object_with_dtype,
+                                             dtype_class_mapper)
+        self._set('_solver',
+                  solver_class(self.tol, self.max_cg_iter, self.record_every))
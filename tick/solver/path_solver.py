@@ -0,0 +1,162 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from tick.base import Base
+from tick.prox import ProxL1, ProxElasticNet
+from .base import SolverFirstOrderSto
+
+from .build.solver import PathSolverDouble as _PathSolverDouble
+from .build.solver import PathSolverFloat as _PathSolverFloat
+
+dtype_class_mapper = {
+    np.dtype('float32'): _PathSolverFloat,
+    np.dtype('float64'): _PathSolverDouble
+}
+
+
+class PathSolver(Base):
+    """Regularization path of a model penalized by a `ProxL1` or a
+    `ProxElasticNet`
+
+    The path is fitted over a decreasing grid of strengths, each fit being
+    warm-started from the previous one by running ``n_epochs`` epochs of the
+    given stochastic solver. Before each fit, the sequential strong rule
+    discards the features that are likely to be zero at the new strength.
+    Discarded features are held at zero, and the fit is resumed with the
+    features violating the KKT conditions until there is none.
+
+    Parameters
+    ----------
+    solver : `SolverFirstOrderSto`
+        Stochastic solver whose model is set, such as `SVRG` or `SAGA`. Its
+        state is kept along the path, and its prox is given back at the end
+        of the path
+
+    prox : `ProxL1` or `ProxElasticNet`
+        Penalization of the path, whose strength is set to each strength of
+        the grid in turn
+
+    strengths : `np.ndarray`, shape=(n_strengths,), default=None
+        Positive and decreasing grid of strengths. If `None`, a geometric
+        grid of ``n_strengths`` strengths from ``strength_max`` down to
+        ``eps * strength_max`` is used
+
+    n_strengths : `int`, default=20
+        Number of strengths of the default grid
+
+    eps : `float`, default=1e-3
+        Ratio of the smallest to the largest strength of the default grid
+
+    n_epochs : `int`, default=10
+        Number of epochs of the solver run for each fit
+
+    screening : `bool`, default=True
+        If `True`, features are discarded with the sequential strong rule
+
+    Attributes
+    ----------
+    strength_max : `float`
+        Smallest strength for which zero is a solution
+
+    path : `scipy.sparse.csr_matrix`, shape=(n_strengths, n_coeffs)
+        Solutions of the path, one row per strength
+
+    n_active_features : `np.ndarray`, shape=(n_strengths,)
+        Number of features that were not discarded at the end of each fit
+
+    n_kkt_violations : `np.ndarray`, shape=(n_strengths,)
+        Number of discarded features added back because they violated the
+        KKT conditions, for each fit
+    """
+
+    _attrinfos = {
+        "solver": {
+            "writable": False
+        },
+        "prox": {
+            "writable": False
+        },
+        "n_epochs": {
+            "cpp_setter": "set_n_epochs"
+        },
+        "screening": {
+            "cpp_setter": "set_screening"
+        },
+        "path": {
+            "writable": False
+        },
+        "n_active_features": {
+            "writable": False
+        },
+        "n_kkt_violations": {
+            "writable": False
+        },
+        "_path_solver": {
+            "writable": False
+        }
+    }
+
+    _cpp_obj_name = "_path_solver"
+
+    def __init__(self, solver: SolverFirstOrderSto, prox,
+                 strengths: np.ndarray = None, n_strengths: int = 20,
+                 eps: float = 1e-3, n_epochs: int = 10,
+                 screening: bool = True):
+        Base.__init__(self)
+        if not isinstance(solver, SolverFirstOrderSto) or \
+                getattr(solver, '_solver', None) is None:
+            raise ValueError("PathSolver needs a stochastic solver")
+        if solver.model is None:
+            raise ValueError("The model of the solver must be set")
+        if not isinstance(prox, (ProxL1, ProxElasticNet)):
+            raise ValueError("PathSolver accepts only ProxL1 or "
+                             "ProxElasticNet")
+        if np.dtype(prox.dtype) != np.dtype(solver.dtype):
+            prox = prox.astype(solver.dtype)
+
+        self._set("solver", solver)
+        self._set("prox", prox)
+        self._set("path", None)
+        self._set("n_active_features", None)
+        self._set("n_kkt_violations", None)
+        self._set("_path_solver", None)
+        self.n_epochs = n_epochs
+        self.screening = screening
+        self.n_strengths = n_strengths
+        self.eps = eps
+        self.strengths = strengths
+
+        self.dtype = solver.dtype
+        path_solver_class = dtype_class_mapper[np.dtype(self.dtype)]
+        # The C++ solver is shared with the Python one, which keeps it alive
+        self._set("_path_solver",
+                  path_solver_class(solver._solver, prox._prox, n_epochs,
+                                    screening))
+
+    @property
+    def strength_max(self):
+        return self._path_solver.get_strength_max()
+
+    def solve(self):
+        """Fits the path
+
+        Returns
+        -------
+        output : `scipy.sparse.csr_matrix`, shape=(n_strengths, n_coeffs)
+            Solutions of the path, one row per strength
+        """
+        strengths = self.strengths
+        if strengths is None:
+            strengths = self.strength_max * np.logspace(
+                0, np.log10(self.eps), self.n_strengths)
+        strengths = np.ascontiguousarray(strengths, dtype=self.dtype)
+        self._path_solver.set_strengths(strengths)
+        self._path_solver.solve()
+
+        self._set("path", self._path_solver.get_path())
+        self._set("n_active_features",
+                  self._path_solver.get_n_active_features())
+        self._set("n_kkt_violations",
+                  self._path_solver.get_n_kkt_violations())
+        return self.path
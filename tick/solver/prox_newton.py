@@ -0,0 +1,141 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from .coordinate_descent import CoordinateDescent
+
+from .build.solver import ProxNewtonDouble as _ProxNewtonDouble
+from .build.solver import ProxNewtonFloat as _ProxNewtonFloat
+
+dtype_class_mapper = {
+    np.dtype('float32'): _ProxNewtonFloat,
+    np.dtype('float64'): _ProxNewtonDouble
+}
+
+
+class ProxNewton(CoordinateDescent):
+    """Proximal Newton solver
+
+    For the minimization of objectives of the form
+
+    .. math::
+        \\frac 1n \\sum_{i=1}^n f_i(w^\\top x_i) + g(w),
+
+    where the functions :math:`f_i` are twice differentiable and :math:`g`
+    is separable, such as `ProxL1` or `ProxElasticNet`. Each iteration is a
+    Newton step: the loss is replaced by its second order approximation at
+    the iterate, and the penalized approximation is minimized by coordinate
+    descent, with a pass over all the coordinates followed by at most
+    ``max_active_passes`` passes over the non-zero ones. The step towards
+    the minimizer of the approximation is halved until the objective
+    decreases enough (Armijo condition).
+
+    The model must be a generalized linear model, such as `ModelLinReg`,
+    `ModelLogReg` or `ModelPoisReg` with an exponential link.
+
+    Parameters
+    ----------
+    rand_type : {'cyclic', 'perm', 'unif'}, default='cyclic'
+        Order in which the coordinates of the approximation are updated
+
+        * if ``'cyclic'`` coordinates are updated in order
+        * if ``'perm'`` coordinates follow random permutations, drawn again
+          after each of them
+        * if ``'unif'`` coordinates are drawn uniformly
+
+    max_active_passes : `int`, default=10
+        Maximum number of passes over the non-zero coordinates of each
+        minimization of the approximation
+
+    tol : `float`, default=0.
+        The tolerance of the solver (iterations stop when the stopping
+        criterion is below it). It also stops the passes over the non-zero
+        coordinates
+
+    max_iter : `int`, default=10
+        Maximum number of iterations of the solver, namely maximum number of
+        Newton steps
+
+    verbose : `bool`, default=True
+        If `True`, solver verboses history, otherwise nothing is displayed,
+        but history is recorded anyway
+
+    print_every : `int`, default=1
+        Print history information every time the iteration number is a
+        multiple of ``print_every``. Used only is ``verbose`` is True
+
+    record_every : `int`, default=1
+        Save history information every time the iteration number is a
+        multiple of ``record_every``
+
+    seed : `int`, default=-1
+        The seed of the random order of the coordinates. If it is negative
+        then a random seed (different at each run) will be chosen.
+
+    Attributes
+    ----------
+    model : `Model`
+        The model used by the solver, passed with the ``set_model`` method
+
+    prox : `Prox`
+        Proximal operator used by the solver, passed with the ``set_prox``
+        method
+
+    solution : `numpy.array`, shape=(n_coeffs,)
+        Minimizer found by the solver
+
+    history : `dict`-like
+        A dict-type of object that contains history of the solver along
+        iterations. It should be accessed using the ``get_history`` method
+
+    time_start : `str`
+        Start date of the call to ``solve()``
+
+    time_elapsed : `float`
+        Duration of the call to ``solve()``, in seconds
+
+    time_end : `str`
+        End date of the call to ``solve()``
+
+    dtype : `{'float64', 'float32'}`, default='float64'
+        Type of the arrays used. This value is set from model and prox dtypes.
+
+    Notes
+    -----
+    The coordinates are updated with the exact curvature of the
+    approximation, hence ``step_type`` is always ``'newton'``
+
+    References
+    ----------
+    * J. Lee, Y. Sun and M. Saunders, Proximal Newton-type methods for
+      minimizing composite functions, *SIAM Journal on Optimization*, 2014
+    """
+
+    def __init__(self, rand_type: str = 'cyclic', max_active_passes: int = 10,
+                 tol: float = 0., max_iter: int = 10, verbose: bool = True,
+                 print_every: int = 1, record_every: int = 1,
+                 seed: int = -1):
+        CoordinateDescent.__init__(
+            self, rand_type=rand_type, max_active_passes=max_active_passes,
+            tol=tol, max_iter=max_iter, verbose=verbose,
+            print_every=print_every, record_every=record_every, seed=seed)
+
+    @property
+    def step_type(self):
+        return 'newton'
+
+    @step_type.setter
+    def step_type(self, val: str):
+        if val != 'newton':
+            raise ValueError(
+                'ProxNewton only uses the "newton" step_type, got "{}"'.format(
+                    val))
+
+    def _set_cpp_solver(self, dtype_or_object_with_dtype):
+        self.dtype = self._extract_dtype(dtype_or_object_with_dtype)
+        solver_class = self._get_typed_class(dtype_or_object_with_dtype,
+                                             dtype_class_mapper)
+        self._set(
+            '_solver',
+            solver_class(self.tol, self._rand_type, self.max_active_passes,
+                         self.record_every, self.seed))
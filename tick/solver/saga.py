@@ -91,13 +91,16 @@ class SAGA(SolverFirstOrderSto):
         Epoch size, by default, this is automatically tuned using
         information from the model object passed through ``set_model``.
 
-    rand_type : {'unif', 'perm'}, default='unif'
+    rand_type : {'unif', 'perm', 'importance'}, default='unif'
         How samples are randomly selected from the data
 
         * if ``'unif'`` samples are uniformly drawn among all possibilities
         * if ``'perm'`` a random permutation of all possibilities is
           generated and samples are sequentially taken from it. Once all of
           them have been taken, a new random permutation is generated
+        * if ``'importance'`` samples are drawn proportionally to their
+          Lipschitz constants, and their gradients are reweighted to remain
+          unbiased. This requires a model with Lipschitz constants
 
     print_every : `int`, default=1
         Print history information every time the iteration number is a
@@ -111,6 +114,28 @@ class SAGA(SolverFirstOrderSto):
         Number of threads to use for parallel optimization. The strategy used
         for this is asynchronous updates of the iterates.
 
+    batch_size : `int`, default=1
+        Number of samples drawn at each iteration. Their gradients are
+        computed at the same iterate and each one replaces the gradient stored
+        for its sample. The corrected gradients are averaged and followed by
+        one prox step, so that an epoch is made of ``epoch_size //
+        batch_size`` iterations. With sparse features, the step correction of
+        a feature is the inverse of the probability that it belongs to the
+        support of a batch. A step of
+        ``batch_size / (L_max + (batch_size - 1) * L_mean)``, with
+        ``L_max = model.get_lip_max()`` and ``L_mean = model.get_lip_mean()``,
+        is a good start. Not available with ``n_threads`` > 1, where each
+        thread steps on a single sample
+
+    screening_every : `int`, default=0
+        If positive, SAGA looks for features that are zero at the optimum
+        every ``screening_every`` epochs, with the gap safe rules based on
+        the duality gap at the iterate. Such features are set to zero and
+        the steps no longer update them, nor maintain the average of the
+        stored gradients on them. Can only be used with ``n_threads`` = 1, on a
+        generalized linear model without intercept, penalized on all its
+        coefficients by `ProxL1` or `ProxElasticNet`
+
     Attributes
     ----------
     model : `Model`
@@ -148,13 +173,32 @@ class SAGA(SolverFirstOrderSto):
     * R. Leblond, F. Pedregosa, and S. Lacoste-Julien: Asaga: Asynchronous
       Parallel Saga, (AISTATS) 2017
     """
-    _attrinfos = {"n_threads": {"writable": False}}
+    _attrinfos = {
+        "n_threads": {
+            "writable": False
+        },
+        "batch_size": {
+            "cpp_setter": "set_batch_size"
+        },
+        "screening_every": {
+            "cpp_setter": "set_screening_every"
+        }
+    }
 
     def __init__(self, step: float = None, epoch_size: int = None,
                  rand_type: str = "unif", tol: float = 0., max_iter: int = 100,
                  verbose: bool = True, print_every: int = 10,
-                 record_every: int = 1, seed: int = -1, n_threads: int = 1):
+                 record_every: int = 1, seed: int = -1, n_threads: int = 1,
+                 batch_size: int = 1,
+                 screening_every: int = 0):
+        if n_threads > 1 and batch_size > 1:
+            raise ValueError("SAGA cannot use batch_size > 1 with "
+                             "n_threads > 1")
+        if n_threads > 1 and screening_every > 0:
+            raise ValueError("SAGA cannot use screening with n_threads > 1")
         self.n_threads = n_threads
+        self.batch_size = batch_size
+        self.screening_every = screening_every
 
         SolverFirstOrderSto.__init__(self, step, epoch_size, rand_type, tol,
                                      max_iter, verbose, print_every,
@@ -200,6 +244,8 @@ class SAGA(SolverFirstOrderSto):
                 '_solver',
                 solver_class(epoch_size, self.tol, self._rand_type, step,
                              self.record_every, self.seed))
+            self._solver.set_batch_size(self.batch_size)
+            self._solver.set_screening_every(self.screening_every)
         else:
             solver_class = self._get_typed_class(dtype_or_object_with_dtype,
                                                  dtype_atomic_mapper)
@@ -69,6 +69,10 @@ class SDCA(SolverFirstOrderSto):
     also stored in the ``solution`` attribute of the solver. The dual solution
     :math:`\\alpha` is stored in the ``dual_solution`` attribute.
 
+    When ``n_threads`` > 1, each thread maximizes the dual coordinates of its
+    own block of samples, while :math:`v` and :math:`w` are shared and
+    updated asynchronously. This requires a separable prox.
+
     Internally, :class:`SDCA <tick.solver.SDCA>` has dedicated code when
     the model is a generalized linear model with sparse features, and a
     separable proximal operator: in this case, each iteration works only in the
@@ -120,6 +124,10 @@ class SDCA(SolverFirstOrderSto):
         Save history information every time the iteration number is a
         multiple of ``record_every``
 
+    n_threads : `int`, default=1
+        Number of threads to use for parallel optimization. The strategy used
+        for this is asynchronous updates of the primal vector.
+
     Attributes
     ----------
     model : `Model`
@@ -157,14 +165,23 @@ class SDCA(SolverFirstOrderSto):
       coordinate ascent for regularized loss minimization, *ICML 2014*
     """
 
-    _attrinfos = {'l_l2sq': {'cpp_setter': 'set_l_l2sq'}}
+    _attrinfos = {
+        'l_l2sq': {
+            'cpp_setter': 'set_l_l2sq'
+        },
+        'n_threads': {
+            'cpp_setter': 'set_n_threads'
+        }
+    }
 
     def __init__(self, l_l2sq: float, epoch_size: int = None,
                  rand_type: str = 'unif', tol: float = 1e-10,
                  max_iter: int = 10, verbose: bool = True,
-                 print_every: int = 1, record_every: int = 1, seed: int = -1):
+                 print_every: int = 1, record_every: int = 1, seed: int = -1,
+                 n_threads: int = 1):
 
         self.l_l2sq = l_l2sq
+        self.n_threads = n_threads
         SolverFirstOrderSto.__init__(
             self, step=0, epoch_size=epoch_size, rand_type=rand_type, tol=tol,
             max_iter=max_iter, verbose=verbose, print_every=print_every,
@@ -182,7 +199,7 @@ class SDCA(SolverFirstOrderSto):
         self._set(
             '_solver',
             solver_class(self.l_l2sq, epoch_size, self.tol, self._rand_type,
-                         self.record_every, self.seed))
+                         self.record_every, self.seed, self.n_threads))
 
     def objective(self, coeffs, loss: float = None):
         """Compute the objective minimized by the solver at ``coeffs``
@@ -74,13 +74,16 @@ class SGD(SolverFirstOrderSto):
         variance reducing term. By default, this is automatically tuned using
         information from the model object passed through ``set_model``.
 
-    rand_type : {'unif', 'perm'}, default='unif'
+    rand_type : {'unif', 'perm', 'importance'}, default='unif'
         How samples are randomly selected from the data
 
         * if ``'unif'`` samples are uniformly drawn among all possibilities
         * if ``'perm'`` a random permutation of all possibilities is
           generated and samples are sequentially taken from it. Once all of
           them have been taken, a new random permutation is generated
+        * if ``'importance'`` samples are drawn proportionally to their
+          Lipschitz constants, and their gradients are reweighted to remain
+          unbiased. This requires a model with Lipschitz constants
 
     print_every : `int`, default=10
         Print history information every time the iteration number is a
@@ -90,6 +93,15 @@ class SGD(SolverFirstOrderSto):
         Save history information every time the iteration number is a
         multiple of ``record_every``
 
+    batch_size : `int`, default=1
+        Number of samples drawn at each iteration. Their gradients are
+        computed at the same iterate and averaged into a single step, followed
+        by a single prox, applied lazily on the union of their supports with
+        sparse features. An epoch is then made of ``epoch_size //
+        batch_size`` iterations. The decreasing step :math:`\\eta_t` counts
+        samples rather than iterations, so the schedule along an epoch does
+        not depend on ``batch_size``
+
     Attributes
     ----------
     model : `Model`
@@ -123,10 +135,14 @@ class SGD(SolverFirstOrderSto):
     * https://en.wikipedia.org/wiki/Stochastic_gradient_descent
     """
 
+    _attrinfos = {"batch_size": {"cpp_setter": "set_batch_size"}}
+
     def __init__(self, step: float = None, epoch_size: int = None,
                  rand_type: str = "unif", tol: float = 1e-10,
                  max_iter: int = 100, verbose: bool = True,
-                 print_every: int = 10, record_every: int = 1, seed: int = -1):
+                 print_every: int = 10, record_every: int = 1, seed: int = -1,
+                 batch_size: int = 1):
+        self.batch_size = batch_size
 
         SolverFirstOrderSto.__init__(self, step, epoch_size, rand_type, tol,
                                      max_iter, verbose, print_every,
@@ -149,3 +165,4 @@ class SGD(SolverFirstOrderSto):
             '_solver',
             solver_class(epoch_size, self.tol, self._rand_type, step,
                          self.record_every, self.seed))
+        self._solver.set_batch_size(self.batch_size)
@@ -35,6 +35,13 @@ dtype_class_mapper = {
     np.dtype('float64'): _SVRGDouble
 }
 
+from .build.solver import AtomicSVRGDouble as _ASVRGDouble
+from .build.solver import AtomicSVRGFloat as _ASVRGFloat
+dtype_atomic_mapper = {
+    np.dtype('float32'): _ASVRGFloat,
+    np.dtype('float64'): _ASVRGDouble
+}
+
 
 class SVRG(SolverFirstOrderSto):
     """Stochastic Variance Reduced Gradient solver
@@ -75,7 +82,10 @@ class SVRG(SolverFirstOrderSto):
     Moreover, when ``n_threads`` > 1, this class actually implements parallel
     and asynchronous updates of :math:`w`, which is likely to accelerate
     optimization, depending on the sparsity of the dataset, and the number of
-    available cores.
+    available cores. The threads share :math:`w` and write each of its
+    coordinates atomically. This requires a generalized linear model and a
+    separable prox, and only the ``'last'`` variance reduction and the
+    ``'fixed'`` step type are available.
 
     Parameters
     ----------
@@ -104,7 +114,20 @@ class SVRG(SolverFirstOrderSto):
 
     n_threads : `int`, default=1
         Number of threads to use for parallel optimization. The strategy used
-        for this is asynchronous updates of the iterates.
+        for this is lock-free asynchronous updates of the iterates.
+
+    batch_size : `int`, default=1
+        Number of samples drawn at each iteration. For each of them, the
+        gradient at the variance reduction point is subtracted from the one at
+        the current iterate, and the average of these differences plus the
+        full gradient gives one step, followed by one prox. An epoch is then
+        made of ``epoch_size // batch_size`` iterations, while the full
+        gradient is still computed once per epoch. Averaging lets the step
+        grow with the batch, up to about ``batch_size / (L_max + (batch_size -
+        1) * L_mean)`` where ``L_max`` and ``L_mean`` are returned by
+        ``model.get_lip_max()`` and ``model.get_lip_mean()``. Not available
+        with ``n_threads`` > 1, whose lock-free threads step on one sample at
+        a time
 
     epoch_size : `int`, default given by model
         Epoch size, namely how many iterations are made before updating the
@@ -125,13 +148,16 @@ class SVRG(SolverFirstOrderSto):
         * ``'rand'``: the phase iterate is a random iterate of the previous
           epoch
 
-    rand_type : {'unif', 'perm'}, default='unif'
+    rand_type : {'unif', 'perm', 'importance'}, default='unif'
         How samples are randomly selected from the data
 
         * if ``'unif'`` samples are uniformly drawn among all possibilities
         * if ``'perm'`` a random permutation of all possibilities is
           generated and samples are sequentially taken from it. Once all of
           them have been taken, a new random permutation is generated
+        * if ``'importance'`` samples are drawn proportionally to their
+          Lipschitz constants, and their gradients are reweighted to remain
+          unbiased. This requires a model with Lipschitz constants
 
     step_type : {'fixed', 'bb'}, default='fixed'
         How step will evoluate over stime
@@ -143,6 +169,15 @@ class SVRG(SolverFirstOrderSto):
           choice is much more adaptive and should be used if optimal step if
           difficult to obtain.
 
+    screening_every : `int`, default=0
+        Number of epochs between two gap safe screenings, ``0`` disabling
+        them. At the end of each such epoch, the duality gap at the iterate
+        bounds the distance to the optimum, which discards the features
+        guaranteed to be zero there: they are set to zero and the following
+        steps skip them. Requires ``n_threads`` = 1 and a generalized linear
+        model without intercept, with a `ProxL1` or a `ProxElasticNet`
+        covering all coefficients
+
     print_every : `int`, default=1
         Print history information every time the iteration number is a
         multiple of ``print_every``. Used only is ``verbose`` is True
@@ -192,15 +227,41 @@ class SVRG(SolverFirstOrderSto):
       Jordan, M.I., 2015.
       Perturbed iterate analysis for asynchronous stochastic optimization.
     """
-    _attrinfos = {"_step_type_str": {}, "_var_red_str": {}}
+    _attrinfos = {
+        "n_threads": {
+            "writable": False
+        },
+        "_step_type_str": {},
+        "_var_red_str": {},
+        "batch_size": {
+            "cpp_setter": "set_batch_size"
+        },
+        "screening_every": {
+            "cpp_setter": "set_screening_every"
+        }
+    }
 
     def __init__(self, step: float = None, epoch_size: int = None,
                  rand_type: str = 'unif', tol: float = 1e-10,
                  max_iter: int = 10, verbose: bool = True,
                  print_every: int = 1, record_every: int = 1, seed: int = -1,
                  variance_reduction: str = 'last', step_type: str = 'fixed',
-                 n_threads: int = 1):
+                 n_threads: int = 1, batch_size: int = 1,
+                 screening_every: int = 0):
+        if n_threads > 1 and batch_size > 1:
+            raise ValueError("SVRG cannot use batch_size > 1 with "
+                             "n_threads > 1")
+        if n_threads > 1 and screening_every > 0:
+            raise ValueError("SVRG cannot use screening with n_threads > 1")
+        if n_threads > 1 and variance_reduction != 'last':
+            raise ValueError("SVRG can only use 'last' variance_reduction "
+                             "with n_threads > 1")
+        if n_threads > 1 and step_type != 'fixed':
+            raise ValueError("SVRG can only use 'fixed' step_type with "
+                             "n_threads > 1")
         self.n_threads = n_threads
+        self.batch_size = batch_size
+        self.screening_every = screening_every
         # temporary to hold step type before dtype is known
         self._step_type_str = step_type
         # temporary to hold varience reduction type before dtype is known
@@ -212,6 +273,8 @@ class SVRG(SolverFirstOrderSto):
 
     @property
     def variance_reduction(self):
+        if self.n_threads > 1:
+            return 'last'
         return next((k for k, v in variance_reduction_methods_mapper.items()
                      if v == self._solver.get_variance_reduction()), None)
 
@@ -228,11 +291,18 @@ class SVRG(SolverFirstOrderSto):
                 warn(
                     "'avg' variance reduction cannot be used "
                     "with sparse datasets", UserWarning)
+        if self.n_threads > 1:
+            if val != 'last':
+                raise ValueError("SVRG can only use 'last' "
+                                 "variance_reduction with n_threads > 1")
+            return
         self._solver.set_variance_reduction(
             variance_reduction_methods_mapper[val])
 
     @property
     def step_type(self):
+        if self.n_threads > 1:
+            return 'fixed'
         return next((k for k, v in step_types_mapper.items()
                      if v == self._solver.get_step_type()), None)
 
@@ -242,6 +312,11 @@ class SVRG(SolverFirstOrderSto):
             raise ValueError(
                 'step_type should be one of "{}", got "{}"'.format(
                     ', '.join(sorted(step_types_mapper.keys())), val))
+        if self.n_threads > 1:
+            if val != 'fixed':
+                raise ValueError("SVRG can only use 'fixed' step_type with "
+                                 "n_threads > 1")
+            return
         self._solver.set_step_type(step_types_mapper[val])
 
     def set_model(self, model: Model):
@@ -274,8 +349,6 @@ class SVRG(SolverFirstOrderSto):
 
     def _set_cpp_solver(self, dtype_or_object_with_dtype):
         self.dtype = self._extract_dtype(dtype_or_object_with_dtype)
-        solver_class = self._get_typed_class(dtype_or_object_with_dtype,
-                                             dtype_class_mapper)
 
         # Type mapping None to unsigned long and double does not work...
         step = self.step
@@ -285,10 +358,22 @@ class SVRG(SolverFirstOrderSto):
         if epoch_size is None:
             epoch_size = 0
 
-        self._set(
-            '_solver',
-            solver_class(epoch_size, self.tol, self._rand_type, step,
-                         self.record_every, self.seed, self.n_threads))
+        if self.n_threads == 1:
+            solver_class = self._get_typed_class(dtype_or_object_with_dtype,
+                                                 dtype_class_mapper)
+            self._set(
+                '_solver',
+                solver_class(epoch_size, self.tol, self._rand_type, step,
+                             self.record_every, self.seed, self.n_threads))
+            self._solver.set_batch_size(self.batch_size)
+            self._solver.set_screening_every(self.screening_every)
+        else:
+            solver_class = self._get_typed_class(dtype_or_object_with_dtype,
+                                                 dtype_atomic_mapper)
+            self._set(
+                '_solver',
+                solver_class(epoch_size, self.tol, self._rand_type, step,
+                             self.record_every, self.seed, self.n_threads))
 
         self.variance_reduction = self._var_red_str
         self.step_type = self._step_type_str
@@ -0,0 +1,110 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+from scipy.sparse import csr_matrix
+
+from tick.linear_model import ModelLinReg, ModelLogReg, ModelPoisReg
+from tick.prox import ProxL1, ProxElasticNet
+from tick.solver import CoordinateDescent
+from tick.solver.tests import TestSolver
+
+
+class CoordinateDescentTest(object):
+    def assert_l1_optimality(self, model, prox, minimizer, l1_strength,
+                             decimal):
+        """Checks the KKT conditions of the L1 penalization, the L2 part of
+        the penalization being added to the gradient
+        """
+        grad = model.grad(minimizer)
+        grad += (prox.strength - l1_strength) * minimizer
+        for j in range(model.n_coeffs):
+            if minimizer[j] != 0:
+                self.assertAlmostEqual(
+                    grad[j], -l1_strength * np.sign(minimizer[j]),
+                    places=decimal)
+            else:
+                self.assertLessEqual(abs(grad[j]),
+                                     l1_strength + 10 ** -decimal)
+
+    def test_coordinate_descent_optimality(self):
+        """...Test that CoordinateDescent reaches the minimizer of penalized
+        least squares and logistic regression, with dense and sparse features
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        decimal = 3 if self.dtype == "float32" else 7
+
+        for model_class in [ModelLinReg, ModelLogReg]:
+            for features in [X, csr_matrix(X)]:
+                model = model_class(fit_intercept=False).fit(features, y)
+                strength = 0.2 * np.abs(
+                    model.grad(np.zeros(model.n_coeffs,
+                                        dtype=self.dtype))).max()
+                for prox, l1_strength in [
+                    (ProxL1(strength), strength),
+                    (ProxElasticNet(strength / 0.8, 0.8), strength)]:
+                    prox = prox.astype(self.dtype)
+                    for rand_type in ['cyclic', 'perm', 'unif']:
+                        solver = CoordinateDescent(
+                            rand_type=rand_type, max_iter=100, verbose=False,
+                            seed=TestSolver.sto_seed)
+                        solver.set_model(model).set_prox(prox)
+                        minimizer = solver.solve()
+                        self.assertGreater(np.sum(minimizer != 0), 0)
+                        self.assertGreater(np.sum(minimizer == 0), 0)
+                        self.assert_l1_optimality(model, prox, minimizer,
+                                                  l1_strength, decimal)
+
+    def test_coordinate_descent_step_types(self):
+        """...Test that the Newton and the bound steps of CoordinateDescent
+        reach the same minimizer
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=True).fit(X, y)
+        prox = ProxL1(1e-2, range=(0, X.shape[1])).astype(self.dtype)
+
+        solutions = []
+        for step_type in ['newton', 'bound']:
+            solver = CoordinateDescent(step_type=step_type, max_iter=300,
+                                       verbose=False)
+            self.assertEqual(solver.step_type, step_type)
+            solver.set_model(model).set_prox(prox)
+            solutions.append(solver.solve())
+        np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                   atol=1e-4)
+
+    def test_coordinate_descent_rejected_settings(self):
+        """...Test that CoordinateDescent rejects the settings it does not
+        support
+        """
+        with self.assertRaises(ValueError):
+            CoordinateDescent(step_type='bb')
+        with self.assertRaises(ValueError):
+            CoordinateDescent(rand_type='importance')
+
+        np.random.seed(12)
+        X = np.random.rand(50, 4).astype(self.dtype)
+        y = np.random.poisson(2., 50).astype(self.dtype)
+        # The identity link needs positive inner products
+        model = ModelPoisReg(fit_intercept=False, link='identity').fit(X, y)
+        with self.assertRaises(RuntimeError):
+            CoordinateDescent().set_model(model)
+
+
+class CoordinateDescentTestFloat32(TestSolver, CoordinateDescentTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float32", **kwargs)
+
+
+class CoordinateDescentTestFloat64(TestSolver, CoordinateDescentTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float64", **kwargs)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,89 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+from scipy.sparse import csr_matrix
+
+from tick.linear_model import ModelLinReg, ModelLogReg
+from tick.prox import ProxL1, ProxL2Sq
+from tick.solver import NewtonCG
+from tick.solver.tests import TestSolver
+
+
+class NewtonCGTest(object):
+    def test_hessian_vector_product(self):
+        """...Test that the hessian-vector product of the models matches
+        finite differences of their gradient
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        decimal = 2 if self.dtype == "float32" else 6
+        eps = 1e-3 if self.dtype == "float32" else 1e-6
+
+        for features in [X, csr_matrix(X)]:
+            model = ModelLogReg(fit_intercept=True).fit(features, y)
+            coeffs = np.random.randn(model.n_coeffs).astype(self.dtype)
+            out = np.empty(model.n_coeffs, dtype=self.dtype)
+            # The second product reuses the derivatives of the first one
+            for _ in range(2):
+                vector = np.random.randn(model.n_coeffs).astype(self.dtype)
+                model._model.hessian_vector_product(coeffs, vector, out)
+                finite_diff = (model.grad(coeffs + eps * vector) -
+                               model.grad(coeffs - eps * vector)) / (2 * eps)
+                np.testing.assert_array_almost_equal(out, finite_diff,
+                                                     decimal=decimal)
+
+    def test_newton_cg_minimizer(self):
+        """...Test that NewtonCG reaches the minimizer of smooth models, with
+        and without a ProxL2Sq
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        decimal = 3 if self.dtype == "float32" else 6
+
+        for model_class in [ModelLinReg, ModelLogReg]:
+            for features in [X, csr_matrix(X)]:
+                model = model_class(fit_intercept=True).fit(features, y)
+                for strength in [0., 1e-2]:
+                    solver = NewtonCG(max_iter=30, verbose=False)
+                    solver.set_model(model)
+                    if strength > 0:
+                        solver.set_prox(ProxL2Sq(strength))
+                    minimizer = solver.solve()
+                    grad = model.grad(minimizer) + strength * minimizer
+                    np.testing.assert_array_almost_equal(
+                        grad, np.zeros_like(grad), decimal=decimal)
+
+    def test_newton_cg_rejected_settings(self):
+        """...Test that NewtonCG rejects non-smooth penalizations and
+        positive constraints
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg().fit(X, y)
+        solver = NewtonCG(verbose=False).set_model(model)
+        with self.assertRaises(RuntimeError):
+            solver.set_prox(ProxL1(0.1))
+        with self.assertRaises(RuntimeError):
+            solver.set_prox(ProxL2Sq(0.1, positive=True))
+
+        solver.max_cg_iter = 5
+        self.assertEqual(solver._solver.get_max_cg_iter(), 5)
+
+
+class NewtonCGTestFloat32(TestSolver, NewtonCGTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float32", **kwargs)
+
+
+class NewtonCGTestFloat64(TestSolver, NewtonCGTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float64", **kwargs)
+
+
+if __name__ == '__main__':
+    unittest.main()
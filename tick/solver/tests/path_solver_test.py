@@ -0,0 +1,75 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+
+from tick.linear_model import ModelLinReg
+from tick.prox import ProxL1, ProxElasticNet, ProxL2Sq
+from tick.solver import SVRG, PathSolver
+
+
+class PathSolverTest(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2318)
+        n_samples, n_features = 200, 12
+        self.features = np.random.randn(n_samples, n_features)
+        weights = np.zeros(n_features)
+        weights[:4] = [1., -2., 0.5, 1.5]
+        self.labels = self.features.dot(weights) + \
+            0.1 * np.random.randn(n_samples)
+        self.model = ModelLinReg(fit_intercept=False).fit(
+            self.features, self.labels)
+
+    def get_solver(self):
+        solver = SVRG(step=0.5 / self.model.get_lip_max(),
+                      seed=1309, verbose=False)
+        solver.set_model(self.model)
+        return solver
+
+    def test_path_minimizers(self):
+        """...Test that each solution of the path is the minimizer of the
+        penalized model at its strength
+        """
+        for prox_class in [ProxL1, ProxElasticNet]:
+            for screening in [True, False]:
+                prox = ProxL1(0.) if prox_class is ProxL1 \
+                    else ProxElasticNet(0., 0.8)
+                path_solver = PathSolver(self.get_solver(), prox,
+                                         n_strengths=5, eps=1e-2,
+                                         n_epochs=100, screening=screening)
+                path = path_solver.solve().toarray()
+                self.assertEqual(path.shape, (5, self.model.n_coeffs))
+                # Zero is the solution at the largest strength
+                np.testing.assert_array_equal(path[0], 0)
+                self.assertEqual(len(path_solver.n_active_features), 5)
+                self.assertEqual(len(path_solver.n_kkt_violations), 5)
+
+                strengths = path_solver.strength_max * \
+                    np.logspace(0, -2, 5)
+                for k, strength in enumerate(strengths[1:], 1):
+                    single_prox = ProxL1(strength) \
+                        if prox_class is ProxL1 \
+                        else ProxElasticNet(strength, 0.8)
+                    solver = self.get_solver()
+                    solver.max_iter = 2000
+                    solver.set_prox(single_prox)
+                    minimizer = solver.solve()
+                    np.testing.assert_array_almost_equal(
+                        path[k], minimizer, decimal=4)
+
+    def test_path_solver_rejected_settings(self):
+        """...Test that PathSolver rejects unsupported proxs and strengths
+        """
+        with self.assertRaises(ValueError):
+            PathSolver(self.get_solver(), ProxL2Sq(0.1))
+        with self.assertRaises(ValueError):
+            PathSolver(SVRG(), ProxL1(0.1))
+        path_solver = PathSolver(self.get_solver(), ProxL1(0.),
+                                 strengths=np.array([0.1, 0.2]))
+        with self.assertRaises(RuntimeError):
+            path_solver.solve()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,65 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+from scipy.sparse import csr_matrix
+
+from tick.linear_model import ModelLogReg
+from tick.prox import ProxL1, ProxElasticNet
+from tick.solver import CoordinateDescent, ProxNewton
+from tick.solver.tests import TestSolver
+
+
+class ProxNewtonTest(object):
+    def test_prox_newton_minimizer(self):
+        """...Test that ProxNewton and CoordinateDescent reach the same
+        minimizer of penalized logistic regression
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        decimal = 3 if self.dtype == "float32" else 5
+
+        for features in [X, csr_matrix(X)]:
+            model = ModelLogReg(fit_intercept=False).fit(features, y)
+            strength = 0.2 * np.abs(
+                model.grad(np.zeros(model.n_coeffs, dtype=self.dtype))).max()
+            for prox in [ProxL1(strength),
+                         ProxElasticNet(strength / 0.8, 0.8)]:
+                prox = prox.astype(self.dtype)
+                solutions = []
+                for solver in [ProxNewton(max_iter=30, verbose=False),
+                               CoordinateDescent(max_iter=300,
+                                                 verbose=False)]:
+                    solver.set_model(model).set_prox(prox)
+                    solutions.append(solver.solve())
+                self.assertGreater(np.sum(solutions[0] == 0), 0)
+                np.testing.assert_array_almost_equal(
+                    solutions[0], solutions[1], decimal=decimal)
+
+    def test_prox_newton_settings(self):
+        """...Test the settings of ProxNewton
+        """
+        solver = ProxNewton(rand_type='perm', max_active_passes=3)
+        self.assertEqual(solver.rand_type, 'perm')
+        self.assertEqual(solver.step_type, 'newton')
+        self.assertEqual(solver._solver.get_max_active_passes(), 3)
+        with self.assertRaises(ValueError):
+            ProxNewton(rand_type='importance')
+        with self.assertRaises(ValueError):
+            solver.step_type = 'bound'
+
+
+class ProxNewtonTestFloat32(TestSolver, ProxNewtonTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float32", **kwargs)
+
+
+class ProxNewtonTestFloat64(TestSolver, ProxNewtonTest):
+    def __init__(self, *args, **kwargs):
+        TestSolver.__init__(self, *args, dtype="float64", **kwargs)
+
+
+if __name__ == '__main__':
+    unittest.main()
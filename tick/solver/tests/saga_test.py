@@ -3,7 +3,7 @@
 import unittest
 import numpy as np
 from scipy import sparse
-from tick.prox import ProxElasticNet
+from tick.prox import ProxElasticNet, ProxL1, ProxL2Sq
 from tick.solver import SAGA
 from tick.solver.tests import TestSolver
 from tick.solver.build.solver import SAGADouble as _SAGA
@@ -40,6 +40,77 @@ class SAGATest(object):
             model = ModelCoxRegPartialLik().fit(X, T, C)
             SAGA().set_model(model)
 
+    def test_saga_batch_size(self):
+        """...SolverTest SAGA with batches finds the same minimizer
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=True).fit(X, y)
+        prox = ProxL2Sq(1e-2).astype(self.dtype)
+
+        solutions = []
+        for batch_size in [1, 8]:
+            saga = SAGA(step=1. / model.get_lip_max(), max_iter=300,
+                        verbose=False, tol=0, seed=TestSolver.sto_seed,
+                        batch_size=batch_size)
+            saga.set_model(model).set_prox(prox)
+            solutions.append(saga.solve())
+
+        np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                   atol=1e-4)
+
+    def test_saga_importance_sampling(self):
+        """...SolverTest SAGA with importance sampling finds the same
+        minimizer
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=True).fit(X, y)
+        prox = ProxL2Sq(1e-2).astype(self.dtype)
+
+        solutions = []
+        for rand_type in ['unif', 'importance']:
+            saga = SAGA(step=1. / model.get_lip_max(), max_iter=300,
+                        verbose=False, tol=0, seed=TestSolver.sto_seed,
+                        rand_type=rand_type)
+            saga.set_model(model).set_prox(prox)
+            solutions.append(saga.solve())
+
+        np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                   atol=1e-4)
+
+    def test_saga_gap_safe_screening(self):
+        """...SolverTest SAGA with gap safe screening discards features and
+        finds the same minimizer
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=False).fit(X, y)
+        # Strong enough for some coefficients to be zero at the optimum
+        strength = 0.3 * np.abs(model.grad(np.zeros(model.n_coeffs,
+                                                    dtype=self.dtype))).max()
+        for prox in [ProxL1(strength), ProxElasticNet(strength / 0.7, 0.7)]:
+            prox = prox.astype(self.dtype)
+            solutions, screening_rates = [], []
+            for screening_every in [0, 10]:
+                saga = SAGA(step=1. / model.get_lip_max(), max_iter=500,
+                            verbose=False, tol=0, seed=TestSolver.sto_seed,
+                            screening_every=screening_every)
+                saga.set_model(model).set_prox(prox)
+                solutions.append(saga.solve())
+                screening_rates.append(saga._solver.get_screening_rate())
+
+            self.assertEqual(screening_rates[0], 0)
+            self.assertGreater(screening_rates[1], 0)
+            np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                       atol=1e-4)
+
+        with self.assertRaises(ValueError):
+            SAGA(n_threads=2, screening_every=10)
+
     def test_saga_dtype_can_change(self):
         """...Test saga astype method
         """
@@ -62,6 +62,24 @@ class SDCATest(object):
 
         self._test_solver_sparse_and_dense_consistency(create_solver)
 
+    def test_sdca_n_threads(self):
+        """...SolverTest SDCA with several threads finds the same minimizer
+        """
+        np.random.seed(12)
+        y, X, _, _ = TestSolver.generate_logistic_data(
+            TestSolver.n_features, TestSolver.n_samples, dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=True).fit(X, y)
+
+        solutions = []
+        for n_threads in [1, 2]:
+            sdca = SDCA(l_l2sq=1e-2, max_iter=200, verbose=False, tol=0,
+                        seed=TestSolver.sto_seed, n_threads=n_threads)
+            sdca.set_model(model).set_prox(ProxZero().astype(self.dtype))
+            solutions.append(sdca.solve())
+
+        np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                   atol=1e-4)
+
     def test_sdca_identity_poisreg(self):
         """...SolverTest SDCA on specific case of Poisson regression with
         indentity link
@@ -94,6 +94,35 @@ class Test(TestSolver):
                     else:
                         self.assertEqual(model.loss(X[0]), solver.model.loss(X[0]))
 
+    def test_serializing_sdca_n_threads(self):
+        """...Test that the number of threads of SDCA is serialized
+        """
+        X, y = SimuLogReg(np.ones(5), None, n_samples=100, verbose=False,
+                          seed=2038).simulate()
+        model = ModelLogReg(fit_intercept=False).fit(X, y)
+        solver = SDCA(l_l2sq=1e-2, max_iter=10, verbose=False, tol=0,
+                      n_threads=2)
+        solver.set_model(model).set_prox(ProxZero())
+
+        pickled = pickle.loads(pickle.dumps(solver))
+        self.assertEqual(pickled._solver.get_n_threads(), 2)
+        self.assertTrue(solver._solver.compare(pickled._solver))
+
+    def test_serializing_atomic_svrg(self):
+        """...Test serialization of SVRG with several threads
+        """
+        X, y = SimuLogReg(np.ones(5), None, n_samples=100, verbose=False,
+                          seed=2038).simulate()
+        model = ModelLogReg(fit_intercept=True).fit(X, y)
+        solver = SVRG(step=1e-3, max_iter=10, verbose=False, tol=0,
+                      n_threads=3)
+        solver.set_model(model).set_prox(ProxL1(1e-3))
+        solver.solve()
+
+        pickled = pickle.loads(pickle.dumps(solver))
+        self.assertEqual(pickled._solver.get_n_threads(), 3)
+        self.assertTrue(solver._solver.compare(pickled._solver))
+
 
 if __name__ == "__main__":
     unittest.main()
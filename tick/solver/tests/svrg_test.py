@@ -264,6 +264,75 @@ class SVRGTest(object):
         # This test is very unstable...
         # self._test_solver_sparse_and_dense_consistency(create_solver)
 
+    def test_asvrg_reaches_sequential_minimizer(self):
+        """...Test that SVRG with several threads converges to the minimizer
+        found with one thread, on dense and sparse features
+        """
+        X, y = SVRGTest.simu_linreg_data(self.dtype, n_samples=2000,
+                                         n_features=20)
+        X_sparse = csr_matrix(X)
+        decimal = 3 if self.dtype == "float32" else 6
+        for features in [X, X_sparse]:
+            model = ModelLinReg(fit_intercept=True).fit(features, y)
+            prox = ProxElasticNet(1e-3, ratio=0.5, range=(0, 20))
+            step = 1. / model.get_lip_max()
+            solutions = []
+            for n_threads in [1, 3]:
+                solver = SVRG(step=step, max_iter=100, tol=0, verbose=False,
+                              seed=TestSolver.sto_seed, n_threads=n_threads)
+                solver.set_model(model).set_prox(prox)
+                solutions.append(solver.solve())
+            np.testing.assert_array_almost_equal(solutions[0], solutions[1],
+                                                 decimal=decimal)
+
+    def test_asvrg_rejected_settings(self):
+        """...Test that SVRG with several threads rejects the settings it
+        does not support
+        """
+        with self.assertRaises(ValueError):
+            SVRG(n_threads=2, variance_reduction='avg')
+        with self.assertRaises(ValueError):
+            SVRG(n_threads=2, step_type='bb')
+        solver = SVRG(n_threads=2)
+        self.assertEqual(solver.variance_reduction, 'last')
+        self.assertEqual(solver.step_type, 'fixed')
+        with self.assertRaises(ValueError):
+            solver.variance_reduction = 'rand'
+        with self.assertRaises(RuntimeError):
+            solver.batch_size = 2
+
+    def test_svrg_gap_safe_screening(self):
+        """...Test that SVRG with gap safe screening discards features and
+        reaches the minimizer found without screening
+        """
+        np.random.seed(12)
+        n_samples, n_features = 300, 10
+        y, X, _, _ = TestSolver.generate_logistic_data(n_features, n_samples,
+                                                       dtype=self.dtype)
+        model = ModelLogReg(fit_intercept=False).fit(X, y)
+        grad_at_zero = model.grad(np.zeros(n_features, dtype=self.dtype))
+        prox = ProxL1(0.3 * np.abs(grad_at_zero).max()).astype(self.dtype)
+
+        solutions = []
+        for screening_every in [0, 5]:
+            svrg = SVRG(step=1. / model.get_lip_max(), max_iter=300,
+                        verbose=False, tol=0, seed=TestSolver.sto_seed,
+                        screening_every=screening_every)
+            svrg.set_model(model).set_prox(prox)
+            solutions.append(svrg.solve())
+            rate = svrg._solver.get_screening_rate()
+            if screening_every == 0:
+                self.assertEqual(rate, 0)
+            else:
+                self.assertGreater(rate, 0)
+                # Screened features are exactly zero
+                self.assertGreater(np.sum(solutions[-1] == 0), 0)
+
+        np.testing.assert_allclose(solutions[0], solutions[1], rtol=1e-3,
+                                   atol=1e-4)
+        with self.assertRaises(ValueError):
+            SVRG(n_threads=2, screening_every=5)
+
     def test_svrg_dtype_can_change(self):
         """...Test svrg astype method
         """
@@ -0,0 +1,66 @@
+#include <vector>
+
+#include "tick/solver/asvrg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/prox/prox_elasticnet.h"
+
+#include "shared_saga.ipp"
+
+//
+// Benchmark asvrg performances, to be compared with svrg_sparse which runs
+// the same threads without atomics
+// The command lines arguments are the following
+// dataset : a sparse dataset (for example generated with benchmark_utils.py
+// n_threads : the number of threads to be used
+// n_iter : the number of passes on the data
+// record_every : how often metrics are computed
+// verbose : verbose results on the fly if true, only summary if false
+//
+// Example
+// First get the data ready
+// python -c "from benchmark_util import save_url_dataset_for_cpp_benchmarks; save_url_dataset_for_cpp_benchmarks(5)"
+// Then run asvrg on url dataset with 5 days, 4 threads, 25 iterations, record every 5 and no verbose
+// ./tick_asvrg_sparse url.5 4 25 5 0
+//
+
+const constexpr int SEED = 42;
+
+std::tuple<std::vector<double>, std::vector<double>> run_asvrg_solver(
+    SBaseArrayDouble2dPtr features, SArrayDoublePtr labels, ulong n_iter, int n_threads,
+    int record_every, double strength, double ratio) {
+  const auto n_samples = features->n_rows();
+
+  auto model = std::make_shared<ModelLogReg>(features, labels, false);
+  AtomicSVRG<double> asvrg(
+      n_samples, 0,
+      RandType::unif,
+      1. / model->get_lip_max(),
+      record_every,
+      SEED,
+      n_threads
+  );
+  asvrg.set_rand_max(n_samples);
+  asvrg.set_model(model);
+
+  auto prox = std::make_shared<TProxElasticNet<double> >(
+      strength, ratio, 0, model->get_n_coeffs(), 0);
+
+  asvrg.set_prox(prox);
+  asvrg.solve((int) n_iter);
+  const auto &history = asvrg.get_time_history();
+
+  const auto &iterates = asvrg.get_iterate_history();
+
+  std::vector<double> objectives(iterates.size());
+  for (int i = 0; i < iterates.size(); ++i) {
+    objectives[i] = model->loss(*iterates[i]) + prox->value(*iterates[i]);
+  }
+
+  return std::make_tuple(history, objectives);
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "ASVRG" << std::endl;
+  submain(argc, argv, run_asvrg_solver);
+  return 0;
+}
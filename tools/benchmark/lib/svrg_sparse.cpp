@@ -0,0 +1,66 @@
+#include <vector>
+
+#include "tick/solver/svrg.h"
+#include "tick/linear_model/model_logreg.h"
+#include "tick/prox/prox_elasticnet.h"
+
+#include "shared_saga.ipp"
+
+//
+// Benchmark svrg performances, its multi-threaded mode updating the iterate
+// without synchronization
+// The command lines arguments are the following
+// dataset : a sparse dataset (for example generated with benchmark_utils.py
+// n_threads : the number of threads to be used
+// n_iter : the number of passes on the data
+// record_every : how often metrics are computed
+// verbose : verbose results on the fly if true, only summary if false
+//
+// Example
+// First get the data ready
+// python -c "from benchmark_util import save_url_dataset_for_cpp_benchmarks; save_url_dataset_for_cpp_benchmarks(5)"
+// Then run svrg on url dataset with 5 days, 4 threads, 25 iterations, record every 5 and no verbose
+// ./tick_svrg_sparse url.5 4 25 5 0
+//
+
+const constexpr int SEED = 42;
+
+std::tuple<std::vector<double>, std::vector<double>> run_svrg_solver(
+    SBaseArrayDouble2dPtr features, SArrayDoublePtr labels, ulong n_iter, int n_threads,
+    int record_every, double strength, double ratio) {
+  const auto n_samples = features->n_rows();
+
+  auto model = std::make_shared<TModelLogReg<double> >(features, labels, false);
+  TSVRG<double> svrg(
+      n_samples, 0,
+      RandType::unif,
+      1. / model->get_lip_max(),
+      record_every,
+      SEED,
+      n_threads
+  );
+  svrg.set_rand_max(n_samples);
+  svrg.set_model(model);
+
+  auto prox = std::make_shared<TProxElasticNet<double> >(
+      strength, ratio, 0, model->get_n_coeffs(), 0);
+
+  svrg.set_prox(prox);
+  svrg.solve((int) n_iter);
+  const auto &history = svrg.get_time_history();
+
+  const auto &iterates = svrg.get_iterate_history();
+
+  std::vector<double> objectives(iterates.size());
+  for (int i = 0; i < iterates.size(); ++i) {
+    objectives[i] = model->loss(*iterates[i]) + prox->value(*iterates[i]);
+  }
+
+  return std::make_tuple(history, objectives);
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "SVRG" << std::endl;
+  submain(argc, argv, run_svrg_solver);
+  return 0;
+}